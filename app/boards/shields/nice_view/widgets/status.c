@@ -46,27 +46,38 @@ struct wpm_status_state {
     uint8_t wpm;
 };
 
-static void draw_top(lv_obj_t *widget, const struct status_state *state) {
-    lv_obj_t *canvas = lv_obj_get_child(widget, 0);
+// Unrotated areas of the elements, which are redrawn and flushed on their own. Every element
+// covers the pixels it draws, so redrawing one doesn't touch the others.
+enum status_element {
+    STATUS_BATTERY,
+    STATUS_OUTPUT,
+    STATUS_WPM,
+    STATUS_PROFILES,
+    STATUS_LAYER,
+};
 
-    lv_draw_label_dsc_t label_dsc;
-    init_label_dsc(&label_dsc, LVGL_FOREGROUND, &lv_font_montserrat_16, LV_TEXT_ALIGN_RIGHT);
-    lv_draw_label_dsc_t label_dsc_wpm;
-    init_label_dsc(&label_dsc_wpm, LVGL_FOREGROUND, &lv_font_unscii_8, LV_TEXT_ALIGN_RIGHT);
-    lv_draw_rect_dsc_t rect_black_dsc;
-    init_rect_dsc(&rect_black_dsc, LVGL_BACKGROUND);
-    lv_draw_rect_dsc_t rect_white_dsc;
-    init_rect_dsc(&rect_white_dsc, LVGL_FOREGROUND);
-    lv_draw_line_dsc_t line_dsc;
-    init_line_dsc(&line_dsc, LVGL_FOREGROUND, 1);
+struct status_element_area {
+    uint8_t canvas;
+    lv_area_t area;
+};
+
+static const struct status_element_area element_areas[] = {
+    [STATUS_BATTERY] = {.canvas = 0, .area = {0, 0, 33, 20}},
+    [STATUS_OUTPUT] = {.canvas = 0, .area = {34, 0, CANVAS_SIZE - 1, 20}},
+    [STATUS_WPM] = {.canvas = 0, .area = {0, 21, CANVAS_SIZE - 1, CANVAS_SIZE - 1}},
+    [STATUS_PROFILES] = {.canvas = 1, .area = {0, 0, CANVAS_SIZE - 1, CANVAS_SIZE - 1}},
+    [STATUS_LAYER] = {.canvas = 2, .area = {0, 0, CANVAS_SIZE - 1, CANVAS_SIZE - 1}},
+};
+
+// Elements are drawn unrotated into this buffer, then only their area is rotated into the canvas.
+static uint8_t scratch_buf[CANVAS_BUF_SIZE];
 
-    // Fill background
-    lv_canvas_fill_bg(canvas, LVGL_BACKGROUND, LV_OPA_COVER);
+#define SCRATCH_CANVAS 3
 
-    // Draw battery
-    draw_battery(canvas, state);
+static void draw_output(lv_obj_t *canvas, const struct status_state *state) {
+    lv_draw_label_dsc_t label_dsc;
+    init_label_dsc(&label_dsc, LVGL_FOREGROUND, &lv_font_montserrat_16, LV_TEXT_ALIGN_RIGHT);
 
-    // Draw output status
     char output_text[10] = {};
 
     switch (state->selected_endpoint.transport) {
@@ -87,8 +98,18 @@ static void draw_top(lv_obj_t *widget, const struct status_state *state) {
     }
 
     canvas_draw_text(canvas, 0, 0, CANVAS_SIZE, &label_dsc, output_text);
+}
+
+static void draw_wpm(lv_obj_t *canvas, const struct status_state *state) {
+    lv_draw_label_dsc_t label_dsc_wpm;
+    init_label_dsc(&label_dsc_wpm, LVGL_FOREGROUND, &lv_font_unscii_8, LV_TEXT_ALIGN_RIGHT);
+    lv_draw_rect_dsc_t rect_black_dsc;
+    init_rect_dsc(&rect_black_dsc, LVGL_BACKGROUND);
+    lv_draw_rect_dsc_t rect_white_dsc;
+    init_rect_dsc(&rect_white_dsc, LVGL_FOREGROUND);
+    lv_draw_line_dsc_t line_dsc;
+    init_line_dsc(&line_dsc, LVGL_FOREGROUND, 1);
 
-    // Draw WPM
     canvas_draw_rect(canvas, 0, 21, 68, 42, &rect_white_dsc);
     canvas_draw_rect(canvas, 1, 22, 66, 40, &rect_black_dsc);
 
@@ -119,18 +140,9 @@ static void draw_top(lv_obj_t *widget, const struct status_state *state) {
         points[i].y = 60 - (state->wpm[i] - min) * 36 / range;
     }
     canvas_draw_line(canvas, points, 10, &line_dsc);
-
-    // Rotate canvas
-    rotate_canvas(canvas);
 }
 
-static void draw_middle(lv_obj_t *widget, const struct status_state *state) {
-    lv_obj_t *canvas = lv_obj_get_child(widget, 1);
-
-    lv_draw_rect_dsc_t rect_black_dsc;
-    init_rect_dsc(&rect_black_dsc, LVGL_BACKGROUND);
-    lv_draw_rect_dsc_t rect_white_dsc;
-    init_rect_dsc(&rect_white_dsc, LVGL_FOREGROUND);
+static void draw_profiles(lv_obj_t *canvas, const struct status_state *state) {
     lv_draw_arc_dsc_t arc_dsc;
     init_arc_dsc(&arc_dsc, LVGL_FOREGROUND, 2);
     lv_draw_arc_dsc_t arc_dsc_filled;
@@ -140,9 +152,6 @@ static void draw_middle(lv_obj_t *widget, const struct status_state *state) {
     lv_draw_label_dsc_t label_dsc_black;
     init_label_dsc(&label_dsc_black, LVGL_BACKGROUND, &lv_font_montserrat_18, LV_TEXT_ALIGN_CENTER);
 
-    // Fill background
-    lv_canvas_fill_bg(canvas, LVGL_BACKGROUND, LV_OPA_COVER);
-
     // Draw circles
     int circle_offsets[NICEVIEW_PROFILE_COUNT][2] = {
         {13, 13}, {55, 13}, {34, 34}, {13, 55}, {55, 55},
@@ -173,23 +182,12 @@ static void draw_middle(lv_obj_t *widget, const struct status_state *state) {
         canvas_draw_text(canvas, circle_offsets[i][0] - 8, circle_offsets[i][1] - 10, 16,
                          (selected ? &label_dsc_black : &label_dsc), label);
     }
-
-    // Rotate canvas
-    rotate_canvas(canvas);
 }
 
-static void draw_bottom(lv_obj_t *widget, const struct status_state *state) {
-    lv_obj_t *canvas = lv_obj_get_child(widget, 2);
-
-    lv_draw_rect_dsc_t rect_black_dsc;
-    init_rect_dsc(&rect_black_dsc, LVGL_BACKGROUND);
+static void draw_layer(lv_obj_t *canvas, const struct status_state *state) {
     lv_draw_label_dsc_t label_dsc;
     init_label_dsc(&label_dsc, LVGL_FOREGROUND, &lv_font_montserrat_14, LV_TEXT_ALIGN_CENTER);
 
-    // Fill background
-    lv_canvas_fill_bg(canvas, LVGL_BACKGROUND, LV_OPA_COVER);
-
-    // Draw layer
     if (state->layer_label == NULL || strlen(state->layer_label) == 0) {
         char text[10] = {};
 
@@ -199,20 +197,47 @@ static void draw_bottom(lv_obj_t *widget, const struct status_state *state) {
     } else {
         canvas_draw_text(canvas, 0, 5, 68, &label_dsc, state->layer_label);
     }
+}
+
+static void (*const element_draws[])(lv_obj_t *canvas, const struct status_state *state) = {
+    [STATUS_BATTERY] = draw_battery,   [STATUS_OUTPUT] = draw_output, [STATUS_WPM] = draw_wpm,
+    [STATUS_PROFILES] = draw_profiles, [STATUS_LAYER] = draw_layer,
+};
+
+// Redraws @p element, or skips it if it's already drawn and @p changed is false. Only the display
+// lines of the element's area are flushed.
+static void draw_element(struct zmk_widget_status *widget, enum status_element element,
+                         bool changed) {
+    if (!changed && (widget->drawn_elements & BIT(element))) {
+        return;
+    }
+
+    const lv_area_t *area = &element_areas[element].area;
+    lv_obj_t *scratch = lv_obj_get_child(widget->obj, SCRATCH_CANVAS);
 
-    // Rotate canvas
-    rotate_canvas(canvas);
+    lv_draw_rect_dsc_t rect_black_dsc;
+    init_rect_dsc(&rect_black_dsc, LVGL_BACKGROUND);
+    canvas_draw_rect(scratch, area->x1, area->y1, lv_area_get_width(area),
+                     lv_area_get_height(area), &rect_black_dsc);
+
+    element_draws[element](scratch, &widget->state);
+
+    rotate_canvas_area(scratch, lv_obj_get_child(widget->obj, element_areas[element].canvas),
+                       area);
+    widget->drawn_elements |= BIT(element);
 }
 
 static void set_battery_status(struct zmk_widget_status *widget,
                                struct battery_status_state state) {
+    bool changed = widget->state.battery != state.level;
 #if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+    changed |= widget->state.charging != state.usb_present;
     widget->state.charging = state.usb_present;
 #endif /* IS_ENABLED(CONFIG_USB_DEVICE_STACK) */
 
     widget->state.battery = state.level;
 
-    draw_top(widget->obj, &widget->state);
+    draw_element(widget, STATUS_BATTERY, changed);
 }
 
 static void battery_status_update_cb(struct battery_status_state state) {
@@ -241,6 +266,17 @@ ZMK_SUBSCRIPTION(widget_battery_status, zmk_usb_conn_state_changed);
 
 static void set_output_status(struct zmk_widget_status *widget,
                               const struct output_status_state *state) {
+    bool output_changed =
+        !zmk_endpoint_instance_eq(widget->state.selected_endpoint, state->selected_endpoint) ||
+        widget->state.active_profile_connected != state->active_profile_connected ||
+        widget->state.active_profile_bonded != state->active_profile_bonded;
+    bool profiles_changed =
+        widget->state.active_profile_index != state->active_profile_index ||
+        memcmp(widget->state.profiles_connected, state->profiles_connected,
+               sizeof(state->profiles_connected)) != 0 ||
+        memcmp(widget->state.profiles_bonded, state->profiles_bonded,
+               sizeof(state->profiles_bonded)) != 0;
+
     widget->state.selected_endpoint = state->selected_endpoint;
     widget->state.active_profile_index = state->active_profile_index;
     widget->state.active_profile_connected = state->active_profile_connected;
@@ -250,8 +286,8 @@ static void set_output_status(struct zmk_widget_status *widget,
         widget->state.profiles_bonded[i] = state->profiles_bonded[i];
     }
 
-    draw_top(widget->obj, &widget->state);
-    draw_middle(widget->obj, &widget->state);
+    draw_element(widget, STATUS_OUTPUT, output_changed);
+    draw_element(widget, STATUS_PROFILES, profiles_changed);
 }
 
 static void output_status_update_cb(struct output_status_state state) {
@@ -285,10 +321,13 @@ ZMK_SUBSCRIPTION(widget_output_status, zmk_ble_active_profile_changed);
 #endif
 
 static void set_layer_status(struct zmk_widget_status *widget, struct layer_status_state state) {
+    bool changed =
+        widget->state.layer_index != state.index || widget->state.layer_label != state.label;
+
     widget->state.layer_index = state.index;
     widget->state.layer_label = state.label;
 
-    draw_bottom(widget->obj, &widget->state);
+    draw_element(widget, STATUS_LAYER, changed);
 }
 
 static void layer_status_update_cb(struct layer_status_state state) {
@@ -308,12 +347,15 @@ ZMK_DISPLAY_WIDGET_LISTENER(widget_layer_status, struct layer_status_state, laye
 ZMK_SUBSCRIPTION(widget_layer_status, zmk_layer_state_changed);
 
 static void set_wpm_status(struct zmk_widget_status *widget, struct wpm_status_state state) {
+    bool changed = false;
     for (int i = 0; i < 9; i++) {
+        changed |= widget->state.wpm[i] != widget->state.wpm[i + 1];
         widget->state.wpm[i] = widget->state.wpm[i + 1];
     }
+    changed |= widget->state.wpm[9] != state.wpm;
     widget->state.wpm[9] = state.wpm;
 
-    draw_top(widget->obj, &widget->state);
+    draw_element(widget, STATUS_WPM, changed);
 }
 
 static void wpm_status_update_cb(struct wpm_status_state state) {
@@ -341,6 +383,14 @@ int zmk_widget_status_init(struct zmk_widget_status *widget, lv_obj_t *parent) {
     lv_obj_t *bottom = lv_canvas_create(widget->obj);
     lv_obj_align(bottom, LV_ALIGN_TOP_LEFT, -44, 0);
     lv_canvas_set_buffer(bottom, widget->cbuf3, CANVAS_SIZE, CANVAS_SIZE, CANVAS_COLOR_FORMAT);
+    lv_obj_t *scratch = lv_canvas_create(widget->obj);
+    lv_obj_add_flag(scratch, LV_OBJ_FLAG_HIDDEN);
+    lv_canvas_set_buffer(scratch, scratch_buf, CANVAS_SIZE, CANVAS_SIZE, CANVAS_COLOR_FORMAT);
+
+    // Areas between the elements are never drawn, so start from the background.
+    lv_canvas_fill_bg(top, LVGL_BACKGROUND, LV_OPA_COVER);
+    lv_canvas_fill_bg(middle, LVGL_BACKGROUND, LV_OPA_COVER);
+    lv_canvas_fill_bg(bottom, LVGL_BACKGROUND, LV_OPA_COVER);
 
     sys_slist_append(&widgets, &widget->node);
     widget_battery_status_init();
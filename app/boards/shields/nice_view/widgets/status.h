@@ -18,6 +18,8 @@ struct zmk_widget_status {
     uint8_t cbuf2[CANVAS_BUF_SIZE];
     uint8_t cbuf3[CANVAS_BUF_SIZE];
     struct status_state state;
+    // bits of the elements drawn since init, which are only redrawn when they change
+    uint8_t drawn_elements;
 };
 
 int zmk_widget_status_init(struct zmk_widget_status *widget, lv_obj_t *parent);
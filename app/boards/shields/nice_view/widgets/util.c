@@ -20,6 +20,28 @@ void rotate_canvas(lv_obj_t *canvas) {
                       LV_DISPLAY_ROTATION_270, CANVAS_COLOR_FORMAT);
 }
 
+// Rotates @p area of the unrotated @p src canvas into @p canvas and invalidates only the rotated
+// area, so the display flushes just the lines it covers.
+void rotate_canvas_area(lv_obj_t *src, lv_obj_t *canvas, const lv_area_t *area) {
+    const uint8_t *src_buf = lv_canvas_get_draw_buf(src)->data;
+    uint8_t *buf = lv_canvas_get_draw_buf(canvas)->data;
+
+    // Rotating by 270 degrees moves (x, y) to (CANVAS_SIZE - 1 - y, x).
+    lv_area_t rotated = {CANVAS_SIZE - 1 - area->y2, area->x1, CANVAS_SIZE - 1 - area->y1,
+                         area->x2};
+
+    const uint32_t stride = lv_draw_buf_width_to_stride(CANVAS_SIZE, CANVAS_COLOR_FORMAT);
+    lv_draw_sw_rotate(src_buf + area->y1 * stride + area->x1,
+                      buf + rotated.y1 * stride + rotated.x1, lv_area_get_width(area),
+                      lv_area_get_height(area), stride, stride, LV_DISPLAY_ROTATION_270,
+                      CANVAS_COLOR_FORMAT);
+
+    lv_area_t coords;
+    lv_obj_get_coords(canvas, &coords);
+    lv_area_move(&rotated, coords.x1, coords.y1);
+    lv_obj_invalidate_area(canvas, &rotated);
+}
+
 void draw_battery(lv_obj_t *canvas, const struct status_state *state) {
     lv_draw_rect_dsc_t rect_black_dsc;
     init_rect_dsc(&rect_black_dsc, LVGL_BACKGROUND);
@@ -47,6 +47,7 @@ struct battery_status_state {
 };
 
 void rotate_canvas(lv_obj_t *canvas);
+void rotate_canvas_area(lv_obj_t *src, lv_obj_t *canvas, const lv_area_t *area);
 void draw_battery(lv_obj_t *canvas, const struct status_state *state);
 void init_label_dsc(lv_draw_label_dsc_t *label_dsc, lv_color_t color, const lv_font_t *font,
                     lv_text_align_t align);
@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2026 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+
+"""
+Prints the ZmkEvent frames of an IPC observer trace file (CONFIG_ZMK_IPC_OBSERVER_TRACE_FILE) as
+one line of text per event, for comparison with a test's trace_events.snapshot.
+
+Times are in milliseconds since the first event of the trace. Only the fields the snapshots rely on
+are decoded, so this needs neither protoc nor the protobuf package.
+"""
+
+import struct
+import sys
+
+# ZmkEvent payload field numbers, see proto/zmk_ipc.proto
+KSCAN_EVENT = 1
+KEYBOARD = 2
+CONSUMER = 3
+MOUSE = 4
+LAYER_STATE = 8
+TIMESTAMP = 9
+
+
+def read_varint(data, pos):
+    value = shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def fields(data):
+    """Returns the fields of a message as a dictionary of field number to its last value."""
+    values = {}
+    pos = 0
+    while pos < len(data):
+        key, pos = read_varint(data, pos)
+        number, wire_type = key >> 3, key & 7
+        if wire_type == 0:
+            values[number], pos = read_varint(data, pos)
+        elif wire_type == 2:
+            length, pos = read_varint(data, pos)
+            values[number] = data[pos : pos + length]
+            pos += length
+        elif wire_type == 1:
+            values[number] = data[pos : pos + 8]
+            pos += 8
+        elif wire_type == 5:
+            values[number] = data[pos : pos + 4]
+            pos += 4
+        else:
+            raise ValueError(f"unsupported wire type {wire_type}")
+    return values
+
+
+def sint(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def hex_bytes(data):
+    return " ".join(f"{byte:02x}" for byte in data.rstrip(b"\0"))
+
+
+def describe(event):
+    if KSCAN_EVENT in event:
+        kscan = fields(event[KSCAN_EVENT])
+        state = "pressed" if kscan.get(3) else "released"
+        return f"kscan position {kscan.get(2, 0)} {state}"
+    if KEYBOARD in event:
+        report = fields(event[KEYBOARD])
+        return f"keyboard mods 0x{report.get(2, 0):02x} keys {hex_bytes(report.get(3, b''))}"
+    if CONSUMER in event:
+        report = fields(event[CONSUMER])
+        return f"consumer keys {hex_bytes(report.get(2, b''))}"
+    if MOUSE in event:
+        report = fields(event[MOUSE])
+        return (
+            f"mouse buttons 0x{report.get(2, 0):02x} dx {sint(report.get(3, 0))} "
+            f"dy {sint(report.get(4, 0))} scroll_x {sint(report.get(5, 0))} "
+            f"scroll_y {sint(report.get(6, 0))}"
+        )
+    if LAYER_STATE in event:
+        layer = fields(event[LAYER_STATE])
+        state = "active" if layer.get(2) else "inactive"
+        return f"layer {layer.get(1, 0)} {state}"
+    return None
+
+
+def main(path):
+    with open(path, "rb") as trace:
+        data = trace.read()
+
+    start = None
+    pos = 0
+    while pos + 4 <= len(data):
+        (length,) = struct.unpack_from(">I", data, pos)
+        event = fields(data[pos + 4 : pos + 4 + length])
+        pos += 4 + length
+
+        line = describe(event)
+        if line is None:
+            continue
+
+        timestamp = event.get(TIMESTAMP, 0)
+        start = timestamp if start is None else start
+        print(f"{timestamp - start} {line}".rstrip())
+
+    if pos != len(data):
+        print(f"truncated frame at byte {pos}", file=sys.stderr)
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        print("Usage: decode-ipc-trace.py <trace file>", file=sys.stderr)
+        sys.exit(1)
+    sys.exit(main(sys.argv[1]))
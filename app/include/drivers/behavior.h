@@ -84,6 +84,7 @@ enum behavior_locality {
 __subsystem struct behavior_driver_api {
     enum behavior_locality locality;
     behavior_keymap_binding_callback_t binding_convert_central_state_dependent_params;
+    behavior_keymap_binding_callback_t binding_is_idempotent;
     behavior_keymap_binding_callback_t binding_pressed;
     behavior_keymap_binding_callback_t binding_released;
     behavior_sensor_keymap_binding_accept_data_callback_t sensor_binding_accept_data;
@@ -248,7 +249,7 @@ __syscall int behavior_keymap_binding_convert_central_state_dependent_params(
 
 static inline int z_impl_behavior_keymap_binding_convert_central_state_dependent_params(
     struct zmk_behavior_binding *binding, struct zmk_behavior_binding_event event) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
     const struct behavior_driver_api *api = (const struct behavior_driver_api *)dev->api;
 
     if (api->binding_convert_central_state_dependent_params == NULL) {
@@ -258,6 +259,37 @@ static inline int z_impl_behavior_keymap_binding_convert_central_state_dependent
     return api->binding_convert_central_state_dependent_params(binding, event);
 }
 
+/**
+ * @brief Determine whether the binding sets a state from its parameters alone, once converted
+ * from relative to absolute, so a later invocation with the same param1 makes an earlier one that
+ * hasn't run yet redundant
+ * @param binding Pointer to the details so of the binding
+ * @param event The event that triggered use of the binding
+ *
+ * @retval 1 If the binding is idempotent.
+ * @retval 0 If it isn't, or the behavior can't tell.
+ */
+__syscall int behavior_keymap_binding_is_idempotent(struct zmk_behavior_binding *binding,
+                                                    struct zmk_behavior_binding_event event);
+
+static inline int
+z_impl_behavior_keymap_binding_is_idempotent(struct zmk_behavior_binding *binding,
+                                             struct zmk_behavior_binding_event event) {
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
+
+    if (dev == NULL) {
+        return 0;
+    }
+
+    const struct behavior_driver_api *api = (const struct behavior_driver_api *)dev->api;
+
+    if (api->binding_is_idempotent == NULL) {
+        return 0;
+    }
+
+    return api->binding_is_idempotent(binding, event);
+}
+
 #if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
 
 /**
@@ -328,7 +360,7 @@ __syscall int behavior_keymap_binding_pressed(struct zmk_behavior_binding *bindi
 
 static inline int z_impl_behavior_keymap_binding_pressed(struct zmk_behavior_binding *binding,
                                                          struct zmk_behavior_binding_event event) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
 
     if (dev == NULL) {
         return -EINVAL;
@@ -356,7 +388,7 @@ __syscall int behavior_keymap_binding_released(struct zmk_behavior_binding *bind
 
 static inline int z_impl_behavior_keymap_binding_released(struct zmk_behavior_binding *binding,
                                                           struct zmk_behavior_binding_event event) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
 
     if (dev == NULL) {
         return -EINVAL;
@@ -390,7 +422,7 @@ static inline int z_impl_behavior_sensor_keymap_binding_accept_data(
     struct zmk_behavior_binding *binding, struct zmk_behavior_binding_event event,
     const struct zmk_sensor_config *sensor_config, size_t channel_data_size,
     const struct zmk_sensor_channel_data *channel_data) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
 
     if (dev == NULL) {
         return -EINVAL;
@@ -426,7 +458,7 @@ static inline int
 z_impl_behavior_sensor_keymap_binding_process(struct zmk_behavior_binding *binding,
                                               struct zmk_behavior_binding_event event,
                                               enum behavior_sensor_binding_process_mode mode) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
 
     if (dev == NULL) {
         return -EINVAL;
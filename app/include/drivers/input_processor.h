@@ -46,8 +46,33 @@ typedef int (*zmk_input_processor_handle_event_callback_t)(const struct device *
                                                            uint32_t param1, uint32_t param2,
                                                            struct zmk_input_processor_state *state);
 
+/**
+ * @brief What a chain of linear processors does to the events of one type and code.
+ *
+ * The event code becomes `code`, and its value is multiplied by `mul / div`.
+ */
+struct zmk_input_processor_linear_map {
+    uint8_t type;
+    uint16_t code;
+    int32_t mul;
+    int32_t div;
+};
+
+/**
+ * @brief Compose the processor with a linear map, for processors that only ever rename the code of
+ * an event and scale its value, whatever the state of the system.
+ *
+ * Updates the map to what the processor does to the result of it. A processor that doesn't touch
+ * the events of the map leaves it as is.
+ */
+typedef int (*zmk_input_processor_map_linear_callback_t)(
+    const struct device *dev, uint32_t param1, uint32_t param2,
+    struct zmk_input_processor_linear_map *map);
+
 __subsystem struct zmk_input_processor_driver_api {
     zmk_input_processor_handle_event_callback_t handle_event;
+    // Optional, lets consecutive linear processors be applied as a single step
+    zmk_input_processor_map_linear_callback_t map_linear;
 };
 
 __syscall int zmk_input_processor_handle_event(const struct device *dev, struct input_event *event,
@@ -68,4 +93,23 @@ static inline int z_impl_zmk_input_processor_handle_event(const struct device *d
     return api->handle_event(dev, event, param1, param2, state);
 }
 
+/**
+ * @brief Compose a linear processor with a map.
+ *
+ * @retval 0 once the map is updated
+ * @retval -ENOTSUP if the processor isn't linear
+ */
+static inline int zmk_input_processor_map_linear(const struct device *dev, uint32_t param1,
+                                                 uint32_t param2,
+                                                 struct zmk_input_processor_linear_map *map) {
+    const struct zmk_input_processor_driver_api *api =
+        (const struct zmk_input_processor_driver_api *)dev->api;
+
+    if (api->map_linear == NULL) {
+        return -ENOTSUP;
+    }
+
+    return api->map_linear(dev, param1, param2, map);
+}
+
 #include <syscalls/input_processor.h>
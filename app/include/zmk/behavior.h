@@ -20,6 +20,9 @@ struct zmk_behavior_binding {
     const char *behavior_dev;
     uint32_t param1;
     uint32_t param2;
+    // Behavior device resolved from behavior_dev, if already known. NULL means unresolved; see
+    // zmk_behavior_binding_get_device().
+    const struct device *device;
 };
 
 struct zmk_behavior_binding_event {
@@ -45,6 +48,16 @@ struct zmk_behavior_binding_event {
  */
 const struct device *zmk_behavior_get_binding(const char *name);
 
+/**
+ * @brief Get the behavior device for a binding.
+ *
+ * @param binding Behavior binding to resolve.
+ *
+ * @retval The cached @p binding->device if set, otherwise the result of looking up
+ *         @p binding->behavior_dev with zmk_behavior_get_binding().
+ */
+const struct device *zmk_behavior_binding_get_device(const struct zmk_behavior_binding *binding);
+
 /**
  * @brief Invoke a behavior given its binding and invoking event details.
  *
@@ -12,3 +12,57 @@
 
 int zmk_behavior_queue_add(const struct zmk_behavior_binding_event *event,
                            const struct zmk_behavior_binding behavior, bool press, uint32_t wait);
+
+/**
+ * @brief Queue a number of taps of the same binding as a single queue entry.
+ *
+ * Each press is held for @p tap_ms, and the next press follows its release right away, as if
+ * each press and release had been queued with zmk_behavior_queue_add().
+ *
+ * @retval 0 on success, or if @p taps is zero.
+ * @retval -ENOMSG if the queue is full.
+ */
+int zmk_behavior_queue_add_taps(const struct zmk_behavior_binding_event *event,
+                                const struct zmk_behavior_binding binding, uint16_t taps,
+                                uint32_t tap_ms);
+
+#if CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS > 0
+
+/**
+ * @brief A single behavior invocation produced by a queue cursor.
+ */
+struct zmk_behavior_queue_step {
+    struct zmk_behavior_binding binding;
+    bool press;
+    uint32_t wait;
+};
+
+#define ZMK_BEHAVIOR_QUEUE_CURSOR_STATE_SIZE 64
+
+/**
+ * @brief Produce the next step of a queued cursor.
+ *
+ * @param state The cursor's own copy of the state passed to zmk_behavior_queue_add_cursor().
+ * @param step Filled in with the next behavior to invoke.
+ * @retval true if @p step was filled in, false once the cursor is exhausted.
+ */
+typedef bool (*zmk_behavior_queue_cursor_next_t)(void *state,
+                                                 struct zmk_behavior_queue_step *step);
+
+/**
+ * @brief Queue a sequence of behaviors that is expanded lazily.
+ *
+ * The cursor takes a single queue entry. Once the queue reaches it, @p next is called for each
+ * step in turn until it returns false, and only then does the queue move on.
+ *
+ * @param state Copied into the cursor, at most ZMK_BEHAVIOR_QUEUE_CURSOR_STATE_SIZE bytes.
+ * @retval 0 on success.
+ * @retval -ENOMEM if all of the CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS cursors are in use.
+ * @retval -EINVAL if @p state_len is too large.
+ * @retval -ENOMSG if the queue is full.
+ */
+int zmk_behavior_queue_add_cursor(const struct zmk_behavior_binding_event *event,
+                                  zmk_behavior_queue_cursor_next_t next, const void *state,
+                                  size_t state_len);
+
+#endif // CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS > 0
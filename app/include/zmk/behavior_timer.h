@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
+
+struct zmk_behavior_timer;
+
+typedef void (*zmk_behavior_timer_handler_t)(struct zmk_behavior_timer *timer);
+
+/**
+ * @brief A behavior timeout, run from a timer wheel shared by all behaviors.
+ *
+ * Starting and cancelling a timer are constant time, and all timers are driven by a single
+ * delayable work item on the input work queue, which also runs the handlers. Timers that are due
+ * while kscan events are still queued run once those events are raised, so behaviors can first
+ * check the event timestamps against their deadlines.
+ */
+struct zmk_behavior_timer {
+    sys_dnode_t node;
+    int64_t deadline;
+    zmk_behavior_timer_handler_t handler;
+#if CONFIG_ZMK_CONTEXT_COUNT > 1
+    // The context the timer was started in, which its handler runs in.
+    uint8_t context;
+#endif
+};
+
+void zmk_behavior_timer_init(struct zmk_behavior_timer *timer,
+                             zmk_behavior_timer_handler_t handler);
+
+/**
+ * @brief (Re)start @p timer to run its handler once the uptime reaches @p deadline.
+ *
+ * A deadline that has already passed runs the handler as soon as possible.
+ */
+void zmk_behavior_timer_start(struct zmk_behavior_timer *timer, int64_t deadline);
+
+/**
+ * @brief Stop @p timer, if it is pending. Its handler won't run until it is started again.
+ */
+void zmk_behavior_timer_cancel(struct zmk_behavior_timer *timer);
+
+bool zmk_behavior_timer_is_pending(const struct zmk_behavior_timer *timer);
@@ -32,6 +32,12 @@ bt_addr_le_t *zmk_ble_profile_address(uint8_t index);
 
 bt_addr_le_t *zmk_ble_active_profile_addr(void);
 struct bt_conn *zmk_ble_active_profile_conn(void);
+struct bt_conn *zmk_ble_profile_conn(uint8_t index);
+
+/**
+ * Returns a bit mask of the profiles that are connected, by profile index.
+ */
+uint32_t zmk_ble_connected_profiles(void);
 
 bool zmk_ble_profile_is_connected(uint8_t index);
 bool zmk_ble_profile_is_open(uint8_t index);
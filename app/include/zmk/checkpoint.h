@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+/**
+ * @brief Write a checkpoint of the keyboard to @p path.
+ *
+ * The checkpoint is the settings image, with everything saved so far and the active and locked
+ * layers. An instance started with the ZMK_SETTINGS_TEMPLATE environment variable set to the
+ * checkpoint boots in that state.
+ *
+ * @retval 0 on success.
+ * @retval -EBUSY while a key change is queued, a key is held or reported in any context, a combo,
+ *         hold-tap, sticky key, tap dance or caps word is active, or behaviors such as the rest of
+ *         a macro are still queued.
+ */
+int zmk_checkpoint_save(const char *path);
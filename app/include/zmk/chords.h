@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/devicetree.h>
+
+#define ZMK_CHORDS_UTIL_ONE(n) +1
+
+#define ZMK_CHORDS_LEN                                                                             \
+    COND_CODE_1(DT_HAS_COMPAT_STATUS_OKAY(zmk_chords),                                             \
+                (0 DT_FOREACH_CHILD_STATUS_OKAY(DT_INST(0, zmk_chords), ZMK_CHORDS_UTIL_ONE)),     \
+                (0))
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <errno.h>
+#include <stdint.h>
+
+/*
+ * Runtime state of a keyboard, kept once per context so that one process can run several
+ * keyboards with the same keymap, e.g. a host simulating many of them. The keymap bindings,
+ * behavior devices and timer wheel are shared; what each context gets its own copy of are the HID
+ * reports and their coalescing, the active layers, the held positions and the state of hold-taps,
+ * combos, sticky keys, caps word and tap dances.
+ *
+ * A module keeps its state in a struct and defines one instance per context with
+ * ZMK_CONTEXT_STATE_DEFINE, then reaches the one of the current context with ZMK_CONTEXT_STATE.
+ * Key changes carry the context of their keyboard through the kscan queue, see
+ * zmk_physical_layouts_kscan_context_changed(), which selects it while raising their position
+ * events. Behavior timers run in the context they were started in, queued behavior steps, e.g.
+ * those of macros, in the context they were queued in, and coalesced reports are sent from the
+ * context they were made in.
+ *
+ * With CONFIG_ZMK_CONTEXT_COUNT at 1, ZMK_CONTEXT_STATE is the address of a plain static, so
+ * single keyboard builds don't pay for any of this.
+ */
+
+#define ZMK_CONTEXT_COUNT CONFIG_ZMK_CONTEXT_COUNT
+
+#if ZMK_CONTEXT_COUNT > 1
+
+extern uint8_t zmk_context_current;
+
+static inline uint8_t zmk_context_index(void) { return zmk_context_current; }
+
+/**
+ * @brief Make @p index the context that events and state lookups apply to.
+ *
+ * The selection isn't per thread, so all work that selects a context runs on the input work queue
+ * (see zmk_workqueue_input_work_q()), and this asserts that it's called from there.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if @p index isn't below ZMK_CONTEXT_COUNT.
+ */
+int zmk_context_select(uint8_t index);
+
+#else
+
+static inline uint8_t zmk_context_index(void) { return 0; }
+
+static inline int zmk_context_select(uint8_t index) { return index == 0 ? 0 : -EINVAL; }
+
+#endif
+
+/**
+ * @brief Define static state @p name of @p type for every context, each initialized to the
+ * initializer that follows the type, e.g. {} for all zeros.
+ */
+#define ZMK_CONTEXT_STATE_DEFINE(name, type, ...)                                                  \
+    static type name[ZMK_CONTEXT_COUNT] = {[0 ... ZMK_CONTEXT_COUNT - 1] = __VA_ARGS__}
+
+/** Pointer to the state @p name of the current context. */
+#define ZMK_CONTEXT_STATE(name) (&(name)[zmk_context_index()])
+
+/** Iterate @p ptr over the state @p name of every context. */
+#define ZMK_CONTEXT_STATE_FOREACH(name, ptr)                                                       \
+    for (ptr = &(name)[0]; ptr < &(name)[ZMK_CONTEXT_COUNT]; ptr++)
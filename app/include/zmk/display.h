@@ -10,16 +10,62 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <string.h>
+
+#include <zephyr/sys/slist.h>
+#include <zephyr/sys/util.h>
+
+#if IS_ENABLED(CONFIG_ZMK_DISPLAY)
+#include <lvgl.h>
+#endif
+
 struct k_work_q *zmk_display_work_q(void);
 
 bool zmk_display_is_initialized(void);
 int zmk_display_init(void);
 
+/**
+ * @brief Ask for the display to be refreshed once changed LVGL objects are due to be redrawn.
+ *
+ * The display is only ticked promptly while LVGL has work pending, so anything that changes the
+ * UI outside of `ZMK_DISPLAY_WIDGET_LISTENER` should call this afterwards. Otherwise the change
+ * waits for the `CONFIG_ZMK_DISPLAY_IDLE_TICK_PERIOD_MS` fallback tick, if that's enabled.
+ * Requests made within one `CONFIG_ZMK_DISPLAY_TICK_PERIOD_MS` are served by the same refresh.
+ */
+void zmk_display_request_refresh(void);
+
+#if IS_ENABLED(CONFIG_ZMK_DISPLAY)
+
+/**
+ * @brief Set the text of an LVGL label, unless it already shows @p text.
+ *
+ * LVGL invalidates a label whenever its text is set, so widgets whose state can change without
+ * changing what they show, e.g. a battery level drawn as a symbol, use this to skip the redraw.
+ */
+void zmk_display_label_set_text(lv_obj_t *label, const char *text);
+
+#endif
+
+struct zmk_display_widget_listener {
+    sys_snode_t node;
+    bool pending;
+    void (*update)(void);
+};
+
+/**
+ * @brief Queue the update of a widget listener for the next display tick.
+ *
+ * Listeners marked any number of times before the tick are updated once, in the order they
+ * were first marked, so a burst of events costs a single LVGL update per widget.
+ */
+void zmk_display_widget_listener_mark_pending(struct zmk_display_widget_listener *listener);
+
 /**
  * @brief Macro to define a ZMK event listener that handles the thread safety of fetching
- * the necessary state from the system work queue context, invoking a work callback
- * in the display queue context, and properly accessing that state safely when performing
- * display/LVGL updates.
+ * the necessary state from the system work queue context, invoking a callback
+ * in the display queue context on the next display tick, and properly accessing that state
+ * safely when performing display/LVGL updates.
  *
  * @param listener THe ZMK Event manager listener name.
  * @param state_type The struct/enum type used to store/transfer state.
@@ -29,18 +75,35 @@ int zmk_display_init(void);
  * Should be `state type func(const zmk_event_t *eh)` signature.
  * @retval listener##_init Generates a function `listener##_init` that should be called by the
  * widget once ready to be updated.
+ *
+ * Only the latest state fetched before a tick is shown. The callback is only invoked when it
+ * differs from the state last passed to it, so the state type should hold everything the UI
+ * shows. States are compared byte for byte, so a difference in padding only costs a redundant
+ * update.
  **/
 #define ZMK_DISPLAY_WIDGET_LISTENER(listener, state_type, cb, state_func)                          \
     K_MUTEX_DEFINE(listener##_mutex);                                                              \
     static state_type __##listener##_state;                                                        \
+    static state_type __##listener##_applied_state;                                                \
     static state_type listener##_get_local_state() {                                               \
         k_mutex_lock(&listener##_mutex, K_FOREVER);                                                \
         state_type copy = __##listener##_state;                                                    \
         k_mutex_unlock(&listener##_mutex);                                                         \
         return copy;                                                                               \
     };                                                                                             \
-    static void listener##_work_cb(struct k_work *work) { cb(listener##_get_local_state()); };     \
-    K_WORK_DEFINE(listener##_work, listener##_work_cb);                                            \
+    static void listener##_apply_state(state_type state) {                                         \
+        memcpy(&__##listener##_applied_state, &state, sizeof(state_type));                         \
+        cb(state);                                                                                 \
+    };                                                                                             \
+    static void listener##_update() {                                                              \
+        state_type state = listener##_get_local_state();                                           \
+        if (memcmp(&state, &__##listener##_applied_state, sizeof(state_type)) != 0) {              \
+            listener##_apply_state(state);                                                         \
+        }                                                                                          \
+    };                                                                                             \
+    static struct zmk_display_widget_listener listener##_widget_listener = {                       \
+        .update = listener##_update,                                                               \
+    };                                                                                             \
     static void listener##_refresh_state(const zmk_event_t *eh) {                                  \
         k_mutex_lock(&listener##_mutex, K_FOREVER);                                                \
         __##listener##_state = state_func(eh);                                                     \
@@ -48,12 +111,12 @@ int zmk_display_init(void);
     };                                                                                             \
     static void listener##_init() {                                                                \
         listener##_refresh_state(NULL);                                                            \
-        listener##_work_cb(NULL);                                                                  \
+        listener##_apply_state(listener##_get_local_state());                                      \
     }                                                                                              \
     static int listener##_cb(const zmk_event_t *eh) {                                              \
         if (zmk_display_is_initialized()) {                                                        \
             listener##_refresh_state(eh);                                                          \
-            k_work_submit_to_queue(zmk_display_work_q(), &listener##_work);                        \
+            zmk_display_widget_listener_mark_pending(&listener##_widget_listener);                 \
         }                                                                                          \
         return ZMK_EV_EVENT_BUBBLE;                                                                \
     }                                                                                              \
@@ -8,6 +8,7 @@
 
 #include <zmk/ble.h>
 #include <zmk/endpoints_types.h>
+#include <zmk/hid.h>
 
 /**
  * Recommended length of string buffer for printing endpoint identifiers.
@@ -104,8 +105,55 @@ int zmk_endpoint_send_report(uint16_t usage_page);
  * Sends the HID mouse report to the selected endpoint.
  */
 int zmk_endpoint_send_mouse_report();
+
+/**
+ * Merges the motion of the next `count` mouse reports to the selected endpoint into the report
+ * sent after them, for sources that produce parts of the same frame one after the other.
+ * Reports to other endpoints aren't counted. Has no effect if
+ * CONFIG_ZMK_POINTING_MAX_REPORT_RATE is 0.
+ */
+void zmk_endpoint_merge_mouse_reports(uint8_t count);
+
+/**
+ * Serializes changes to the HID mouse report with sending it. Motion held back by
+ * CONFIG_ZMK_POINTING_MAX_REPORT_RATE is sent from the system work queue, so whatever sets the
+ * fields of the mouse report, sends it and clears them again holds this lock throughout.
+ */
+void zmk_endpoint_mouse_report_lock(void);
+
+void zmk_endpoint_mouse_report_unlock(void);
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
+/**
+ * Sets the keyboard report layout sent to an endpoint instance.
+ *
+ * @retval -ENOTSUP if @p format needs a report the keyboard isn't built to maintain.
+ * @retval -EINVAL if the keyboard has no such endpoint.
+ */
+int zmk_endpoint_set_keyboard_report_format(struct zmk_endpoint_instance endpoint,
+                                            enum zmk_hid_keyboard_report_format format);
+
+/**
+ * Gets the keyboard report layout sent to an endpoint instance, or the native one if the keyboard
+ * has no such endpoint.
+ */
+enum zmk_hid_keyboard_report_format
+zmk_endpoint_get_keyboard_report_format(struct zmk_endpoint_instance endpoint);
+
+/**
+ * Returns whether the selected endpoint has no room left to queue another keyboard report.
+ *
+ * Sending a report anyway replaces the last queued one, so senders of long report sequences
+ * should wait for this to clear.
+ */
+bool zmk_endpoint_keyboard_report_queue_full(void);
+
+/**
+ * Returns the number of keyboard and consumer reports that were not sent because they were
+ * identical to the last one sent to the selected endpoint.
+ */
+uint32_t zmk_endpoint_get_skipped_report_count(void);
+
 /**
  * Clears all HID reports for the selected endpoint.
  */
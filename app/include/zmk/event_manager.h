@@ -10,15 +10,41 @@
 #include <zephyr/kernel.h>
 #include <zephyr/types.h>
 
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+struct zmk_event_stats {
+    uint32_t raised;
+    uint32_t listeners_invoked;
+    uint32_t captured;
+    uint64_t cycles;
+};
+#endif
+
+/* Range of an event type's subscriptions in the event manager's dispatch table. */
+struct zmk_event_subscribers {
+    uint16_t start;
+    uint16_t count;
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+    struct zmk_event_stats stats;
+#endif
+};
+
 struct zmk_event_type {
     const char *name;
+    /* sizeof(struct <name>_event), for copies made by the event manager. */
+    size_t size;
+    struct zmk_event_subscribers *subscribers;
 };
 
 typedef struct {
     const struct zmk_event_type *event;
-    uint8_t last_listener_index;
+    uint16_t last_listener_index;
 } zmk_event_t;
 
+/* Handle to an event held in the event manager's capture pool. */
+typedef int16_t zmk_event_handle_t;
+
+#define ZMK_EVENT_HANDLE_NONE ((zmk_event_handle_t)-1)
+
 #define ZMK_EV_EVENT_BUBBLE 0
 #define ZMK_EV_EVENT_HANDLED 1
 #define ZMK_EV_EVENT_CAPTURED 2
@@ -26,6 +52,11 @@ typedef struct {
 typedef int (*zmk_listener_callback_t)(const zmk_event_t *eh);
 struct zmk_listener {
     zmk_listener_callback_t callback;
+    /*
+     * For listeners declared with ZMK_LISTENER_WHEN_ACTIVE, whether they currently want events.
+     * Dispatch passes over them while it is false. NULL for listeners that get every event.
+     */
+    const bool *active;
 };
 
 struct zmk_event_subscription {
@@ -39,23 +70,40 @@ struct zmk_event_subscription {
         struct event_type data;                                                                    \
     };                                                                                             \
     struct event_type##_event copy_raised_##event_type(const struct event_type *ev);               \
+    zmk_event_handle_t capture_##event_type(const struct event_type *ev);                          \
     int raise_##event_type(struct event_type);                                                     \
+    int raise_ref_##event_type(const struct event_type *data);                                     \
     struct event_type *as_##event_type(const zmk_event_t *eh);                                     \
     extern const struct zmk_event_type zmk_event_##event_type;
 
 #define ZMK_EVENT_IMPL(event_type)                                                                 \
-    const struct zmk_event_type zmk_event_##event_type = {.name = STRINGIFY(event_type)};          \
+    BUILD_ASSERT(sizeof(struct event_type##_event) <= CONFIG_ZMK_EVENT_POOL_SLOT_SIZE,             \
+                 STRINGIFY(event_type) " doesn't fit in CONFIG_ZMK_EVENT_POOL_SLOT_SIZE");         \
+    static struct zmk_event_subscribers zmk_event_subscribers_##event_type;                        \
+    const struct zmk_event_type zmk_event_##event_type = {                                         \
+        .name = STRINGIFY(event_type),                                                             \
+        .size = sizeof(struct event_type##_event),                                                 \
+        .subscribers = &zmk_event_subscribers_##event_type};                                       \
     const struct zmk_event_type *zmk_event_ref_##event_type __used                                 \
         __attribute__((__section__(".event_type"))) = &zmk_event_##event_type;                     \
     struct event_type##_event copy_raised_##event_type(const struct event_type *ev) {              \
         struct event_type##_event *outer = CONTAINER_OF(ev, struct event_type##_event, data);      \
         return *outer;                                                                             \
     };                                                                                             \
+    zmk_event_handle_t capture_##event_type(const struct event_type *ev) {                         \
+        struct event_type##_event *outer = CONTAINER_OF(ev, struct event_type##_event, data);      \
+        return zmk_event_pool_capture(&outer->header, sizeof(*outer));                             \
+    };                                                                                             \
     int raise_##event_type(struct event_type data) {                                               \
         struct event_type##_event ev = {.data = data,                                              \
                                         .header = {.event = &zmk_event_##event_type}};             \
         return ZMK_EVENT_RAISE(ev);                                                                \
     };                                                                                             \
+    int raise_ref_##event_type(const struct event_type *data) {                                    \
+        struct event_type##_event ev = {.data = *data,                                             \
+                                        .header = {.event = &zmk_event_##event_type}};             \
+        return ZMK_EVENT_RAISE(ev);                                                                \
+    };                                                                                             \
     struct event_type *as_##event_type(const zmk_event_t *eh) {                                    \
         return (eh->event == &zmk_event_##event_type) ? &((struct event_type##_event *)eh)->data   \
                                                       : NULL;                                      \
@@ -63,6 +111,17 @@ struct zmk_event_subscription {
 
 #define ZMK_LISTENER(mod, cb) const struct zmk_listener zmk_listener_##mod = {.callback = cb};
 
+/*
+ * A listener that is only called while it marks itself active with ZMK_LISTENER_SET_ACTIVE, for
+ * features that ignore every event while idle. It starts out inactive.
+ */
+#define ZMK_LISTENER_WHEN_ACTIVE(mod, cb)                                                          \
+    static bool zmk_listener_active_##mod;                                                         \
+    const struct zmk_listener zmk_listener_##mod = {.callback = cb,                                \
+                                                    .active = &zmk_listener_active_##mod};
+
+#define ZMK_LISTENER_SET_ACTIVE(mod, is_active) (zmk_listener_active_##mod = (is_active))
+
 #define ZMK_SUBSCRIPTION(mod, ev_type)                                                             \
     extern const struct zmk_listener zmk_listener_##mod;                                           \
     const Z_DECL_ALIGN(struct zmk_event_subscription)                                              \
@@ -72,6 +131,14 @@ struct zmk_event_subscription {
             .listener = &zmk_listener_##mod,                                                       \
     };
 
+/*
+ * Define @p name as an event of @p event_type whose data is filled in place, then raised with
+ * ZMK_EVENT_RAISE. Unlike raise_<event_type>(), which takes the data by value and copies it into
+ * the event again, this copies nothing, which counts for large events such as zmk_sensor_event.
+ */
+#define ZMK_EVENT_INIT(event_type, name)                                                           \
+    struct event_type##_event name = {.header = {.event = &zmk_event_##event_type}}
+
 #define ZMK_EVENT_RAISE(ev) zmk_event_manager_raise(&(ev).header)
 
 #define ZMK_EVENT_RAISE_AFTER(ev, mod)                                                             \
@@ -81,7 +148,50 @@ struct zmk_event_subscription {
 
 #define ZMK_EVENT_RELEASE(ev) zmk_event_manager_release(&(ev).header)
 
+#define ZMK_EVENT_POOL_RAISE_AFTER(handle, mod)                                                    \
+    zmk_event_pool_raise_after(handle, &zmk_listener_##mod)
+
+#define ZMK_EVENT_POOL_RAISE_AT(handle, mod) zmk_event_pool_raise_at(handle, &zmk_listener_##mod)
+
 int zmk_event_manager_raise(zmk_event_t *event);
 int zmk_event_manager_raise_after(zmk_event_t *event, const struct zmk_listener *listener);
 int zmk_event_manager_raise_at(zmk_event_t *event, const struct zmk_listener *listener);
-int zmk_event_manager_release(zmk_event_t *event);
\ No newline at end of file
+int zmk_event_manager_release(zmk_event_t *event);
+
+/**
+ * Copy a raised event, header included, into the capture pool.
+ *
+ * Use the generated capture_<event_type>() rather than calling this directly.
+ * @return a handle, -ENOMEM if the pool is full or -EMSGSIZE if the event
+ *         does not fit in a slot.
+ */
+zmk_event_handle_t zmk_event_pool_capture(const zmk_event_t *event, size_t size);
+
+/** The pooled event behind @p handle, valid until the handle is freed. */
+zmk_event_t *zmk_event_pool_get(zmk_event_handle_t handle);
+
+/** Return a pooled event's slot without dispatching it. */
+void zmk_event_pool_free(zmk_event_handle_t handle);
+
+/*
+ * Dispatch a pooled event like the zmk_event_manager_* function of the same
+ * name, then free its slot.  The slot stays valid during dispatch, so
+ * listeners may capture the event again.  If the raise is deferred, the
+ * queue takes over the slot instead of copying the event again.
+ */
+int zmk_event_pool_raise(zmk_event_handle_t handle);
+int zmk_event_pool_raise_after(zmk_event_handle_t handle, const struct zmk_listener *listener);
+int zmk_event_pool_raise_at(zmk_event_handle_t handle, const struct zmk_listener *listener);
+int zmk_event_pool_release(zmk_event_handle_t handle);
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+typedef void (*zmk_event_stats_cb_t)(const struct zmk_event_type *type,
+                                     const struct zmk_event_stats *stats, void *user_data);
+
+/**
+ * Call @p cb with the dispatch counters of every event type.  @p cb may be
+ * NULL to only count the event types.
+ * @return the number of event types visited.
+ */
+size_t zmk_event_manager_stats_foreach(zmk_event_stats_cb_t cb, void *user_data);
+#endif
\ No newline at end of file
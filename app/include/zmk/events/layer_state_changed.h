@@ -13,12 +13,22 @@ struct zmk_layer_state_changed {
     uint8_t layer;
     bool state;
     bool locked;
+    // The states of every layer just before and after this layer changed. When several layers
+    // change at once, one event is raised per layer, in the order they changed.
+    uint32_t old_layers_state;
+    uint32_t layers_state;
     int64_t timestamp;
 };
 
 ZMK_EVENT_DECLARE(zmk_layer_state_changed);
 
-static inline int raise_layer_state_changed(uint8_t layer, bool state, bool locked) {
-    return raise_zmk_layer_state_changed((struct zmk_layer_state_changed){
-        .layer = layer, .state = state, .locked = locked, .timestamp = k_uptime_get()});
+static inline int raise_layer_state_changed(uint8_t layer, bool state, bool locked,
+                                            uint32_t old_layers_state, uint32_t layers_state) {
+    return raise_zmk_layer_state_changed(
+        (struct zmk_layer_state_changed){.layer = layer,
+                                         .state = state,
+                                         .locked = locked,
+                                         .old_layers_state = old_layers_state,
+                                         .layers_state = layers_state,
+                                         .timestamp = k_uptime_get()});
 }
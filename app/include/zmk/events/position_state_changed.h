@@ -13,6 +13,8 @@
 
 struct zmk_position_state_changed {
     uint8_t source;
+    // context of the keyboard the key belongs to, see zmk/context.h
+    uint8_t context;
     uint32_t position;
     bool state;
     int64_t timestamp;
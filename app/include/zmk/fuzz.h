@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+// Whether each module is left without any state for a key, which the fuzzing harness checks once
+// every key of an input has been released and all of their timeouts have expired. Checkpoints are
+// only taken while they all hold.
+
+bool zmk_combos_idle(void);
+bool zmk_behavior_hold_tap_idle(void);
+bool zmk_behavior_sticky_key_idle(void);
+bool zmk_behavior_tap_dance_idle(void);
+
+// Checkpoints also wait out state that outlives the keys by design: caps word until a word breaks
+// it, and behavior queue items, e.g. the rest of a macro, until they have all been invoked.
+
+bool zmk_behavior_caps_word_idle(void);
+bool zmk_behavior_queue_idle(void);
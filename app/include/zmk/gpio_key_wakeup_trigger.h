@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Milliseconds from reset to the first key press sent to a connected endpoint, when the
+ * device was woken by a trigger key.
+ *
+ * @retval -1 if the device wasn't woken by a trigger key with a position, or no key was sent yet.
+ */
+int64_t zmk_gpio_key_wakeup_trigger_first_key_ms(void);
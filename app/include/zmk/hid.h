@@ -43,6 +43,16 @@
 
 #define ZMK_HID_MOUSE_NUM_BUTTONS 0x05
 
+/**
+ * Layouts a keyboard report can be sent to an endpoint in.
+ */
+enum zmk_hid_keyboard_report_format {
+    /** The HKRO or NKRO report the keyboard is configured with */
+    ZMK_HID_KEYBOARD_REPORT_FORMAT_NATIVE,
+    /** The 6KRO boot keyboard report, if CONFIG_ZMK_HID_BOOT_REPORT is enabled */
+    ZMK_HID_KEYBOARD_REPORT_FORMAT_BOOT,
+};
+
 // See https://www.usb.org/sites/default/files/hid1_11.pdf section 6.2.2.4 Main Items
 
 #define ZMK_HID_MAIN_VAL_DATA (0x00 << 0)
@@ -255,7 +265,7 @@ static const uint8_t zmk_hid_report_desc[] = {
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 };
 
-#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+#if IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT)
 
 #define HID_ERROR_ROLLOVER 0x1
 #define HID_BOOT_KEY_LEN 6
@@ -348,11 +358,33 @@ bool zmk_hid_mod_is_pressed(zmk_mod_t modifier);
 
 int zmk_hid_register_mods(zmk_mod_flags_t explicit_modifiers);
 int zmk_hid_unregister_mods(zmk_mod_flags_t explicit_modifiers);
-int zmk_hid_implicit_modifiers_press(zmk_mod_flags_t implicit_modifiers);
-int zmk_hid_implicit_modifiers_release(void);
+
+/**
+ * @brief Apply the implicit modifiers of a press of @p usage, in place of the ones of the previous
+ * press.
+ *
+ * The modifiers are owned by @p usage until zmk_hid_implicit_modifiers_release() for it, so
+ * releasing another key that carried some of the same modifiers doesn't drop them.
+ */
+int zmk_hid_implicit_modifiers_press(uint32_t usage, zmk_mod_flags_t implicit_modifiers);
+
+/**
+ * @brief Drop the implicit modifiers owned by @p usage that no other held key carries.
+ */
+int zmk_hid_implicit_modifiers_release(uint32_t usage);
 int zmk_hid_masked_modifiers_set(zmk_mod_flags_t masked_modifiers);
 int zmk_hid_masked_modifiers_clear(void);
 
+/**
+ * @brief Force @p modifiers on and @p masked_modifiers off in the report, over the explicit,
+ * implicit and masked ones, until zmk_hid_override_modifiers_clear().
+ *
+ * For a behavior that writes reports on its own, e.g. to type text, without changing the
+ * modifiers that the keys and behaviors around it set and later restore.
+ */
+int zmk_hid_override_modifiers_set(zmk_mod_flags_t modifiers, zmk_mod_flags_t masked_modifiers);
+int zmk_hid_override_modifiers_clear(void);
+
 int zmk_hid_keyboard_press(zmk_key_t key);
 int zmk_hid_keyboard_release(zmk_key_t key);
 void zmk_hid_keyboard_clear(void);
@@ -383,7 +415,7 @@ void zmk_hid_mouse_clear(void);
 struct zmk_hid_keyboard_report *zmk_hid_get_keyboard_report(void);
 struct zmk_hid_consumer_report *zmk_hid_get_consumer_report(void);
 
-#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+#if IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT)
 zmk_hid_boot_report_t *zmk_hid_get_boot_report();
 #endif
 
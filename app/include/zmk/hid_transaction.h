@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * A batch of changes to the HID reports that are sent together. Change the reports with the
+ * zmk_hid_* functions as usual and mark each report changed, then commit: only the reports that
+ * changed are sent, the keyboard report (with the modifiers) before the consumer report.
+ *
+ * When the host has to see a change before a later one, e.g. a key release before the same key
+ * is pressed again, zmk_hid_transaction_send() sends a changed report right away. A report that
+ * hasn't changed since is then not sent again on commit.
+ */
+struct zmk_hid_transaction {
+    // reports changed since they were last sent
+    uint8_t changed;
+    // reports sent so far
+    uint8_t sent;
+};
+
+void zmk_hid_transaction_begin(struct zmk_hid_transaction *txn);
+
+/** Mark the report of @p usage_page changed. Modifiers are part of the HID_USAGE_KEY report. */
+void zmk_hid_transaction_mark(struct zmk_hid_transaction *txn, uint16_t usage_page);
+
+/**
+ * Send the report of @p usage_page now, if it changed since it was last sent in @p txn.
+ *
+ * @retval 0 if the report was sent or didn't need to be.
+ * @retval <0 the error of sending the report.
+ */
+int zmk_hid_transaction_send(struct zmk_hid_transaction *txn, uint16_t usage_page);
+
+/**
+ * Send every report that changed since it was last sent in @p txn, keyboard first.
+ *
+ * @retval 0 if the reports were sent or none needed to be.
+ * @retval <0 the first error of sending a report.
+ */
+int zmk_hid_transaction_commit(struct zmk_hid_transaction *txn);
+
+/**
+ * Returns the number of reports that weren't sent because nothing in them had changed since the
+ * transaction last sent them.
+ */
+uint32_t zmk_hid_transaction_get_saved_report_count(void);
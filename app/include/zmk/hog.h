@@ -11,6 +11,16 @@
 
 int zmk_hog_send_keyboard_report(struct zmk_hid_keyboard_report_body *body);
 int zmk_hog_send_consumer_report(struct zmk_hid_consumer_report_body *body);
+bool zmk_hog_keyboard_report_queue_full(void);
+
+#if IS_ENABLED(CONFIG_ZMK_BLE_MIRROR)
+/**
+ * Sets the profiles, as a bit mask of profile indexes, whose hosts also get every HID report sent
+ * to the active profile while they are connected.
+ */
+int zmk_hog_set_mirror_profiles(uint32_t profiles);
+uint32_t zmk_hog_get_mirror_profiles(void);
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_MIRROR)
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 int zmk_hog_send_mouse_report(struct zmk_hid_mouse_report_body *body);
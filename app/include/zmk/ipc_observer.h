@@ -8,34 +8,77 @@
 
 #include <zephyr/kernel.h>
 
+#include <zmk/endpoints_types.h>
+
 #if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER)
 
 /**
  * Notify IPC clients that a keyboard HID report is being sent to an endpoint.
- * @param transport_str Human-readable transport name (e.g. "USB", "BLE:0", "None")
+ * @param endpoint Endpoint the report is sent to
  */
-void zmk_ipc_observer_notify_keyboard_report(const char *transport_str);
+void zmk_ipc_observer_notify_keyboard_report(const struct zmk_endpoint_instance *endpoint);
 
 /**
  * Notify IPC clients that a consumer HID report is being sent to an endpoint.
- * @param transport_str Human-readable transport name
+ * @param endpoint Endpoint the report is sent to
  */
-void zmk_ipc_observer_notify_consumer_report(const char *transport_str);
+void zmk_ipc_observer_notify_consumer_report(const struct zmk_endpoint_instance *endpoint);
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 /**
  * Notify IPC clients that a mouse HID report is being sent to an endpoint.
- * @param transport_str Human-readable transport name
+ * @param endpoint Endpoint the report is sent to
  */
-void zmk_ipc_observer_notify_mouse_report(const char *transport_str);
+void zmk_ipc_observer_notify_mouse_report(const struct zmk_endpoint_instance *endpoint);
 #endif /* IS_ENABLED(CONFIG_ZMK_POINTING) */
 
 #else /* !IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER) */
 
-static inline void zmk_ipc_observer_notify_keyboard_report(const char *transport_str) {}
-static inline void zmk_ipc_observer_notify_consumer_report(const char *transport_str) {}
+static inline void
+zmk_ipc_observer_notify_keyboard_report(const struct zmk_endpoint_instance *endpoint) {}
+static inline void
+zmk_ipc_observer_notify_consumer_report(const struct zmk_endpoint_instance *endpoint) {}
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
-static inline void zmk_ipc_observer_notify_mouse_report(const char *transport_str) {}
+static inline void
+zmk_ipc_observer_notify_mouse_report(const struct zmk_endpoint_instance *endpoint) {}
 #endif
 
 #endif /* IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER) */
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_LATENCY_TRACE)
+
+/**
+ * Record the kscan callback time of a traced key event injected over IPC.
+ * Does nothing when @p seq is 0 (event not traced).
+ * @param row        Matrix row passed to the kscan callback
+ * @param col        Matrix column passed to the kscan callback
+ * @param seq        Client sequence number from KeyEvent.seq
+ * @param client_ts  Opaque client timestamp from KeyEvent.client_ts
+ */
+void zmk_ipc_observer_trace_kscan(uint32_t row, uint32_t col, uint32_t seq, uint64_t client_ts);
+
+/**
+ * Like zmk_ipc_observer_trace_kscan(), for a key event injected as a key
+ * position of the active physical layout.
+ * @param position   Key position queued for the event
+ * @param seq        Client sequence number from KeyEvent.seq
+ * @param client_ts  Opaque client timestamp from KeyEvent.client_ts
+ */
+void zmk_ipc_observer_trace_position(uint32_t position, uint32_t seq, uint64_t client_ts);
+
+/**
+ * Record that the position event for @p position is being raised.  The
+ * trace, if any, is attached to the next keyboard report.
+ * @param position Key position about to be raised
+ */
+void zmk_ipc_observer_trace_raise(uint32_t position);
+
+#else
+
+static inline void zmk_ipc_observer_trace_kscan(uint32_t row, uint32_t col, uint32_t seq,
+                                                uint64_t client_ts) {}
+static inline void zmk_ipc_observer_trace_position(uint32_t position, uint32_t seq,
+                                                   uint64_t client_ts) {}
+static inline void zmk_ipc_observer_trace_raise(uint32_t position) {}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_LATENCY_TRACE) */
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <errno.h>
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+/*
+ * Timing statistics of the keys, kept on the device with CONFIG_ZMK_KEY_STATS to tune hold-tap
+ * terms and combo timeouts: how long each position is held, the interval from one key press to
+ * the next and how the hold-taps at each position were decided.
+ *
+ * buckets[0] counts samples under 1 ms, buckets[i] those of [2^(i-1), 2^i) ms, and the last
+ * bucket also counts everything longer.
+ */
+#define ZMK_KEY_STATS_BUCKETS 16
+
+struct zmk_key_stats {
+    uint32_t samples;
+    uint32_t max_ms;
+    uint32_t buckets[ZMK_KEY_STATS_BUCKETS];
+    // Hold-tap decisions; a retro-tap is a hold turned into a tap, so it's moved out of holds.
+    uint32_t holds;
+    uint32_t taps;
+    uint32_t retro_taps;
+};
+
+enum zmk_key_stats_hold_tap {
+    ZMK_KEY_STATS_HOLD_TAP_HOLD,
+    ZMK_KEY_STATS_HOLD_TAP_TAP,
+    ZMK_KEY_STATS_HOLD_TAP_RETRO_TAP,
+};
+
+#if IS_ENABLED(CONFIG_ZMK_KEY_STATS)
+
+/** Count @p decision of the hold-tap at @p position. */
+void zmk_key_stats_hold_tap(uint32_t position, enum zmk_key_stats_hold_tap decision);
+
+/**
+ * Copy the press durations and hold-tap decisions of @p position since boot into @p stats.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if @p position isn't a keymap position.
+ */
+int zmk_key_stats_get(uint32_t position, struct zmk_key_stats *stats);
+
+/** Copy the intervals from one key press to the next since boot into @p stats. */
+void zmk_key_stats_get_intervals(struct zmk_key_stats *stats);
+
+#else
+
+static inline void zmk_key_stats_hold_tap(uint32_t position, enum zmk_key_stats_hold_tap decision) {
+}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_KEY_STATS) */
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <zmk/behavior.h>
 #include <zmk/events/position_state_changed.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/devicetree.h>
@@ -52,6 +53,19 @@ int zmk_keymap_layer_activate(zmk_keymap_layer_id_t layer, bool locking);
 int zmk_keymap_layer_deactivate(zmk_keymap_layer_id_t layer, bool locking);
 int zmk_keymap_layer_toggle(zmk_keymap_layer_id_t layer, bool locking);
 int zmk_keymap_layer_to(zmk_keymap_layer_id_t layer, bool locking);
+
+/**
+ * @brief Set the state of several layers at once.
+ *
+ * Each layer in @p mask is activated if it's in @p state, and deactivated otherwise, as with
+ * zmk_keymap_layer_activate() and zmk_keymap_layer_deactivate(). Layers in @p locking are changed
+ * as locking. Every layer is changed before one layer state changed event is raised for each
+ * of them, so listeners see the whole change from the first event.
+ *
+ * Layers outside of @p mask keep their state.
+ */
+int zmk_keymap_layers_set(zmk_keymap_layers_state_t state, zmk_keymap_layers_state_t mask,
+                          zmk_keymap_layers_state_t locking);
 const char *zmk_keymap_layer_name(zmk_keymap_layer_id_t layer);
 
 const struct zmk_behavior_binding *zmk_keymap_get_layer_binding_at_idx(zmk_keymap_layer_id_t layer,
@@ -59,6 +73,28 @@ const struct zmk_behavior_binding *zmk_keymap_get_layer_binding_at_idx(zmk_keyma
 int zmk_keymap_set_layer_binding_at_idx(zmk_keymap_layer_id_t layer, uint16_t binding_idx,
                                         const struct zmk_behavior_binding binding);
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_PACKED_BINDINGS)
+
+struct zmk_keymap_local_binding {
+    zmk_behavior_local_id_t behavior_local_id;
+    uint32_t param1;
+    uint32_t param2;
+};
+
+/**
+ * @brief Get the behavior local ID and params bound at @p binding_idx on @p layer.
+ *
+ * Reads the packed keymap directly, without resolving the behavior by name.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if the layer or binding index is invalid.
+ * @retval -ENODEV if no behavior is bound there.
+ */
+int zmk_keymap_get_layer_local_binding_at_idx(zmk_keymap_layer_id_t layer, uint16_t binding_idx,
+                                              struct zmk_keymap_local_binding *binding);
+
+#endif
+
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
 int zmk_keymap_add_layer(void);
@@ -80,6 +116,14 @@ int zmk_keymap_set_layer_name(zmk_keymap_layer_id_t id, const char *name, size_t
 int zmk_keymap_check_unsaved_changes(void);
 
 int zmk_keymap_save_changes(void);
+
+/**
+ * @brief Write the saved keymap changes that are still waiting for their debounce.
+ *
+ * Unsaved changes are left as they are. Other settings still wait for zmk_settings_flush().
+ */
+void zmk_keymap_flush_saved_changes(void);
+
 int zmk_keymap_discard_changes(void);
 int zmk_keymap_reset_settings(void);
 
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Set the runtime log level of a ZMK log module, for all backends.
+ *
+ * Besides the main "zmk" module, hot paths log to modules of their own, e.g. "zmk_event_manager",
+ * "zmk_keymap", "zmk_combo", "zmk_behavior_queue" and "zmk_hid", so their debug messages can be
+ * turned on or off without the rest. Needs CONFIG_LOG_RUNTIME_FILTERING, and can't raise a module
+ * above the level it was built with.
+ *
+ * @param module The log module name, or NULL for every module whose name starts with "zmk".
+ * @param level One of the LOG_LEVEL_* values.
+ *
+ * @retval the number of modules changed.
+ * @retval -ENOENT if no module matched.
+ */
+int zmk_logging_set_level(const char *module, uint32_t level);
@@ -62,4 +62,68 @@ int zmk_physical_layouts_get_position_map(uint8_t source, uint8_t dest, size_t m
  * @retval a negative errno value in the case of errors
  * @retval a positive length of the position map array that map is updated to point to.
  */
-int zmk_physical_layouts_get_selected_to_stock_position_map(uint32_t const **map);
\ No newline at end of file
+int zmk_physical_layouts_get_selected_to_stock_position_map(uint32_t const **map);
+
+/**
+ * @brief Wait until the queue of kscan events for the active layout has room for another event
+ *
+ * Kscan sources that can hold back their input, such as ones reading from a socket, call this
+ * before reporting an event, so bursts are delayed instead of dropped once
+ * CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE events are waiting. Must not be called from an ISR.
+ *
+ * @retval 0 once there is room
+ * @retval -EAGAIN if the timeout expired first
+ */
+int zmk_physical_layouts_kscan_wait_for_space(k_timeout_t timeout);
+
+/**
+ * @brief Queue a key position change, skipping the matrix transform of the active layout
+ *
+ * For sources that already know the key position, such as the kscan IPC driver. The position is
+ * one of the active layout, as its matrix transform would produce, so the keymap maps it to the
+ * stock layout like any other. The event is raised from the same queue as kscan events, in
+ * order with them.
+ *
+ * @param timestamp Uptime in milliseconds to raise the position event with
+ *
+ * @retval 0 once queued
+ * @retval -EINVAL if the position is out of range
+ * @retval -ENOSPC if the queue was full and the event was dropped
+ */
+int zmk_physical_layouts_kscan_position_changed(uint32_t position, bool pressed,
+                                               int64_t timestamp);
+
+/**
+ * @brief Queue a key change of the keyboard of another context
+ *
+ * For sources that scan a keyboard of their own, other than the kscan device of the active
+ * layout, when CONFIG_ZMK_CONTEXT_COUNT runs several. The row and column go through the matrix
+ * transform of the active layout, and the position event is raised with @p context selected.
+ *
+ * @retval 0 once queued
+ * @retval -EINVAL if @p context isn't below ZMK_CONTEXT_COUNT
+ * @retval -ENOSPC if the queue was full and the event was dropped
+ */
+int zmk_physical_layouts_kscan_context_changed(uint8_t context, uint32_t row, uint32_t column,
+                                              bool pressed);
+
+/**
+ * @brief Whether kscan events are queued and not yet raised
+ *
+ * Their timestamps are all in the past, so timeouts that are due defer to them, letting the
+ * events decide by their own timestamps whether they came before the timeout.
+ */
+bool zmk_physical_layouts_kscan_pending(void);
+
+/**
+ * @brief Get the number of kscan events dropped because the queue was full
+ */
+uint32_t zmk_physical_layouts_kscan_dropped_events(void);
+
+/**
+ * @brief Get the number of kscan events taken off the queue since boot, wrapping around
+ *
+ * Together with CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE, a source that is alone in feeding the queue can
+ * tell how many more events fit without waiting.
+ */
+uint32_t zmk_physical_layouts_kscan_taken_events(void);
\ No newline at end of file
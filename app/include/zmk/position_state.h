@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Which key positions are held, as raised by zmk_position_state_changed events, kept once for
+ * every module. It is updated before hold-taps, combos or any other listener can capture the
+ * event, so it reflects the physical keys rather than what the keymap has processed so far.
+ *
+ * Positions are tracked per source, with ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL for the keys of
+ * this half and the peripheral index for those of a split peripheral.
+ */
+
+typedef void (*zmk_position_state_cb_t)(uint32_t position, void *user_data);
+
+/** Whether @p position is held by any source. */
+bool zmk_position_state_is_pressed(uint32_t position);
+
+/** Whether @p position is held by @p source. */
+bool zmk_position_state_source_is_pressed(uint8_t source, uint32_t position);
+
+/** The number of positions held by all sources together. */
+uint32_t zmk_position_state_pressed_count(void);
+
+/** The latest timestamp of the position events raised so far, from any source. */
+int64_t zmk_position_state_last_timestamp(void);
+
+/** Call @p cb with every position held by any source, lowest first. */
+void zmk_position_state_foreach_pressed(zmk_position_state_cb_t cb, void *user_data);
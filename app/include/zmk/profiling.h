@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+/*
+ * Static markers for profiling native builds with perf, enabled by CONFIG_ZMK_PROFILING. Each
+ * marker is a USDT probe of provider "zmk", which costs a single nop until a tracer attaches:
+ *
+ * - keystroke_start(position, pressed) and keystroke_end(position, pressed) bracket the dispatch
+ *   of one kscan event, so samples between them belong to that keystroke.
+ * - event_raise(name) for every raised event, with the event type name, e.g.
+ *   "zmk_keycode_state_changed".
+ * - behavior_invoke(name, position, pressed) for every behavior binding invoked, with the
+ *   behavior device name.
+ * - report_send(usage_page) for every report sent to the current endpoint.
+ *
+ * app/scripts/perf_keystrokes.py turns `perf script` output of a recording with these markers
+ * into a flame graph per keystroke.
+ */
+
+#if IS_ENABLED(CONFIG_ZMK_PROFILING)
+
+#include <sys/sdt.h>
+
+#define ZMK_PROFILING_MARK1(name, a) DTRACE_PROBE1(zmk, name, a)
+#define ZMK_PROFILING_MARK2(name, a, b) DTRACE_PROBE2(zmk, name, a, b)
+#define ZMK_PROFILING_MARK3(name, a, b, c) DTRACE_PROBE3(zmk, name, a, b, c)
+
+#else
+
+#define ZMK_PROFILING_MARK1(name, a)
+#define ZMK_PROFILING_MARK2(name, a, b)
+#define ZMK_PROFILING_MARK3(name, a, b, c)
+
+#endif /* IS_ENABLED(CONFIG_ZMK_PROFILING) */
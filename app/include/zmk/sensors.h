@@ -20,6 +20,15 @@
 
 const struct zmk_sensor_config *zmk_sensors_get_config_at_index(uint8_t sensor_index);
 
+/**
+ * Raise a reading for a keymap sensor as if its device had reported it, on the sensor's rotation
+ * channel and subject to the same event rate limiting. Blocks while earlier injected readings are
+ * still waiting to be raised, so it must not be called from the system work queue.
+ *
+ * @return 0 on success, -EINVAL if there is no sensor at that index.
+ */
+int zmk_sensors_inject(uint8_t sensor_index, const struct sensor_value *value);
+
 struct zmk_sensor_config {
     uint16_t triggers_per_rotation;
 };
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <stddef.h>
+
 /**
  * Erases all saved settings.
  *
@@ -13,3 +15,38 @@
  * subsystem. This should typically be followed by a call to sys_reboot().
  */
 int zmk_settings_erase(void);
+
+/**
+ * Loads all saved settings at boot.
+ *
+ * With CONFIG_ZMK_SETTINGS_DEFERRED_LOAD, lighting settings are loaded later from the low
+ * priority work queue, so the keymap and connections are ready sooner.
+ */
+int zmk_settings_load(void);
+
+/**
+ * Saves a setting once the settings save debounce has passed.
+ *
+ * Saves from every subsystem are written together in one flush, and only with their last value.
+ * Saving the value a key already has is skipped, and so is writing a value that is already stored
+ * in flash. Values too large for the cache are written immediately.
+ */
+int zmk_settings_save(const char *name, const void *value, size_t len);
+
+/**
+ * Deletes a setting, dropping any save of it that is still waiting to be written.
+ */
+int zmk_settings_delete(const char *name);
+
+/**
+ * Writes every waiting setting now, e.g. before powering off or reloading settings.
+ */
+int zmk_settings_flush(void);
+
+/**
+ * Writes a copy of the settings image to @p path, with @p name set to @p value in the copy only.
+ *
+ * The copy can be used as the ZMK_SETTINGS_TEMPLATE of other instances. Saves still waiting for
+ * the debounce aren't in it, so flush them first. Only available with CONFIG_ZMK_SETTINGS_MMAP.
+ */
+int zmk_settings_export(const char *path, const char *name, const void *value, size_t len);
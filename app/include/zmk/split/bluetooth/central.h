@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/types.h>
+
+struct zmk_split_bt_link_stats {
+    // connection interval, in units of 1.25 ms
+    uint16_t interval;
+    // number of connection events the peripheral may skip
+    uint16_t latency;
+    // key position changes received along with their timing
+    uint32_t edges;
+    // key position changes the peripheral dropped instead of sending
+    uint32_t dropped_edges;
+    // Milliseconds from a key position change to the peripheral sending it. The one-way latency
+    // adds the wait for the next connection event, up to one interval.
+    uint16_t last_delay_ms;
+    uint16_t avg_delay_ms;
+    uint16_t max_delay_ms;
+};
+
+int zmk_split_bt_central_get_link_stats(uint8_t source, struct zmk_split_bt_link_stats *stats);
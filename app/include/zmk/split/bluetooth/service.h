@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <zephyr/sys/util.h>
+
+#include <zmk/behavior.h>
 #include <zmk/events/sensor_event.h>
 #include <zmk/sensors.h>
 
@@ -31,9 +34,72 @@ struct zmk_split_run_behavior_payload {
     char behavior_dev[ZMK_SPLIT_RUN_BEHAVIOR_DEV_LEN];
 } __packed;
 
+// Invokes a behavior by the local ID both halves derive from its device name. The header is
+// followed by param1 and param2 as varints, seven bits per byte starting from the lowest, with the
+// top bit set on every byte but the last.
+struct zmk_split_run_behavior_compact_header {
+    // little endian
+    zmk_behavior_local_id_t local_id;
+    uint8_t position;
+    uint8_t source;
+    uint8_t state;
+} __packed;
+
+#define ZMK_SPLIT_VARINT_MAX_LEN 5
+
+#define ZMK_SPLIT_RUN_BEHAVIOR_COMPACT_MAX_LEN                                                     \
+    (sizeof(struct zmk_split_run_behavior_compact_header) + 2 * ZMK_SPLIT_VARINT_MAX_LEN)
+
+static inline size_t zmk_split_varint_put(uint8_t *buf, uint32_t value) {
+    size_t len = 0;
+
+    while (value >= 0x80) {
+        buf[len++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    buf[len++] = value;
+
+    return len;
+}
+
+// Returns the number of bytes read, or 0 if the buffer ends before the value does
+static inline size_t zmk_split_varint_get(const uint8_t *buf, size_t len, uint32_t *value) {
+    uint32_t result = 0;
+
+    for (size_t i = 0; i < MIN(len, ZMK_SPLIT_VARINT_MAX_LEN); i++) {
+        result |= (uint32_t)(buf[i] & 0x7F) << (7 * i);
+        if (!(buf[i] & 0x80)) {
+            *value = result;
+            return i + 1;
+        }
+    }
+
+    return 0;
+}
+
 struct zmk_split_input_event_payload {
     uint8_t type;
     uint16_t code;
     uint32_t value;
     uint8_t sync;
 } __packed;
+
+// Set in the age of a key position edge when the key was pressed
+#define ZMK_SPLIT_POSITION_EDGE_PRESSED BIT(15)
+// The largest age of a key position edge, in milliseconds. Older edges are sent with this age.
+#define ZMK_SPLIT_POSITION_EDGE_AGE_MAX (ZMK_SPLIT_POSITION_EDGE_PRESSED - 1)
+
+struct zmk_split_position_edge {
+    uint8_t position;
+    // little endian, the milliseconds from the change to the notification, and the new state
+    uint16_t age_and_state;
+} __packed;
+
+// Keeps a full notification within the 20 bytes the default ATT MTU allows.
+#define ZMK_SPLIT_POSITION_EDGES_MAX 6
+
+struct zmk_split_position_edges_payload {
+    // sequence number of the first edge, counting every edge the peripheral queued
+    uint8_t seq;
+    struct zmk_split_position_edge edges[ZMK_SPLIT_POSITION_EDGES_MAX];
+} __packed;
@@ -20,3 +20,5 @@
 #define ZMK_SPLIT_BT_UPDATE_HID_INDICATORS_UUID ZMK_BT_SPLIT_UUID(0x00000004)
 #define ZMK_SPLIT_BT_SELECT_PHYS_LAYOUT_UUID ZMK_BT_SPLIT_UUID(0x00000005)
 #define ZMK_SPLIT_BT_INPUT_EVENT_UUID ZMK_BT_SPLIT_UUID(0x00000006)
+#define ZMK_SPLIT_BT_CHAR_POSITION_EDGES_UUID ZMK_BT_SPLIT_UUID(0x00000007)
+#define ZMK_SPLIT_BT_CHAR_RUN_BEHAVIOR_COMPACT_UUID ZMK_BT_SPLIT_UUID(0x00000008)
@@ -26,7 +26,14 @@
 #define WIRED_PERIPHERAL_COUNT 0
 #endif
 
-#define ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT MAX(BLE_PERIPHERAL_COUNT, WIRED_PERIPHERAL_COUNT)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_IPC)
+#define IPC_PERIPHERAL_COUNT CONFIG_ZMK_SPLIT_IPC_CENTRAL_PERIPHERALS
+#else
+#define IPC_PERIPHERAL_COUNT 0
+#endif
+
+#define ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT                                                         \
+    MAX(MAX(BLE_PERIPHERAL_COUNT, WIRED_PERIPHERAL_COUNT), IPC_PERIPHERAL_COUNT)
 
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 #include <zmk/hid_indicators_types.h>
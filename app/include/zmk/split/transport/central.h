@@ -37,6 +37,13 @@ int zmk_split_transport_central_peripheral_event_handler(
     const struct zmk_split_transport_central *transport, uint8_t source,
     struct zmk_split_transport_peripheral_event ev);
 
+// Handles an event that happened at the given uptime of the central, for transports that carry
+// the time of the event from the peripheral instead of relying on the time it arrived. Key
+// position events are never raised before the last position event of any source.
+int zmk_split_transport_central_peripheral_event_handler_at(
+    const struct zmk_split_transport_central *transport, uint8_t source,
+    struct zmk_split_transport_peripheral_event ev, int64_t timestamp);
+
 #define ZMK_SPLIT_TRANSPORT_CENTRAL_REGISTER(name, _api, priority)                                 \
     STRUCT_SECTION_ITERABLE_NAMED(zmk_split_transport_central, _CONCAT(priority, _##name),         \
                                   name) = {                                                        \
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+/*
+ * Stages of the key press path timed with CONFIG_ZMK_STAGE_TIMING.  Stages
+ * nest: a position dispatch includes the behaviors it invokes, and those
+ * include the keycode handling and endpoint sends they trigger.
+ */
+enum zmk_stage {
+    /* From the kscan callback until the event is taken off the kscan queue. */
+    ZMK_STAGE_KSCAN_QUEUE,
+    /* Raising a position event to all of its listeners. */
+    ZMK_STAGE_POSITION_DISPATCH,
+    /* One zmk_behavior_invoke_binding() call. */
+    ZMK_STAGE_BEHAVIOR,
+    /* The HID listener handling a keycode event. */
+    ZMK_STAGE_KEYCODE,
+    /* Sending a keyboard or consumer report to the current endpoint. */
+    ZMK_STAGE_ENDPOINT_SEND,
+    ZMK_STAGE_COUNT,
+};
+
+/*
+ * buckets[0] counts samples of 0 cycles, buckets[i] those of [2^(i-1), 2^i)
+ * cycles, and the last bucket also counts everything longer.
+ */
+#define ZMK_STAGE_TIMING_BUCKETS 32
+
+struct zmk_stage_timing {
+    uint32_t samples;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    uint32_t buckets[ZMK_STAGE_TIMING_BUCKETS];
+};
+
+#if IS_ENABLED(CONFIG_ZMK_STAGE_TIMING)
+
+static inline uint32_t zmk_stage_timing_start(void) { return k_cycle_get_32(); }
+
+/**
+ * Record the cycles since @p start, as returned by zmk_stage_timing_start(),
+ * as one sample of @p stage.
+ */
+void zmk_stage_timing_end(enum zmk_stage stage, uint32_t start);
+
+/** @return the name of @p stage, e.g. "behavior". */
+const char *zmk_stage_timing_name(enum zmk_stage stage);
+
+/** Copy the histogram of @p stage since boot into @p timing. */
+void zmk_stage_timing_get(enum zmk_stage stage, struct zmk_stage_timing *timing);
+
+#else
+
+static inline uint32_t zmk_stage_timing_start(void) { return 0; }
+static inline void zmk_stage_timing_end(enum zmk_stage stage, uint32_t start) {}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_STAGE_TIMING) */
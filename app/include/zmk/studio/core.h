@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <stddef.h>
+
 #include <zmk/event_manager.h>
 
 enum zmk_studio_core_lock_state {
@@ -28,4 +30,13 @@ void zmk_studio_core_lock();
 void zmk_studio_core_initiate_unlock();
 void zmk_studio_core_complete_unlock();
 
+/*
+ * Called by a transport when the host @p peer, identified by something the transport has
+ * authenticated, disconnects or connects. Unless CONFIG_ZMK_STUDIO_LOCK_RESUME_TIMEOUT_SEC is set,
+ * suspending locks and resuming does nothing. Suspending and resuming an unlocked session raise
+ * zmk_studio_core_lock_state_changed, as the session reads as locked while it's suspended.
+ */
+void zmk_studio_core_suspend(const void *peer, size_t len);
+void zmk_studio_core_resume(const void *peer, size_t len);
+
 void zmk_studio_core_reschedule_lock_timeout();
\ No newline at end of file
@@ -201,12 +201,24 @@ typedef int (*zmk_rpc_rx_start_stop_func)(void);
 typedef void (*zmk_rpc_tx_buffer_notify_func)(struct ring_buf *buf, size_t added, bool message_done,
                                               void *user_data);
 typedef void *(*zmk_rpc_tx_user_data_func)(void);
+typedef size_t (*zmk_rpc_tx_chunk_size_func)(void);
+
+enum zmk_rpc_transport_framing {
+    // SOF and EOF around each message, with those and ESC escaped inside it
+    ZMK_RPC_TRANSPORT_FRAMING_BYTE_STUFFED,
+    // Each message preceded by its 4 byte big endian length, as in the IPC wire format
+    ZMK_RPC_TRANSPORT_FRAMING_LENGTH_PREFIXED,
+};
 
 struct zmk_rpc_transport {
     enum zmk_transport transport;
+    enum zmk_rpc_transport_framing framing;
 
     zmk_rpc_tx_user_data_func tx_user_data;
     zmk_rpc_tx_buffer_notify_func tx_notify;
+    // Optional, bytes to buffer between calls to tx_notify, such as the payload size of a packet.
+    // Half of the TX buffer if not set.
+    zmk_rpc_tx_chunk_size_func tx_chunk_size;
     zmk_rpc_rx_start_stop_func rx_start;
     zmk_rpc_rx_start_stop_func rx_stop;
 };
@@ -218,12 +230,21 @@ zmk_studio_Response zmk_rpc_subsystem_delegate_to_subs(const struct zmk_rpc_subs
 struct ring_buf *zmk_rpc_get_tx_buf(void);
 struct ring_buf *zmk_rpc_get_rx_buf(void);
 void zmk_rpc_rx_notify(void);
+// Called by transports as they consume bytes from the TX buffer, waking the encoder if it's full
+void zmk_rpc_tx_space_notify(void);
 
-#define ZMK_RPC_TRANSPORT(name, _transport, _rx_start, _rx_stop, _tx_user_data, _tx_notify)        \
+#define ZMK_RPC_TRANSPORT_FRAMED(name, _transport, _framing, _rx_start, _rx_stop, _tx_user_data,   \
+                                 _tx_notify, _tx_chunk_size)                                       \
     STRUCT_SECTION_ITERABLE(zmk_rpc_transport, name) = {                                           \
         .transport = _transport,                                                                   \
+        .framing = _framing,                                                                       \
         .rx_start = _rx_start,                                                                     \
         .rx_stop = _rx_stop,                                                                       \
         .tx_user_data = _tx_user_data,                                                             \
         .tx_notify = _tx_notify,                                                                   \
+        .tx_chunk_size = _tx_chunk_size,                                                           \
     }
+
+#define ZMK_RPC_TRANSPORT(name, _transport, _rx_start, _rx_stop, _tx_user_data, _tx_notify)        \
+    ZMK_RPC_TRANSPORT_FRAMED(name, _transport, ZMK_RPC_TRANSPORT_FRAMING_BYTE_STUFFED, _rx_start,  \
+                             _rx_stop, _tx_user_data, _tx_notify, NULL)
\ No newline at end of file
@@ -6,11 +6,18 @@
 
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
 
 int zmk_usb_hid_send_keyboard_report(void);
 int zmk_usb_hid_send_consumer_report(void);
+bool zmk_usb_hid_keyboard_report_queue_full(void);
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 int zmk_usb_hid_send_mouse_report(void);
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 void zmk_usb_hid_set_protocol(uint8_t protocol);
+
+/**
+ * @brief Drop the queued reports and any write in progress, after the bus was reset.
+ */
+void zmk_usb_hid_reset(void);
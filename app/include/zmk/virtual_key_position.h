@@ -8,6 +8,7 @@
 
 #include <zmk/matrix.h>
 #include <zmk/combos.h>
+#include <zmk/chords.h>
 #include <zmk/input_listeners.h>
 #include <zmk/sensors.h>
 
@@ -27,6 +28,12 @@
 #define ZMK_VIRTUAL_KEY_POSITION_COMBO(index)                                                      \
     (ZMK_VIRTUAL_KEY_POSITION_SENSOR(ZMK_KEYMAP_SENSORS_LEN) + (index))
 
+/**
+ * Gets the virtual key position to use for the chord with the given index.
+ */
+#define ZMK_VIRTUAL_KEY_POSITION_CHORD(index)                                                      \
+    (ZMK_VIRTUAL_KEY_POSITION_COMBO(ZMK_COMBOS_LEN) + (index))
+
 #define ZMK_VIRTUAL_KEY_POSITION_BEHAVIOR_INPUT_PROCESSOR(listener_index, processor_index)         \
-    (ZMK_VIRTUAL_KEY_POSITION_COMBO(ZMK_COMBOS_LEN) +                                              \
+    (ZMK_VIRTUAL_KEY_POSITION_CHORD(ZMK_CHORDS_LEN) +                                              \
      (ZMK_INPUT_LISTENERS_LEN * (processor_index)) + (listener_index))
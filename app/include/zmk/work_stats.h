@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/iterable_sections.h>
+
+/*
+ * Counters of one work item with CONFIG_ZMK_WORK_STATS, plus the high-water
+ * mark of the queue it drains, if any.  Latency is measured from the point a
+ * run was due, i.e. the earliest submit, or scheduled time for delayable
+ * work, that the run serves.
+ */
+struct zmk_work_stats {
+    const char *name;
+    /* Capacity of the queue the work item drains, 0 if it has none. */
+    uint32_t queue_capacity;
+    uint32_t queue_high_water;
+    uint32_t submitted;
+    uint32_t runs;
+    uint32_t max_latency_cycles;
+    uint64_t total_latency_cycles;
+    uint32_t max_run_cycles;
+    uint64_t total_run_cycles;
+    /* Cycle count the next run is due at, while submitted and not yet run. */
+    uint32_t due_cycles;
+    bool pending;
+};
+
+#if IS_ENABLED(CONFIG_ZMK_WORK_STATS)
+
+/**
+ * Define the counters of work item @p _name, which drains a queue of
+ * @p _queue_capacity entries, or none if 0.
+ */
+#define ZMK_WORK_STATS_DEFINE(_name, _queue_capacity)                                              \
+    static STRUCT_SECTION_ITERABLE(zmk_work_stats, _CONCAT(_zmk_work_stats_, _name)) = {           \
+        .name = STRINGIFY(_name),                                                                  \
+        .queue_capacity = (_queue_capacity),                                                       \
+    }
+
+#define ZMK_WORK_STATS(_name) (&_CONCAT(_zmk_work_stats_, _name))
+
+/**
+ * Record that the work item was submitted to run in @p delay_ms.  A submit
+ * before a pending run is due only moves it earlier, as resubmitting pending
+ * work doesn't delay it.
+ */
+void zmk_work_stats_submit(struct zmk_work_stats *stats, uint32_t delay_ms);
+
+/** Record that the queue the work item drains now holds @p used entries. */
+void zmk_work_stats_queue_depth(struct zmk_work_stats *stats, uint32_t used);
+
+/**
+ * Record the start of a run from the work handler.
+ * @return the cycle count to pass to zmk_work_stats_run_end().
+ */
+uint32_t zmk_work_stats_run_start(struct zmk_work_stats *stats);
+
+void zmk_work_stats_run_end(struct zmk_work_stats *stats, uint32_t start);
+
+typedef void (*zmk_work_stats_cb_t)(const struct zmk_work_stats *stats, void *user_data);
+
+/**
+ * Call @p cb with a copy of the counters of every work item.  @p cb may be
+ * NULL to only count the work items.
+ * @return the number of work items visited.
+ */
+size_t zmk_work_stats_foreach(zmk_work_stats_cb_t cb, void *user_data);
+
+#else
+
+/* Only a declaration, so the semicolon after it is still valid at file scope */
+#define ZMK_WORK_STATS_DEFINE(_name, _queue_capacity)                                              \
+    extern struct zmk_work_stats _CONCAT(_zmk_work_stats_, _name)
+#define ZMK_WORK_STATS(_name) NULL
+
+static inline void zmk_work_stats_submit(struct zmk_work_stats *stats, uint32_t delay_ms) {}
+static inline void zmk_work_stats_queue_depth(struct zmk_work_stats *stats, uint32_t used) {}
+static inline uint32_t zmk_work_stats_run_start(struct zmk_work_stats *stats) { return 0; }
+static inline void zmk_work_stats_run_end(struct zmk_work_stats *stats, uint32_t start) {}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_WORK_STATS) */
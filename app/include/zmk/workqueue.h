@@ -1 +1,16 @@
+#pragma once
+
+#include <zephyr/kernel.h>
+
 struct k_work_q *zmk_workqueue_lowprio_work_q(void);
+
+/*
+ * The work queue that processes key input: kscan and split peripheral events, sensor readings,
+ * combo timeouts, behavior timers, two-axis input ticks and the behavior queue. This is the system
+ * work queue unless CONFIG_ZMK_INPUT_WORK_QUEUE is enabled.
+ */
+#if IS_ENABLED(CONFIG_ZMK_INPUT_WORK_QUEUE)
+struct k_work_q *zmk_workqueue_input_work_q(void);
+#else
+static inline struct k_work_q *zmk_workqueue_input_work_q(void) { return &k_sys_work_q; }
+#endif
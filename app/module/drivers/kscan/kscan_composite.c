@@ -18,19 +18,13 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 struct kscan_composite_child_config {
     const struct device *child;
-    uint8_t row_offset;
-    uint8_t column_offset;
+    /** Forwards the events of this child to the composite, with its offsets applied. */
+    kscan_callback_t callback;
 };
 
-#define CHILD_CONFIG(inst)                                                                         \
-    {.child = DEVICE_DT_GET(DT_PHANDLE(inst, kscan)),                                              \
-     .row_offset = DT_PROP(inst, row_offset),                                                      \
-     .column_offset = DT_PROP_OR(inst, col_offset, DT_PROP(inst, column_offset))},
-
-struct kscan_composite_config {
-    const struct kscan_composite_child_config *children;
-    size_t children_len;
-};
+#define CHILD_ROW_OFFSET(inst) DT_PROP(inst, row_offset)
+#define CHILD_COLUMN_OFFSET(inst) DT_PROP_OR(inst, col_offset, DT_PROP(inst, column_offset))
+#define CHILD_CALLBACK_NAME(inst) _CONCAT(kscan_composite_child_callback_, inst)
 
 struct kscan_composite_data {
     kscan_callback_t callback;
@@ -38,6 +32,30 @@ struct kscan_composite_data {
     const struct device *dev;
 };
 
+static void kscan_composite_forward(const struct device *dev, uint32_t row, uint32_t column,
+                                    bool pressed) {
+    struct kscan_composite_data *data = dev->data;
+
+    data->callback(dev, row, column, pressed);
+}
+
+// Child callbacks don't say which composite they belong to, so each child gets its own callback
+// with the composite and offsets built in, rather than looking them up on every event.
+#define CHILD_CALLBACK(inst)                                                                       \
+    static void CHILD_CALLBACK_NAME(inst)(const struct device *child_dev, uint32_t row,            \
+                                          uint32_t column, bool pressed) {                         \
+        kscan_composite_forward(DEVICE_DT_GET(DT_PARENT(inst)), row + CHILD_ROW_OFFSET(inst),      \
+                                column + CHILD_COLUMN_OFFSET(inst), pressed);                      \
+    }
+
+#define CHILD_CONFIG(inst)                                                                         \
+    {.child = DEVICE_DT_GET(DT_PHANDLE(inst, kscan)), .callback = CHILD_CALLBACK_NAME(inst)},
+
+struct kscan_composite_config {
+    const struct kscan_composite_child_config *children;
+    size_t children_len;
+};
+
 static int kscan_composite_enable_callback(const struct device *dev) {
     const struct kscan_composite_config *cfg = dev->config;
 
@@ -90,32 +108,6 @@ static int kscan_composite_disable_callback(const struct device *dev) {
     return 0;
 }
 
-#define KSCAN_COMP_INST_DEV(n) DEVICE_DT_GET(DT_DRV_INST(n)),
-
-static const struct device *all_instances[] = {DT_INST_FOREACH_STATUS_OKAY(KSCAN_COMP_INST_DEV)};
-
-static void kscan_composite_child_callback(const struct device *child_dev, uint32_t row,
-                                           uint32_t column, bool pressed) {
-    // TODO: Ideally we can get this passed into our callback!
-    for (int i = 0; i < ARRAY_SIZE(all_instances); i++) {
-
-        const struct device *dev = all_instances[i];
-        const struct kscan_composite_config *cfg = dev->config;
-        struct kscan_composite_data *data = dev->data;
-
-        for (int c = 0; c < cfg->children_len; c++) {
-            const struct kscan_composite_child_config *child_cfg = &cfg->children[c];
-
-            if (child_cfg->child != child_dev) {
-                continue;
-            }
-
-            data->callback(dev, row + child_cfg->row_offset, column + child_cfg->column_offset,
-                           pressed);
-        }
-    }
-}
-
 static int kscan_composite_configure(const struct device *dev, kscan_callback_t callback) {
     const struct kscan_composite_config *cfg = dev->config;
     struct kscan_composite_data *data = dev->data;
@@ -127,7 +119,7 @@ static int kscan_composite_configure(const struct device *dev, kscan_callback_t
     for (int i = 0; i < cfg->children_len; i++) {
         const struct kscan_composite_child_config *child_cfg = &cfg->children[i];
 
-        kscan_config(child_cfg->child, &kscan_composite_child_callback);
+        kscan_config(child_cfg->child, child_cfg->callback);
     }
 
     data->callback = callback;
@@ -169,6 +161,7 @@ static int kscan_composite_pm_action(const struct device *dev, enum pm_device_ac
 #endif // IS_ENABLED(CONFIG_PM_DEVICE)
 
 #define KSCAN_COMP_DEV(n)                                                                          \
+    DT_INST_FOREACH_CHILD(n, CHILD_CALLBACK)                                                       \
     static const struct kscan_composite_child_config kscan_composite_children_##n[] = {            \
         DT_INST_FOREACH_CHILD(n, CHILD_CONFIG)};                                                   \
     static const struct kscan_composite_config kscan_composite_config_##n = {                      \
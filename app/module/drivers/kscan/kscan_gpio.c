@@ -8,6 +8,11 @@
 
 #include <stdlib.h>
 
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
 static int compare_ports(const void *a, const void *b) {
     const struct kscan_gpio *gpio_a = a;
     const struct kscan_gpio *gpio_b = b;
@@ -31,3 +36,54 @@ int kscan_gpio_pin_get(const struct kscan_gpio *gpio, struct kscan_gpio_port_sta
 
     return (state->value & BIT(gpio->spec.pin)) != 0;
 }
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_GPIO_WORK_QUEUE)
+
+K_THREAD_STACK_DEFINE(kscan_gpio_q_stack, CONFIG_ZMK_KSCAN_GPIO_WORK_QUEUE_STACK_SIZE);
+
+static struct k_work_q kscan_gpio_work_q;
+
+static int kscan_gpio_work_q_init(void) {
+    static const struct k_work_queue_config queue_config = {.name = "Kscan Work Queue"};
+    k_work_queue_start(&kscan_gpio_work_q, kscan_gpio_q_stack,
+                       K_THREAD_STACK_SIZEOF(kscan_gpio_q_stack),
+                       CONFIG_ZMK_KSCAN_GPIO_WORK_QUEUE_PRIORITY, &queue_config);
+    return 0;
+}
+
+// Started ahead of the kscan drivers, which may schedule their first scan while initializing.
+SYS_INIT(kscan_gpio_work_q_init, POST_KERNEL, 0);
+
+#endif // IS_ENABLED(CONFIG_ZMK_KSCAN_GPIO_WORK_QUEUE)
+
+int kscan_gpio_reschedule(struct k_work_delayable *work, k_timeout_t delay) {
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_GPIO_WORK_QUEUE)
+    return k_work_reschedule_for_queue(&kscan_gpio_work_q, work, delay);
+#else
+    return k_work_reschedule(work, delay);
+#endif
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_GPIO_SCAN_STATS)
+
+void kscan_gpio_scan_stats_record(const struct device *dev, struct kscan_gpio_scan_stats *stats,
+                                  int64_t scheduled_ms) {
+    // Scans are scheduled with K_TIMEOUT_ABS_MS(), which rounds up to the next tick.
+    const int64_t late_ticks = k_uptime_ticks() - (int64_t)k_ms_to_ticks_ceil64(scheduled_ms);
+    const uint32_t late_us = late_ticks > 0 ? (uint32_t)k_ticks_to_us_floor64(late_ticks) : 0;
+
+    stats->scans++;
+    stats->total_late_us += late_us;
+    stats->max_late_us = MAX(stats->max_late_us, late_us);
+
+    if (stats->scans < CONFIG_ZMK_KSCAN_GPIO_SCAN_STATS_INTERVAL) {
+        return;
+    }
+
+    LOG_INF("%s: %u scans started %u us late on average, %u us at most", dev->name, stats->scans,
+            (uint32_t)(stats->total_late_us / stats->scans), stats->max_late_us);
+
+    *stats = (struct kscan_gpio_scan_stats){0};
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KSCAN_GPIO_SCAN_STATS)
@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/gpio.h>
+#include <zephyr/kernel.h>
 #include <zephyr/dt-bindings/gpio/gpio.h>
 #include <zephyr/sys/util.h>
 
@@ -32,6 +33,28 @@ struct kscan_gpio_list {
 #define KSCAN_GPIO_LIST(gpio_array)                                                                \
     ((struct kscan_gpio_list){.gpios = gpio_array, .len = ARRAY_SIZE(gpio_array)})
 
+/** The keys of a debounce profile child node, as listed in its keys property. */
+struct kscan_gpio_debounce_profile {
+    const uint16_t *keys;
+    size_t keys_len;
+};
+
+/** The struct zmk_debounce_config of a debounce profile child node. */
+#define KSCAN_GPIO_DEBOUNCE_PROFILE_CONFIG(node_id)                                                \
+    {                                                                                              \
+        .debounce_press_ms = DT_PROP(node_id, debounce_press_ms),                                  \
+        .debounce_release_ms = DT_PROP(node_id, debounce_release_ms),                              \
+    }
+
+/** The struct kscan_gpio_debounce_profile of a debounce profile child node. */
+#define KSCAN_GPIO_DEBOUNCE_PROFILE(node_id)                                                       \
+    {.keys = (const uint16_t[])DT_PROP(node_id, keys), .keys_len = DT_PROP_LEN(node_id, keys)}
+
+#define KSCAN_GPIO_DEBOUNCE_PROFILE_CHECK(node_id)                                                 \
+    BUILD_ASSERT(DT_PROP(node_id, debounce_press_ms) <= DEBOUNCE_COUNTER_MAX &&                    \
+                     DT_PROP(node_id, debounce_release_ms) <= DEBOUNCE_COUNTER_MAX,                \
+                 "debounce-press-ms or debounce-release-ms of a debounce profile is too large")
+
 struct kscan_gpio_port_state {
     const struct device *port;
     gpio_port_value_t value;
@@ -59,3 +82,32 @@ void kscan_gpio_list_sort_by_port(struct kscan_gpio_list *list);
  * @retval -EWOULDBLOCK if operation would block.
  */
 int kscan_gpio_pin_get(const struct kscan_gpio *gpio, struct kscan_gpio_port_state *state);
+
+/**
+ * Schedule a scan at the given time, replacing any scan already scheduled.
+ *
+ * This is k_work_reschedule(), except that with CONFIG_ZMK_KSCAN_GPIO_WORK_QUEUE the work runs on
+ * a dedicated work queue, so scans aren't delayed by other work on the system work queue.
+ */
+int kscan_gpio_reschedule(struct k_work_delayable *work, k_timeout_t delay);
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_GPIO_SCAN_STATS)
+
+struct kscan_gpio_scan_stats {
+    uint32_t scans;
+    uint32_t max_late_us;
+    uint64_t total_late_us;
+};
+
+/**
+ * Record how late a scan started compared to the time it was scheduled for, logging a summary
+ * every CONFIG_ZMK_KSCAN_GPIO_SCAN_STATS_INTERVAL scans.
+ *
+ * @param dev The kscan device, for logging.
+ * @param stats An object to accumulate stats in. Must be zero-initialized before the first use.
+ * @param scheduled_ms The uptime in milliseconds the scan was scheduled for.
+ */
+void kscan_gpio_scan_stats_record(const struct device *dev, struct kscan_gpio_scan_stats *stats,
+                                  int64_t scheduled_ms);
+
+#endif // IS_ENABLED(CONFIG_ZMK_KSCAN_GPIO_SCAN_STATS)
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include "kscan_gpio.h"
+
 #include <zmk/debounce.h>
 
 #include <zephyr/device.h>
@@ -58,6 +60,9 @@ struct kscan_charlieplex_data {
     kscan_callback_t callback;
     struct k_work_delayable work;
     int64_t scan_time; /* Timestamp of the current or scheduled scan. */
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_GPIO_SCAN_STATS)
+    struct kscan_gpio_scan_stats scan_stats;
+#endif
     struct gpio_callback irq_callback;
     /**
      * Current state of the matrix as a flattened 2D array of length
@@ -219,7 +224,7 @@ static void kscan_charlieplex_irq_callback(const struct device *port, struct gpi
     // Disable our interrupt to avoid re-entry while we scan.
     kscan_charlieplex_interrupt_configure(data->dev, GPIO_INT_DISABLE);
     data->scan_time = k_uptime_get();
-    k_work_reschedule(&data->work, K_NO_WAIT);
+    kscan_gpio_reschedule(&data->work, K_NO_WAIT);
 }
 
 static void kscan_charlieplex_read_continue(const struct device *dev) {
@@ -228,7 +233,7 @@ static void kscan_charlieplex_read_continue(const struct device *dev) {
 
     data->scan_time += config->debounce_scan_period_ms;
 
-    k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
+    kscan_gpio_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
 }
 
 static void kscan_charlieplex_read_end(const struct device *dev) {
@@ -242,7 +247,7 @@ static void kscan_charlieplex_read_end(const struct device *dev) {
         data->scan_time += config->poll_period_ms;
 
         // Return to polling slowly.
-        k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
+        kscan_gpio_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
     }
 }
 
@@ -316,6 +321,9 @@ static int kscan_charlieplex_read(const struct device *dev) {
 static void kscan_charlieplex_work_handler(struct k_work *work) {
     struct k_work_delayable *dwork = CONTAINER_OF(work, struct k_work_delayable, work);
     struct kscan_charlieplex_data *data = CONTAINER_OF(dwork, struct kscan_charlieplex_data, work);
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_GPIO_SCAN_STATS)
+    kscan_gpio_scan_stats_record(data->dev, &data->scan_stats, data->scan_time);
+#endif
     kscan_charlieplex_read(data->dev);
 }
 
@@ -6,11 +6,14 @@
 
 #define DT_DRV_COMPAT zmk_kscan_gpio_demux
 
+#include <string.h>
+
 #include <zephyr/device.h>
 #include <zephyr/drivers/kscan.h>
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -28,6 +31,28 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #define INST_DEMUX_GPIOS(n) DT_INST_PROP_LEN(n, output_gpios)
 #define INST_MATRIX_OUTPUTS(n) PWR_TWO(INST_DEMUX_GPIOS(n))
 #define POLL_INTERVAL(n) DT_INST_PROP(n, polling_interval_msec)
+#define INST_STATE_WORDS(n) DIV_ROUND_UP(INST_MATRIX_INPUTS(n) * INST_MATRIX_OUTPUTS(n), 32)
+
+// Drive the demux address pins to select output @p o, in one write when they share a port.
+static void kscan_gpio_demux_select(const struct gpio_dt_spec *cols, size_t len,
+                                    gpio_port_pins_t one_port_mask, int o) {
+    if (one_port_mask) {
+        gpio_port_value_t value = 0;
+
+        for (size_t bit = 0; bit < len; bit++) {
+            if (o & BIT(bit)) {
+                value |= BIT(cols[bit].pin);
+            }
+        }
+
+        gpio_port_set_masked(cols[0].port, one_port_mask, value);
+        return;
+    }
+
+    for (size_t bit = 0; bit < len; bit++) {
+        gpio_pin_set_dt(&cols[bit], (o >> bit) & 1);
+    }
+}
 
 #define GPIO_INST_INIT(n)                                                                          \
     struct kscan_gpio_irq_callback_##n {                                                           \
@@ -45,7 +70,11 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
         kscan_callback_t callback;                                                                 \
         struct k_timer poll_timer;                                                                 \
         struct CHECK_DEBOUNCE_CFG(n, (k_work), (k_work_delayable)) work;                           \
-        bool matrix_state[INST_MATRIX_INPUTS(n)][INST_MATRIX_OUTPUTS(n)];                          \
+        /* Bit r * INST_MATRIX_OUTPUTS(n) + c per key, as last reported and as last read */        \
+        uint32_t matrix_state[INST_STATE_WORDS(n)];                                                \
+        uint32_t read_state[INST_STATE_WORDS(n)];                                                  \
+        /* The address pins, if they're all on one port, 0 otherwise */                            \
+        gpio_port_pins_t one_port_mask;                                                            \
         const struct device *dev;                                                                  \
     };                                                                                             \
     /* IO/GPIO SETUP */                                                                            \
@@ -70,33 +99,35 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     static int kscan_gpio_read_##n(const struct device *dev) {                                     \
         bool submit_follow_up_read = false;                                                        \
         struct kscan_gpio_data_##n *data = dev->data;                                              \
-        static bool read_state[INST_MATRIX_INPUTS(n)][INST_MATRIX_OUTPUTS(n)];                     \
+        memset(data->read_state, 0, sizeof(data->read_state));                                     \
         for (int o = 0; o < INST_MATRIX_OUTPUTS(n); o++) {                                         \
-            /* Iterate over bits and set GPIOs accordingly */                                      \
-            for (uint8_t bit = 0; bit < INST_DEMUX_GPIOS(n); bit++) {                              \
-                uint8_t state = (o & (0b1 << bit)) >> bit;                                         \
-                const struct gpio_dt_spec *out_spec = &kscan_gpio_output_specs_##n(dev)[bit];      \
-                gpio_pin_set_dt(out_spec, state);                                                  \
-            }                                                                                      \
+            kscan_gpio_demux_select(kscan_gpio_output_specs_##n(dev), INST_DEMUX_GPIOS(n),         \
+                                    data->one_port_mask, o);                                       \
             /* Let the col settle before reading the rows */                                       \
-            k_usleep(1);                                                                           \
+            k_busy_wait(DT_INST_PROP(n, settle_us));                                               \
                                                                                                    \
             for (int i = 0; i < INST_MATRIX_INPUTS(n); i++) {                                      \
                 /* Get the input spec */                                                           \
                 const struct gpio_dt_spec *in_spec = &kscan_gpio_input_specs_##n(dev)[i];          \
-                read_state[i][o] = gpio_pin_get_dt(in_spec) > 0;                                   \
+                if (gpio_pin_get_dt(in_spec) > 0) {                                                \
+                    const int key = i * INST_MATRIX_OUTPUTS(n) + o;                                \
+                    data->read_state[key / 32] |= BIT(key % 32);                                   \
+                }                                                                                  \
             }                                                                                      \
         }                                                                                          \
-        for (int r = 0; r < INST_MATRIX_INPUTS(n); r++) {                                          \
-            for (int c = 0; c < INST_MATRIX_OUTPUTS(n); c++) {                                     \
-                bool pressed = read_state[r][c];                                                   \
-                submit_follow_up_read = (submit_follow_up_read || pressed);                        \
-                if (pressed != data->matrix_state[r][c]) {                                         \
-                    LOG_DBG("Sending event at %d,%d state %s", r, c, (pressed ? "on" : "off"));    \
-                    data->matrix_state[r][c] = pressed;                                            \
-                    data->callback(dev, r, c, pressed);                                            \
-                }                                                                                  \
+        for (int w = 0; w < INST_STATE_WORDS(n); w++) {                                            \
+            const uint32_t read = data->read_state[w];                                             \
+            submit_follow_up_read = (submit_follow_up_read || read != 0);                          \
+            for (uint32_t changed = read ^ data->matrix_state[w]; changed;                         \
+                 changed &= changed - 1) {                                                         \
+                const int key = w * 32 + find_lsb_set(changed) - 1;                                \
+                const int r = key / INST_MATRIX_OUTPUTS(n);                                        \
+                const int c = key % INST_MATRIX_OUTPUTS(n);                                        \
+                const bool pressed = (read & BIT(key % 32)) != 0;                                  \
+                LOG_DBG("Sending event at %d,%d state %s", r, c, (pressed ? "on" : "off"));        \
+                data->callback(dev, r, c, pressed);                                                \
             }                                                                                      \
+            data->matrix_state[w] = read;                                                          \
         }                                                                                          \
         if (submit_follow_up_read) {                                                               \
             CHECK_DEBOUNCE_CFG(n, ({ k_work_submit(&data->work); }),                               \
@@ -181,6 +212,13 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
             } else {                                                                               \
                 LOG_DBG("Configured pin %d for output", out_spec->pin);                            \
             }                                                                                      \
+            data->one_port_mask |= BIT(out_spec->pin);                                             \
+        }                                                                                          \
+        for (int o = 1; o < INST_DEMUX_GPIOS(n); o++) {                                            \
+            if (kscan_gpio_output_specs_##n(dev)[o].port !=                                        \
+                kscan_gpio_output_specs_##n(dev)[0].port) {                                        \
+                data->one_port_mask = 0;                                                           \
+            }                                                                                      \
         }                                                                                          \
         data->dev = dev;                                                                           \
                                                                                                    \
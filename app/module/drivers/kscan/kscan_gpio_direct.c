@@ -69,10 +69,19 @@ struct kscan_direct_data {
     int64_t scan_time;
     /** Current state of the inputs as an array of length config->inputs.len */
     struct zmk_debounce_state *pin_state;
+    /**
+     * Debounce profile of each input as an array of length config->inputs.len, or NULL if there
+     * are no debounce profiles.
+     */
+    uint8_t *debounce_profiles;
 };
 
 struct kscan_direct_config {
-    struct zmk_debounce_config debounce_config;
+    /** Debounce of each profile, starting with the default one of the inputs. */
+    const struct zmk_debounce_config *debounce_configs;
+    /** Inputs of each profile after the default one. */
+    const struct kscan_gpio_debounce_profile *debounce_profiles;
+    size_t debounce_profiles_len;
     int32_t debounce_scan_period_ms;
     int32_t poll_period_ms;
     bool toggle_mode;
@@ -189,8 +198,13 @@ static int kscan_direct_read(const struct device *dev) {
             return active;
         }
 
+        const struct zmk_debounce_config *debounce_config =
+            data->debounce_profiles
+                ? &config->debounce_configs[data->debounce_profiles[gpio->index]]
+                : config->debounce_configs;
+
         zmk_debounce_update(&data->pin_state[gpio->index], active, config->debounce_scan_period_ms,
-                            &config->debounce_config);
+                            debounce_config);
     }
 
     // Process the new state.
@@ -327,10 +341,35 @@ static int kscan_direct_init_inputs(const struct device *dev) {
     return 0;
 }
 
+static void kscan_direct_init_debounce_profiles(const struct device *dev) {
+    struct kscan_direct_data *data = dev->data;
+    const struct kscan_direct_config *config = dev->config;
+
+    if (!data->debounce_profiles) {
+        return;
+    }
+
+    for (int p = 0; p < config->debounce_profiles_len; p++) {
+        const struct kscan_gpio_debounce_profile *profile = &config->debounce_profiles[p];
+
+        for (size_t k = 0; k < profile->keys_len; k++) {
+            const int input = profile->keys[k];
+
+            if (input >= data->inputs.len) {
+                LOG_WRN("Debounce profile %i has an input that doesn't exist: %i", p + 1, input);
+                continue;
+            }
+
+            data->debounce_profiles[input] = p + 1;
+        }
+    }
+}
+
 static int kscan_direct_init(const struct device *dev) {
     struct kscan_direct_data *data = dev->data;
 
     data->dev = dev;
+    kscan_direct_init_debounce_profiles(dev);
 
     // Sort inputs by port so we can read each port just once per scan.
     kscan_gpio_list_sort_by_port(&data->inputs);
@@ -381,6 +420,21 @@ static const struct kscan_driver_api kscan_direct_api = {
                  "ZMK_KSCAN_DEBOUNCE_PRESS_MS or debounce-press-ms is too large");                 \
     BUILD_ASSERT(INST_DEBOUNCE_RELEASE_MS(n) <= DEBOUNCE_COUNTER_MAX,                              \
                  "ZMK_KSCAN_DEBOUNCE_RELEASE_MS or debounce-release-ms is too large");             \
+    BUILD_ASSERT(DT_INST_CHILD_NUM(n) < UINT8_MAX, "Too many debounce profiles");                  \
+    DT_INST_FOREACH_CHILD_SEP(n, KSCAN_GPIO_DEBOUNCE_PROFILE_CHECK, (;));                          \
+                                                                                                   \
+    static const struct zmk_debounce_config kscan_direct_debounce_configs_##n[] = {                \
+        {                                                                                          \
+            .debounce_press_ms = INST_DEBOUNCE_PRESS_MS(n),                                        \
+            .debounce_release_ms = INST_DEBOUNCE_RELEASE_MS(n),                                    \
+        },                                                                                         \
+        DT_INST_FOREACH_CHILD_SEP(n, KSCAN_GPIO_DEBOUNCE_PROFILE_CONFIG, (, ))};                   \
+                                                                                                   \
+    COND_CODE_0(DT_INST_CHILD_NUM(n), (),                                                          \
+                (static const struct kscan_gpio_debounce_profile                                   \
+                     kscan_direct_debounce_profiles_##n[] = {                                      \
+                         DT_INST_FOREACH_CHILD_SEP(n, KSCAN_GPIO_DEBOUNCE_PROFILE, (, ))};         \
+                 static uint8_t kscan_direct_debounce_profile_##n[INST_INPUTS_LEN(n)];))           \
                                                                                                    \
     static struct kscan_gpio kscan_direct_inputs_##n[] = {                                         \
         COND_CODE_1(DT_INST_NODE_HAS_PROP(n, input_gpios),                                         \
@@ -395,14 +449,15 @@ static const struct kscan_driver_api kscan_direct_api = {
     static struct kscan_direct_data kscan_direct_data_##n = {                                      \
         .inputs = KSCAN_GPIO_LIST(kscan_direct_inputs_##n),                                        \
         .pin_state = kscan_direct_state_##n,                                                       \
-        COND_INTERRUPTS((.irqs = kscan_direct_irqs_##n, ))};                                       \
+        COND_INTERRUPTS((.irqs = kscan_direct_irqs_##n, ))                                         \
+        COND_CODE_0(DT_INST_CHILD_NUM(n), (),                                                      \
+                    (.debounce_profiles = kscan_direct_debounce_profile_##n, ))};                  \
                                                                                                    \
     static const struct kscan_direct_config kscan_direct_config_##n = {                            \
-        .debounce_config =                                                                         \
-            {                                                                                      \
-                .debounce_press_ms = INST_DEBOUNCE_PRESS_MS(n),                                    \
-                .debounce_release_ms = INST_DEBOUNCE_RELEASE_MS(n),                                \
-            },                                                                                     \
+        .debounce_configs = kscan_direct_debounce_configs_##n,                                     \
+        .debounce_profiles = COND_CODE_0(DT_INST_CHILD_NUM(n), (NULL),                             \
+                                         (kscan_direct_debounce_profiles_##n)),                    \
+        .debounce_profiles_len = DT_INST_CHILD_NUM(n),                                             \
         .debounce_scan_period_ms = DT_INST_PROP(n, debounce_scan_period_ms),                       \
         .poll_period_ms = DT_INST_PROP(n, poll_period_ms),                                         \
         .toggle_mode = DT_INST_PROP(n, toggle_mode),                                               \
@@ -17,6 +17,7 @@
 #include <zephyr/sys/util.h>
 
 #include <zmk/debounce.h>
+#include <zmk/debounce_bits.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -30,6 +31,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #define INST_COLS_LEN(n) DT_INST_PROP_LEN(n, col_gpios)
 #define INST_MATRIX_LEN(n) (INST_ROWS_LEN(n) * INST_COLS_LEN(n))
 #define INST_INPUTS_LEN(n) COND_DIODE_DIR(n, (INST_COLS_LEN(n)), (INST_ROWS_LEN(n)))
+#define INST_OUTPUTS_LEN(n) COND_DIODE_DIR(n, (INST_ROWS_LEN(n)), (INST_COLS_LEN(n)))
 
 #if CONFIG_ZMK_KSCAN_DEBOUNCE_PRESS_MS >= 0
 #define INST_DEBOUNCE_PRESS_MS(n) CONFIG_ZMK_KSCAN_DEBOUNCE_PRESS_MS
@@ -45,10 +47,13 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     DT_INST_PROP_OR(n, debounce_period, DT_INST_PROP(n, debounce_release_ms))
 #endif
 
+#define USE_PORT_SCAN IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_PORT_SCAN)
+
 #define USE_POLLING IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_POLLING)
 #define USE_INTERRUPTS (!USE_POLLING)
 
 #define COND_INTERRUPTS(code) COND_CODE_1(CONFIG_ZMK_KSCAN_MATRIX_POLLING, (), code)
+#define COND_PORT_SCAN(code, nocode) COND_CODE_1(CONFIG_ZMK_KSCAN_MATRIX_PORT_SCAN, code, nocode)
 #define COND_POLL_OR_INTERRUPTS(pollcode, intcode)                                                 \
     COND_CODE_1(CONFIG_ZMK_KSCAN_MATRIX_POLLING, pollcode, intcode)
 
@@ -78,16 +83,36 @@ struct kscan_matrix_data {
 #endif
     /** Timestamp of the current or scheduled scan. */
     int64_t scan_time;
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_GPIO_SCAN_STATS)
+    struct kscan_gpio_scan_stats scan_stats;
+#endif
+#if USE_PORT_SCAN
+    /**
+     * Current state of the matrix, with one word per output holding a bit per input, indexed by
+     * its position in the sorted input list.
+     */
+    struct zmk_debounce_bits *debounce;
+#else
     /**
      * Current state of the matrix as a flattened 2D array of length
      * (config->rows * config->cols)
      */
     struct zmk_debounce_state *matrix_state;
+#endif
+    /**
+     * Debounce profile of each key, by its index in the matrix state, or NULL if the matrix has no
+     * debounce profiles.
+     */
+    uint8_t *debounce_profiles;
 };
 
 struct kscan_matrix_config {
     struct kscan_gpio_list outputs;
-    struct zmk_debounce_config debounce_config;
+    /** Debounce of each profile, starting with the default one of the matrix. */
+    const struct zmk_debounce_config *debounce_configs;
+    /** Keys of each profile after the default one. */
+    const struct kscan_gpio_debounce_profile *debounce_profiles;
+    size_t debounce_profiles_len;
     size_t rows;
     size_t cols;
     int32_t debounce_scan_period_ms;
@@ -95,6 +120,7 @@ struct kscan_matrix_config {
     enum kscan_diode_direction diode_direction;
 };
 
+#if !USE_PORT_SCAN
 /**
  * Get the index into a matrix state array from a row and column.
  */
@@ -114,6 +140,18 @@ static int state_index_io(const struct kscan_matrix_config *config, const int in
                ? state_index_rc(config, output_idx, input_idx)
                : state_index_rc(config, input_idx, output_idx);
 }
+#endif // !USE_PORT_SCAN
+
+#if !USE_PORT_SCAN
+static const struct zmk_debounce_config *kscan_matrix_debounce_config(const struct device *dev,
+                                                                       const int index) {
+    const struct kscan_matrix_data *data = dev->data;
+    const struct kscan_matrix_config *config = dev->config;
+
+    return data->debounce_profiles ? &config->debounce_configs[data->debounce_profiles[index]]
+                                   : config->debounce_configs;
+}
+#endif // !USE_PORT_SCAN
 
 static int kscan_matrix_set_all_outputs(const struct device *dev, const int value) {
     const struct kscan_matrix_config *config = dev->config;
@@ -187,7 +225,7 @@ static void kscan_matrix_irq_callback_handler(const struct device *port, struct
 
     data->scan_time = k_uptime_get();
 
-    k_work_reschedule(&data->work, K_NO_WAIT);
+    kscan_gpio_reschedule(&data->work, K_NO_WAIT);
 }
 #endif
 
@@ -197,7 +235,7 @@ static void kscan_matrix_read_continue(const struct device *dev) {
 
     data->scan_time += config->debounce_scan_period_ms;
 
-    k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
+    kscan_gpio_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
 }
 
 static void kscan_matrix_read_end(const struct device *dev) {
@@ -211,10 +249,72 @@ static void kscan_matrix_read_end(const struct device *dev) {
     data->scan_time += config->poll_period_ms;
 
     // Return to polling slowly.
-    k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
+    kscan_gpio_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
 #endif
 }
 
+#if USE_PORT_SCAN
+/**
+ * Read every input with one read per GPIO port, as bits indexed by its position in the sorted
+ * input list.
+ */
+static int kscan_matrix_read_inputs(const struct device *dev, uint32_t *inputs) {
+    const struct kscan_matrix_data *data = dev->data;
+    const struct device *port = NULL;
+    gpio_port_value_t value = 0;
+
+    *inputs = 0;
+
+    for (int j = 0; j < data->inputs.len; j++) {
+        const struct gpio_dt_spec *gpio = &data->inputs.gpios[j].spec;
+
+        if (gpio->port != port) {
+            port = gpio->port;
+
+            int err = gpio_port_get(port, &value);
+            if (err) {
+                LOG_ERR("Failed to read port %s: %i", port->name, err);
+                return err;
+            }
+        }
+
+        *inputs |= ((value >> gpio->pin) & 1) << j;
+    }
+
+    return 0;
+}
+
+/**
+ * Report the cells which changed on the last scan.
+ *
+ * @returns whether any key is pressed or still being debounced.
+ */
+static bool kscan_matrix_report_changes(const struct device *dev) {
+    struct kscan_matrix_data *data = dev->data;
+    const struct kscan_matrix_config *config = dev->config;
+
+    for (int i = 0; i < config->outputs.len; i++) {
+        const struct kscan_gpio *out_gpio = &config->outputs.gpios[i];
+        const uint32_t pressed = zmk_debounce_bits_get_pressed(data->debounce, i);
+
+        for (uint32_t changed = zmk_debounce_bits_get_changed(data->debounce, i); changed;
+             changed &= changed - 1) {
+            const int j = __builtin_ctz(changed);
+            const struct kscan_gpio *in_gpio = &data->inputs.gpios[j];
+            const int r = (config->diode_direction == KSCAN_ROW2COL) ? out_gpio->index
+                                                                     : in_gpio->index;
+            const int c = (config->diode_direction == KSCAN_ROW2COL) ? in_gpio->index
+                                                                     : out_gpio->index;
+
+            LOG_DBG("Sending event at %i,%i state %s", r, c, (pressed & BIT(j)) ? "on" : "off");
+            data->callback(dev, r, c, pressed & BIT(j));
+        }
+    }
+
+    return zmk_debounce_bits_is_active(data->debounce);
+}
+#endif // USE_PORT_SCAN
+
 static int kscan_matrix_read(const struct device *dev) {
     struct kscan_matrix_data *data = dev->data;
     const struct kscan_matrix_config *config = dev->config;
@@ -232,6 +332,17 @@ static int kscan_matrix_read(const struct device *dev) {
 #if CONFIG_ZMK_KSCAN_MATRIX_WAIT_BEFORE_INPUTS > 0
         k_busy_wait(CONFIG_ZMK_KSCAN_MATRIX_WAIT_BEFORE_INPUTS);
 #endif
+#if USE_PORT_SCAN
+        uint32_t inputs;
+
+        err = kscan_matrix_read_inputs(dev, &inputs);
+        if (err) {
+            return err;
+        }
+
+        zmk_debounce_bits_update(data->debounce, i, inputs, config->debounce_scan_period_ms,
+                                 config->debounce_configs);
+#else
         struct kscan_gpio_port_state state = {0};
 
         for (int j = 0; j < data->inputs.len; j++) {
@@ -245,8 +356,9 @@ static int kscan_matrix_read(const struct device *dev) {
             }
 
             zmk_debounce_update(&data->matrix_state[index], active, config->debounce_scan_period_ms,
-                                &config->debounce_config);
+                                kscan_matrix_debounce_config(dev, index));
         }
+#endif // USE_PORT_SCAN
 
         err = gpio_pin_set_dt(&out_gpio->spec, 0);
         if (err) {
@@ -260,6 +372,9 @@ static int kscan_matrix_read(const struct device *dev) {
     }
 
     // Process the new state.
+#if USE_PORT_SCAN
+    const bool continue_scan = kscan_matrix_report_changes(dev);
+#else
     bool continue_scan = false;
 
     for (int r = 0; r < config->rows; r++) {
@@ -277,6 +392,7 @@ static int kscan_matrix_read(const struct device *dev) {
             continue_scan = continue_scan || zmk_debounce_is_active(state);
         }
     }
+#endif // USE_PORT_SCAN
 
     if (continue_scan) {
         // At least one key is pressed or the debouncer has not yet decided if
@@ -293,6 +409,9 @@ static int kscan_matrix_read(const struct device *dev) {
 static void kscan_matrix_work_handler(struct k_work *work) {
     struct k_work_delayable *dwork = k_work_delayable_from_work(work);
     struct kscan_matrix_data *data = CONTAINER_OF(dwork, struct kscan_matrix_data, work);
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_GPIO_SCAN_STATS)
+    kscan_gpio_scan_stats_record(data->dev, &data->scan_stats, data->scan_time);
+#endif
     kscan_matrix_read(data->dev);
 }
 
@@ -443,6 +562,61 @@ static void kscan_matrix_setup_pins(const struct device *dev) {
     kscan_matrix_set_all_outputs(dev, 0);
 }
 
+/**
+ * Get the index of a key in the debounce profiles array, once the inputs are sorted.
+ */
+static int kscan_matrix_debounce_index(const struct device *dev, const int row, const int col) {
+    const struct kscan_matrix_config *config = dev->config;
+#if USE_PORT_SCAN
+    const struct kscan_matrix_data *data = dev->data;
+    const bool row2col = config->diode_direction == KSCAN_ROW2COL;
+    const int output_idx = row2col ? row : col;
+    const int input_idx = row2col ? col : row;
+
+    for (int j = 0; j < data->inputs.len; j++) {
+        if (data->inputs.gpios[j].index == input_idx) {
+            return output_idx * 32 + j;
+        }
+    }
+
+    return -EINVAL;
+#else
+    return state_index_rc(config, row, col);
+#endif
+}
+
+static void kscan_matrix_init_debounce_profiles(const struct device *dev) {
+    struct kscan_matrix_data *data = dev->data;
+    const struct kscan_matrix_config *config = dev->config;
+
+    if (!data->debounce_profiles) {
+        return;
+    }
+
+    for (int p = 0; p < config->debounce_profiles_len; p++) {
+        const struct kscan_gpio_debounce_profile *profile = &config->debounce_profiles[p];
+
+        for (size_t k = 0; k + 1 < profile->keys_len; k += 2) {
+            const int row = profile->keys[k];
+            const int col = profile->keys[k + 1];
+            const int index = (row < config->rows && col < config->cols)
+                                  ? kscan_matrix_debounce_index(dev, row, col)
+                                  : -EINVAL;
+
+            if (index < 0) {
+                LOG_WRN("Debounce profile %i has a key outside the matrix: %i,%i", p + 1, row, col);
+                continue;
+            }
+
+            data->debounce_profiles[index] = p + 1;
+        }
+    }
+
+#if USE_PORT_SCAN
+    data->debounce->profiles = data->debounce_profiles;
+#endif
+}
+
 static int kscan_matrix_init(const struct device *dev) {
     struct kscan_matrix_data *data = dev->data;
 
@@ -450,6 +624,7 @@ static int kscan_matrix_init(const struct device *dev) {
 
     // Sort inputs by port so we can read each port just once per scan.
     kscan_gpio_list_sort_by_port(&data->inputs);
+    kscan_matrix_init_debounce_profiles(dev);
 
     k_work_init_delayable(&data->work, kscan_matrix_work_handler);
 
@@ -497,6 +672,22 @@ static const struct kscan_driver_api kscan_matrix_api = {
                  "ZMK_KSCAN_DEBOUNCE_PRESS_MS or debounce-press-ms is too large");                 \
     BUILD_ASSERT(INST_DEBOUNCE_RELEASE_MS(n) <= DEBOUNCE_COUNTER_MAX,                              \
                  "ZMK_KSCAN_DEBOUNCE_RELEASE_MS or debounce-release-ms is too large");             \
+    BUILD_ASSERT(DT_INST_CHILD_NUM(n) < UINT8_MAX, "Too many debounce profiles");                  \
+    DT_INST_FOREACH_CHILD_SEP(n, KSCAN_GPIO_DEBOUNCE_PROFILE_CHECK, (;));                          \
+                                                                                                   \
+    static const struct zmk_debounce_config kscan_matrix_debounce_configs_##n[] = {                \
+        {                                                                                          \
+            .debounce_press_ms = INST_DEBOUNCE_PRESS_MS(n),                                        \
+            .debounce_release_ms = INST_DEBOUNCE_RELEASE_MS(n),                                    \
+        },                                                                                         \
+        DT_INST_FOREACH_CHILD_SEP(n, KSCAN_GPIO_DEBOUNCE_PROFILE_CONFIG, (, ))};                   \
+                                                                                                   \
+    COND_CODE_0(DT_INST_CHILD_NUM(n), (),                                                          \
+                (static const struct kscan_gpio_debounce_profile                                   \
+                     kscan_matrix_debounce_profiles_##n[] = {                                      \
+                         DT_INST_FOREACH_CHILD_SEP(n, KSCAN_GPIO_DEBOUNCE_PROFILE, (, ))};         \
+                 static uint8_t kscan_matrix_debounce_profile_##n[COND_PORT_SCAN(                  \
+                     (INST_OUTPUTS_LEN(n) * 32), (INST_MATRIX_LEN(n)))];))                         \
                                                                                                    \
     static struct kscan_gpio kscan_matrix_rows_##n[] = {                                           \
         LISTIFY(INST_ROWS_LEN(n), KSCAN_GPIO_ROW_CFG_INIT, (, ), n)};                              \
@@ -504,7 +695,12 @@ static const struct kscan_driver_api kscan_matrix_api = {
     static struct kscan_gpio kscan_matrix_cols_##n[] = {                                           \
         LISTIFY(INST_COLS_LEN(n), KSCAN_GPIO_COL_CFG_INIT, (, ), n)};                              \
                                                                                                    \
-    static struct zmk_debounce_state kscan_matrix_state_##n[INST_MATRIX_LEN(n)];                   \
+    COND_PORT_SCAN(                                                                                \
+        (BUILD_ASSERT(INST_INPUTS_LEN(n) <= 32,                                                    \
+                      "CONFIG_ZMK_KSCAN_MATRIX_PORT_SCAN supports at most 32 inputs");             \
+         ZMK_DEBOUNCE_BITS_DEFINE(kscan_matrix_debounce_##n, INST_OUTPUTS_LEN(n),                  \
+                                  CONFIG_ZMK_KSCAN_MATRIX_DEBOUNCE_COUNTERS);),                    \
+        (static struct zmk_debounce_state kscan_matrix_state_##n[INST_MATRIX_LEN(n)];))            \
                                                                                                    \
     COND_INTERRUPTS(                                                                               \
         (static struct kscan_matrix_irq_callback kscan_matrix_irqs_##n[INST_INPUTS_LEN(n)];))      \
@@ -512,19 +708,21 @@ static const struct kscan_driver_api kscan_matrix_api = {
     static struct kscan_matrix_data kscan_matrix_data_##n = {                                      \
         .inputs =                                                                                  \
             KSCAN_GPIO_LIST(COND_DIODE_DIR(n, (kscan_matrix_cols_##n), (kscan_matrix_rows_##n))),  \
-        .matrix_state = kscan_matrix_state_##n,                                                    \
-        COND_INTERRUPTS((.irqs = kscan_matrix_irqs_##n, ))};                                       \
+        COND_PORT_SCAN((.debounce = &kscan_matrix_debounce_##n, ),                                 \
+                       (.matrix_state = kscan_matrix_state_##n, ))                                 \
+        COND_INTERRUPTS((.irqs = kscan_matrix_irqs_##n, ))                                         \
+        COND_CODE_0(DT_INST_CHILD_NUM(n), (),                                                      \
+                    (.debounce_profiles = kscan_matrix_debounce_profile_##n, ))};                  \
                                                                                                    \
     static const struct kscan_matrix_config kscan_matrix_config_##n = {                            \
         .rows = ARRAY_SIZE(kscan_matrix_rows_##n),                                                 \
         .cols = ARRAY_SIZE(kscan_matrix_cols_##n),                                                 \
         .outputs =                                                                                 \
             KSCAN_GPIO_LIST(COND_DIODE_DIR(n, (kscan_matrix_rows_##n), (kscan_matrix_cols_##n))),  \
-        .debounce_config =                                                                         \
-            {                                                                                      \
-                .debounce_press_ms = INST_DEBOUNCE_PRESS_MS(n),                                    \
-                .debounce_release_ms = INST_DEBOUNCE_RELEASE_MS(n),                                \
-            },                                                                                     \
+        .debounce_configs = kscan_matrix_debounce_configs_##n,                                     \
+        .debounce_profiles = COND_CODE_0(DT_INST_CHILD_NUM(n), (NULL),                             \
+                                         (kscan_matrix_debounce_profiles_##n)),                    \
+        .debounce_profiles_len = DT_INST_CHILD_NUM(n),                                             \
         .debounce_scan_period_ms = DT_INST_PROP(n, debounce_scan_period_ms),                       \
         .poll_period_ms = DT_INST_PROP(n, poll_period_ms),                                         \
         .diode_direction = INST_DIODE_DIR(n),                                                      \
@@ -7,18 +7,66 @@
 /*
  * kscan IPC driver (ARCH_POSIX / native_sim only)
  *
- * Opens a Unix domain socket server and feeds key events received from a
- * connected client into the ZMK kscan subsystem.
+ * Opens a Unix domain socket server and feeds key events received from
+ * connected clients into the ZMK kscan subsystem.  Up to
+ * CONFIG_ZMK_KSCAN_IPC_MAX_CLIENTS clients may be connected at once.  The
+ * listening socket and every client are served by the shared IPC event
+ * loop (see zmk_ipc_loop.h), so instances and clients add no threads.
+ *
+ * Each instance has its own socket.  With CONFIG_ZMK_CONTEXT_COUNT above 1,
+ * an instance with a non-zero `context` is a keyboard of its own: its key
+ * events are queued for that context (see zmk/context.h), which has its own
+ * layers, behavior state and HID reports, and the IPC observer tags what
+ * they cause with the context.  All keyboards share the keymap bindings
+ * and the matrix transform of the active physical layout.  Instances of
+ * context 0 only receive key events while they are the kscan of the active
+ * physical layout.  Latency traces (KeyEvent.seq) are only kept for
+ * context 0.
+ *
+ * With CONFIG_ZMK_KSCAN_IPC_SHM the event loop also polls a shared-memory
+ * ring (see zmk_ipc_shm.h) carrying the same frames, for one local producer
+ * that wants to avoid per-event syscalls.
+ *
+ * With CONFIG_ZMK_KSCAN_IPC_VIRTUAL_TIME the event loop blocks the whole
+ * simulation while no client data is pending, so simulated time advances
+ * only through AdvanceTime messages (see zmk_ipc.proto).
+ *
+ * With the `exit-after` property the process exits once the last client of
+ * the instance disconnects, like zmk,kscan-mock does after its last event,
+ * so a test runner can replay a test case and then collect its results.
  *
  * Wire format (client → ZMK):
  *   [4-byte big-endian length][nanopb-encoded zmk_ipc_ClientMessage]
  *
- * The ClientMessage wraps a KeyEvent which supports two address formats:
+ * The same messages are accepted on the IPC observer socket (the
+ * bidirectional Connect stream) and forwarded here via zmk_kscan_ipc_inject().
+ *
+ * The ClientMessage wraps either a single KeyEvent or a KeyEventBatch
+ * (repeated KeyEvent, dispatched in order).  A KeyEvent supports two
+ * address formats:
  *
  *   key_pos { row: 0  col: 0 }   ← explicit row / column
  *   position: 5                  ← linear index (row = pos / columns,
  *                                                 col = pos % columns)
  *
+ * With CONFIG_ZMK_KSCAN_IPC_LOGICAL_POSITIONS, `position` is instead a key
+ * position of the active physical layout.  It skips the matrix transform
+ * and is raised as a position event with the time it was received.
+ *
+ * A SensorEvent or SensorEventBatch is raised as readings of the keymap
+ * sensors (CONFIG_ZMK_KEYMAP_SENSORS_INJECT), whether or not the sensors
+ * have a device in this build.
+ *
+ * With CONFIG_ZMK_KSCAN_IPC_POINTER a PointerEvent or PointerEventBatch is
+ * raised as input events (relative motion and INPUT_BTN_0 – 4) from this
+ * device, so a zmk,input-listener with `device = <&kscan_ipc>` feeds it
+ * through its input processors.
+ *
+ * A Hello is answered on the same connection with one ZmkEvent frame
+ * carrying Capabilities: the protocol version, the payloads this build
+ * dispatches and the `rows` / `columns` of the instance.  It is the only
+ * frame the driver ever writes to a client.
+ *
  * Example client (Python):
  *   import socket, struct
  *   from zmk_ipc_pb2 import ClientMessage, KeyEvent, KeyPosition
@@ -36,20 +84,32 @@
 
 #define DT_DRV_COMPAT zmk_kscan_ipc
 
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 
 #include <sys/socket.h>
-#include <sys/un.h>
 #include <unistd.h>
 
 #include <zephyr/device.h>
 #include <zephyr/drivers/kscan.h>
+#include <zephyr/input/input.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 
+#include <zmk/ipc_observer.h>
+#include <zmk/kscan_ipc.h>
+#include <zmk/physical_layouts.h>
+#include <zmk/sensors.h>
+
 #include "zmk_ipc.pb.h"
 #include "zmk_ipc_framing.h"
+#include "zmk_ipc_listener.h"
+#include "zmk_ipc_loop.h"
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_SHM)
+#include "zmk_ipc_shm.h"
+#endif
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -59,42 +119,114 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 struct kscan_ipc_config {
     const char *socket_path;
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_SHM)
+    const char *shm_path;
+#endif
     uint32_t    rows;
     uint32_t    columns;
+    uint8_t     context;
+    bool        exit_after;
 };
 
 /* -------------------------------------------------------------------------
  * Per-instance runtime data
  * ------------------------------------------------------------------------- */
 
+#define KSCAN_IPC_MAX_CLIENTS CONFIG_ZMK_KSCAN_IPC_MAX_CLIENTS
+
+struct kscan_ipc_client {
+    int fd; /* accepted connection (-1 = free slot) */
+    const struct device *dev;
+    struct zmk_ipc_loop_source source;
+    struct zmk_ipc_frame_reader reader;
+};
+
 struct kscan_ipc_data {
     kscan_callback_t  callback;
     const struct device *dev;
 
     int server_fd; /* listening socket (-1 = not open) */
-    int client_fd; /* current accepted connection (-1 = none) */
+    struct zmk_ipc_loop_source server_source;
+
+    struct kscan_ipc_client clients[KSCAN_IPC_MAX_CLIENTS];
 
-    struct k_thread   read_thread;
-    k_thread_stack_t *read_stack; /* set in per-instance init wrapper */
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_SHM)
+    struct zmk_ipc_shm_ring ring; /* polled every loop iteration */
+    struct zmk_ipc_loop_source shm_source;
+#endif
+
+    /* Decode target; too large for the event loop's stack. */
+    zmk_ipc_ClientMessage rx_msg;
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_POINTER)
+    uint8_t pointer_buttons; /* buttons held, as of the last PointerEvent */
+#endif
 
     bool enabled;
+    bool unbound_warned; /* dropped key events without a callback */
 };
 
 /* -------------------------------------------------------------------------
  * Decode and dispatch a received ClientMessage
  * ------------------------------------------------------------------------- */
 
-static void dispatch_message(const struct device *dev,
-                             const zmk_ipc_ClientMessage *msg) {
-    struct kscan_ipc_data *data     = dev->data;
+/*
+ * Only the kscan of the active physical layout is configured with a
+ * callback.  Other instances of context 0 have nowhere to send key events,
+ * since they share the keymap and HID state of that context.  Instances of
+ * other contexts queue their key events themselves and are always enabled.
+ */
+static bool kscan_ipc_can_dispatch(const struct device *dev) {
     const struct kscan_ipc_config *cfg = dev->config;
+    struct kscan_ipc_data *data = dev->data;
 
-    if (msg->which_payload != zmk_ipc_ClientMessage_key_event_tag) {
-        LOG_WRN("kscan IPC: unknown ClientMessage payload %d", msg->which_payload);
+    if (cfg->context != 0) {
+        return true;
+    }
+
+    if (!data->callback) {
+        if (!data->unbound_warned) {
+            LOG_WRN("kscan IPC: %s is not the kscan of the active physical layout, "
+                    "dropping its key events", dev->name);
+            data->unbound_warned = true;
+        }
+        return false;
+    }
+
+    return data->enabled;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_LOGICAL_POSITIONS)
+static void dispatch_position_event(const struct device *dev, const zmk_ipc_KeyEvent *ev,
+                                    bool pressed) {
+    const struct kscan_ipc_config *cfg = dev->config;
+    uint32_t position = ev->address.position;
+
+    LOG_DBG("kscan IPC event: position=%u pressed=%d", position, (int)pressed);
+
+    if (!kscan_ipc_can_dispatch(dev)) {
+        return;
+    }
+
+    if (cfg->context != 0) {
+        LOG_WRN("kscan IPC: %s dropping logical position %u, only context 0 takes them",
+                dev->name, position);
         return;
     }
 
-    const zmk_ipc_KeyEvent *ev = &msg->payload.key_event;
+    zmk_physical_layouts_kscan_wait_for_space(K_FOREVER);
+    zmk_ipc_observer_trace_position(position, ev->seq, ev->client_ts);
+
+    int err = zmk_physical_layouts_kscan_position_changed(position, pressed, k_uptime_get());
+    if (err == -EINVAL) {
+        LOG_WRN("kscan IPC: position %u is out of range", position);
+    }
+}
+#endif
+
+static void dispatch_key_event(const struct device *dev, const zmk_ipc_KeyEvent *ev) {
+    struct kscan_ipc_data *data     = dev->data;
+    const struct kscan_ipc_config *cfg = dev->config;
     bool pressed;
 
     switch (ev->action) {
@@ -118,6 +250,10 @@ static void dispatch_message(const struct device *dev,
         break;
 
     case zmk_ipc_KeyEvent_position_tag:
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_LOGICAL_POSITIONS)
+        dispatch_position_event(dev, ev, pressed);
+        return;
+#endif
         if (cfg->columns == 0) {
             LOG_ERR("kscan IPC: position event received but columns == 0");
             return;
@@ -133,64 +269,332 @@ static void dispatch_message(const struct device *dev,
 
     LOG_DBG("kscan IPC event: row=%u col=%u pressed=%d", row, col, (int)pressed);
 
-    if (data->enabled && data->callback) {
-        data->callback(dev, row, col, pressed);
+    if (kscan_ipc_can_dispatch(dev)) {
+        /* Stop reading the client while the event queue is full, so bursts
+         * back up into the socket instead of being dropped. */
+        zmk_physical_layouts_kscan_wait_for_space(K_FOREVER);
+        if (cfg->context == 0) {
+            zmk_ipc_observer_trace_kscan(row, col, ev->seq, ev->client_ts);
+            data->callback(dev, row, col, pressed);
+        } else {
+            zmk_physical_layouts_kscan_context_changed(cfg->context, row, col, pressed);
+        }
+    }
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SENSORS_INJECT)
+static void dispatch_sensor_event(const zmk_ipc_SensorEvent *ev) {
+    if (ev->sensor_index > UINT8_MAX) {
+        LOG_WRN("kscan IPC: sensor %u is out of range", ev->sensor_index);
+        return;
+    }
+
+    struct sensor_value value = {.val1 = ev->val1, .val2 = ev->val2};
+    int err = zmk_sensors_inject(ev->sensor_index, &value);
+    if (err == -EINVAL) {
+        LOG_WRN("kscan IPC: sensor %u is out of range", ev->sensor_index);
+    }
+}
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_POINTER)
+#define KSCAN_IPC_POINTER_BUTTONS 5
+
+struct kscan_ipc_pointer_report {
+    uint8_t type;
+    uint16_t code;
+    int32_t value;
+};
+
+static void dispatch_pointer_event(const struct device *dev, const zmk_ipc_PointerEvent *ev) {
+    struct kscan_ipc_data *data = dev->data;
+    struct kscan_ipc_pointer_report reports[KSCAN_IPC_POINTER_BUTTONS + 4];
+    size_t len = 0;
+
+    uint8_t buttons = ev->buttons & BIT_MASK(KSCAN_IPC_POINTER_BUTTONS);
+    for (uint8_t changed = buttons ^ data->pointer_buttons; changed; changed &= changed - 1) {
+        uint8_t btn = __builtin_ctz(changed);
+        reports[len++] = (struct kscan_ipc_pointer_report){
+            INPUT_EV_KEY, INPUT_BTN_0 + btn, (buttons >> btn) & 1};
+    }
+    data->pointer_buttons = buttons;
+
+    if (ev->dx) {
+        reports[len++] = (struct kscan_ipc_pointer_report){INPUT_EV_REL, INPUT_REL_X, ev->dx};
+    }
+    if (ev->dy) {
+        reports[len++] = (struct kscan_ipc_pointer_report){INPUT_EV_REL, INPUT_REL_Y, ev->dy};
+    }
+    if (ev->wheel) {
+        reports[len++] =
+            (struct kscan_ipc_pointer_report){INPUT_EV_REL, INPUT_REL_WHEEL, ev->wheel};
+    }
+    if (ev->hwheel) {
+        reports[len++] =
+            (struct kscan_ipc_pointer_report){INPUT_EV_REL, INPUT_REL_HWHEEL, ev->hwheel};
+    }
+
+    if (len == 0) {
+        if (!ev->sync) {
+            return;
+        }
+        /* Nothing changed, but the sync still has to reach the listener */
+        reports[len++] = (struct kscan_ipc_pointer_report){INPUT_EV_REL, INPUT_REL_X, 0};
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        bool sync = ev->sync && i == len - 1;
+
+        /* Waiting for room in the input queue backs bursts up into the socket */
+        int err = input_report(dev, reports[i].type, reports[i].code, reports[i].value, sync,
+                               K_FOREVER);
+        if (err) {
+            LOG_WRN("kscan IPC: failed to raise pointer input (%d)", err);
+            return;
+        }
+    }
+}
+#endif
+
+static void dispatch_message(const struct device *dev,
+                             const zmk_ipc_ClientMessage *msg) {
+    switch (msg->which_payload) {
+    case zmk_ipc_ClientMessage_key_event_tag:
+        dispatch_key_event(dev, &msg->payload.key_event);
+        break;
+
+    case zmk_ipc_ClientMessage_key_batch_tag: {
+        const zmk_ipc_KeyEventBatch *batch = &msg->payload.key_batch;
+
+        LOG_DBG("kscan IPC: batch of %u events", (unsigned)batch->events_count);
+        for (pb_size_t i = 0; i < batch->events_count; i++) {
+            dispatch_key_event(dev, &batch->events[i]);
+        }
+        break;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SENSORS_INJECT)
+    case zmk_ipc_ClientMessage_sensor_event_tag:
+        dispatch_sensor_event(&msg->payload.sensor_event);
+        break;
+
+    case zmk_ipc_ClientMessage_sensor_batch_tag: {
+        const zmk_ipc_SensorEventBatch *batch = &msg->payload.sensor_batch;
+
+        LOG_DBG("kscan IPC: batch of %u sensor readings", (unsigned)batch->events_count);
+        for (pb_size_t i = 0; i < batch->events_count; i++) {
+            dispatch_sensor_event(&batch->events[i]);
+        }
+        break;
+    }
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_POINTER)
+    case zmk_ipc_ClientMessage_pointer_event_tag:
+        dispatch_pointer_event(dev, &msg->payload.pointer_event);
+        break;
+
+    case zmk_ipc_ClientMessage_pointer_batch_tag: {
+        const zmk_ipc_PointerEventBatch *batch = &msg->payload.pointer_batch;
+
+        LOG_DBG("kscan IPC: batch of %u pointer events", (unsigned)batch->events_count);
+        for (pb_size_t i = 0; i < batch->events_count; i++) {
+            dispatch_pointer_event(dev, &batch->events[i]);
+        }
+        break;
+    }
+#endif
+
+    case zmk_ipc_ClientMessage_advance_time_tag:
+        LOG_DBG("kscan IPC: advancing time by %u ms", msg->payload.advance_time.ms);
+        k_sleep(K_MSEC(msg->payload.advance_time.ms));
+        break;
+
+    case zmk_ipc_ClientMessage_hello_tag:
+        /* Answered by the socket reader; the shm ring has no way back. */
+        LOG_DBG("kscan IPC: ignoring Hello without a reply channel");
+        break;
+
+    default:
+        LOG_WRN("kscan IPC: unknown ClientMessage payload %d", msg->which_payload);
+        break;
     }
 }
 
+void zmk_kscan_ipc_inject(const struct device *dev, const zmk_ipc_ClientMessage *msg) {
+    dispatch_message(dev, msg);
+}
+
+void zmk_kscan_ipc_fill_capabilities(const struct device *dev, zmk_ipc_Capabilities *caps) {
+    const struct kscan_ipc_config *cfg = dev->config;
+
+    caps->max_message_frame = ZMK_IPC_MSG_FRAME_MAX;
+    caps->rows              = cfg->rows;
+    caps->columns           = cfg->columns;
+    caps->message_mask |= BIT(zmk_ipc_ClientMessage_key_event_tag) |
+                          BIT(zmk_ipc_ClientMessage_key_batch_tag) |
+                          BIT(zmk_ipc_ClientMessage_advance_time_tag) |
+                          BIT(zmk_ipc_ClientMessage_hello_tag);
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SENSORS_INJECT)
+    caps->message_mask |= BIT(zmk_ipc_ClientMessage_sensor_event_tag) |
+                          BIT(zmk_ipc_ClientMessage_sensor_batch_tag);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_POINTER)
+    caps->message_mask |= BIT(zmk_ipc_ClientMessage_pointer_event_tag) |
+                          BIT(zmk_ipc_ClientMessage_pointer_batch_tag);
+#endif
+}
+
 /* -------------------------------------------------------------------------
- * Read thread
+ * Event loop handlers
  *
- * Accepts one client at a time and processes incoming protobuf frames
- * (length-prefix + ClientMessage).
+ * Accept new clients and drain every complete protobuf frame (length-prefix
+ * + ClientMessage) from readable clients, on the shared IPC event loop.
+ * All sockets are non-blocking.
+ *
+ * In virtual-time mode the loop blocks in epoll_wait().  A blocking host
+ * call stops the whole native_sim kernel, which is exactly what freezes the
+ * simulated clock between AdvanceTime messages.
  * ------------------------------------------------------------------------- */
 
-static void kscan_ipc_read_thread_func(void *a, void *b, void *c) {
-    const struct device *dev        = (const struct device *)a;
-    struct kscan_ipc_data *data     = dev->data;
-    const struct kscan_ipc_config *cfg = dev->config;
+static void kscan_ipc_close_client(struct kscan_ipc_client *client) {
+    const struct kscan_ipc_config *cfg = client->dev->config;
+    struct kscan_ipc_data *data = client->dev->data;
+
+    close(client->fd); /* also removes it from the event loop */
+    client->fd = -1;
+
+    if (!cfg->exit_after) {
+        return;
+    }
+
+    for (int i = 0; i < KSCAN_IPC_MAX_CLIENTS; i++) {
+        if (data->clients[i].fd >= 0) {
+            return;
+        }
+    }
+
+    LOG_DBG("kscan IPC: last client gone, exiting");
+    exit(0);
+}
+
+static void kscan_ipc_service_client(struct zmk_ipc_loop_source *source);
+
+/*
+ * Answer a Hello.  The connection is otherwise never written to, so its send
+ * buffer is empty and the small frame goes out in one non-blocking send().
+ */
+static void kscan_ipc_reply_hello(const struct device *dev, struct kscan_ipc_client *client,
+                                  const zmk_ipc_Hello *hello) {
+    /* Static, like rx_msg: only the event loop thread gets here. */
+    static zmk_ipc_ZmkEvent ev;
+    static uint8_t frame[ZMK_IPC_EVENT_FRAME_MAX];
+    size_t frame_len;
+
+    LOG_DBG("kscan IPC: Hello from fd=%d, protocol version %u", client->fd,
+            hello->protocol_version);
+
+    ev = (zmk_ipc_ZmkEvent)zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload = zmk_ipc_ZmkEvent_capabilities_tag;
+    ev.payload.capabilities.protocol_version = ZMK_IPC_PROTOCOL_VERSION;
+    ev.payload.capabilities.max_event_frame  = ZMK_IPC_EVENT_FRAME_MAX;
+    zmk_kscan_ipc_fill_capabilities(dev, &ev.payload.capabilities);
+
+    if (zmk_ipc_encode_event_frame(&ev, frame, sizeof(frame), &frame_len) != 0) {
+        return; /* already logged inside helper */
+    }
+
+    ssize_t sent = send(client->fd, frame, frame_len, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (sent != (ssize_t)frame_len) {
+        LOG_WRN("kscan IPC: can't send Capabilities to fd=%d (errno=%d)", client->fd,
+                sent < 0 ? errno : 0);
+    }
+}
+
+static void kscan_ipc_accept_clients(struct zmk_ipc_loop_source *source) {
+    struct kscan_ipc_data *data = CONTAINER_OF(source, struct kscan_ipc_data, server_source);
 
     for (;;) {
-        /* Accept a new connection if we don't have one */
-        if (data->client_fd < 0) {
-            LOG_DBG("kscan IPC: waiting for client on %s", cfg->socket_path);
-            int client = accept(data->server_fd, NULL, NULL);
-            if (client < 0) {
-                if (errno == EINTR) {
-                    continue;
-                }
-                LOG_ERR("kscan IPC: accept() failed (errno=%d)", errno);
-                k_sleep(K_MSEC(100));
-                continue;
+        int fd = zmk_ipc_listener_accept(data->server_fd);
+        if (fd < 0) {
+            if (fd != -EAGAIN) {
+                LOG_ERR("kscan IPC: accept() failed (err %d)", fd);
             }
-            data->client_fd = client;
-            LOG_INF("kscan IPC: client connected (fd=%d)", client);
+            return;
         }
 
-        /* Blocking receive of one length-prefixed protobuf frame */
-        zmk_ipc_ClientMessage msg = zmk_ipc_ClientMessage_init_zero;
-        int ret = zmk_ipc_frame_recv(data->client_fd, &msg);
+        uint32_t slot = KSCAN_IPC_MAX_CLIENTS;
+        for (uint32_t i = 0; i < KSCAN_IPC_MAX_CLIENTS; i++) {
+            if (data->clients[i].fd < 0) {
+                slot = i;
+                break;
+            }
+        }
 
-        if (ret == 0) {
-            dispatch_message(dev, &msg);
+        if (slot == KSCAN_IPC_MAX_CLIENTS) {
+            LOG_WRN("kscan IPC: max clients (%d) reached, rejecting", KSCAN_IPC_MAX_CLIENTS);
+            close(fd);
+            continue;
+        }
+
+        if (zmk_ipc_loop_add(&data->clients[slot].source, fd, kscan_ipc_service_client) < 0) {
+            close(fd);
+            continue;
+        }
+
+        data->clients[slot].fd = fd;
+        zmk_ipc_frame_reader_init(&data->clients[slot].reader, fd);
+        LOG_INF("kscan IPC: client connected (fd=%d, slot %u)", fd, slot);
+    }
+}
+
+static void kscan_ipc_service_client(struct zmk_ipc_loop_source *source) {
+    struct kscan_ipc_client *client = CONTAINER_OF(source, struct kscan_ipc_client, source);
+    const struct device *dev = client->dev;
+    struct kscan_ipc_data *data = dev->data;
+
+    while (client->fd >= 0) {
+        int ret = zmk_ipc_frame_reader_next(&client->reader, &data->rx_msg);
+
+        if (ret == 0 && data->rx_msg.which_payload == zmk_ipc_ClientMessage_hello_tag) {
+            kscan_ipc_reply_hello(dev, client, &data->rx_msg.payload.hello);
+        } else if (ret == 0) {
+            dispatch_message(dev, &data->rx_msg);
+        } else if (ret == -EAGAIN || ret == -EWOULDBLOCK) {
+            return;
         } else if (ret == -ECONNRESET || ret == -EPIPE) {
-            LOG_INF("kscan IPC: client disconnected");
-            close(data->client_fd);
-            data->client_fd = -1;
+            LOG_INF("kscan IPC: client fd=%d disconnected", client->fd);
+            kscan_ipc_close_client(client);
         } else if (ret == -EMSGSIZE) {
             LOG_WRN("kscan IPC: oversized frame, closing connection");
-            close(data->client_fd);
-            data->client_fd = -1;
+            kscan_ipc_close_client(client);
         } else if (ret == -EBADMSG) {
             LOG_WRN("kscan IPC: decode error, skipping frame");
             /* Keep the connection — the stream may still be valid */
         } else {
             LOG_ERR("kscan IPC: recv error %d, closing connection", ret);
-            close(data->client_fd);
-            data->client_fd = -1;
+            kscan_ipc_close_client(client);
+        }
+    }
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_SHM)
+static void kscan_ipc_service_shm(struct zmk_ipc_loop_source *source) {
+    struct kscan_ipc_data *data = CONTAINER_OF(source, struct kscan_ipc_data, shm_source);
+    const struct device *dev = data->dev;
+
+    for (;;) {
+        int ret = zmk_ipc_shm_ring_next(&data->ring, &data->rx_msg);
+
+        if (ret == 0) {
+            dispatch_message(dev, &data->rx_msg);
+        } else if (ret == -EAGAIN) {
+            return;
         }
+        /* Bad frames are logged and discarded by the ring; keep draining. */
     }
 }
+#endif
 
 /* -------------------------------------------------------------------------
  * kscan driver API
@@ -227,7 +631,7 @@ static const struct kscan_driver_api kscan_ipc_driver_api = {
 };
 
 /* -------------------------------------------------------------------------
- * Common init helper (called from per-instance wrapper)
+ * Init
  * ------------------------------------------------------------------------- */
 
 static int kscan_ipc_init(const struct device *dev) {
@@ -235,50 +639,46 @@ static int kscan_ipc_init(const struct device *dev) {
     const struct kscan_ipc_config *cfg = dev->config;
 
     data->dev       = dev;
-    data->client_fd = -1;
     data->server_fd = -1;
     data->enabled   = false;
     data->callback  = NULL;
 
-    data->server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
-    if (data->server_fd < 0) {
-        LOG_ERR("kscan IPC: socket() failed (errno=%d)", errno);
-        return -errno;
+    for (int i = 0; i < KSCAN_IPC_MAX_CLIENTS; i++) {
+        data->clients[i].fd  = -1;
+        data->clients[i].dev = dev;
     }
 
-    struct sockaddr_un addr;
-    memset(&addr, 0, sizeof(addr));
-    addr.sun_family = AF_UNIX;
-    strncpy(addr.sun_path, cfg->socket_path, sizeof(addr.sun_path) - 1);
-
-    unlink(cfg->socket_path);
+    int fd = zmk_ipc_listener_open(cfg->socket_path, KSCAN_IPC_MAX_CLIENTS);
+    if (fd < 0) {
+        return fd; /* already logged inside helper */
+    }
+    data->server_fd = fd;
 
-    if (bind(data->server_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
-        LOG_ERR("kscan IPC: bind() failed (errno=%d)", errno);
+    int err = zmk_ipc_loop_add(&data->server_source, data->server_fd, kscan_ipc_accept_clients);
+    if (err < 0) {
         close(data->server_fd);
         data->server_fd = -1;
-        return -errno;
+        return err;
     }
 
-    if (listen(data->server_fd, 1) < 0) {
-        LOG_ERR("kscan IPC: listen() failed (errno=%d)", errno);
-        close(data->server_fd);
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_SHM)
+    BUILD_ASSERT(CONFIG_ZMK_KSCAN_IPC_SHM_SIZE >= ZMK_IPC_MSG_FRAME_MAX,
+                 "CONFIG_ZMK_KSCAN_IPC_SHM_SIZE cannot hold a maximum-size frame");
+
+    err = zmk_ipc_shm_ring_create(&data->ring, cfg->shm_path, CONFIG_ZMK_KSCAN_IPC_SHM_SIZE);
+    if (err < 0) {
+        LOG_ERR("kscan IPC: cannot create shm ring %s (err %d)", cfg->shm_path, err);
+        close(data->server_fd); /* also removes it from the event loop */
         data->server_fd = -1;
-        return -errno;
+        return err;
     }
+    zmk_ipc_loop_add_poll(&data->shm_source, kscan_ipc_service_shm);
+    LOG_INF("kscan IPC: polling shm ring %s", cfg->shm_path);
+#endif
 
     LOG_INF("kscan IPC: listening on %s (protobuf/length-prefix framing)",
             cfg->socket_path);
 
-    k_thread_create(&data->read_thread,
-                    data->read_stack,
-                    CONFIG_ZMK_KSCAN_IPC_THREAD_STACK_SIZE,
-                    kscan_ipc_read_thread_func,
-                    (void *)dev, NULL, NULL,
-                    K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
-
-    k_thread_name_set(&data->read_thread, "kscan_ipc");
-
     return 0;
 }
 
@@ -287,24 +687,21 @@ static int kscan_ipc_init(const struct device *dev) {
  * ------------------------------------------------------------------------- */
 
 #define KSCAN_IPC_INST_INIT(n)                                                              \
-    K_THREAD_STACK_DEFINE(kscan_ipc_read_stack_##n,                                         \
-                          CONFIG_ZMK_KSCAN_IPC_THREAD_STACK_SIZE);                          \
+    BUILD_ASSERT(DT_INST_PROP(n, context) < CONFIG_ZMK_CONTEXT_COUNT,                       \
+                 "kscan IPC context must be below CONFIG_ZMK_CONTEXT_COUNT");               \
                                                                                             \
     static struct kscan_ipc_data kscan_ipc_data_##n;                                        \
                                                                                             \
     static const struct kscan_ipc_config kscan_ipc_config_##n = {                           \
         .socket_path = DT_INST_PROP(n, socket_path),                                        \
+        IF_ENABLED(CONFIG_ZMK_KSCAN_IPC_SHM, (.shm_path = DT_INST_PROP(n, shm_path),))      \
         .rows        = DT_INST_PROP(n, rows),                                               \
         .columns     = DT_INST_PROP(n, columns),                                            \
+        .context     = DT_INST_PROP(n, context),                                            \
+        .exit_after  = DT_INST_PROP(n, exit_after),                                         \
     };                                                                                      \
                                                                                             \
-    static int kscan_ipc_init_##n(const struct device *dev) {                               \
-        struct kscan_ipc_data *data = dev->data;                                            \
-        data->read_stack = kscan_ipc_read_stack_##n;                                        \
-        return kscan_ipc_init(dev);                                                         \
-    }                                                                                       \
-                                                                                            \
-    DEVICE_DT_INST_DEFINE(n, kscan_ipc_init_##n, NULL,                                     \
+    DEVICE_DT_INST_DEFINE(n, kscan_ipc_init, NULL,                                          \
                           &kscan_ipc_data_##n, &kscan_ipc_config_##n,                       \
                           POST_KERNEL, CONFIG_KSCAN_INIT_PRIORITY,                          \
                           &kscan_ipc_driver_api);
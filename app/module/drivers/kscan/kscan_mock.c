@@ -12,18 +12,116 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_EVENTS_FILE)
+#include <stdio.h>
+#endif // IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_EVENTS_FILE)
+
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <dt-bindings/zmk/kscan_mock.h>
+#include <zmk/physical_layouts.h>
+
+struct kscan_mock_config {
+    const uint32_t *events;
+    size_t events_len;
+    bool exit_after;
+    // Mocks of a context other than 0 are a keyboard of their own rather than the kscan of a
+    // layout, and queue their events for that context themselves
+    uint8_t context;
+};
 
 struct kscan_mock_data {
     kscan_callback_t callback;
 
+    // The events replayed, either the configured ones or those of the events file
+    const uint32_t *events;
+    size_t events_len;
+
     uint32_t event_index;
     struct k_work_delayable work;
     const struct device *dev;
 };
 
+static void kscan_mock_schedule_next_event(const struct device *dev) {
+    struct kscan_mock_data *data = dev->data;
+    const struct kscan_mock_config *cfg = dev->config;
+
+    if (data->event_index < data->events_len) {
+        uint32_t ev = data->events[data->event_index];
+        LOG_DBG("delaying next keypress: %d", ZMK_MOCK_MSEC(ev));
+        k_work_schedule(&data->work, K_MSEC(ZMK_MOCK_MSEC(ev)));
+    } else if (cfg->exit_after) {
+        LOG_DBG("Exiting");
+        exit(0);
+    }
+}
+
+static void kscan_mock_work_handler(struct k_work *work) {
+    struct k_work_delayable *d_work = k_work_delayable_from_work(work);
+    struct kscan_mock_data *data = CONTAINER_OF(d_work, struct kscan_mock_data, work);
+    const struct kscan_mock_config *cfg = data->dev->config;
+
+    if (data->event_index >= data->events_len) {
+        if (cfg->exit_after)
+            exit(0);
+        else
+            return;
+    }
+
+    uint32_t ev = data->events[data->event_index];
+    LOG_DBG("ev %u row %d column %d state %d\n", ev, ZMK_MOCK_ROW(ev), ZMK_MOCK_COL(ev),
+            ZMK_MOCK_IS_PRESS(ev));
+    if (cfg->context == 0) {
+        data->callback(data->dev, ZMK_MOCK_ROW(ev), ZMK_MOCK_COL(ev), ZMK_MOCK_IS_PRESS(ev));
+    } else {
+        zmk_physical_layouts_kscan_context_changed(cfg->context, ZMK_MOCK_ROW(ev),
+                                                   ZMK_MOCK_COL(ev), ZMK_MOCK_IS_PRESS(ev));
+    }
+    kscan_mock_schedule_next_event(data->dev);
+    data->event_index++;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_EVENTS_FILE)
+
+static uint32_t file_events[CONFIG_ZMK_KSCAN_MOCK_MAX_FILE_EVENTS];
+
+// Reads the whitespace separated events of the file named by ZMK_KSCAN_MOCK_EVENTS, returning
+// their number, 0 if there's no such file, or a negative error.
+static int kscan_mock_read_events_file(void) {
+    const char *path = getenv("ZMK_KSCAN_MOCK_EVENTS");
+    if (path == NULL || path[0] == '\0') {
+        return 0;
+    }
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        LOG_ERR("Unable to open the mock events file %s", path);
+        return -ENOENT;
+    }
+
+    int len = 0;
+    long long ev;
+    while (fscanf(file, "%lli", &ev) == 1) {
+        if (len == ARRAY_SIZE(file_events)) {
+            LOG_ERR("More than %d events in %s", (int)ARRAY_SIZE(file_events), path);
+            fclose(file);
+            return -ENOMEM;
+        }
+        file_events[len++] = (uint32_t)ev;
+    }
+
+    bool complete = feof(file);
+    fclose(file);
+    if (!complete) {
+        LOG_ERR("Invalid event in %s after %d events", path, len);
+        return -EINVAL;
+    }
+
+    return len;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_EVENTS_FILE)
+
 static int kscan_mock_disable_callback(const struct device *dev) {
     struct kscan_mock_data *data = dev->data;
 
@@ -44,60 +142,53 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
     return 0;
 }
 
+static int kscan_mock_enable_callback(const struct device *dev) {
+    kscan_mock_schedule_next_event(dev);
+    return 0;
+}
+
+static int kscan_mock_init(const struct device *dev) {
+    struct kscan_mock_data *data = dev->data;
+    const struct kscan_mock_config *cfg = dev->config;
+
+    data->dev = dev;
+    data->events = cfg->events;
+    data->events_len = cfg->events_len;
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_EVENTS_FILE)
+    int len = kscan_mock_read_events_file();
+    if (len < 0) {
+        return len;
+    }
+    if (len > 0) {
+        data->events = file_events;
+        data->events_len = len;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_EVENTS_FILE)
+
+    k_work_init_delayable(&data->work, kscan_mock_work_handler);
+    if (cfg->context != 0) {
+        kscan_mock_schedule_next_event(dev);
+    }
+    return 0;
+}
+
+static const struct kscan_driver_api mock_driver_api = {
+    .config = kscan_mock_configure,
+    .enable_callback = kscan_mock_enable_callback,
+    .disable_callback = kscan_mock_disable_callback,
+};
+
 #define MOCK_INST_INIT(n)                                                                          \
-    struct kscan_mock_config_##n {                                                                 \
-        uint32_t events[DT_INST_PROP_LEN(n, events)];                                              \
-        bool exit_after;                                                                           \
-    };                                                                                             \
-    static void kscan_mock_schedule_next_event_##n(const struct device *dev) {                     \
-        struct kscan_mock_data *data = dev->data;                                                  \
-        const struct kscan_mock_config_##n *cfg = dev->config;                                     \
-        if (data->event_index < DT_INST_PROP_LEN(n, events)) {                                     \
-            uint32_t ev = cfg->events[data->event_index];                                          \
-            LOG_DBG("delaying next keypress: %d", ZMK_MOCK_MSEC(ev));                              \
-            k_work_schedule(&data->work, K_MSEC(ZMK_MOCK_MSEC(ev)));                               \
-        } else if (cfg->exit_after) {                                                              \
-            LOG_DBG("Exiting");                                                                    \
-            exit(0);                                                                               \
-        }                                                                                          \
-    }                                                                                              \
-    static void kscan_mock_work_handler_##n(struct k_work *work) {                                 \
-        struct k_work_delayable *d_work = k_work_delayable_from_work(work);                        \
-        struct kscan_mock_data *data = CONTAINER_OF(d_work, struct kscan_mock_data, work);         \
-        const struct kscan_mock_config_##n *cfg = data->dev->config;                               \
-        if (data->event_index >= DT_INST_PROP_LEN(n, events)) {                                    \
-            if (cfg->exit_after)                                                                   \
-                exit(0);                                                                           \
-            else                                                                                   \
-                return;                                                                            \
-        }                                                                                          \
-        uint32_t ev = cfg->events[data->event_index];                                              \
-        LOG_DBG("ev %u row %d column %d state %d\n", ev, ZMK_MOCK_ROW(ev), ZMK_MOCK_COL(ev),       \
-                ZMK_MOCK_IS_PRESS(ev));                                                            \
-        data->callback(data->dev, ZMK_MOCK_ROW(ev), ZMK_MOCK_COL(ev), ZMK_MOCK_IS_PRESS(ev));      \
-        kscan_mock_schedule_next_event_##n(data->dev);                                             \
-        data->event_index++;                                                                       \
-    }                                                                                              \
-    static int kscan_mock_init_##n(const struct device *dev) {                                     \
-        struct kscan_mock_data *data = dev->data;                                                  \
-        data->dev = dev;                                                                           \
-        k_work_init_delayable(&data->work, kscan_mock_work_handler_##n);                           \
-        return 0;                                                                                  \
-    }                                                                                              \
-    static int kscan_mock_enable_callback_##n(const struct device *dev) {                          \
-        kscan_mock_schedule_next_event_##n(dev);                                                   \
-        return 0;                                                                                  \
-    }                                                                                              \
-    static const struct kscan_driver_api mock_driver_api_##n = {                                   \
-        .config = kscan_mock_configure,                                                            \
-        .enable_callback = kscan_mock_enable_callback_##n,                                         \
-        .disable_callback = kscan_mock_disable_callback,                                           \
-    };                                                                                             \
+    static const uint32_t kscan_mock_events_##n[] = DT_INST_PROP_OR(n, events, {0});               \
     static struct kscan_mock_data kscan_mock_data_##n;                                             \
-    static const struct kscan_mock_config_##n kscan_mock_config_##n = {                            \
-        .events = DT_INST_PROP(n, events), .exit_after = DT_INST_PROP(n, exit_after)};             \
-    DEVICE_DT_INST_DEFINE(n, kscan_mock_init_##n, NULL, &kscan_mock_data_##n,                      \
-                          &kscan_mock_config_##n, POST_KERNEL, CONFIG_KSCAN_INIT_PRIORITY,         \
-                          &mock_driver_api_##n);
+    static const struct kscan_mock_config kscan_mock_config_##n = {                                \
+        .events = kscan_mock_events_##n,                                                           \
+        .events_len = DT_INST_PROP_LEN_OR(n, events, 0),                                           \
+        .exit_after = DT_INST_PROP(n, exit_after),                                                 \
+        .context = DT_INST_PROP(n, context),                                                       \
+    };                                                                                             \
+    DEVICE_DT_INST_DEFINE(n, kscan_mock_init, NULL, &kscan_mock_data_##n, &kscan_mock_config_##n,  \
+                          POST_KERNEL, CONFIG_KSCAN_INIT_PRIORITY, &mock_driver_api);
 
 DT_INST_FOREACH_STATUS_OKAY(MOCK_INST_INIT)
@@ -29,6 +29,10 @@ struct zmk_debounce_config {
 /**
  * Debounces one switch.
  *
+ * With CONFIG_ZMK_DEBOUNCE_EAGER, a change is reported on its first edge, and the switch is then
+ * ignored for the press or release time of its new state. Otherwise it is reported once the switch
+ * has been stable for that time.
+ *
  * @param state The state for the switch to debounce.
  * @param active Is the switch currently pressed?
  * @param elapsed_ms Time elapsed since the previous update in milliseconds.
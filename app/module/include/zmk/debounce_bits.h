@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+#include <zmk/debounce.h>
+
+/**
+ * Debounces a set of switches with the same algorithm as zmk_debounce_update(), keeping their
+ * states as bitmaps of 32 switches per word. Only switches whose debouncer is running have a
+ * counter, taken from a fixed pool, so an update only does work for switches that are changing.
+ */
+
+struct zmk_debounce_bits_counter {
+    uint16_t index;
+    uint16_t counter;
+};
+
+struct zmk_debounce_bits {
+    size_t words;
+    /** Switches latched as pressed. */
+    uint32_t *pressed;
+    /** Switches whose state changed in the last update of their word. */
+    uint32_t *changed;
+    /** Switches which hold a counter. */
+    uint32_t *counting;
+    struct zmk_debounce_bits_counter *counters;
+    size_t counters_size;
+    size_t counters_len;
+    size_t pressed_count;
+    /**
+     * Debounce profile of each switch, by word * 32 + bit, as an index into the configs passed to
+     * zmk_debounce_bits_update(). NULL if every switch uses the first one.
+     */
+    const uint8_t *profiles;
+};
+
+/**
+ * Define a struct zmk_debounce_bits and its storage.
+ *
+ * @param name Name of the variable to define.
+ * @param words Number of 32 switch words.
+ * @param max_counters Number of switches which can be debounced at the same time.
+ */
+#define ZMK_DEBOUNCE_BITS_DEFINE(name, _words, max_counters)                                       \
+    static uint32_t name##_pressed[_words];                                                        \
+    static uint32_t name##_changed[_words];                                                        \
+    static uint32_t name##_counting[_words];                                                       \
+    static struct zmk_debounce_bits_counter name##_counters[max_counters];                         \
+    static struct zmk_debounce_bits name = {                                                       \
+        .words = _words,                                                                           \
+        .pressed = name##_pressed,                                                                 \
+        .changed = name##_changed,                                                                 \
+        .counting = name##_counting,                                                               \
+        .counters = name##_counters,                                                               \
+        .counters_size = max_counters,                                                             \
+    }
+
+/**
+ * Debounces the 32 switches of one word.
+ *
+ * A switch which starts changing while every counter is in use is left as it is, and starts
+ * debouncing on a later update once a counter is free.
+ *
+ * @param bits The switches to debounce.
+ * @param word Index of the word to update.
+ * @param active Which switches of the word are currently pressed.
+ * @param elapsed_ms Time elapsed since the previous update in milliseconds.
+ * @param config Debounce settings, an array indexed by the profile of each switch if bits->profiles
+ * is set.
+ */
+void zmk_debounce_bits_update(struct zmk_debounce_bits *bits, size_t word, uint32_t active,
+                              int elapsed_ms, const struct zmk_debounce_config *config);
+
+/**
+ * @returns whether any switch is either latched as pressed or is still being debounced. If this
+ * returns true, the kscan driver should continue to poll quickly.
+ */
+static inline bool zmk_debounce_bits_is_active(const struct zmk_debounce_bits *bits) {
+    return bits->pressed_count > 0 || bits->counters_len > 0;
+}
+
+/**
+ * @returns the switches of a word which are latched as pressed.
+ */
+static inline uint32_t zmk_debounce_bits_get_pressed(const struct zmk_debounce_bits *bits,
+                                                     size_t word) {
+    return bits->pressed[word];
+}
+
+/**
+ * @returns the switches of a word whose pressed state changed in the last update of the word.
+ */
+static inline uint32_t zmk_debounce_bits_get_changed(const struct zmk_debounce_bits *bits,
+                                                     size_t word) {
+    return bits->changed[word];
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/device.h>
+
+#include "zmk_ipc.pb.h"
+
+/**
+ * @brief Inject a client message into a kscan IPC device.
+ *
+ * Used by other IPC endpoints (e.g. the observer socket acting as the
+ * bidirectional Connect stream) to feed key events into the same kscan
+ * pipeline as the device's own socket.  Key events are dispatched exactly
+ * as if they had arrived on the kscan socket; other payloads are ignored.
+ *
+ * @param dev A zmk,kscan-ipc device.
+ * @param msg Decoded client message.
+ */
+void zmk_kscan_ipc_inject(const struct device *dev, const zmk_ipc_ClientMessage *msg);
+
+/**
+ * @brief Describe a kscan IPC device in a Capabilities reply.
+ *
+ * Sets the key matrix size from the device's DTS `rows` and `columns`, ORs
+ * the ClientMessage payloads the device dispatches into message_mask and
+ * sets max_message_frame.  Other fields are left alone.
+ *
+ * @param dev  A zmk,kscan-ipc device.
+ * @param caps Reply being built.
+ */
+void zmk_kscan_ipc_fill_capabilities(const struct device *dev, zmk_ipc_Capabilities *caps);
@@ -6,11 +6,45 @@
 
 #include <zmk/debounce.h>
 
-static uint32_t get_threshold(const struct zmk_debounce_state *state,
-                              const struct zmk_debounce_config *config) {
-    return state->pressed ? config->debounce_release_ms : config->debounce_press_ms;
+static void decrement_counter(struct zmk_debounce_state *state, const int elapsed_ms) {
+    if (state->counter < elapsed_ms) {
+        state->counter = 0;
+    } else {
+        state->counter -= elapsed_ms;
+    }
 }
 
+#if IS_ENABLED(CONFIG_ZMK_DEBOUNCE_EAGER)
+
+static uint32_t get_lockout(const struct zmk_debounce_state *state,
+                            const struct zmk_debounce_config *config) {
+    return state->pressed ? config->debounce_press_ms : config->debounce_release_ms;
+}
+
+void zmk_debounce_update(struct zmk_debounce_state *state, const bool active, const int elapsed_ms,
+                         const struct zmk_debounce_config *config) {
+    // Eager debouncing reports the first edge right away, then ignores the switch until its
+    // lockout time has passed. The counter holds the lockout time left.
+    state->changed = false;
+
+    if (state->counter > 0) {
+        decrement_counter(state, elapsed_ms);
+        if (state->counter > 0) {
+            return;
+        }
+    }
+
+    if (active == state->pressed) {
+        return;
+    }
+
+    state->pressed = active;
+    state->changed = true;
+    state->counter = MIN(get_lockout(state, config), DEBOUNCE_COUNTER_MAX);
+}
+
+#else
+
 static void increment_counter(struct zmk_debounce_state *state, const int elapsed_ms) {
     if (state->counter + elapsed_ms > DEBOUNCE_COUNTER_MAX) {
         state->counter = DEBOUNCE_COUNTER_MAX;
@@ -19,12 +53,9 @@ static void increment_counter(struct zmk_debounce_state *state, const int elapse
     }
 }
 
-static void decrement_counter(struct zmk_debounce_state *state, const int elapsed_ms) {
-    if (state->counter < elapsed_ms) {
-        state->counter = 0;
-    } else {
-        state->counter -= elapsed_ms;
-    }
+static uint32_t get_threshold(const struct zmk_debounce_state *state,
+                              const struct zmk_debounce_config *config) {
+    return state->pressed ? config->debounce_release_ms : config->debounce_press_ms;
 }
 
 void zmk_debounce_update(struct zmk_debounce_state *state, const bool active, const int elapsed_ms,
@@ -53,6 +84,8 @@ void zmk_debounce_update(struct zmk_debounce_state *state, const bool active, co
     state->changed = true;
 }
 
+#endif // IS_ENABLED(CONFIG_ZMK_DEBOUNCE_EAGER)
+
 bool zmk_debounce_is_active(const struct zmk_debounce_state *state) {
     return state->pressed || state->counter > 0;
 }
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zmk/debounce_bits.h>
+
+static uint32_t get_threshold(const struct zmk_debounce_bits *bits, size_t word, uint32_t bit,
+                              const struct zmk_debounce_config *config) {
+    if (bits->profiles) {
+        config = &config[bits->profiles[word * 32 + __builtin_ctz(bit)]];
+    }
+
+    return (bits->pressed[word] & bit) ? config->debounce_release_ms : config->debounce_press_ms;
+}
+
+static void flip(struct zmk_debounce_bits *bits, size_t word, uint32_t bit) {
+    bits->pressed[word] ^= bit;
+    bits->changed[word] |= bit;
+
+    if (bits->pressed[word] & bit) {
+        bits->pressed_count++;
+    } else {
+        bits->pressed_count--;
+    }
+}
+
+static void release_counter(struct zmk_debounce_bits *bits, size_t word, uint32_t bit, size_t i) {
+    bits->counting[word] &= ~bit;
+    bits->counters[i] = bits->counters[--bits->counters_len];
+}
+
+#if IS_ENABLED(CONFIG_ZMK_DEBOUNCE_EAGER)
+
+// Runs the lockout counter at i, which belongs to the word. Returns false if it was released and
+// another counter moved into its place.
+static bool update_counter(struct zmk_debounce_bits *bits, size_t word, uint32_t active, size_t i,
+                           int elapsed_ms, const struct zmk_debounce_config *config) {
+    struct zmk_debounce_bits_counter *counter = &bits->counters[i];
+
+    if (counter->counter > elapsed_ms) {
+        counter->counter -= elapsed_ms;
+        return true;
+    }
+
+    release_counter(bits, word, BIT(counter->index % 32), i);
+    return false;
+}
+
+#else
+
+// Runs the counter at i, which belongs to the word. Returns false if it was released and another
+// counter moved into its place.
+static bool update_counter(struct zmk_debounce_bits *bits, size_t word, uint32_t active, size_t i,
+                           int elapsed_ms, const struct zmk_debounce_config *config) {
+    struct zmk_debounce_bits_counter *counter = &bits->counters[i];
+    const uint32_t bit = BIT(counter->index % 32);
+
+    if (!((active ^ bits->pressed[word]) & bit)) {
+        if (counter->counter <= elapsed_ms) {
+            release_counter(bits, word, bit, i);
+            return false;
+        }
+
+        counter->counter -= elapsed_ms;
+        return true;
+    }
+
+    if (counter->counter < get_threshold(bits, word, bit, config)) {
+        counter->counter = MIN(counter->counter + elapsed_ms, DEBOUNCE_COUNTER_MAX);
+        return true;
+    }
+
+    flip(bits, word, bit);
+    release_counter(bits, word, bit, i);
+    return false;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_DEBOUNCE_EAGER)
+
+void zmk_debounce_bits_update(struct zmk_debounce_bits *bits, size_t word, uint32_t active,
+                              int elapsed_ms, const struct zmk_debounce_config *config) {
+    bits->changed[word] = 0;
+
+    if (bits->counting[word]) {
+        for (size_t i = 0; i < bits->counters_len;) {
+            if (bits->counters[i].index / 32 != word ||
+                update_counter(bits, word, active, i, elapsed_ms, config)) {
+                i++;
+            }
+        }
+    }
+
+    // Switches without a counter have settled, so only those whose level differs need one.
+    for (uint32_t start = (active ^ bits->pressed[word]) & ~bits->counting[word]; start;
+         start &= start - 1) {
+        const uint32_t bit = start & -start;
+        // With eager debouncing, this is also how long the switch is ignored once it flips.
+        const uint32_t threshold = get_threshold(bits, word, bit, config);
+
+        if (threshold == 0) {
+            flip(bits, word, bit);
+            continue;
+        }
+
+        if (bits->counters_len == bits->counters_size || elapsed_ms <= 0) {
+            continue;
+        }
+
+        bits->counting[word] |= bit;
+        bits->counters[bits->counters_len++] = (struct zmk_debounce_bits_counter){
+            .index = word * 32 + __builtin_ctz(bit),
+#if IS_ENABLED(CONFIG_ZMK_DEBOUNCE_EAGER)
+            .counter = MIN(threshold, DEBOUNCE_COUNTER_MAX),
+#else
+            .counter = MIN(elapsed_ms, DEBOUNCE_COUNTER_MAX),
+#endif
+        };
+
+        if (IS_ENABLED(CONFIG_ZMK_DEBOUNCE_EAGER)) {
+            flip(bits, word, bit);
+        }
+    }
+}
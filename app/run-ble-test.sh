@@ -3,6 +3,14 @@
 # Copyright (c) 2023 The ZMK Contributors
 # SPDX-License-Identifier: MIT
 
+##
+# Optional environment variables:
+#  J:                       Number of test cases simulated in parallel (default is 4)
+#  ZMK_TESTS_AUTO_ACCEPT:   Replace snapshot files with new output
+#  BLE_TESTS_SPEED:         How many times faster than real time a simulation may run (default is
+#                           10). Simulated time is lock-stepped across the devices whatever the
+#                           ratio, so a large one like 1000 only removes the real time limit.
+
 if [ -z "$1" ]; then
     echo "Usage: ./run-ble-test.sh <path to testcase>"
     exit 1
@@ -91,6 +99,8 @@ fi
 exe_name=${testcase//\//_}
 # Remove trailing underscores
 exe_name=${exe_name%%_}
+# Unique to this run, so parallel runs of the same test case don't share a simulation
+sim_id="${exe_name}_$$"
 
 start_dir=$(pwd)
 cp build/$testcase/zephyr/zmk.exe "${BSIM_OUT_PATH}/bin/${exe_name}"
@@ -108,16 +118,16 @@ if [ -e "${start_dir}/build/$testcase/output.log" ]; then
 fi
 
 sibling_counts=$(wc -l ${start_dir}/${testcase}/siblings.txt | cut -d' ' -f1)
-./${exe_name} -d=0 -s=${exe_name} | tee -a "${start_dir}/build/$testcase/output.log" > "${output_dev}" &
-./bs_device_handbrake -s=${exe_name} -d=1 -r=10 > "${output_dev}" &
+./${exe_name} -d=0 -s=${sim_id} | tee -a "${start_dir}/build/$testcase/output.log" > "${output_dev}" &
+./bs_device_handbrake -s=${sim_id} -d=1 -r=${BLE_TESTS_SPEED:-10} > "${output_dev}" &
 
 cat "${start_dir}/${testcase}/siblings.txt" |
 while IFS= read -r line
 do
-  ${line} -s=${exe_name} | tee -a "${start_dir}/build/$testcase/output.log" > "${output_dev}" &
+  ${line} -s=${sim_id} | tee -a "${start_dir}/build/$testcase/output.log" > "${output_dev}" &
 done
 
-./bs_2G4_phy_v1 -s=${exe_name} -D=$(( 2 + sibling_counts )) -sim_length=50e6 > "${output_dev}" 2>&1
+./bs_2G4_phy_v1 -s=${sim_id} -D=$(( 2 + sibling_counts )) -sim_length=50e6 > "${output_dev}" 2>&1
 
 popd > /dev/null 2>&1
 
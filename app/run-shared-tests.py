@@ -0,0 +1,375 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2026 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+
+"""
+Runs test cases that only differ in their mock kscan events against a shared build.
+
+Test cases are grouped by everything that goes into their build: the keymap without its
+`&kscan { events = <...>; };` list, the files it includes and the other files of the test case.
+Each group is built once, and each of its test cases runs the same zmk.exe with its events read
+from a file named by ZMK_KSCAN_MOCK_EVENTS. Test cases whose events can't be extracted, or that
+define mock kscans of their own, are left to run-test.sh, which builds them on their own.
+
+With ZMK_TESTS_POOL set, each group is instead built with the mock kscan turned into a kscan IPC
+one and virtual time (boards/native/native_sim/zmk_test_pool.*), and the events are sent over its
+socket: every delay is an AdvanceTime, so a test case takes as long as it needs the CPU rather than
+as long as its timeouts add up to. Every test case still gets an instance of its own, since the
+state a test case leaves behind (toggled layers, caps word, quick-tap and idle timestamps) can't be
+reset reliably from outside. Instead, the instance for the next test case of a group is booted
+while the current one runs, and each has its own sockets through ZMK_IPC_INSTANCE.
+
+Takes the test case directories as arguments, and the same environment variables as run-test.sh.
+"""
+
+import hashlib
+import itertools
+import os
+import re
+import socket
+import struct
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+
+SRC_DIR = Path(os.environ.get("ZMK_SRC_DIR") or ".")
+BUILD_DIR = Path(os.environ.get("ZMK_BUILD_DIR") or SRC_DIR / "build")
+TESTS_DIR = BUILD_DIR / "tests"
+PASS_FAIL_LOG = TESTS_DIR / "pass-fail.log"
+RUN_TEST = Path(__file__).resolve().parent / "run-test.sh"
+DECODE_TRACE = Path(__file__).resolve().parent / "decode-ipc-trace.py"
+
+POOL = bool(os.environ.get("ZMK_TESTS_POOL"))
+POOL_FILES = Path(__file__).resolve().parent / "boards" / "native" / "native_sim" / "zmk_test_pool"
+# socket-path of zmk_test_pool.overlay, before ZMK_IPC_INSTANCE is appended
+POOL_KSCAN_ADDRESS = "@zmk_test_kscan"
+POOL_CONNECT_TIMEOUT = 10
+POOL_RUN_TIMEOUT = 60
+# Numbers the instances of this runner, whose names also carry its pid
+POOL_INSTANCES = itertools.count()
+
+# ClientMessage payload field numbers, see proto/zmk_ipc.proto
+KEY_EVENT = 1
+ADVANCE_TIME = 4
+KEY_PRESS = 1
+KEY_RELEASE = 2
+
+# Files of a test case that only matter once zmk.exe has run
+RESULT_FILES = {"events.patterns", "keycode_events.snapshot", "trace_events.snapshot", "pending"}
+
+KSCAN_EVENTS_RE = re.compile(r"(&kscan\s*\{[^}]*?\bevents\s*=\s*<)([^>]*)(>)", re.S)
+MOCK_EVENT_RE = re.compile(
+    r"ZMK_MOCK_(PRESS|RELEASE)\s*\(\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*\)"
+)
+# Further mocks, e.g. of another context, replay their own events however the test case is run
+MOCK_NODE_RE = re.compile(r'compatible\s*=\s*"zmk,kscan-mock"')
+COMMENT_RE = re.compile(r"/\*.*?\*/|//[^\n]*", re.S)
+INCLUDE_RE = re.compile(r'^\s*#include\s+"([^"]+)"', re.M)
+
+
+class TestCase:
+    def __init__(self, path):
+        self.path = Path(path)
+        self.name = re.sub(r".*/tests/", "", str(self.path.resolve()))
+        self.out_dir = TESTS_DIR / self.name
+        self.events = None
+        self.build_key = None
+
+        keymap = (self.path / "native_sim.keymap").read_text()
+        match = KSCAN_EVENTS_RE.search(keymap)
+        if not match or MOCK_NODE_RE.search(keymap):
+            return
+
+        events = parse_events(match.group(2))
+        if not events:
+            return
+
+        stripped = keymap[: match.start(2)] + keymap[match.end(2) :]
+        self.events = events
+        self.build_key = build_key(self.path, stripped)
+
+
+def parse_events(text):
+    """Encodes the mock events as ZMK_MOCK_PRESS and ZMK_MOCK_RELEASE do, or returns None if the
+    list has anything else in it."""
+    text = COMMENT_RE.sub("", text)
+    if MOCK_EVENT_RE.sub("", text).strip():
+        return None
+
+    events = []
+    for kind, row, col, msec in MOCK_EVENT_RE.findall(text):
+        event = int(row) + (int(col) << 8) + (int(msec) << 16)
+        if kind == "PRESS":
+            event |= 1 << 31
+        events.append(event)
+
+    return events
+
+
+def build_key(path, keymap):
+    digest = hashlib.sha256(keymap.encode())
+    seen = set()
+
+    def add_includes(text, base):
+        for include in INCLUDE_RE.findall(text):
+            included = (base / include).resolve()
+            if included in seen or not included.is_file():
+                continue
+            seen.add(included)
+            contents = included.read_text()
+            digest.update(str(included).encode() + b"\0" + contents.encode())
+            add_includes(contents, included.parent)
+
+    add_includes(keymap, path)
+
+    for file in sorted(path.iterdir()):
+        if file.is_file() and file.name not in RESULT_FILES | {"native_sim.keymap"}:
+            digest.update(file.name.encode() + b"\0" + file.read_bytes())
+
+    return digest.hexdigest()
+
+
+def varint(value):
+    out = bytearray()
+    while value > 0x7F:
+        out.append(value & 0x7F | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+def varint_field(number, value):
+    return varint(number << 3) + varint(value)
+
+
+def message_field(number, message):
+    return varint(number << 3 | 2) + varint(len(message)) + message
+
+
+def client_frame(number, message):
+    """Encodes a length-prefixed ClientMessage frame with the given payload."""
+    data = message_field(number, message)
+    return struct.pack(">I", len(data)) + data
+
+
+def advance_frame(event):
+    return client_frame(ADVANCE_TIME, varint_field(1, (event >> 16) & 0x7FFF))
+
+
+def replay_frames(events):
+    """The frames that replay mock events as zmk,kscan-mock does: it waits for the delay of the
+    first event before it, and after each event for that event's delay."""
+    frames = []
+    for index, event in enumerate(events):
+        row, col = event & 0xFF, (event >> 8) & 0xFF
+        press = bool(event & (1 << 31))
+        if index == 0:
+            frames.append(advance_frame(events[0]))
+
+        position = varint_field(1, row) + varint_field(2, col)
+        key_event = varint_field(1, KEY_PRESS if press else KEY_RELEASE)
+        frames.append(client_frame(KEY_EVENT, key_event + message_field(2, position)))
+        frames.append(advance_frame(event))
+
+    return b"".join(frames)
+
+
+def log_result(line):
+    print(line, flush=True)
+    with open(PASS_FAIL_LOG, "a") as log:
+        log.write(line + "\n")
+
+
+def build(case, build_dir):
+    cmd = ["west", "build"]
+    if os.environ.get("ZMK_SRC_DIR"):
+        cmd += ["-s", os.environ["ZMK_SRC_DIR"]]
+    cmd += ["-d", str(build_dir), "-b", "native_sim//zmk_test_mock", "-p", "--"]
+    cmd += ["-DCONFIG_ASSERT=y", f"-DZMK_CONFIG={case.path.resolve()}"]
+    if os.environ.get("ZMK_EXTRA_MODULES"):
+        cmd += [f"-DZMK_EXTRA_MODULES={Path(os.environ['ZMK_EXTRA_MODULES']).resolve()}"]
+
+    extra_args = case.path / "extra-cmake-args"
+    if extra_args.is_file():
+        cmd += extra_args.read_text().split()
+
+    if POOL:
+        cmd += [
+            f"-DEXTRA_DTC_OVERLAY_FILE={POOL_FILES.with_suffix('.overlay')}",
+            f"-DEXTRA_CONF_FILE={POOL_FILES.with_suffix('.conf')}",
+        ]
+
+    build_dir.mkdir(parents=True, exist_ok=True)
+    with open(build_dir / "build.log", "w") as log:
+        return subprocess.run(cmd, stdout=log, stderr=subprocess.STDOUT).returncode == 0
+
+
+def case_env(case):
+    case.out_dir.mkdir(parents=True, exist_ok=True)
+    env = dict(os.environ)
+    if (case.path / "trace_events.snapshot").is_file():
+        env["ZMK_IPC_TRACE_FILE"] = str((case.out_dir / "ipc_trace.bin").resolve())
+    return env
+
+
+def run(case, build_dir):
+    env = case_env(case)
+    events_file = case.out_dir / "mock_events"
+    events_file.write_text("\n".join(str(event) for event in case.events) + "\n")
+    env["ZMK_KSCAN_MOCK_EVENTS"] = str(events_file.resolve())
+
+    output = subprocess.run(
+        [str(build_dir / "zephyr" / "zmk.exe")], env=env, stdout=subprocess.PIPE
+    ).stdout.decode(errors="replace")
+    return check(case, output)
+
+
+class Instance:
+    """A zmk.exe of a pool build, booted for one test case and waiting for its events."""
+
+    def __init__(self, case, build_dir):
+        self.case = case
+        self.name = f"{os.getpid()}.{next(POOL_INSTANCES)}"
+        env = dict(case_env(case), ZMK_IPC_INSTANCE=self.name)
+        self.log_file = case.out_dir / "zmk.log"
+        with open(self.log_file, "wb") as log:
+            self.process = subprocess.Popen(
+                [str(build_dir / "zephyr" / "zmk.exe")], env=env, stdout=log
+            )
+
+    def connect(self):
+        address = "\0" + POOL_KSCAN_ADDRESS[1:] + "." + self.name
+        deadline = time.monotonic() + POOL_CONNECT_TIMEOUT
+        while True:
+            sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            try:
+                sock.connect(address)
+                return sock
+            except (ConnectionRefusedError, FileNotFoundError):
+                sock.close()
+                if self.process.poll() is not None or time.monotonic() > deadline:
+                    return None
+                time.sleep(0.01)
+
+    def replay(self):
+        """Sends the events of the test case, which the instance exits after, and returns its
+        output."""
+        sock = self.connect()
+        if sock is None:
+            print(f"Unable to connect to the instance of {self.case.name}", flush=True)
+        else:
+            with sock:
+                sock.sendall(replay_frames(self.case.events))
+
+        try:
+            self.process.wait(timeout=POOL_RUN_TIMEOUT)
+        except subprocess.TimeoutExpired:
+            print(f"Killing the instance of {self.case.name}, which didn't exit", flush=True)
+            self.process.kill()
+            self.process.wait()
+
+        return self.log_file.read_bytes().decode(errors="replace")
+
+
+def run_pooled(cases, build_dir):
+    results = []
+    instance = Instance(cases[0], build_dir)
+    for index, case in enumerate(cases):
+        current = instance
+        # The next test case's instance boots while this one replays
+        if index + 1 < len(cases):
+            instance = Instance(cases[index + 1], build_dir)
+        results.append(check(case, current.replay()))
+
+    return all(results)
+
+
+def check(case, output):
+    traced = (case.path / "trace_events.snapshot").is_file()
+    trace_file = case.out_dir / "ipc_trace.bin"
+    full_log = "".join(re.sub(r"^.*> ", "", line) for line in output.splitlines(True))
+    (case.out_dir / "keycode_events_full.log").write_text(full_log)
+
+    # Test cases with a trace_events.snapshot are checked against the IPC observer trace instead
+    # of the log
+    if traced:
+        snapshot = case.path / "trace_events.snapshot"
+        events_log = case.out_dir / "trace_events.log"
+        with open(events_log, "w") as log:
+            subprocess.run([sys.executable, str(DECODE_TRACE), str(trace_file)], stdout=log)
+    else:
+        snapshot = case.path / "keycode_events.snapshot"
+        events_log = case.out_dir / "keycode_events.log"
+        with open(events_log, "w") as log:
+            subprocess.run(
+                ["sed", "-n", "-f", str(case.path / "events.patterns")],
+                input=full_log.encode(),
+                stdout=log,
+            )
+
+    diff = subprocess.run(
+        ["diff", "-auZ", str(snapshot), str(events_log)], stdout=subprocess.PIPE
+    )
+    if diff.returncode == 0:
+        log_result(f"PASS: {case.name}")
+        return True
+
+    sys.stdout.write(diff.stdout.decode(errors="replace"))
+    if (case.path / "pending").exists():
+        log_result(f"PENDING: {case.name}")
+        return True
+
+    if os.environ.get("ZMK_TESTS_AUTO_ACCEPT"):
+        print(f"Auto-accepting failure for {case.name}")
+        snapshot.write_bytes(events_log.read_bytes())
+        log_result(f"PASS: {case.name}")
+        return True
+
+    log_result(f"FAILED: {case.name}")
+    return False
+
+
+def run_group(cases):
+    build_dir = TESTS_DIR / ("pool" if POOL else "shared") / cases[0].build_key[:16]
+    print(f"Running {', '.join(case.name for case in cases)}:", flush=True)
+
+    if not build(cases[0], build_dir):
+        for case in cases:
+            log_result(
+                f"FAILED: {case.name} did not build (see {build_dir / 'build.log'})"
+            )
+        return False
+
+    if POOL:
+        return run_pooled(cases, build_dir)
+
+    return all([run(case, build_dir) for case in cases])
+
+
+def run_standalone(case):
+    return subprocess.run([str(RUN_TEST), str(case.path)]).returncode == 0
+
+
+def main(paths):
+    cases = [TestCase(path) for path in paths]
+
+    groups = {}
+    standalone = []
+    for case in cases:
+        if case.build_key is None:
+            standalone.append(case)
+        else:
+            groups.setdefault(case.build_key, []).append(case)
+
+    with ThreadPoolExecutor(max_workers=int(os.environ.get("J") or 4)) as pool:
+        results = list(pool.map(run_group, groups.values()))
+        results += list(pool.map(run_standalone, standalone))
+
+    return 0 if all(results) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
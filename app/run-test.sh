@@ -10,6 +10,10 @@
 #  ZMK_EXTRA_MODULES:       Path to at most one module (in addition to any in west.yml)
 #  ZMK_TESTS_AUTO_ACCEPT:   Replace snapshot files with new key events
 #  J:                       Number of parallel jobs (default is 4)
+#  ZMK_TESTS_SHARED_BUILDS: Build test cases that only differ in their mock events once, and run
+#                           them with the events read from a file (see run-shared-tests.py)
+#  ZMK_TESTS_POOL:          Like ZMK_TESTS_SHARED_BUILDS, but send the events over kscan IPC in
+#                           virtual time, to instances booted ahead (see run-shared-tests.py)
 
 if [ -z "$1" ]; then
     echo "Usage: ./run-test.sh <path to testcase>"
@@ -28,7 +32,11 @@ testcases=$(find $path -name native_sim.keymap -exec dirname \{\} \;)
 num_cases=$(echo "$testcases" | wc -l)
 if [ $num_cases -gt 1 ] || [ "$testcases" != "$path" ]; then
     echo "" >${ZMK_BUILD_DIR}/tests/pass-fail.log
-    echo "$testcases" | xargs -L 1 -P ${J:-4} ${0}
+    if [ -n "${ZMK_TESTS_SHARED_BUILDS}${ZMK_TESTS_POOL}" ]; then
+        echo "$testcases" | xargs python3 $(dirname ${0})/run-shared-tests.py
+    else
+        echo "$testcases" | xargs -L 1 -P ${J:-4} ${0}
+    fi
     err=$?
     sort -k2 ${ZMK_BUILD_DIR}/tests/pass-fail.log
     exit $err
@@ -60,12 +68,27 @@ if [ $build_exit_code -gt 0 ]; then
     exit 1
 fi
 
-${ZMK_BUILD_DIR}/tests/$testcase/zephyr/zmk.exe |
-    sed -e "s/.*> //" |
-    tee ${ZMK_BUILD_DIR}/tests/$testcase/keycode_events_full.log |
-    sed -n -f $path/events.patterns >${ZMK_BUILD_DIR}/tests/$testcase/keycode_events.log
+# Test cases with a trace_events.snapshot are checked against the IPC observer trace instead of
+# the log
+if [ -f $path/trace_events.snapshot ]; then
+    snapshot=trace_events.snapshot
+    trace_file=${ZMK_BUILD_DIR}/tests/$testcase/ipc_trace.bin
+
+    ZMK_IPC_TRACE_FILE=$trace_file ${ZMK_BUILD_DIR}/tests/$testcase/zephyr/zmk.exe |
+        sed -e "s/.*> //" >${ZMK_BUILD_DIR}/tests/$testcase/keycode_events_full.log
+    python3 $(dirname ${0})/decode-ipc-trace.py $trace_file \
+        >${ZMK_BUILD_DIR}/tests/$testcase/trace_events.log
+else
+    snapshot=keycode_events.snapshot
+
+    ${ZMK_BUILD_DIR}/tests/$testcase/zephyr/zmk.exe |
+        sed -e "s/.*> //" |
+        tee ${ZMK_BUILD_DIR}/tests/$testcase/keycode_events_full.log |
+        sed -n -f $path/events.patterns >${ZMK_BUILD_DIR}/tests/$testcase/keycode_events.log
+fi
+events_log=${ZMK_BUILD_DIR}/tests/$testcase/$(basename $snapshot .snapshot).log
 
-diff -auZ $path/keycode_events.snapshot ${ZMK_BUILD_DIR}/tests/$testcase/keycode_events.log
+diff -auZ $path/$snapshot $events_log
 if [ $? -gt 0 ]; then
     if [ -f $path/pending ]; then
         echo "PENDING: $testcase" | tee -a ${ZMK_BUILD_DIR}/tests/pass-fail.log
@@ -74,7 +97,7 @@ if [ $? -gt 0 ]; then
 
     if [ -n "${ZMK_TESTS_AUTO_ACCEPT}" ]; then
         echo "Auto-accepting failure for $testcase"
-        cp ${ZMK_BUILD_DIR}/tests/$testcase/keycode_events.log $path/keycode_events.snapshot
+        cp $events_log $path/$snapshot
     else
         echo "FAILED: $testcase" | tee -a ${ZMK_BUILD_DIR}/tests/pass-fail.log
         exit 1
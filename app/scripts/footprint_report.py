@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2026 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+
+"""
+Writes a report of the static RAM, thread stack and flash each ZMK subsystem takes, from the
+symbols of the firmware ELF and the source file each one is defined in, plus the largest RAM
+symbols. Peak stack use at runtime isn't static; with CONFIG_ZMK_THREAD_STACK_STATS the IPC
+observer reports it per thread.
+
+Runs after each build (CONFIG_ZMK_FOOTPRINT_REPORT). Symbols are attributed by source path:
+app/src/<dir>/ to zmk/<dir>, other files of app/src/ to zmk/<file>, the kernel and each Zephyr
+subsystem and driver class to its own zephyr/ entry, and each module to its modules/ entry.
+"""
+
+import argparse
+import os
+import subprocess
+
+# nm symbol types: zero-initialised RAM, initialised RAM (with its initial value in flash), and
+# code and constants in flash
+BSS_TYPES = "bB"
+DATA_TYPES = "dD"
+FLASH_TYPES = "tTrR"
+
+TOP_SYMBOLS = 25
+
+
+def read_symbols(nm, elf):
+    """Returns (name, type, size, path) of each sized symbol of the ELF; path is None for
+    symbols without debug line info."""
+    output = subprocess.run(
+        [nm, "--print-size", "--size-sort", "--radix=d", "--line-numbers", elf],
+        check=True,
+        capture_output=True,
+        text=True,
+    ).stdout
+
+    symbols = []
+    for line in output.splitlines():
+        fields, _, location = line.partition("\t")
+        parts = fields.split()
+        if len(parts) != 4:
+            continue
+        _, size, kind, name = parts
+        path = location.rpartition(":")[0] or None
+        symbols.append((name, kind, int(size), path))
+    return symbols
+
+
+def subsystem_of(path, app_dir, zephyr_base, build_dir):
+    if path is None:
+        return "unknown"
+
+    path = os.path.normpath(path)
+
+    def under(base):
+        rel = os.path.relpath(path, base)
+        return None if rel.startswith("..") else rel.split(os.sep)
+
+    parts = under(build_dir)
+    if parts is not None:
+        return "generated"
+
+    parts = under(app_dir)
+    if parts is not None:
+        if parts[0] == "src":
+            return "zmk/" + (parts[1] if len(parts) > 2 else os.path.splitext(parts[1])[0])
+        return "zmk/" + "/".join(parts[: min(3, len(parts) - 1)] or parts)
+
+    parts = under(zephyr_base)
+    if parts is not None:
+        if parts[0] in ("subsys", "drivers") and len(parts) > 2:
+            return "zephyr/" + (parts[1] if parts[0] == "subsys" else "drivers/" + parts[1])
+        return "zephyr/" + parts[0]
+
+    # Modules are checked out next to zephyr/ in the west workspace
+    parts = under(os.path.dirname(zephyr_base))
+    if parts is not None and parts[0] == "modules" and len(parts) > 2:
+        return "/".join(parts[:3] if len(parts) > 3 else parts[:2])
+
+    return "other"
+
+
+class Usage:
+    def __init__(self):
+        self.ram = 0
+        self.stack = 0
+        self.flash = 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--nm", required=True)
+    parser.add_argument("--elf", required=True)
+    parser.add_argument("--app-dir", required=True)
+    parser.add_argument("--zephyr-base", required=True)
+    parser.add_argument("--build-dir", required=True)
+    parser.add_argument("--output", required=True)
+    args = parser.parse_args()
+
+    symbols = read_symbols(args.nm, args.elf)
+    usage = {}
+    ram_symbols = []
+    for name, kind, size, path in symbols:
+        if kind not in BSS_TYPES + DATA_TYPES + FLASH_TYPES:
+            continue
+
+        subsystem = subsystem_of(path, args.app_dir, args.zephyr_base, args.build_dir)
+        entry = usage.setdefault(subsystem, Usage())
+        if kind in FLASH_TYPES:
+            entry.flash += size
+            continue
+
+        # Thread stacks are RAM too, but are reported apart: they're sized by Kconfig options
+        # rather than by the code, and what they hold is only known at runtime
+        if "stack" in name:
+            entry.stack += size
+        else:
+            entry.ram += size
+        if kind in DATA_TYPES:
+            entry.flash += size
+        ram_symbols.append((size, name, subsystem))
+
+    lines = [f"{'subsystem':<32} {'RAM':>8} {'stacks':>8} {'flash':>8}"]
+    total = Usage()
+    for subsystem, entry in sorted(usage.items(), key=lambda u: (-(u[1].ram + u[1].stack), u[0])):
+        lines.append(f"{subsystem:<32} {entry.ram:>8} {entry.stack:>8} {entry.flash:>8}")
+        total.ram += entry.ram
+        total.stack += entry.stack
+        total.flash += entry.flash
+    lines.append(f"{'total':<32} {total.ram:>8} {total.stack:>8} {total.flash:>8}")
+
+    lines += ["", "Largest RAM symbols", "-" * 19]
+    lines.append(f"{'symbol':<48} {'bytes':>8}  subsystem")
+    for size, name, subsystem in sorted(ram_symbols, key=lambda s: (-s[0], s[1]))[:TOP_SYMBOLS]:
+        lines.append(f"{name:<48} {size:>8}  {subsystem}")
+
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,328 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2026 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+
+"""
+Writes a report of the keymap shape that decides how much work a key event can cost: combos per
+key position, &trans chain depth per position, behavior queue entries per macro, and hold-tap
+slot and capture buffer needs. Limits of the build configuration the keymap can exceed are also
+printed as warnings, so they show up before flashing.
+
+Runs at build time (CONFIG_ZMK_KEYMAP_REPORT) on the devicetree the firmware is built from, read
+from the edt.pickle of the build directory, and the .config next to it.
+"""
+
+import argparse
+import os
+import pickle
+import sys
+
+TRANSPARENT = "zmk,behavior-transparent"
+HOLD_TAP = "zmk,behavior-hold-tap"
+MACROS = ("zmk,behavior-macro", "zmk,behavior-macro-one-param", "zmk,behavior-macro-two-param")
+
+# Macro control bindings, which set up the bindings after them rather than being queued
+TAP_MODE = "zmk,macro-control-mode-tap"
+PRESS_MODE = "zmk,macro-control-mode-press"
+RELEASE_MODE = "zmk,macro-control-mode-release"
+PAUSE_FOR_RELEASE = "zmk,macro-pause-for-release"
+MACRO_CONTROLS = (
+    TAP_MODE,
+    PRESS_MODE,
+    RELEASE_MODE,
+    "zmk,macro-control-tap-time",
+    "zmk,macro-control-wait-time",
+    "zmk,macro-param-1to1",
+    "zmk,macro-param-1to2",
+    "zmk,macro-param-2to1",
+    "zmk,macro-param-2to2",
+)
+
+# A hold-tap captures a press and a release per key tapped while it's undecided. Typing above
+# this rate, about 240 WPM, is taken as the fastest burst the capture buffer has to absorb.
+BURST_KEYS_PER_SEC = 20
+
+
+def read_config(path):
+    """Returns the integer and boolean options of a .config as a dictionary."""
+    config = {}
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            name, sep, value = line.strip().partition("=")
+            if not sep or name.startswith("#"):
+                continue
+            if value == "y":
+                config[name] = True
+            elif value.lstrip("-").isdigit():
+                config[name] = int(value)
+    return config
+
+
+def okay_nodes(edt, compat):
+    return edt.compat2okay.get(compat, [])
+
+
+def behaviors(node, prop="bindings"):
+    """Returns the behavior nodes of a phandle-array property, None for empty entries."""
+    if prop not in node.props:
+        return []
+    return [entry.controller if entry is not None else None for entry in node.props[prop].val]
+
+
+def is_compat(node, compats):
+    return node is not None and any(c in compats for c in node.compats)
+
+
+def name_of(node):
+    return node.labels[0] if node.labels else node.name
+
+
+def positions_text(positions, limit=8):
+    text = ", ".join(str(p) for p in positions[:limit])
+    return text + f" and {len(positions) - limit} more" if len(positions) > limit else text
+
+
+class Report:
+    def __init__(self):
+        self.lines = []
+        self.warnings = []
+
+    def section(self, title):
+        if self.lines:
+            self.lines.append("")
+        self.lines += [title, "-" * len(title)]
+
+    def line(self, text=""):
+        self.lines.append(text)
+
+    def warn(self, text):
+        self.warnings.append(text)
+        self.lines.append(f"WARNING: {text}")
+
+
+def keymap_layers(edt):
+    keymaps = okay_nodes(edt, "zmk,keymap")
+    if not keymaps:
+        return []
+    return [layer for layer in keymaps[0].children.values() if layer.status == "okay"]
+
+
+def report_combos(edt, config, layers, keymap_len, report):
+    """Returns the number of combos each position is part of, on the layer where it has most."""
+    per_position = [0] * keymap_len
+    report.section("Combos")
+
+    combos_nodes = okay_nodes(edt, "zmk,combos")
+    combos = [c for n in combos_nodes for c in n.children.values() if c.status == "okay"]
+    if not combos:
+        report.line("no combos")
+        return per_position
+
+    # A combo without layers is active on all of them; the busiest layer sets the worst case
+    per_layer = [[0] * keymap_len for _ in range(max(len(layers), 1))]
+    longest = 0
+    for combo in combos:
+        positions = combo.props["key-positions"].val
+        combo_layers = combo.props["layers"].val if "layers" in combo.props else []
+        longest = max(longest, len(positions))
+        for layer in combo_layers or range(len(per_layer)):
+            if layer >= len(per_layer):
+                continue
+            for position in positions:
+                if position < keymap_len:
+                    per_layer[layer][position] += 1
+
+    for position in range(keymap_len):
+        per_position[position] = max(counts[position] for counts in per_layer)
+
+    busiest = max(per_position)
+    report.line(f"combos: {len(combos)}, longest: {longest} key positions")
+    report.line(
+        f"most combos on one key position: {busiest}, at "
+        + positions_text([p for p, n in enumerate(per_position) if n == busiest])
+    )
+
+    max_positions = config.get("CONFIG_ZMK_COMBO_MAX_KEY_POSITIONS")
+    if max_positions is not None and longest > max_positions:
+        report.warn(
+            f"a combo has {longest} key positions, more than "
+            f"CONFIG_ZMK_COMBO_MAX_KEY_POSITIONS={max_positions}"
+        )
+    return per_position
+
+
+def report_trans_chains(layers, keymap_len, report):
+    """Returns the longest run of &trans bindings each position falls through, from any layer."""
+    depth = [0] * keymap_len
+    report.section("Transparent chains")
+
+    bindings = [behaviors(layer) for layer in layers]
+    for position in range(keymap_len):
+        run = 0
+        # From the default layer up, so each run ends at the layer it starts from
+        for layer in bindings:
+            if position < len(layer) and is_compat(layer[position], (TRANSPARENT,)):
+                run += 1
+            else:
+                run = 0
+            depth[position] = max(depth[position], run)
+
+    deepest = max(depth, default=0)
+    if deepest == 0:
+        report.line("no &trans bindings")
+        return depth
+
+    report.line(
+        f"deepest &trans chain: {deepest} layers, at "
+        + positions_text([p for p, d in enumerate(depth) if d == deepest])
+    )
+    return depth
+
+
+def macro_entries(bindings):
+    """Returns the behavior queue entries the press and the release of a macro take."""
+    halves = [0, 0]
+    half = 0
+    mode = TAP_MODE
+    for behavior in bindings:
+        if is_compat(behavior, (PAUSE_FOR_RELEASE,)) and half == 0:
+            half = 1
+            continue
+        if is_compat(behavior, MACRO_CONTROLS):
+            if is_compat(behavior, (TAP_MODE, PRESS_MODE, RELEASE_MODE)):
+                mode = behavior.compats[0]
+            continue
+        halves[half] += 2 if mode == TAP_MODE else 1
+    return halves
+
+
+def report_macros(edt, config, report):
+    report.section("Macros")
+
+    macros = [m for compat in MACROS for m in okay_nodes(edt, compat)]
+    if not macros:
+        report.line("no macros")
+        return
+
+    queue_size = config.get("CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE")
+    cursors = config.get("CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS", 0)
+    if config.get("CONFIG_ZMK_MACRO_QUEUE_CURSOR") and cursors:
+        report.line(
+            f"CONFIG_ZMK_MACRO_QUEUE_CURSOR: up to {cursors} macros at once take a single "
+            "queue entry, the entries below are for macros queued while no cursor is free"
+        )
+
+    report.line(f"{'macro':<32} {'press':>6} {'release':>8}")
+    largest = 0
+    for macro in sorted(macros, key=name_of):
+        press, release = macro_entries(behaviors(macro))
+        largest = max(largest, press, release)
+        report.line(f"{name_of(macro):<32} {press:>6} {release:>8}")
+
+    if queue_size is not None:
+        report.line(f"CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE={queue_size}")
+        if largest > queue_size:
+            report.warn(
+                f"a macro queues {largest} behaviors at once, more than "
+                f"CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE={queue_size}; the rest are dropped"
+                + (" whenever no queue cursor is free" if cursors else "")
+            )
+
+
+def report_hold_taps(edt, config, layers, keymap_len, report):
+    """Returns the number of layers each position has a hold-tap binding on."""
+    per_position = [0] * keymap_len
+    report.section("Hold-taps")
+
+    hold_taps = okay_nodes(edt, HOLD_TAP)
+    if not hold_taps:
+        report.line("no hold-taps")
+        return per_position
+
+    for layer in layers:
+        for position, behavior in enumerate(behaviors(layer)[:keymap_len]):
+            if is_compat(behavior, (HOLD_TAP,)):
+                per_position[position] += 1
+
+    held = sum(1 for n in per_position if n > 0)
+    longest = max(
+        (ht.props["tapping-term-ms"].val for ht in hold_taps if "tapping-term-ms" in ht.props),
+        default=0,
+    )
+    report.line(f"hold-taps: {len(hold_taps)}, bound at {held} key positions")
+    report.line(f"longest tapping-term-ms: {longest}")
+
+    max_held = config.get("CONFIG_ZMK_BEHAVIOR_HOLD_TAP_MAX_HELD")
+    if max_held is not None:
+        report.line(f"CONFIG_ZMK_BEHAVIOR_HOLD_TAP_MAX_HELD={max_held}")
+        if held > max_held:
+            report.warn(
+                f"{held} key positions have hold-taps that can be held at once, more than "
+                f"CONFIG_ZMK_BEHAVIOR_HOLD_TAP_MAX_HELD={max_held}"
+            )
+
+    captured = config.get("CONFIG_ZMK_BEHAVIOR_HOLD_TAP_MAX_CAPTURED_EVENTS")
+    if captured is not None:
+        needed = 2 * BURST_KEYS_PER_SEC * longest // 1000
+        report.line(
+            f"CONFIG_ZMK_BEHAVIOR_HOLD_TAP_MAX_CAPTURED_EVENTS={captured}, "
+            f"{BURST_KEYS_PER_SEC} keys/s over the longest tapping term capture {needed}"
+        )
+        if needed > captured:
+            report.warn(
+                f"typing {BURST_KEYS_PER_SEC} keys/s while a hold-tap is undecided captures "
+                f"{needed} events, more than "
+                f"CONFIG_ZMK_BEHAVIOR_HOLD_TAP_MAX_CAPTURED_EVENTS={captured}"
+            )
+    return per_position
+
+
+def report_positions(combos, trans, hold_taps, report):
+    report.section("Key positions")
+    report.line(f"{'position':>8} {'combos':>7} {'&trans':>7} {'hold-tap layers':>16}")
+    for position in range(len(combos)):
+        report.line(
+            f"{position:>8} {combos[position]:>7} {trans[position]:>7} "
+            f"{hold_taps[position]:>16}"
+        )
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--edt-pickle", required=True)
+    parser.add_argument("--dotconfig", required=True)
+    parser.add_argument("--zephyr-base", required=True)
+    parser.add_argument("--output", required=True)
+    args = parser.parse_args()
+
+    # The pickle holds edtlib objects, so their module has to be importable to load it
+    devicetree = os.path.join(args.zephyr_base, "scripts", "dts", "python-devicetree", "src")
+    sys.path.insert(0, devicetree)
+    with open(args.edt_pickle, "rb") as f:
+        edt = pickle.load(f)
+    config = read_config(args.dotconfig)
+
+    report = Report()
+    layers = keymap_layers(edt)
+    keymap_len = max((len(behaviors(layer)) for layer in layers), default=0)
+
+    report.line(f"keymap: {len(layers)} layers, {keymap_len} key positions")
+    combos = report_combos(edt, config, layers, keymap_len, report)
+    trans = report_trans_chains(layers, keymap_len, report)
+    report_macros(edt, config, report)
+    hold_taps = report_hold_taps(edt, config, layers, keymap_len, report)
+    if keymap_len:
+        report_positions(combos, trans, hold_taps, report)
+
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write("\n".join(report.lines) + "\n")
+
+    for warning in report.warnings:
+        print(f"warning: keymap report: {warning}", file=sys.stderr)
+    if report.warnings:
+        print(f"keymap report: see {args.output}", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
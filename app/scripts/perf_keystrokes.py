@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2026 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+
+"""
+Splits a perf recording of a CONFIG_ZMK_PROFILING build into one folded stack file per keystroke,
+for flamegraph.pl or any other tool that reads the folded format, plus a summary of the markers
+each keystroke hit.
+
+A keystroke is everything sampled between its keystroke_start and keystroke_end markers, i.e. the
+dispatch of one position event through every listener, behavior and report send it triggers.
+Samples outside of any keystroke are left out. Record with frame pointer call graphs:
+
+    perf probe -x build/zephyr/zmk.exe 'sdt_zmk:*'
+    perf record -e 'sdt_zmk:*' -e cycles:u -c 20000 --call-graph fp -- build/zephyr/zmk.exe
+    perf script | app/scripts/perf_keystrokes.py -o keystrokes/
+
+With --flamegraph, or with flamegraph.pl on the PATH, an SVG is written next to each folded file.
+"""
+
+import argparse
+import collections
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+MARKER_PREFIX = "sdt_zmk:"
+
+HEADER = re.compile(
+    r"^(?P<comm>.+?)\s+(?P<pid>\d+)(?:/\d+)?\s+(?:\[\d+\]\s+)?(?P<time>\d+\.\d+):\s+"
+    r"(?:(?P<period>\d+)\s+)?(?P<event>[\w:.-]+?):(?:\s+|$)(?P<rest>.*)$"
+)
+FRAME = re.compile(r"^\s+[0-9a-f]+\s+(?P<symbol>.+?)(?:\+0x[0-9a-f]+)?\s+\((?P<dso>.*)\)$")
+ARG = re.compile(r"arg(\d+)=(\S+)")
+
+
+class Keystroke:
+    def __init__(self, index, position, pressed, start):
+        self.index = index
+        self.position = position
+        self.pressed = pressed
+        self.start = start
+        self.end = None
+        self.stacks = collections.Counter()
+        self.samples = 0
+        self.markers = collections.Counter()
+
+    @property
+    def name(self):
+        return f"{self.index:04d}-pos{self.position}-{'press' if self.pressed else 'release'}"
+
+
+def read_samples(lines):
+    """Yields (event, time, period, args, frames) for each sample of `perf script` output, with
+    frames from the root of the stack to the leaf."""
+    header = None
+    frames = []
+
+    def sample():
+        args = {int(n): v for n, v in ARG.findall(header.group("rest"))}
+        period = int(header.group("period") or 1)
+        return header.group("event"), float(header.group("time")), period, args, frames[::-1]
+
+    for line in lines:
+        line = line.rstrip("\n")
+        if not line.strip():
+            if header:
+                yield sample()
+            header, frames = None, []
+        elif header is None:
+            header = HEADER.match(line)
+        else:
+            frame = FRAME.match(line)
+            if frame:
+                symbol = frame.group("symbol")
+                if symbol == "[unknown]":
+                    symbol = f"[{os.path.basename(frame.group('dso'))}]"
+                frames.append(symbol)
+
+    if header:
+        yield sample()
+
+
+def split_keystrokes(samples):
+    keystrokes = []
+    current = None
+
+    for event, time, period, args, frames in samples:
+        if not event.startswith(MARKER_PREFIX):
+            if current is not None and frames:
+                current.stacks[";".join(frames)] += period
+                current.samples += 1
+            continue
+
+        marker = event[len(MARKER_PREFIX) :]
+        if marker == "keystroke_start":
+            position = int(args.get(1, "-1"), 0)
+            pressed = int(args.get(2, "0"), 0) != 0
+            current = Keystroke(len(keystrokes), position, pressed, time)
+            keystrokes.append(current)
+        elif marker == "keystroke_end":
+            if current is not None:
+                current.end = time
+            current = None
+        elif current is not None:
+            current.markers[marker] += 1
+
+    return keystrokes
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("input", nargs="?", help="perf script output, stdin if not given")
+    parser.add_argument("-o", "--output", required=True, help="directory to write files to")
+    parser.add_argument("--flamegraph", help="path to flamegraph.pl")
+    parser.add_argument(
+        "--min-samples", type=int, default=1, help="skip keystrokes with fewer samples than this"
+    )
+    args = parser.parse_args()
+
+    with open(args.input, encoding="utf-8") if args.input else sys.stdin as f:
+        keystrokes = split_keystrokes(read_samples(f))
+
+    os.makedirs(args.output, exist_ok=True)
+    flamegraph = args.flamegraph or shutil.which("flamegraph.pl")
+
+    summary = [
+        f"{'keystroke':<24} {'us':>8} {'samples':>8} {'events':>7} {'behaviors':>9} {'reports':>7}"
+    ]
+    for keystroke in keystrokes:
+        duration = (keystroke.end - keystroke.start) * 1e6 if keystroke.end else float("nan")
+        summary.append(
+            f"{keystroke.name:<24} {duration:>8.1f} {keystroke.samples:>8} "
+            f"{keystroke.markers['event_raise']:>7} {keystroke.markers['behavior_invoke']:>9} "
+            f"{keystroke.markers['report_send']:>7}"
+        )
+
+        if keystroke.samples < args.min_samples:
+            continue
+
+        folded = os.path.join(args.output, keystroke.name + ".folded")
+        with open(folded, "w", encoding="utf-8") as f:
+            for stack, count in sorted(keystroke.stacks.items()):
+                f.write(f"{stack} {count}\n")
+
+        if flamegraph:
+            with open(os.path.join(args.output, keystroke.name + ".svg"), "w") as svg:
+                subprocess.run(
+                    [flamegraph, "--title", keystroke.name, folded], stdout=svg, check=True
+                )
+
+    with open(os.path.join(args.output, "keystrokes.txt"), "w", encoding="utf-8") as f:
+        f.write("\n".join(summary) + "\n")
+
+    print(f"{len(keystrokes)} keystrokes written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,216 @@
+# Copyright (c) 2026 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+"""Build matrix command for ZMK."""
+
+import os
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+
+import yaml
+from west import log  # use this for user output
+from west.commands import WestCommand
+
+
+class BuildMatrix(WestCommand):
+    def __init__(self):
+        super().__init__(
+            name="build-matrix",
+            help="build a matrix of ZMK boards and shields",
+            description="""Build every entry of a build matrix, such as core-coverage.yml, in
+parallel. Each entry keeps its own build directory between runs and is only
+rebuilt as far as it changed, and compiler output is shared between entries
+through ccache: objects of the same sources and configuration, such as the
+kernel and ZMK core of boards that share an SoC, are compiled once.""",
+        )
+
+        self.appdir = Path(__file__).resolve().parents[2]
+
+    def do_add_parser(self, parser_adder):
+        parser = parser_adder.add_parser(
+            self.name,
+            help=self.help,
+            description=self.description,
+        )
+
+        parser.add_argument(
+            "matrix",
+            default=str(self.appdir / "core-coverage.yml"),
+            help="The build matrix to build. Defaults to core-coverage.yml.",
+            nargs="?",
+        )
+        parser.add_argument(
+            "-d",
+            "--build-dir",
+            default="build/matrix",
+            help="Directory holding one build directory per entry. Defaults to build/matrix.",
+        )
+        parser.add_argument(
+            "-j",
+            "--jobs",
+            type=int,
+            default=max(1, (os.cpu_count() or 1) // 4),
+            help="Entries to build at once. Defaults to a quarter of the CPUs.",
+        )
+        parser.add_argument(
+            "--shard",
+            default="1/1",
+            help="Only build shard I of N, e.g. 2/4, to split the matrix across machines.",
+        )
+        parser.add_argument(
+            "-p",
+            "--pristine",
+            action="store_true",
+            help="Start every entry from an empty build directory.",
+        )
+        parser.add_argument(
+            "-l",
+            "--list",
+            action="store_true",
+            help="Only list the entries of the shard and their build directories.",
+        )
+        return parser
+
+    def do_run(self, args, unknown_args):
+        with open(args.matrix, "r") as stream:
+            entries = expand_matrix(yaml.safe_load(stream))
+
+        try:
+            index, count = (int(n) for n in args.shard.split("/"))
+            if not 1 <= index <= count:
+                raise ValueError
+        except ValueError:
+            log.die(f"invalid shard {args.shard}, expected I/N with 1 <= I <= N")
+
+        socs = board_socs(
+            [
+                self.appdir / "boards",
+                self.appdir / "module" / "boards",
+                Path(self.topdir) / "zephyr" / "boards",
+            ]
+        )
+        entries = shard(entries, index, count, lambda board: socs.get(board_name(board), board))
+        build_root = Path(args.build_dir).resolve()
+
+        if args.list:
+            for entry in entries:
+                log.inf(f"{entry_name(entry):<48} {build_root / entry_name(entry)}")
+            return
+
+        if shutil.which("ccache") is None:
+            log.wrn("ccache not found, every entry compiles all of its sources")
+
+        env = dict(os.environ)
+        # Paths below the workspace are hashed relative to it, so the same source compiled for
+        # different build directories hits the same cache entry
+        env.setdefault("CCACHE_BASEDIR", str(Path(self.topdir).resolve()))
+        env.setdefault("CCACHE_NOHASHDIR", "1")
+
+        ninja_jobs = max(1, (os.cpu_count() or 1) // max(1, args.jobs))
+        start = time.monotonic()
+
+        def build(entry):
+            return entry, run_build(
+                entry, build_root / entry_name(entry), self.appdir, args.pristine, ninja_jobs, env
+            )
+
+        failed = []
+        with ThreadPoolExecutor(max_workers=max(1, args.jobs)) as pool:
+            for entry, (ok, seconds, log_path) in pool.map(build, entries):
+                if ok:
+                    log.inf(f"ok     {entry_name(entry):<48} {seconds:6.1f} s")
+                else:
+                    log.err(f"FAILED {entry_name(entry):<48} {seconds:6.1f} s, see {log_path}")
+                    failed.append(entry)
+
+        log.inf(
+            f"{len(entries) - len(failed)} of {len(entries)} entries built "
+            f"in {time.monotonic() - start:.1f} s"
+        )
+        sys.exit(1 if failed else 0)
+
+
+def expand_matrix(matrix):
+    """Expands a matrix the way the Build workflow does: every board with every shield, plus
+    the entries of its include list."""
+    entries = [
+        {"board": board, "shield": shield}
+        for board in matrix.get("board", [])
+        for shield in matrix.get("shield", [])
+    ]
+    return entries + list(matrix.get("include", []))
+
+
+def entry_name(entry):
+    """Names an entry like the Build workflow names its artifact, without the -zmk suffix."""
+    name = entry["board"]
+    if entry.get("shield"):
+        name += "-" + entry["shield"]
+    if entry.get("cmake-args"):
+        name += "-" + (entry.get("nickname") or "".join(entry["cmake-args"].split(" ")))
+    return re.sub(r"[^A-Za-z0-9_.=-]", "_", name)
+
+
+def board_name(board):
+    """Returns the name of a board target without its qualifiers, e.g. nice_nano for
+    nice_nano//zmk."""
+    return board.split("/")[0]
+
+
+def board_socs(dirs):
+    """Maps the names of the boards defined in the board.yml files below dirs to their SoC."""
+    socs = {}
+    for path in (p for d in dirs if d.is_dir() for p in d.glob("**/board.yml")):
+        with open(path, "r") as stream:
+            data = yaml.safe_load(stream) or {}
+        for board in [data["board"]] if "board" in data else data.get("boards", []):
+            if board.get("socs"):
+                socs.setdefault(board["name"], board["socs"][0]["name"])
+    return socs
+
+
+def shard(entries, index, count, group_of):
+    """Deals entries out to shards in groups of the same SoC, so that the entries of a group
+    share their ccache on the machine building them."""
+    sizes = {}
+    for entry in entries:
+        group = group_of(entry["board"])
+        sizes[group] = sizes.get(group, 0) + 1
+
+    # Largest groups first, each to the shard with the fewest entries so far
+    shard_sizes = [0] * count
+    owner = {}
+    for group in sorted(sizes, key=lambda g: (-sizes[g], g)):
+        smallest = shard_sizes.index(min(shard_sizes))
+        owner[group] = smallest
+        shard_sizes[smallest] += sizes[group]
+    return [entry for entry in entries if owner[group_of(entry["board"])] == index - 1]
+
+
+def run_build(entry, build_dir, appdir, pristine, ninja_jobs, env):
+    cmd = ["west", "build", "-s", str(appdir), "-d", str(build_dir), "-b", entry["board"]]
+    cmd += ["-p", "always" if pristine else "auto", "-o", f"-j{ninja_jobs}"]
+    if entry.get("snippet"):
+        cmd += ["-S", entry["snippet"]]
+
+    cmake_args = []
+    if entry.get("shield"):
+        cmake_args.append(f"-DSHIELD={entry['shield']}")
+    cmake_args += shlex.split(entry.get("cmake-args", ""))
+    if cmake_args:
+        cmd += ["--"] + cmake_args
+
+    build_dir.parent.mkdir(parents=True, exist_ok=True)
+    log_path = build_dir.with_name(build_dir.name + ".log")
+    start = time.monotonic()
+    with open(log_path, "w") as output:
+        output.write(shlex.join(cmd) + "\n")
+        output.flush()
+        completed = subprocess.run(cmd, stdout=output, stderr=subprocess.STDOUT, env=env)
+
+    return completed.returncode == 0, time.monotonic() - start, log_path
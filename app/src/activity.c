@@ -19,11 +19,13 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/sensor_event.h>
 
 #include <zmk/pm.h>
+#include <zmk/settings.h>
 
 #include <zmk/activity.h>
 
 #if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
 #include <zmk/usb.h>
+#include <zmk/events/usb_conn_state_changed.h>
 #endif
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
@@ -40,7 +42,8 @@ bool is_usb_power_present(void) {
 
 static enum zmk_activity_state activity_state;
 
-static uint32_t activity_last_uptime;
+// Written from whichever thread reports activity, only read by the activity work.
+static atomic_t activity_last_uptime;
 
 #define MAX_IDLE_MS CONFIG_ZMK_IDLE_TIMEOUT
 
@@ -63,22 +66,29 @@ int set_state(enum zmk_activity_state state) {
 
 enum zmk_activity_state zmk_activity_get_state(void) { return activity_state; }
 
-static int note_activity(void) {
-    activity_last_uptime = k_uptime_get();
-
-    return set_state(ZMK_ACTIVITY_ACTIVE);
-}
+// The work only runs at the next idle or sleep deadline. Activity just moves the timestamp, and
+// the work pushes its deadline back when it finds the keyboard was used in the meantime.
+static void activity_work_handler(struct k_work *work);
 
-static int activity_event_listener(const zmk_event_t *eh) { return note_activity(); }
+K_WORK_DELAYABLE_DEFINE(activity_work, activity_work_handler);
 
-void activity_work_handler(struct k_work *work) {
-    int32_t current = k_uptime_get();
-    int32_t inactive_time = current - activity_last_uptime;
+static void activity_work_handler(struct k_work *work) {
+    int32_t inactive_time = k_uptime_get_32() - (uint32_t)atomic_get(&activity_last_uptime);
 #if IS_ENABLED(CONFIG_ZMK_SLEEP)
-    if (inactive_time > MAX_SLEEP_MS && !is_usb_power_present()) {
+    if (inactive_time >= MAX_SLEEP_MS) {
+        if (is_usb_power_present()) {
+            // Checked again once USB power goes away
+            set_state(ZMK_ACTIVITY_IDLE);
+            return;
+        }
+
         // Put devices in suspend power mode before sleeping
         set_state(ZMK_ACTIVITY_SLEEP);
 
+#if IS_ENABLED(CONFIG_SETTINGS)
+        zmk_settings_flush();
+#endif
+
         if (zmk_pm_suspend_devices() < 0) {
             LOG_ERR("Failed to suspend all the devices");
             zmk_pm_resume_devices();
@@ -86,29 +96,60 @@ void activity_work_handler(struct k_work *work) {
         }
 
         sys_poweroff();
-    } else
+        return;
+    }
 #endif /* IS_ENABLED(CONFIG_ZMK_SLEEP) */
-        if (inactive_time > MAX_IDLE_MS) {
-            set_state(ZMK_ACTIVITY_IDLE);
-        }
+
+    if (inactive_time >= MAX_IDLE_MS) {
+        set_state(ZMK_ACTIVITY_IDLE);
+#if IS_ENABLED(CONFIG_ZMK_SLEEP)
+        k_work_schedule(&activity_work, K_MSEC(MAX_SLEEP_MS - inactive_time));
+#endif
+        return;
+    }
+
+    k_work_schedule(&activity_work, K_MSEC(MAX_IDLE_MS - inactive_time));
 }
 
-K_WORK_DEFINE(activity_work, activity_work_handler);
+static int note_activity(void) {
+    atomic_set(&activity_last_uptime, k_uptime_get_32());
+
+    if (activity_state == ZMK_ACTIVITY_ACTIVE) {
+        return 0;
+    }
+
+    // Replaces the pending sleep deadline
+    k_work_reschedule(&activity_work, K_MSEC(MAX_IDLE_MS));
+    return set_state(ZMK_ACTIVITY_ACTIVE);
+}
 
-void activity_expiry_function(struct k_timer *_timer) { k_work_submit(&activity_work); }
+static int activity_event_listener(const zmk_event_t *eh) {
+#if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+    if (as_zmk_usb_conn_state_changed(eh)) {
+        // Losing USB power may let an idle keyboard go to sleep right away
+        if (activity_state == ZMK_ACTIVITY_IDLE) {
+            k_work_reschedule(&activity_work, K_NO_WAIT);
+        }
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+#endif
 
-K_TIMER_DEFINE(activity_timer, activity_expiry_function, NULL);
+    return note_activity();
+}
 
 static int activity_init(void) {
-    activity_last_uptime = k_uptime_get();
+    atomic_set(&activity_last_uptime, k_uptime_get_32());
 
-    k_timer_start(&activity_timer, K_SECONDS(1), K_SECONDS(1));
+    k_work_schedule(&activity_work, K_MSEC(MAX_IDLE_MS));
     return 0;
 }
 
 ZMK_LISTENER(activity, activity_event_listener);
 ZMK_SUBSCRIPTION(activity, zmk_position_state_changed);
 ZMK_SUBSCRIPTION(activity, zmk_sensor_event);
+#if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+ZMK_SUBSCRIPTION(activity, zmk_usb_conn_state_changed);
+#endif
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 
@@ -116,8 +157,14 @@ static void note_activity_work_cb(struct k_work *_work) { note_activity(); }
 
 K_WORK_DEFINE(note_activity_work, note_activity_work_cb);
 
+// Runs on the input thread for every input event, so only leaves the system work queue to handle
+// the rare wake up from idle.
 static void activity_input_listener(struct input_event *ev, void *user_data) {
-    k_work_submit(&note_activity_work);
+    atomic_set(&activity_last_uptime, k_uptime_get_32());
+
+    if (activity_state != ZMK_ACTIVITY_ACTIVE) {
+        k_work_submit(&note_activity_work);
+    }
 }
 
 INPUT_CALLBACK_DEFINE(NULL, activity_input_listener, NULL);
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/init.h>
+#include <zephyr/pm/device_runtime.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/activity.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+
+// Every device listed here holds one runtime PM usage count while the keyboard is active. Other
+// users, like the kscan held by the active physical layout, keep their own counts, so a device
+// only suspends once nobody needs it, without waiting for the whole keyboard to sleep.
+
+#define DEVICE_WITH_SEP(node_id, prop, idx) DEVICE_DT_GET(DT_PROP_BY_IDX(node_id, prop, idx)),
+
+static const struct device *const activity_pm_devices[] = {
+    DT_FOREACH_PROP_ELEM(DT_INST(0, zmk_activity_pm_devices), devices, DEVICE_WITH_SEP)};
+
+static bool held;
+
+static void activity_pm_hold(bool hold) {
+    if (held == hold) {
+        return;
+    }
+
+    held = hold;
+    for (int i = 0; i < ARRAY_SIZE(activity_pm_devices); i++) {
+        const struct device *dev = activity_pm_devices[i];
+        int err = hold ? pm_device_runtime_get(dev) : pm_device_runtime_put(dev);
+        if (err < 0) {
+            LOG_WRN("Failed to %s %s (%d)", hold ? "resume" : "release", dev->name, err);
+        }
+    }
+}
+
+static int activity_pm_listener(const zmk_event_t *eh) {
+    activity_pm_hold(zmk_activity_get_state() == ZMK_ACTIVITY_ACTIVE);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(activity_pm, activity_pm_listener);
+ZMK_SUBSCRIPTION(activity_pm, zmk_activity_state_changed);
+
+static int activity_pm_init(void) {
+    for (int i = 0; i < ARRAY_SIZE(activity_pm_devices); i++) {
+        if (!pm_device_runtime_is_enabled(activity_pm_devices[i])) {
+            LOG_WRN("Runtime PM is not enabled for %s", activity_pm_devices[i]->name);
+        }
+    }
+
+    // The keyboard starts out active.
+    activity_pm_hold(true);
+    return 0;
+}
+
+SYS_INIT(activity_pm_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -13,8 +13,11 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/settings/settings.h>
 
+#include <string.h>
+
 #include <zmk/activity.h>
 #include <zmk/backlight.h>
+#include <zmk/settings.h>
 #include <zmk/usb.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/activity_state_changed.h>
@@ -42,10 +45,26 @@ struct backlight_state {
 static struct backlight_state state = {.brightness = CONFIG_ZMK_BACKLIGHT_BRT_START,
                                        .on = IS_ENABLED(CONFIG_ZMK_BACKLIGHT_ON_START)};
 
-static int zmk_backlight_update(void) {
-    uint8_t brt = zmk_backlight_get_brt();
-    LOG_DBG("Update backlight brightness: %d%%", brt);
+// The brightness the LEDs were last set to, so unchanged values aren't written again
+static uint8_t written_brt;
+static bool written_brt_valid;
 
+#if IS_ENABLED(CONFIG_ZMK_BACKLIGHT_WRITE_CHANNELS)
+
+static int write_brt(uint8_t brt) {
+    uint8_t channels[BACKLIGHT_NUM_LEDS];
+    memset(channels, brt, sizeof(channels));
+
+    int rc = led_write_channels(backlight_dev, 0, BACKLIGHT_NUM_LEDS, channels);
+    if (rc != 0) {
+        LOG_ERR("Failed to update backlight LEDs: %d", rc);
+    }
+    return rc;
+}
+
+#else
+
+static int write_brt(uint8_t brt) {
     for (int i = 0; i < BACKLIGHT_NUM_LEDS; i++) {
         int rc = led_set_brightness(backlight_dev, i, brt);
         if (rc != 0) {
@@ -56,6 +75,76 @@ static int zmk_backlight_update(void) {
     return 0;
 }
 
+#endif // IS_ENABLED(CONFIG_ZMK_BACKLIGHT_WRITE_CHANNELS)
+
+static int set_brt(uint8_t brt) {
+    if (written_brt_valid && written_brt == brt) {
+        return 0;
+    }
+
+    int rc = write_brt(brt);
+    written_brt = brt;
+    written_brt_valid = (rc == 0);
+    return rc;
+}
+
+#if CONFIG_ZMK_BACKLIGHT_FADE_MS > 0
+
+// Moves the brightness one percent per step, so a fade across the whole range takes
+// CONFIG_ZMK_BACKLIGHT_FADE_MS, and shorter ones take less.
+#define FADE_STEP_MS MAX(1, CONFIG_ZMK_BACKLIGHT_FADE_MS / BRT_MAX)
+
+static void backlight_fade_work_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(backlight_fade_work, backlight_fade_work_handler);
+
+// Always steps toward the current target, so a change during a fade carries on from where it is
+static void backlight_fade_work_handler(struct k_work *work) {
+    uint8_t target = zmk_backlight_get_brt();
+    if (!written_brt_valid) {
+        int rc = set_brt(target);
+        if (rc != 0) {
+            LOG_ERR("Failed to set backlight to %d%% after a failed fade: %d", target, rc);
+        }
+        return;
+    }
+
+    if (written_brt == target) {
+        return;
+    }
+
+    uint8_t prev = written_brt;
+    uint8_t next = prev < target ? prev + 1 : prev - 1;
+    int rc = set_brt(next);
+    if (rc != 0) {
+        // The next update writes the target directly, as the LEDs' brightness is now unknown
+        LOG_ERR("Backlight fade to %d%% stopped at %d%%: %d", target, prev, rc);
+        return;
+    }
+
+    if (next != target) {
+        k_work_schedule(&backlight_fade_work, K_MSEC(FADE_STEP_MS));
+    }
+}
+
+#endif // CONFIG_ZMK_BACKLIGHT_FADE_MS > 0
+
+static int zmk_backlight_update(void) {
+    uint8_t brt = zmk_backlight_get_brt();
+    LOG_DBG("Update backlight brightness: %d%%", brt);
+
+#if CONFIG_ZMK_BACKLIGHT_FADE_MS > 0
+    // The first write isn't faded, as the LEDs may be at any brightness until then
+    if (written_brt_valid) {
+        // Doesn't delay a step already scheduled
+        k_work_schedule(&backlight_fade_work, K_NO_WAIT);
+        return 0;
+    }
+#endif
+
+    return set_brt(brt);
+}
+
 #if IS_ENABLED(CONFIG_SETTINGS)
 static int backlight_settings_load_cb(const char *name, size_t len, settings_read_cb read_cb,
                                       void *cb_arg) {
@@ -77,12 +166,6 @@ static int backlight_settings_load_cb(const char *name, size_t len, settings_rea
 
 SETTINGS_STATIC_HANDLER_DEFINE(backlight, "backlight", NULL, backlight_settings_load_cb, NULL,
                                NULL);
-
-static void backlight_save_work_handler(struct k_work *work) {
-    settings_save_one("backlight/state", &state, sizeof(state));
-}
-
-static struct k_work_delayable backlight_save_work;
 #endif
 
 static int zmk_backlight_init(void) {
@@ -90,10 +173,6 @@ static int zmk_backlight_init(void) {
         LOG_ERR("Backlight device \"%s\" is not ready", backlight_dev->name);
         return -ENODEV;
     }
-
-#if IS_ENABLED(CONFIG_SETTINGS)
-    k_work_init_delayable(&backlight_save_work, backlight_save_work_handler);
-#endif
 #if IS_ENABLED(CONFIG_ZMK_BACKLIGHT_AUTO_OFF_USB)
     state.on = zmk_usb_is_powered();
 #endif
@@ -107,8 +186,7 @@ static int zmk_backlight_update_and_save(void) {
     }
 
 #if IS_ENABLED(CONFIG_SETTINGS)
-    int ret = k_work_reschedule(&backlight_save_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
-    return MIN(ret, 0);
+    return zmk_settings_save("backlight/state", &state, sizeof(state));
 #else
     return 0;
 #endif
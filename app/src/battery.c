@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <stdlib.h>
+
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/init.h>
@@ -23,6 +25,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/workqueue.h>
 
 static uint8_t last_state_of_charge = 0;
+static bool state_of_charge_reported;
 
 uint8_t zmk_battery_state_of_charge(void) { return last_state_of_charge; }
 
@@ -50,6 +53,40 @@ static uint8_t lithium_ion_mv_to_pct(int16_t bat_mv) {
 
 #endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING_FETCH_MODE_LITHIUM_VOLTAGE)
 
+// Filtered state of charge in 1/256 percent, negative until the first sample
+static int32_t filtered_state_of_charge = -1;
+
+static uint8_t filter_state_of_charge(int32_t sample) {
+    sample = CLAMP(sample, 0, 100) << 8;
+
+    if (filtered_state_of_charge < 0) {
+        filtered_state_of_charge = sample;
+    } else {
+        filtered_state_of_charge +=
+            (sample - filtered_state_of_charge) / (1 << CONFIG_ZMK_BATTERY_FILTER_SHIFT);
+    }
+
+    return (filtered_state_of_charge + 128) >> 8;
+}
+
+static bool should_report_state_of_charge(uint8_t state_of_charge) {
+    if (!state_of_charge_reported) {
+        return true;
+    }
+
+    if (state_of_charge == last_state_of_charge) {
+        return false;
+    }
+
+    // Full and empty are always reported, however small the change
+    if (state_of_charge == 0 || state_of_charge == 100) {
+        return true;
+    }
+
+    return abs(state_of_charge - last_state_of_charge) >= CONFIG_ZMK_BATTERY_REPORT_HYSTERESIS;
+}
+
+// Returns 1 if the reported level changed, 0 if it didn't, or a negative error code
 static int zmk_battery_update(const struct device *battery) {
     struct sensor_value state_of_charge;
     int rc;
@@ -91,16 +128,23 @@ static int zmk_battery_update(const struct device *battery) {
 #error "Not a supported reporting fetch mode"
 #endif
 
-    if (last_state_of_charge != state_of_charge.val1) {
-        last_state_of_charge = state_of_charge.val1;
+    uint8_t filtered = filter_state_of_charge(state_of_charge.val1);
+    bool changed = should_report_state_of_charge(filtered);
+
+    if (changed) {
+        last_state_of_charge = filtered;
 
         rc = raise_zmk_battery_state_changed(
             (struct zmk_battery_state_changed){.state_of_charge = last_state_of_charge});
 
-        if (rc != 0) {
+        if (rc < 0) {
             LOG_ERR("Failed to raise battery state changed event: %d", rc);
+            // Report the next sample whatever its level, so the change isn't lost
+            state_of_charge_reported = false;
             return rc;
         }
+
+        state_of_charge_reported = true;
     }
 
 #if IS_ENABLED(CONFIG_BT_BAS)
@@ -116,28 +160,41 @@ static int zmk_battery_update(const struct device *battery) {
     }
 #endif
 
-    return rc;
+    return changed ? 1 : 0;
 }
 
+#define BATTERY_INTERVAL_MIN_S CONFIG_ZMK_BATTERY_REPORT_INTERVAL
+#define BATTERY_INTERVAL_MAX_S                                                                     \
+    MAX(CONFIG_ZMK_BATTERY_REPORT_INTERVAL, CONFIG_ZMK_BATTERY_REPORT_INTERVAL_MAX)
+
+static uint32_t battery_interval_s = BATTERY_INTERVAL_MIN_S;
+
+static void zmk_battery_work(struct k_work *work);
+
+K_WORK_DELAYABLE_DEFINE(battery_work, zmk_battery_work);
+
 static void zmk_battery_work(struct k_work *work) {
     int rc = zmk_battery_update(battery);
 
-    if (rc != 0) {
+    if (rc < 0) {
         LOG_DBG("Failed to update battery value: %d.", rc);
+    } else if (rc > 0) {
+        battery_interval_s = BATTERY_INTERVAL_MIN_S;
+    } else {
+        battery_interval_s = MIN(battery_interval_s * 2, BATTERY_INTERVAL_MAX_S);
     }
-}
 
-K_WORK_DEFINE(battery_work, zmk_battery_work);
-
-static void zmk_battery_timer(struct k_timer *timer) {
-    k_work_submit_to_queue(zmk_workqueue_lowprio_work_q(), &battery_work);
+    // Sampling stops while idle, and restarts when the keyboard is active again
+    if (zmk_activity_get_state() == ZMK_ACTIVITY_ACTIVE) {
+        k_work_schedule_for_queue(zmk_workqueue_lowprio_work_q(), &battery_work,
+                                  K_SECONDS(battery_interval_s));
+    }
 }
 
-K_TIMER_DEFINE(battery_timer, zmk_battery_timer, NULL);
-
-static void zmk_battery_start_reporting() {
+static void zmk_battery_start_reporting(k_timeout_t delay) {
     if (device_is_ready(battery)) {
-        k_timer_start(&battery_timer, K_NO_WAIT, K_SECONDS(CONFIG_ZMK_BATTERY_REPORT_INTERVAL));
+        battery_interval_s = BATTERY_INTERVAL_MIN_S;
+        k_work_reschedule_for_queue(zmk_workqueue_lowprio_work_q(), &battery_work, delay);
     }
 }
 
@@ -157,7 +214,11 @@ static int zmk_battery_init(void) {
         return -ENODEV;
     }
 
-    zmk_battery_start_reporting();
+#if IS_ENABLED(CONFIG_ZMK_BOOT_INPUT_FIRST)
+    zmk_battery_start_reporting(K_MSEC(CONFIG_ZMK_BOOT_DEFERRED_START_MS));
+#else
+    zmk_battery_start_reporting(K_NO_WAIT);
+#endif
     return 0;
 }
 
@@ -166,11 +227,11 @@ static int battery_event_listener(const zmk_event_t *eh) {
     if (as_zmk_activity_state_changed(eh)) {
         switch (zmk_activity_get_state()) {
         case ZMK_ACTIVITY_ACTIVE:
-            zmk_battery_start_reporting();
+            zmk_battery_start_reporting(K_NO_WAIT);
             return 0;
         case ZMK_ACTIVITY_IDLE:
         case ZMK_ACTIVITY_SLEEP:
-            k_timer_stop(&battery_timer);
+            k_work_cancel_delayable(&battery_work);
             return 0;
         default:
             break;
@@ -25,6 +25,9 @@
 #include <zmk/behavior.h>
 #include <zmk/hid.h>
 #include <zmk/matrix.h>
+#include <zmk/settings.h>
+#include <zmk/profiling.h>
+#include <zmk/stage_timing.h>
 
 #include <zmk/events/position_state_changed.h>
 
@@ -55,6 +58,14 @@ const struct device *z_impl_behavior_get_binding(const char *name) {
     return NULL;
 }
 
+const struct device *zmk_behavior_binding_get_device(const struct zmk_behavior_binding *binding) {
+    if (binding->device != NULL) {
+        return binding->device;
+    }
+
+    return zmk_behavior_get_binding(binding->behavior_dev);
+}
+
 static int invoke_locally(struct zmk_behavior_binding *binding,
                           struct zmk_behavior_binding_event event, bool pressed) {
     if (pressed) {
@@ -64,19 +75,51 @@ static int invoke_locally(struct zmk_behavior_binding *binding,
     }
 }
 
-int zmk_behavior_invoke_binding(const struct zmk_behavior_binding *src_binding,
-                                struct zmk_behavior_binding_event event, bool pressed) {
+// Whether a behavior of the given locality only runs on this device for the event.
+static bool runs_only_locally(enum behavior_locality locality,
+                              const struct zmk_behavior_binding_event *event) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT) && IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+    switch (locality) {
+    case BEHAVIOR_LOCALITY_CENTRAL:
+        return true;
+    case BEHAVIOR_LOCALITY_EVENT_SOURCE:
+        return event->source == ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL;
+    default:
+        return false;
+    }
+#else
+    return true;
+#endif
+}
+
+static int invoke_binding(const struct zmk_behavior_binding *src_binding,
+                          struct zmk_behavior_binding_event event, bool pressed) {
     // We want to make a copy of this, since it may be converted from
     // relative to absolute before being invoked
     struct zmk_behavior_binding binding = *src_binding;
 
-    const struct device *behavior = zmk_behavior_get_binding(binding.behavior_dev);
+    const struct device *behavior = zmk_behavior_binding_get_device(&binding);
 
     if (!behavior) {
         LOG_WRN("No behavior assigned to %d on layer %d", event.position, event.layer);
         return 1;
     }
 
+    // Resolve once for the driver calls below.
+    binding.device = behavior;
+    ZMK_PROFILING_MARK3(behavior_invoke, behavior->name, event.position, pressed);
+
+    // Most behaviors keep their parameters as bound and run right here, so they go straight to
+    // their handler.
+    const struct behavior_driver_api *api = (const struct behavior_driver_api *)behavior->api;
+    if (api->binding_convert_central_state_dependent_params == NULL &&
+        runs_only_locally(api->locality, &event)) {
+        behavior_keymap_binding_callback_t handler =
+            pressed ? api->binding_pressed : api->binding_released;
+
+        return handler ? handler(&binding, event) : -ENOTSUP;
+    }
+
     int err = behavior_keymap_binding_convert_central_state_dependent_params(&binding, event);
     if (err) {
         LOG_ERR("Failed to convert relative to absolute behavior binding (err %d)", err);
@@ -115,6 +158,15 @@ int zmk_behavior_invoke_binding(const struct zmk_behavior_binding *src_binding,
     return -ENOTSUP;
 }
 
+int zmk_behavior_invoke_binding(const struct zmk_behavior_binding *src_binding,
+                                struct zmk_behavior_binding_event event, bool pressed) {
+    uint32_t start = zmk_stage_timing_start();
+    int ret = invoke_binding(src_binding, event, pressed);
+
+    zmk_stage_timing_end(ZMK_STAGE_BEHAVIOR, start);
+    return ret;
+}
+
 #if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
 
 int zmk_behavior_get_empty_param_metadata(const struct device *dev,
@@ -239,7 +291,7 @@ int zmk_behavior_check_params_match_metadata(const struct behavior_parameter_met
 
 int zmk_behavior_validate_binding(const struct zmk_behavior_binding *binding) {
 #if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
-    const struct device *behavior = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *behavior = zmk_behavior_binding_get_device(binding);
 
     if (!behavior) {
         return -ENODEV;
@@ -361,7 +413,7 @@ static int behavior_handle_commit(void) {
         char device_name[32];
         snprintf(device_name, ARRAY_SIZE(device_name), "%s", item->device->name);
 
-        settings_save_one(setting_name, device_name, strlen(device_name));
+        zmk_settings_save(setting_name, device_name, strlen(device_name));
     }
 
     return 0;
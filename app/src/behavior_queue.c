@@ -6,32 +6,158 @@
 
 #include <zmk/behavior_queue.h>
 #include <zmk/behavior.h>
+#include <zmk/context.h>
+#include <zmk/fuzz.h>
+#include <zmk/work_stats.h>
+#include <zmk/workqueue.h>
 
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <drivers/behavior.h>
 
-LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+LOG_MODULE_REGISTER(zmk_behavior_queue, CONFIG_ZMK_LOG_LEVEL);
 
 struct q_item {
     uint32_t position;
 #if IS_ENABLED(CONFIG_ZMK_SPLIT)
     uint8_t source;
+#endif
+#if ZMK_CONTEXT_COUNT > 1
+    // the context the item was queued in, which it's invoked in however long it waits
+    uint8_t context;
 #endif
     struct zmk_behavior_binding binding;
     bool press : 1;
     uint32_t wait : 31;
+    // taps still to invoke for an item added with zmk_behavior_queue_add_taps(), or zero
+    uint16_t taps;
+#if CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS > 0
+    // index plus one of the cursor this item stands for, or zero for a plain binding
+    uint8_t cursor;
+#endif
+};
+
+// Each queue works through its own items, and waits, independently of the others. Items are
+// spread over the queues by key position, so the items of one position always stay in order.
+struct behavior_queue {
+    struct k_msgq msgq;
+    struct k_work_delayable work;
+    // The taps item the queue is currently working through. Its press flag tells which half of
+    // the next tap comes next, and its wait is how long each press is held.
+    struct q_item current_taps_item;
+#if CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS > 0
+    // The cursor the queue is currently working through, and the item that queued it.
+    struct q_item current_cursor_item;
+#endif
 };
 
-K_MSGQ_DEFINE(zmk_behavior_queue_msgq, sizeof(struct q_item), CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE, 4);
+static struct behavior_queue queues[CONFIG_ZMK_BEHAVIORS_QUEUE_COUNT];
+static char __aligned(4) queue_buffers[CONFIG_ZMK_BEHAVIORS_QUEUE_COUNT]
+                                      [CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE * sizeof(struct q_item)];
 
-static void behavior_queue_process_next(struct k_work *work);
-static K_WORK_DELAYABLE_DEFINE(queue_work, behavior_queue_process_next);
+// One set of counters for all queues, whose high-water mark is that of the fullest queue
+ZMK_WORK_STATS_DEFINE(behavior_queue, CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE);
 
-static void behavior_queue_process_next(struct k_work *work) {
+#if CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS > 0
+
+BUILD_ASSERT(CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS <= 32, "At most 32 queue cursors are supported");
+
+struct queue_cursor {
+    zmk_behavior_queue_cursor_next_t next;
+    uint8_t state[ZMK_BEHAVIOR_QUEUE_CURSOR_STATE_SIZE] __aligned(8);
+};
+
+static struct queue_cursor cursors[CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS];
+static atomic_t cursors_in_use;
+
+static bool behavior_queue_next_cursor_step(struct behavior_queue *queue, struct q_item *item) {
+    if (!queue->current_cursor_item.cursor) {
+        return false;
+    }
+
+    int idx = queue->current_cursor_item.cursor - 1;
+    struct zmk_behavior_queue_step step;
+
+    if (cursors[idx].next(cursors[idx].state, &step)) {
+        *item = queue->current_cursor_item;
+        item->cursor = 0;
+        item->binding = step.binding;
+        item->press = step.press;
+        item->wait = step.wait;
+        return true;
+    }
+
+    queue->current_cursor_item.cursor = 0;
+    atomic_clear_bit(&cursors_in_use, idx);
+    return false;
+}
+
+#endif // CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS > 0
+
+static bool behavior_queue_next_tap(struct behavior_queue *queue, struct q_item *item) {
+    struct q_item *taps_item = &queue->current_taps_item;
+
+    if (!taps_item->taps) {
+        return false;
+    }
+
+    *item = *taps_item;
+    item->taps = 0;
+
+    if (taps_item->press) {
+        taps_item->press = false;
+    } else {
+        item->wait = 0;
+        taps_item->press = true;
+        taps_item->taps--;
+    }
+
+    return true;
+}
+
+// Get the next item to invoke, expanding the current taps item or cursor first if there is one.
+static int behavior_queue_get(struct behavior_queue *queue, struct q_item *item) {
+    while (true) {
+        if (behavior_queue_next_tap(queue, item)) {
+            return 0;
+        }
+
+#if CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS > 0
+        if (behavior_queue_next_cursor_step(queue, item)) {
+            return 0;
+        }
+#endif
+
+        int ret = k_msgq_get(&queue->msgq, item, K_NO_WAIT);
+        if (ret < 0) {
+            return ret;
+        }
+
+        if (item->taps) {
+            queue->current_taps_item = *item;
+            queue->current_taps_item.press = true;
+            continue;
+        }
+
+#if CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS > 0
+        if (item->cursor) {
+            queue->current_cursor_item = *item;
+            continue;
+        }
+#endif
+
+        return 0;
+    }
+}
+
+static struct behavior_queue *behavior_queue_for_position(uint32_t position) {
+    return &queues[position % ARRAY_SIZE(queues)];
+}
+
+static void behavior_queue_process(struct behavior_queue *queue) {
     struct q_item item = {.wait = 0};
 
-    while (k_msgq_get(&zmk_behavior_queue_msgq, &item, K_NO_WAIT) == 0) {
+    while (behavior_queue_get(queue, &item) == 0) {
         LOG_DBG("Invoking %s: 0x%02x 0x%02x", item.binding.behavior_dev, item.binding.param1,
                 item.binding.param2);
 
@@ -42,21 +168,41 @@ static void behavior_queue_process_next(struct k_work *work) {
 #endif
         };
 
-        if (item.press) {
-            zmk_behavior_invoke_binding(&item.binding, event, true);
-        } else {
-            zmk_behavior_invoke_binding(&item.binding, event, false);
-        }
+#if ZMK_CONTEXT_COUNT > 1
+        uint8_t context = zmk_context_index();
+
+        zmk_context_select(item.context);
+        zmk_behavior_invoke_binding(&item.binding, event, item.press);
+        zmk_context_select(context);
+#else
+        zmk_behavior_invoke_binding(&item.binding, event, item.press);
+#endif
 
         LOG_DBG("Processing next queued behavior in %dms", item.wait);
 
         if (item.wait > 0) {
-            k_work_schedule(&queue_work, K_MSEC(item.wait));
+            zmk_work_stats_submit(ZMK_WORK_STATS(behavior_queue), item.wait);
+            k_work_schedule_for_queue(zmk_workqueue_input_work_q(), &queue->work,
+                                      K_MSEC(item.wait));
             break;
         }
     }
 }
 
+static void behavior_queue_process_next(struct k_work *work) {
+    struct k_work_delayable *d_work = k_work_delayable_from_work(work);
+    uint32_t start = zmk_work_stats_run_start(ZMK_WORK_STATS(behavior_queue));
+
+    behavior_queue_process(CONTAINER_OF(d_work, struct behavior_queue, work));
+    zmk_work_stats_run_end(ZMK_WORK_STATS(behavior_queue), start);
+}
+
+static void behavior_queue_start(struct behavior_queue *queue) {
+    if (!k_work_delayable_is_pending(&queue->work)) {
+        behavior_queue_process(queue);
+    }
+}
+
 int zmk_behavior_queue_add(const struct zmk_behavior_binding_event *event,
                            const struct zmk_behavior_binding binding, bool press, uint32_t wait) {
     struct q_item item = {
@@ -66,17 +212,132 @@ int zmk_behavior_queue_add(const struct zmk_behavior_binding_event *event,
         .position = event->position,
 #if IS_ENABLED(CONFIG_ZMK_SPLIT)
         .source = event->source,
+#endif
+#if ZMK_CONTEXT_COUNT > 1
+        .context = zmk_context_index(),
+#endif
+    };
+
+    struct behavior_queue *queue = behavior_queue_for_position(event->position);
+
+    const int ret = k_msgq_put(&queue->msgq, &item, K_NO_WAIT);
+    if (ret < 0) {
+        return ret;
+    }
+
+    zmk_work_stats_queue_depth(ZMK_WORK_STATS(behavior_queue), k_msgq_num_used_get(&queue->msgq));
+
+    behavior_queue_start(queue);
+
+    return 0;
+}
+
+int zmk_behavior_queue_add_taps(const struct zmk_behavior_binding_event *event,
+                                const struct zmk_behavior_binding binding, uint16_t taps,
+                                uint32_t tap_ms) {
+    if (taps == 0) {
+        return 0;
+    }
+
+    struct q_item item = {
+        .binding = binding,
+        .wait = tap_ms,
+        .taps = taps,
+        .position = event->position,
+#if IS_ENABLED(CONFIG_ZMK_SPLIT)
+        .source = event->source,
+#endif
+#if ZMK_CONTEXT_COUNT > 1
+        .context = zmk_context_index(),
+#endif
+    };
+
+    struct behavior_queue *queue = behavior_queue_for_position(event->position);
+
+    const int ret = k_msgq_put(&queue->msgq, &item, K_NO_WAIT);
+    if (ret < 0) {
+        return ret;
+    }
+
+    zmk_work_stats_queue_depth(ZMK_WORK_STATS(behavior_queue), k_msgq_num_used_get(&queue->msgq));
+
+    behavior_queue_start(queue);
+
+    return 0;
+}
+
+#if CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS > 0
+
+int zmk_behavior_queue_add_cursor(const struct zmk_behavior_binding_event *event,
+                                  zmk_behavior_queue_cursor_next_t next, const void *state,
+                                  size_t state_len) {
+    if (state_len > ZMK_BEHAVIOR_QUEUE_CURSOR_STATE_SIZE) {
+        return -EINVAL;
+    }
+
+    int idx = 0;
+    while (atomic_test_and_set_bit(&cursors_in_use, idx)) {
+        if (++idx == CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS) {
+            return -ENOMEM;
+        }
+    }
+
+    cursors[idx].next = next;
+    memcpy(cursors[idx].state, state, state_len);
+
+    struct q_item item = {
+        .cursor = idx + 1,
+        .position = event->position,
+#if IS_ENABLED(CONFIG_ZMK_SPLIT)
+        .source = event->source,
+#endif
+#if ZMK_CONTEXT_COUNT > 1
+        .context = zmk_context_index(),
 #endif
     };
 
-    const int ret = k_msgq_put(&zmk_behavior_queue_msgq, &item, K_NO_WAIT);
+    struct behavior_queue *queue = behavior_queue_for_position(event->position);
+
+    const int ret = k_msgq_put(&queue->msgq, &item, K_NO_WAIT);
     if (ret < 0) {
+        atomic_clear_bit(&cursors_in_use, idx);
         return ret;
     }
 
-    if (!k_work_delayable_is_pending(&queue_work)) {
-        behavior_queue_process_next(&queue_work.work);
+    zmk_work_stats_queue_depth(ZMK_WORK_STATS(behavior_queue), k_msgq_num_used_get(&queue->msgq));
+
+    behavior_queue_start(queue);
+
+    return 0;
+}
+
+#endif // CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS > 0
+
+#if IS_ENABLED(CONFIG_ZMK_CHECKPOINT)
+bool zmk_behavior_queue_idle(void) {
+    for (int i = 0; i < ARRAY_SIZE(queues); i++) {
+        if (k_msgq_num_used_get(&queues[i].msgq) > 0 || queues[i].current_taps_item.taps) {
+            return false;
+        }
+#if CONFIG_ZMK_BEHAVIORS_QUEUE_CURSORS > 0
+        if (queues[i].current_cursor_item.cursor) {
+            return false;
+        }
+#endif
+    }
+
+    return true;
+}
+#endif // IS_ENABLED(CONFIG_ZMK_CHECKPOINT)
+
+static int behavior_queue_init(void) {
+    for (int i = 0; i < ARRAY_SIZE(queues); i++) {
+        k_msgq_init(&queues[i].msgq, queue_buffers[i], sizeof(struct q_item),
+                    CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE);
+        k_work_init_delayable(&queues[i].work, behavior_queue_process_next);
     }
 
     return 0;
 }
+
+SYS_INIT(behavior_queue_init, APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zmk/behavior_timer.h>
+#include <zmk/context.h>
+#include <zmk/physical_layouts.h>
+#include <zmk/work_stats.h>
+#include <zmk/workqueue.h>
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// A hierarchical timer wheel with millisecond resolution. Level 0 has a slot per millisecond of
+// the current 64ms block, level 1 a slot per 64ms block of the current 4096ms block, and so on.
+// A timer goes in the lowest level whose current block holds its deadline, and moves down a level
+// once the wheel reaches the start of its slot. The few timers further out than the top level
+// wait in an overflow list until the wheel reaches their top level block.
+
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS BIT(WHEEL_BITS)
+#define WHEEL_LEVELS 3
+
+static sys_dlist_t wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+// slots that may hold timers, cleared lazily since cancelling doesn't update them
+static uint64_t wheel_occupied[WHEEL_LEVELS];
+static sys_dlist_t wheel_overflow;
+// timers whose deadline has been reached, in the order they'll run
+static sys_dlist_t wheel_expired;
+
+// the uptime the wheel has been advanced to
+static int64_t wheel_time;
+static size_t wheel_pending;
+static int64_t wheel_scheduled_at = INT64_MAX;
+// whether the current run already waited for queued input
+static bool wheel_deferred;
+
+static struct k_spinlock wheel_lock;
+
+static void wheel_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(wheel_work, wheel_work_cb);
+
+ZMK_WORK_STATS_DEFINE(behavior_timer, 0);
+
+static void wheel_insert(struct zmk_behavior_timer *timer) {
+    if (timer->deadline <= wheel_time) {
+        sys_dlist_append(&wheel_expired, &timer->node);
+        return;
+    }
+
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+        int block_shift = WHEEL_BITS * (level + 1);
+        if ((timer->deadline >> block_shift) == (wheel_time >> block_shift)) {
+            int slot = (timer->deadline >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1);
+            sys_dlist_append(&wheel[level][slot], &timer->node);
+            wheel_occupied[level] |= BIT64(slot);
+            return;
+        }
+    }
+
+    sys_dlist_append(&wheel_overflow, &timer->node);
+}
+
+// The next time the wheel has to be advanced to, either to run timers or to move them down a
+// level. Lower levels always come first, since their slots are all in the current block.
+static int64_t wheel_next_time(void) {
+    if (!sys_dlist_is_empty(&wheel_expired)) {
+        return wheel_time;
+    }
+
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+        while (wheel_occupied[level]) {
+            int slot = __builtin_ctzll(wheel_occupied[level]);
+            if (sys_dlist_is_empty(&wheel[level][slot])) {
+                wheel_occupied[level] &= ~BIT64(slot);
+                continue;
+            }
+
+            int shift = WHEEL_BITS * level;
+            int64_t block = (wheel_time >> (shift + WHEEL_BITS)) << (shift + WHEEL_BITS);
+            return block | ((int64_t)slot << shift);
+        }
+    }
+
+    if (!sys_dlist_is_empty(&wheel_overflow)) {
+        int shift = WHEEL_BITS * WHEEL_LEVELS;
+        return ((wheel_time >> shift) + 1) << shift;
+    }
+
+    return INT64_MAX;
+}
+
+static void wheel_move(sys_dlist_t *list) {
+    // Overflow timers can go right back into the overflow list, so only move the current ones.
+    sys_dnode_t *last = sys_dlist_peek_tail(list);
+    sys_dnode_t *node;
+    do {
+        node = sys_dlist_get(list);
+        if (node == NULL) {
+            break;
+        }
+        wheel_insert(CONTAINER_OF(node, struct zmk_behavior_timer, node));
+    } while (node != last);
+}
+
+static void wheel_advance(int64_t time) {
+    wheel_time = time;
+
+    if ((time & (BIT64(WHEEL_BITS * WHEEL_LEVELS) - 1)) == 0) {
+        wheel_move(&wheel_overflow);
+    }
+
+    // Higher levels first, so their timers can move down more than one level at once.
+    for (int level = WHEEL_LEVELS - 1; level >= 0; level--) {
+        int shift = WHEEL_BITS * level;
+        if ((time & (BIT64(shift) - 1)) == 0) {
+            int slot = (time >> shift) & (WHEEL_SLOTS - 1);
+            wheel_occupied[level] &= ~BIT64(slot);
+            wheel_move(&wheel[level][slot]);
+        }
+    }
+}
+
+static void wheel_schedule(void) {
+    int64_t next = wheel_next_time();
+    if (next >= wheel_scheduled_at) {
+        return;
+    }
+
+    wheel_scheduled_at = next;
+
+    int64_t delay = MAX(next - k_uptime_get(), 0);
+    zmk_work_stats_submit(ZMK_WORK_STATS(behavior_timer), delay);
+    k_work_reschedule_for_queue(zmk_workqueue_input_work_q(), &wheel_work, K_MSEC(delay));
+}
+
+static void wheel_work_cb(struct k_work *work) {
+    // Key events still queued happened before now, possibly before the deadlines that are due.
+    // Behaviors resolve a timeout passed by an event's timestamp when they get that event, so let
+    // the queue, which was submitted ahead of this, raise them first and run the timers after.
+    // Only once per run, so a steady stream of input can't hold the timers off.
+    if (!wheel_deferred && zmk_physical_layouts_kscan_pending()) {
+        wheel_deferred = true;
+        k_work_reschedule_for_queue(zmk_workqueue_input_work_q(), &wheel_work, K_NO_WAIT);
+        return;
+    }
+
+    wheel_deferred = false;
+
+    uint32_t start = zmk_work_stats_run_start(ZMK_WORK_STATS(behavior_timer));
+    int64_t now = k_uptime_get();
+    k_spinlock_key_t key = k_spin_lock(&wheel_lock);
+
+    wheel_scheduled_at = INT64_MAX;
+
+    while (true) {
+        sys_dnode_t *node = sys_dlist_get(&wheel_expired);
+        if (node != NULL) {
+            struct zmk_behavior_timer *timer = CONTAINER_OF(node, struct zmk_behavior_timer, node);
+            wheel_pending--;
+
+            k_spin_unlock(&wheel_lock, key);
+#if ZMK_CONTEXT_COUNT > 1
+            uint8_t context = zmk_context_index();
+
+            zmk_context_select(timer->context);
+            timer->handler(timer);
+            zmk_context_select(context);
+#else
+            timer->handler(timer);
+#endif
+            key = k_spin_lock(&wheel_lock);
+            continue;
+        }
+
+        int64_t next = wheel_next_time();
+        if (next > now) {
+            break;
+        }
+
+        wheel_advance(next);
+    }
+
+    // Nothing is due before now, so the wheel can skip ahead without moving any timers.
+    wheel_time = MAX(wheel_time, now);
+    wheel_schedule();
+
+    k_spin_unlock(&wheel_lock, key);
+    zmk_work_stats_run_end(ZMK_WORK_STATS(behavior_timer), start);
+}
+
+void zmk_behavior_timer_init(struct zmk_behavior_timer *timer,
+                             zmk_behavior_timer_handler_t handler) {
+    sys_dnode_init(&timer->node);
+    timer->handler = handler;
+}
+
+void zmk_behavior_timer_start(struct zmk_behavior_timer *timer, int64_t deadline) {
+    k_spinlock_key_t key = k_spin_lock(&wheel_lock);
+
+    if (sys_dnode_is_linked(&timer->node)) {
+        sys_dlist_remove(&timer->node);
+        wheel_pending--;
+    }
+
+    if (wheel_pending == 0) {
+        // an empty wheel can jump straight to the current time
+        memset(wheel_occupied, 0, sizeof(wheel_occupied));
+        wheel_time = MAX(wheel_time, k_uptime_get());
+    }
+
+    timer->deadline = deadline;
+#if ZMK_CONTEXT_COUNT > 1
+    timer->context = zmk_context_index();
+#endif
+    wheel_insert(timer);
+    wheel_pending++;
+    wheel_schedule();
+
+    k_spin_unlock(&wheel_lock, key);
+}
+
+void zmk_behavior_timer_cancel(struct zmk_behavior_timer *timer) {
+    k_spinlock_key_t key = k_spin_lock(&wheel_lock);
+
+    if (sys_dnode_is_linked(&timer->node)) {
+        sys_dlist_remove(&timer->node);
+        wheel_pending--;
+    }
+
+    k_spin_unlock(&wheel_lock, key);
+}
+
+bool zmk_behavior_timer_is_pending(const struct zmk_behavior_timer *timer) {
+    return sys_dnode_is_linked(&timer->node);
+}
+
+static int behavior_timer_init(void) {
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < WHEEL_SLOTS; slot++) {
+            sys_dlist_init(&wheel[level][slot]);
+        }
+    }
+    sys_dlist_init(&wheel_overflow);
+    sys_dlist_init(&wheel_expired);
+
+    return 0;
+}
+
+SYS_INIT(behavior_timer_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -122,6 +122,18 @@ on_keymap_binding_convert_central_state_dependent_params(struct zmk_behavior_bin
     return 0;
 }
 
+static int on_keymap_binding_is_idempotent(struct zmk_behavior_binding *binding,
+                                           struct zmk_behavior_binding_event event) {
+    switch (binding->param1) {
+    case BL_ON_CMD:
+    case BL_OFF_CMD:
+    case BL_SET_CMD:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
 static int on_keymap_binding_pressed(struct zmk_behavior_binding *binding,
                                      struct zmk_behavior_binding_event event) {
     switch (binding->param1) {
@@ -160,6 +172,7 @@ static int on_keymap_binding_released(struct zmk_behavior_binding *binding,
 static const struct behavior_driver_api behavior_backlight_driver_api = {
     .binding_convert_central_state_dependent_params =
         on_keymap_binding_convert_central_state_dependent_params,
+    .binding_is_idempotent = on_keymap_binding_is_idempotent,
     .binding_pressed = on_keymap_binding_pressed,
     .binding_released = on_keymap_binding_released,
     .locality = BEHAVIOR_LOCALITY_GLOBAL,
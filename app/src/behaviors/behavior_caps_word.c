@@ -10,12 +10,14 @@
 #include <drivers/behavior.h>
 #include <zephyr/logging/log.h>
 #include <zmk/behavior.h>
+#include <zmk/context.h>
 
 #include <zmk/endpoints.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/keycode_state_changed.h>
 #include <zmk/events/modifiers_state_changed.h>
+#include <zmk/fuzz.h>
 #include <zmk/keys.h>
 #include <zmk/hid.h>
 #include <zmk/keymap.h>
@@ -30,34 +32,57 @@ struct caps_word_continue_item {
     uint8_t implicit_modifiers;
 };
 
+// One bit per usage of the keyboard page
+#define KEYBOARD_USAGE_WORDS (256 / 32)
+
 struct behavior_caps_word_config {
     zmk_mod_flags_t mods;
+    // Keyboard usages of the continue list without implicit modifiers, which always continue
+    uint32_t continue_keyboard_usages[KEYBOARD_USAGE_WORDS];
+    // Keyboard usages of the continue list that only continue with some modifiers
+    uint32_t continue_keyboard_modded_usages[KEYBOARD_USAGE_WORDS];
+    // Whether the continue list has usages of other pages
+    bool continue_other_pages;
     uint8_t continuations_count;
     struct caps_word_continue_item continuations[];
 };
 
 struct behavior_caps_word_data {
-    bool active;
+    // per context
+    bool active[ZMK_CONTEXT_COUNT];
 };
 
+static int caps_word_keycode_state_changed_listener(const zmk_event_t *eh);
+
+// Keycode events are only dispatched to the listener while an instance is active.
+ZMK_LISTENER_WHEN_ACTIVE(behavior_caps_word, caps_word_keycode_state_changed_listener);
+ZMK_SUBSCRIPTION(behavior_caps_word, zmk_keycode_state_changed);
+
+// Instances active, counted once per context they are active in
+static uint8_t active_count;
+
 static void activate_caps_word(const struct device *dev) {
     struct behavior_caps_word_data *data = dev->data;
 
-    data->active = true;
+    data->active[zmk_context_index()] = true;
+    active_count++;
+    ZMK_LISTENER_SET_ACTIVE(behavior_caps_word, true);
 }
 
 static void deactivate_caps_word(const struct device *dev) {
     struct behavior_caps_word_data *data = dev->data;
 
-    data->active = false;
+    data->active[zmk_context_index()] = false;
+    active_count--;
+    ZMK_LISTENER_SET_ACTIVE(behavior_caps_word, active_count > 0);
 }
 
 static int on_caps_word_binding_pressed(struct zmk_behavior_binding *binding,
                                         struct zmk_behavior_binding_event event) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
     struct behavior_caps_word_data *data = dev->data;
 
-    if (data->active) {
+    if (data->active[zmk_context_index()]) {
         deactivate_caps_word(dev);
     } else {
         activate_caps_word(dev);
@@ -79,26 +104,44 @@ static const struct behavior_driver_api behavior_caps_word_driver_api = {
 #endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
 };
 
-static int caps_word_keycode_state_changed_listener(const zmk_event_t *eh);
-
-ZMK_LISTENER(behavior_caps_word, caps_word_keycode_state_changed_listener);
-ZMK_SUBSCRIPTION(behavior_caps_word, zmk_keycode_state_changed);
-
 #define GET_DEV(inst) DEVICE_DT_INST_GET(inst),
 static const struct device *devs[] = {DT_INST_FOREACH_STATUS_OKAY(GET_DEV)};
 
+static bool keyboard_usage_bit(const uint32_t *usages, uint32_t usage_id) {
+    return usage_id < 256 && (usages[usage_id / 32] & BIT(usage_id % 32)) != 0U;
+}
+
 static bool caps_word_is_caps_includelist(const struct behavior_caps_word_config *config,
                                           uint16_t usage_page, uint8_t usage_id,
                                           uint8_t implicit_modifiers) {
+    // Keyboard usages are looked up in the bitmaps, and the list is only compared with for
+    // those that need modifiers, or for other pages.
+    if (usage_page == HID_USAGE_KEY) {
+        if (keyboard_usage_bit(config->continue_keyboard_usages, usage_id)) {
+            LOG_DBG("Continuing capsword, found included usage: 0x%02X - 0x%02X", usage_page,
+                    usage_id);
+            return true;
+        }
+
+        if (!keyboard_usage_bit(config->continue_keyboard_modded_usages, usage_id)) {
+            return false;
+        }
+    } else if (!config->continue_other_pages) {
+        return false;
+    }
+
     for (int i = 0; i < config->continuations_count; i++) {
         const struct caps_word_continue_item *continuation = &config->continuations[i];
+        if (continuation->page != usage_page || continuation->id != usage_id) {
+            continue;
+        }
+
         LOG_DBG("Comparing with 0x%02X - 0x%02X (with implicit mods: 0x%02X)", continuation->page,
                 continuation->id, continuation->implicit_modifiers);
 
-        if (continuation->page == usage_page && continuation->id == usage_id &&
-            (continuation->implicit_modifiers &
+        if ((continuation->implicit_modifiers &
              (implicit_modifiers | zmk_hid_get_explicit_mods())) ==
-                continuation->implicit_modifiers) {
+            continuation->implicit_modifiers) {
             LOG_DBG("Continuing capsword, found included usage: 0x%02X - 0x%02X", usage_page,
                     usage_id);
             return true;
@@ -137,7 +180,7 @@ static int caps_word_keycode_state_changed_listener(const zmk_event_t *eh) {
         const struct device *dev = devs[i];
 
         struct behavior_caps_word_data *data = dev->data;
-        if (!data->active) {
+        if (!data->active[zmk_context_index()]) {
             continue;
         }
 
@@ -157,6 +200,19 @@ static int caps_word_keycode_state_changed_listener(const zmk_event_t *eh) {
     return ZMK_EV_EVENT_BUBBLE;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_CHECKPOINT)
+bool zmk_behavior_caps_word_idle(void) {
+    for (int i = 0; i < ARRAY_SIZE(devs); i++) {
+        const struct behavior_caps_word_data *data = devs[i]->data;
+        if (data->active[zmk_context_index()]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+#endif // IS_ENABLED(CONFIG_ZMK_CHECKPOINT)
+
 #define CAPS_WORD_LABEL(i, _n) DT_INST_LABEL(i)
 
 #define PARSE_BREAK(i)                                                                             \
@@ -164,10 +220,36 @@ static int caps_word_keycode_state_changed_listener(const zmk_event_t *eh) {
 
 #define BREAK_ITEM(i, n) PARSE_BREAK(DT_INST_PROP_BY_IDX(n, continue_list, i))
 
+#define IS_KEYBOARD_USAGE(u) (ZMK_HID_USAGE_PAGE(u) == HID_USAGE_KEY && ZMK_HID_USAGE_ID(u) < 256)
+
+#define CONTINUE_USAGE_BIT(node_id, prop, idx, word, modded)                                       \
+    ((IS_KEYBOARD_USAGE(DT_PROP_BY_IDX(node_id, prop, idx)) &&                                     \
+      ZMK_HID_USAGE_ID(DT_PROP_BY_IDX(node_id, prop, idx)) / 32 == word &&                         \
+      (SELECT_MODS(DT_PROP_BY_IDX(node_id, prop, idx)) != 0) == modded)                            \
+         ? BIT(ZMK_HID_USAGE_ID(DT_PROP_BY_IDX(node_id, prop, idx)) % 32)                          \
+         : 0) |
+
+#define CONTINUE_USAGE_WORD(word, n, modded)                                                       \
+    (DT_INST_FOREACH_PROP_ELEM_VARGS(n, continue_list, CONTINUE_USAGE_BIT, word, modded) 0)
+
+#define CONTINUE_OTHER_PAGE(node_id, prop, idx)                                                    \
+    !IS_KEYBOARD_USAGE(DT_PROP_BY_IDX(node_id, prop, idx)) ||
+
 #define KP_INST(n)                                                                                 \
-    static struct behavior_caps_word_data behavior_caps_word_data_##n = {.active = false};         \
+    static struct behavior_caps_word_data behavior_caps_word_data_##n = {};                        \
     static const struct behavior_caps_word_config behavior_caps_word_config_##n = {                \
         .mods = DT_INST_PROP_OR(n, mods, MOD_LSFT),                                                \
+        .continue_keyboard_usages = {CONTINUE_USAGE_WORD(0, n, 0), CONTINUE_USAGE_WORD(1, n, 0),   \
+                                     CONTINUE_USAGE_WORD(2, n, 0), CONTINUE_USAGE_WORD(3, n, 0),   \
+                                     CONTINUE_USAGE_WORD(4, n, 0), CONTINUE_USAGE_WORD(5, n, 0),   \
+                                     CONTINUE_USAGE_WORD(6, n, 0), CONTINUE_USAGE_WORD(7, n, 0)},  \
+        .continue_keyboard_modded_usages =                                                         \
+            {CONTINUE_USAGE_WORD(0, n, 1), CONTINUE_USAGE_WORD(1, n, 1),                           \
+             CONTINUE_USAGE_WORD(2, n, 1), CONTINUE_USAGE_WORD(3, n, 1),                           \
+             CONTINUE_USAGE_WORD(4, n, 1), CONTINUE_USAGE_WORD(5, n, 1),                           \
+             CONTINUE_USAGE_WORD(6, n, 1), CONTINUE_USAGE_WORD(7, n, 1)},                          \
+        .continue_other_pages =                                                                    \
+            DT_INST_FOREACH_PROP_ELEM(n, continue_list, CONTINUE_OTHER_PAGE) false,                \
         .continuations = {LISTIFY(DT_INST_PROP_LEN(n, continue_list), BREAK_ITEM, (, ), n)},       \
         .continuations_count = DT_INST_PROP_LEN(n, continue_list),                                 \
     };                                                                                             \
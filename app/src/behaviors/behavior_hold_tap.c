@@ -12,6 +12,10 @@
 #include <dt-bindings/zmk/keys.h>
 #include <zephyr/logging/log.h>
 #include <zmk/behavior.h>
+#include <zmk/behavior_timer.h>
+#include <zmk/context.h>
+#include <zmk/fuzz.h>
+#include <zmk/key_stats.h>
 #include <zmk/matrix.h>
 #include <zmk/endpoints.h>
 #include <zmk/event_manager.h>
@@ -50,8 +54,11 @@ enum decision_moment {
     HT_OTHER_KEY_UP,
     HT_TIMER_EVENT,
     HT_QUICK_TAP,
+    HT_DECISION_MOMENT_COUNT,
 };
 
+#define HOLD_TRIGGER_MASK_LEN DIV_ROUND_UP(ZMK_KEYMAP_LEN, 32)
+
 struct behavior_hold_tap_config {
     int tapping_term_ms;
     char *hold_behavior_dev;
@@ -59,10 +66,14 @@ struct behavior_hold_tap_config {
     int quick_tap_ms;
     int require_prior_idle_ms;
     enum flavor flavor;
+    // the status each decision moment decides for this flavor, STATUS_UNDECIDED for none
+    const uint8_t *decisions;
     bool hold_while_undecided;
     bool hold_while_undecided_linger;
     bool retro_tap;
     bool hold_trigger_on_release;
+    // hold_trigger_key_positions as a bitset of key positions, filled in at init
+    uint32_t *hold_trigger_key_positions_mask;
     int32_t hold_trigger_key_positions_len;
     int32_t hold_trigger_key_positions[];
 };
@@ -84,39 +95,16 @@ struct active_hold_tap {
     int64_t timestamp;
     enum status status;
     const struct behavior_hold_tap_config *config;
-    struct k_work_delayable work;
-    bool work_is_cancelled;
+    struct zmk_behavior_timer timer;
 
     // initialized to -1, which is to be interpreted as "no other key has been pressed yet"
     int32_t position_of_first_other_key_pressed;
 };
 
-// The undecided hold tap is the hold tap that needs to be decided before
-// other keypress events can be released. While the undecided_hold_tap is
-// not NULL, most events are captured in captured_events.
-// After the hold_tap is decided, it will stay in the active_hold_taps until
-// its key-up has been processed and the delayed work is cleaned up.
-struct active_hold_tap *undecided_hold_tap = NULL;
-struct active_hold_tap active_hold_taps[ZMK_BHV_HOLD_TAP_MAX_HELD] = {};
-// We capture most position_state_changed events and some modifiers_state_changed events.
-
-enum captured_event_tag {
-    ET_NONE,
-    ET_POS_CHANGED,
-    ET_CODE_CHANGED,
-};
-
-union captured_event_data {
-    struct zmk_position_state_changed_event position;
-    struct zmk_keycode_state_changed_event keycode;
-};
-
-struct captured_event {
-    enum captured_event_tag tag;
-    union captured_event_data data;
-};
+#define HOLD_TAP_SLOT_NONE UINT8_MAX
 
-struct captured_event captured_events[ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS] = {};
+BUILD_ASSERT(ZMK_BHV_HOLD_TAP_MAX_HELD < HOLD_TAP_SLOT_NONE,
+             "CONFIG_ZMK_BEHAVIOR_HOLD_TAP_MAX_HELD must be below 255");
 
 // Keep track of which key was tapped most recently for the standard, if it is a hold-tap
 // a position, will be given, if not it will just be INT32_MIN
@@ -125,128 +113,138 @@ struct last_tapped {
     int64_t timestamp;
 };
 
+struct hold_tap_state {
+    // The undecided hold tap is the hold tap that needs to be decided before
+    // other keypress events can be released. While the undecided_hold_tap is
+    // not NULL, most events are captured in captured_events.
+    // After the hold_tap is decided, it will stay in the active_hold_taps until
+    // its key-up has been processed and its timer is cancelled.
+    struct active_hold_tap *undecided_hold_tap;
+    struct active_hold_tap active_hold_taps[ZMK_BHV_HOLD_TAP_MAX_HELD];
+
+    // Index into active_hold_taps of the hold-tap on each key position. Virtual key positions
+    // (e.g. combos) aren't mapped, and are searched for in active_hold_taps instead.
+    uint8_t hold_tap_slots[ZMK_KEYMAP_LEN];
+    // Unused entries of active_hold_taps, as a stack of indexes.
+    uint8_t free_hold_tap_slots[ZMK_BHV_HOLD_TAP_MAX_HELD];
+    uint8_t free_hold_tap_slots_len;
+
+    // We capture most position_state_changed events and some modifiers_state_changed events.
+    // The events themselves live in the event manager's pool; this array only orders them,
+    // oldest first, and is emptied every time the captured events are released.
+    zmk_event_handle_t captured_events[ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS];
+    uint16_t captured_events_len;
+
+    // Number of key-down events per position captured since captured events were last released.
+    uint8_t captured_keydowns[ZMK_KEYMAP_LEN];
+
+    struct last_tapped last_tapped;
+};
+
 // Set time stamp to large negative number initially for test suites, but not
 // int64 min since it will overflow if -1 is added
-struct last_tapped last_tapped = {INT32_MIN, INT32_MIN};
+ZMK_CONTEXT_STATE_DEFINE(hold_tap_states, struct hold_tap_state,
+                         {.last_tapped = {INT32_MIN, INT32_MIN}});
+
+#define STATE ZMK_CONTEXT_STATE(hold_tap_states)
 
 static void store_last_tapped(int64_t timestamp) {
-    if (timestamp > last_tapped.timestamp) {
-        last_tapped.position = INT32_MIN;
-        last_tapped.timestamp = timestamp;
+    if (timestamp > STATE->last_tapped.timestamp) {
+        STATE->last_tapped.position = INT32_MIN;
+        STATE->last_tapped.timestamp = timestamp;
     }
 }
 
 static void store_last_hold_tapped(struct active_hold_tap *hold_tap) {
-    last_tapped.position = hold_tap->position;
-    last_tapped.timestamp = hold_tap->timestamp;
+    STATE->last_tapped.position = hold_tap->position;
+    STATE->last_tapped.timestamp = hold_tap->timestamp;
 }
 
 static bool is_quick_tap(struct active_hold_tap *hold_tap) {
-    if ((last_tapped.timestamp + hold_tap->config->require_prior_idle_ms) > hold_tap->timestamp) {
+    const struct last_tapped *last_tapped = &STATE->last_tapped;
+
+    if ((last_tapped->timestamp + hold_tap->config->require_prior_idle_ms) > hold_tap->timestamp) {
         return true;
     } else {
-        return (last_tapped.position == hold_tap->position) &&
-               (last_tapped.timestamp + hold_tap->config->quick_tap_ms) > hold_tap->timestamp;
+        return (last_tapped->position == hold_tap->position) &&
+               (last_tapped->timestamp + hold_tap->config->quick_tap_ms) > hold_tap->timestamp;
     }
 }
 
-static int capture_event(struct captured_event *data) {
-    for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS; i++) {
-        if (captured_events[i].tag == ET_NONE) {
-            captured_events[i] = *data;
-            return 0;
-        }
+static int capture_event(zmk_event_handle_t handle) {
+    if (handle < 0) {
+        return handle;
     }
-    return -ENOMEM;
-}
 
-static bool have_captured_keydown_event(uint32_t position) {
-    for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS; i++) {
-        struct captured_event *ev = &captured_events[i];
-        if (ev->tag == ET_NONE) {
-            return false;
-        }
+    if (STATE->captured_events_len == ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS) {
+        zmk_event_pool_free(handle);
+        return -ENOMEM;
+    }
 
-        if (ev->tag != ET_POS_CHANGED) {
-            continue;
-        }
+    STATE->captured_events[STATE->captured_events_len++] = handle;
+    return 0;
+}
 
-        if (ev->data.position.data.position == position && ev->data.position.data.state) {
-            return true;
-        }
-    }
-    return false;
+static bool have_captured_keydown_event(uint32_t position) {
+    return position < ZMK_KEYMAP_LEN && STATE->captured_keydowns[position] > 0;
 }
 
 const struct zmk_listener zmk_listener_behavior_hold_tap;
 
 static void release_captured_events() {
-    if (undecided_hold_tap != NULL) {
+    if (STATE->undecided_hold_tap != NULL) {
         return;
     }
 
-    // We use a trick to prevent copying the captured_events array.
-    //
-    // Events for different mod-tap instances are separated by a NULL pointer.
+    // Releasing an event may start a new undecided hold-tap, which then captures the events
+    // released after it, in order. Those must wait for the new hold-tap to be decided, so the
+    // release works from a copy and the new hold-tap starts from an empty list. If the new
+    // hold-tap is decided while we're still releasing, it releases only what it captured
+    // itself before we continue with the rest.
     //
-    // The first event popped will never be caught by the next active hold-tap
-    // because to start capturing a mod-tap-key-down event must first completely
-    // go through the events queue.
-    //
-    // Example of this release process;
-    // [mt2_down, k1_down, k1_up, mt2_up, null, ...]
-    //  ^
-    // mt2_down position event isn't captured because no hold-tap is active.
-    // mt2_down behavior event is handled, now we have an undecided hold-tap
-    // [null, k1_down, k1_up, mt2_up, null, ...]
-    //        ^
-    // k1_down  is captured by the mt2 mod-tap
-    // !note that searches for find_captured_keydown_event by the mt2 behavior will stop at the
-    // first null encountered [mt1_down, null, k1_up, mt2_up, null, ...]
-    //                  ^
-    // k1_up event is captured by the new hold-tap:
-    // [k1_down, k1_up, null, mt2_up, null, ...]
-    //                        ^
-    // mt2_up event is not captured but causes release of mt2 behavior
-    // [k1_down, k1_up, null, null, null, ...]
-    // now mt2 will start releasing it's own captured positions.
-    for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS; i++) {
-        struct captured_event *captured_event = &captured_events[i];
-        enum captured_event_tag tag = captured_event->tag;
-
-        if (tag == ET_NONE) {
-            return;
-        }
-
-        captured_events[i].tag = ET_NONE;
-        if (undecided_hold_tap != NULL) {
+    // Every key-down counted in captured_keydowns is being released here too, so the count
+    // restarts and only covers what the next undecided hold-tap captures.
+    uint16_t count = STATE->captured_events_len;
+    zmk_event_handle_t handles[ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS];
+    memcpy(handles, STATE->captured_events, count * sizeof(handles[0]));
+    STATE->captured_events_len = 0;
+    memset(STATE->captured_keydowns, 0, sizeof(STATE->captured_keydowns));
+
+    for (int i = 0; i < count; i++) {
+        zmk_event_handle_t handle = handles[i];
+
+        if (STATE->undecided_hold_tap != NULL) {
             k_msleep(10);
         }
 
-        switch (tag) {
-        case ET_CODE_CHANGED:
-            LOG_DBG("Releasing mods changed event 0x%02X %s",
-                    captured_event->data.keycode.data.keycode,
-                    (captured_event->data.keycode.data.state ? "pressed" : "released"));
-            ZMK_EVENT_RAISE_AT(captured_event->data.keycode, behavior_hold_tap);
-            break;
-        case ET_POS_CHANGED:
-            LOG_DBG("Releasing key position event for position %d %s",
-                    captured_event->data.position.data.position,
-                    (captured_event->data.position.data.state ? "pressed" : "released"));
-            ZMK_EVENT_RAISE_AT(captured_event->data.position, behavior_hold_tap);
-            break;
-        default:
+        const zmk_event_t *eh = zmk_event_pool_get(handle);
+        const struct zmk_keycode_state_changed *keycode = as_zmk_keycode_state_changed(eh);
+        const struct zmk_position_state_changed *position = as_zmk_position_state_changed(eh);
+
+        if (keycode != NULL) {
+            LOG_DBG("Releasing mods changed event 0x%02X %s", keycode->keycode,
+                    (keycode->state ? "pressed" : "released"));
+            ZMK_EVENT_POOL_RAISE_AT(handle, behavior_hold_tap);
+        } else if (position != NULL) {
+            LOG_DBG("Releasing key position event for position %d %s", position->position,
+                    (position->state ? "pressed" : "released"));
+            ZMK_EVENT_POOL_RAISE_AT(handle, behavior_hold_tap);
+        } else {
             LOG_ERR("Unhandled captured event type");
-            break;
+            zmk_event_pool_free(handle);
         }
     }
 }
 
 static struct active_hold_tap *find_hold_tap(uint32_t position) {
+    if (position < ZMK_KEYMAP_LEN) {
+        uint8_t slot = STATE->hold_tap_slots[position];
+        return slot == HOLD_TAP_SLOT_NONE ? NULL : &STATE->active_hold_taps[slot];
+    }
+
     for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_HELD; i++) {
-        if (active_hold_taps[i].position == position) {
-            return &active_hold_taps[i];
+        if (STATE->active_hold_taps[i].position == position) {
+            return &STATE->active_hold_taps[i];
         }
     }
     return NULL;
@@ -255,105 +253,77 @@ static struct active_hold_tap *find_hold_tap(uint32_t position) {
 static struct active_hold_tap *store_hold_tap(struct zmk_behavior_binding_event *event,
                                               uint32_t param_hold, uint32_t param_tap,
                                               const struct behavior_hold_tap_config *config) {
-    for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_HELD; i++) {
-        if (active_hold_taps[i].position != ZMK_BHV_HOLD_TAP_POSITION_NOT_USED) {
-            continue;
-        }
-        active_hold_taps[i].position = event->position;
-#if IS_ENABLED(CONFIG_ZMK_SPLIT)
-        active_hold_taps[i].source = event->source;
-#endif
-        active_hold_taps[i].status = STATUS_UNDECIDED;
-        active_hold_taps[i].config = config;
-        active_hold_taps[i].param_hold = param_hold;
-        active_hold_taps[i].param_tap = param_tap;
-        active_hold_taps[i].timestamp = event->timestamp;
-        active_hold_taps[i].position_of_first_other_key_pressed = -1;
-        return &active_hold_taps[i];
+    if (STATE->free_hold_tap_slots_len == 0) {
+        return NULL;
     }
-    return NULL;
-}
 
-static void clear_hold_tap(struct active_hold_tap *hold_tap) {
-    hold_tap->position = ZMK_BHV_HOLD_TAP_POSITION_NOT_USED;
+    uint8_t slot = STATE->free_hold_tap_slots[--STATE->free_hold_tap_slots_len];
+    struct active_hold_tap *hold_tap = &STATE->active_hold_taps[slot];
+
+    hold_tap->position = event->position;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT)
+    hold_tap->source = event->source;
+#endif
     hold_tap->status = STATUS_UNDECIDED;
-    hold_tap->work_is_cancelled = false;
-}
+    hold_tap->config = config;
+    hold_tap->param_hold = param_hold;
+    hold_tap->param_tap = param_tap;
+    hold_tap->timestamp = event->timestamp;
+    hold_tap->position_of_first_other_key_pressed = -1;
 
-static void decide_balanced(struct active_hold_tap *hold_tap, enum decision_moment event) {
-    switch (event) {
-    case HT_KEY_UP:
-        hold_tap->status = STATUS_TAP;
-        return;
-    case HT_OTHER_KEY_UP:
-        hold_tap->status = STATUS_HOLD_INTERRUPT;
-        return;
-    case HT_TIMER_EVENT:
-        hold_tap->status = STATUS_HOLD_TIMER;
-        return;
-    case HT_QUICK_TAP:
-        hold_tap->status = STATUS_TAP;
-        return;
-    default:
-        return;
+    if (event->position < ZMK_KEYMAP_LEN) {
+        STATE->hold_tap_slots[event->position] = slot;
     }
+    return hold_tap;
 }
 
-static void decide_tap_preferred(struct active_hold_tap *hold_tap, enum decision_moment event) {
-    switch (event) {
-    case HT_KEY_UP:
-        hold_tap->status = STATUS_TAP;
-        return;
-    case HT_TIMER_EVENT:
-        hold_tap->status = STATUS_HOLD_TIMER;
-        return;
-    case HT_QUICK_TAP:
-        hold_tap->status = STATUS_TAP;
-        return;
-    default:
+static void clear_hold_tap(struct active_hold_tap *hold_tap) {
+    if (hold_tap->position == ZMK_BHV_HOLD_TAP_POSITION_NOT_USED) {
         return;
     }
-}
 
-static void decide_tap_unless_interrupted(struct active_hold_tap *hold_tap,
-                                          enum decision_moment event) {
-    switch (event) {
-    case HT_KEY_UP:
-        hold_tap->status = STATUS_TAP;
-        return;
-    case HT_OTHER_KEY_DOWN:
-        hold_tap->status = STATUS_HOLD_INTERRUPT;
-        return;
-    case HT_TIMER_EVENT:
-        hold_tap->status = STATUS_TAP;
-        return;
-    case HT_QUICK_TAP:
-        hold_tap->status = STATUS_TAP;
-        return;
-    default:
-        return;
+    uint8_t slot = hold_tap - STATE->active_hold_taps;
+    if (hold_tap->position < ZMK_KEYMAP_LEN && STATE->hold_tap_slots[hold_tap->position] == slot) {
+        STATE->hold_tap_slots[hold_tap->position] = HOLD_TAP_SLOT_NONE;
     }
-}
+    STATE->free_hold_tap_slots[STATE->free_hold_tap_slots_len++] = slot;
 
-static void decide_hold_preferred(struct active_hold_tap *hold_tap, enum decision_moment event) {
-    switch (event) {
-    case HT_KEY_UP:
-        hold_tap->status = STATUS_TAP;
-        return;
-    case HT_OTHER_KEY_DOWN:
-        hold_tap->status = STATUS_HOLD_INTERRUPT;
-        return;
-    case HT_TIMER_EVENT:
-        hold_tap->status = STATUS_HOLD_TIMER;
-        return;
-    case HT_QUICK_TAP:
-        hold_tap->status = STATUS_TAP;
-        return;
-    default:
-        return;
-    }
+    hold_tap->position = ZMK_BHV_HOLD_TAP_POSITION_NOT_USED;
+    hold_tap->status = STATUS_UNDECIDED;
 }
 
+static const uint8_t flavor_decisions[][HT_DECISION_MOMENT_COUNT] = {
+    [FLAVOR_HOLD_PREFERRED] =
+        {
+            [HT_KEY_UP] = STATUS_TAP,
+            [HT_OTHER_KEY_DOWN] = STATUS_HOLD_INTERRUPT,
+            [HT_TIMER_EVENT] = STATUS_HOLD_TIMER,
+            [HT_QUICK_TAP] = STATUS_TAP,
+        },
+    [FLAVOR_BALANCED] =
+        {
+            [HT_KEY_UP] = STATUS_TAP,
+            [HT_OTHER_KEY_UP] = STATUS_HOLD_INTERRUPT,
+            [HT_TIMER_EVENT] = STATUS_HOLD_TIMER,
+            [HT_QUICK_TAP] = STATUS_TAP,
+        },
+    [FLAVOR_TAP_PREFERRED] =
+        {
+            [HT_KEY_UP] = STATUS_TAP,
+            [HT_TIMER_EVENT] = STATUS_HOLD_TIMER,
+            [HT_QUICK_TAP] = STATUS_TAP,
+        },
+    [FLAVOR_TAP_UNLESS_INTERRUPTED] =
+        {
+            [HT_KEY_UP] = STATUS_TAP,
+            [HT_OTHER_KEY_DOWN] = STATUS_HOLD_INTERRUPT,
+            [HT_TIMER_EVENT] = STATUS_TAP,
+            [HT_QUICK_TAP] = STATUS_TAP,
+        },
+};
+
+BUILD_ASSERT(STATUS_UNDECIDED == 0, "Unlisted decision moments must leave hold-taps undecided");
+
 static inline const char *flavor_str(enum flavor flavor) {
     switch (flavor) {
     case FLAVOR_HOLD_PREFERRED:
@@ -493,13 +463,11 @@ static int release_binding(struct active_hold_tap *hold_tap) {
 }
 
 static bool is_first_other_key_pressed_trigger_key(struct active_hold_tap *hold_tap) {
-    for (int i = 0; i < hold_tap->config->hold_trigger_key_positions_len; i++) {
-        if (hold_tap->config->hold_trigger_key_positions[i] ==
-            hold_tap->position_of_first_other_key_pressed) {
-            return true;
-        }
-    }
-    return false;
+    int32_t position = hold_tap->position_of_first_other_key_pressed;
+
+    return position >= 0 && position < ZMK_KEYMAP_LEN &&
+           sys_bitfield_test_bit((mem_addr_t)hold_tap->config->hold_trigger_key_positions_mask,
+                                 position);
 }
 
 // Force a tap decision if the positional conditions for a hold decision are not met.
@@ -531,7 +499,7 @@ static void decide_hold_tap(struct active_hold_tap *hold_tap,
         return;
     }
 
-    if (hold_tap != undecided_hold_tap) {
+    if (hold_tap != STATE->undecided_hold_tap) {
         LOG_DBG("ERROR found undecided tap hold that is not the active tap hold");
         return;
     }
@@ -543,20 +511,7 @@ static void decide_hold_tap(struct active_hold_tap *hold_tap,
     }
 
     // If the hold-tap behavior is still undecided, attempt to decide it.
-    switch (hold_tap->config->flavor) {
-    case FLAVOR_HOLD_PREFERRED:
-        decide_hold_preferred(hold_tap, decision_moment);
-        break;
-    case FLAVOR_BALANCED:
-        decide_balanced(hold_tap, decision_moment);
-        break;
-    case FLAVOR_TAP_PREFERRED:
-        decide_tap_preferred(hold_tap, decision_moment);
-        break;
-    case FLAVOR_TAP_UNLESS_INTERRUPTED:
-        decide_tap_unless_interrupted(hold_tap, decision_moment);
-        break;
-    }
+    hold_tap->status = hold_tap->config->decisions[decision_moment];
 
     if (hold_tap->status == STATUS_UNDECIDED) {
         return;
@@ -569,7 +524,10 @@ static void decide_hold_tap(struct active_hold_tap *hold_tap,
     LOG_DBG("%d decided %s (%s decision moment %s)", hold_tap->position,
             status_str(hold_tap->status), flavor_str(hold_tap->config->flavor),
             decision_moment_str(decision_moment));
-    undecided_hold_tap = NULL;
+    zmk_key_stats_hold_tap(hold_tap->position, hold_tap->status == STATUS_TAP
+                                                   ? ZMK_KEY_STATS_HOLD_TAP_TAP
+                                                   : ZMK_KEY_STATS_HOLD_TAP_HOLD);
+    STATE->undecided_hold_tap = NULL;
     press_binding(hold_tap);
     release_captured_events();
 }
@@ -581,6 +539,7 @@ static void decide_retro_tap(struct active_hold_tap *hold_tap) {
     if (hold_tap->status == STATUS_HOLD_TIMER) {
         release_binding(hold_tap);
         LOG_DBG("%d retro tap", hold_tap->position);
+        zmk_key_stats_hold_tap(hold_tap->position, ZMK_KEY_STATS_HOLD_TAP_RETRO_TAP);
         hold_tap->status = STATUS_TAP;
         press_binding(hold_tap);
         return;
@@ -589,7 +548,7 @@ static void decide_retro_tap(struct active_hold_tap *hold_tap) {
 
 static void update_hold_status_for_retro_tap(uint32_t ignore_position) {
     for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_HELD; i++) {
-        struct active_hold_tap *hold_tap = &active_hold_taps[i];
+        struct active_hold_tap *hold_tap = &STATE->active_hold_taps[i];
         if (hold_tap->position == ignore_position ||
             hold_tap->position == ZMK_BHV_HOLD_TAP_POSITION_NOT_USED ||
             hold_tap->config->retro_tap == false) {
@@ -605,10 +564,10 @@ static void update_hold_status_for_retro_tap(uint32_t ignore_position) {
 
 static int on_hold_tap_binding_pressed(struct zmk_behavior_binding *binding,
                                        struct zmk_behavior_binding_event event) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
     const struct behavior_hold_tap_config *cfg = dev->config;
 
-    if (undecided_hold_tap != NULL) {
+    if (STATE->undecided_hold_tap != NULL) {
         LOG_DBG("ERROR another hold-tap behavior is undecided.");
         // if this happens, make sure the behavior events occur AFTER other position events.
         return ZMK_BEHAVIOR_OPAQUE;
@@ -624,7 +583,7 @@ static int on_hold_tap_binding_pressed(struct zmk_behavior_binding *binding,
     }
 
     LOG_DBG("%d new undecided hold_tap", event.position);
-    undecided_hold_tap = hold_tap;
+    STATE->undecided_hold_tap = hold_tap;
 
     if (is_quick_tap(hold_tap)) {
         decide_hold_tap(hold_tap, HT_QUICK_TAP);
@@ -632,10 +591,9 @@ static int on_hold_tap_binding_pressed(struct zmk_behavior_binding *binding,
 
     decide_hold_tap(hold_tap, HT_KEY_DOWN);
 
-    // if this behavior was queued we have to adjust the timer to only
-    // wait for the remaining time.
-    int32_t tapping_term_ms_left = (hold_tap->timestamp + cfg->tapping_term_ms) - k_uptime_get();
-    k_work_schedule(&hold_tap->work, K_MSEC(tapping_term_ms_left));
+    // the deadline is absolute, so if this behavior was queued the timer
+    // only waits for the remaining time.
+    zmk_behavior_timer_start(&hold_tap->timer, hold_tap->timestamp + cfg->tapping_term_ms);
 
     return ZMK_BEHAVIOR_OPAQUE;
 }
@@ -650,7 +608,7 @@ static int on_hold_tap_binding_released(struct zmk_behavior_binding *binding,
 
     // If these events were queued, the timer event may be queued too late or not at all.
     // We insert a timer event before the TH_KEY_UP event to verify.
-    int work_cancel_result = k_work_cancel_delayable(&hold_tap->work);
+    zmk_behavior_timer_cancel(&hold_tap->timer);
     if (event.timestamp > (hold_tap->timestamp + hold_tap->config->tapping_term_ms)) {
         decide_hold_tap(hold_tap, HT_TIMER_EVENT);
     }
@@ -663,15 +621,8 @@ static int on_hold_tap_binding_released(struct zmk_behavior_binding *binding,
         release_hold_binding(hold_tap);
     }
 
-    if (work_cancel_result == -EINPROGRESS) {
-        // let the timer handler clean up
-        // if we'd clear now, the timer may call back for an uninitialized active_hold_tap.
-        LOG_DBG("%d hold-tap timer work in event queue", event.position);
-        hold_tap->work_is_cancelled = true;
-    } else {
-        LOG_DBG("%d cleaning up hold-tap", event.position);
-        clear_hold_tap(hold_tap);
-    }
+    LOG_DBG("%d cleaning up hold-tap", event.position);
+    clear_hold_tap(hold_tap);
 
     return ZMK_BEHAVIOR_OPAQUE;
 }
@@ -729,27 +680,28 @@ static int position_state_changed_listener(const zmk_event_t *eh) {
 
     update_hold_status_for_retro_tap(ev->position);
 
-    if (undecided_hold_tap == NULL) {
+    if (STATE->undecided_hold_tap == NULL) {
         LOG_DBG("%d bubble (no undecided hold_tap active)", ev->position);
         return ZMK_EV_EVENT_BUBBLE;
     }
 
     // Store the position of pressed key for positional hold-tap purposes.
-    if ((undecided_hold_tap->config->hold_trigger_on_release !=
+    if ((STATE->undecided_hold_tap->config->hold_trigger_on_release !=
          ev->state) // key has been pressed and hold_trigger_on_release is not set, or key
                     // has been released and hold_trigger_on_release is set
-        && (undecided_hold_tap->position_of_first_other_key_pressed ==
+        && (STATE->undecided_hold_tap->position_of_first_other_key_pressed ==
             -1) // no other key has been pressed yet
     ) {
-        undecided_hold_tap->position_of_first_other_key_pressed = ev->position;
+        STATE->undecided_hold_tap->position_of_first_other_key_pressed = ev->position;
     }
 
-    if (undecided_hold_tap->position == ev->position) {
+    if (STATE->undecided_hold_tap->position == ev->position) {
         if (ev->state) { // keydown
             LOG_ERR("hold-tap listener should be called before before most other listeners!");
             return ZMK_EV_EVENT_BUBBLE;
         } else { // keyup
-            LOG_DBG("%d bubble undecided hold-tap keyrelease event", undecided_hold_tap->position);
+            LOG_DBG("%d bubble undecided hold-tap keyrelease event",
+                    STATE->undecided_hold_tap->position);
             return ZMK_EV_EVENT_BUBBLE;
         }
     }
@@ -757,31 +709,30 @@ static int position_state_changed_listener(const zmk_event_t *eh) {
     // If these events were queued, the timer event may be queued too late or not at all.
     // We make a timer decision before the other key events are handled if the timer would
     // have run out.
-    if (ev->timestamp >
-        (undecided_hold_tap->timestamp + undecided_hold_tap->config->tapping_term_ms)) {
-        decide_hold_tap(undecided_hold_tap, HT_TIMER_EVENT);
+    if (ev->timestamp > (STATE->undecided_hold_tap->timestamp +
+                         STATE->undecided_hold_tap->config->tapping_term_ms)) {
+        decide_hold_tap(STATE->undecided_hold_tap, HT_TIMER_EVENT);
     }
 
-    if (undecided_hold_tap == NULL) {
+    if (STATE->undecided_hold_tap == NULL) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
     if (!ev->state && !have_captured_keydown_event(ev->position)) {
         // no keydown event has been captured, let it bubble.
         // we'll catch modifiers later in modifier_state_changed_listener
-        LOG_DBG("%d bubbling %d %s event", undecided_hold_tap->position, ev->position,
+        LOG_DBG("%d bubbling %d %s event", STATE->undecided_hold_tap->position, ev->position,
                 ev->state ? "down" : "up");
         return ZMK_EV_EVENT_BUBBLE;
     }
 
-    LOG_DBG("%d capturing %d %s event", undecided_hold_tap->position, ev->position,
+    LOG_DBG("%d capturing %d %s event", STATE->undecided_hold_tap->position, ev->position,
             ev->state ? "down" : "up");
-    struct captured_event capture = {
-        .tag = ET_POS_CHANGED,
-        .data = {.position = copy_raised_zmk_position_state_changed(ev)},
-    };
-    capture_event(&capture);
-    decide_hold_tap(undecided_hold_tap, ev->state ? HT_OTHER_KEY_DOWN : HT_OTHER_KEY_UP);
+    if (capture_event(capture_zmk_position_state_changed(ev)) == 0 && ev->state &&
+        ev->position < ZMK_KEYMAP_LEN) {
+        STATE->captured_keydowns[ev->position]++;
+    }
+    decide_hold_tap(STATE->undecided_hold_tap, ev->state ? HT_OTHER_KEY_DOWN : HT_OTHER_KEY_UP);
     return ZMK_EV_EVENT_CAPTURED;
 }
 
@@ -793,7 +744,7 @@ static int keycode_state_changed_listener(const zmk_event_t *eh) {
         store_last_tapped(ev->timestamp);
     }
 
-    if (undecided_hold_tap == NULL) {
+    if (STATE->undecided_hold_tap == NULL) {
         // LOG_DBG("0x%02X bubble (no undecided hold_tap active)", ev->keycode);
         return ZMK_EV_EVENT_BUBBLE;
     }
@@ -803,19 +754,28 @@ static int keycode_state_changed_listener(const zmk_event_t *eh) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
+    // As for position events, a mod from after the tapping term is only handled once the timer
+    // decision it would have followed has been made.
+    if (ev->timestamp > (STATE->undecided_hold_tap->timestamp +
+                         STATE->undecided_hold_tap->config->tapping_term_ms)) {
+        decide_hold_tap(STATE->undecided_hold_tap, HT_TIMER_EVENT);
+    }
+
+    if (STATE->undecided_hold_tap == NULL) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
     // hold-while-undecided can produce a mod, but we don't want to capture it.
-    if (undecided_hold_tap->config->hold_while_undecided &&
-        undecided_hold_tap->status == STATUS_UNDECIDED) {
+    if (STATE->undecided_hold_tap->config->hold_while_undecided &&
+        STATE->undecided_hold_tap->status == STATUS_UNDECIDED) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
     // only key-up events will bubble through position_state_changed_listener
     // if a undecided_hold_tap is active.
-    LOG_DBG("%d capturing 0x%02X %s event", undecided_hold_tap->position, ev->keycode,
+    LOG_DBG("%d capturing 0x%02X %s event", STATE->undecided_hold_tap->position, ev->keycode,
             ev->state ? "down" : "up");
-    struct captured_event capture = {
-        .tag = ET_CODE_CHANGED, .data = {.keycode = copy_raised_zmk_keycode_state_changed(ev)}};
-    capture_event(&capture);
+    capture_event(capture_zmk_keycode_state_changed(ev));
     return ZMK_EV_EVENT_CAPTURED;
 }
 
@@ -833,31 +793,52 @@ ZMK_SUBSCRIPTION(behavior_hold_tap, zmk_position_state_changed);
 // this should be modifiers_state_changed, but unfrotunately that's not implemented yet.
 ZMK_SUBSCRIPTION(behavior_hold_tap, zmk_keycode_state_changed);
 
-void behavior_hold_tap_timer_work_handler(struct k_work *item) {
-    struct k_work_delayable *d_work = k_work_delayable_from_work(item);
-    struct active_hold_tap *hold_tap = CONTAINER_OF(d_work, struct active_hold_tap, work);
+void behavior_hold_tap_timer_handler(struct zmk_behavior_timer *timer) {
+    struct active_hold_tap *hold_tap = CONTAINER_OF(timer, struct active_hold_tap, timer);
 
-    if (hold_tap->work_is_cancelled) {
-        clear_hold_tap(hold_tap);
-    } else {
-        decide_hold_tap(hold_tap, HT_TIMER_EVENT);
-    }
+    decide_hold_tap(hold_tap, HT_TIMER_EVENT);
 }
 
 static int behavior_hold_tap_init(const struct device *dev) {
     static bool init_first_run = true;
+    const struct behavior_hold_tap_config *cfg = dev->config;
+
+    for (int i = 0; i < cfg->hold_trigger_key_positions_len; i++) {
+        int32_t position = cfg->hold_trigger_key_positions[i];
+        if (position < 0 || position >= ZMK_KEYMAP_LEN) {
+            LOG_WRN("Ignoring hold-trigger-key-position %d outside of the keymap", position);
+            continue;
+        }
+        sys_bitfield_set_bit((mem_addr_t)cfg->hold_trigger_key_positions_mask, position);
+    }
 
     if (init_first_run) {
-        for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_HELD; i++) {
-            k_work_init_delayable(&active_hold_taps[i].work, behavior_hold_tap_timer_work_handler);
-            active_hold_taps[i].position = ZMK_BHV_HOLD_TAP_POSITION_NOT_USED;
+        struct hold_tap_state *state;
+
+        ZMK_CONTEXT_STATE_FOREACH(hold_tap_states, state) {
+            memset(state->hold_tap_slots, HOLD_TAP_SLOT_NONE, sizeof(state->hold_tap_slots));
+            // Pushed in reverse, so the lowest entries are used first.
+            for (int i = ZMK_BHV_HOLD_TAP_MAX_HELD - 1; i >= 0; i--) {
+                zmk_behavior_timer_init(&state->active_hold_taps[i].timer,
+                                        behavior_hold_tap_timer_handler);
+                state->active_hold_taps[i].position = ZMK_BHV_HOLD_TAP_POSITION_NOT_USED;
+                state->free_hold_tap_slots[state->free_hold_tap_slots_len++] = i;
+            }
         }
     }
     init_first_run = false;
     return 0;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_FUZZ) || IS_ENABLED(CONFIG_ZMK_CHECKPOINT)
+bool zmk_behavior_hold_tap_idle(void) {
+    return STATE->undecided_hold_tap == NULL && STATE->captured_events_len == 0 &&
+           STATE->free_hold_tap_slots_len == ZMK_BHV_HOLD_TAP_MAX_HELD;
+}
+#endif // IS_ENABLED(CONFIG_ZMK_FUZZ) || IS_ENABLED(CONFIG_ZMK_CHECKPOINT)
+
 #define KP_INST(n)                                                                                 \
+    static uint32_t behavior_hold_tap_trigger_mask_##n[HOLD_TRIGGER_MASK_LEN];                     \
     static const struct behavior_hold_tap_config behavior_hold_tap_config_##n = {                  \
         .tapping_term_ms = DT_INST_PROP(n, tapping_term_ms),                                       \
         .hold_behavior_dev = DEVICE_DT_NAME(DT_INST_PHANDLE_BY_IDX(n, bindings, 0)),               \
@@ -867,10 +848,12 @@ static int behavior_hold_tap_init(const struct device *dev) {
                                      ? DT_INST_PROP(n, quick_tap_ms)                               \
                                      : DT_INST_PROP(n, require_prior_idle_ms),                     \
         .flavor = DT_ENUM_IDX(DT_DRV_INST(n), flavor),                                             \
+        .decisions = flavor_decisions[DT_ENUM_IDX(DT_DRV_INST(n), flavor)],                        \
         .hold_while_undecided = DT_INST_PROP(n, hold_while_undecided),                             \
         .hold_while_undecided_linger = DT_INST_PROP(n, hold_while_undecided_linger),               \
         .retro_tap = DT_INST_PROP(n, retro_tap),                                                   \
         .hold_trigger_on_release = DT_INST_PROP(n, hold_trigger_on_release),                       \
+        .hold_trigger_key_positions_mask = behavior_hold_tap_trigger_mask_##n,                     \
         .hold_trigger_key_positions = DT_INST_PROP(n, hold_trigger_key_positions),                 \
         .hold_trigger_key_positions_len = DT_INST_PROP_LEN(n, hold_trigger_key_positions),         \
     };                                                                                             \
@@ -13,6 +13,8 @@
 #include <zephyr/sys/util.h> // CLAMP
 
 #include <zmk/behavior.h>
+#include <zmk/endpoints.h>
+#include <zmk/workqueue.h>
 #include <dt-bindings/zmk/pointing.h>
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
@@ -22,12 +24,31 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 struct vector2d {
-    float x;
-    float y;
+    int16_t x;
+    int16_t y;
 };
 
+// Movement per tick is speed * (t >> time_shift)^exponent * trigger_period_ms / denominator, with
+// t the milliseconds since the movement started, up to time_to_max_speed_ms. Everything is
+// integer math, and the part of a count that isn't reported yet is carried over exactly.
+struct motion_curve {
+    int64_t denominator;
+    // (time_to_max_speed_ms >> time_shift)^exponent, the factor at full speed
+    int64_t full_scale;
+    uint16_t max_time;
+    uint8_t time_shift;
+    uint8_t exponent;
+};
+
+// Keeps speed * full_scale * trigger_period_ms, plus a remainder, well inside 64 bits.
+#define MOTION_CURVE_MAX_SCALE (1LL << 38)
+
+static const struct motion_curve uniform_curve = {.denominator = 1000, .full_scale = 1};
+
 struct movement_state_1d {
-    float remainder;
+    // movement not reported yet, in units of 1 / curve->denominator
+    int64_t remainder;
+    const struct motion_curve *curve;
     int16_t speed;
     int64_t start_time;
 };
@@ -38,9 +59,11 @@ struct movement_state_2d {
 };
 
 struct behavior_input_two_axis_data {
-    struct k_work_delayable tick_work;
     const struct device *dev;
+    // uptime in ticks of the next tick of this instance, 0 while it isn't moving
+    int64_t next_tick;
 
+    struct motion_curve curve;
     struct movement_state_2d state;
 };
 
@@ -56,18 +79,34 @@ struct behavior_input_two_axis_config {
     uint8_t acceleration_exponent;
 };
 
-#if CONFIG_MINIMAL_LIBC
-static float powf(float base, float exponent) {
-    // poor man's power implementation rounds the exponent down to the nearest integer.
-    float power = 1.0f;
-    for (; exponent >= 1.0f; exponent--) {
-        power = power * base;
+static void motion_curve_init(struct motion_curve *curve, uint16_t time_to_max_speed_ms,
+                              uint8_t exponent) {
+    if (time_to_max_speed_ms == 0 || exponent == 0) {
+        *curve = uniform_curve;
+        return;
+    }
+
+    // Steep curves over long times are computed with coarser time steps to fit.
+    for (uint8_t shift = 0;; shift++) {
+        uint16_t max_time = MAX(time_to_max_speed_ms >> shift, 1);
+        int64_t full_scale = 1;
+
+        for (int i = 0; i < exponent && full_scale <= MOTION_CURVE_MAX_SCALE; i++) {
+            full_scale *= max_time;
+        }
+
+        if (full_scale <= MOTION_CURVE_MAX_SCALE || max_time == 1) {
+            *curve = (struct motion_curve){
+                .denominator = full_scale * 1000,
+                .full_scale = full_scale,
+                .max_time = max_time,
+                .time_shift = shift,
+                .exponent = exponent,
+            };
+            return;
+        }
     }
-    return power;
 }
-#else
-#include <math.h>
-#endif
 
 static int64_t ticks_since_start(int64_t start, int64_t now, int64_t delay) {
     if (start == 0) {
@@ -83,86 +122,90 @@ static int64_t ticks_since_start(int64_t start, int64_t now, int64_t delay) {
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 
-static uint8_t get_acceleration_exponent(const struct behavior_input_two_axis_config *config,
-                                         uint16_t code) {
+static const struct motion_curve *get_curve(const struct behavior_input_two_axis_data *data,
+                                            uint16_t code) {
     switch (code) {
     case INPUT_REL_WHEEL:
         return (zmk_pointing_resolution_multipliers_get_current_profile().wheel > 0)
-                   ? 0
-                   : config->acceleration_exponent;
+                   ? &uniform_curve
+                   : &data->curve;
     case INPUT_REL_HWHEEL:
         return (zmk_pointing_resolution_multipliers_get_current_profile().hor_wheel > 0)
-                   ? 0
-                   : config->acceleration_exponent;
+                   ? &uniform_curve
+                   : &data->curve;
     default:
-        return config->acceleration_exponent;
+        return &data->curve;
     }
 }
 
 #else
 
-static inline uint8_t get_acceleration_exponent(const struct behavior_input_two_axis_config *config,
-                                                uint16_t code) {
-    return config->acceleration_exponent;
+static inline const struct motion_curve *
+get_curve(const struct behavior_input_two_axis_data *data, uint16_t code) {
+    return &data->curve;
 }
 
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 
-static float speed(const struct behavior_input_two_axis_config *config, uint16_t code,
-                   float max_speed, int64_t duration_ticks) {
-    uint8_t accel_exp = get_acceleration_exponent(config, code);
-
-    if ((1000 * duration_ticks / CONFIG_SYS_CLOCK_TICKS_PER_SEC) > config->time_to_max_speed_ms ||
-        config->time_to_max_speed_ms == 0 || accel_exp == 0) {
-        return max_speed;
+// Calculate the speed based on MouseKeysAccel, as a factor of the full speed.
+// See https://en.wikipedia.org/wiki/Mouse_keys
+static int64_t speed_scale(const struct motion_curve *curve, int64_t duration_ticks) {
+    if (curve->exponent == 0) {
+        return curve->full_scale;
     }
 
-    // Calculate the speed based on MouseKeysAccel
-    // See https://en.wikipedia.org/wiki/Mouse_keys
-    if (duration_ticks == 0) {
-        return 0;
+    // Curves end within UINT16_MAX ms, so any longer duration is at full speed. Capping it keeps
+    // the conversion to milliseconds from overflowing, however long the key is held.
+    duration_ticks = MIN(duration_ticks, k_ms_to_ticks_ceil64(UINT16_MAX + 1));
+
+    int64_t t = (1000 * duration_ticks / CONFIG_SYS_CLOCK_TICKS_PER_SEC) >> curve->time_shift;
+    if (t >= curve->max_time) {
+        return curve->full_scale;
     }
 
-    float time_fraction = (float)(1000 * duration_ticks / CONFIG_SYS_CLOCK_TICKS_PER_SEC) /
-                          config->time_to_max_speed_ms;
-    return max_speed * powf(time_fraction, accel_exp);
-}
+    int64_t scale = 1;
+    for (int i = 0; i < curve->exponent; i++) {
+        scale *= t;
+    }
 
-static void track_remainder(float *move, float *remainder) {
-    float new_move = *move + *remainder;
-    *remainder = new_move - (int)new_move;
-    *move = (int)new_move;
+    return scale;
 }
 
-static float update_movement_1d(const struct behavior_input_two_axis_config *config, uint16_t code,
-                                struct movement_state_1d *state, int64_t now) {
-    float move = 0;
+static int16_t update_movement_1d(const struct behavior_input_two_axis_config *config,
+                                  const struct motion_curve *curve,
+                                  struct movement_state_1d *state, int64_t now) {
     if (state->speed == 0) {
         state->remainder = 0;
-        return move;
+        return 0;
+    }
+
+    if (state->curve != curve) {
+        state->curve = curve;
+        state->remainder = 0;
     }
 
     int64_t move_duration = ticks_since_start(state->start_time, now, config->delay_ms);
-    LOG_DBG("Calculated speed: %f", (double)speed(config, code, state->speed, move_duration));
-    move =
-        (move_duration > 0)
-            ? (speed(config, code, state->speed, move_duration) * config->trigger_period_ms / 1000)
-            : 0;
+    if (move_duration == 0) {
+        return 0;
+    }
+
+    int64_t move = state->speed * speed_scale(curve, move_duration) * config->trigger_period_ms +
+                   state->remainder;
+    int64_t counts = move / curve->denominator;
+    state->remainder = move - counts * curve->denominator;
 
-    track_remainder(&(move), &(state->remainder));
+    LOG_DBG("Calculated move: %lld", (long long)counts);
 
-    return move;
+    return (int16_t)CLAMP(counts, INT16_MIN, INT16_MAX);
 }
-static struct vector2d update_movement_2d(const struct behavior_input_two_axis_config *config,
-                                          struct movement_state_2d *state, int64_t now) {
-    struct vector2d move = {0};
 
-    move = (struct vector2d){
-        .x = update_movement_1d(config, config->x_code, &state->x, now),
-        .y = update_movement_1d(config, config->y_code, &state->y, now),
+static struct vector2d update_movement_2d(const struct behavior_input_two_axis_config *config,
+                                          struct behavior_input_two_axis_data *data,
+                                          int64_t now) {
+    return (struct vector2d){
+        .x = update_movement_1d(config, get_curve(data, config->x_code), &data->state.x, now),
+        .y = update_movement_1d(config, get_curve(data, config->y_code), &data->state.y, now),
     };
-
-    return move;
 }
 
 static bool is_non_zero_1d_movement(int16_t speed) { return speed != 0; }
@@ -175,35 +218,79 @@ static bool should_be_working(struct behavior_input_two_axis_data *data) {
     return is_non_zero_2d_movement(&data->state);
 }
 
-static void tick_work_cb(struct k_work *work) {
-    struct k_work_delayable *d_work = k_work_delayable_from_work(work);
-    struct behavior_input_two_axis_data *data =
-        CONTAINER_OF(d_work, struct behavior_input_two_axis_data, tick_work);
-    const struct device *dev = data->dev;
-    const struct behavior_input_two_axis_config *cfg = dev->config;
+// All moving instances share one tick, so motion from several of them, like moving and scrolling
+// at the same time, is reported together as one mouse report.
+static struct behavior_input_two_axis_data *instances[DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT)];
+static size_t instances_len;
 
-    uint64_t timestamp = k_uptime_ticks();
+static void tick_work_cb(struct k_work *work);
 
-    // LOG_INF("x start: %llu, y start: %llu, current timestamp: %llu", data->state.x.start_time,
-    //         data->state.y.start_time, timestamp);
+// Like a relative timeout, waits one tick more to be sure the full period has passed.
+static int64_t tick_after_period(int64_t now, const struct behavior_input_two_axis_config *cfg) {
+    return now + k_ms_to_ticks_ceil64(cfg->trigger_period_ms) + 1;
+}
+
+static K_WORK_DELAYABLE_DEFINE(tick_work, tick_work_cb);
 
-    struct vector2d move = update_movement_2d(cfg, &data->state, timestamp);
+static void schedule_tick(void) {
+    int64_t next_tick = 0;
 
-    int ret = 0;
-    bool have_x = is_non_zero_1d_movement(move.x);
-    bool have_y = is_non_zero_1d_movement(move.y);
-    if (have_x) {
-        ret = input_report_rel(dev, cfg->x_code, (int16_t)CLAMP(move.x, INT16_MIN, INT16_MAX),
-                               !have_y, K_NO_WAIT);
+    for (size_t i = 0; i < instances_len; i++) {
+        if (instances[i]->next_tick != 0 &&
+            (next_tick == 0 || instances[i]->next_tick < next_tick)) {
+            next_tick = instances[i]->next_tick;
+        }
     }
-    if (have_y) {
-        ret = input_report_rel(dev, cfg->y_code, (int16_t)CLAMP(move.y, INT16_MIN, INT16_MAX), true,
-                               K_NO_WAIT);
+
+    if (next_tick == 0) {
+        k_work_cancel_delayable(&tick_work);
+    } else {
+        k_work_reschedule_for_queue(zmk_workqueue_input_work_q(), &tick_work,
+                                    K_TIMEOUT_ABS_TICKS(next_tick));
     }
+}
 
-    if (should_be_working(data)) {
-        k_work_schedule(&data->tick_work, K_MSEC(cfg->trigger_period_ms));
+static void tick_work_cb(struct k_work *work) {
+    int64_t timestamp = k_uptime_ticks();
+    const struct device *devs[ARRAY_SIZE(instances)];
+    struct vector2d moves[ARRAY_SIZE(instances)];
+    size_t moving = 0;
+
+    for (size_t i = 0; i < instances_len; i++) {
+        struct behavior_input_two_axis_data *data = instances[i];
+        const struct behavior_input_two_axis_config *cfg = data->dev->config;
+
+        if (data->next_tick == 0 || data->next_tick > timestamp) {
+            continue;
+        }
+
+        struct vector2d move = update_movement_2d(cfg, data, timestamp);
+        data->next_tick = tick_after_period(timestamp, cfg);
+
+        if (is_non_zero_1d_movement(move.x) || is_non_zero_1d_movement(move.y)) {
+            devs[moving] = data->dev;
+            moves[moving++] = move;
+        }
     }
+
+    if (moving > 1) {
+        zmk_endpoint_merge_mouse_reports(moving - 1);
+    }
+
+    for (size_t i = 0; i < moving; i++) {
+        const struct behavior_input_two_axis_config *cfg = devs[i]->config;
+        bool have_x = is_non_zero_1d_movement(moves[i].x);
+        bool have_y = is_non_zero_1d_movement(moves[i].y);
+
+        if (have_x) {
+            input_report_rel(devs[i], cfg->x_code, moves[i].x, !have_y, K_NO_WAIT);
+        }
+        if (have_y) {
+            input_report_rel(devs[i], cfg->y_code, moves[i].y, true, K_NO_WAIT);
+        }
+    }
+
+    schedule_tick();
 }
 
 static void set_start_times_for_activity_1d(struct movement_state_1d *state) {
@@ -218,6 +305,24 @@ static void set_start_times_for_activity(struct movement_state_2d *state) {
     set_start_times_for_activity_1d(&state->y);
 }
 
+// An instance that starts moving while others are joins their next tick, if it comes within its
+// own period, rather than getting a tick of its own.
+static int64_t first_tick(const struct behavior_input_two_axis_data *data,
+                          const struct behavior_input_two_axis_config *cfg) {
+    int64_t first = tick_after_period(k_uptime_ticks(), cfg);
+    int64_t joined = 0;
+
+    for (size_t i = 0; i < instances_len; i++) {
+        if (instances[i] != data && instances[i]->next_tick != 0 &&
+            instances[i]->next_tick <= first &&
+            (joined == 0 || instances[i]->next_tick < joined)) {
+            joined = instances[i]->next_tick;
+        }
+    }
+
+    return joined != 0 ? joined : first;
+}
+
 static void update_work_scheduling(const struct device *dev) {
     struct behavior_input_two_axis_data *data = dev->data;
     const struct behavior_input_two_axis_config *cfg = dev->config;
@@ -225,12 +330,16 @@ static void update_work_scheduling(const struct device *dev) {
     set_start_times_for_activity(&data->state);
 
     if (should_be_working(data)) {
-        k_work_schedule(&data->tick_work, K_MSEC(cfg->trigger_period_ms));
+        if (data->next_tick == 0) {
+            data->next_tick = first_tick(data, cfg);
+        }
     } else {
-        k_work_cancel_delayable(&data->tick_work);
+        data->next_tick = 0;
         data->state.y.remainder = 0;
         data->state.x.remainder = 0;
     }
+
+    schedule_tick();
 }
 
 int behavior_input_two_axis_adjust_speed(const struct device *dev, int16_t dx, int16_t dy) {
@@ -249,9 +358,11 @@ int behavior_input_two_axis_adjust_speed(const struct device *dev, int16_t dx, i
 
 static int behavior_input_two_axis_init(const struct device *dev) {
     struct behavior_input_two_axis_data *data = dev->data;
+    const struct behavior_input_two_axis_config *cfg = dev->config;
 
     data->dev = dev;
-    k_work_init_delayable(&data->tick_work, tick_work_cb);
+    motion_curve_init(&data->curve, cfg->time_to_max_speed_ms, cfg->acceleration_exponent);
+    instances[instances_len++] = data;
 
     return 0;
 };
@@ -259,7 +370,7 @@ static int behavior_input_two_axis_init(const struct device *dev) {
 static int on_keymap_binding_pressed(struct zmk_behavior_binding *binding,
                                      struct zmk_behavior_binding_event event) {
 
-    const struct device *behavior_dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *behavior_dev = zmk_behavior_binding_get_device(binding);
 
     LOG_DBG("position %d keycode 0x%02X", event.position, binding->param1);
 
@@ -272,7 +383,7 @@ static int on_keymap_binding_pressed(struct zmk_behavior_binding *binding,
 
 static int on_keymap_binding_released(struct zmk_behavior_binding *binding,
                                       struct zmk_behavior_binding_event event) {
-    const struct device *behavior_dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *behavior_dev = zmk_behavior_binding_get_device(binding);
 
     LOG_DBG("position %d keycode 0x%02X", event.position, binding->param1);
 
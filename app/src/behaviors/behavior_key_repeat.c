@@ -19,8 +19,12 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
 
+// Pages below this, such as the keyboard and consumer pages, are looked up in a bitmap
+#define USAGE_PAGES_MASK_LEN 32
+
 struct behavior_key_repeat_config {
     uint8_t index;
+    uint32_t usage_pages_mask;
     uint8_t usage_pages_count;
     uint16_t usage_pages[];
 };
@@ -32,7 +36,7 @@ struct behavior_key_repeat_data {
 
 static int on_key_repeat_binding_pressed(struct zmk_behavior_binding *binding,
                                          struct zmk_behavior_binding_event event) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
     struct behavior_key_repeat_data *data = dev->data;
 
     if (data->last_keycode_pressed.usage_page == 0) {
@@ -50,7 +54,7 @@ static int on_key_repeat_binding_pressed(struct zmk_behavior_binding *binding,
 
 static int on_key_repeat_binding_released(struct zmk_behavior_binding *binding,
                                           struct zmk_behavior_binding_event event) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
     struct behavior_key_repeat_data *data = dev->data;
 
     if (data->current_keycode_pressed.usage_page == 0) {
@@ -80,6 +84,21 @@ ZMK_SUBSCRIPTION(behavior_key_repeat, zmk_keycode_state_changed);
 #define GET_DEV(inst) DEVICE_DT_INST_GET(inst),
 static const struct device *devs[] = {DT_INST_FOREACH_STATUS_OKAY(GET_DEV)};
 
+static bool key_repeat_usage_page_included(const struct behavior_key_repeat_config *config,
+                                           uint16_t usage_page) {
+    if (usage_page < USAGE_PAGES_MASK_LEN) {
+        return (config->usage_pages_mask & BIT(usage_page)) != 0U;
+    }
+
+    for (int u = 0; u < config->usage_pages_count; u++) {
+        if (config->usage_pages[u] == usage_page) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 static int key_repeat_keycode_state_changed_listener(const zmk_event_t *eh) {
     struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
     if (ev == NULL || !ev->state) {
@@ -92,21 +111,24 @@ static int key_repeat_keycode_state_changed_listener(const zmk_event_t *eh) {
         struct behavior_key_repeat_data *data = dev->data;
         const struct behavior_key_repeat_config *config = dev->config;
 
-        for (int u = 0; u < config->usage_pages_count; u++) {
-            if (config->usage_pages[u] == ev->usage_page) {
-                memcpy(&data->last_keycode_pressed, ev, sizeof(struct zmk_keycode_state_changed));
-                data->last_keycode_pressed.implicit_modifiers |= zmk_hid_get_explicit_mods();
-                break;
-            }
+        if (key_repeat_usage_page_included(config, ev->usage_page)) {
+            memcpy(&data->last_keycode_pressed, ev, sizeof(struct zmk_keycode_state_changed));
+            data->last_keycode_pressed.implicit_modifiers |= zmk_hid_get_explicit_mods();
         }
     }
 
     return ZMK_EV_EVENT_BUBBLE;
 }
 
+#define USAGE_PAGE_BIT(node_id, prop, idx)                                                         \
+    (DT_PROP_BY_IDX(node_id, prop, idx) < USAGE_PAGES_MASK_LEN                                     \
+         ? BIT(DT_PROP_BY_IDX(node_id, prop, idx) % USAGE_PAGES_MASK_LEN)                          \
+         : 0) |
+
 #define KR_INST(n)                                                                                 \
     static struct behavior_key_repeat_data behavior_key_repeat_data_##n = {};                      \
     static struct behavior_key_repeat_config behavior_key_repeat_config_##n = {                    \
+        .usage_pages_mask = DT_INST_FOREACH_PROP_ELEM(n, usage_pages, USAGE_PAGE_BIT) 0,           \
         .usage_pages = DT_INST_PROP(n, usage_pages),                                               \
         .usage_pages_count = DT_INST_PROP_LEN(n, usage_pages),                                     \
     };                                                                                             \
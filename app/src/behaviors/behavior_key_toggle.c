@@ -31,7 +31,7 @@ static int on_keymap_binding_pressed(struct zmk_behavior_binding *binding,
                                      struct zmk_behavior_binding_event event) {
     LOG_DBG("position %d keycode 0x%02X", event.position, binding->param1);
     const struct behavior_key_toggle_config *cfg =
-        zmk_behavior_get_binding(binding->behavior_dev)->config;
+        zmk_behavior_binding_get_device(binding)->config;
     switch (cfg->toggle_mode) {
     case ON:
         return raise_zmk_keycode_state_changed_from_encoded(binding->param1, true, event.timestamp);
@@ -21,30 +21,43 @@ enum behavior_macro_mode {
 
 enum param_source { PARAM_SOURCE_BINDING, PARAM_SOURCE_MACRO_1ST, PARAM_SOURCE_MACRO_2ND };
 
+// The mode, times and parameter sources set by the control bindings up to a point in a macro.
 struct behavior_macro_trigger_state {
     uint32_t wait_ms;
     uint32_t tap_ms;
     enum behavior_macro_mode mode;
-    uint16_t start_index;
-    uint16_t count;
     enum param_source param1_source;
     enum param_source param2_source;
 };
 
-struct behavior_macro_state {
-    struct behavior_macro_trigger_state release_state;
+// One invocation of a binding, with the control bindings before it resolved when the macro is
+// compiled at init.
+struct macro_op {
+    uint32_t wait_ms;
+    uint32_t tap_ms;
+    // Index of the binding in the macro's bindings.
+    uint16_t binding;
+    uint8_t mode;
+    uint8_t param1_source;
+    uint8_t param2_source;
+};
 
+struct behavior_macro_state {
 #if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
     struct behavior_parameter_metadata_set set;
 #endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
 
-    uint32_t press_bindings_count;
+    // The ops queued on press come first, then those queued on release.
+    uint16_t press_ops_count;
+    uint16_t ops_count;
 };
 
 struct behavior_macro_config {
     uint32_t default_wait_ms;
     uint32_t default_tap_ms;
     uint32_t count;
+    // One for each of the bindings at most, filled in at init.
+    struct macro_op *ops;
     struct zmk_behavior_binding bindings[];
 };
 
@@ -111,30 +124,71 @@ static bool handle_control_binding(struct behavior_macro_trigger_state *state,
     return true;
 }
 
+// Compile the bindings [start, end) into ops, from the control state @p state at start, and
+// return the number of ops.
+static uint16_t compile_ops(const struct behavior_macro_config *cfg, uint16_t start, uint16_t end,
+                            struct behavior_macro_trigger_state state, struct macro_op *ops) {
+    uint16_t count = 0;
+
+    for (uint16_t i = start; i < end; i++) {
+        if (handle_control_binding(&state, &cfg->bindings[i])) {
+            continue;
+        }
+
+        ops[count++] = (struct macro_op){
+            .wait_ms = state.wait_ms,
+            .tap_ms = state.tap_ms,
+            .binding = i,
+            .mode = state.mode,
+            .param1_source = state.param1_source,
+            .param2_source = state.param2_source,
+        };
+
+        // Parameter replacement only applies to the binding right after it.
+        state.param1_source = PARAM_SOURCE_BINDING;
+        state.param2_source = PARAM_SOURCE_BINDING;
+    }
+
+    return count;
+}
+
 static int behavior_macro_init(const struct device *dev) {
     const struct behavior_macro_config *cfg = dev->config;
     struct behavior_macro_state *state = dev->data;
-    state->press_bindings_count = cfg->count;
-    state->release_state.start_index = cfg->count;
-    state->release_state.count = 0;
+    struct behavior_macro_trigger_state release_state = {0};
+    uint16_t press_count = cfg->count;
+    uint16_t release_start = cfg->count;
 
     LOG_DBG("Precalculate initial release state:");
     for (int i = 0; i < cfg->count; i++) {
-        if (handle_control_binding(&state->release_state, &cfg->bindings[i])) {
+        if (handle_control_binding(&release_state, &cfg->bindings[i])) {
             // Updated state used for initial state on release.
         } else if (IS_PAUSE(cfg->bindings[i].behavior_dev)) {
-            state->release_state.start_index = i + 1;
-            state->release_state.count = cfg->count - state->release_state.start_index;
-            state->press_bindings_count = i;
-            LOG_DBG("Release will resume at %d", state->release_state.start_index);
+            release_start = i + 1;
+            press_count = i;
+            LOG_DBG("Release will resume at %d", release_start);
             break;
         } else {
             // Mostly ignore regular invokable bindings, except they will consume macro parameters
-            state->release_state.param1_source = PARAM_SOURCE_BINDING;
-            state->release_state.param2_source = PARAM_SOURCE_BINDING;
+            release_state.param1_source = PARAM_SOURCE_BINDING;
+            release_state.param2_source = PARAM_SOURCE_BINDING;
         }
     }
 
+    const struct behavior_macro_trigger_state press_state = {
+        .mode = MACRO_MODE_TAP,
+        .tap_ms = cfg->default_tap_ms,
+        .wait_ms = cfg->default_wait_ms,
+    };
+
+    state->press_ops_count = compile_ops(cfg, 0, press_count, press_state, cfg->ops);
+    state->ops_count =
+        state->press_ops_count + compile_ops(cfg, release_start, cfg->count, release_state,
+                                             &cfg->ops[state->press_ops_count]);
+
+    LOG_DBG("Compiled %d press and %d release ops", state->press_ops_count,
+            state->ops_count - state->press_ops_count);
+
     return 0;
 };
 
@@ -150,68 +204,134 @@ static uint32_t select_param(enum param_source param_source, uint32_t source_bin
     }
 };
 
-static void replace_params(struct behavior_macro_trigger_state *state,
-                           struct zmk_behavior_binding *binding,
-                           const struct zmk_behavior_binding *macro_binding) {
-    binding->param1 = select_param(state->param1_source, binding->param1, macro_binding);
-    binding->param2 = select_param(state->param2_source, binding->param2, macro_binding);
+// The binding @p op invokes, with the parameters of @p macro_binding it takes.
+static struct zmk_behavior_binding op_binding(const struct zmk_behavior_binding bindings[],
+                                              const struct macro_op *op,
+                                              const struct zmk_behavior_binding *macro_binding) {
+    struct zmk_behavior_binding binding = bindings[op->binding];
+
+    binding.param1 = select_param(op->param1_source, binding.param1, macro_binding);
+    binding.param2 = select_param(op->param2_source, binding.param2, macro_binding);
 
-    state->param1_source = PARAM_SOURCE_BINDING;
-    state->param2_source = PARAM_SOURCE_BINDING;
+    return binding;
 }
 
 static void queue_macro(struct zmk_behavior_binding_event *event,
-                        const struct zmk_behavior_binding bindings[],
-                        struct behavior_macro_trigger_state state,
-                        const struct zmk_behavior_binding *macro_binding) {
-    LOG_DBG("Iterating macro bindings - starting: %d, count: %d", state.start_index, state.count);
-    for (int i = state.start_index; i < state.start_index + state.count; i++) {
-        if (!handle_control_binding(&state, &bindings[i])) {
-            struct zmk_behavior_binding binding = bindings[i];
-            replace_params(&state, &binding, macro_binding);
-
-            switch (state.mode) {
-            case MACRO_MODE_TAP:
-                zmk_behavior_queue_add(event, binding, true, state.tap_ms);
-                zmk_behavior_queue_add(event, binding, false, state.wait_ms);
-                break;
-            case MACRO_MODE_PRESS:
-                zmk_behavior_queue_add(event, binding, true, state.wait_ms);
-                break;
-            case MACRO_MODE_RELEASE:
-                zmk_behavior_queue_add(event, binding, false, state.wait_ms);
-                break;
-            default:
-                LOG_ERR("Unknown macro mode: %d", state.mode);
-                break;
-            }
+                        const struct zmk_behavior_binding bindings[], const struct macro_op ops[],
+                        uint16_t count, const struct zmk_behavior_binding *macro_binding) {
+    LOG_DBG("Queueing %d macro ops", count);
+    for (int i = 0; i < count; i++) {
+        const struct macro_op *op = &ops[i];
+        const struct zmk_behavior_binding binding = op_binding(bindings, op, macro_binding);
+
+        switch (op->mode) {
+        case MACRO_MODE_TAP:
+            zmk_behavior_queue_add(event, binding, true, op->tap_ms);
+            zmk_behavior_queue_add(event, binding, false, op->wait_ms);
+            break;
+        case MACRO_MODE_PRESS:
+            zmk_behavior_queue_add(event, binding, true, op->wait_ms);
+            break;
+        case MACRO_MODE_RELEASE:
+            zmk_behavior_queue_add(event, binding, false, op->wait_ms);
+            break;
         }
     }
 }
 
+#if IS_ENABLED(CONFIG_ZMK_MACRO_QUEUE_CURSOR)
+
+// Everything needed to continue a triggered macro, copied into its behavior queue cursor.
+struct macro_cursor_state {
+    const struct zmk_behavior_binding *bindings;
+    const struct macro_op *ops;
+    uint32_t macro_param1;
+    uint32_t macro_param2;
+    uint16_t index;
+    uint16_t count;
+    // in tap mode, the release of the op before index is still due
+    bool release_pending;
+};
+
+BUILD_ASSERT(sizeof(struct macro_cursor_state) <= ZMK_BEHAVIOR_QUEUE_CURSOR_STATE_SIZE,
+             "Macro cursor state doesn't fit in a behavior queue cursor");
+
+static bool macro_cursor_next(void *cursor_state, struct zmk_behavior_queue_step *step) {
+    struct macro_cursor_state *cursor = cursor_state;
+    const struct zmk_behavior_binding macro_binding = {.param1 = cursor->macro_param1,
+                                                       .param2 = cursor->macro_param2};
+
+    if (cursor->release_pending) {
+        const struct macro_op *op = &cursor->ops[cursor->index - 1];
+
+        cursor->release_pending = false;
+        *step = (struct zmk_behavior_queue_step){
+            .binding = op_binding(cursor->bindings, op, &macro_binding),
+            .press = false,
+            .wait = op->wait_ms,
+        };
+        return true;
+    }
+
+    if (cursor->index == cursor->count) {
+        return false;
+    }
+
+    const struct macro_op *op = &cursor->ops[cursor->index++];
+
+    *step = (struct zmk_behavior_queue_step){
+        .binding = op_binding(cursor->bindings, op, &macro_binding),
+        .press = op->mode != MACRO_MODE_RELEASE,
+        .wait = op->mode == MACRO_MODE_TAP ? op->tap_ms : op->wait_ms,
+    };
+    cursor->release_pending = op->mode == MACRO_MODE_TAP;
+    return true;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_MACRO_QUEUE_CURSOR)
+
+static void trigger_macro(struct zmk_behavior_binding_event *event,
+                          const struct zmk_behavior_binding bindings[], const struct macro_op ops[],
+                          uint16_t count, const struct zmk_behavior_binding *macro_binding) {
+#if IS_ENABLED(CONFIG_ZMK_MACRO_QUEUE_CURSOR)
+    const struct macro_cursor_state cursor = {
+        .bindings = bindings,
+        .ops = ops,
+        .macro_param1 = macro_binding->param1,
+        .macro_param2 = macro_binding->param2,
+        .count = count,
+    };
+
+    int ret = zmk_behavior_queue_add_cursor(event, macro_cursor_next, &cursor, sizeof(cursor));
+    if (ret == 0) {
+        return;
+    }
+
+    LOG_DBG("Unable to queue macro cursor (%d), queueing its bindings instead", ret);
+#endif
+
+    queue_macro(event, bindings, ops, count, macro_binding);
+}
+
 static int on_macro_binding_pressed(struct zmk_behavior_binding *binding,
                                     struct zmk_behavior_binding_event event) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
     const struct behavior_macro_config *cfg = dev->config;
-    struct behavior_macro_state *state = dev->data;
-    struct behavior_macro_trigger_state trigger_state = {.mode = MACRO_MODE_TAP,
-                                                         .tap_ms = cfg->default_tap_ms,
-                                                         .wait_ms = cfg->default_wait_ms,
-                                                         .start_index = 0,
-                                                         .count = state->press_bindings_count};
+    const struct behavior_macro_state *state = dev->data;
 
-    queue_macro(&event, cfg->bindings, trigger_state, binding);
+    trigger_macro(&event, cfg->bindings, cfg->ops, state->press_ops_count, binding);
 
     return ZMK_BEHAVIOR_OPAQUE;
 }
 
 static int on_macro_binding_released(struct zmk_behavior_binding *binding,
                                      struct zmk_behavior_binding_event event) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
     const struct behavior_macro_config *cfg = dev->config;
-    struct behavior_macro_state *state = dev->data;
+    const struct behavior_macro_state *state = dev->data;
 
-    queue_macro(&event, cfg->bindings, state->release_state, binding);
+    trigger_macro(&event, cfg->bindings, &cfg->ops[state->press_ops_count],
+                  state->ops_count - state->press_ops_count, binding);
 
     return ZMK_BEHAVIOR_OPAQUE;
 }
@@ -317,10 +437,12 @@ static const struct behavior_driver_api behavior_macro_driver_api = {
 
 #define MACRO_INST(inst)                                                                           \
     static struct behavior_macro_state behavior_macro_state_##inst = {};                           \
+    static struct macro_op behavior_macro_ops_##inst[DT_PROP_LEN(inst, bindings)];                 \
     static struct behavior_macro_config behavior_macro_config_##inst = {                           \
         .default_wait_ms = DT_PROP_OR(inst, wait_ms, CONFIG_ZMK_MACRO_DEFAULT_WAIT_MS),            \
         .default_tap_ms = DT_PROP_OR(inst, tap_ms, CONFIG_ZMK_MACRO_DEFAULT_TAP_MS),               \
         .count = DT_PROP_LEN(inst, bindings),                                                      \
+        .ops = behavior_macro_ops_##inst,                                                          \
         .bindings = TRANSFORMED_BEHAVIORS(inst)};                                                  \
     BEHAVIOR_DT_DEFINE(inst, behavior_macro_init, NULL, &behavior_macro_state_##inst,              \
                        &behavior_macro_config_##inst, POST_KERNEL,                                 \
@@ -16,7 +16,7 @@ int zmk_behavior_sensor_rotate_common_accept_data(
     struct zmk_behavior_binding *binding, struct zmk_behavior_binding_event event,
     const struct zmk_sensor_config *sensor_config, size_t channel_data_size,
     const struct zmk_sensor_channel_data *channel_data) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
     struct behavior_sensor_rotate_data *data = dev->data;
 
     const struct sensor_value value = channel_data[0].value;
@@ -59,7 +59,7 @@ int zmk_behavior_sensor_rotate_common_accept_data(
 int zmk_behavior_sensor_rotate_common_process(struct zmk_behavior_binding *binding,
                                               struct zmk_behavior_binding_event event,
                                               enum behavior_sensor_binding_process_mode mode) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
     const struct behavior_sensor_rotate_config *cfg = dev->config;
     struct behavior_sensor_rotate_data *data = dev->data;
 
@@ -95,10 +95,7 @@ int zmk_behavior_sensor_rotate_common_process(struct zmk_behavior_binding *bindi
     event.source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL;
 #endif
 
-    for (int i = 0; i < triggers; i++) {
-        zmk_behavior_queue_add(&event, triggered_binding, true, cfg->tap_ms);
-        zmk_behavior_queue_add(&event, triggered_binding, false, 0);
-    }
+    zmk_behavior_queue_add_taps(&event, triggered_binding, MIN(triggers, UINT16_MAX), cfg->tap_ms);
 
     return ZMK_BEHAVIOR_OPAQUE;
 }
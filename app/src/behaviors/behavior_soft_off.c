@@ -29,7 +29,7 @@ struct behavior_soft_off_data {
 
 static int on_keymap_binding_pressed(struct zmk_behavior_binding *binding,
                                      struct zmk_behavior_binding_event event) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
     struct behavior_soft_off_data *data = dev->data;
     const struct behavior_soft_off_config *config = dev->config;
 
@@ -44,7 +44,7 @@ static int on_keymap_binding_pressed(struct zmk_behavior_binding *binding,
 
 static int on_keymap_binding_released(struct zmk_behavior_binding *binding,
                                       struct zmk_behavior_binding_event event) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
     struct behavior_soft_off_data *data = dev->data;
     const struct behavior_soft_off_config *config = dev->config;
 
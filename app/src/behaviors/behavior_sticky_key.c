@@ -10,6 +10,9 @@
 #include <drivers/behavior.h>
 #include <zephyr/logging/log.h>
 #include <zmk/behavior.h>
+#include <zmk/behavior_timer.h>
+#include <zmk/context.h>
+#include <zmk/fuzz.h>
 
 #include <zmk/matrix.h>
 #include <zmk/endpoints.h>
@@ -30,6 +33,8 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #define ZMK_BHV_STICKY_KEY_POSITION_FREE UINT32_MAX
 
+BUILD_ASSERT(ZMK_BHV_STICKY_KEY_MAX_HELD <= 32, "At most 32 sticky keys can be held at once");
+
 struct behavior_sticky_key_config {
     uint32_t release_after_ms;
     bool quick_release;
@@ -45,25 +50,59 @@ struct active_sticky_key {
 #endif
     uint32_t param1;
     const struct behavior_sticky_key_config *config;
+    // set if the sticky key presses a key, whose own keycode events it doesn't catch
+    bool key_press;
     // timer data.
     bool timer_started;
-    bool timer_cancelled;
     int64_t release_at;
-    struct k_work_delayable release_timer;
+    struct zmk_behavior_timer release_timer;
     // usage page and keycode for the key that is being modified by this sticky key
     uint8_t modified_key_usage_page;
     uint32_t modified_key_keycode;
 };
 
-struct active_sticky_key active_sticky_keys[ZMK_BHV_STICKY_KEY_MAX_HELD] = {};
+struct sticky_key_state {
+    struct active_sticky_key keys[ZMK_BHV_STICKY_KEY_MAX_HELD];
+
+    // Bitmaps of the keys slots, so keycode events only visit the sticky keys they may affect,
+    // and none at all while no sticky key is active.
+    uint32_t active_mask;
+    // sticky keys that let modifier presses through
+    uint32_t ignore_modifiers_mask;
+    // sticky keys already used for a keycode
+    uint32_t modified_key_mask;
+};
+
+ZMK_CONTEXT_STATE_DEFINE(sticky_key_states, struct sticky_key_state, {});
+
+#define STATE ZMK_CONTEXT_STATE(sticky_key_states)
+
+static int sticky_key_keycode_state_changed_listener(const zmk_event_t *eh);
+
+// Keycode events are only dispatched to the listener while a sticky key is active.
+ZMK_LISTENER_WHEN_ACTIVE(behavior_sticky_key, sticky_key_keycode_state_changed_listener);
+ZMK_SUBSCRIPTION(behavior_sticky_key, zmk_keycode_state_changed);
+
+static inline uint32_t sticky_key_bit(const struct active_sticky_key *sticky_key) {
+    return BIT(sticky_key - STATE->keys);
+}
+
+// The listener is wanted while a sticky key is active in any context.
+static void update_listener_active(void) {
+    struct sticky_key_state *state;
+    bool active = false;
+
+    ZMK_CONTEXT_STATE_FOREACH(sticky_key_states, state) { active |= state->active_mask != 0U; }
+
+    ZMK_LISTENER_SET_ACTIVE(behavior_sticky_key, active);
+}
 
 static struct active_sticky_key *store_sticky_key(struct zmk_behavior_binding_event *event,
                                                   uint32_t param1,
                                                   const struct behavior_sticky_key_config *config) {
     for (int i = 0; i < ZMK_BHV_STICKY_KEY_MAX_HELD; i++) {
-        struct active_sticky_key *const sticky_key = &active_sticky_keys[i];
-        if (sticky_key->position != ZMK_BHV_STICKY_KEY_POSITION_FREE ||
-            sticky_key->timer_cancelled) {
+        struct active_sticky_key *const sticky_key = &STATE->keys[i];
+        if ((STATE->active_mask & BIT(i)) != 0U) {
             continue;
         }
         sticky_key->position = event->position;
@@ -72,11 +111,16 @@ static struct active_sticky_key *store_sticky_key(struct zmk_behavior_binding_ev
 #endif
         sticky_key->param1 = param1;
         sticky_key->config = config;
+        sticky_key->key_press = strcmp(config->behavior.behavior_dev, KEY_PRESS) == 0;
         sticky_key->release_at = 0;
-        sticky_key->timer_cancelled = false;
         sticky_key->timer_started = false;
         sticky_key->modified_key_usage_page = 0;
         sticky_key->modified_key_keycode = 0;
+
+        STATE->active_mask |= BIT(i);
+        ZMK_LISTENER_SET_ACTIVE(behavior_sticky_key, true);
+        WRITE_BIT(STATE->ignore_modifiers_mask, i, config->ignore_modifiers);
+        STATE->modified_key_mask &= ~BIT(i);
         return sticky_key;
     }
     return NULL;
@@ -86,16 +130,18 @@ static void clear_sticky_key(struct active_sticky_key *sticky_key) {
     LOG_DBG("clearing sticky key at position %d, param %d", sticky_key->position,
             sticky_key->param1);
     sticky_key->position = ZMK_BHV_STICKY_KEY_POSITION_FREE;
+    STATE->active_mask &= ~sticky_key_bit(sticky_key);
+    update_listener_active();
 }
 
 static struct active_sticky_key *
 find_sticky_key(uint32_t position, struct zmk_behavior_binding behavior, uint32_t binding_param) {
-    for (int i = 0; i < ZMK_BHV_STICKY_KEY_MAX_HELD; i++) {
-        if (active_sticky_keys[i].position == position &&
-            active_sticky_keys[i].config->behavior.behavior_dev == behavior.behavior_dev &&
-            active_sticky_keys[i].param1 == binding_param &&
-            !active_sticky_keys[i].timer_cancelled) {
-            return &active_sticky_keys[i];
+    for (uint32_t active = STATE->active_mask; active != 0U; active &= active - 1) {
+        int i = __builtin_ctz(active);
+        if (STATE->keys[i].position == position &&
+            STATE->keys[i].config->behavior.behavior_dev == behavior.behavior_dev &&
+            STATE->keys[i].param1 == binding_param) {
+            return &STATE->keys[i];
         }
     }
     return NULL;
@@ -144,18 +190,13 @@ static inline void on_sticky_key_timeout(struct active_sticky_key *sticky_key) {
     }
 }
 
-static int stop_timer(struct active_sticky_key *sticky_key) {
-    int timer_cancel_result = k_work_cancel_delayable(&sticky_key->release_timer);
-    if (timer_cancel_result == -EINPROGRESS) {
-        // too late to cancel, we'll let the timer handler clear up.
-        sticky_key->timer_cancelled = true;
-    }
-    return timer_cancel_result;
+static void stop_timer(struct active_sticky_key *sticky_key) {
+    zmk_behavior_timer_cancel(&sticky_key->release_timer);
 }
 
 static int on_sticky_key_binding_pressed(struct zmk_behavior_binding *binding,
                                          struct zmk_behavior_binding_event event) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
     const struct behavior_sticky_key_config *cfg = dev->config;
     struct active_sticky_key *sticky_key;
     sticky_key = find_sticky_key(event.position, cfg->behavior, binding->param1);
@@ -181,7 +222,7 @@ static int on_sticky_key_binding_pressed(struct zmk_behavior_binding *binding,
 
 static int on_sticky_key_binding_released(struct zmk_behavior_binding *binding,
                                           struct zmk_behavior_binding_event event) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
     const struct behavior_sticky_key_config *cfg = dev->config;
     struct active_sticky_key *sticky_key =
         find_sticky_key(event.position, cfg->behavior, binding->param1);
@@ -201,7 +242,7 @@ static int on_sticky_key_binding_released(struct zmk_behavior_binding *binding,
     // adjust timer in case this behavior was queued by a hold-tap
     int32_t ms_left = sticky_key->release_at - k_uptime_get();
     if (ms_left > 0) {
-        k_work_schedule(&sticky_key->release_timer, K_MSEC(ms_left));
+        zmk_behavior_timer_start(&sticky_key->release_timer, sticky_key->release_at);
     }
     return ZMK_BEHAVIOR_OPAQUE;
 }
@@ -244,14 +285,26 @@ static const struct behavior_driver_api behavior_sticky_key_driver_api = {
 #endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
 };
 
-static int sticky_key_keycode_state_changed_listener(const zmk_event_t *eh);
+// The sticky keys a keycode event may affect
+static uint32_t keycode_candidates(bool key_down, bool modifier) {
+    uint32_t candidates = STATE->active_mask;
 
-ZMK_LISTENER(behavior_sticky_key, sticky_key_keycode_state_changed_listener);
-ZMK_SUBSCRIPTION(behavior_sticky_key, zmk_keycode_state_changed);
+    if (key_down) {
+        // sticky keys already in use for a keycode
+        candidates &= ~STATE->modified_key_mask;
+    }
+
+    if (modifier) {
+        // ignore modifier key press so we can stack sticky keys and combine with other modifiers
+        candidates &= ~STATE->ignore_modifiers_mask;
+    }
+
+    return candidates;
+}
 
 static int sticky_key_keycode_state_changed_listener(const zmk_event_t *eh) {
     struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
-    if (ev == NULL) {
+    if (ev == NULL || STATE->active_mask == 0U) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
@@ -269,13 +322,21 @@ static int sticky_key_keycode_state_changed_listener(const zmk_event_t *eh) {
     for (int i = 0; i < ZMK_BHV_STICKY_KEY_MAX_HELD; i++) {
         sticky_keys_to_press_before_reraise[i] = NULL;
         sticky_keys_to_release_after_reraise[i] = NULL;
+    }
+
+    bool modifier_pressed = ev_copy.state && is_mod(ev_copy.usage_page, ev_copy.keycode);
 
-        struct active_sticky_key *sticky_key = &active_sticky_keys[i];
-        if (sticky_key->position == ZMK_BHV_STICKY_KEY_POSITION_FREE) {
+    for (uint32_t candidates = keycode_candidates(ev_copy.state, modifier_pressed);
+         candidates != 0U; candidates &= candidates - 1) {
+        int i = __builtin_ctz(candidates);
+        struct active_sticky_key *sticky_key = &STATE->keys[i];
+
+        // a sticky key released by the keycode event of an earlier one is no longer a candidate
+        if ((keycode_candidates(ev_copy.state, modifier_pressed) & BIT(i)) == 0U) {
             continue;
         }
 
-        if (strcmp(sticky_key->config->behavior.behavior_dev, KEY_PRESS) == 0 &&
+        if (sticky_key->key_press &&
             ZMK_HID_USAGE_ID(sticky_key->param1) == ev_copy.keycode &&
             ZMK_HID_USAGE_PAGE(sticky_key->param1) == ev_copy.usage_page &&
             SELECT_MODS(sticky_key->param1) == ev_copy.implicit_modifiers) {
@@ -284,17 +345,6 @@ static int sticky_key_keycode_state_changed_listener(const zmk_event_t *eh) {
         }
 
         if (ev_copy.state) { // key down
-            if (sticky_key->config->ignore_modifiers &&
-                is_mod(ev_copy.usage_page, ev_copy.keycode)) {
-                // ignore modifier key press so we can stack sticky keys and combine with other
-                // modifiers
-                continue;
-            }
-            if (sticky_key->modified_key_usage_page != 0 || sticky_key->modified_key_keycode != 0) {
-                // this sticky key is already in use for a keycode
-                continue;
-            }
-
             // we don't want the timer to release the sticky key before the other key is released
             stop_timer(sticky_key);
 
@@ -317,6 +367,7 @@ static int sticky_key_keycode_state_changed_listener(const zmk_event_t *eh) {
             }
             sticky_key->modified_key_usage_page = ev_copy.usage_page;
             sticky_key->modified_key_keycode = ev_copy.keycode;
+            STATE->modified_key_mask |= BIT(i);
         } else { // key up
             if (sticky_key->timer_started &&
                 sticky_key->modified_key_usage_page == ev_copy.usage_page &&
@@ -357,33 +408,36 @@ static int sticky_key_keycode_state_changed_listener(const zmk_event_t *eh) {
     return event_reraised ? ZMK_EV_EVENT_CAPTURED : ZMK_EV_EVENT_BUBBLE;
 }
 
-void behavior_sticky_key_timer_handler(struct k_work *item) {
-    struct k_work_delayable *d_work = k_work_delayable_from_work(item);
+void behavior_sticky_key_timer_handler(struct zmk_behavior_timer *timer) {
     struct active_sticky_key *sticky_key =
-        CONTAINER_OF(d_work, struct active_sticky_key, release_timer);
+        CONTAINER_OF(timer, struct active_sticky_key, release_timer);
     if (sticky_key->position == ZMK_BHV_STICKY_KEY_POSITION_FREE) {
         return;
     }
-    if (sticky_key->timer_cancelled) {
-        sticky_key->timer_cancelled = false;
-    } else {
-        on_sticky_key_timeout(sticky_key);
-    }
+    on_sticky_key_timeout(sticky_key);
 }
 
 static int behavior_sticky_key_init(const struct device *dev) {
     static bool init_first_run = true;
     if (init_first_run) {
-        for (int i = 0; i < ZMK_BHV_STICKY_KEY_MAX_HELD; i++) {
-            k_work_init_delayable(&active_sticky_keys[i].release_timer,
-                                  behavior_sticky_key_timer_handler);
-            active_sticky_keys[i].position = ZMK_BHV_STICKY_KEY_POSITION_FREE;
+        struct sticky_key_state *state;
+
+        ZMK_CONTEXT_STATE_FOREACH(sticky_key_states, state) {
+            for (int i = 0; i < ZMK_BHV_STICKY_KEY_MAX_HELD; i++) {
+                zmk_behavior_timer_init(&state->keys[i].release_timer,
+                                        behavior_sticky_key_timer_handler);
+                state->keys[i].position = ZMK_BHV_STICKY_KEY_POSITION_FREE;
+            }
         }
     }
     init_first_run = false;
     return 0;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_FUZZ) || IS_ENABLED(CONFIG_ZMK_CHECKPOINT)
+bool zmk_behavior_sticky_key_idle(void) { return STATE->active_mask == 0; }
+#endif // IS_ENABLED(CONFIG_ZMK_FUZZ) || IS_ENABLED(CONFIG_ZMK_CHECKPOINT)
+
 #define KP_INST(n)                                                                                 \
     static const struct behavior_sticky_key_config behavior_sticky_key_config_##n = {              \
         .behavior = ZMK_KEYMAP_EXTRACT_BINDING(0, DT_DRV_INST(n)),                                 \
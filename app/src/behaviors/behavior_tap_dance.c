@@ -10,6 +10,9 @@
 #include <drivers/behavior.h>
 #include <zephyr/logging/log.h>
 #include <zmk/behavior.h>
+#include <zmk/behavior_timer.h>
+#include <zmk/context.h>
+#include <zmk/fuzz.h>
 #include <zmk/keymap.h>
 #include <zmk/matrix.h>
 #include <zmk/event_manager.h>
@@ -45,18 +48,41 @@ struct active_tap_dance {
 
     // Timer Data
     bool timer_started;
-    bool timer_cancelled;
     bool tap_dance_decided;
     int64_t release_at;
-    struct k_work_delayable release_timer;
+    struct zmk_behavior_timer release_timer;
 };
 
-struct active_tap_dance active_tap_dances[ZMK_BHV_TAP_DANCE_MAX_HELD] = {};
+BUILD_ASSERT(ZMK_BHV_TAP_DANCE_MAX_HELD < 32, "At most 31 held tap-dances are supported");
+
+struct tap_dance_state {
+    struct active_tap_dance tap_dances[ZMK_BHV_TAP_DANCE_MAX_HELD];
+
+    // Slots in use, and those of them whose binding isn't decided yet.
+    uint32_t active_slots;
+    uint32_t undecided_slots;
+
+    // Slot index + 1 of the tap dance at each key position, or 0. Virtual key positions, like
+    // those of combos, are found by looking through the slots in use instead.
+    uint8_t tap_dance_at_position[ZMK_KEYMAP_LEN];
+};
+
+ZMK_CONTEXT_STATE_DEFINE(tap_dance_states, struct tap_dance_state, {});
+
+#define STATE ZMK_CONTEXT_STATE(tap_dance_states)
 
 static struct active_tap_dance *find_tap_dance(uint32_t position) {
-    for (int i = 0; i < ZMK_BHV_TAP_DANCE_MAX_HELD; i++) {
-        if (active_tap_dances[i].position == position && !active_tap_dances[i].timer_cancelled) {
-            return &active_tap_dances[i];
+    if (position < ZMK_KEYMAP_LEN) {
+        uint8_t slot = STATE->tap_dance_at_position[position];
+        return slot ? &STATE->tap_dances[slot - 1] : NULL;
+    }
+
+    for (uint32_t slots = STATE->active_slots; slots;) {
+        int i = find_lsb_set(slots) - 1;
+        WRITE_BIT(slots, i, 0);
+
+        if (STATE->tap_dances[i].position == position) {
+            return &STATE->tap_dances[i];
         }
     }
     return NULL;
@@ -65,38 +91,47 @@ static struct active_tap_dance *find_tap_dance(uint32_t position) {
 static int new_tap_dance(struct zmk_behavior_binding_event *event,
                          const struct behavior_tap_dance_config *config,
                          struct active_tap_dance **tap_dance) {
-    for (int i = 0; i < ZMK_BHV_TAP_DANCE_MAX_HELD; i++) {
-        struct active_tap_dance *const ref_dance = &active_tap_dances[i];
-        if (ref_dance->position == ZMK_BHV_TAP_DANCE_POSITION_FREE) {
-            ref_dance->counter = 0;
-            ref_dance->position = event->position;
+    int i = find_lsb_set(~STATE->active_slots & BIT_MASK(ZMK_BHV_TAP_DANCE_MAX_HELD)) - 1;
+    if (i < 0) {
+        return -ENOMEM;
+    }
+
+    struct active_tap_dance *const ref_dance = &STATE->tap_dances[i];
+    ref_dance->counter = 0;
+    ref_dance->position = event->position;
 #if IS_ENABLED(CONFIG_ZMK_SPLIT)
-            ref_dance->source = event->source;
+    ref_dance->source = event->source;
 #endif
-            ref_dance->config = config;
-            ref_dance->release_at = 0;
-            ref_dance->is_pressed = true;
-            ref_dance->timer_started = true;
-            ref_dance->timer_cancelled = false;
-            ref_dance->tap_dance_decided = false;
-            *tap_dance = ref_dance;
-            return 0;
-        }
+    ref_dance->config = config;
+    ref_dance->release_at = 0;
+    ref_dance->is_pressed = true;
+    ref_dance->timer_started = true;
+    ref_dance->tap_dance_decided = false;
+
+    WRITE_BIT(STATE->active_slots, i, 1);
+    WRITE_BIT(STATE->undecided_slots, i, 1);
+    if (event->position < ZMK_KEYMAP_LEN) {
+        STATE->tap_dance_at_position[event->position] = i + 1;
     }
-    return -ENOMEM;
+
+    *tap_dance = ref_dance;
+    return 0;
 }
 
 static void clear_tap_dance(struct active_tap_dance *tap_dance) {
+    int i = tap_dance - STATE->tap_dances;
+
+    if (tap_dance->position < ZMK_KEYMAP_LEN) {
+        STATE->tap_dance_at_position[tap_dance->position] = 0;
+    }
+
+    WRITE_BIT(STATE->active_slots, i, 0);
+    WRITE_BIT(STATE->undecided_slots, i, 0);
     tap_dance->position = ZMK_BHV_TAP_DANCE_POSITION_FREE;
 }
 
-static int stop_timer(struct active_tap_dance *tap_dance) {
-    int timer_cancel_result = k_work_cancel_delayable(&tap_dance->release_timer);
-    if (timer_cancel_result == -EINPROGRESS) {
-        // too late to cancel, we'll let the timer handler clear up.
-        tap_dance->timer_cancelled = true;
-    }
-    return timer_cancel_result;
+static void stop_timer(struct active_tap_dance *tap_dance) {
+    zmk_behavior_timer_cancel(&tap_dance->release_timer);
 }
 
 static void reset_timer(struct active_tap_dance *tap_dance,
@@ -104,13 +139,16 @@ static void reset_timer(struct active_tap_dance *tap_dance,
     tap_dance->release_at = event.timestamp + tap_dance->config->tapping_term_ms;
     int32_t ms_left = tap_dance->release_at - k_uptime_get();
     if (ms_left > 0) {
-        k_work_schedule(&tap_dance->release_timer, K_MSEC(ms_left));
+        zmk_behavior_timer_start(&tap_dance->release_timer, tap_dance->release_at);
         LOG_DBG("Successfully reset timer at position %d", tap_dance->position);
+    } else {
+        stop_timer(tap_dance);
     }
 }
 
 static inline int press_tap_dance_behavior(struct active_tap_dance *tap_dance, int64_t timestamp) {
     tap_dance->tap_dance_decided = true;
+    WRITE_BIT(STATE->undecided_slots, tap_dance - STATE->tap_dances, 0);
     struct zmk_behavior_binding binding = tap_dance->config->behaviors[tap_dance->counter - 1];
     struct zmk_behavior_binding_event event = {
         .position = tap_dance->position,
@@ -138,20 +176,19 @@ static inline int release_tap_dance_behavior(struct active_tap_dance *tap_dance,
 
 static int on_tap_dance_binding_pressed(struct zmk_behavior_binding *binding,
                                         struct zmk_behavior_binding_event event) {
-    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
     const struct behavior_tap_dance_config *cfg = dev->config;
     struct active_tap_dance *tap_dance;
     tap_dance = find_tap_dance(event.position);
     if (tap_dance == NULL) {
         if (new_tap_dance(&event, cfg, &tap_dance) == -ENOMEM) {
-            LOG_ERR("Unable to create new tap dance. Insufficient space in active_tap_dances[].");
+            LOG_ERR("Unable to create new tap dance. Insufficient space in tap_dances[].");
             return ZMK_BEHAVIOR_OPAQUE;
         }
         LOG_DBG("%d created new tap dance", event.position);
     }
     tap_dance->is_pressed = true;
     LOG_DBG("%d tap dance pressed", event.position);
-    stop_timer(tap_dance);
     // Increment the counter on keypress. If the counter has reached its maximum
     // value, invoke the last binding available.
     if (tap_dance->counter < cfg->behavior_count) {
@@ -159,6 +196,7 @@ static int on_tap_dance_binding_pressed(struct zmk_behavior_binding *binding,
     }
     if (tap_dance->counter == cfg->behavior_count) {
         // LOG_DBG("Tap dance has been decided via maximum counter value");
+        stop_timer(tap_dance);
         press_tap_dance_behavior(tap_dance, event.timestamp);
         return ZMK_EV_EVENT_BUBBLE;
     }
@@ -181,16 +219,12 @@ static int on_tap_dance_binding_released(struct zmk_behavior_binding *binding,
     return ZMK_BEHAVIOR_OPAQUE;
 }
 
-void behavior_tap_dance_timer_handler(struct k_work *item) {
-    struct k_work_delayable *d_work = k_work_delayable_from_work(item);
+void behavior_tap_dance_timer_handler(struct zmk_behavior_timer *timer) {
     struct active_tap_dance *tap_dance =
-        CONTAINER_OF(d_work, struct active_tap_dance, release_timer);
+        CONTAINER_OF(timer, struct active_tap_dance, release_timer);
     if (tap_dance->position == ZMK_BHV_TAP_DANCE_POSITION_FREE) {
         return;
     }
-    if (tap_dance->timer_cancelled) {
-        return;
-    }
     LOG_DBG("Tap dance has been decided via timer. Counter reached: %d", tap_dance->counter);
     press_tap_dance_behavior(tap_dance, tap_dance->release_at);
     if (tap_dance->is_pressed) {
@@ -221,23 +255,22 @@ static int tap_dance_position_state_changed_listener(const zmk_event_t *eh) {
         LOG_DBG("Ignore upstroke at position %d.", ev->position);
         return ZMK_EV_EVENT_BUBBLE;
     }
-    for (int i = 0; i < ZMK_BHV_TAP_DANCE_MAX_HELD; i++) {
-        struct active_tap_dance *tap_dance = &active_tap_dances[i];
-        if (tap_dance->position == ZMK_BHV_TAP_DANCE_POSITION_FREE) {
-            continue;
-        }
+    // Only undecided tap dances can be interrupted.
+    for (uint32_t slots = STATE->undecided_slots; slots;) {
+        int i = find_lsb_set(slots) - 1;
+        WRITE_BIT(slots, i, 0);
+
+        struct active_tap_dance *tap_dance = &STATE->tap_dances[i];
         if (tap_dance->position == ev->position) {
             continue;
         }
         stop_timer(tap_dance);
         LOG_DBG("Tap dance interrupted, activating tap-dance at %d", tap_dance->position);
-        if (!tap_dance->tap_dance_decided) {
-            press_tap_dance_behavior(tap_dance, ev->timestamp);
-            if (!tap_dance->is_pressed) {
-                release_tap_dance_behavior(tap_dance, ev->timestamp);
-            }
-            return ZMK_EV_EVENT_BUBBLE;
+        press_tap_dance_behavior(tap_dance, ev->timestamp);
+        if (!tap_dance->is_pressed) {
+            release_tap_dance_behavior(tap_dance, ev->timestamp);
         }
+        return ZMK_EV_EVENT_BUBBLE;
     }
     return ZMK_EV_EVENT_BUBBLE;
 }
@@ -245,10 +278,14 @@ static int tap_dance_position_state_changed_listener(const zmk_event_t *eh) {
 static int behavior_tap_dance_init(const struct device *dev) {
     static bool init_first_run = true;
     if (init_first_run) {
-        for (int i = 0; i < ZMK_BHV_TAP_DANCE_MAX_HELD; i++) {
-            k_work_init_delayable(&active_tap_dances[i].release_timer,
-                                  behavior_tap_dance_timer_handler);
-            clear_tap_dance(&active_tap_dances[i]);
+        struct tap_dance_state *state;
+
+        ZMK_CONTEXT_STATE_FOREACH(tap_dance_states, state) {
+            for (int i = 0; i < ZMK_BHV_TAP_DANCE_MAX_HELD; i++) {
+                zmk_behavior_timer_init(&state->tap_dances[i].release_timer,
+                                        behavior_tap_dance_timer_handler);
+                state->tap_dances[i].position = ZMK_BHV_TAP_DANCE_POSITION_FREE;
+            }
         }
     }
     init_first_run = false;
@@ -260,6 +297,10 @@ static int behavior_tap_dance_init(const struct device *dev) {
 #define TRANSFORMED_BINDINGS(node)                                                                 \
     {LISTIFY(DT_INST_PROP_LEN(node, bindings), _TRANSFORM_ENTRY, (, ), DT_DRV_INST(node))}
 
+#if IS_ENABLED(CONFIG_ZMK_FUZZ) || IS_ENABLED(CONFIG_ZMK_CHECKPOINT)
+bool zmk_behavior_tap_dance_idle(void) { return STATE->active_slots == 0; }
+#endif // IS_ENABLED(CONFIG_ZMK_FUZZ) || IS_ENABLED(CONFIG_ZMK_CHECKPOINT)
+
 #define KP_INST(n)                                                                                 \
     static struct zmk_behavior_binding                                                             \
         behavior_tap_dance_config_##n##_bindings[DT_INST_PROP_LEN(n, bindings)] =                  \
@@ -274,4 +315,25 @@ static int behavior_tap_dance_init(const struct device *dev) {
 
 DT_INST_FOREACH_STATUS_OKAY(KP_INST)
 
+#define KP_CONFIG_REF(n) &behavior_tap_dance_config_##n,
+
+static const struct behavior_tap_dance_config *const tap_dance_configs[] = {
+    DT_INST_FOREACH_STATUS_OKAY(KP_CONFIG_REF)};
+
+// Resolves the behavior devices of all tap dance bindings once every behavior is ready, so that
+// invoking the chosen binding doesn't look its behavior up by name.
+static int behavior_tap_dance_resolve_bindings(void) {
+    for (int c = 0; c < ARRAY_SIZE(tap_dance_configs); c++) {
+        const struct behavior_tap_dance_config *cfg = tap_dance_configs[c];
+
+        for (int b = 0; b < cfg->behavior_count; b++) {
+            cfg->behaviors[b].device = zmk_behavior_get_binding(cfg->behaviors[b].behavior_dev);
+        }
+    }
+
+    return 0;
+}
+
+SYS_INIT(behavior_tap_dance_resolve_bindings, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
 #endif
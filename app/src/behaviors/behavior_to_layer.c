@@ -24,7 +24,7 @@ struct behavior_to_config {
 static int to_keymap_binding_pressed(struct zmk_behavior_binding *binding,
                                      struct zmk_behavior_binding_event event) {
     LOG_DBG("position %d layer %d", event.position, binding->param1);
-    const struct behavior_to_config *cfg = zmk_behavior_get_binding(binding->behavior_dev)->config;
+    const struct behavior_to_config *cfg = zmk_behavior_binding_get_device(binding)->config;
     zmk_keymap_layer_to(binding->param1, cfg->locking);
     return ZMK_BEHAVIOR_OPAQUE;
 }
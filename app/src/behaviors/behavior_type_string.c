@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_behavior_type_string
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <drivers/behavior.h>
+#include <zephyr/logging/log.h>
+
+#include <dt-bindings/zmk/hid_usage.h>
+#include <dt-bindings/zmk/modifiers.h>
+
+#include <zmk/behavior.h>
+#include <zmk/endpoints.h>
+#include <zmk/hid.h>
+#include <zmk/workqueue.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
+
+// Text is typed by writing keyboard reports directly instead of raising keycode events, with no
+// fixed waits between keys. Each report releases the keys of the previous one and presses the next
+// run of characters that can't be reordered by the host: keys with strictly increasing usages, all
+// using the same shift state, none of them still held from the previous report. The next report
+// only goes out once the endpoint has room to queue it, so the transport sets the pace.
+
+struct behavior_type_string_config {
+    const char *text;
+    uint8_t keys_per_report;
+};
+
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO)
+#define TYPE_STRING_REPORT_KEYS CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE
+#else
+#define TYPE_STRING_REPORT_KEYS 64
+#endif
+
+#define ASCII_SHIFT BIT(7)
+
+// US layout usages of the ASCII characters other than letters and 1-9, 0 if they can't be typed
+static const uint8_t ascii_symbol_usages[128] = {
+    ['\t'] = HID_USAGE_KEY_KEYBOARD_TAB,
+    ['\n'] = HID_USAGE_KEY_KEYBOARD_RETURN_ENTER,
+    [' '] = HID_USAGE_KEY_KEYBOARD_SPACEBAR,
+    ['!'] = HID_USAGE_KEY_KEYBOARD_1_AND_EXCLAMATION | ASCII_SHIFT,
+    ['"'] = HID_USAGE_KEY_KEYBOARD_APOSTROPHE_AND_QUOTE | ASCII_SHIFT,
+    ['#'] = HID_USAGE_KEY_KEYBOARD_3_AND_HASH | ASCII_SHIFT,
+    ['$'] = HID_USAGE_KEY_KEYBOARD_4_AND_DOLLAR | ASCII_SHIFT,
+    ['%'] = HID_USAGE_KEY_KEYBOARD_5_AND_PERCENT | ASCII_SHIFT,
+    ['&'] = HID_USAGE_KEY_KEYBOARD_7_AND_AMPERSAND | ASCII_SHIFT,
+    ['\''] = HID_USAGE_KEY_KEYBOARD_APOSTROPHE_AND_QUOTE,
+    ['('] = HID_USAGE_KEY_KEYBOARD_9_AND_LEFT_PARENTHESIS | ASCII_SHIFT,
+    [')'] = HID_USAGE_KEY_KEYBOARD_0_AND_RIGHT_PARENTHESIS | ASCII_SHIFT,
+    ['*'] = HID_USAGE_KEY_KEYBOARD_8_AND_ASTERISK | ASCII_SHIFT,
+    ['+'] = HID_USAGE_KEY_KEYBOARD_EQUAL_AND_PLUS | ASCII_SHIFT,
+    [','] = HID_USAGE_KEY_KEYBOARD_COMMA_AND_LESS_THAN,
+    ['-'] = HID_USAGE_KEY_KEYBOARD_MINUS_AND_UNDERSCORE,
+    ['.'] = HID_USAGE_KEY_KEYBOARD_PERIOD_AND_GREATER_THAN,
+    ['/'] = HID_USAGE_KEY_KEYBOARD_SLASH_AND_QUESTION_MARK,
+    ['0'] = HID_USAGE_KEY_KEYBOARD_0_AND_RIGHT_PARENTHESIS,
+    [':'] = HID_USAGE_KEY_KEYBOARD_SEMICOLON_AND_COLON | ASCII_SHIFT,
+    [';'] = HID_USAGE_KEY_KEYBOARD_SEMICOLON_AND_COLON,
+    ['<'] = HID_USAGE_KEY_KEYBOARD_COMMA_AND_LESS_THAN | ASCII_SHIFT,
+    ['='] = HID_USAGE_KEY_KEYBOARD_EQUAL_AND_PLUS,
+    ['>'] = HID_USAGE_KEY_KEYBOARD_PERIOD_AND_GREATER_THAN | ASCII_SHIFT,
+    ['?'] = HID_USAGE_KEY_KEYBOARD_SLASH_AND_QUESTION_MARK | ASCII_SHIFT,
+    ['@'] = HID_USAGE_KEY_KEYBOARD_2_AND_AT | ASCII_SHIFT,
+    ['['] = HID_USAGE_KEY_KEYBOARD_LEFT_BRACKET_AND_LEFT_BRACE,
+    ['\\'] = HID_USAGE_KEY_KEYBOARD_BACKSLASH_AND_PIPE,
+    [']'] = HID_USAGE_KEY_KEYBOARD_RIGHT_BRACKET_AND_RIGHT_BRACE,
+    ['^'] = HID_USAGE_KEY_KEYBOARD_6_AND_CARET | ASCII_SHIFT,
+    ['_'] = HID_USAGE_KEY_KEYBOARD_MINUS_AND_UNDERSCORE | ASCII_SHIFT,
+    ['`'] = HID_USAGE_KEY_KEYBOARD_GRAVE_ACCENT_AND_TILDE,
+    ['{'] = HID_USAGE_KEY_KEYBOARD_LEFT_BRACKET_AND_LEFT_BRACE | ASCII_SHIFT,
+    ['|'] = HID_USAGE_KEY_KEYBOARD_BACKSLASH_AND_PIPE | ASCII_SHIFT,
+    ['}'] = HID_USAGE_KEY_KEYBOARD_RIGHT_BRACKET_AND_RIGHT_BRACE | ASCII_SHIFT,
+    ['~'] = HID_USAGE_KEY_KEYBOARD_GRAVE_ACCENT_AND_TILDE | ASCII_SHIFT,
+};
+
+// Every usage typed is below 64, so a set of keys fits a single word.
+BUILD_ASSERT(HID_USAGE_KEY_KEYBOARD_SLASH_AND_QUESTION_MARK < 64);
+
+static uint8_t ascii_usage(char c) {
+    if (c >= 'a' && c <= 'z') {
+        return HID_USAGE_KEY_KEYBOARD_A + (c - 'a');
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return (HID_USAGE_KEY_KEYBOARD_A + (c - 'A')) | ASCII_SHIFT;
+    }
+    if (c >= '1' && c <= '9') {
+        return HID_USAGE_KEY_KEYBOARD_1_AND_EXCLAMATION + (c - '1');
+    }
+    if ((uint8_t)c >= ARRAY_SIZE(ascii_symbol_usages)) {
+        return 0;
+    }
+
+    return ascii_symbol_usages[(uint8_t)c];
+}
+
+// Only one string is typed at a time, since they all share the keyboard report.
+static const struct behavior_type_string_config *typing;
+static size_t typing_offset;
+// keys pressed in the last report sent, as bits indexed by usage
+static uint64_t typing_held;
+
+static void release_typing_held(void) {
+    while (typing_held) {
+        zmk_hid_keyboard_release(__builtin_ctzll(typing_held));
+        typing_held &= typing_held - 1;
+    }
+}
+
+static void type_string_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(type_string_work, type_string_work_cb);
+
+// how long to wait for the endpoint to make room for another report
+#define TYPE_STRING_QUEUE_FULL_RETRY K_MSEC(1)
+
+static void type_string_work_cb(struct k_work *work) {
+    if (zmk_endpoint_keyboard_report_queue_full()) {
+        k_work_schedule_for_queue(zmk_workqueue_input_work_q(), &type_string_work,
+                                  TYPE_STRING_QUEUE_FULL_RETRY);
+        return;
+    }
+
+    const char *text = typing->text + typing_offset;
+    uint8_t max_keys = TYPE_STRING_REPORT_KEYS;
+    if (typing->keys_per_report) {
+        max_keys = MIN(max_keys, typing->keys_per_report);
+    }
+
+    uint64_t keys = 0;
+    uint8_t count = 0;
+    uint8_t last_usage = 0;
+    bool shift = false;
+    size_t len = 0;
+
+    for (; text[len]; len++) {
+        uint8_t usage = ascii_usage(text[len]);
+        if (!usage) {
+            LOG_WRN("Skipping character 0x%02X, which can't be typed", (uint8_t)text[len]);
+            continue;
+        }
+
+        bool usage_shift = usage & ASCII_SHIFT;
+        usage &= ~ASCII_SHIFT;
+
+        if (count > 0 && (usage_shift != shift || usage <= last_usage || count == max_keys)) {
+            break;
+        }
+
+        if (typing_held & BIT64(usage)) {
+            // the key has to be released in a report of its own before it's typed again
+            break;
+        }
+
+        keys |= BIT64(usage);
+        last_usage = usage;
+        shift = usage_shift;
+        count++;
+    }
+
+    release_typing_held();
+    typing_offset += len;
+
+    if (count > 0) {
+        for (uint64_t remaining = keys; remaining; remaining &= remaining - 1) {
+            zmk_hid_keyboard_press(__builtin_ctzll(remaining));
+        }
+
+        // The shift state of the run overrides whatever the held keys set, and leaves it to be
+        // restored once the string is done
+        if (shift) {
+            zmk_hid_override_modifiers_set(MOD_LSFT, 0);
+        } else {
+            zmk_hid_override_modifiers_set(0, MOD_LSFT | MOD_RSFT);
+        }
+
+        LOG_DBG("Typing keys 0x%llx%s", keys, shift ? " with shift" : "");
+        typing_held = keys;
+    } else if (!text[len]) {
+        zmk_hid_override_modifiers_clear();
+    }
+
+    int err = zmk_endpoint_send_report(HID_USAGE_KEY);
+    if (err < 0) {
+        LOG_ERR("Failed to send keyboard report (%d)", err);
+    }
+
+    if (count == 0 && !text[len]) {
+        LOG_DBG("Finished typing string");
+        typing = NULL;
+        return;
+    }
+
+    // resubmitting lets other work run between reports instead of holding the queue
+    k_work_schedule_for_queue(zmk_workqueue_input_work_q(), &type_string_work, K_NO_WAIT);
+}
+
+static int on_type_string_binding_pressed(struct zmk_behavior_binding *binding,
+                                          struct zmk_behavior_binding_event event) {
+    const struct device *dev = zmk_behavior_binding_get_device(binding);
+
+    if (typing) {
+        LOG_WRN("Already typing a string, ignoring %s", dev->name);
+        return ZMK_BEHAVIOR_OPAQUE;
+    }
+
+    typing = dev->config;
+    typing_offset = 0;
+    typing_held = 0;
+    k_work_schedule_for_queue(zmk_workqueue_input_work_q(), &type_string_work, K_NO_WAIT);
+
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static int on_type_string_binding_released(struct zmk_behavior_binding *binding,
+                                           struct zmk_behavior_binding_event event) {
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static const struct behavior_driver_api behavior_type_string_driver_api = {
+    .binding_pressed = on_type_string_binding_pressed,
+    .binding_released = on_type_string_binding_released,
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+    .get_parameter_metadata = zmk_behavior_get_empty_param_metadata,
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+};
+
+#define TS_INST(n)                                                                                 \
+    static const struct behavior_type_string_config behavior_type_string_config_##n = {            \
+        .text = DT_INST_PROP(n, text),                                                             \
+        .keys_per_report = DT_INST_PROP(n, keys_per_report),                                       \
+    };                                                                                             \
+    BEHAVIOR_DT_INST_DEFINE(n, NULL, NULL, NULL, &behavior_type_string_config_##n, POST_KERNEL,    \
+                            CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,                                   \
+                            &behavior_type_string_driver_api);
+
+DT_INST_FOREACH_STATUS_OKAY(TS_INST)
+
+#endif
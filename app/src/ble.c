@@ -13,6 +13,7 @@
 #include <stdio.h>
 
 #include <zephyr/settings/settings.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/sys/ring_buffer.h>
 #include <zephyr/bluetooth/bluetooth.h>
 #include <zephyr/bluetooth/conn.h>
@@ -33,6 +34,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/ble.h>
 #include <zmk/keys.h>
+#include <zmk/settings.h>
 #include <zmk/split/bluetooth/uuid.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/ble_active_profile_changed.h>
@@ -55,13 +57,39 @@ enum advertising_type {
 
 #define CURR_ADV(adv) (adv << 4)
 
-#define ZMK_ADV_CONN_NAME                                                                          \
+#define ZMK_ADV_CONN_NAME(_min, _max)                                                              \
     BT_LE_ADV_PARAM(BT_LE_ADV_OPT_CONN | BT_LE_ADV_OPT_USE_NAME | BT_LE_ADV_OPT_FORCE_NAME_IN_AD,  \
-                    BT_GAP_ADV_FAST_INT_MIN_2, BT_GAP_ADV_FAST_INT_MAX_2, NULL)
+                    _min, _max, NULL)
+#define ZMK_ADV_CONN_FAST ZMK_ADV_CONN_NAME(BT_GAP_ADV_FAST_INT_MIN_2, BT_GAP_ADV_FAST_INT_MAX_2)
+#define ZMK_ADV_CONN_SLOW ZMK_ADV_CONN_NAME(BT_GAP_ADV_SLOW_INT_MIN, BT_GAP_ADV_SLOW_INT_MAX)
+
+// Hosts reconnecting after a disconnect or a profile switch find the keyboard quickly with fast
+// advertising; after CONFIG_ZMK_BLE_ADV_FAST_TIMEOUT_MS it continues at slow intervals.
+static int64_t advertising_fast_until;
+static bool advertising_fast;
+// the host of directed advertising
+static bt_addr_le_t advertising_dir_peer;
+
+static void advertising_fast_window_start(void) {
+    advertising_fast_until = k_uptime_get() + CONFIG_ZMK_BLE_ADV_FAST_TIMEOUT_MS;
+}
+
+static void advertising_slow_callback(struct k_work *work);
+
+K_WORK_DELAYABLE_DEFINE(advertising_slow_work, advertising_slow_callback);
 
 static struct zmk_ble_profile profiles[ZMK_BLE_PROFILE_COUNT];
 static uint8_t active_profile;
 
+// A referenced connection to each profile, or NULL, so the report send path doesn't need a
+// connection lookup per report.
+static struct bt_conn *profile_conns[ZMK_BLE_PROFILE_COUNT];
+static struct k_spinlock profile_conns_lock;
+// a bit for each profile with a cached connection
+static atomic_t connected_profiles;
+// sends attempted while their profile wasn't connected
+static atomic_t profile_conn_misses;
+
 #define DEVICE_NAME CONFIG_BT_DEVICE_NAME
 #define DEVICE_NAME_LEN (sizeof(DEVICE_NAME) - 1)
 
@@ -103,6 +131,36 @@ bool zmk_ble_profile_is_open(uint8_t index) {
     return !bt_addr_le_cmp(&profiles[index].peer, BT_ADDR_LE_ANY);
 }
 
+static void set_profile_conn(uint8_t index, struct bt_conn *conn) {
+    k_spinlock_key_t key = k_spin_lock(&profile_conns_lock);
+    struct bt_conn *old = profile_conns[index];
+    profile_conns[index] = conn;
+    if (conn) {
+        atomic_or(&connected_profiles, BIT(index));
+    } else {
+        atomic_and(&connected_profiles, ~BIT(index));
+    }
+    k_spin_unlock(&profile_conns_lock, key);
+
+    if (old) {
+        bt_conn_unref(old);
+    }
+
+    uint32_t misses = (uint32_t)atomic_clear(&profile_conn_misses);
+    if (misses > 0) {
+        LOG_DBG("%u sends skipped, profile not connected", misses);
+    }
+}
+
+// Look the connection of a profile up again after its address changed.
+static void refresh_profile_conn(uint8_t index) {
+    const bt_addr_le_t *addr = &profiles[index].peer;
+
+    set_profile_conn(index, bt_addr_le_cmp(addr, BT_ADDR_LE_ANY)
+                                ? bt_conn_lookup_addr_le(BT_ID_DEFAULT, addr)
+                                : NULL);
+}
+
 void set_profile_address(uint8_t index, const bt_addr_le_t *addr) {
     char setting_name[17];
     char addr_str[BT_ADDR_LE_STR_LEN];
@@ -115,6 +173,7 @@ void set_profile_address(uint8_t index, const bt_addr_le_t *addr) {
 #if IS_ENABLED(CONFIG_SETTINGS)
     settings_save_one(setting_name, &profiles[index], sizeof(struct zmk_ble_profile));
 #endif
+    refresh_profile_conn(index);
     k_work_submit(&raise_profile_changed_event_work);
 }
 
@@ -164,16 +223,71 @@ bool zmk_ble_profile_is_connected(uint8_t index) {
         LOG_ERR("Advertising failed to start (err %d)", err);                                      \
         return err;                                                                                \
     }                                                                                              \
+    bt_addr_le_copy(&advertising_dir_peer, addr);                                                  \
     advertising_status = ZMK_ADV_DIR;
 
 #define CHECKED_OPEN_ADV()                                                                         \
-    err = bt_le_adv_start(ZMK_ADV_CONN_NAME, zmk_ble_ad, ARRAY_SIZE(zmk_ble_ad), NULL, 0);         \
+    advertising_fast = k_uptime_get() < advertising_fast_until;                                    \
+    err = bt_le_adv_start(advertising_fast ? ZMK_ADV_CONN_FAST : ZMK_ADV_CONN_SLOW, zmk_ble_ad,    \
+                          ARRAY_SIZE(zmk_ble_ad), NULL, 0);                                        \
     if (err) {                                                                                     \
         LOG_ERR("Advertising failed to start (err %d)", err);                                      \
         return err;                                                                                \
     }                                                                                              \
+    if (advertising_fast) {                                                                        \
+        k_work_reschedule(&advertising_slow_work, K_TIMEOUT_ABS_MS(advertising_fast_until));       \
+    }                                                                                              \
     advertising_status = ZMK_ADV_CONN;
 
+#if IS_ENABLED(CONFIG_ZMK_BLE_KEEP_PROFILES_CONNECTED)
+
+#if ZMK_BLE_IS_CENTRAL
+#define HOST_CONN_LIMIT (CONFIG_BT_MAX_CONN - ZMK_SPLIT_BLE_PERIPHERAL_COUNT)
+#else
+#define HOST_CONN_LIMIT CONFIG_BT_MAX_CONN
+#endif
+
+// Whether a bonded profile is waiting for its host to connect, and the controller has a connection
+// left for it.
+static bool standby_profile_disconnected(void) {
+    uint32_t connected = zmk_ble_connected_profiles();
+
+    if (__builtin_popcount(connected) >= HOST_CONN_LIMIT) {
+        return false;
+    }
+
+    for (int i = 0; i < ZMK_BLE_PROFILE_COUNT; i++) {
+        if (!zmk_ble_profile_is_open(i) && !(connected & BIT(i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Hosts of the other profiles stay connected with a high peripheral latency, so switching to
+// them only needs the latency lowered again, not a new connection.
+static void set_standby_conn_params(uint8_t index, bool standby) {
+    struct bt_conn *conn = zmk_ble_profile_conn(index);
+    if (conn == NULL) {
+        return;
+    }
+
+    struct bt_le_conn_param param = BT_LE_CONN_PARAM_INIT(
+        CONFIG_BT_PERIPHERAL_PREF_MIN_INT, CONFIG_BT_PERIPHERAL_PREF_MAX_INT,
+        standby ? CONFIG_ZMK_BLE_STANDBY_CONN_LATENCY : CONFIG_BT_PERIPHERAL_PREF_LATENCY,
+        CONFIG_BT_PERIPHERAL_PREF_TIMEOUT);
+
+    int err = bt_conn_le_param_update(conn, &param);
+    if (err) {
+        LOG_WRN("Failed to request %s connection parameters for profile %d (%d)",
+                standby ? "standby" : "active", index, err);
+    }
+
+    bt_conn_unref(conn);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_KEEP_PROFILES_CONNECTED)
+
 int update_advertising(void) {
     int err = 0;
     bt_addr_le_t *addr;
@@ -182,6 +296,10 @@ int update_advertising(void) {
 
     if (zmk_ble_active_profile_is_open()) {
         desired_adv = ZMK_ADV_CONN;
+#if IS_ENABLED(CONFIG_ZMK_BLE_KEEP_PROFILES_CONNECTED)
+    } else if (standby_profile_disconnected()) {
+        desired_adv = ZMK_ADV_CONN;
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_KEEP_PROFILES_CONNECTED)
     } else if (!zmk_ble_active_profile_is_connected()) {
         desired_adv = ZMK_ADV_CONN;
         // Need to fix directed advertising for privacy centrals. See
@@ -200,6 +318,10 @@ int update_advertising(void) {
         CHECKED_ADV_STOP();
         break;
     case ZMK_ADV_DIR + CURR_ADV(ZMK_ADV_DIR):
+        if (!bt_addr_le_cmp(&advertising_dir_peer, zmk_ble_active_profile_addr())) {
+            break; // already advertising to this host
+        }
+        __fallthrough;
     case ZMK_ADV_DIR + CURR_ADV(ZMK_ADV_CONN):
         CHECKED_ADV_STOP();
         CHECKED_DIR_ADV();
@@ -214,11 +336,36 @@ int update_advertising(void) {
     case ZMK_ADV_CONN + CURR_ADV(ZMK_ADV_NONE):
         CHECKED_OPEN_ADV();
         break;
+    case ZMK_ADV_CONN + CURR_ADV(ZMK_ADV_CONN):
+        // Already advertising. A profile switch or a disconnect that started a new fast window
+        // while it had slowed down brings it back to fast intervals; otherwise only
+        // advertising_slow_work changes the interval.
+        if (!advertising_fast && k_uptime_get() < advertising_fast_until) {
+            LOG_DBG("Switching back to fast advertising");
+            CHECKED_ADV_STOP();
+            CHECKED_OPEN_ADV();
+        }
+        break;
     }
 
     return 0;
 };
 
+static int restart_advertising_slow(void) {
+    int err;
+
+    LOG_DBG("Switching to slow advertising");
+    CHECKED_ADV_STOP();
+    CHECKED_OPEN_ADV();
+    return 0;
+}
+
+static void advertising_slow_callback(struct k_work *work) {
+    if (advertising_status == ZMK_ADV_CONN && advertising_fast) {
+        restart_advertising_slow();
+    }
+}
+
 static void update_advertising_callback(struct k_work *work) { update_advertising(); }
 
 K_WORK_DEFINE(update_advertising_work, update_advertising_callback);
@@ -268,17 +415,9 @@ bt_addr_le_t *zmk_ble_profile_address(uint8_t index) {
     return &profiles[index].peer;
 }
 
-#if IS_ENABLED(CONFIG_SETTINGS)
-static void ble_save_profile_work(struct k_work *work) {
-    settings_save_one("ble/active_profile", &active_profile, sizeof(active_profile));
-}
-
-static struct k_work_delayable ble_save_work;
-#endif
-
 static int ble_save_profile(void) {
 #if IS_ENABLED(CONFIG_SETTINGS)
-    return k_work_reschedule(&ble_save_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
+    return zmk_settings_save("ble/active_profile", &active_profile, sizeof(active_profile));
 #else
     return 0;
 #endif
@@ -294,9 +433,16 @@ int zmk_ble_prof_select(uint8_t index) {
         return 0;
     }
 
+#if IS_ENABLED(CONFIG_ZMK_BLE_KEEP_PROFILES_CONNECTED)
+    set_standby_conn_params(active_profile, true);
+    set_standby_conn_params(index, false);
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_KEEP_PROFILES_CONNECTED)
+
     active_profile = index;
     ble_save_profile();
 
+    advertising_fast_window_start();
+
     update_advertising();
 
     raise_profile_changed_event();
@@ -338,21 +484,25 @@ int zmk_ble_prof_disconnect(uint8_t index) {
 
 bt_addr_le_t *zmk_ble_active_profile_addr(void) { return &profiles[active_profile].peer; }
 
-struct bt_conn *zmk_ble_active_profile_conn(void) {
-    struct bt_conn *conn;
-    bt_addr_le_t *addr = zmk_ble_active_profile_addr();
-
-    if (!bt_addr_le_cmp(addr, BT_ADDR_LE_ANY)) {
-        LOG_WRN("Not sending, no active address for current profile");
-        return NULL;
-    } else if ((conn = bt_conn_lookup_addr_le(BT_ID_DEFAULT, addr)) == NULL) {
-        LOG_WRN("Not sending, not connected to active profile");
+struct bt_conn *zmk_ble_profile_conn(uint8_t index) {
+    if (index >= ZMK_BLE_PROFILE_COUNT) {
         return NULL;
     }
 
+    k_spinlock_key_t key = k_spin_lock(&profile_conns_lock);
+    struct bt_conn *conn = profile_conns[index] ? bt_conn_ref(profile_conns[index]) : NULL;
+    k_spin_unlock(&profile_conns_lock, key);
+
+    if (conn == NULL) {
+        atomic_inc(&profile_conn_misses);
+    }
     return conn;
 }
 
+struct bt_conn *zmk_ble_active_profile_conn(void) { return zmk_ble_profile_conn(active_profile); }
+
+uint32_t zmk_ble_connected_profiles(void) { return (uint32_t)atomic_get(&connected_profiles); }
+
 char *zmk_ble_active_profile_name(void) { return profiles[active_profile].name; }
 
 int zmk_ble_set_device_name(char *name) {
@@ -364,13 +514,12 @@ int zmk_ble_set_device_name(char *name) {
         return err;
     }
     if (advertising_status == ZMK_ADV_CONN) {
-        // Stop current advertising so it can restart with new name
-        err = bt_le_adv_stop();
-        advertising_status = ZMK_ADV_NONE;
+        // The name is part of the advertising data, which can change without a restart
+        err = bt_le_adv_update_data(zmk_ble_ad, ARRAY_SIZE(zmk_ble_ad), NULL, 0);
         if (err) {
-            LOG_ERR("Failed to stop advertising (err %d)", err);
-            return err;
+            LOG_ERR("Failed to update advertising data (err %d)", err);
         }
+        return err;
     }
     return update_advertising();
 }
@@ -522,6 +671,16 @@ static void connected(struct bt_conn *conn, uint8_t err) {
 
     update_advertising();
 
+    int index = zmk_ble_profile_index(bt_conn_get_dst(conn));
+    if (index >= 0) {
+        set_profile_conn(index, bt_conn_ref(conn));
+#if IS_ENABLED(CONFIG_ZMK_BLE_KEEP_PROFILES_CONNECTED)
+        if (index != active_profile) {
+            set_standby_conn_params(index, true);
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_KEEP_PROFILES_CONNECTED)
+    }
+
     if (is_conn_active_profile(conn)) {
         LOG_DBG("Active profile connected");
         k_work_submit(&raise_profile_changed_event_work);
@@ -545,8 +704,25 @@ static void disconnected(struct bt_conn *conn, uint8_t reason) {
 
     // We need to do this in a work callback, otherwise the advertising update will still see the
     // connection for a profile as active, and not start advertising yet.
+    advertising_fast_window_start();
     k_work_submit(&update_advertising_work);
 
+    // The connection can still be looked up here, so drop it from the cache directly.
+    k_spinlock_key_t key = k_spin_lock(&profile_conns_lock);
+    int cached = 0;
+    for (int i = 0; i < ZMK_BLE_PROFILE_COUNT; i++) {
+        if (profile_conns[i] == conn) {
+            profile_conns[i] = NULL;
+            atomic_and(&connected_profiles, ~BIT(i));
+            cached++;
+        }
+    }
+    k_spin_unlock(&profile_conns_lock, key);
+
+    while (cached-- > 0) {
+        bt_conn_unref(conn);
+    }
+
     if (is_conn_active_profile(conn)) {
         LOG_DBG("Active profile disconnected");
         k_work_submit(&raise_profile_changed_event_work);
@@ -686,6 +862,7 @@ static void zmk_ble_ready(int err) {
         return;
     }
 
+    advertising_fast_window_start();
     update_advertising();
 }
 
@@ -739,7 +916,6 @@ static int zmk_ble_init(void) {
 
 #if IS_ENABLED(CONFIG_SETTINGS)
     settings_register(&profiles_handler);
-    k_work_init_delayable(&ble_save_work, ble_save_profile_work);
 #else
     zmk_ble_complete_startup();
 #endif
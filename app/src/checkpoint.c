@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/devicetree.h>
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/checkpoint.h>
+#include <zmk/combos.h>
+#include <zmk/context.h>
+#include <zmk/fuzz.h>
+#include <zmk/hid.h>
+#include <zmk/keymap.h>
+#include <zmk/physical_layouts.h>
+#include <zmk/position_state.h>
+#include <zmk/settings.h>
+#include <zmk/workqueue.h>
+
+// A checkpoint is a settings image. Runtime state that isn't otherwise saved goes into it as the
+// checkpoint/layers setting, which is restored and deleted again when an instance boots from it.
+#define CHECKPOINT_LAYERS_SETTINGS_KEY "checkpoint/layers"
+
+struct checkpoint_layers {
+    zmk_keymap_layers_state_t state;
+    zmk_keymap_layers_state_t locks;
+};
+
+static bool hid_reports_empty(void) {
+    static const struct zmk_hid_keyboard_report_body empty_keyboard;
+    static const struct zmk_hid_consumer_report_body empty_consumer;
+
+    return memcmp(&zmk_hid_get_keyboard_report()->body, &empty_keyboard,
+                  sizeof(empty_keyboard)) == 0 &&
+           memcmp(&zmk_hid_get_consumer_report()->body, &empty_consumer,
+                  sizeof(empty_consumer)) == 0;
+}
+
+// Whether no key or behavior of the current context holds state that the checkpoint can't carry.
+static bool context_is_quiescent(void) {
+    if (zmk_position_state_pressed_count() > 0) {
+        return false;
+    }
+
+#if ZMK_COMBOS_LEN > 0
+    if (!zmk_combos_idle()) {
+        return false;
+    }
+#endif
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_behavior_hold_tap)
+    if (!zmk_behavior_hold_tap_idle()) {
+        return false;
+    }
+#endif
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_behavior_sticky_key)
+    if (!zmk_behavior_sticky_key_idle()) {
+        return false;
+    }
+#endif
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_behavior_tap_dance)
+    if (!zmk_behavior_tap_dance_idle()) {
+        return false;
+    }
+#endif
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_behavior_caps_word)
+    if (!zmk_behavior_caps_word_idle()) {
+        return false;
+    }
+#endif
+    return hid_reports_empty();
+}
+
+#if ZMK_CONTEXT_COUNT > 1
+
+static bool contexts_quiescent;
+
+static void contexts_quiescent_work_cb(struct k_work *work) {
+    uint8_t context = zmk_context_index();
+
+    contexts_quiescent = true;
+    for (uint8_t i = 0; i < ZMK_CONTEXT_COUNT && contexts_quiescent; i++) {
+        zmk_context_select(i);
+        contexts_quiescent = context_is_quiescent();
+    }
+
+    zmk_context_select(context);
+}
+
+static K_WORK_DEFINE(contexts_quiescent_work, contexts_quiescent_work_cb);
+
+// Checkpoints are saved from the IPC thread, but only the input work queue may select contexts.
+static bool contexts_are_quiescent(void) {
+    struct k_work_sync sync;
+
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &contexts_quiescent_work);
+    k_work_flush(&contexts_quiescent_work, &sync);
+    return contexts_quiescent;
+}
+
+#else
+
+static bool contexts_are_quiescent(void) { return context_is_quiescent(); }
+
+#endif
+
+// Key changes still queued would press keys the checkpoint doesn't know about, and queued
+// behaviors, e.g. the rest of a macro, would send reports it doesn't know about.
+static bool is_quiescent(void) {
+    if (zmk_physical_layouts_kscan_pending() || !zmk_behavior_queue_idle()) {
+        return false;
+    }
+
+    return contexts_are_quiescent();
+}
+
+int zmk_checkpoint_save(const char *path) {
+    if (!is_quiescent()) {
+        LOG_WRN("Not saving a checkpoint while keys or behaviors are active");
+        return -EBUSY;
+    }
+
+    zmk_keymap_flush_saved_changes();
+
+    int ret = zmk_settings_flush();
+    if (ret < 0) {
+        return ret;
+    }
+
+    const struct checkpoint_layers layers = {
+        .state = zmk_keymap_layer_state(),
+        .locks = zmk_keymap_layer_locks(),
+    };
+
+    ret = zmk_settings_export(path, CHECKPOINT_LAYERS_SETTINGS_KEY, &layers, sizeof(layers));
+    if (ret < 0) {
+        return ret;
+    }
+
+    LOG_INF("Saved checkpoint to %s", path);
+    return 0;
+}
+
+static struct checkpoint_layers loaded_layers;
+static bool layers_loaded;
+
+static int checkpoint_settings_set(const char *name, size_t len, settings_read_cb read_cb,
+                                   void *cb_arg) {
+    if (!settings_name_steq(name, "layers", NULL)) {
+        return 0;
+    }
+
+    if (len != sizeof(loaded_layers)) {
+        return -EINVAL;
+    }
+
+    int ret = read_cb(cb_arg, &loaded_layers, sizeof(loaded_layers));
+    if (ret < 0) {
+        return ret;
+    }
+
+    layers_loaded = true;
+    return 0;
+}
+
+static int checkpoint_settings_commit(void) {
+    if (!layers_loaded) {
+        return 0;
+    }
+
+    layers_loaded = false;
+
+    LOG_INF("Restoring layers 0x%08x from checkpoint", (uint32_t)loaded_layers.state);
+    // Layers start out inactive at boot, so only the active ones need to be set.
+    zmk_keymap_layers_set(loaded_layers.state, loaded_layers.state, loaded_layers.locks);
+
+    // The layers belong to the boot from the checkpoint only, not to later ones of this image.
+    return zmk_settings_delete(CHECKPOINT_LAYERS_SETTINGS_KEY);
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(checkpoint, "checkpoint", NULL, checkpoint_settings_set,
+                               checkpoint_settings_commit, NULL);
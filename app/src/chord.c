@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_chords
+
+#include <zephyr/device.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/kernel.h>
+
+#include <drivers/behavior.h>
+
+#include <zmk/behavior.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/matrix.h>
+#include <zmk/keymap.h>
+#include <zmk/virtual_key_position.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
+
+// Unlike combos, chords don't narrow down candidates while keys are pressed. Every key in the
+// chord `key-positions` is collected until all of them are released, and the resulting set of
+// keys is then looked up once, in a hash table of all chords. This keeps the cost per chord
+// constant, no matter how many thousands of chords the dictionary holds.
+
+// A set of chord keys, as bits indexed by their position in the `zmk,chords` key-positions.
+typedef uint64_t chord_keys_t;
+
+#define CHORD_KEYS_LEN DT_INST_PROP_LEN(0, key_positions)
+
+BUILD_ASSERT(CHORD_KEYS_LEN <= 64, "zmk,chords supports at most 64 key-positions");
+
+#define CHORD_KEY_BIT_IF_POSITION(n, prop, idx, position)                                          \
+    ((DT_PROP_BY_IDX(n, prop, idx) == (position)) ? BIT64(idx) : 0) |
+
+#define CHORD_KEY_BIT(position)                                                                    \
+    (DT_INST_FOREACH_PROP_ELEM_VARGS(0, key_positions, CHORD_KEY_BIT_IF_POSITION, position) 0)
+
+#define CHORD_POSITION_BIT(n, prop, idx) CHORD_KEY_BIT(DT_PROP_BY_IDX(n, prop, idx)) |
+
+#define CHORD_KEYS(n) (DT_FOREACH_PROP_ELEM(n, key_positions, CHORD_POSITION_BIT) 0)
+
+struct chord_cfg {
+    chord_keys_t keys;
+    struct zmk_behavior_binding behavior;
+};
+
+#define CHORD_INST(n)                                                                              \
+    BUILD_ASSERT(__builtin_popcountll(CHORD_KEYS(n)) == DT_PROP_LEN(n, key_positions),             \
+                 "Chord key-positions must be unique and part of the zmk,chords key-positions");
+
+DT_INST_FOREACH_CHILD(0, CHORD_INST)
+
+#define CHORD_CFG(n)                                                                               \
+    {                                                                                              \
+        .keys = CHORD_KEYS(n),                                                                     \
+        .behavior = ZMK_KEYMAP_EXTRACT_BINDING(0, n),                                              \
+    },
+
+static const struct chord_cfg chords[] = {DT_INST_FOREACH_CHILD(0, CHORD_CFG)};
+
+static const uint32_t chord_key_positions[] = DT_INST_PROP(0, key_positions);
+
+#define PROP_BIT_AT_IDX(n, prop, idx) BIT(DT_PROP_BY_IDX(n, prop, idx))
+
+static const uint32_t chords_layer_mask = COND_CODE_1(
+    DT_INST_NODE_HAS_PROP(0, layers),
+    (DT_INST_FOREACH_PROP_ELEM_SEP(0, layers, PROP_BIT_AT_IDX, (|))), (0));
+
+// Open addressing hash table of chord indexes plus one, zero marking an empty slot. Keeping it
+// at most half full keeps probe sequences short, at four bytes per chord.
+#define CHORD_TABLE_SIZE (2 * ARRAY_SIZE(chords) + 1)
+
+BUILD_ASSERT(ARRAY_SIZE(chords) < UINT16_MAX, "Too many chords");
+
+static uint16_t chord_table[CHORD_TABLE_SIZE];
+
+// maps a key position to its index in the chord key-positions, or -1
+static int8_t chord_key_index[ZMK_KEYMAP_LEN];
+
+// the chord keys currently held
+static chord_keys_t pressed_chord_keys;
+// every chord key pressed since the first key of the current chord
+static chord_keys_t collected_chord_keys;
+
+static uint32_t chord_hash(chord_keys_t keys) {
+    return (uint32_t)((keys * 0x9E3779B97F4A7C15ULL) >> 32) % CHORD_TABLE_SIZE;
+}
+
+static int find_chord(chord_keys_t keys) {
+    for (uint32_t slot = chord_hash(keys); chord_table[slot];
+         slot = (slot + 1) % CHORD_TABLE_SIZE) {
+        if (chords[chord_table[slot] - 1].keys == keys) {
+            return chord_table[slot] - 1;
+        }
+    }
+
+    return -1;
+}
+
+static bool chords_active_on_layer(uint8_t layer) {
+    if (!chords_layer_mask) {
+        return true;
+    }
+
+    return chords_layer_mask & BIT(layer);
+}
+
+static void trigger_chord(chord_keys_t keys, int64_t timestamp) {
+    int chord_idx = find_chord(keys);
+    if (chord_idx < 0) {
+        LOG_DBG("No chord for keys 0x%llx", keys);
+        return;
+    }
+
+    struct zmk_behavior_binding_event event = {
+        .position = ZMK_VIRTUAL_KEY_POSITION_CHORD(chord_idx),
+        .timestamp = timestamp,
+#if IS_ENABLED(CONFIG_ZMK_SPLIT)
+        .source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL,
+#endif
+    };
+
+    LOG_DBG("chord %d triggered", chord_idx);
+
+    zmk_behavior_invoke_binding(&chords[chord_idx].behavior, event, true);
+    zmk_behavior_invoke_binding(&chords[chord_idx].behavior, event, false);
+}
+
+static int position_state_changed_listener(const zmk_event_t *eh) {
+    struct zmk_position_state_changed *data = as_zmk_position_state_changed(eh);
+    if (data == NULL || data->position >= ZMK_KEYMAP_LEN || chord_key_index[data->position] < 0) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    chord_keys_t key = BIT64(chord_key_index[data->position]);
+
+    if (data->state) { // keydown
+        // the layer is only checked when a chord starts, later keys always join it
+        if (!pressed_chord_keys && !chords_active_on_layer(zmk_keymap_highest_layer_active())) {
+            return ZMK_EV_EVENT_BUBBLE;
+        }
+
+        pressed_chord_keys |= key;
+        collected_chord_keys |= key;
+        return ZMK_EV_EVENT_HANDLED;
+    }
+
+    // keyup: a key whose press bubbled releases the same way
+    if (!(pressed_chord_keys & key)) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    pressed_chord_keys &= ~key;
+    if (!pressed_chord_keys) {
+        trigger_chord(collected_chord_keys, data->timestamp);
+        collected_chord_keys = 0;
+    }
+
+    return ZMK_EV_EVENT_HANDLED;
+}
+
+ZMK_LISTENER(chord, position_state_changed_listener);
+ZMK_SUBSCRIPTION(chord, zmk_position_state_changed);
+
+static int chord_init(void) {
+    memset(chord_key_index, -1, sizeof(chord_key_index));
+    for (int i = 0; i < ARRAY_SIZE(chord_key_positions); i++) {
+        if (chord_key_positions[i] < ZMK_KEYMAP_LEN) {
+            chord_key_index[chord_key_positions[i]] = i;
+        }
+    }
+
+    for (int i = 0; i < ARRAY_SIZE(chords); i++) {
+        if (find_chord(chords[i].keys) >= 0) {
+            LOG_WRN("Ignoring chord %d, which uses the same keys as an earlier chord", i);
+            continue;
+        }
+
+        uint32_t slot = chord_hash(chords[i].keys);
+        while (chord_table[slot]) {
+            slot = (slot + 1) % CHORD_TABLE_SIZE;
+        }
+        chord_table[slot] = i + 1;
+    }
+
+    LOG_DBG("Have %d chords", ARRAY_SIZE(chords));
+    return 0;
+}
+
+SYS_INIT(chord_init, APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+#endif
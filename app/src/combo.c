@@ -15,7 +15,10 @@
 #include <drivers/behavior.h>
 
 #include <zmk/behavior.h>
+#include <zmk/behavior_timer.h>
+#include <zmk/context.h>
 #include <zmk/event_manager.h>
+#include <zmk/fuzz.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/keycode_state_changed.h>
 #include <zmk/hid.h>
@@ -23,7 +26,7 @@
 #include <zmk/keymap.h>
 #include <zmk/virtual_key_position.h>
 
-LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+LOG_MODULE_REGISTER(zmk_combo, CONFIG_ZMK_LOG_LEVEL);
 
 #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
 
@@ -63,7 +66,7 @@ struct active_combo {
     // The keys are removed from this array when they are released.
     // Once this array is empty, the behavior is released.
     uint16_t key_positions_pressed_count;
-    struct zmk_position_state_changed_event key_positions_pressed[MAX_COMBO_KEYS];
+    uint32_t key_positions_pressed[MAX_COMBO_KEYS];
 };
 
 #define PROP_BIT_AT_IDX(n, prop, idx) BIT(DT_PROP_BY_IDX(n, prop, idx))
@@ -95,125 +98,248 @@ struct active_combo {
 // by key position length and on each iteration, only include entries where the `key-positions`
 // length matches.
 // Doing so allows our bitmasks to be "shorted key positions list first" when searching for matches.
-// `20` is chosen as a reasonable limit, since the theoretical maximum number of keys you might
-// reasonably press simultaneously with 10 fingers is 20 keys, two keys per finger.
-static const struct combo_cfg combos[] = {
-    LISTIFY(20, COMBO_CONFIGS_WITH_MATCHING_POSITIONS_LEN, (), 0)};
+// The limit defaults to 20, since the theoretical maximum number of keys you might reasonably
+// press simultaneously with 10 fingers is 20 keys, two keys per finger.
+static const struct combo_cfg combos[] = {LISTIFY(CONFIG_ZMK_COMBO_MAX_KEY_POSITIONS,
+                                                  COMBO_CONFIGS_WITH_MATCHING_POSITIONS_LEN, (), 0)};
 
 #define COMBO_ONE(n) +1
 
 #define COMBO_CHILDREN_COUNT (0 DT_INST_FOREACH_CHILD(0, COMBO_ONE))
 
+BUILD_ASSERT(ARRAY_SIZE(combos) == COMBO_CHILDREN_COUNT,
+             "A combo has more key-positions than CONFIG_ZMK_COMBO_MAX_KEY_POSITIONS");
+
+#define COMBO_KEY_POSITIONS_LEN(n) +DT_PROP_LEN(n, key_positions)
+
+#define COMBO_KEY_POSITIONS_COUNT (0 DT_INST_FOREACH_CHILD(0, COMBO_KEY_POSITIONS_LEN))
+
+BUILD_ASSERT(COMBO_KEY_POSITIONS_COUNT <= UINT16_MAX, "Too many combo key positions");
+
 // We need at least 4 bytes to avoid alignment issues
 #define BYTES_FOR_COMBOS_MASK DIV_ROUND_UP(COMBO_CHILDREN_COUNT, 32)
 
-uint8_t pressed_keys_count = 0;
-// set of keys pressed
-struct zmk_position_state_changed_event pressed_keys[MAX_COMBO_KEYS] = {};
-// the set of candidate combos based on the currently pressed_keys
-uint32_t candidates[BYTES_FOR_COMBOS_MASK];
-// the last candidate that was completely pressed
-int16_t fully_pressed_combo = INT16_MAX;
-// a lookup dict that maps a key position to all combos on that position
-uint32_t combo_lookup[ZMK_KEYMAP_LEN][BYTES_FOR_COMBOS_MASK] = {};
-// combos that have been activated and still have (some) keys pressed
-// this array is always contiguous from 0.
-struct active_combo active_combos[CONFIG_ZMK_COMBO_MAX_PRESSED_COMBOS] = {};
-uint8_t active_combo_count = 0;
-
-struct k_work_delayable timeout_task;
-int64_t timeout_task_timeout_at;
-
-// this keeps track of the last non-combo, non-mod key tap
-int64_t last_tapped_timestamp = INT32_MIN;
-// this keeps track of the last time a combo was pressed
-int64_t last_combo_timestamp = INT32_MIN;
+// a lookup dict that maps a key position to all combos on that position, as sorted runs of combo
+// indexes: the combos on position p are combo_lookup[combo_lookup_start[p]] up to (excluding)
+// combo_lookup[combo_lookup_start[p + 1]]. Its size scales with the combos' key positions only.
+uint16_t combo_lookup_start[ZMK_KEYMAP_LEN + 1] = {};
+uint16_t combo_lookup[COMBO_KEY_POSITIONS_COUNT] = {};
+// the set of combos allowed on each layer, from the combos' `layers` property
+uint32_t candidates_allowed[ZMK_KEYMAP_LAYERS_LEN][BYTES_FOR_COMBOS_MASK] = {};
+
+struct combo_state {
+    uint8_t pressed_keys_count;
+    // set of keys pressed, as handles to the captured events in the event manager's pool
+    zmk_event_handle_t pressed_keys[MAX_COMBO_KEYS];
+    // the set of candidate combos based on the currently pressed_keys
+    uint32_t candidates[BYTES_FOR_COMBOS_MASK];
+    // the last candidate that was completely pressed
+    int16_t fully_pressed_combo;
+    // combos that have been activated and still have (some) keys pressed
+    // this array is always contiguous from 0.
+    struct active_combo active_combos[CONFIG_ZMK_COMBO_MAX_PRESSED_COMBOS];
+    uint8_t active_combo_count;
+
+    // the candidates as a binary min-heap of combo indexes ordered by timeout. Entries are removed
+    // lazily: one whose combo has left `candidates` is only dropped once it reaches the top.
+    uint16_t candidate_timeouts[COMBO_CHILDREN_COUNT];
+    uint16_t candidate_timeouts_len;
+
+    // Due at the earliest candidate timeout, counted from the timestamp of the first pressed key.
+    struct zmk_behavior_timer timeout_timer;
+
+    // this keeps track of the last non-combo, non-mod key tap
+    int64_t last_tapped_timestamp;
+    // this keeps track of the last time a combo was pressed
+    int64_t last_combo_timestamp;
+};
+
+ZMK_CONTEXT_STATE_DEFINE(combo_states, struct combo_state,
+                         {
+                             .fully_pressed_combo = INT16_MAX,
+                             .last_tapped_timestamp = INT32_MIN,
+                             .last_combo_timestamp = INT32_MIN,
+                         });
+
+#define STATE ZMK_CONTEXT_STATE(combo_states)
+
+static inline const struct zmk_position_state_changed *pressed_key(int index) {
+    return as_zmk_position_state_changed(zmk_event_pool_get(STATE->pressed_keys[index]));
+}
 
 static void store_last_tapped(int64_t timestamp) {
-    if (timestamp > last_combo_timestamp) {
-        last_tapped_timestamp = timestamp;
+    if (timestamp > STATE->last_combo_timestamp) {
+        STATE->last_tapped_timestamp = timestamp;
     }
 }
 
-// Store the combo key pointer in the combos array, one pointer for each key position
-// The combos are sorted shortest-first, then by virtual-key-position.
 static int initialize_combo(size_t index) {
     const struct combo_cfg *new_combo = &combos[index];
 
-    for (size_t kp = 0; kp < new_combo->key_position_len; kp++) {
-        sys_bitfield_set_bit((mem_addr_t)&combo_lookup[new_combo->key_positions[kp]], index);
+    // A combo without any layers is active on all of them.
+    for (size_t layer = 0; layer < ZMK_KEYMAP_LAYERS_LEN; layer++) {
+        if (!new_combo->layer_mask || (new_combo->layer_mask & BIT(layer))) {
+            sys_bitfield_set_bit((mem_addr_t)&candidates_allowed[layer], index);
+        }
     }
 
     return 0;
 }
 
-static bool combo_active_on_layer(const struct combo_cfg *combo, uint8_t layer) {
-    if (!combo->layer_mask) {
-        return true;
+// Store the combo indexes in the lookup, one entry for each key position of each combo.
+// The combos are sorted shortest-first, then by virtual-key-position, and so is each run.
+static void initialize_combo_lookup() {
+    for (size_t i = 0; i < ARRAY_SIZE(combos); i++) {
+        for (size_t kp = 0; kp < combos[i].key_position_len; kp++) {
+            combo_lookup_start[combos[i].key_positions[kp]]++;
+        }
     }
 
-    return combo->layer_mask & BIT(layer);
+    // Turn the counts into the end of each run, then fill every run back to front.
+    uint16_t end = 0;
+    for (size_t pos = 0; pos < ZMK_KEYMAP_LEN; pos++) {
+        end += combo_lookup_start[pos];
+        combo_lookup_start[pos] = end;
+    }
+    combo_lookup_start[ZMK_KEYMAP_LEN] = end;
+
+    for (int i = ARRAY_SIZE(combos) - 1; i >= 0; i--) {
+        for (size_t kp = 0; kp < combos[i].key_position_len; kp++) {
+            combo_lookup[--combo_lookup_start[combos[i].key_positions[kp]]] = i;
+        }
+    }
 }
 
 static bool is_quick_tap(const struct combo_cfg *combo, int64_t timestamp) {
-    return (last_tapped_timestamp + combo->require_prior_idle_ms) > timestamp;
+    return (STATE->last_tapped_timestamp + combo->require_prior_idle_ms) > timestamp;
 }
 
-static int setup_candidates_for_first_keypress(int32_t position, int64_t timestamp) {
-    int number_of_combo_candidates = 0;
-    uint8_t highest_active_layer = zmk_keymap_highest_layer_active();
+static inline bool timeout_before(uint16_t a, uint16_t b) {
+    return combos[a].timeout_ms < combos[b].timeout_ms;
+}
 
-    for (size_t i = 0; i < ARRAY_SIZE(combos); i++) {
-        if (sys_bitfield_test_bit((mem_addr_t)&combo_lookup[position], i)) {
-            const struct combo_cfg *combo = &combos[i];
-            if (combo_active_on_layer(combo, highest_active_layer) &&
-                !is_quick_tap(combo, timestamp)) {
-                sys_bitfield_set_bit((mem_addr_t)&candidates, i);
-                number_of_combo_candidates++;
-            }
-            // LOG_DBG("combo timeout %d %d %d", position, i, candidates[i].timeout_at);
+static void push_candidate_timeout(uint16_t combo_idx) {
+    int i = STATE->candidate_timeouts_len++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!timeout_before(combo_idx, STATE->candidate_timeouts[parent])) {
+            break;
         }
+        STATE->candidate_timeouts[i] = STATE->candidate_timeouts[parent];
+        i = parent;
     }
+    STATE->candidate_timeouts[i] = combo_idx;
+}
 
-    return number_of_combo_candidates;
+static void pop_candidate_timeout() {
+    uint16_t last = STATE->candidate_timeouts[--STATE->candidate_timeouts_len];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= STATE->candidate_timeouts_len) {
+            break;
+        }
+        if (child + 1 < STATE->candidate_timeouts_len &&
+            timeout_before(STATE->candidate_timeouts[child + 1],
+                           STATE->candidate_timeouts[child])) {
+            child++;
+        }
+        if (!timeout_before(STATE->candidate_timeouts[child], last)) {
+            break;
+        }
+        STATE->candidate_timeouts[i] = STATE->candidate_timeouts[child];
+        i = child;
+    }
+    STATE->candidate_timeouts[i] = last;
+}
+
+// returns the candidate with the earliest timeout, or -1 if there are no candidates left.
+static int first_timeout_candidate() {
+    while (STATE->candidate_timeouts_len > 0) {
+        uint16_t combo_idx = STATE->candidate_timeouts[0];
+        if (sys_bitfield_test_bit((mem_addr_t)&STATE->candidates, combo_idx)) {
+            return combo_idx;
+        }
+        pop_candidate_timeout();
+    }
+    return -1;
+}
+
+// returns the lowest candidate index, i.e. the candidate with the fewest keys, or -1.
+static int first_candidate() {
+    for (int i = 0; i < BYTES_FOR_COMBOS_MASK; i++) {
+        if (STATE->candidates[i]) {
+            return i * 32 + find_lsb_set(STATE->candidates[i]) - 1;
+        }
+    }
+    return -1;
 }
 
-static inline uint8_t zero_one_or_more_bits(uint32_t field) {
-    if (field == 0) {
+static int count_candidates() {
+    int count = 0;
+    for (int i = 0; i < BYTES_FOR_COMBOS_MASK; i++) {
+        count += __builtin_popcount(STATE->candidates[i]);
+    }
+    return count;
+}
+
+static int setup_candidates_for_first_keypress(int32_t position, int64_t timestamp) {
+    int number_of_combo_candidates = 0;
+    uint8_t highest_active_layer = zmk_keymap_highest_layer_active();
+
+    if (highest_active_layer >= ZMK_KEYMAP_LAYERS_LEN) {
         return 0;
     }
-    if ((field & (field - 1)) == 0) {
-        return 1;
+
+    const uint32_t *allowed = candidates_allowed[highest_active_layer];
+
+    STATE->candidate_timeouts_len = 0;
+
+    // only visit the combos on this position
+    for (int i = combo_lookup_start[position]; i < combo_lookup_start[position + 1]; i++) {
+        uint16_t combo_idx = combo_lookup[i];
+        if (!sys_bitfield_test_bit((mem_addr_t)allowed, combo_idx) ||
+            sys_bitfield_test_bit((mem_addr_t)&STATE->candidates, combo_idx)) {
+            continue;
+        }
+
+        if (!is_quick_tap(&combos[combo_idx], timestamp)) {
+            sys_bitfield_set_bit((mem_addr_t)&STATE->candidates, combo_idx);
+            push_candidate_timeout(combo_idx);
+            number_of_combo_candidates++;
+        }
     }
-    return 2;
+
+    return number_of_combo_candidates;
 }
 
 static int filter_candidates(int32_t position) {
-    int matches = 0;
-    for (int i = 0; i < BYTES_FOR_COMBOS_MASK; i++) {
-        candidates[i] &= combo_lookup[position][i];
-        if (matches < 2) {
-            matches += zero_one_or_more_bits(candidates[i]);
+    // keep only the candidates that are also on this position
+    uint32_t matching[BYTES_FOR_COMBOS_MASK] = {};
+    for (int i = combo_lookup_start[position]; i < combo_lookup_start[position + 1]; i++) {
+        if (sys_bitfield_test_bit((mem_addr_t)&STATE->candidates, combo_lookup[i])) {
+            sys_bitfield_set_bit((mem_addr_t)&matching, combo_lookup[i]);
         }
     }
+    memcpy(STATE->candidates, matching, sizeof(STATE->candidates));
+
+    int matches = count_candidates();
 
     LOG_DBG("combo matches after filter %d", matches);
     return matches;
 }
 
 static int64_t first_candidate_timeout() {
-    if (pressed_keys_count == 0) {
+    if (STATE->pressed_keys_count == 0) {
         return LONG_MAX;
     }
 
-    int64_t first_timeout = LONG_MAX;
-    for (int i = 0; i < ARRAY_SIZE(combos); i++) {
-        if (sys_bitfield_test_bit((mem_addr_t)&candidates, i)) {
-            first_timeout = MIN(first_timeout, combos[i].timeout_ms);
-        }
+    int combo_idx = first_timeout_candidate();
+    if (combo_idx < 0) {
+        return LONG_MAX;
     }
 
-    return pressed_keys[0].data.timestamp + first_timeout;
+    return pressed_key(0)->timestamp + combos[combo_idx].timeout_ms;
 }
 
 static inline bool candidate_is_completely_pressed(const struct combo_cfg *candidate) {
@@ -222,26 +348,25 @@ static inline bool candidate_is_completely_pressed(const struct combo_cfg *candi
     // since events may have been reraised after clearing one or more slots at
     // the start of pressed_keys (see: release_pressed_keys), we have to check
     // that each key needed to trigger the combo was pressed, not just the last.
-    return candidate->key_position_len == pressed_keys_count;
+    return candidate->key_position_len == STATE->pressed_keys_count;
 }
 
 static int cleanup();
 
 static int filter_timed_out_candidates(int64_t timestamp) {
-    __ASSERT(pressed_keys_count > 0, "Searching for a candidate timeout with no keys pressed");
+    __ASSERT(STATE->pressed_keys_count > 0,
+             "Searching for a candidate timeout with no keys pressed");
 
-    int remaining_candidates = 0;
-    for (int i = 0; i < ARRAY_SIZE(combos); i++) {
-        if (sys_bitfield_test_bit((mem_addr_t)&candidates, i)) {
-
-            if (pressed_keys[0].data.timestamp + combos[i].timeout_ms > timestamp) {
-                remaining_candidates++;
-            } else {
-                sys_bitfield_clear_bit((mem_addr_t)&candidates, i);
-            }
-        }
+    // timed out candidates are always the ones at the top of the heap
+    int combo_idx;
+    while ((combo_idx = first_timeout_candidate()) >= 0 &&
+           pressed_key(0)->timestamp + combos[combo_idx].timeout_ms <= timestamp) {
+        sys_bitfield_clear_bit((mem_addr_t)&STATE->candidates, combo_idx);
+        pop_candidate_timeout();
     }
 
+    int remaining_candidates = count_candidates();
+
     LOG_DBG(
         "after filtering out timed out combo candidates: remaining_candidates=%d timestamp=%lld",
         remaining_candidates, timestamp);
@@ -250,28 +375,37 @@ static int filter_timed_out_candidates(int64_t timestamp) {
 }
 
 static int capture_pressed_key(const struct zmk_position_state_changed *ev) {
-    if (pressed_keys_count == MAX_COMBO_KEYS) {
+    if (STATE->pressed_keys_count == MAX_COMBO_KEYS) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    zmk_event_handle_t handle = capture_zmk_position_state_changed(ev);
+    if (handle < 0) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
-    pressed_keys[pressed_keys_count++] = copy_raised_zmk_position_state_changed(ev);
+    STATE->pressed_keys[STATE->pressed_keys_count++] = handle;
     return ZMK_EV_EVENT_CAPTURED;
 }
 
 const struct zmk_listener zmk_listener_combo;
 
 static int release_pressed_keys() {
-    uint8_t count = pressed_keys_count;
-    pressed_keys_count = 0;
+    uint8_t count = STATE->pressed_keys_count;
+    STATE->pressed_keys_count = 0;
+    // Re-raised events may be captured again, so work from a copy of the handles.
+    zmk_event_handle_t handles[MAX_COMBO_KEYS];
+    memcpy(handles, STATE->pressed_keys, count * sizeof(handles[0]));
     for (int i = 0; i < count; i++) {
-        struct zmk_position_state_changed_event *ev = &pressed_keys[i];
+        const struct zmk_position_state_changed *ev =
+            as_zmk_position_state_changed(zmk_event_pool_get(handles[i]));
         if (i == 0) {
-            LOG_DBG("combo: releasing position event %d", ev->data.position);
-            ZMK_EVENT_RELEASE(*ev);
+            LOG_DBG("combo: releasing position event %d", ev->position);
+            zmk_event_pool_release(handles[i]);
         } else {
             // reprocess events (see tests/combo/fully-overlapping-combos-3 for why this is needed)
-            LOG_DBG("combo: reraising position event %d", ev->data.position);
-            ZMK_EVENT_RAISE(*ev);
+            LOG_DBG("combo: reraising position event %d", ev->position);
+            zmk_event_pool_raise(handles[i]);
         }
     }
 
@@ -288,7 +422,7 @@ static inline int press_combo_behavior(int combo_idx, const struct combo_cfg *co
 #endif
     };
 
-    last_combo_timestamp = timestamp;
+    STATE->last_combo_timestamp = timestamp;
 
     return zmk_behavior_invoke_binding(&combo->behavior, event, true);
 }
@@ -308,26 +442,29 @@ static inline int release_combo_behavior(int combo_idx, const struct combo_cfg *
 
 static void move_pressed_keys_to_active_combo(struct active_combo *active_combo) {
 
-    int combo_length = MIN(pressed_keys_count, combos[active_combo->combo_idx].key_position_len);
+    int combo_length =
+        MIN(STATE->pressed_keys_count, combos[active_combo->combo_idx].key_position_len);
+    // The combo consumes these events, so only their positions are kept.
     for (int i = 0; i < combo_length; i++) {
-        active_combo->key_positions_pressed[i] = pressed_keys[i];
+        active_combo->key_positions_pressed[i] = pressed_key(i)->position;
+        zmk_event_pool_free(STATE->pressed_keys[i]);
     }
     active_combo->key_positions_pressed_count = combo_length;
 
     // move any other pressed keys up
-    for (int i = 0; i + combo_length < pressed_keys_count; i++) {
-        pressed_keys[i] = pressed_keys[i + combo_length];
+    for (int i = 0; i + combo_length < STATE->pressed_keys_count; i++) {
+        STATE->pressed_keys[i] = STATE->pressed_keys[i + combo_length];
     }
 
-    pressed_keys_count -= combo_length;
+    STATE->pressed_keys_count -= combo_length;
 }
 
 static struct active_combo *store_active_combo(int32_t combo_idx) {
     for (int i = 0; i < CONFIG_ZMK_COMBO_MAX_PRESSED_COMBOS; i++) {
-        if (active_combos[i].combo_idx == UINT16_MAX) {
-            active_combos[i].combo_idx = combo_idx;
-            active_combo_count++;
-            return &active_combos[i];
+        if (STATE->active_combos[i].combo_idx == UINT16_MAX) {
+            STATE->active_combos[i].combo_idx = combo_idx;
+            STATE->active_combo_count++;
+            return &STATE->active_combos[i];
         }
     }
     LOG_ERR("Unable to store combo; already %d active. Increase "
@@ -343,25 +480,25 @@ static void activate_combo(int combo_idx) {
         release_pressed_keys();
         return;
     }
+    int64_t timestamp = pressed_key(0)->timestamp;
     move_pressed_keys_to_active_combo(active_combo);
-    press_combo_behavior(combo_idx, &combos[combo_idx],
-                         active_combo->key_positions_pressed[0].data.timestamp);
+    press_combo_behavior(combo_idx, &combos[combo_idx], timestamp);
 }
 
 static void deactivate_combo(int active_combo_index) {
-    active_combo_count--;
-    if (active_combo_index != active_combo_count) {
-        memcpy(&active_combos[active_combo_index], &active_combos[active_combo_count],
-               sizeof(struct active_combo));
+    STATE->active_combo_count--;
+    if (active_combo_index != STATE->active_combo_count) {
+        memcpy(&STATE->active_combos[active_combo_index],
+               &STATE->active_combos[STATE->active_combo_count], sizeof(struct active_combo));
     }
-    active_combos[active_combo_count] = (struct active_combo){0};
-    active_combos[active_combo_count].combo_idx = UINT16_MAX;
+    STATE->active_combos[STATE->active_combo_count] = (struct active_combo){0};
+    STATE->active_combos[STATE->active_combo_count].combo_idx = UINT16_MAX;
 }
 
 /* returns true if a key was released. */
 static bool release_combo_key(int32_t position, int64_t timestamp) {
-    for (int combo_idx = 0; combo_idx < active_combo_count; combo_idx++) {
-        struct active_combo *active_combo = &active_combos[combo_idx];
+    for (int combo_idx = 0; combo_idx < STATE->active_combo_count; combo_idx++) {
+        struct active_combo *active_combo = &STATE->active_combos[combo_idx];
 
         bool key_released = false;
         bool all_keys_pressed = active_combo->key_positions_pressed_count ==
@@ -371,7 +508,7 @@ static bool release_combo_key(int32_t position, int64_t timestamp) {
             if (key_released) {
                 active_combo->key_positions_pressed[i - 1] = active_combo->key_positions_pressed[i];
                 all_keys_released = false;
-            } else if (active_combo->key_positions_pressed[i].data.position != position) {
+            } else if (active_combo->key_positions_pressed[i] != position) {
                 all_keys_released = false;
             } else { // position matches
                 key_released = true;
@@ -394,33 +531,34 @@ static bool release_combo_key(int32_t position, int64_t timestamp) {
 }
 
 static int cleanup() {
-    k_work_cancel_delayable(&timeout_task);
-    memset(candidates, 0, BYTES_FOR_COMBOS_MASK * sizeof(uint32_t));
-    if (fully_pressed_combo != INT16_MAX) {
-        activate_combo(fully_pressed_combo);
-        fully_pressed_combo = INT16_MAX;
+    zmk_behavior_timer_cancel(&STATE->timeout_timer);
+    memset(STATE->candidates, 0, BYTES_FOR_COMBOS_MASK * sizeof(uint32_t));
+    STATE->candidate_timeouts_len = 0;
+    if (STATE->fully_pressed_combo != INT16_MAX) {
+        activate_combo(STATE->fully_pressed_combo);
+        STATE->fully_pressed_combo = INT16_MAX;
     }
     return release_pressed_keys();
 }
 
 static void update_timeout_task() {
     int64_t first_timeout = first_candidate_timeout();
-    if (timeout_task_timeout_at == first_timeout) {
-        return;
-    }
     if (first_timeout == LLONG_MAX) {
-        timeout_task_timeout_at = 0;
-        k_work_cancel_delayable(&timeout_task);
+        zmk_behavior_timer_cancel(&STATE->timeout_timer);
         return;
     }
-    if (k_work_schedule(&timeout_task, K_MSEC(first_timeout - k_uptime_get())) >= 0) {
-        timeout_task_timeout_at = first_timeout;
+    if (zmk_behavior_timer_is_pending(&STATE->timeout_timer) &&
+        STATE->timeout_timer.deadline == first_timeout) {
+        return;
     }
+    // The deadline is absolute, so a timeout that a later key press already passed by its own
+    // timestamp has been filtered out before this, whenever that press is processed.
+    zmk_behavior_timer_start(&STATE->timeout_timer, first_timeout);
 }
 
 static int position_state_down(const zmk_event_t *ev, struct zmk_position_state_changed *data) {
     int num_candidates;
-    if (!pressed_keys_count) {
+    if (!STATE->pressed_keys_count) {
         num_candidates = setup_candidates_for_first_keypress(data->position, data->timestamp);
         if (num_candidates == 0) {
             return ZMK_EV_EVENT_BUBBLE;
@@ -435,18 +573,17 @@ static int position_state_down(const zmk_event_t *ev, struct zmk_position_state_
     update_timeout_task();
 
     if (num_candidates) {
-        for (int i = 0; i < ARRAY_SIZE(combos); i++) {
-            if (sys_bitfield_test_bit((mem_addr_t)&candidates, i)) {
-                const struct combo_cfg *candidate_combo = &combos[i];
-                if (candidate_is_completely_pressed(candidate_combo)) {
-                    fully_pressed_combo = i;
-                    if (num_candidates == 1) {
-                        cleanup();
-                    }
+        int i = first_candidate();
+        if (i >= 0) {
+            const struct combo_cfg *candidate_combo = &combos[i];
+            if (candidate_is_completely_pressed(candidate_combo)) {
+                STATE->fully_pressed_combo = i;
+                if (num_candidates == 1) {
+                    cleanup();
                 }
-
-                return ret;
             }
+
+            return ret;
         }
     } else {
         cleanup();
@@ -472,12 +609,8 @@ static int position_state_up(const zmk_event_t *ev, struct zmk_position_state_ch
     return ZMK_EV_EVENT_BUBBLE;
 }
 
-static void combo_timeout_handler(struct k_work *item) {
-    if (timeout_task_timeout_at == 0 || k_uptime_get() < timeout_task_timeout_at) {
-        // timer was cancelled or rescheduled.
-        return;
-    }
-    if (filter_timed_out_candidates(timeout_task_timeout_at) == 0) {
+static void combo_timeout_handler(struct zmk_behavior_timer *timer) {
+    if (filter_timed_out_candidates(timer->deadline) == 0) {
         LOG_DBG("CLEANUP!");
         cleanup();
     }
@@ -521,18 +654,30 @@ ZMK_SUBSCRIPTION(combo, zmk_position_state_changed);
 ZMK_SUBSCRIPTION(combo, zmk_keycode_state_changed);
 
 static int combo_init(void) {
-    for (size_t i = 0; i < CONFIG_ZMK_COMBO_MAX_PRESSED_COMBOS; i++) {
-        active_combos[i].combo_idx = UINT16_MAX;
+    struct combo_state *state;
+
+    ZMK_CONTEXT_STATE_FOREACH(combo_states, state) {
+        for (size_t i = 0; i < CONFIG_ZMK_COMBO_MAX_PRESSED_COMBOS; i++) {
+            state->active_combos[i].combo_idx = UINT16_MAX;
+        }
+
+        zmk_behavior_timer_init(&state->timeout_timer, combo_timeout_handler);
     }
 
-    k_work_init_delayable(&timeout_task, combo_timeout_handler);
     LOG_WRN("Have %d combos!", ARRAY_SIZE(combos));
     for (int i = 0; i < ARRAY_SIZE(combos); i++) {
         initialize_combo(i);
     }
+    initialize_combo_lookup();
     return 0;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_FUZZ) || IS_ENABLED(CONFIG_ZMK_CHECKPOINT)
+bool zmk_combos_idle(void) {
+    return STATE->active_combo_count == 0 && STATE->pressed_keys_count == 0;
+}
+#endif // IS_ENABLED(CONFIG_ZMK_FUZZ) || IS_ENABLED(CONFIG_ZMK_CHECKPOINT)
+
 SYS_INIT(combo_init, APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
 
 #endif
@@ -10,6 +10,7 @@
 #include <zephyr/kernel.h>
 
 #include <zephyr/devicetree.h>
+#include <zephyr/init.h>
 #include <zephyr/logging/log.h>
 
 #include <zmk/event_manager.h>
@@ -54,26 +55,138 @@ static bool conditional_layer_updates_needed;
 // Tracks which layers have been locked by conditional layer activations.
 static uint32_t layer_locked_by_conditional = 0;
 
-static void conditional_layer_activate(int8_t layer, bool locking) {
-    // This may trigger another event that could, in turn, activate additional then-layers. However,
-    // the process will eventually terminate (at worst, when every layer is active).
-    if (!zmk_keymap_layer_active(layer) || (locking && !zmk_keymap_layer_locked(layer))) {
+// Then-layers in the order they're evaluated, each after the then-layers among its if-layers, so
+// a single pass settles a conditional layer that activates another.
+static uint8_t then_layer_order[ZMK_KEYMAP_LAYERS_LEN];
+static uint8_t then_layers_len;
+// Set if then-layers depend on each other in a cycle. Those are then evaluated again until the
+// layer state is stable.
+static bool then_layer_cycles;
+// Set while the pass applies its changes, whose own event needs no further pass
+static bool applying_then_layers;
+
+// The then-layers changed by a pass, applied at once at its end. The layer state and locks are
+// those the keymap will have once they're applied.
+struct then_layers_update {
+    zmk_keymap_layers_state_t layer_state;
+    zmk_keymap_layers_state_t layer_locks;
+    zmk_keymap_layers_state_t state;
+    zmk_keymap_layers_state_t mask;
+    zmk_keymap_layers_state_t locking;
+};
+
+static bool layer_active_with_state(int8_t layer, zmk_keymap_layers_state_t state) {
+    return (state & BIT(layer)) != 0U || layer == zmk_keymap_layer_default();
+}
+
+static void set_then_layer(struct then_layers_update *update, int8_t layer, bool state,
+                           bool locking) {
+    WRITE_BIT(update->state, layer, state);
+    WRITE_BIT(update->mask, layer, true);
+    WRITE_BIT(update->locking, layer, locking);
+
+    // As in the keymap, the default layer is never deactivated
+    if (!state && layer == zmk_keymap_layer_default()) {
+        return;
+    }
+
+    WRITE_BIT(update->layer_state, layer, state);
+    if (locking) {
+        WRITE_BIT(update->layer_locks, layer, state);
+    }
+}
+
+static void conditional_layer_activate(struct then_layers_update *update, int8_t layer,
+                                       bool locking) {
+    if (!layer_active_with_state(layer, update->layer_state) ||
+        (locking && !layer_active_with_state(layer, update->layer_locks))) {
         LOG_DBG("layer %d", layer);
-        zmk_keymap_layer_activate(layer, locking);
+        set_then_layer(update, layer, true, locking);
     }
 }
 
-static void conditional_layer_deactivate(int8_t layer, bool locking) {
+static void conditional_layer_deactivate(struct then_layers_update *update, int8_t layer,
+                                         bool locking) {
     // This may deactivate a then-layer that's already active via another mechanism (e.g., a
     // momentary layer behavior). However, the same problem arises when multiple keys with the same
     // &mo binding are held and then one is released, so it's probably not an issue in practice.
-    if (zmk_keymap_layer_active(layer) && (!zmk_keymap_layer_locked(layer) || locking)) {
+    if (layer_active_with_state(layer, update->layer_state) &&
+        (!layer_active_with_state(layer, update->layer_locks) || locking)) {
         LOG_DBG("layer %d", layer);
-        zmk_keymap_layer_deactivate(layer, locking);
+        set_then_layer(update, layer, false, locking);
     }
 }
 
+static zmk_keymap_layers_state_t if_layers_of(uint8_t then_layer) {
+    zmk_keymap_layers_state_t if_layers = 0;
+
+    for (int i = 0; i < NUM_CONDITIONAL_LAYER_CFGS; i++) {
+        if (CONDITIONAL_LAYER_CFGS[i].then_layer == then_layer) {
+            if_layers |= CONDITIONAL_LAYER_CFGS[i].if_layers_state_mask;
+        }
+    }
+
+    return if_layers;
+}
+
+static void update_then_layer(struct then_layers_update *update, uint8_t layer) {
+    bool active = false;
+
+    // Activate then-layer if and only if all if-layers of one of its configs are already active.
+    // The layer state includes the changes to the then-layers before it in the order.
+    for (int i = 0; i < NUM_CONDITIONAL_LAYER_CFGS; i++) {
+        const struct conditional_layer_cfg *cfg = CONDITIONAL_LAYER_CFGS + i;
+        zmk_keymap_layers_state_t mask = cfg->if_layers_state_mask;
+
+        if (cfg->then_layer != layer) {
+            continue;
+        }
+
+        if ((update->layer_state & mask) == mask) {
+            active = true;
+        }
+        // Same as above, but for the lock status
+        if ((update->layer_locks & mask) == mask) {
+            WRITE_BIT(layer_locked_by_conditional, layer, true);
+        }
+    }
+
+    bool locking = (BIT(layer) & layer_locked_by_conditional) != 0U;
+
+    if (active) {
+        conditional_layer_activate(update, layer, locking);
+    } else {
+        conditional_layer_deactivate(update, layer, locking);
+        WRITE_BIT(layer_locked_by_conditional, layer, false);
+    }
+}
+
+static void update_then_layers(void) {
+    struct then_layers_update update = {
+        .layer_state = zmk_keymap_layer_state(),
+        .layer_locks = zmk_keymap_layer_locks(),
+    };
+
+    for (int i = 0; i < then_layers_len; i++) {
+        update_then_layer(&update, then_layer_order[i]);
+    }
+
+    if (update.mask == 0U) {
+        return;
+    }
+
+    // A single layer state change for all of the then-layers
+    applying_then_layers = true;
+    zmk_keymap_layers_set(update.state, update.mask, update.locking);
+    applying_then_layers = false;
+}
+
 static int layer_state_changed_listener(const zmk_event_t *ev) {
+    // Without cycles, the pass already settled every then-layer its own change affects
+    if (applying_then_layers && !then_layer_cycles) {
+        return 0;
+    }
+
     conditional_layer_updates_needed = true;
 
     // Semaphore ensures we don't re-enter the loop in the middle of doing update, and
@@ -84,49 +197,53 @@ static int layer_state_changed_listener(const zmk_event_t *ev) {
     }
 
     while (conditional_layer_updates_needed) {
-        int8_t max_then_layer = -1;
-        uint32_t then_layers = 0;
-        uint32_t then_layer_state = 0;
         conditional_layer_updates_needed = false;
+        update_then_layers();
+    }
 
-        // On layer state changes, examines each conditional layer config to determine if then-layer
-        // in the config should activate based on the currently active set of if-layers.
-        for (int i = 0; i < NUM_CONDITIONAL_LAYER_CFGS; i++) {
-            const struct conditional_layer_cfg *cfg = CONDITIONAL_LAYER_CFGS + i;
-            zmk_keymap_layers_state_t mask = cfg->if_layers_state_mask;
-            WRITE_BIT(then_layers, cfg->then_layer, true);
-            max_then_layer = MAX(max_then_layer, cfg->then_layer);
-
-            // Activate then-layer if and only if all if-layers are already active. Note that we
-            // reevaluate the current layer state for each config since activation of one layer can
-            // also trigger activation of another.
-            if ((zmk_keymap_layer_state() & mask) == mask) {
-                WRITE_BIT(then_layer_state, cfg->then_layer, true);
-            }
-            // Same as above, but for the lock status
-            if ((zmk_keymap_layer_locks() & mask) == mask) {
-                WRITE_BIT(layer_locked_by_conditional, cfg->then_layer, true);
+    k_sem_give(&conditional_layer_sem);
+    return 0;
+}
+
+ZMK_LISTENER(conditional_layer, layer_state_changed_listener);
+ZMK_SUBSCRIPTION(conditional_layer, zmk_layer_state_changed);
+
+static int conditional_layer_init(void) {
+    zmk_keymap_layers_state_t then_layers = 0;
+    zmk_keymap_layers_state_t ordered = 0;
+
+    for (int i = 0; i < NUM_CONDITIONAL_LAYER_CFGS; i++) {
+        WRITE_BIT(then_layers, CONDITIONAL_LAYER_CFGS[i].then_layer, true);
+    }
+
+    while (ordered != then_layers) {
+        zmk_keymap_layers_state_t ready = 0;
+
+        for (uint8_t layer = 0; layer < ZMK_KEYMAP_LAYERS_LEN; layer++) {
+            if ((then_layers & ~ordered & BIT(layer)) != 0U &&
+                (if_layers_of(layer) & then_layers & ~ordered) == 0U) {
+                WRITE_BIT(ready, layer, true);
             }
         }
 
-        for (uint8_t layer = 0; layer <= max_then_layer; layer++) {
-            if ((BIT(layer) & then_layers) != 0U) {
-                bool locking = (BIT(layer) & layer_locked_by_conditional) != 0U;
-                if ((BIT(layer) & then_layer_state) != 0U) {
-                    conditional_layer_activate(layer, locking);
-                } else {
-                    conditional_layer_deactivate(layer, locking);
-                    WRITE_BIT(layer_locked_by_conditional, layer, false);
-                }
+        // Layers left in a cycle are evaluated in layer order
+        if (ready == 0U) {
+            then_layer_cycles = true;
+            ready = then_layers & ~ordered;
+        }
+
+        for (uint8_t layer = 0; layer < ZMK_KEYMAP_LAYERS_LEN; layer++) {
+            if ((ready & BIT(layer)) != 0U) {
+                then_layer_order[then_layers_len++] = layer;
             }
         }
+
+        ordered |= ready;
     }
 
-    k_sem_give(&conditional_layer_sem);
     return 0;
 }
 
-ZMK_LISTENER(conditional_layer, layer_state_changed_listener);
-ZMK_SUBSCRIPTION(conditional_layer, zmk_layer_state_changed);
+SYS_INIT(conditional_layer_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
 
 #endif
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zmk/context.h>
+#include <zmk/workqueue.h>
+
+uint8_t zmk_context_current;
+
+int zmk_context_select(uint8_t index) {
+    // The selection is one global, so only one thread may ever change it
+    __ASSERT(k_current_get() == k_work_queue_thread_get(zmk_workqueue_input_work_q()),
+             "Contexts can only be selected on the input work queue");
+
+    if (index >= ZMK_CONTEXT_COUNT) {
+        return -EINVAL;
+    }
+
+    zmk_context_current = index;
+    return 0;
+}
@@ -8,6 +8,8 @@
 #include <zephyr/init.h>
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/slist.h>
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
@@ -16,11 +18,18 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zephyr/drivers/led.h>
 #include <lvgl.h>
 
+#if IS_ENABLED(CONFIG_ZMK_DISPLAY_STATS)
+#include <lvgl_mem.h>
+#include <zephyr/sys/sys_heap.h>
+#endif
+
 #include "theme.h"
 
+#include <zmk/display.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/activity_state_changed.h>
 #include <zmk/display/status_screen.h>
+#include <zmk/work_stats.h>
 
 static const struct device *display = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
 
@@ -37,10 +46,6 @@ static lv_obj_t *screen;
 
 __attribute__((weak)) lv_obj_t *zmk_display_status_screen() { return NULL; }
 
-void display_tick_cb(struct k_work *work) { lv_task_handler(); }
-
-K_WORK_DEFINE(display_tick_work, display_tick_cb);
-
 #if IS_ENABLED(CONFIG_ZMK_DISPLAY_WORK_QUEUE_DEDICATED)
 
 K_THREAD_STACK_DEFINE(display_work_stack_area, CONFIG_ZMK_DISPLAY_DEDICATED_THREAD_STACK_SIZE);
@@ -57,9 +62,137 @@ struct k_work_q *zmk_display_work_q() {
 #endif
 }
 
-void display_timer_cb() { k_work_submit_to_queue(zmk_display_work_q(), &display_tick_work); }
+// The display isn't ticked while blanked, and changes made meanwhile are drawn by the first tick
+// once it's unblanked.
+static atomic_t ticking;
+
+static void display_tick_cb(struct k_work *work);
+
+K_WORK_DELAYABLE_DEFINE(display_tick_work, display_tick_cb);
+
+ZMK_WORK_STATS_DEFINE(display_tick, 0);
+
+// Doesn't move a tick already scheduled
+static void schedule_display_tick(uint32_t delay_ms) {
+    zmk_work_stats_submit(ZMK_WORK_STATS(display_tick), delay_ms);
+    k_work_schedule_for_queue(zmk_display_work_q(), &display_tick_work, K_MSEC(delay_ms));
+}
+
+// Widget listeners with a state change to show, each in the list once however many events it got
+static sys_slist_t pending_widget_listeners = SYS_SLIST_STATIC_INIT(&pending_widget_listeners);
+
+static struct k_spinlock pending_widget_listeners_lock;
+
+static void schedule_tick(void) {
+    if (IS_ENABLED(CONFIG_ARCH_POSIX) || atomic_get(&ticking)) {
+        // A burst of changes is drawn at once by the tick already scheduled for the first one
+        schedule_display_tick(CONFIG_ZMK_DISPLAY_TICK_PERIOD_MS);
+    }
+}
+
+void zmk_display_widget_listener_mark_pending(struct zmk_display_widget_listener *listener) {
+    k_spinlock_key_t key = k_spin_lock(&pending_widget_listeners_lock);
+    if (!listener->pending) {
+        listener->pending = true;
+        sys_slist_append(&pending_widget_listeners, &listener->node);
+    }
+    k_spin_unlock(&pending_widget_listeners_lock, key);
+
+    schedule_tick();
+}
+
+// Listeners marked while the pass runs are left for the next tick. Each stays pending until it's
+// taken from the batch, so marking one meanwhile never touches the batch.
+static void update_pending_widgets(void) {
+    k_spinlock_key_t key = k_spin_lock(&pending_widget_listeners_lock);
+    sys_slist_t listeners = pending_widget_listeners;
+    sys_slist_init(&pending_widget_listeners);
+    k_spin_unlock(&pending_widget_listeners_lock, key);
+
+    for (;;) {
+        struct zmk_display_widget_listener *listener = NULL;
+
+        key = k_spin_lock(&pending_widget_listeners_lock);
+        sys_snode_t *node = sys_slist_get(&listeners);
+        if (node != NULL) {
+            listener = CONTAINER_OF(node, struct zmk_display_widget_listener, node);
+            listener->pending = false;
+        }
+        k_spin_unlock(&pending_widget_listeners_lock, key);
+
+        if (listener == NULL) {
+            return;
+        }
+
+        listener->update();
+    }
+}
+
+#if IS_ENABLED(CONFIG_ZMK_DISPLAY_STATS)
+
+static uint32_t max_tick_us;
+static size_t max_heap_allocated;
+
+// Only new maximums are logged, so the cost of a tick that's within the known budget is a compare.
+static void update_display_stats(uint32_t start_cycles) {
+    uint32_t tick_us = k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles);
+    if (tick_us > max_tick_us) {
+        max_tick_us = tick_us;
+        LOG_INF("Display tick took %u us, the longest so far", tick_us);
+    }
+
+    struct sys_memory_stats heap;
+    lvgl_heap_stats(&heap);
+    if (heap.max_allocated_bytes > max_heap_allocated) {
+        max_heap_allocated = heap.max_allocated_bytes;
+        LOG_INF("LVGL heap high-water mark %zu of %zu bytes", heap.max_allocated_bytes,
+                heap.allocated_bytes + heap.free_bytes);
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_DISPLAY_STATS)
+
+// LVGL pauses the refresh timer of the display once nothing is left to redraw, so the display is
+// ticked again soon only when LVGL still has timers due, or once a refresh is requested. Otherwise
+// it falls back to a slow tick, which picks up changes made without requesting a refresh.
+static void display_tick_cb(struct k_work *work) {
+    uint32_t start = zmk_work_stats_run_start(ZMK_WORK_STATS(display_tick));
+#if IS_ENABLED(CONFIG_ZMK_DISPLAY_STATS)
+    uint32_t start_cycles = k_cycle_get_32();
+#endif
+
+    update_pending_widgets();
+
+#if !IS_ENABLED(CONFIG_ARCH_POSIX)
+    uint32_t next_run_ms = lv_task_handler();
+
+    if (atomic_get(&ticking)) {
+        if (next_run_ms != LV_NO_TIMER_READY) {
+            schedule_display_tick(MAX(next_run_ms, CONFIG_ZMK_DISPLAY_TICK_PERIOD_MS));
+        } else if (CONFIG_ZMK_DISPLAY_IDLE_TICK_PERIOD_MS > 0) {
+            schedule_display_tick(CONFIG_ZMK_DISPLAY_IDLE_TICK_PERIOD_MS);
+        }
+    }
+#endif // !IS_ENABLED(CONFIG_ARCH_POSIX)
+
+#if IS_ENABLED(CONFIG_ZMK_DISPLAY_STATS)
+    update_display_stats(start_cycles);
+#endif
+
+    zmk_work_stats_run_end(ZMK_WORK_STATS(display_tick), start);
+}
+
+void zmk_display_label_set_text(lv_obj_t *label, const char *text) {
+    if (strcmp(lv_label_get_text(label), text) != 0) {
+        lv_label_set_text(label, text);
+    }
+}
 
-K_TIMER_DEFINE(display_timer, display_timer_cb, NULL);
+void zmk_display_request_refresh(void) {
+#if !IS_ENABLED(CONFIG_ARCH_POSIX)
+    schedule_tick();
+#endif // !IS_ENABLED(CONFIG_ARCH_POSIX)
+}
 
 void unblank_display_cb(struct k_work *work) {
 #if DT_HAS_CHOSEN(zmk_display_led)
@@ -67,8 +200,8 @@ void unblank_display_cb(struct k_work *work) {
 #endif
     display_blanking_off(display);
 #if !IS_ENABLED(CONFIG_ARCH_POSIX)
-    k_timer_start(&display_timer, K_MSEC(CONFIG_ZMK_DISPLAY_TICK_PERIOD_MS),
-                  K_MSEC(CONFIG_ZMK_DISPLAY_TICK_PERIOD_MS));
+    atomic_set(&ticking, 1);
+    schedule_display_tick(0);
 #endif // !IS_ENABLED(CONFIG_ARCH_POSIX)
 }
 
@@ -76,7 +209,8 @@ void unblank_display_cb(struct k_work *work) {
 
 void blank_display_cb(struct k_work *work) {
 #if !IS_ENABLED(CONFIG_ARCH_POSIX)
-    k_timer_stop(&display_timer);
+    atomic_set(&ticking, 0);
+    k_work_cancel_delayable(&display_tick_work);
 #endif // !IS_ENABLED(CONFIG_ARCH_POSIX)
     display_blanking_on(display);
 #if DT_HAS_CHOSEN(zmk_display_led)
@@ -104,7 +238,7 @@ static void stop_display_updates() {
 
 #endif
 
-int zmk_display_is_initialized() { return initialized; }
+bool zmk_display_is_initialized() { return initialized; }
 
 static void initialize_theme() {
 #if IS_ENABLED(CONFIG_LV_USE_THEME_MONO)
@@ -54,7 +54,7 @@ static void set_battery_symbol(lv_obj_t *label, struct battery_status_state stat
         strcat(text, LV_SYMBOL_BATTERY_EMPTY);
     }
 #endif
-    lv_label_set_text(label, text);
+    zmk_display_label_set_text(label, text);
 }
 
 void battery_status_update_cb(struct battery_status_state state) {
@@ -28,13 +28,13 @@ static void set_layer_symbol(lv_obj_t *label, struct layer_status_state state) {
 
         snprintf(text, sizeof(text), LV_SYMBOL_KEYBOARD " %i", state.index);
 
-        lv_label_set_text(label, text);
+        zmk_display_label_set_text(label, text);
     } else {
         char text[14] = {};
 
         snprintf(text, sizeof(text), LV_SYMBOL_KEYBOARD " %s", state.label);
 
-        lv_label_set_text(label, text);
+        zmk_display_label_set_text(label, text);
     }
 }
 
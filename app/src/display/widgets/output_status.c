@@ -75,7 +75,7 @@ static void set_status_symbol(lv_obj_t *label, struct output_status_state state)
         break;
     }
 
-    lv_label_set_text(label, text);
+    zmk_display_label_set_text(label, text);
 }
 
 static void output_status_update_cb(struct output_status_state state) {
@@ -30,7 +30,7 @@ void set_wpm_symbol(lv_obj_t *label, struct wpm_status_state state) {
     LOG_DBG("WPM changed to %i", state.wpm);
     snprintf(text, sizeof(text), "%i", state.wpm);
 
-    lv_label_set_text(label, text);
+    zmk_display_label_set_text(label, text);
     lv_obj_align(label, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
 }
 
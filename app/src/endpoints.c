@@ -5,9 +5,12 @@
  */
 
 #include <zephyr/init.h>
+#include <zephyr/kernel.h>
 #include <zephyr/settings/settings.h>
+#include <zephyr/sys/atomic.h>
 
 #include <stdio.h>
+#include <string.h>
 
 #include <zmk/ble.h>
 #include <zmk/endpoints.h>
@@ -15,12 +18,15 @@
 #include <dt-bindings/zmk/hid_usage_pages.h>
 #include <zmk/usb_hid.h>
 #include <zmk/hog.h>
+#include <zmk/settings.h>
 #include <zmk/endpoints.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/ble_active_profile_changed.h>
 #include <zmk/events/usb_conn_state_changed.h>
 #include <zmk/events/endpoint_changed.h>
 #include <zmk/ipc_observer.h>
+#include <zmk/profiling.h>
+#include <zmk/stage_timing.h>
 
 #include <zephyr/logging/log.h>
 
@@ -54,18 +60,10 @@ static enum zmk_transport preferred_transport = DEFAULT_TRANSPORT;
 
 static void update_current_endpoint(void);
 
-#if IS_ENABLED(CONFIG_SETTINGS)
-static void endpoints_save_preferred_work(struct k_work *work) {
-    settings_save_one(SETTING_PREFERRED_TRANSPORT, &preferred_transport,
-                      sizeof(preferred_transport));
-}
-
-static struct k_work_delayable endpoints_save_work;
-#endif
-
 static int endpoints_save_preferred(void) {
 #if IS_ENABLED(CONFIG_SETTINGS)
-    return k_work_reschedule(&endpoints_save_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
+    return zmk_settings_save(SETTING_PREFERRED_TRANSPORT, &preferred_transport,
+                             sizeof(preferred_transport));
 #else
     return 0;
 #endif
@@ -174,10 +172,83 @@ struct zmk_endpoint_instance zmk_endpoint_get_selected(void) { return current_in
 
 bool zmk_endpoint_is_connected(void) { return current_instance.transport != ZMK_TRANSPORT_NONE; }
 
-static int send_keyboard_report(void) {
-    char endpoint_str[ZMK_ENDPOINT_STR_LEN];
-    zmk_endpoint_instance_to_str(current_instance, endpoint_str, sizeof(endpoint_str));
-    zmk_ipc_observer_notify_keyboard_report(endpoint_str);
+#if IS_ENABLED(CONFIG_ZMK_HID_SKIP_UNCHANGED_REPORTS)
+// The last reports sent successfully to the current endpoint.
+static struct zmk_hid_keyboard_report_body last_keyboard_report;
+static bool last_keyboard_report_valid;
+static struct zmk_hid_consumer_report_body last_consumer_report;
+static bool last_consumer_report_valid;
+#endif // IS_ENABLED(CONFIG_ZMK_HID_SKIP_UNCHANGED_REPORTS)
+
+static atomic_t skipped_report_count;
+
+static enum zmk_hid_keyboard_report_format keyboard_report_formats[ZMK_ENDPOINT_COUNT];
+
+int zmk_endpoint_set_keyboard_report_format(struct zmk_endpoint_instance endpoint,
+                                            enum zmk_hid_keyboard_report_format format) {
+    if (format == ZMK_HID_KEYBOARD_REPORT_FORMAT_BOOT && !IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT)) {
+        return -ENOTSUP;
+    }
+
+    if ((endpoint.transport == ZMK_TRANSPORT_USB && !IS_ENABLED(CONFIG_ZMK_USB)) ||
+        (endpoint.transport == ZMK_TRANSPORT_BLE &&
+         endpoint.ble.profile_index >= ZMK_ENDPOINT_BLE_COUNT)) {
+        return -EINVAL;
+    }
+
+    int index = zmk_endpoint_instance_to_index(endpoint);
+    if (index < 0 || index >= ZMK_ENDPOINT_COUNT) {
+        return -EINVAL;
+    }
+
+    keyboard_report_formats[index] = format;
+    return 0;
+}
+
+enum zmk_hid_keyboard_report_format
+zmk_endpoint_get_keyboard_report_format(struct zmk_endpoint_instance endpoint) {
+    int index = zmk_endpoint_instance_to_index(endpoint);
+    if (index < 0 || index >= ZMK_ENDPOINT_COUNT) {
+        return ZMK_HID_KEYBOARD_REPORT_FORMAT_NATIVE;
+    }
+
+    return keyboard_report_formats[index];
+}
+
+bool zmk_endpoint_keyboard_report_queue_full(void) {
+    switch (current_instance.transport) {
+    case ZMK_TRANSPORT_USB:
+#if IS_ENABLED(CONFIG_ZMK_USB)
+        return zmk_usb_hid_keyboard_report_queue_full();
+#else
+        return false;
+#endif /* IS_ENABLED(CONFIG_ZMK_USB) */
+
+    case ZMK_TRANSPORT_BLE:
+#if IS_ENABLED(CONFIG_ZMK_BLE)
+        return zmk_hog_keyboard_report_queue_full();
+#else
+        return false;
+#endif /* IS_ENABLED(CONFIG_ZMK_BLE) */
+
+    default:
+        return false;
+    }
+}
+
+uint32_t zmk_endpoint_get_skipped_report_count(void) {
+    return (uint32_t)atomic_get(&skipped_report_count);
+}
+
+static void invalidate_last_reports(void) {
+#if IS_ENABLED(CONFIG_ZMK_HID_SKIP_UNCHANGED_REPORTS)
+    last_keyboard_report_valid = false;
+    last_consumer_report_valid = false;
+#endif // IS_ENABLED(CONFIG_ZMK_HID_SKIP_UNCHANGED_REPORTS)
+}
+
+static int send_keyboard_report_to_endpoint(void) {
+    zmk_ipc_observer_notify_keyboard_report(&current_instance);
 
     switch (current_instance.transport) {
     case ZMK_TRANSPORT_NONE:
@@ -215,10 +286,36 @@ static int send_keyboard_report(void) {
     return -ENOTSUP;
 }
 
-static int send_consumer_report(void) {
-    char endpoint_str[ZMK_ENDPOINT_STR_LEN];
-    zmk_endpoint_instance_to_str(current_instance, endpoint_str, sizeof(endpoint_str));
-    zmk_ipc_observer_notify_consumer_report(endpoint_str);
+#if IS_ENABLED(CONFIG_ZMK_HID_SKIP_UNCHANGED_REPORTS)
+
+static int send_keyboard_report(void) {
+    const struct zmk_hid_keyboard_report_body *body = &zmk_hid_get_keyboard_report()->body;
+
+    if (last_keyboard_report_valid && memcmp(&last_keyboard_report, body, sizeof(*body)) == 0) {
+        atomic_inc(&skipped_report_count);
+        LOG_DBG("Skipping unchanged keyboard report");
+        // IPC clients still see every report, as they would without skipping.
+        zmk_ipc_observer_notify_keyboard_report(&current_instance);
+        return 0;
+    }
+
+    int err = send_keyboard_report_to_endpoint();
+    if (!err) {
+        last_keyboard_report = *body;
+        last_keyboard_report_valid = true;
+    }
+
+    return err;
+}
+
+#else
+
+static int send_keyboard_report(void) { return send_keyboard_report_to_endpoint(); }
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_SKIP_UNCHANGED_REPORTS)
+
+static int send_consumer_report_to_endpoint(void) {
+    zmk_ipc_observer_notify_consumer_report(&current_instance);
 
     switch (current_instance.transport) {
     case ZMK_TRANSPORT_NONE:
@@ -256,8 +353,35 @@ static int send_consumer_report(void) {
     return -ENOTSUP;
 }
 
-int zmk_endpoint_send_report(uint16_t usage_page) {
-    LOG_DBG("usage page 0x%02X", usage_page);
+#if IS_ENABLED(CONFIG_ZMK_HID_SKIP_UNCHANGED_REPORTS)
+
+static int send_consumer_report(void) {
+    const struct zmk_hid_consumer_report_body *body = &zmk_hid_get_consumer_report()->body;
+
+    if (last_consumer_report_valid && memcmp(&last_consumer_report, body, sizeof(*body)) == 0) {
+        atomic_inc(&skipped_report_count);
+        LOG_DBG("Skipping unchanged consumer report");
+        // IPC clients still see every report, as they would without skipping.
+        zmk_ipc_observer_notify_consumer_report(&current_instance);
+        return 0;
+    }
+
+    int err = send_consumer_report_to_endpoint();
+    if (!err) {
+        last_consumer_report = *body;
+        last_consumer_report_valid = true;
+    }
+
+    return err;
+}
+
+#else
+
+static int send_consumer_report(void) { return send_consumer_report_to_endpoint(); }
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_SKIP_UNCHANGED_REPORTS)
+
+static int send_report(uint16_t usage_page) {
     switch (usage_page) {
     case HID_USAGE_KEY:
         return send_keyboard_report();
@@ -270,11 +394,30 @@ int zmk_endpoint_send_report(uint16_t usage_page) {
     return -ENOTSUP;
 }
 
+int zmk_endpoint_send_report(uint16_t usage_page) {
+    static bool first_report_sent;
+
+    LOG_DBG("usage page 0x%02X", usage_page);
+
+    ZMK_PROFILING_MARK1(report_send, usage_page);
+
+    uint32_t start = zmk_stage_timing_start();
+    int err = send_report(usage_page);
+
+    zmk_stage_timing_end(ZMK_STAGE_ENDPOINT_SEND, start);
+
+    if (unlikely(!first_report_sent) && err == 0 &&
+        current_instance.transport != ZMK_TRANSPORT_NONE) {
+        first_report_sent = true;
+        LOG_INF("First report sent %lld ms after boot", k_uptime_get());
+    }
+
+    return err;
+}
+
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
-int zmk_endpoint_send_mouse_report() {
-    char endpoint_str[ZMK_ENDPOINT_STR_LEN];
-    zmk_endpoint_instance_to_str(current_instance, endpoint_str, sizeof(endpoint_str));
-    zmk_ipc_observer_notify_mouse_report(endpoint_str);
+static int send_mouse_report_to_endpoint(void) {
+    zmk_ipc_observer_notify_mouse_report(&current_instance);
 
     switch (current_instance.transport) {
     case ZMK_TRANSPORT_NONE:
@@ -311,6 +454,162 @@ int zmk_endpoint_send_mouse_report() {
     LOG_ERR("Unhandled endpoint transport %d", current_instance.transport);
     return -ENOTSUP;
 }
+
+static K_MUTEX_DEFINE(mouse_report_mutex);
+
+void zmk_endpoint_mouse_report_lock(void) { k_mutex_lock(&mouse_report_mutex, K_FOREVER); }
+
+void zmk_endpoint_mouse_report_unlock(void) { k_mutex_unlock(&mouse_report_mutex); }
+
+#if CONFIG_ZMK_POINTING_MAX_REPORT_RATE > 0
+
+#define MOUSE_REPORT_INTERVAL_TICKS                                                                \
+    k_us_to_ticks_ceil64(USEC_PER_SEC / CONFIG_ZMK_POINTING_MAX_REPORT_RATE)
+
+// Movement and scrolling not sent to an endpoint yet. Sums beyond the int16 range of a report
+// are sent over several reports instead of wrapping around.
+struct mouse_accumulator {
+    int32_t d_x;
+    int32_t d_y;
+    int32_t d_scroll_x;
+    int32_t d_scroll_y;
+    zmk_mouse_button_flags_t buttons;
+    // reports still to be merged into the one after them, see zmk_endpoint_merge_mouse_reports()
+    uint8_t to_merge;
+    int64_t last_sent;
+};
+
+static struct mouse_accumulator mouse_accumulators[ZMK_ENDPOINT_COUNT];
+static struct k_spinlock mouse_accumulators_lock;
+
+static void mouse_flush_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(mouse_flush_work, mouse_flush_work_cb);
+
+static int16_t take_int16(int32_t *value) {
+    int16_t taken = CLAMP(*value, INT16_MIN, INT16_MAX);
+    *value -= taken;
+    return taken;
+}
+
+static bool mouse_accumulator_has_motion(const struct mouse_accumulator *acc) {
+    return acc->d_x || acc->d_y || acc->d_scroll_x || acc->d_scroll_y;
+}
+
+// Adds the motion in the HID report to the accumulator of the current endpoint, and sends it on
+// if a report is due. The motion set in the HID report is left for the caller to clear.
+static int send_accumulated_mouse_report(void) {
+    struct zmk_hid_mouse_report_body *body = &zmk_hid_get_mouse_report()->body;
+    int64_t now = k_uptime_ticks();
+
+    k_spinlock_key_t key = k_spin_lock(&mouse_accumulators_lock);
+    struct mouse_accumulator *acc =
+        &mouse_accumulators[zmk_endpoint_instance_to_index(current_instance)];
+
+    acc->d_x += body->d_x;
+    acc->d_y += body->d_y;
+    acc->d_scroll_x += body->d_scroll_x;
+    acc->d_scroll_y += body->d_scroll_y;
+
+    bool buttons_changed = body->buttons != acc->buttons;
+    int64_t next = acc->last_sent + MOUSE_REPORT_INTERVAL_TICKS;
+
+    if (!buttons_changed && acc->to_merge > 0) {
+        acc->to_merge--;
+        k_spin_unlock(&mouse_accumulators_lock, key);
+
+        // Sent anyway if the rest of the frame never comes
+        k_work_schedule(&mouse_flush_work, K_TIMEOUT_ABS_TICKS(now + MOUSE_REPORT_INTERVAL_TICKS));
+        return 0;
+    }
+
+    if (!buttons_changed && (!mouse_accumulator_has_motion(acc) || now < next)) {
+        bool pending = mouse_accumulator_has_motion(acc);
+        k_spin_unlock(&mouse_accumulators_lock, key);
+
+        if (pending) {
+            k_work_schedule(&mouse_flush_work, K_TIMEOUT_ABS_TICKS(next));
+        }
+        return 0;
+    }
+
+    int16_t d_x = take_int16(&acc->d_x);
+    int16_t d_y = take_int16(&acc->d_y);
+    int16_t d_scroll_x = take_int16(&acc->d_scroll_x);
+    int16_t d_scroll_y = take_int16(&acc->d_scroll_y);
+    bool pending = mouse_accumulator_has_motion(acc);
+    acc->buttons = body->buttons;
+    acc->last_sent = now;
+    k_spin_unlock(&mouse_accumulators_lock, key);
+
+    // Usually nothing was held back, and the report already has the right motion.
+    if (d_x != body->d_x || d_y != body->d_y) {
+        zmk_hid_mouse_movement_set(d_x, d_y);
+    }
+    if (d_scroll_x != body->d_scroll_x || d_scroll_y != body->d_scroll_y) {
+        zmk_hid_mouse_scroll_set(d_scroll_x, d_scroll_y);
+    }
+
+    int err = send_mouse_report_to_endpoint();
+
+    if (pending) {
+        k_work_schedule(&mouse_flush_work,
+                        K_TIMEOUT_ABS_TICKS(now + MOUSE_REPORT_INTERVAL_TICKS));
+    }
+
+    return err;
+}
+
+int zmk_endpoint_send_mouse_report() { return send_accumulated_mouse_report(); }
+
+void zmk_endpoint_merge_mouse_reports(uint8_t count) {
+    k_spinlock_key_t key = k_spin_lock(&mouse_accumulators_lock);
+    mouse_accumulators[zmk_endpoint_instance_to_index(current_instance)].to_merge = count;
+    k_spin_unlock(&mouse_accumulators_lock, key);
+}
+
+static void mouse_flush_work_cb(struct k_work *work) {
+    // The input listener thread changes the same report, see zmk_endpoint_mouse_report_lock()
+    zmk_endpoint_mouse_report_lock();
+
+    k_spinlock_key_t key = k_spin_lock(&mouse_accumulators_lock);
+    mouse_accumulators[zmk_endpoint_instance_to_index(current_instance)].to_merge = 0;
+    k_spin_unlock(&mouse_accumulators_lock, key);
+
+    send_accumulated_mouse_report();
+
+    // Unlike an input listener, nothing else clears the motion after this report. An input
+    // listener interrupted before sending its own motion has had it taken as well.
+    struct zmk_hid_mouse_report_body *body = &zmk_hid_get_mouse_report()->body;
+    if (body->d_x || body->d_y) {
+        zmk_hid_mouse_movement_set(0, 0);
+    }
+    if (body->d_scroll_x || body->d_scroll_y) {
+        zmk_hid_mouse_scroll_set(0, 0);
+    }
+
+    zmk_endpoint_mouse_report_unlock();
+}
+
+// Drops the motion not sent yet to the current endpoint.
+static void clear_mouse_accumulator(void) {
+    k_spinlock_key_t key = k_spin_lock(&mouse_accumulators_lock);
+    struct mouse_accumulator *acc =
+        &mouse_accumulators[zmk_endpoint_instance_to_index(current_instance)];
+    acc->d_x = acc->d_y = acc->d_scroll_x = acc->d_scroll_y = 0;
+    acc->to_merge = 0;
+    k_spin_unlock(&mouse_accumulators_lock, key);
+}
+
+#else
+
+int zmk_endpoint_send_mouse_report() { return send_mouse_report_to_endpoint(); }
+
+void zmk_endpoint_merge_mouse_reports(uint8_t count) {}
+
+static void clear_mouse_accumulator(void) {}
+
+#endif // CONFIG_ZMK_POINTING_MAX_REPORT_RATE > 0
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
 #if IS_ENABLED(CONFIG_SETTINGS)
@@ -472,10 +771,6 @@ static struct zmk_endpoint_instance get_selected_instance(void) {
 }
 
 static int zmk_endpoints_init(void) {
-#if IS_ENABLED(CONFIG_SETTINGS)
-    k_work_init_delayable(&endpoints_save_work, endpoints_save_preferred_work);
-#endif
-
     current_instance = get_selected_instance();
 
     return 0;
@@ -485,7 +780,10 @@ void zmk_endpoint_clear_reports(void) {
     zmk_hid_keyboard_clear();
     zmk_hid_consumer_clear();
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
+    zmk_endpoint_mouse_report_lock();
     zmk_hid_mouse_clear();
+    clear_mouse_accumulator();
+    zmk_endpoint_mouse_report_unlock();
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
     zmk_endpoint_send_report(HID_USAGE_KEY);
@@ -500,16 +798,21 @@ static void update_current_endpoint(void) {
         zmk_endpoint_clear_reports();
 
         current_instance = new_instance;
+        invalidate_last_reports();
 
-        char endpoint_str[ZMK_ENDPOINT_STR_LEN];
-        zmk_endpoint_instance_to_str(current_instance, endpoint_str, sizeof(endpoint_str));
-        LOG_INF("Endpoint changed: %s", endpoint_str);
+        if (IS_ENABLED(CONFIG_LOG)) {
+            char endpoint_str[ZMK_ENDPOINT_STR_LEN];
+            zmk_endpoint_instance_to_str(current_instance, endpoint_str, sizeof(endpoint_str));
+            LOG_INF("Endpoint changed: %s", endpoint_str);
+        }
 
         raise_zmk_endpoint_changed((struct zmk_endpoint_changed){.endpoint = current_instance});
     }
 }
 
 static int endpoint_listener(const zmk_event_t *eh) {
+    // The host may have forgotten the last reports if its connection changed.
+    invalidate_last_reports();
     update_current_endpoint();
     return 0;
 }
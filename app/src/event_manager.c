@@ -5,27 +5,49 @@
  */
 
 #include <zephyr/kernel.h>
+#include <zephyr/init.h>
 #include <zephyr/logging/log.h>
 
-LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+LOG_MODULE_REGISTER(zmk_event_manager, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/event_manager.h>
+#include <zmk/profiling.h>
 
-extern struct zmk_event_type *__event_type_start[];
-extern struct zmk_event_type *__event_type_end[];
+#include <string.h>
+
+extern const struct zmk_event_type *__event_type_start[];
+extern const struct zmk_event_type *__event_type_end[];
 
 extern struct zmk_event_subscription __event_subscriptions_start[];
 extern struct zmk_event_subscription __event_subscriptions_end[];
 
-int zmk_event_manager_handle_from(zmk_event_t *event, uint8_t start_index) {
+/*
+ * Subscription indices grouped by event type, keeping link order within each
+ * type. Each type's zmk_event_subscribers records its range, so dispatch only
+ * visits listeners of the raised type. Positions in this table are what
+ * last_listener_index stores.
+ */
+static uint16_t dispatch_table[CONFIG_ZMK_EVENT_MANAGER_MAX_SUBSCRIPTIONS];
+
+// zmk-events.ld fails the link when the subscriptions don't fit the table, counting them as two
+// pointers each.
+BUILD_ASSERT(sizeof(struct zmk_event_subscription) == 2 * sizeof(void *),
+             "zmk-events.ld assumes an event subscription is two pointers");
+
+static int dispatch(zmk_event_t *event, uint16_t start_index) {
     int ret = 0;
-    uint8_t len = __event_subscriptions_end - __event_subscriptions_start;
-    for (int i = start_index; i < len; i++) {
-        struct zmk_event_subscription *ev_sub = __event_subscriptions_start + i;
-        if (ev_sub->event_type != event->event) {
+    struct zmk_event_subscribers *subs = event->event->subscribers;
+    uint16_t end = subs->start + subs->count;
+    for (int i = start_index; i < end; i++) {
+        struct zmk_event_subscription *ev_sub = __event_subscriptions_start + dispatch_table[i];
+        if (ev_sub->listener->active && !*ev_sub->listener->active) {
             continue;
         }
+
         event->last_listener_index = i;
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+        subs->stats.listeners_invoked++;
+#endif
         ret = ev_sub->listener->callback(event);
         switch (ret) {
         case ZMK_EV_EVENT_BUBBLE:
@@ -35,6 +57,9 @@ int zmk_event_manager_handle_from(zmk_event_t *event, uint8_t start_index) {
             return 0;
         case ZMK_EV_EVENT_CAPTURED:
             LOG_DBG("Listener captured the event");
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+            subs->stats.captured++;
+#endif
             return 0;
         default:
             LOG_DBG("Listener returned an error: %d", ret);
@@ -45,38 +70,301 @@ int zmk_event_manager_handle_from(zmk_event_t *event, uint8_t start_index) {
     return 0;
 }
 
-int zmk_event_manager_raise(zmk_event_t *event) { return zmk_event_manager_handle_from(event, 0); }
+static int zmk_event_manager_handle_from(zmk_event_t *event, uint16_t start_index) {
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+    uint32_t start_cycles = k_cycle_get_32();
+    int ret = dispatch(event, start_index);
+    event->event->subscribers->stats.cycles += k_cycle_get_32() - start_cycles;
+    return ret;
+#else
+    return dispatch(event, start_index);
+#endif
+}
 
-int zmk_event_manager_raise_after(zmk_event_t *event, const struct zmk_listener *listener) {
-    uint8_t len = __event_subscriptions_end - __event_subscriptions_start;
-    for (int i = 0; i < len; i++) {
-        struct zmk_event_subscription *ev_sub = __event_subscriptions_start + i;
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_DEFERRED_RAISE)
+
+/*
+ * Run-to-completion queue. The thread that owns dispatch_owner runs the
+ * outermost raise; raises it makes from within listeners are copied into
+ * the capture pool and queued here, then drained in FIFO order before the
+ * outermost raise returns. Only the owner touches the queue. Raises from
+ * other threads meanwhile are dispatched immediately, as without deferral.
+ */
+struct deferred_event {
+    zmk_event_handle_t handle;
+    uint16_t start_index;
+};
+
+static struct deferred_event deferred_queue[CONFIG_ZMK_EVENT_MANAGER_DEFERRED_QUEUE_SIZE];
+static uint8_t deferred_head;
+static uint8_t deferred_count;
+static atomic_ptr_t dispatch_owner = ATOMIC_PTR_INIT(NULL);
+
+static int defer_pooled(zmk_event_handle_t handle, uint16_t start_index) {
+    if (deferred_count == ARRAY_SIZE(deferred_queue)) {
+        return -ENOMEM;
+    }
+
+    uint8_t tail = (deferred_head + deferred_count) % ARRAY_SIZE(deferred_queue);
+    deferred_queue[tail] = (struct deferred_event){.handle = handle, .start_index = start_index};
+    deferred_count++;
+    return 0;
+}
+
+static int defer(const zmk_event_t *event, uint16_t start_index) {
+    if (deferred_count == ARRAY_SIZE(deferred_queue)) {
+        return -ENOMEM;
+    }
+
+    zmk_event_handle_t handle = zmk_event_pool_capture(event, event->event->size);
+    if (handle < 0) {
+        return handle;
+    }
+
+    return defer_pooled(handle, start_index);
+}
+
+static void drain_deferred(void) {
+    while (deferred_count > 0) {
+        struct deferred_event next = deferred_queue[deferred_head];
+        deferred_head = (deferred_head + 1) % ARRAY_SIZE(deferred_queue);
+        deferred_count--;
+
+        zmk_event_manager_handle_from(zmk_event_pool_get(next.handle), next.start_index);
+        zmk_event_pool_free(next.handle);
+    }
+}
+
+static int submit(zmk_event_t *event, uint16_t start_index) {
+    k_tid_t self = k_current_get();
 
-        if (ev_sub->event_type == event->event && ev_sub->listener == listener) {
-            return zmk_event_manager_handle_from(event, i + 1);
+    if (atomic_ptr_get(&dispatch_owner) == self) {
+        if (defer(event, start_index) == 0) {
+            return 0;
         }
+        LOG_WRN("Deferred event queue full, dispatching %s nested", event->event->name);
+        return zmk_event_manager_handle_from(event, start_index);
     }
 
-    LOG_WRN("Unable to find where to raise this after event");
+    if (!atomic_ptr_cas(&dispatch_owner, NULL, self)) {
+        return zmk_event_manager_handle_from(event, start_index);
+    }
 
-    return -EINVAL;
+    int ret = zmk_event_manager_handle_from(event, start_index);
+    drain_deferred();
+    atomic_ptr_set(&dispatch_owner, NULL);
+    return ret;
 }
 
-int zmk_event_manager_raise_at(zmk_event_t *event, const struct zmk_listener *listener) {
-    uint8_t len = __event_subscriptions_end - __event_subscriptions_start;
-    for (int i = 0; i < len; i++) {
-        struct zmk_event_subscription *ev_sub = __event_subscriptions_start + i;
+// Like submit(), for an event in the capture pool whose slot it takes over.
+static int submit_pooled(zmk_event_handle_t handle, uint16_t start_index) {
+    zmk_event_t *event = zmk_event_pool_get(handle);
 
-        if (ev_sub->event_type == event->event && ev_sub->listener == listener) {
-            return zmk_event_manager_handle_from(event, i);
+    if (atomic_ptr_get(&dispatch_owner) == k_current_get()) {
+        if (defer_pooled(handle, start_index) == 0) {
+            return 0;
         }
+        LOG_WRN("Deferred event queue full, dispatching %s nested", event->event->name);
+        int ret = zmk_event_manager_handle_from(event, start_index);
+        zmk_event_pool_free(handle);
+        return ret;
     }
 
-    LOG_WRN("Unable to find where to raise this event");
+    int ret = submit(event, start_index);
+    zmk_event_pool_free(handle);
+    return ret;
+}
+
+#else
+
+static inline int submit(zmk_event_t *event, uint16_t start_index) {
+    return zmk_event_manager_handle_from(event, start_index);
+}
+
+static int submit_pooled(zmk_event_handle_t handle, uint16_t start_index) {
+    int ret = zmk_event_manager_handle_from(zmk_event_pool_get(handle), start_index);
+    zmk_event_pool_free(handle);
+    return ret;
+}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_DEFERRED_RAISE) */
+
+static inline void count_raised(const zmk_event_t *event) {
+    ZMK_PROFILING_MARK1(event_raise, event->event->name);
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+    event->event->subscribers->stats.raised++;
+#endif
+}
+
+static int find_listener(const zmk_event_t *event, const struct zmk_listener *listener) {
+    const struct zmk_event_subscribers *subs = event->event->subscribers;
+    for (int i = subs->start; i < subs->start + subs->count; i++) {
+        if (__event_subscriptions_start[dispatch_table[i]].listener == listener) {
+            return i;
+        }
+    }
 
     return -EINVAL;
 }
 
+int zmk_event_manager_raise(zmk_event_t *event) {
+    count_raised(event);
+    return submit(event, event->event->subscribers->start);
+}
+
+int zmk_event_manager_raise_after(zmk_event_t *event, const struct zmk_listener *listener) {
+    int index = find_listener(event, listener);
+    if (index < 0) {
+        LOG_WRN("Unable to find where to raise this after event");
+        return -EINVAL;
+    }
+
+    count_raised(event);
+    return submit(event, index + 1);
+}
+
+int zmk_event_manager_raise_at(zmk_event_t *event, const struct zmk_listener *listener) {
+    int index = find_listener(event, listener);
+    if (index < 0) {
+        LOG_WRN("Unable to find where to raise this event");
+        return -EINVAL;
+    }
+
+    count_raised(event);
+    return submit(event, index);
+}
+
 int zmk_event_manager_release(zmk_event_t *event) {
-    return zmk_event_manager_handle_from(event, event->last_listener_index + 1);
+    return submit(event, event->last_listener_index + 1);
+}
+
+/*
+ * Capture pool: fixed-size slots holding whole events, so a behavior that
+ * defers an event keeps a two-byte handle instead of its own copy. Free
+ * slots form a stack, making capture and free O(1).
+ */
+union event_pool_slot {
+    zmk_event_t header;
+    uint64_t align;
+    uint8_t bytes[CONFIG_ZMK_EVENT_POOL_SLOT_SIZE];
+};
+
+static union event_pool_slot event_pool[CONFIG_ZMK_EVENT_POOL_SIZE];
+static zmk_event_handle_t event_pool_free_list[CONFIG_ZMK_EVENT_POOL_SIZE];
+static size_t event_pool_free_count;
+static struct k_spinlock event_pool_lock;
+
+zmk_event_handle_t zmk_event_pool_capture(const zmk_event_t *event, size_t size) {
+    if (size > sizeof(union event_pool_slot)) {
+        LOG_ERR("Event %s (%d bytes) exceeds CONFIG_ZMK_EVENT_POOL_SLOT_SIZE",
+                event->event->name, (int)size);
+        return -EMSGSIZE;
+    }
+
+    zmk_event_handle_t handle = -ENOMEM;
+    k_spinlock_key_t key = k_spin_lock(&event_pool_lock);
+    if (event_pool_free_count > 0) {
+        handle = event_pool_free_list[--event_pool_free_count];
+    }
+    k_spin_unlock(&event_pool_lock, key);
+
+    if (handle < 0) {
+        LOG_ERR("Event pool exhausted; increase CONFIG_ZMK_EVENT_POOL_SIZE");
+        return handle;
+    }
+
+    memcpy(&event_pool[handle], event, size);
+    return handle;
 }
+
+zmk_event_t *zmk_event_pool_get(zmk_event_handle_t handle) {
+    __ASSERT(handle >= 0 && handle < CONFIG_ZMK_EVENT_POOL_SIZE, "Invalid event handle %d", handle);
+    return &event_pool[handle].header;
+}
+
+void zmk_event_pool_free(zmk_event_handle_t handle) {
+    __ASSERT(handle >= 0 && handle < CONFIG_ZMK_EVENT_POOL_SIZE, "Invalid event handle %d", handle);
+    k_spinlock_key_t key = k_spin_lock(&event_pool_lock);
+    event_pool_free_list[event_pool_free_count++] = handle;
+    k_spin_unlock(&event_pool_lock, key);
+}
+
+int zmk_event_pool_raise(zmk_event_handle_t handle) {
+    zmk_event_t *event = zmk_event_pool_get(handle);
+
+    count_raised(event);
+    return submit_pooled(handle, event->event->subscribers->start);
+}
+
+int zmk_event_pool_raise_after(zmk_event_handle_t handle, const struct zmk_listener *listener) {
+    zmk_event_t *event = zmk_event_pool_get(handle);
+    int index = find_listener(event, listener);
+    if (index < 0) {
+        LOG_WRN("Unable to find where to raise this after event");
+        zmk_event_pool_free(handle);
+        return -EINVAL;
+    }
+
+    count_raised(event);
+    return submit_pooled(handle, index + 1);
+}
+
+int zmk_event_pool_raise_at(zmk_event_handle_t handle, const struct zmk_listener *listener) {
+    zmk_event_t *event = zmk_event_pool_get(handle);
+    int index = find_listener(event, listener);
+    if (index < 0) {
+        LOG_WRN("Unable to find where to raise this event");
+        zmk_event_pool_free(handle);
+        return -EINVAL;
+    }
+
+    count_raised(event);
+    return submit_pooled(handle, index);
+}
+
+int zmk_event_pool_release(zmk_event_handle_t handle) {
+    zmk_event_t *event = zmk_event_pool_get(handle);
+
+    return submit_pooled(handle, event->last_listener_index + 1);
+}
+
+static int event_manager_init(void) {
+    for (size_t i = 0; i < ARRAY_SIZE(event_pool); i++) {
+        event_pool_free_list[i] = (zmk_event_handle_t)(ARRAY_SIZE(event_pool) - 1 - i);
+    }
+    event_pool_free_count = ARRAY_SIZE(event_pool);
+
+    size_t sub_count = __event_subscriptions_end - __event_subscriptions_start;
+
+    uint16_t next = 0;
+    for (const struct zmk_event_type **type = __event_type_start; type < __event_type_end;
+         type++) {
+        struct zmk_event_subscribers *subs = (*type)->subscribers;
+
+        subs->start = next;
+        for (size_t i = 0; i < sub_count; i++) {
+            if (__event_subscriptions_start[i].event_type == *type) {
+                dispatch_table[next++] = i;
+            }
+        }
+        subs->count = next - subs->start;
+    }
+
+    return 0;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+size_t zmk_event_manager_stats_foreach(zmk_event_stats_cb_t cb, void *user_data) {
+    for (const struct zmk_event_type **type = __event_type_start; type < __event_type_end;
+         type++) {
+        if (cb) {
+            cb(*type, &(*type)->subscribers->stats, user_data);
+        }
+    }
+
+    return __event_type_end - __event_type_start;
+}
+#endif
+
+/* Before any driver or subsystem can raise an event. */
+SYS_INIT(event_manager_init, PRE_KERNEL_1, 0);
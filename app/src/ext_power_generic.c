@@ -16,6 +16,8 @@
 
 #include <drivers/ext_power.h>
 
+#include <zmk/settings.h>
+
 #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
 
 #include <zephyr/logging/log.h>
@@ -34,53 +36,61 @@ struct ext_power_generic_data {
 #endif
 };
 
+int ext_power_save_state(void) {
 #if IS_ENABLED(CONFIG_SETTINGS)
-static void ext_power_save_state_work(struct k_work *work) {
     char setting_path[40];
     const struct device *ext_power = DEVICE_DT_GET(DT_DRV_INST(0));
     struct ext_power_generic_data *data = ext_power->data;
 
     snprintf(setting_path, sizeof(setting_path), "ext_power/state/%s", ext_power->name);
-    settings_save_one(setting_path, &data->status, sizeof(data->status));
-}
-
-static struct k_work_delayable ext_power_save_work;
-#endif
-
-int ext_power_save_state(void) {
-#if IS_ENABLED(CONFIG_SETTINGS)
-    int ret = k_work_reschedule(&ext_power_save_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
-    return MIN(ret, 0);
+    return zmk_settings_save(setting_path, &data->status, sizeof(data->status));
 #else
     return 0;
 #endif
 }
 
-static int ext_power_generic_enable(const struct device *dev) {
-    struct ext_power_generic_data *data = dev->data;
+static int ext_power_generic_set_pins(const struct device *dev, bool on) {
     const struct ext_power_generic_config *config = dev->config;
 
     for (int i = 0; i < config->control_gpios_count; i++) {
         const struct gpio_dt_spec *gpio = &config->control[i];
-        if (gpio_pin_set_dt(gpio, 1)) {
-            LOG_WRN("Failed to set ext-power control pin %d", i);
+        if (gpio_pin_set_dt(gpio, on)) {
+            LOG_WRN("Failed to %s ext-power control pin %d", on ? "set" : "clear", i);
             return -EIO;
         }
     }
+    return 0;
+}
+
+// While the device is suspended, the pins stay off and only the status to resume to changes.
+static bool ext_power_generic_is_suspended(const struct device *dev) {
+#ifdef CONFIG_PM_DEVICE
+    enum pm_device_state state;
+    return pm_device_state_get(dev, &state) == 0 && state != PM_DEVICE_STATE_ACTIVE;
+#else
+    return false;
+#endif /* CONFIG_PM_DEVICE */
+}
+
+static int ext_power_generic_enable(const struct device *dev) {
+    struct ext_power_generic_data *data = dev->data;
+
+    if (!ext_power_generic_is_suspended(dev)) {
+        int rc = ext_power_generic_set_pins(dev, true);
+        if (rc) {
+            return rc;
+        }
+    }
     data->status = true;
     return ext_power_save_state();
 }
 
 static int ext_power_generic_disable(const struct device *dev) {
     struct ext_power_generic_data *data = dev->data;
-    const struct ext_power_generic_config *config = dev->config;
 
-    for (int i = 0; i < config->control_gpios_count; i++) {
-        const struct gpio_dt_spec *gpio = &config->control[i];
-        if (gpio_pin_set_dt(gpio, 0)) {
-            LOG_WRN("Failed to clear ext-power control pin %d", i);
-            return -EIO;
-        }
+    int rc = ext_power_generic_set_pins(dev, false);
+    if (rc) {
+        return rc;
     }
     data->status = false;
     return ext_power_save_state();
@@ -134,7 +144,7 @@ static int ext_power_settings_commit() {
     if (!data->settings_init) {
 
         data->status = true;
-        k_work_schedule(&ext_power_save_work, K_NO_WAIT);
+        ext_power_save_state();
 
         ext_power_enable(dev);
     }
@@ -158,10 +168,6 @@ static int ext_power_generic_init(const struct device *dev) {
         }
     }
 
-#if IS_ENABLED(CONFIG_SETTINGS)
-    k_work_init_delayable(&ext_power_save_work, ext_power_save_state_work);
-#endif
-
     // Enable by default. We may get disabled again once settings load.
     ext_power_enable(dev);
 
@@ -173,14 +179,16 @@ static int ext_power_generic_init(const struct device *dev) {
 }
 
 #ifdef CONFIG_PM_DEVICE
+// Suspending only switches the output off; the saved status is what resuming restores, so
+// runtime PM can power the output down whenever it has no users.
 static int ext_power_generic_pm_action(const struct device *dev, enum pm_device_action action) {
+    struct ext_power_generic_data *data = dev->data;
+
     switch (action) {
     case PM_DEVICE_ACTION_RESUME:
-        ext_power_generic_enable(dev);
-        return 0;
+        return ext_power_generic_set_pins(dev, data->status);
     case PM_DEVICE_ACTION_SUSPEND:
-        ext_power_generic_disable(dev);
-        return 0;
+        return ext_power_generic_set_pins(dev, false);
     default:
         return -ENOTSUP;
     }
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/devicetree.h>
+#include <zephyr/init.h>
+#include <zephyr/irq.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <zmk/combos.h>
+#include <zmk/fuzz.h>
+#include <zmk/hid.h>
+#include <zmk/matrix.h>
+#include <zmk/position_state.h>
+#include <zmk/workqueue.h>
+#include <zmk/events/position_state_changed.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Set by the libFuzzer entry point of native_sim before it raises CONFIG_ARCH_POSIX_FUZZ_IRQ
+extern const uint8_t *posix_fuzz_buf;
+extern size_t posix_fuzz_sz;
+
+// Each event of an input is two bytes: a key position, taken modulo the keymap length, whose
+// state is toggled, and the milliseconds to wait before the next event.
+#define FUZZ_EVENT_SIZE 2
+
+static uint8_t input[CONFIG_ZMK_FUZZ_MAX_EVENTS * FUZZ_EVENT_SIZE];
+static size_t input_len;
+static size_t input_pos;
+static bool running;
+
+static void fuzz_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(fuzz_work, fuzz_work_handler);
+
+static void raise_position(uint32_t position, bool state) {
+    raise_zmk_position_state_changed(
+        (struct zmk_position_state_changed){.source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL,
+                                            .state = state,
+                                            .position = position,
+                                            .timestamp = k_uptime_get()});
+}
+
+static bool hid_reports_empty(void) {
+    static const struct zmk_hid_keyboard_report_body empty_keyboard;
+    static const struct zmk_hid_consumer_report_body empty_consumer;
+
+    return memcmp(&zmk_hid_get_keyboard_report()->body, &empty_keyboard,
+                  sizeof(empty_keyboard)) == 0 &&
+           memcmp(&zmk_hid_get_consumer_report()->body, &empty_consumer,
+                  sizeof(empty_consumer)) == 0;
+}
+
+#define CHECK_INVARIANT(cond)                                                                      \
+    if (!(cond)) {                                                                                 \
+        LOG_ERR("Invariant failed after all keys were released: %s", #cond);                      \
+        abort();                                                                                   \
+    }
+
+static void check_invariants(void) {
+#if ZMK_COMBOS_LEN > 0
+    CHECK_INVARIANT(zmk_combos_idle());
+#endif
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_behavior_hold_tap)
+    CHECK_INVARIANT(zmk_behavior_hold_tap_idle());
+#endif
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_behavior_sticky_key)
+    CHECK_INVARIANT(zmk_behavior_sticky_key_idle());
+#endif
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_behavior_tap_dance)
+    CHECK_INVARIANT(zmk_behavior_tap_dance_idle());
+#endif
+    CHECK_INVARIANT(zmk_position_state_pressed_count() == 0);
+    CHECK_INVARIANT(hid_reports_empty());
+}
+
+// Replays the input on the system work queue, as the kscan drivers do, then releases the keys
+// still held and waits for every timeout before checking that nothing was left behind.
+static void fuzz_work_handler(struct k_work *work) {
+    if (input_pos < input_len) {
+        uint32_t position = input[input_pos] % ZMK_KEYMAP_LEN;
+        uint8_t delay = input[input_pos + 1];
+
+        input_pos += FUZZ_EVENT_SIZE;
+        raise_position(position, !zmk_position_state_is_pressed(position));
+        k_work_schedule_for_queue(zmk_workqueue_input_work_q(), &fuzz_work, K_MSEC(delay));
+        return;
+    }
+
+    if (input_pos == input_len) {
+        for (uint32_t i = 0; i < ZMK_KEYMAP_LEN; i++) {
+            if (zmk_position_state_is_pressed(i)) {
+                raise_position(i, false);
+            }
+        }
+
+        input_pos++;
+        k_work_schedule_for_queue(zmk_workqueue_input_work_q(), &fuzz_work,
+                                  K_MSEC(CONFIG_ZMK_FUZZ_SETTLE_MS));
+        return;
+    }
+
+    check_invariants();
+    running = false;
+}
+
+static void fuzz_isr(const void *arg) {
+    // An input arriving before the previous one settled would break the invariants, so it's
+    // dropped instead. CONFIG_ARCH_POSIX_FUZZ_TICKS must cover the longest input.
+    if (running) {
+        LOG_WRN("Dropping a fuzz input, the previous one hasn't settled");
+        return;
+    }
+
+    input_len = MIN(posix_fuzz_sz, sizeof(input)) / FUZZ_EVENT_SIZE * FUZZ_EVENT_SIZE;
+    memcpy(input, posix_fuzz_buf, input_len);
+    input_pos = 0;
+    running = true;
+
+    k_work_schedule_for_queue(zmk_workqueue_input_work_q(), &fuzz_work, K_NO_WAIT);
+}
+
+static int zmk_fuzz_init(void) {
+    IRQ_CONNECT(CONFIG_ARCH_POSIX_FUZZ_IRQ, 0, fuzz_isr, NULL, 0);
+    irq_enable(CONFIG_ARCH_POSIX_FUZZ_IRQ);
+    return 0;
+}
+
+SYS_INIT(zmk_fuzz_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -5,6 +5,7 @@
  */
 
 #include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/hwinfo.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/init.h>
 #include <zephyr/pm/device.h>
@@ -14,15 +15,90 @@
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+#include <zmk/gpio_key_wakeup_trigger.h>
+
 #define DT_DRV_COMPAT zmk_gpio_key_wakeup_trigger
 
+// Keys are only replayed where the endpoints are, i.e. not on split peripherals.
+#define WAKEUP_REPLAY                                                                              \
+    (IS_ENABLED(CONFIG_HWINFO) &&                                                                  \
+     (!IS_ENABLED(CONFIG_ZMK_SPLIT) || IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)))
+
+#if WAKEUP_REPLAY
+
+#include <zmk/endpoints.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/endpoint_changed.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/physical_layouts.h>
+
+#endif // WAKEUP_REPLAY
+
 struct gpio_key_wakeup_trigger_config {
     struct gpio_dt_spec trigger;
+    // keymap position of the trigger key, or -1 if it doesn't stand for a single key
+    int32_t position;
     size_t extra_gpios_count;
     struct gpio_dt_spec extra_gpios[];
 };
 
+struct gpio_key_wakeup_trigger_data {
+    // The trigger key was pressed at reset and the kscan hasn't reported it since.
+    bool latched;
+};
+
+#if WAKEUP_REPLAY
+
+// Whether any trigger key was pressed at reset, i.e. the device was woken by one.
+static bool woken_by_key;
+static int64_t first_key_ms = -1;
+
+// Whether this reset is a wakeup from soft off, rather than e.g. a power-on with a key held.
+static bool woken_from_soft_off(void) {
+    uint32_t cause;
+
+    if (hwinfo_get_reset_cause(&cause) < 0) {
+        return false;
+    }
+
+    return (cause & RESET_LOW_POWER_WAKE) != 0;
+}
+
+static bool trigger_is_active(const struct gpio_key_wakeup_trigger_config *config) {
+    if (gpio_pin_configure_dt(&config->trigger, GPIO_INPUT) < 0) {
+        return false;
+    }
+
+    for (int i = 0; i < config->extra_gpios_count; i++) {
+        gpio_pin_configure_dt(&config->extra_gpios[i], GPIO_OUTPUT_ACTIVE);
+    }
+
+    bool active = gpio_pin_get_dt(&config->trigger) > 0;
+
+    // The kscan configures the pins again once it's initialized.
+    for (int i = 0; i < config->extra_gpios_count; i++) {
+        gpio_pin_configure_dt(&config->extra_gpios[i], GPIO_DISCONNECTED);
+    }
+
+    return active;
+}
+
+#endif // WAKEUP_REPLAY
+
 static int zmk_gpio_key_wakeup_trigger_init(const struct device *dev) {
+#if WAKEUP_REPLAY
+    const struct gpio_key_wakeup_trigger_config *config = dev->config;
+    struct gpio_key_wakeup_trigger_data *data = dev->data;
+
+    // Latch the key that woke the device this early, as it's often released again well before
+    // settings, BLE and the kscan are up.
+    if (config->position >= 0 && woken_from_soft_off() && trigger_is_active(config)) {
+        data->latched = true;
+        woken_by_key = true;
+    }
+#endif // WAKEUP_REPLAY
+
 #if IS_ENABLED(CONFIG_PM_DEVICE)
     pm_device_init_suspended(dev);
     pm_device_wakeup_enable(dev, true);
@@ -94,18 +170,144 @@ static int gpio_key_wakeup_trigger_pm_action(const struct device *dev,
 
 #endif // IS_ENABLED(CONFIG_PM_DEVICE)
 
+#if WAKEUP_REPLAY
+
+// Long enough for the kscan to report a trigger key that is still held, so it isn't replayed too.
+#define REPLAY_SETTLE_MS 50
+
+#define GPIO_KEY_WAKEUP_TRIGGER_DEV(n) DEVICE_DT_INST_GET(n),
+
+static const struct device *const triggers[] = {
+    DT_INST_FOREACH_STATUS_OKAY(GPIO_KEY_WAKEUP_TRIGGER_DEV)};
+
+static void replay_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(replay_work, replay_work_cb);
+
+static bool replay_pending(void) {
+    for (int i = 0; i < ARRAY_SIZE(triggers); i++) {
+        const struct gpio_key_wakeup_trigger_data *data = triggers[i]->data;
+        if (data->latched) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Replays the latched keys as taps once an endpoint can take the report, which is the first one
+// available: USB if it's connected, without waiting for BLE to reconnect.
+static void replay_work_cb(struct k_work *work) {
+    const int64_t timeout = CONFIG_ZMK_GPIO_KEY_WAKEUP_TRIGGER_REPLAY_TIMEOUT;
+
+    if (!zmk_endpoint_is_connected() && k_uptime_get() < timeout) {
+        // The endpoint_changed listener reschedules this once one connects.
+        k_work_schedule(&replay_work, K_TIMEOUT_ABS_MS(timeout));
+        return;
+    }
+
+    int64_t now = k_uptime_get();
+
+    for (int i = 0; i < ARRAY_SIZE(triggers); i++) {
+        const struct gpio_key_wakeup_trigger_config *config = triggers[i]->config;
+        struct gpio_key_wakeup_trigger_data *data = triggers[i]->data;
+
+        if (!data->latched) {
+            continue;
+        }
+        data->latched = false;
+
+        if (!zmk_endpoint_is_connected()) {
+            LOG_WRN("No endpoint connected, dropping key %d that woke the device",
+                    config->position);
+            continue;
+        }
+
+        LOG_DBG("Replaying key %d that woke the device", config->position);
+        // A tap, so behaviors don't take the time until the replay as the key being held.
+        int ret = zmk_physical_layouts_kscan_position_changed(config->position, true, now);
+        if (ret >= 0) {
+            ret = zmk_physical_layouts_kscan_position_changed(config->position, false, now);
+        }
+        if (ret < 0) {
+            LOG_ERR("Failed to replay key %d that woke the device (%d)", config->position, ret);
+        }
+    }
+}
+
+static int gpio_key_wakeup_trigger_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *pos_ev = as_zmk_position_state_changed(eh);
+    if (pos_ev != NULL) {
+        if (!pos_ev->state) {
+            return ZMK_EV_EVENT_BUBBLE;
+        }
+
+        // The kscan reported the key itself, since it was still held.
+        for (int i = 0; i < ARRAY_SIZE(triggers); i++) {
+            const struct gpio_key_wakeup_trigger_config *config = triggers[i]->config;
+            struct gpio_key_wakeup_trigger_data *data = triggers[i]->data;
+            if (data->latched && config->position == pos_ev->position) {
+                data->latched = false;
+            }
+        }
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_keycode_state_changed *key_ev = as_zmk_keycode_state_changed(eh);
+    if (key_ev != NULL) {
+        if (woken_by_key && first_key_ms < 0 && key_ev->state && zmk_endpoint_is_connected()) {
+            first_key_ms = k_uptime_get();
+            LOG_INF("First key sent %lld ms after wakeup", first_key_ms);
+        }
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    if (as_zmk_endpoint_changed(eh) != NULL && replay_pending() &&
+        k_uptime_get() >= REPLAY_SETTLE_MS) {
+        k_work_reschedule(&replay_work, K_NO_WAIT);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(gpio_key_wakeup_trigger, gpio_key_wakeup_trigger_listener);
+ZMK_SUBSCRIPTION(gpio_key_wakeup_trigger, zmk_position_state_changed);
+ZMK_SUBSCRIPTION(gpio_key_wakeup_trigger, zmk_keycode_state_changed);
+ZMK_SUBSCRIPTION(gpio_key_wakeup_trigger, zmk_endpoint_changed);
+
+int64_t zmk_gpio_key_wakeup_trigger_first_key_ms(void) { return first_key_ms; }
+
+static int gpio_key_wakeup_trigger_replay_init(void) {
+    if (replay_pending()) {
+        k_work_schedule(&replay_work, K_TIMEOUT_ABS_MS(REPLAY_SETTLE_MS));
+    }
+
+    return 0;
+}
+
+SYS_INIT(gpio_key_wakeup_trigger_replay_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#else
+
+int64_t zmk_gpio_key_wakeup_trigger_first_key_ms(void) { return -1; }
+
+#endif // WAKEUP_REPLAY
+
 #define WAKEUP_TRIGGER_EXTRA_GPIO_SPEC(idx, n)                                                     \
     GPIO_DT_SPEC_GET_BY_IDX(DT_DRV_INST(n), extra_gpios, idx)
 
 #define GPIO_KEY_WAKEUP_TRIGGER_INST(n)                                                            \
     const struct gpio_key_wakeup_trigger_config wtk_cfg_##n = {                                    \
         .trigger = GPIO_DT_SPEC_GET(DT_INST_PROP(n, trigger), gpios),                              \
+        .position = DT_INST_PROP_OR(n, position, -1),                                              \
         .extra_gpios = {LISTIFY(DT_PROP_LEN_OR(DT_DRV_INST(n), extra_gpios, 0),                    \
                                 WAKEUP_TRIGGER_EXTRA_GPIO_SPEC, (, ), n)},                         \
         .extra_gpios_count = DT_PROP_LEN_OR(DT_DRV_INST(n), extra_gpios, 0),                       \
     };                                                                                             \
+    static struct gpio_key_wakeup_trigger_data wtk_data_##n;                                       \
     PM_DEVICE_DT_INST_DEFINE(n, gpio_key_wakeup_trigger_pm_action);                                \
-    DEVICE_DT_INST_DEFINE(n, zmk_gpio_key_wakeup_trigger_init, PM_DEVICE_DT_INST_GET(n), NULL,     \
-                          &wtk_cfg_##n, PRE_KERNEL_2, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, NULL);
+    DEVICE_DT_INST_DEFINE(n, zmk_gpio_key_wakeup_trigger_init, PM_DEVICE_DT_INST_GET(n),           \
+                          &wtk_data_##n, &wtk_cfg_##n, PRE_KERNEL_2,                               \
+                          CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, NULL);
 
 DT_INST_FOREACH_STATUS_OKAY(GPIO_KEY_WAKEUP_TRIGGER_INST)
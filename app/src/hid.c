@@ -6,73 +6,147 @@
 
 #include "zmk/keys.h"
 #include <zephyr/logging/log.h>
-LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+LOG_MODULE_REGISTER(zmk_hid, CONFIG_ZMK_LOG_LEVEL);
 
+#include <zephyr/sys/byteorder.h>
+
+#include <zmk/context.h>
 #include <zmk/hid.h>
 #include <dt-bindings/zmk/modifiers.h>
 
-static struct zmk_hid_keyboard_report keyboard_report = {
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO)
 
-    .report_id = ZMK_HID_REPORT_ID_KEYBOARD, .body = {.modifiers = 0, ._reserved = 0, .keys = {0}}};
+BUILD_ASSERT(CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE <= 32, "At most 32 keyboard keys are reportable");
 
-static struct zmk_hid_consumer_report consumer_report = {.report_id = ZMK_HID_REPORT_ID_CONSUMER,
-                                                         .body = {.keys = {0}}};
+#define KEYBOARD_SLOTS_MASK ((uint32_t)BIT64_MASK(CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE))
 
-#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+#endif
 
-static zmk_hid_boot_report_t boot_report = {.modifiers = 0, ._reserved = 0, .keys = {0}};
-static uint8_t keys_held = 0;
+// Held keys that carry implicit modifiers at once. Keys without any don't take an entry.
+#define IMPLICIT_MODIFIER_OWNERS_LEN 8
 
-#endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
+struct implicit_modifier_owner {
+    uint32_t usage;
+    zmk_mod_flags_t modifiers;
+};
 
+struct hid_state {
+    struct zmk_hid_keyboard_report keyboard_report;
+    struct zmk_hid_consumer_report consumer_report;
+#if IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT)
+    zmk_hid_boot_report_t boot_report;
+    uint8_t keys_held;
+#endif
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
+    struct zmk_hid_mouse_report mouse_report;
+    // Keep track of how often a button was pressed.
+    // Only release the button if the count is 0.
+    int explicit_button_counts[5];
+    zmk_mod_flags_t explicit_buttons;
+#endif
+
+    // Keep track of how often a modifier was pressed.
+    // Only release the modifier if the count is 0.
+    int explicit_modifier_counts[8];
+    zmk_mod_flags_t explicit_modifiers;
+    // The implicit modifiers of the latest press, for as long as a held key carries them.
+    zmk_mod_flags_t implicit_modifiers;
+    // Keep track of how many held keys carry each implicit modifier and which ones each key
+    // carries, so a release only drops the ones no other held key carries.
+    int implicit_modifier_counts[8];
+    zmk_mod_flags_t held_implicit_modifiers;
+    struct implicit_modifier_owner implicit_modifier_owners[IMPLICIT_MODIFIER_OWNERS_LEN];
+    zmk_mod_flags_t masked_modifiers;
+    // Forced on and off over all of the above while a behavior types on its own, so it never
+    // touches the modifiers of the keys and behaviors around it.
+    zmk_mod_flags_t override_modifiers;
+    zmk_mod_flags_t override_masked_modifiers;
+
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_NKRO) && IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT)
+    // The boot report is kept up to date alongside the bitmap, so either one can be sent without
+    // converting. Keys pressed while all its slots are taken are placed once a slot frees up.
+    uint8_t boot_key_slots[ZMK_HID_KEYBOARD_NKRO_MAX_USAGE + 1];
+    // bits of the boot report slots that hold no key
+    uint8_t free_boot_slots;
+#elif IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO)
+    // The usages in the report and the slot holding each of them, so pressing, releasing and
+    // checking a key don't have to scan the report.
+    uint32_t keyboard_usages[DIV_ROUND_UP(ZMK_HID_KEYBOARD_MAX_USAGE + 1, 32)];
+    uint8_t keyboard_usage_slots[ZMK_HID_KEYBOARD_MAX_USAGE + 1];
+    // bits of the report slots that hold no key
+    uint32_t free_keyboard_slots;
+#endif
+};
 
-static struct zmk_hid_mouse_report mouse_report = {
-    .report_id = ZMK_HID_REPORT_ID_MOUSE,
-    .body = {.buttons = 0, .d_x = 0, .d_y = 0, .d_scroll_y = 0, .d_scroll_x = 0}};
+ZMK_CONTEXT_STATE_DEFINE(
+    hid_states, struct hid_state,
+    {
+        .keyboard_report = {.report_id = ZMK_HID_REPORT_ID_KEYBOARD},
+        .consumer_report = {.report_id = ZMK_HID_REPORT_ID_CONSUMER},
+        IF_ENABLED(CONFIG_ZMK_POINTING, (.mouse_report = {.report_id = ZMK_HID_REPORT_ID_MOUSE},))
+        IF_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_NKRO,
+                   (IF_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT,
+                               (.free_boot_slots = BIT_MASK(HID_BOOT_KEY_LEN), ))))
+        IF_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO,
+                   (.free_keyboard_slots = KEYBOARD_SLOTS_MASK, ))
+    });
 
-#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+#define STATE ZMK_CONTEXT_STATE(hid_states)
 
-// Keep track of how often a modifier was pressed.
-// Only release the modifier if the count is 0.
-static int explicit_modifier_counts[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-static zmk_mod_flags_t explicit_modifiers = 0;
-static zmk_mod_flags_t implicit_modifiers = 0;
-static zmk_mod_flags_t masked_modifiers = 0;
+// Sets the report's modifiers from the explicit, masked and implicit ones, returning 1 if that
+// changed them, so callers only send a report for an actual change.
+static int set_report_modifiers(void) {
+    zmk_mod_flags_t current = STATE->keyboard_report.body.modifiers;
 
-#define SET_MODIFIERS(mods)                                                                        \
-    {                                                                                              \
-        keyboard_report.body.modifiers = (mods & ~masked_modifiers) | implicit_modifiers;          \
-        LOG_DBG("Modifiers set to 0x%02X", keyboard_report.body.modifiers);                        \
-    }
+    zmk_mod_flags_t modifiers =
+        (STATE->explicit_modifiers & ~STATE->masked_modifiers) | STATE->implicit_modifiers;
+    STATE->keyboard_report.body.modifiers =
+        (modifiers & ~STATE->override_masked_modifiers) | STATE->override_modifiers;
 
-#define GET_MODIFIERS (keyboard_report.body.modifiers)
+    return current == STATE->keyboard_report.body.modifiers ? 0 : 1;
+}
 
-zmk_mod_flags_t zmk_hid_get_explicit_mods(void) { return explicit_modifiers; }
+// Logged from the caller, so the log tells which kind of modifier change set them
+#define update_modifiers()                                                                         \
+    ({                                                                                             \
+        int _changed = set_report_modifiers();                                                     \
+        LOG_DBG("Modifiers set to 0x%02X", STATE->keyboard_report.body.modifiers);                 \
+        _changed;                                                                                  \
+    })
 
-int zmk_hid_register_mod(zmk_mod_t modifier) {
-    explicit_modifier_counts[modifier]++;
-    LOG_DBG("Modifier %d count %d", modifier, explicit_modifier_counts[modifier]);
-    WRITE_BIT(explicit_modifiers, modifier, true);
-    zmk_mod_flags_t current = GET_MODIFIERS;
-    SET_MODIFIERS(explicit_modifiers);
-    return current == GET_MODIFIERS ? 0 : 1;
+zmk_mod_flags_t zmk_hid_get_explicit_mods(void) { return STATE->explicit_modifiers; }
+
+static void count_mod_press(zmk_mod_t modifier) {
+    STATE->explicit_modifier_counts[modifier]++;
+    LOG_DBG("Modifier %d count %d", modifier, STATE->explicit_modifier_counts[modifier]);
+    WRITE_BIT(STATE->explicit_modifiers, modifier, true);
 }
 
-int zmk_hid_unregister_mod(zmk_mod_t modifier) {
-    if (explicit_modifier_counts[modifier] <= 0) {
+static int count_mod_release(zmk_mod_t modifier) {
+    if (STATE->explicit_modifier_counts[modifier] <= 0) {
         LOG_ERR("Tried to unregister modifier %d too often", modifier);
         return -EINVAL;
     }
-    explicit_modifier_counts[modifier]--;
-    LOG_DBG("Modifier %d count: %d", modifier, explicit_modifier_counts[modifier]);
-    if (explicit_modifier_counts[modifier] == 0) {
+    STATE->explicit_modifier_counts[modifier]--;
+    LOG_DBG("Modifier %d count: %d", modifier, STATE->explicit_modifier_counts[modifier]);
+    if (STATE->explicit_modifier_counts[modifier] == 0) {
         LOG_DBG("Modifier %d released", modifier);
-        WRITE_BIT(explicit_modifiers, modifier, false);
+        WRITE_BIT(STATE->explicit_modifiers, modifier, false);
     }
-    zmk_mod_flags_t current = GET_MODIFIERS;
-    SET_MODIFIERS(explicit_modifiers);
-    return current == GET_MODIFIERS ? 0 : 1;
+    return 0;
+}
+
+int zmk_hid_register_mod(zmk_mod_t modifier) {
+    count_mod_press(modifier);
+    return update_modifiers();
+}
+
+int zmk_hid_unregister_mod(zmk_mod_t modifier) {
+    int err = count_mod_release(modifier);
+    if (err < 0) {
+        return err;
+    }
+    return update_modifiers();
 }
 
 bool zmk_hid_mod_is_pressed(zmk_mod_t modifier) {
@@ -80,79 +154,143 @@ bool zmk_hid_mod_is_pressed(zmk_mod_t modifier) {
     return (zmk_hid_get_explicit_mods() & mod_flag) == mod_flag;
 }
 
+// The report's modifiers are set once for all of the modifiers, and only for a non-empty set
 int zmk_hid_register_mods(zmk_mod_flags_t modifiers) {
-    int ret = 0;
-    for (zmk_mod_t i = 0; i < 8; i++) {
-        if (modifiers & (1 << i)) {
-            ret += zmk_hid_register_mod(i);
-        }
+    if (modifiers == 0) {
+        return 0;
+    }
+
+    for (zmk_mod_flags_t mods = modifiers; mods != 0; mods &= mods - 1) {
+        count_mod_press(__builtin_ctz(mods));
     }
-    return ret;
+    return update_modifiers();
 }
 
 int zmk_hid_unregister_mods(zmk_mod_flags_t modifiers) {
-    int ret = 0;
-    for (zmk_mod_t i = 0; i < 8; i++) {
-        if (modifiers & (1 << i)) {
-            ret += zmk_hid_unregister_mod(i);
-        }
+    int err = 0;
+
+    if (modifiers == 0) {
+        return 0;
+    }
+
+    for (zmk_mod_flags_t mods = modifiers; mods != 0; mods &= mods - 1) {
+        int ret = count_mod_release(__builtin_ctz(mods));
+        err = err < 0 ? err : ret;
     }
 
-    return ret;
+    int changed = update_modifiers();
+    return err < 0 ? err : changed;
 }
 
-#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+#if IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT)
 
 static zmk_hid_boot_report_t *boot_report_rollover(uint8_t modifiers) {
-    boot_report.modifiers = modifiers;
+    static zmk_hid_boot_report_t rollover_report;
+
+    rollover_report.modifiers = modifiers;
     for (int i = 0; i < HID_BOOT_KEY_LEN; i++) {
-        boot_report.keys[i] = HID_ERROR_ROLLOVER;
+        rollover_report.keys[i] = HID_ERROR_ROLLOVER;
     }
-    return &boot_report;
+    return &rollover_report;
 }
 
-#endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
+#endif /* IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT) */
 
 #if IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_NKRO)
 
-#define TOGGLE_KEYBOARD(code, val) WRITE_BIT(keyboard_report.body.keys[code / 8], code % 8, val)
+#define TOGGLE_KEYBOARD(code, val)                                                                 \
+    WRITE_BIT(STATE->keyboard_report.body.keys[code / 8], code % 8, val)
 
-#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
-zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
-    if (keys_held > HID_BOOT_KEY_LEN) {
-        return boot_report_rollover(keyboard_report.body.modifiers);
+static inline bool check_keyboard_usage(zmk_key_t usage) {
+    if (usage > ZMK_HID_KEYBOARD_NKRO_MAX_USAGE) {
+        return false;
     }
+    return STATE->keyboard_report.body.keys[usage / 8] & (1 << (usage % 8));
+}
 
-    boot_report.modifiers = keyboard_report.body.modifiers;
-    memset(&boot_report.keys, 0, HID_BOOT_KEY_LEN);
-    int ix = 0;
-    uint8_t base_code = 0;
-    for (int i = 0; i < sizeof(keyboard_report.body.keys); ++i) {
-        if (ix == keys_held) {
-            break;
-        }
-        if (!keyboard_report.body.keys[i]) {
-            continue;
-        }
-        base_code = i * 8;
-        for (int j = 0; j < 8; ++j) {
-            if (keyboard_report.body.keys[i] & BIT(j)) {
-                boot_report.keys[ix++] = base_code + j;
+#if IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT)
+
+static void place_boot_key(zmk_key_t usage) {
+    int slot = __builtin_ctz(STATE->free_boot_slots);
+    STATE->free_boot_slots &= ~BIT(slot);
+    STATE->boot_key_slots[usage] = slot + 1;
+    STATE->boot_report.keys[slot] = usage;
+    LOG_DBG("Boot report slot %d set to 0x%02X", slot, usage);
+}
+
+// Place a held key that didn't fit before, walking the bitmap a word at a time.
+static void place_waiting_boot_key(void) {
+    for (int i = 0; i < sizeof(STATE->keyboard_report.body.keys); i += 4) {
+        uint8_t bytes[4] = {0};
+        memcpy(bytes, &STATE->keyboard_report.body.keys[i],
+               MIN(4, sizeof(STATE->keyboard_report.body.keys) - i));
+
+        for (uint32_t word = sys_get_le32(bytes); word; word &= word - 1) {
+            zmk_key_t usage = i * 8 + __builtin_ctz(word);
+            if (!STATE->boot_key_slots[usage]) {
+                place_boot_key(usage);
+                return;
             }
         }
     }
-    return &boot_report;
 }
-#endif
+
+static void select_boot_key(zmk_key_t usage) {
+    ++STATE->keys_held;
+    if (STATE->free_boot_slots) {
+        place_boot_key(usage);
+    }
+}
+
+static void deselect_boot_key(zmk_key_t usage) {
+    --STATE->keys_held;
+    if (!STATE->boot_key_slots[usage]) {
+        return;
+    }
+
+    int slot = STATE->boot_key_slots[usage] - 1;
+    STATE->boot_key_slots[usage] = 0;
+    STATE->boot_report.keys[slot] = 0;
+    STATE->free_boot_slots |= BIT(slot);
+    LOG_DBG("Boot report slot %d cleared", slot);
+
+    if (STATE->keys_held >= HID_BOOT_KEY_LEN) {
+        place_waiting_boot_key();
+    }
+}
+
+static inline void clear_keyboard_usages(void) {
+    memset(STATE->boot_key_slots, 0, sizeof(STATE->boot_key_slots));
+    memset(STATE->boot_report.keys, 0, sizeof(STATE->boot_report.keys));
+    STATE->free_boot_slots = BIT_MASK(HID_BOOT_KEY_LEN);
+}
+
+zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
+    if (STATE->keys_held > HID_BOOT_KEY_LEN) {
+        return boot_report_rollover(STATE->keyboard_report.body.modifiers);
+    }
+
+    STATE->boot_report.modifiers = STATE->keyboard_report.body.modifiers;
+    return &STATE->boot_report;
+}
+
+#else
+
+static inline void select_boot_key(zmk_key_t usage) {}
+static inline void deselect_boot_key(zmk_key_t usage) {}
+static inline void clear_keyboard_usages(void) {}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT) */
 
 static inline int select_keyboard_usage(zmk_key_t usage) {
     if (usage > ZMK_HID_KEYBOARD_NKRO_MAX_USAGE) {
         return -EINVAL;
     }
+    if (check_keyboard_usage(usage)) {
+        return 0;
+    }
     TOGGLE_KEYBOARD(usage, 1);
-#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
-    ++keys_held;
-#endif
+    select_boot_key(usage);
     return 0;
 }
 
@@ -160,91 +298,94 @@ static inline int deselect_keyboard_usage(zmk_key_t usage) {
     if (usage > ZMK_HID_KEYBOARD_NKRO_MAX_USAGE) {
         return -EINVAL;
     }
+    if (!check_keyboard_usage(usage)) {
+        return 0;
+    }
     TOGGLE_KEYBOARD(usage, 0);
-#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
-    --keys_held;
-#endif
+    deselect_boot_key(usage);
     return 0;
 }
 
-static inline bool check_keyboard_usage(zmk_key_t usage) {
-    if (usage > ZMK_HID_KEYBOARD_NKRO_MAX_USAGE) {
-        return false;
-    }
-    return keyboard_report.body.keys[usage / 8] & (1 << (usage % 8));
-}
-
 #elif IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO)
 
-#define TOGGLE_KEYBOARD(match, val)                                                                \
-    for (int idx = 0; idx < CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE; idx++) {                          \
-        if (keyboard_report.body.keys[idx] != match) {                                             \
-            continue;                                                                              \
-        }                                                                                          \
-        keyboard_report.body.keys[idx] = val;                                                      \
-        if (val) {                                                                                 \
-            break;                                                                                 \
-        }                                                                                          \
-    }
+static inline void clear_keyboard_usages(void) {
+    memset(STATE->keyboard_usages, 0, sizeof(STATE->keyboard_usages));
+    STATE->free_keyboard_slots = KEYBOARD_SLOTS_MASK;
+}
 
-#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+#if IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT)
 zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
-    if (keys_held > HID_BOOT_KEY_LEN) {
-        return boot_report_rollover(keyboard_report.body.modifiers);
+    if (STATE->keys_held > HID_BOOT_KEY_LEN) {
+        return boot_report_rollover(STATE->keyboard_report.body.modifiers);
     }
 
 #if CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE != HID_BOOT_KEY_LEN
     // Form a boot report from a report of different size.
 
-    boot_report.modifiers = keyboard_report.body.modifiers;
+    STATE->boot_report.modifiers = STATE->keyboard_report.body.modifiers;
 
     int out = 0;
-    for (int i = 0; i < CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE; i++) {
-        uint8_t key = keyboard_report.body.keys[i];
-        if (key) {
-            boot_report.keys[out++] = key;
-            if (out == keys_held) {
-                break;
-            }
-        }
+    for (uint32_t used = ~STATE->free_keyboard_slots & KEYBOARD_SLOTS_MASK; used;
+         used &= used - 1) {
+        STATE->boot_report.keys[out++] = STATE->keyboard_report.body.keys[__builtin_ctz(used)];
     }
 
     while (out < HID_BOOT_KEY_LEN) {
-        boot_report.keys[out++] = 0;
+        STATE->boot_report.keys[out++] = 0;
     }
 
-    return &boot_report;
+    return &STATE->boot_report;
 #else
-    return &keyboard_report.body;
+    return &STATE->keyboard_report.body;
 #endif /* CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE != HID_BOOT_KEY_LEN */
 }
-#endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
+#endif /* IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT) */
+
+static inline bool check_keyboard_usage(zmk_key_t usage) {
+    if (usage > ZMK_HID_KEYBOARD_MAX_USAGE) {
+        return false;
+    }
+    return STATE->keyboard_usages[usage / 32] & BIT(usage % 32);
+}
 
 static inline int select_keyboard_usage(zmk_key_t usage) {
-    TOGGLE_KEYBOARD(0U, usage);
-#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
-    ++keys_held;
+    if (usage == 0 || usage > ZMK_HID_KEYBOARD_MAX_USAGE) {
+        return -EINVAL;
+    }
+    if (check_keyboard_usage(usage)) {
+        return 0;
+    }
+    if (!STATE->free_keyboard_slots) {
+        LOG_DBG("No room in the keyboard report for usage 0x%02X", usage);
+        return -ENOMEM;
+    }
+
+    int slot = __builtin_ctz(STATE->free_keyboard_slots);
+    STATE->free_keyboard_slots &= ~BIT(slot);
+    STATE->keyboard_usages[usage / 32] |= BIT(usage % 32);
+    STATE->keyboard_usage_slots[usage] = slot;
+    STATE->keyboard_report.body.keys[slot] = usage;
+#if IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT)
+    ++STATE->keys_held;
 #endif
     return 0;
 }
 
 static inline int deselect_keyboard_usage(zmk_key_t usage) {
-    TOGGLE_KEYBOARD(usage, 0U);
-#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
-    --keys_held;
+    if (!check_keyboard_usage(usage)) {
+        return 0;
+    }
+
+    int slot = STATE->keyboard_usage_slots[usage];
+    STATE->keyboard_report.body.keys[slot] = 0;
+    STATE->free_keyboard_slots |= BIT(slot);
+    STATE->keyboard_usages[usage / 32] &= ~BIT(usage % 32);
+#if IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT)
+    --STATE->keys_held;
 #endif
     return 0;
 }
 
-static inline int check_keyboard_usage(zmk_key_t usage) {
-    for (int idx = 0; idx < CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE; idx++) {
-        if (keyboard_report.body.keys[idx] == usage) {
-            return true;
-        }
-    }
-    return false;
-}
-
 #else
 #error "A proper HID report type must be selected"
 #endif
@@ -254,41 +395,93 @@ static inline int check_keyboard_usage(zmk_key_t usage) {
         return -ENOTSUP;                                                                           \
     }                                                                                              \
     for (int idx = 0; idx < CONFIG_ZMK_HID_CONSUMER_REPORT_SIZE; idx++) {                          \
-        if (consumer_report.body.keys[idx] != match) {                                             \
+        if (STATE->consumer_report.body.keys[idx] != match) {                                      \
             continue;                                                                              \
         }                                                                                          \
-        consumer_report.body.keys[idx] = val;                                                      \
+        STATE->consumer_report.body.keys[idx] = val;                                               \
         if (val) {                                                                                 \
             break;                                                                                 \
         }                                                                                          \
     }
 
-int zmk_hid_implicit_modifiers_press(zmk_mod_flags_t new_implicit_modifiers) {
-    implicit_modifiers = new_implicit_modifiers;
-    zmk_mod_flags_t current = GET_MODIFIERS;
-    SET_MODIFIERS(explicit_modifiers);
-    return current == GET_MODIFIERS ? 0 : 1;
+// Drops what @p usage owns from the counts, returning its entry to reuse or NULL if it owns none.
+static struct implicit_modifier_owner *release_implicit_modifier_owner(uint32_t usage) {
+    for (int i = 0; i < IMPLICIT_MODIFIER_OWNERS_LEN; i++) {
+        struct implicit_modifier_owner *owner = &STATE->implicit_modifier_owners[i];
+        if (!owner->modifiers || owner->usage != usage) {
+            continue;
+        }
+
+        for (zmk_mod_flags_t mods = owner->modifiers; mods; mods &= mods - 1) {
+            int modifier = __builtin_ctz(mods);
+            if (--STATE->implicit_modifier_counts[modifier] == 0) {
+                WRITE_BIT(STATE->held_implicit_modifiers, modifier, false);
+            }
+        }
+        owner->modifiers = 0;
+        return owner;
+    }
+
+    return NULL;
+}
+
+int zmk_hid_implicit_modifiers_press(uint32_t usage, zmk_mod_flags_t new_implicit_modifiers) {
+    // a usage pressed again without a release in between owns only its latest modifiers
+    struct implicit_modifier_owner *owner = release_implicit_modifier_owner(usage);
+
+    STATE->implicit_modifiers = new_implicit_modifiers;
+    if (!new_implicit_modifiers) {
+        return update_modifiers();
+    }
+
+    for (int i = 0; owner == NULL && i < IMPLICIT_MODIFIER_OWNERS_LEN; i++) {
+        if (!STATE->implicit_modifier_owners[i].modifiers) {
+            owner = &STATE->implicit_modifier_owners[i];
+        }
+    }
+
+    if (owner) {
+        owner->usage = usage;
+        owner->modifiers = new_implicit_modifiers;
+        for (zmk_mod_flags_t mods = new_implicit_modifiers; mods; mods &= mods - 1) {
+            STATE->implicit_modifier_counts[__builtin_ctz(mods)]++;
+        }
+        STATE->held_implicit_modifiers |= new_implicit_modifiers;
+    } else {
+        // Still applied, but dropped by the next release of a key with implicit modifiers.
+        LOG_WRN("No room to track implicit modifiers 0x%02X of usage 0x%08X",
+                new_implicit_modifiers, usage);
+    }
+
+    return update_modifiers();
 }
 
-int zmk_hid_implicit_modifiers_release(void) {
-    implicit_modifiers = 0;
-    zmk_mod_flags_t current = GET_MODIFIERS;
-    SET_MODIFIERS(explicit_modifiers);
-    return current == GET_MODIFIERS ? 0 : 1;
+int zmk_hid_implicit_modifiers_release(uint32_t usage) {
+    release_implicit_modifier_owner(usage);
+    STATE->implicit_modifiers &= STATE->held_implicit_modifiers;
+    return update_modifiers();
 }
 
 int zmk_hid_masked_modifiers_set(zmk_mod_flags_t new_masked_modifiers) {
-    masked_modifiers = new_masked_modifiers;
-    zmk_mod_flags_t current = GET_MODIFIERS;
-    SET_MODIFIERS(explicit_modifiers);
-    return current == GET_MODIFIERS ? 0 : 1;
+    STATE->masked_modifiers = new_masked_modifiers;
+    return update_modifiers();
 }
 
 int zmk_hid_masked_modifiers_clear(void) {
-    masked_modifiers = 0;
-    zmk_mod_flags_t current = GET_MODIFIERS;
-    SET_MODIFIERS(explicit_modifiers);
-    return current == GET_MODIFIERS ? 0 : 1;
+    STATE->masked_modifiers = 0;
+    return update_modifiers();
+}
+
+int zmk_hid_override_modifiers_set(zmk_mod_flags_t modifiers, zmk_mod_flags_t masked_modifiers) {
+    STATE->override_modifiers = modifiers;
+    STATE->override_masked_modifiers = masked_modifiers;
+    return update_modifiers();
+}
+
+int zmk_hid_override_modifiers_clear(void) {
+    STATE->override_modifiers = 0;
+    STATE->override_masked_modifiers = 0;
+    return update_modifiers();
 }
 
 int zmk_hid_keyboard_press(zmk_key_t code) {
@@ -315,7 +508,11 @@ bool zmk_hid_keyboard_is_pressed(zmk_key_t code) {
 }
 
 void zmk_hid_keyboard_clear(void) {
-    memset(&keyboard_report.body, 0, sizeof(keyboard_report.body));
+    memset(&STATE->keyboard_report.body, 0, sizeof(STATE->keyboard_report.body));
+    clear_keyboard_usages();
+#if IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT)
+    STATE->keys_held = 0;
+#endif
 }
 
 int zmk_hid_consumer_press(zmk_key_t code) {
@@ -329,12 +526,12 @@ int zmk_hid_consumer_release(zmk_key_t code) {
 };
 
 void zmk_hid_consumer_clear(void) {
-    memset(&consumer_report.body, 0, sizeof(consumer_report.body));
+    memset(&STATE->consumer_report.body, 0, sizeof(STATE->consumer_report.body));
 }
 
 bool zmk_hid_consumer_is_pressed(zmk_key_t key) {
     for (int idx = 0; idx < CONFIG_ZMK_HID_CONSUMER_REPORT_SIZE; idx++) {
-        if (consumer_report.body.keys[idx] == key) {
+        if (STATE->consumer_report.body.keys[idx] == key) {
             return true;
         }
     }
@@ -373,15 +570,10 @@ bool zmk_hid_is_pressed(uint32_t usage) {
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 
-// Keep track of how often a button was pressed.
-// Only release the button if the count is 0.
-static int explicit_button_counts[5] = {0, 0, 0, 0, 0};
-static zmk_mod_flags_t explicit_buttons = 0;
-
 #define SET_MOUSE_BUTTONS(btns)                                                                    \
     {                                                                                              \
-        mouse_report.body.buttons = btns;                                                          \
-        LOG_DBG("Mouse buttons set to 0x%02X", mouse_report.body.buttons);                         \
+        STATE->mouse_report.body.buttons = btns;                                                   \
+        LOG_DBG("Mouse buttons set to 0x%02X", STATE->mouse_report.body.buttons);                  \
     }
 
 int zmk_hid_mouse_button_press(zmk_mouse_button_t button) {
@@ -389,10 +581,10 @@ int zmk_hid_mouse_button_press(zmk_mouse_button_t button) {
         return -EINVAL;
     }
 
-    explicit_button_counts[button]++;
-    LOG_DBG("Button %d count %d", button, explicit_button_counts[button]);
-    WRITE_BIT(explicit_buttons, button, true);
-    SET_MOUSE_BUTTONS(explicit_buttons);
+    STATE->explicit_button_counts[button]++;
+    LOG_DBG("Button %d count %d", button, STATE->explicit_button_counts[button]);
+    WRITE_BIT(STATE->explicit_buttons, button, true);
+    SET_MOUSE_BUTTONS(STATE->explicit_buttons);
     return 0;
 }
 
@@ -401,17 +593,17 @@ int zmk_hid_mouse_button_release(zmk_mouse_button_t button) {
         return -EINVAL;
     }
 
-    if (explicit_button_counts[button] <= 0) {
+    if (STATE->explicit_button_counts[button] <= 0) {
         LOG_ERR("Tried to release button %d too often", button);
         return -EINVAL;
     }
-    explicit_button_counts[button]--;
-    LOG_DBG("Button %d count: %d", button, explicit_button_counts[button]);
-    if (explicit_button_counts[button] == 0) {
+    STATE->explicit_button_counts[button]--;
+    LOG_DBG("Button %d count: %d", button, STATE->explicit_button_counts[button]);
+    if (STATE->explicit_button_counts[button] == 0) {
         LOG_DBG("Button %d released", button);
-        WRITE_BIT(explicit_buttons, button, false);
+        WRITE_BIT(STATE->explicit_buttons, button, false);
     }
-    SET_MOUSE_BUTTONS(explicit_buttons);
+    SET_MOUSE_BUTTONS(STATE->explicit_buttons);
     return 0;
 }
 
@@ -434,46 +626,52 @@ int zmk_hid_mouse_buttons_release(zmk_mouse_button_flags_t buttons) {
 }
 
 void zmk_hid_mouse_movement_set(int16_t hwheel, int16_t wheel) {
-    mouse_report.body.d_x = hwheel;
-    mouse_report.body.d_y = wheel;
-    LOG_DBG("Mouse movement set to %d/%d", mouse_report.body.d_x, mouse_report.body.d_y);
+    STATE->mouse_report.body.d_x = hwheel;
+    STATE->mouse_report.body.d_y = wheel;
+    LOG_DBG("Mouse movement set to %d/%d", STATE->mouse_report.body.d_x,
+            STATE->mouse_report.body.d_y);
 }
 
 void zmk_hid_mouse_movement_update(int16_t hwheel, int16_t wheel) {
-    mouse_report.body.d_x += hwheel;
-    mouse_report.body.d_y += wheel;
-    LOG_DBG("Mouse movement updated to %d/%d", mouse_report.body.d_x, mouse_report.body.d_y);
+    STATE->mouse_report.body.d_x += hwheel;
+    STATE->mouse_report.body.d_y += wheel;
+    LOG_DBG("Mouse movement updated to %d/%d", STATE->mouse_report.body.d_x,
+            STATE->mouse_report.body.d_y);
 }
 
 void zmk_hid_mouse_scroll_set(int16_t hwheel, int16_t wheel) {
-    mouse_report.body.d_scroll_x = hwheel;
-    mouse_report.body.d_scroll_y = wheel;
+    STATE->mouse_report.body.d_scroll_x = hwheel;
+    STATE->mouse_report.body.d_scroll_y = wheel;
 
-    LOG_DBG("Mouse scroll set to %d/%d", mouse_report.body.d_scroll_x,
-            mouse_report.body.d_scroll_y);
+    LOG_DBG("Mouse scroll set to %d/%d", STATE->mouse_report.body.d_scroll_x,
+            STATE->mouse_report.body.d_scroll_y);
 }
 
 void zmk_hid_mouse_scroll_update(int16_t hwheel, int16_t wheel) {
-    mouse_report.body.d_scroll_x += hwheel;
-    mouse_report.body.d_scroll_y += wheel;
+    STATE->mouse_report.body.d_scroll_x += hwheel;
+    STATE->mouse_report.body.d_scroll_y += wheel;
 
-    LOG_DBG("Mouse scroll updated to X: %d/%d", mouse_report.body.d_scroll_x,
-            mouse_report.body.d_scroll_y);
+    LOG_DBG("Mouse scroll updated to X: %d/%d", STATE->mouse_report.body.d_scroll_x,
+            STATE->mouse_report.body.d_scroll_y);
 }
 
 void zmk_hid_mouse_clear(void) {
     LOG_DBG("Mouse report cleared");
-    memset(&mouse_report.body, 0, sizeof(mouse_report.body));
+    memset(&STATE->mouse_report.body, 0, sizeof(STATE->mouse_report.body));
 }
 
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
-struct zmk_hid_keyboard_report *zmk_hid_get_keyboard_report(void) { return &keyboard_report; }
+struct zmk_hid_keyboard_report *zmk_hid_get_keyboard_report(void) {
+    return &STATE->keyboard_report;
+}
 
-struct zmk_hid_consumer_report *zmk_hid_get_consumer_report(void) { return &consumer_report; }
+struct zmk_hid_consumer_report *zmk_hid_get_consumer_report(void) {
+    return &STATE->consumer_report;
+}
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 
-struct zmk_hid_mouse_report *zmk_hid_get_mouse_report(void) { return &mouse_report; }
+struct zmk_hid_mouse_report *zmk_hid_get_mouse_report(void) { return &STATE->mouse_report; }
 
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
@@ -5,19 +5,242 @@
  */
 
 #include <drivers/behavior.h>
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+#include <zmk/context.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/keycode_state_changed.h>
 #include <zmk/events/modifiers_state_changed.h>
 #include <zmk/hid.h>
+#include <zmk/hid_transaction.h>
 #include <dt-bindings/zmk/hid_usage_pages.h>
 #include <zmk/endpoints.h>
+#include <zmk/stage_timing.h>
+#include <zmk/work_stats.h>
+#include <zmk/workqueue.h>
+
+#if IS_ENABLED(CONFIG_ZMK_HID_COALESCE_REPORTS)
+
+#define DIRTY_KEYBOARD BIT(0)
+#define DIRTY_CONSUMER BIT(1)
+
+struct coalesce_state {
+    uint8_t dirty_reports;
+    // usages changed since the last flush; a second change to one of them forces a flush first
+    uint32_t pending_usages[CONFIG_ZMK_HID_COALESCE_MAX_PENDING];
+    uint8_t pending_usages_count;
+};
+
+ZMK_CONTEXT_STATE_DEFINE(coalesce_states, struct coalesce_state, {});
+
+#define STATE ZMK_CONTEXT_STATE(coalesce_states)
+
+// Usages change from whichever thread raised the keycode event, while the flush work runs on the
+// input work queue. The lock is only held over the state, never while a report is sent.
+static struct k_spinlock coalesce_lock;
+
+static uint8_t dirty_bit(uint16_t usage_page) {
+    switch (usage_page) {
+    case HID_USAGE_KEY:
+        return DIRTY_KEYBOARD;
+    case HID_USAGE_CONSUMER:
+        return DIRTY_CONSUMER;
+    default:
+        return 0;
+    }
+}
+
+static int flush_reports(void) {
+    int err = 0;
+
+    k_spinlock_key_t key = k_spin_lock(&coalesce_lock);
+    uint8_t dirty = STATE->dirty_reports;
+    STATE->dirty_reports = 0;
+    STATE->pending_usages_count = 0;
+    k_spin_unlock(&coalesce_lock, key);
+
+    // keyboard first, so modifiers for a consumer usage reach the host before it
+    if (dirty & DIRTY_KEYBOARD) {
+        err = zmk_endpoint_send_report(HID_USAGE_KEY);
+    }
+    if (dirty & DIRTY_CONSUMER) {
+        int ret = zmk_endpoint_send_report(HID_USAGE_CONSUMER);
+        err = err < 0 ? err : ret;
+    }
+    return err;
+}
+
+ZMK_WORK_STATS_DEFINE(hid_flush, 0);
+
+static void flush_reports_work_cb(struct k_work *work) {
+    uint32_t start = zmk_work_stats_run_start(ZMK_WORK_STATS(hid_flush));
+    uint8_t context = zmk_context_index();
+
+    // The reports of every keyboard changed since the work was submitted
+    for (uint8_t i = 0; i < ZMK_CONTEXT_COUNT; i++) {
+        if (coalesce_states[i].dirty_reports == 0) {
+            continue;
+        }
+
+        zmk_context_select(i);
+        int err = flush_reports();
+        if (err < 0) {
+            LOG_ERR("Failed to send coalesced key reports (%d)", err);
+        }
+    }
+    zmk_context_select(context);
+
+    zmk_work_stats_run_end(ZMK_WORK_STATS(hid_flush), start);
+}
+
+static K_WORK_DEFINE(flush_reports_work, flush_reports_work_cb);
+
+static void prepare_usage_change(uint32_t usage) {
+    k_spinlock_key_t key = k_spin_lock(&coalesce_lock);
+    bool flush = STATE->pending_usages_count == ARRAY_SIZE(STATE->pending_usages);
+    for (int i = 0; i < STATE->pending_usages_count; i++) {
+        if (STATE->pending_usages[i] == usage) {
+            flush = true;
+            break;
+        }
+    }
+    k_spin_unlock(&coalesce_lock, key);
+
+    if (flush) {
+        flush_reports();
+    }
+
+    key = k_spin_lock(&coalesce_lock);
+    // Another thread may have filled the list again while the reports were sent
+    if (STATE->pending_usages_count < ARRAY_SIZE(STATE->pending_usages)) {
+        STATE->pending_usages[STATE->pending_usages_count++] = usage;
+    }
+    k_spin_unlock(&coalesce_lock, key);
+}
+
+static int send_report(uint16_t usage_page) {
+    uint8_t bit = dirty_bit(usage_page);
+    if (!bit) {
+        return zmk_endpoint_send_report(usage_page);
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&coalesce_lock);
+    STATE->dirty_reports |= bit;
+    k_spin_unlock(&coalesce_lock, key);
+
+    zmk_work_stats_submit(ZMK_WORK_STATS(hid_flush), 0);
+    // The flush selects each context in turn, which only the input work queue may do
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &flush_reports_work);
+    return 0;
+}
+
+// For reports the host must see before any later change, e.g. a release before a re-press.
+static int send_report_now(uint16_t usage_page) {
+    k_spinlock_key_t key = k_spin_lock(&coalesce_lock);
+    STATE->dirty_reports &= ~dirty_bit(usage_page);
+    k_spin_unlock(&coalesce_lock, key);
+
+    return zmk_endpoint_send_report(usage_page);
+}
+
+#else
+
+static inline void prepare_usage_change(uint32_t usage) {}
+
+static inline int send_report(uint16_t usage_page) { return zmk_endpoint_send_report(usage_page); }
+
+static inline int send_report_now(uint16_t usage_page) {
+    return zmk_endpoint_send_report(usage_page);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_COALESCE_REPORTS)
+
+#define TXN_KEYBOARD BIT(0)
+#define TXN_CONSUMER BIT(1)
+
+static atomic_t saved_report_count;
+
+static uint8_t txn_bit(uint16_t usage_page) {
+    switch (usage_page) {
+    case HID_USAGE_KEY:
+        return TXN_KEYBOARD;
+    case HID_USAGE_CONSUMER:
+        return TXN_CONSUMER;
+    default:
+        return 0;
+    }
+}
+
+void zmk_hid_transaction_begin(struct zmk_hid_transaction *txn) {
+    *txn = (struct zmk_hid_transaction){0};
+}
+
+void zmk_hid_transaction_mark(struct zmk_hid_transaction *txn, uint16_t usage_page) {
+    txn->changed |= txn_bit(usage_page);
+}
+
+int zmk_hid_transaction_send(struct zmk_hid_transaction *txn, uint16_t usage_page) {
+    uint8_t bit = txn_bit(usage_page);
+
+    if (!(txn->changed & bit)) {
+        return 0;
+    }
+
+    txn->changed &= ~bit;
+    txn->sent |= bit;
+    return send_report_now(usage_page);
+}
+
+int zmk_hid_transaction_commit(struct zmk_hid_transaction *txn) {
+    int err = 0;
+
+    // Sending a report again that was already sent and hasn't changed since is what a report per
+    // change would have cost.
+    uint8_t saved = txn->sent & ~txn->changed;
+    if (saved) {
+        atomic_add(&saved_report_count, __builtin_popcount(saved));
+    }
+
+    // keyboard first, so modifiers for a consumer usage reach the host before it
+    if (txn->changed & TXN_KEYBOARD) {
+        err = send_report(HID_USAGE_KEY);
+    }
+    if (txn->changed & TXN_CONSUMER) {
+        int ret = send_report(HID_USAGE_CONSUMER);
+        err = err < 0 ? err : ret;
+    }
+
+    txn->sent |= txn->changed;
+    txn->changed = 0;
+    return err;
+}
+
+uint32_t zmk_hid_transaction_get_saved_report_count(void) {
+    return (uint32_t)atomic_get(&saved_report_count);
+}
+
+// Modifiers can be held by several keys at once, so only the ones whose explicit state actually
+// flipped are reported
+static void raise_explicit_mods_changed(zmk_mod_flags_t before, bool state) {
+    zmk_mod_flags_t changed = before ^ zmk_hid_get_explicit_mods();
+
+    if (changed) {
+        raise_zmk_modifiers_state_changed(
+            (struct zmk_modifiers_state_changed){.modifiers = changed, .state = state});
+    }
+}
 
 static int hid_listener_keycode_pressed(const struct zmk_keycode_state_changed *ev) {
     int err, explicit_mods_changed, implicit_mods_changed;
+    zmk_mod_flags_t explicit_mods = zmk_hid_get_explicit_mods();
+    struct zmk_hid_transaction txn;
+
+    zmk_hid_transaction_begin(&txn);
+    prepare_usage_change(ZMK_HID_USAGE(ev->usage_page, ev->keycode));
 
     if (!is_mod(ev->usage_page, ev->keycode) &&
         zmk_hid_is_pressed(ZMK_HID_USAGE(ev->usage_page, ev->keycode))) {
@@ -28,7 +251,8 @@ static int hid_listener_keycode_pressed(const struct zmk_keycode_state_changed *
             LOG_DBG("Unable to pre-release keycode (%d)", err);
             return err;
         }
-        err = zmk_endpoint_send_report(ev->usage_page);
+        zmk_hid_transaction_mark(&txn, ev->usage_page);
+        err = zmk_hid_transaction_send(&txn, ev->usage_page);
         if (err < 0) {
             LOG_ERR("Failed to send key report for pre-releasing keycode (%d)", err);
         }
@@ -41,36 +265,40 @@ static int hid_listener_keycode_pressed(const struct zmk_keycode_state_changed *
         LOG_DBG("Unable to press keycode");
         return err;
     }
+    zmk_hid_transaction_mark(&txn, ev->usage_page);
     explicit_mods_changed = zmk_hid_register_mods(ev->explicit_modifiers);
-    implicit_mods_changed = zmk_hid_implicit_modifiers_press(ev->implicit_modifiers);
-    if (ev->usage_page != HID_USAGE_KEY &&
-        (explicit_mods_changed > 0 || implicit_mods_changed > 0)) {
-        err = zmk_endpoint_send_report(HID_USAGE_KEY);
-        if (err < 0) {
-            LOG_ERR("Failed to send key report for changed mofifiers for consumer page event (%d)",
-                    err);
-        }
+    raise_explicit_mods_changed(explicit_mods, true);
+    implicit_mods_changed = zmk_hid_implicit_modifiers_press(
+        ZMK_HID_USAGE(ev->usage_page, ev->keycode), ev->implicit_modifiers);
+    if (explicit_mods_changed > 0 || implicit_mods_changed > 0) {
+        zmk_hid_transaction_mark(&txn, HID_USAGE_KEY);
     }
 
-    return zmk_endpoint_send_report(ev->usage_page);
+    return zmk_hid_transaction_commit(&txn);
 }
 
 static int hid_listener_keycode_released(const struct zmk_keycode_state_changed *ev) {
     int err, explicit_mods_changed, implicit_mods_changed;
+    zmk_mod_flags_t explicit_mods = zmk_hid_get_explicit_mods();
+    struct zmk_hid_transaction txn;
+
+    zmk_hid_transaction_begin(&txn);
 
     LOG_DBG("usage_page 0x%02X keycode 0x%02X implicit_mods 0x%02X explicit_mods 0x%02X",
             ev->usage_page, ev->keycode, ev->implicit_modifiers, ev->explicit_modifiers);
+    prepare_usage_change(ZMK_HID_USAGE(ev->usage_page, ev->keycode));
     err = zmk_hid_release(ZMK_HID_USAGE(ev->usage_page, ev->keycode));
     if (err < 0) {
         LOG_DBG("Unable to release keycode");
         return err;
     }
+    zmk_hid_transaction_mark(&txn, ev->usage_page);
 
 #if IS_ENABLED(CONFIG_ZMK_HID_SEPARATE_MOD_RELEASE_REPORT)
 
     // send report of normal key release early to fix the issue
     // of some programs recognizing the implicit_mod release before the actual key release
-    err = zmk_endpoint_send_report(ev->usage_page);
+    err = zmk_hid_transaction_send(&txn, ev->usage_page);
     if (err < 0) {
         LOG_ERR("Failed to send key report for the released keycode (%d)", err);
     }
@@ -78,32 +306,30 @@ static int hid_listener_keycode_released(const struct zmk_keycode_state_changed
 #endif // IS_ENABLED(CONFIG_ZMK_HID_SEPARATE_MOD_RELEASE_REPORT)
 
     explicit_mods_changed = zmk_hid_unregister_mods(ev->explicit_modifiers);
-    // There is a minor issue with this code.
-    // If LC(A) is pressed, then LS(B), then LC(A) is released, the shift for B will be released
-    // prematurely. This causes if LS(B) to repeat like Bbbbbbbb when pressed for a long time.
-    // Solving this would require keeping track of which key's implicit modifiers are currently
-    // active and only releasing modifiers at that time.
-    implicit_mods_changed = zmk_hid_implicit_modifiers_release();
-
-    if (ev->usage_page != HID_USAGE_KEY &&
-        (explicit_mods_changed > 0 || implicit_mods_changed > 0)) {
-        err = zmk_endpoint_send_report(HID_USAGE_KEY);
-        if (err < 0) {
-            LOG_ERR("Failed to send key report for changed mofifiers for consumer page event (%d)",
-                    err);
-        }
+    raise_explicit_mods_changed(explicit_mods, false);
+    // Only the implicit modifiers this usage was pressed with are released, so if LC(A) is pressed,
+    // then LS(B), then LC(A) is released, the shift for B is kept.
+    implicit_mods_changed =
+        zmk_hid_implicit_modifiers_release(ZMK_HID_USAGE(ev->usage_page, ev->keycode));
+    if (explicit_mods_changed > 0 || implicit_mods_changed > 0) {
+        zmk_hid_transaction_mark(&txn, HID_USAGE_KEY);
     }
-    return zmk_endpoint_send_report(ev->usage_page);
+
+    return zmk_hid_transaction_commit(&txn);
 }
 
 int hid_listener(const zmk_event_t *eh) {
     const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
     if (ev) {
+        uint32_t start = zmk_stage_timing_start();
+
         if (ev->state) {
             hid_listener_keycode_pressed(ev);
         } else {
             hid_listener_keycode_released(ev);
         }
+
+        zmk_stage_timing_end(ZMK_STAGE_KEYCODE, start);
     }
     return 0;
 }
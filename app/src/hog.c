@@ -6,6 +6,7 @@
 
 #include <zephyr/settings/settings.h>
 #include <zephyr/init.h>
+#include <zephyr/sys/atomic.h>
 
 #include <zephyr/logging/log.h>
 
@@ -18,6 +19,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/endpoints_types.h>
 #include <zmk/hog.h>
 #include <zmk/hid.h>
+#include <zmk/work_stats.h>
 #if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 #include <zmk/pointing/resolution_multipliers.h>
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
@@ -304,105 +306,479 @@ K_THREAD_STACK_DEFINE(hog_q_stack, CONFIG_ZMK_BLE_THREAD_STACK_SIZE);
 
 struct k_work_q hog_work_q;
 
-K_MSGQ_DEFINE(zmk_hog_keyboard_msgq, sizeof(struct zmk_hid_keyboard_report_body),
-              CONFIG_ZMK_BLE_KEYBOARD_REPORT_QUEUE_SIZE, 4);
+// Keyboard and consumer reports wait in a queue while a notification is in flight, and the
+// notify completion callback sends the next one. Instead of blocking or dropping reports when
+// the host falls behind, a new report replaces the last queued one if that doesn't lose a press
+// or release in between. Once the queue is full, it replaces it regardless, so the latest state
+// always reaches the host and no key stays stuck.
+struct hog_report_queue {
+    struct k_spinlock lock;
+    uint8_t *reports;
+    // the report most recently handed to the stack, which the host has or will have
+    uint8_t *last_sent;
+    size_t report_size;
+    uint8_t capacity;
+    uint8_t head;
+    uint8_t len;
+    bool in_flight;
+    bool (*can_merge)(const uint8_t *prev, const uint8_t *queued, const uint8_t *next);
+};
 
-void send_keyboard_report_callback(struct k_work *work) {
+static uint8_t *hog_report_queue_slot(struct hog_report_queue *queue, uint8_t idx) {
+    return queue->reports + ((queue->head + idx) % queue->capacity) * queue->report_size;
+}
+
+// Returns the number of reports queued afterwards.
+static uint8_t hog_report_queue_put(struct hog_report_queue *queue, const void *report) {
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+    if (queue->len > 0) {
+        uint8_t *queued = hog_report_queue_slot(queue, queue->len - 1);
+        const uint8_t *prev =
+            queue->len > 1 ? hog_report_queue_slot(queue, queue->len - 2) : queue->last_sent;
+        bool full = queue->len == queue->capacity;
+
+        if (full || queue->can_merge(prev, queued, report)) {
+            if (full) {
+                LOG_WRN("HOG report queue full, merging into the last queued report");
+            }
+            memcpy(queued, report, queue->report_size);
+            uint8_t len = queue->len;
+
+            k_spin_unlock(&queue->lock, key);
+            return len;
+        }
+    }
+
+    memcpy(hog_report_queue_slot(queue, queue->len), report, queue->report_size);
+    uint8_t len = ++queue->len;
+
+    k_spin_unlock(&queue->lock, key);
+    return len;
+}
+
+// Take the next report to notify, unless one is still in flight.
+static bool hog_report_queue_get(struct hog_report_queue *queue, void *report) {
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+    bool got = !queue->in_flight && queue->len > 0;
+    if (got) {
+        memcpy(report, hog_report_queue_slot(queue, 0), queue->report_size);
+        memcpy(queue->last_sent, report, queue->report_size);
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->len--;
+        queue->in_flight = true;
+    }
+
+    k_spin_unlock(&queue->lock, key);
+    return got;
+}
+
+static void hog_report_queue_sent(struct hog_report_queue *queue) {
+    k_spinlock_key_t key = k_spin_lock(&queue->lock);
+    queue->in_flight = false;
+    k_spin_unlock(&queue->lock, key);
+}
+
+// Whether dropping @p queued between @p prev and @p next loses a press or a release of any of
+// the usages in the bits.
+static bool usage_bits_lost(uint8_t prev, uint8_t queued, uint8_t next) {
+    return (queued & ~prev & ~next) || (prev & ~queued & next);
+}
+
+#define USAGE_ARRAY_CONTAINS(array, usage)                                                         \
+    ({                                                                                             \
+        bool found = false;                                                                        \
+        for (int _i = 0; _i < ARRAY_SIZE(array); _i++) {                                           \
+            found |= (array)[_i] == (usage);                                                       \
+        }                                                                                          \
+        found;                                                                                     \
+    })
+
+// The same check for arrays of usages: a usage pressed in @p queued must stay pressed in
+// @p next, and one released in @p queued must stay released.
+#define USAGE_ARRAYS_LOST(prev, queued, next)                                                      \
+    ({                                                                                             \
+        bool lost = false;                                                                         \
+        for (int _j = 0; _j < ARRAY_SIZE(queued) && !lost; _j++) {                                 \
+            lost = (queued)[_j] && !USAGE_ARRAY_CONTAINS(prev, (queued)[_j]) &&                    \
+                   !USAGE_ARRAY_CONTAINS(next, (queued)[_j]);                                      \
+        }                                                                                          \
+        for (int _j = 0; _j < ARRAY_SIZE(prev) && !lost; _j++) {                                   \
+            lost = (prev)[_j] && !USAGE_ARRAY_CONTAINS(queued, (prev)[_j]) &&                      \
+                   USAGE_ARRAY_CONTAINS(next, (prev)[_j]);                                         \
+        }                                                                                          \
+        lost;                                                                                      \
+    })
+
+static bool keyboard_reports_can_merge(const uint8_t *prev_data, const uint8_t *queued_data,
+                                       const uint8_t *next_data) {
+    const struct zmk_hid_keyboard_report_body *prev = (const void *)prev_data;
+    const struct zmk_hid_keyboard_report_body *queued = (const void *)queued_data;
+    const struct zmk_hid_keyboard_report_body *next = (const void *)next_data;
+
+    if (usage_bits_lost(prev->modifiers, queued->modifiers, next->modifiers)) {
+        return false;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_NKRO)
+    for (int i = 0; i < ARRAY_SIZE(queued->keys); i++) {
+        if (usage_bits_lost(prev->keys[i], queued->keys[i], next->keys[i])) {
+            return false;
+        }
+    }
+
+    return true;
+#else
+    return !USAGE_ARRAYS_LOST(prev->keys, queued->keys, next->keys);
+#endif
+}
+
+static bool consumer_reports_can_merge(const uint8_t *prev_data, const uint8_t *queued_data,
+                                       const uint8_t *next_data) {
+    const struct zmk_hid_consumer_report_body *prev = (const void *)prev_data;
+    const struct zmk_hid_consumer_report_body *queued = (const void *)queued_data;
+    const struct zmk_hid_consumer_report_body *next = (const void *)next_data;
+
+    return !USAGE_ARRAYS_LOST(prev->keys, queued->keys, next->keys);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_BLE_MIRROR)
+
+BUILD_ASSERT(ZMK_BLE_PROFILE_COUNT <= 32, "Mirrored profiles are kept in a 32 bit mask");
+
+#define HOG_CONN_COUNT ZMK_BLE_PROFILE_COUNT
+
+static atomic_t mirror_profiles = ATOMIC_INIT(CONFIG_ZMK_BLE_MIRROR_PROFILES);
+
+int zmk_hog_set_mirror_profiles(uint32_t profiles) {
+    atomic_set(&mirror_profiles, (atomic_val_t)profiles);
+    return 0;
+}
+
+uint32_t zmk_hog_get_mirror_profiles(void) { return (uint32_t)atomic_get(&mirror_profiles); }
+
+#else
+
+#define HOG_CONN_COUNT 1
+
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_MIRROR)
+
+// The reports on their way to one host. Each host has its own queues and notification credits, so
+// one that falls behind doesn't hold reports back from the others.
+struct hog_conn {
+    struct hog_report_queue keyboard;
+    struct hog_report_queue consumer;
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+    struct k_msgq mouse;
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+    // Notifications are only handed to the stack while they fit in the upcoming connection events.
+    // Later reports wait in the queues above, where they can still be merged, instead of piling up
+    // in the controller behind the ones already scheduled.
+    struct k_sem credits;
+};
+
+static struct hog_conn hog_conns[HOG_CONN_COUNT];
+
+static struct zmk_hid_keyboard_report_body
+    keyboard_reports[HOG_CONN_COUNT][CONFIG_ZMK_BLE_KEYBOARD_REPORT_QUEUE_SIZE];
+static struct zmk_hid_keyboard_report_body keyboard_last_sent[HOG_CONN_COUNT];
+static struct zmk_hid_consumer_report_body
+    consumer_reports[HOG_CONN_COUNT][CONFIG_ZMK_BLE_CONSUMER_REPORT_QUEUE_SIZE];
+static struct zmk_hid_consumer_report_body consumer_last_sent[HOG_CONN_COUNT];
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+static struct zmk_hid_mouse_report_body
+    mouse_reports[HOG_CONN_COUNT][CONFIG_ZMK_BLE_MOUSE_REPORT_QUEUE_SIZE] __aligned(4);
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+
+#define HOG_REPORT_QUEUE_INIT(_reports, _last_sent, _merge)                                        \
+    ((struct hog_report_queue){                                                                    \
+        .reports = (uint8_t *)(_reports),                                                          \
+        .last_sent = (uint8_t *)(_last_sent),                                                      \
+        .report_size = sizeof(*(_last_sent)),                                                      \
+        .capacity = ARRAY_SIZE(_reports),                                                          \
+        .can_merge = (_merge),                                                                     \
+    })
+
+// The profile of the host @p hc sends reports to.
+static uint8_t hog_conn_profile(const struct hog_conn *hc) {
+#if IS_ENABLED(CONFIG_ZMK_BLE_MIRROR)
+    return hc - hog_conns;
+#else
+    return zmk_ble_active_profile_index();
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_MIRROR)
+}
+
+static struct hog_conn *hog_conn_active(void) {
+#if IS_ENABLED(CONFIG_ZMK_BLE_MIRROR)
+    return &hog_conns[zmk_ble_active_profile_index()];
+#else
+    return &hog_conns[0];
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_MIRROR)
+}
+
+// Whether reports are queued for the host of @p hc. The active profile gets them even while it
+// isn't connected, like without mirroring; mirrored profiles only while they are.
+static bool hog_conn_wanted(const struct hog_conn *hc) {
+#if IS_ENABLED(CONFIG_ZMK_BLE_MIRROR)
+    uint8_t profile = hog_conn_profile(hc);
+    return profile == zmk_ble_active_profile_index() ||
+           (atomic_get(&mirror_profiles) & zmk_ble_connected_profiles() & BIT(profile));
+#else
+    return true;
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_MIRROR)
+}
+
+// The reports for the host on @p conn, or NULL if it has none.
+static struct hog_conn *hog_conn_find(struct bt_conn *conn) {
+#if IS_ENABLED(CONFIG_ZMK_BLE_MIRROR)
+    int profile = zmk_ble_profile_index(bt_conn_get_dst(conn));
+    return profile >= 0 ? &hog_conns[profile] : NULL;
+#else
+    return &hog_conns[0];
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_MIRROR)
+}
+
+static bool hog_notify_credit_take(struct hog_conn *hc) {
+    return k_sem_take(&hc->credits, K_NO_WAIT) == 0;
+}
+
+static void hog_notify_credit_give(struct hog_conn *hc) { k_sem_give(&hc->credits); }
+
+// the parameters currently negotiated for the active profile connection
+static uint16_t conn_interval;
+static uint16_t conn_latency;
+
+#if IS_ENABLED(CONFIG_ZMK_BLE_ACTIVE_CONN_PARAMS)
+
+// While reports are being sent, a shorter connection interval is requested to cut the time a
+// report waits for the next connection event. After a while without reports, the preferred
+// peripheral parameters are requested again so an idle link costs less power.
+static bool conn_params_active;
+
+static void hog_conn_params_update(bool active) {
+    struct bt_conn *conn = zmk_ble_active_profile_conn();
+    if (conn == NULL) {
+        return;
+    }
+
+    struct bt_le_conn_param param =
+        BT_LE_CONN_PARAM_INIT(CONFIG_BT_PERIPHERAL_PREF_MIN_INT, CONFIG_BT_PERIPHERAL_PREF_MAX_INT,
+                              CONFIG_BT_PERIPHERAL_PREF_LATENCY, CONFIG_BT_PERIPHERAL_PREF_TIMEOUT);
+    if (active) {
+        param.interval_min = CONFIG_ZMK_BLE_ACTIVE_CONN_INTERVAL;
+        param.interval_max = CONFIG_ZMK_BLE_ACTIVE_CONN_INTERVAL;
+        param.latency = CONFIG_ZMK_BLE_ACTIVE_CONN_LATENCY;
+    }
+
+    int err = bt_conn_le_param_update(conn, &param);
+    if (err) {
+        LOG_WRN("Failed to request %s connection parameters (%d)", active ? "active" : "idle",
+                err);
+    }
+
+    bt_conn_unref(conn);
+}
+
+static void hog_conn_idle_callback(struct k_work *work) {
+    conn_params_active = false;
+    hog_conn_params_update(false);
+}
+
+K_WORK_DELAYABLE_DEFINE(hog_conn_idle_work, hog_conn_idle_callback);
+
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_ACTIVE_CONN_PARAMS)
+
+// Notify the host of @p hc of a report, returning an error if it won't be sent. On success,
+// @p sent is called with @p hc once it has been sent.
+static int hog_notify(struct hog_conn *hc, const struct bt_gatt_attr *attr, const void *data,
+                      uint16_t len, bt_gatt_complete_func_t sent) {
+    struct bt_conn *conn = zmk_ble_profile_conn(hog_conn_profile(hc));
+    if (conn == NULL) {
+        return -ENOTCONN;
+    }
+
+    struct bt_gatt_notify_params notify_params = {
+        .attr = attr,
+        .data = data,
+        .len = len,
+        .func = sent,
+        .user_data = hc,
+    };
+
+    int err = bt_gatt_notify_cb(conn, &notify_params);
+    if (err == -EPERM) {
+        bt_conn_set_security(conn, BT_SECURITY_L2);
+    } else if (err) {
+        LOG_DBG("Error notifying %d", err);
+    }
+
+    bt_conn_unref(conn);
+
+#if IS_ENABLED(CONFIG_ZMK_BLE_ACTIVE_CONN_PARAMS)
+    if (!err && hc == hog_conn_active()) {
+        k_work_reschedule_for_queue(&hog_work_q, &hog_conn_idle_work,
+                                    K_MSEC(CONFIG_ZMK_BLE_ACTIVE_CONN_IDLE_TIMEOUT_MS));
+
+        if (!conn_params_active) {
+            conn_params_active = true;
+            if (conn_interval > CONFIG_ZMK_BLE_ACTIVE_CONN_INTERVAL ||
+                conn_latency > CONFIG_ZMK_BLE_ACTIVE_CONN_LATENCY) {
+                hog_conn_params_update(true);
+            }
+        }
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_ACTIVE_CONN_PARAMS)
+
+    return err;
+}
+
+static void hog_submit_all(void);
+
+static void hog_notify_done(struct hog_conn *hc) {
+    hog_notify_credit_give(hc);
+    hog_submit_all();
+}
+
+ZMK_WORK_STATS_DEFINE(hog_keyboard, CONFIG_ZMK_BLE_KEYBOARD_REPORT_QUEUE_SIZE);
+
+static void hog_keyboard_sent(struct bt_conn *conn, void *user_data) {
+    struct hog_conn *hc = user_data;
+
+    hog_report_queue_sent(&hc->keyboard);
+    hog_notify_done(hc);
+}
+
+static void hog_send_keyboard_reports(struct hog_conn *hc) {
     struct zmk_hid_keyboard_report_body report;
 
-    while (k_msgq_get(&zmk_hog_keyboard_msgq, &report, K_NO_WAIT) == 0) {
-        struct bt_conn *conn = zmk_ble_active_profile_conn();
-        if (conn == NULL) {
-            return;
+    while (hog_notify_credit_take(hc)) {
+        if (!hog_report_queue_get(&hc->keyboard, &report)) {
+            hog_notify_credit_give(hc);
+            break;
+        }
+
+        int err = hog_notify(hc, &hog_svc.attrs[5], &report, sizeof(report), hog_keyboard_sent);
+        if (!err) {
+            // the next report is sent once this one completes
+            break;
         }
 
-        struct bt_gatt_notify_params notify_params = {
-            .attr = &hog_svc.attrs[5],
-            .data = &report,
-            .len = sizeof(report),
-        };
-
-        int err = bt_gatt_notify_cb(conn, &notify_params);
-        if (err == -EPERM) {
-            bt_conn_set_security(conn, BT_SECURITY_L2);
-        } else if (err) {
-            LOG_DBG("Error notifying %d", err);
+        hog_report_queue_sent(&hc->keyboard);
+        hog_notify_credit_give(hc);
+
+        if (err == -ENOTCONN) {
+            break;
         }
+    }
+}
 
-        bt_conn_unref(conn);
+void send_keyboard_report_callback(struct k_work *work) {
+    uint32_t start = zmk_work_stats_run_start(ZMK_WORK_STATS(hog_keyboard));
+
+    for (int i = 0; i < HOG_CONN_COUNT; i++) {
+        hog_send_keyboard_reports(&hog_conns[i]);
     }
+
+    zmk_work_stats_run_end(ZMK_WORK_STATS(hog_keyboard), start);
 }
 
 K_WORK_DEFINE(hog_keyboard_work, send_keyboard_report_callback);
 
 int zmk_hog_send_keyboard_report(struct zmk_hid_keyboard_report_body *report) {
-    int err = k_msgq_put(&zmk_hog_keyboard_msgq, report, K_MSEC(100));
-    if (err) {
-        switch (err) {
-        case -EAGAIN: {
-            LOG_WRN("Keyboard message queue full, popping first message and queueing again");
-            struct zmk_hid_keyboard_report_body discarded_report;
-            k_msgq_get(&zmk_hog_keyboard_msgq, &discarded_report, K_NO_WAIT);
-            return zmk_hog_send_keyboard_report(report);
-        }
-        default:
-            LOG_WRN("Failed to queue keyboard report to send (%d)", err);
-            return err;
+    uint8_t depth = 0;
+
+    // Every host gets a copy of the same report body.
+    for (int i = 0; i < HOG_CONN_COUNT; i++) {
+        if (hog_conn_wanted(&hog_conns[i])) {
+            depth = MAX(depth, hog_report_queue_put(&hog_conns[i].keyboard, report));
         }
     }
 
+    zmk_work_stats_queue_depth(ZMK_WORK_STATS(hog_keyboard), depth);
+    zmk_work_stats_submit(ZMK_WORK_STATS(hog_keyboard), 0);
     k_work_submit_to_queue(&hog_work_q, &hog_keyboard_work);
 
     return 0;
 };
 
-K_MSGQ_DEFINE(zmk_hog_consumer_msgq, sizeof(struct zmk_hid_consumer_report_body),
-              CONFIG_ZMK_BLE_CONSUMER_REPORT_QUEUE_SIZE, 4);
+// Every host gets a copy of each report, and a full queue merges it into the last one queued, so
+// this is full as soon as any of them is.
+bool zmk_hog_keyboard_report_queue_full(void) {
+    for (int i = 0; i < HOG_CONN_COUNT; i++) {
+        if (!hog_conn_wanted(&hog_conns[i])) {
+            continue;
+        }
 
-void send_consumer_report_callback(struct k_work *work) {
+        struct hog_report_queue *queue = &hog_conns[i].keyboard;
+        k_spinlock_key_t key = k_spin_lock(&queue->lock);
+        bool full = queue->len == queue->capacity;
+        k_spin_unlock(&queue->lock, key);
+
+        if (full) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+ZMK_WORK_STATS_DEFINE(hog_consumer, CONFIG_ZMK_BLE_CONSUMER_REPORT_QUEUE_SIZE);
+
+static void hog_consumer_sent(struct bt_conn *conn, void *user_data) {
+    struct hog_conn *hc = user_data;
+
+    hog_report_queue_sent(&hc->consumer);
+    hog_notify_done(hc);
+}
+
+static void hog_send_consumer_reports(struct hog_conn *hc) {
     struct zmk_hid_consumer_report_body report;
 
-    while (k_msgq_get(&zmk_hog_consumer_msgq, &report, K_NO_WAIT) == 0) {
-        struct bt_conn *conn = zmk_ble_active_profile_conn();
-        if (conn == NULL) {
-            return;
+    while (hog_notify_credit_take(hc)) {
+        if (!hog_report_queue_get(&hc->consumer, &report)) {
+            hog_notify_credit_give(hc);
+            break;
         }
 
-        struct bt_gatt_notify_params notify_params = {
-            .attr = &hog_svc.attrs[9],
-            .data = &report,
-            .len = sizeof(report),
-        };
-
-        int err = bt_gatt_notify_cb(conn, &notify_params);
-        if (err == -EPERM) {
-            bt_conn_set_security(conn, BT_SECURITY_L2);
-        } else if (err) {
-            LOG_DBG("Error notifying %d", err);
+        int err = hog_notify(hc, &hog_svc.attrs[9], &report, sizeof(report), hog_consumer_sent);
+        if (!err) {
+            // the next report is sent once this one completes
+            break;
         }
 
-        bt_conn_unref(conn);
+        hog_report_queue_sent(&hc->consumer);
+        hog_notify_credit_give(hc);
+
+        if (err == -ENOTCONN) {
+            break;
+        }
     }
-};
+}
+
+void send_consumer_report_callback(struct k_work *work) {
+    uint32_t start = zmk_work_stats_run_start(ZMK_WORK_STATS(hog_consumer));
+
+    for (int i = 0; i < HOG_CONN_COUNT; i++) {
+        hog_send_consumer_reports(&hog_conns[i]);
+    }
+
+    zmk_work_stats_run_end(ZMK_WORK_STATS(hog_consumer), start);
+}
 
 K_WORK_DEFINE(hog_consumer_work, send_consumer_report_callback);
 
 int zmk_hog_send_consumer_report(struct zmk_hid_consumer_report_body *report) {
-    int err = k_msgq_put(&zmk_hog_consumer_msgq, report, K_MSEC(100));
-    if (err) {
-        switch (err) {
-        case -EAGAIN: {
-            LOG_WRN("Consumer message queue full, popping first message and queueing again");
-            struct zmk_hid_consumer_report_body discarded_report;
-            k_msgq_get(&zmk_hog_consumer_msgq, &discarded_report, K_NO_WAIT);
-            return zmk_hog_send_consumer_report(report);
-        }
-        default:
-            LOG_WRN("Failed to queue consumer report to send (%d)", err);
-            return err;
+    uint8_t depth = 0;
+
+    for (int i = 0; i < HOG_CONN_COUNT; i++) {
+        if (hog_conn_wanted(&hog_conns[i])) {
+            depth = MAX(depth, hog_report_queue_put(&hog_conns[i].consumer, report));
         }
     }
 
+    zmk_work_stats_queue_depth(ZMK_WORK_STATS(hog_consumer), depth);
+    zmk_work_stats_submit(ZMK_WORK_STATS(hog_consumer), 0);
     k_work_submit_to_queue(&hog_work_q, &hog_consumer_work);
 
     return 0;
@@ -410,45 +786,53 @@ int zmk_hog_send_consumer_report(struct zmk_hid_consumer_report_body *report) {
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 
-K_MSGQ_DEFINE(zmk_hog_mouse_msgq, sizeof(struct zmk_hid_mouse_report_body),
-              CONFIG_ZMK_BLE_MOUSE_REPORT_QUEUE_SIZE, 4);
+ZMK_WORK_STATS_DEFINE(hog_mouse, CONFIG_ZMK_BLE_MOUSE_REPORT_QUEUE_SIZE);
 
-void send_mouse_report_callback(struct k_work *work) {
+static void hog_mouse_sent(struct bt_conn *conn, void *user_data) { hog_notify_done(user_data); }
+
+static void hog_send_mouse_reports(struct hog_conn *hc) {
     struct zmk_hid_mouse_report_body report;
-    while (k_msgq_get(&zmk_hog_mouse_msgq, &report, K_NO_WAIT) == 0) {
-        struct bt_conn *conn = zmk_ble_active_profile_conn();
-        if (conn == NULL) {
-            return;
+
+    while (hog_notify_credit_take(hc)) {
+        if (k_msgq_get(&hc->mouse, &report, K_NO_WAIT) != 0) {
+            hog_notify_credit_give(hc);
+            break;
         }
 
-        struct bt_gatt_notify_params notify_params = {
-            .attr = &hog_svc.attrs[13],
-            .data = &report,
-            .len = sizeof(report),
-        };
-
-        int err = bt_gatt_notify_cb(conn, &notify_params);
-        if (err == -EPERM) {
-            bt_conn_set_security(conn, BT_SECURITY_L2);
-        } else if (err) {
-            LOG_DBG("Error notifying %d", err);
+        int err = hog_notify(hc, &hog_svc.attrs[13], &report, sizeof(report), hog_mouse_sent);
+        if (err) {
+            hog_notify_credit_give(hc);
         }
 
-        bt_conn_unref(conn);
+        if (err == -ENOTCONN) {
+            break;
+        }
+    }
+}
+
+void send_mouse_report_callback(struct k_work *work) {
+    uint32_t start = zmk_work_stats_run_start(ZMK_WORK_STATS(hog_mouse));
+
+    for (int i = 0; i < HOG_CONN_COUNT; i++) {
+        hog_send_mouse_reports(&hog_conns[i]);
     }
+
+    zmk_work_stats_run_end(ZMK_WORK_STATS(hog_mouse), start);
 };
 
 K_WORK_DEFINE(hog_mouse_work, send_mouse_report_callback);
 
-int zmk_hog_send_mouse_report(struct zmk_hid_mouse_report_body *report) {
-    int err = k_msgq_put(&zmk_hog_mouse_msgq, report, K_MSEC(100));
+static int hog_queue_mouse_report(struct hog_conn *hc, struct zmk_hid_mouse_report_body *report,
+                                  k_timeout_t timeout) {
+    int err = k_msgq_put(&hc->mouse, report, timeout);
     if (err) {
         switch (err) {
+        case -ENOMSG:
         case -EAGAIN: {
-            LOG_WRN("Consumer message queue full, popping first message and queueing again");
+            LOG_WRN("Mouse message queue full, popping first message and queueing again");
             struct zmk_hid_mouse_report_body discarded_report;
-            k_msgq_get(&zmk_hog_mouse_msgq, &discarded_report, K_NO_WAIT);
-            return zmk_hog_send_mouse_report(report);
+            k_msgq_get(&hc->mouse, &discarded_report, K_NO_WAIT);
+            return hog_queue_mouse_report(hc, report, K_NO_WAIT);
         }
         default:
             LOG_WRN("Failed to queue mouse report to send (%d)", err);
@@ -456,17 +840,136 @@ int zmk_hog_send_mouse_report(struct zmk_hid_mouse_report_body *report) {
         }
     }
 
+    return 0;
+}
+
+int zmk_hog_send_mouse_report(struct zmk_hid_mouse_report_body *report) {
+    struct hog_conn *active = hog_conn_active();
+    uint32_t depth = 0;
+
+    for (int i = 0; i < HOG_CONN_COUNT; i++) {
+        struct hog_conn *hc = &hog_conns[i];
+        if (!hog_conn_wanted(hc)) {
+            continue;
+        }
+
+        // Only the active host's queue may hold the sender up.
+        int err = hog_queue_mouse_report(hc, report, hc == active ? K_MSEC(100) : K_NO_WAIT);
+        if (err && hc == active) {
+            return err;
+        }
+
+        depth = MAX(depth, k_msgq_num_used_get(&hc->mouse));
+    }
+
+    zmk_work_stats_queue_depth(ZMK_WORK_STATS(hog_mouse), depth);
+    zmk_work_stats_submit(ZMK_WORK_STATS(hog_mouse), 0);
     k_work_submit_to_queue(&hog_work_q, &hog_mouse_work);
 
     return 0;
 };
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
+static void hog_submit_all(void) {
+    k_work_submit_to_queue(&hog_work_q, &hog_keyboard_work);
+    k_work_submit_to_queue(&hog_work_q, &hog_consumer_work);
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+    k_work_submit_to_queue(&hog_work_q, &hog_mouse_work);
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+}
+
+static bool is_hid_conn(struct bt_conn *conn) {
+    struct bt_conn_info info;
+    return bt_conn_get_info(conn, &info) == 0 && info.role == BT_CONN_ROLE_PERIPHERAL;
+}
+
+static bool is_active_profile_conn(struct bt_conn *conn) {
+    struct bt_conn *active = zmk_ble_active_profile_conn();
+    if (active == NULL) {
+        return false;
+    }
+
+    bt_conn_unref(active);
+    return active == conn;
+}
+
+static void hog_connected(struct bt_conn *conn, uint8_t err) {
+    struct bt_conn_info info;
+    if (err || !is_active_profile_conn(conn) || bt_conn_get_info(conn, &info) != 0) {
+        return;
+    }
+
+    conn_interval = info.le.interval;
+    conn_latency = info.le.latency;
+    LOG_DBG("HID connection interval %d latency %d", conn_interval, conn_latency);
+}
+
+// Notifications that were in flight when their connection dropped never complete.
+static void hog_disconnected(struct bt_conn *conn, uint8_t reason) {
+    if (!is_hid_conn(conn)) {
+        return;
+    }
+
+    struct hog_conn *hc = hog_conn_find(conn);
+    if (hc == NULL) {
+        return;
+    }
+
+    hog_report_queue_sent(&hc->keyboard);
+    hog_report_queue_sent(&hc->consumer);
+    // the semaphore limit keeps late completions from adding credits
+    for (int i = 0; i < CONFIG_ZMK_BLE_HID_NOTIFICATIONS_PER_CONN_EVENT; i++) {
+        hog_notify_credit_give(hc);
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_BLE_ACTIVE_CONN_PARAMS)
+    if (hc == hog_conn_active()) {
+        k_work_cancel_delayable(&hog_conn_idle_work);
+        conn_params_active = false;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_ACTIVE_CONN_PARAMS)
+
+    hog_submit_all();
+}
+
+static void hog_le_param_updated(struct bt_conn *conn, uint16_t interval, uint16_t latency,
+                                 uint16_t timeout) {
+    if (!is_active_profile_conn(conn)) {
+        return;
+    }
+
+    conn_interval = interval;
+    conn_latency = latency;
+}
+
+static struct bt_conn_cb hog_conn_callbacks = {
+    .connected = hog_connected,
+    .disconnected = hog_disconnected,
+    .le_param_updated = hog_le_param_updated,
+};
+
 static int zmk_hog_init(void) {
+    for (int i = 0; i < HOG_CONN_COUNT; i++) {
+        struct hog_conn *hc = &hog_conns[i];
+
+        hc->keyboard = HOG_REPORT_QUEUE_INIT(keyboard_reports[i], &keyboard_last_sent[i],
+                                             keyboard_reports_can_merge);
+        hc->consumer = HOG_REPORT_QUEUE_INIT(consumer_reports[i], &consumer_last_sent[i],
+                                             consumer_reports_can_merge);
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+        k_msgq_init(&hc->mouse, (char *)mouse_reports[i], sizeof(mouse_reports[i][0]),
+                    ARRAY_SIZE(mouse_reports[i]));
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+        k_sem_init(&hc->credits, CONFIG_ZMK_BLE_HID_NOTIFICATIONS_PER_CONN_EVENT,
+                   CONFIG_ZMK_BLE_HID_NOTIFICATIONS_PER_CONN_EVENT);
+    }
+
     static const struct k_work_queue_config queue_config = {.name = "HID Over GATT Send Work"};
     k_work_queue_start(&hog_work_q, hog_q_stack, K_THREAD_STACK_SIZEOF(hog_q_stack),
                        CONFIG_ZMK_BLE_THREAD_PRIORITY, &queue_config);
 
+    bt_conn_cb_register(&hog_conn_callbacks);
+
     return 0;
 }
 
@@ -15,9 +15,96 @@
  *   HidKeyboardReport – keyboard HID report, fired at zmk_endpoint_send_report
  *   HidConsumerReport – consumer HID report
  *   HidMouseReport    – mouse HID report (CONFIG_ZMK_POINTING)
+ *   LayerStateChanged – one per zmk_layer_state_changed that turns a layer on or off
+ *   ModifiersStateChanged – zmk_modifiers_state_changed (explicit modifiers)
+ *   EndpointChanged   – zmk_endpoint_changed
+ *
+ * With CONFIG_ZMK_IPC_OBSERVER_STATE_SNAPSHOT, every client first receives a
+ * StateSnapshot with the layer state, modifiers, endpoint, HID reports and
+ * battery level, so the events above are deltas from a known state.
+ *
+ * With CONFIG_ZMK_IPC_OBSERVER_KEYBOARD_DELTA, a client subscribed to
+ * keyboard_delta gets HidKeyboardDelta frames, the usages pressed and
+ * released since the previous report, with a periodic keyframe to resync.
+ *
+ * With CONFIG_ZMK_IPC_OBSERVER_KSCAN_BATCH, position events are only recorded
+ * on the key path and encoded later by the writer thread.  KscanEvents still
+ * arrive in order; kscan_batch subscribers get up to eight per KscanEventBatch.
  *
  * Wire format: [4-byte big-endian length][nanopb-encoded ZmkEvent]
  *
+ * With CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS, a client that sets
+ * packed_events in its Hello gets the event types above as fixed-layout
+ * little-endian structs instead (see zmk_ipc_packed.h), behind the same
+ * length prefix.  While such a client is connected those events are encoded
+ * both ways into the shared frame and each connection sends its own form.
+ *
+ * Events are encoded once, in place, into a shared length-prefixed frame on
+ * the thread that raised them and handed to a dedicated writer thread through
+ * the fan-out queue.  Raising an event never touches the client table: the
+ * writer references each frame from a bounded queue per client and drains
+ * the queues with non-blocking sends.  A client whose queue is full is
+ * handled according to CONFIG_ZMK_IPC_OBSERVER_OVERFLOW_* (drop oldest, drop
+ * newest, disconnect).
+ *
+ * Clients may send ClientMessage frames back on the same socket.  A Subscribe
+ * message restricts the connection to the ZmkEvent payload types in its
+ * event_mask; event types no client has subscribed to are not even encoded.
+ *
+ * With CONFIG_ZMK_IPC_OBSERVER_CONNECT, key events sent on this socket are
+ * injected into the kscan IPC driver, so a single connection carries the
+ * whole bidirectional Connect RPC as one ordered stream.
+ *
+ * With CONFIG_ZMK_IPC_OBSERVER_SHM every frame is also published, unfiltered,
+ * on a shared-memory ring (see zmk_ipc_shm.h) for one syscall-free consumer.
+ *
+ * With CONFIG_ZMK_IPC_OBSERVER_TRACE_FILE every frame is also appended,
+ * unfiltered and through a stdio buffer, to the file named by the
+ * ZMK_IPC_TRACE_FILE environment variable.  Tests decode it with
+ * decode-ipc-trace.py instead of scraping debug logs.
+ *
+ * With CONFIG_ZMK_IPC_OBSERVER_INPUT_CREDITS, clients subscribed to
+ * input_credits get an InputCredits frame whenever the kscan event queue
+ * has taken more events, checked every
+ * CONFIG_ZMK_IPC_OBSERVER_INPUT_CREDITS_INTERVAL_MS, so they can pace key
+ * input to the room left in the queue.
+ *
+ * With CONFIG_ZMK_IPC_OBSERVER_LATENCY_TRACE, a KeyEvent carrying a non-zero
+ * seq is timestamped at the kscan callback and at position event raise; the
+ * next HidKeyboardReport reports those times with its own send time.
+ *
+ * With CONFIG_ZMK_EVENT_MANAGER_STATS, a GetEventStats message is answered
+ * with one EventTypeStats frame per event type, to the requester only.
+ * Likewise, with CONFIG_ZMK_STAGE_TIMING, GetStageTimings is answered with
+ * one StageTiming histogram frame per key press path stage, and with
+ * CONFIG_ZMK_WORK_STATS, GetWorkStats with one WorkStats frame per work item.
+ * With CONFIG_ZMK_KEY_STATS, GetKeyStats is answered with a KeyStats frame
+ * of the intervals between key presses, then one per key position in use.
+ * With CONFIG_ZMK_THREAD_STACK_STATS, GetThreadStacks is answered with one
+ * ThreadStack frame per thread, carrying its stack size and peak use.
+ *
+ * A Hello is answered with a Capabilities frame: the protocol version, frame
+ * size limits, the ZmkEvent and ClientMessage payloads this build handles
+ * and the kscan IPC matrix size.  Its event_mask, if set, subscribes the
+ * connection to the payloads the client understands, opt-in ones included.
+ *
+ * GetClientStats is answered with one ClientStats frame per connection:
+ * frames and bytes sent, frames dropped, queue depth and its high-water
+ * mark, and the socket send buffer (CONFIG_ZMK_IPC_OBSERVER_SNDBUF_SIZE).
+ *
+ * With CONFIG_ZMK_IPC_OBSERVER_KEYMAP, GetKeymapBindings streams a block of
+ * the keymap back as KeymapBindings frames and SetKeymapBindings rewrites
+ * one, again replying to the requester only.  With reset set, the layers
+ * and HID reports are reset first, so a whole keymap can be hot-reloaded.
+ *
+ * With CONFIG_ZMK_IPC_OBSERVER_CHECKPOINT, SaveCheckpoint writes a checkpoint
+ * of the keyboard to the path it names and is answered with a
+ * CheckpointResult frame.
+ *
+ * With CONFIG_ZMK_CONTEXT_COUNT above 1, every broadcast event carries the
+ * context it was raised in as ZmkEvent.context, and every KscanEvent the
+ * context of its key, so a client can tell the keyboards apart.
+ *
  * Example client (Python):
  *   import socket, struct
  *   from zmk_ipc_pb2 import ZmkEvent
@@ -33,246 +120,2257 @@
 #include <zephyr/init.h>
 #include <zephyr/logging/log.h>
 
+#include <zephyr/sys/byteorder.h>
+
+#include <zmk/context.h>
 #include <zmk/event_manager.h>
+#include <zmk/events/endpoint_changed.h>
+#include <zmk/events/layer_state_changed.h>
+#include <zmk/events/modifiers_state_changed.h>
 #include <zmk/events/position_state_changed.h>
+#include <zmk/endpoints.h>
 #include <zmk/hid.h>
 #include <zmk/ipc_observer.h>
+#include <zmk/key_stats.h>
+#include <zmk/stage_timing.h>
+#include <zmk/work_stats.h>
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_DRIVER)
+#include <zmk/kscan_ipc.h>
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_LATENCY_TRACE)
+#include <zmk/matrix.h>
+#include <zmk/physical_layouts.h>
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_INPUT_CREDITS)
+#include <zmk/physical_layouts.h>
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_STATE_SNAPSHOT)
+#include <zmk/battery.h>
+#include <zmk/keymap.h>
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYMAP)
+#include <drivers/behavior.h>
+#include <zmk/behavior.h>
+#include <zmk/keymap.h>
+#include <zmk/matrix.h>
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_KEY_STATS)
+#include <zmk/matrix.h>
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_CHECKPOINT)
+#include <zmk/checkpoint.h>
+#endif
 
 #include "zmk_ipc.pb.h"
 #include "zmk_ipc_framing.h"
+#include "zmk_ipc_listener.h"
+#include "zmk_ipc_loop.h"
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_SHM)
+#include "zmk_ipc_shm.h"
+#endif
 
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS)
+#include "zmk_ipc_packed.h"
+#endif
+
+#include <linux/sockios.h>
+#include <sys/ioctl.h>
 #include <sys/socket.h>
-#include <sys/un.h>
 #include <unistd.h>
 #include <string.h>
-#include <stdlib.h>
 #include <errno.h>
+#include <stdio.h>
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_TRACE_FILE)
+#include <stdlib.h>
+#endif
 
 LOG_MODULE_REGISTER(zmk_ipc_observer, CONFIG_ZMK_IPC_OBSERVER_LOG_LEVEL);
 
 #define MAX_CLIENTS CONFIG_ZMK_IPC_OBSERVER_MAX_CLIENTS
+#define QUEUE_DEPTH CONFIG_ZMK_IPC_OBSERVER_CLIENT_QUEUE_DEPTH
+
+#define FANOUT_DEPTH CONFIG_ZMK_IPC_OBSERVER_FANOUT_QUEUE_DEPTH
+
+/* Enough frames for every client queue and the fan-out queue to be full of
+ * distinct frames, plus a few being encoded by concurrent raisers. */
+#define FRAME_POOL_SIZE (MAX_CLIENTS * QUEUE_DEPTH + FANOUT_DEPTH + 4)
 
+/* Maximum number of queued frames handed to a single sendmsg() call. */
+#define WRITER_IOV_MAX 16
+
+/* Subscription mask bit for a ZmkEvent payload field number. */
+#define EVENT_BIT(tag) BIT(tag)
+#define EVENT_MASK_ALL                                                                             \
+    (EVENT_BIT(zmk_ipc_ZmkEvent_kscan_event_tag) | EVENT_BIT(zmk_ipc_ZmkEvent_keyboard_tag) |     \
+     EVENT_BIT(zmk_ipc_ZmkEvent_consumer_tag) | EVENT_BIT(zmk_ipc_ZmkEvent_mouse_tag) |       \
+     EVENT_BIT(zmk_ipc_ZmkEvent_layer_state_tag) |                                                \
+     EVENT_BIT(zmk_ipc_ZmkEvent_modifiers_state_tag) |                                            \
+     EVENT_BIT(zmk_ipc_ZmkEvent_endpoint_changed_tag))
+
+/* Event types clients only get by subscribing to them, on top of the default
+ * set; the shared-memory ring and the trace file never carry them. */
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYBOARD_DELTA)
+#define EVENT_MASK_OPT_IN_DELTA EVENT_BIT(zmk_ipc_ZmkEvent_keyboard_delta_tag)
+#else
+#define EVENT_MASK_OPT_IN_DELTA 0
+#endif
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KSCAN_BATCH)
+#define EVENT_MASK_OPT_IN_KSCAN EVENT_BIT(zmk_ipc_ZmkEvent_kscan_batch_tag)
+#else
+#define EVENT_MASK_OPT_IN_KSCAN 0
+#endif
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_INPUT_CREDITS)
+#define EVENT_MASK_OPT_IN_CREDITS EVENT_BIT(zmk_ipc_ZmkEvent_input_credits_tag)
+#else
+#define EVENT_MASK_OPT_IN_CREDITS 0
+#endif
+#define EVENT_MASK_OPT_IN                                                                          \
+    (EVENT_MASK_OPT_IN_DELTA | EVENT_MASK_OPT_IN_KSCAN | EVENT_MASK_OPT_IN_CREDITS)
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KSCAN_BATCH)
+#define KSCAN_BATCH_MAX ARRAY_SIZE(((zmk_ipc_KscanEventBatch *)NULL)->events)
+#endif
+
+/*
+ * An encoded, length-prefixed event frame shared by every client queue that
+ * references it. Frames are immutable once queued and return to the slab
+ * when the last reference is released.  Until the writer has fanned a frame
+ * out, refs is 0 and only the fan-out queue points to it.  A frame may also
+ * carry the packed form of its event, for clients that asked for it.
+ */
+struct ipc_frame {
+    uint16_t refs;
+    uint16_t len;
+    uint32_t event_bit; /* EVENT_BIT() of the payload */
+    uint8_t data[ZMK_IPC_EVENT_FRAME_MAX];
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS)
+    uint16_t packed_len; /* 0 if the event has no packed form */
+    uint8_t packed[ZMK_IPC_PACKED_FRAME_MAX];
+#endif
+};
+
+/*
+ * Per-client ring of frames awaiting transmission. The frame at `head` may
+ * be partially written; `head_sent` tracks how many of its bytes the socket
+ * has already accepted.  `packed` only follows `packed_requested` at a frame
+ * boundary, so a partly sent frame is finished in the form it was started.
+ */
+struct ipc_client {
+    int fd;
+    uint32_t event_mask;
+    uint16_t head;
+    uint16_t count;
+    uint16_t head_sent;
+    uint16_t high_water; /* most frames queued at once */
+    uint32_t dropped;
+    uint32_t frames_sent;
+    uint64_t bytes_sent;
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS)
+    bool packed_requested;
+    bool packed;
+#endif
+    struct ipc_frame *frames[QUEUE_DEPTH];
+    /* Incoming control frames; only touched by the IPC event loop. */
+    struct zmk_ipc_loop_source source;
+    struct zmk_ipc_frame_reader reader;
+};
+
+/*
+ * The client table, the per-client queues and the fan-out are guarded by
+ * clients_mutex, which only the writer thread and the IPC event loop take.
+ * Threads raising events just encode and put the frame on fanout_queue.
+ */
 static int server_fd = -1;
-static int client_fds[MAX_CLIENTS];
+static struct zmk_ipc_loop_source server_source;
+static struct ipc_client clients[MAX_CLIENTS];
 static K_MUTEX_DEFINE(clients_mutex);
+static K_SEM_DEFINE(writer_sem, 0, 1);
+
+/* Union of all connected clients' event masks, for the encode fast path. */
+static atomic_t wanted_mask;
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS)
+/* Set while any connected client asked for packed frames. */
+static atomic_t packed_wanted;
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYBOARD_DELTA)
+/* Set when the next keyboard delta has to be a keyframe: at boot, for a new
+ * delta subscriber and after a delta subscriber lost frames. */
+static atomic_t keyframe_due = ATOMIC_INIT(1);
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KSCAN_BATCH)
+/* A position event as recorded on the key path, encoded later. */
+struct kscan_record {
+    int64_t timestamp;
+    uint32_t position;
+    uint8_t source;
+    uint8_t context;
+    bool pressed;
+};
+
+static atomic_t kscan_records_lost; /* records the fan-out queue had no room for */
+
+/* The batch being filled and when it is due; clients_mutex guards both. */
+static zmk_ipc_KscanEventBatch kscan_batch;
+static int64_t kscan_batch_due;
+#endif
+
+/* An event on its way to the writer thread: an encoded frame, or with
+ * CONFIG_ZMK_IPC_OBSERVER_KSCAN_BATCH a position event still to encode. */
+struct fanout_entry {
+    struct ipc_frame *frame; /* NULL for a kscan record */
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KSCAN_BATCH)
+    struct kscan_record kscan;
+#endif
+};
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_INPUT_CREDITS)
+/* Taken events last reported, and whether a new subscriber is owed credits
+ * anyway; clients_mutex guards both. */
+static uint32_t credits_consumed;
+static bool credits_due;
+#endif
+
+K_MSGQ_DEFINE(fanout_queue, sizeof(struct fanout_entry), FANOUT_DEPTH, 8);
+static atomic_t fanout_lost; /* frames the fan-out queue had no room for */
+static atomic_t fanout_lost_mask; /* EVENT_BIT()s of those frames */
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_SHM)
+static struct zmk_ipc_shm_ring event_ring;
+static uint32_t shm_dropped; /* consecutive frames the ring had no room for */
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_TRACE_FILE)
+static FILE *trace_file;
+#endif
+
+K_MEM_SLAB_DEFINE_STATIC(frame_slab, sizeof(struct ipc_frame), FRAME_POOL_SIZE, 4);
 
 /* -------------------------------------------------------------------------
- * Internal broadcast helper
- * Encodes event once, then sends the same frame to every connected client.
- * Clients that fail to receive are closed and removed.
+ * Frame pool and client queue helpers
+ *
+ * Frames may be allocated on any thread; everything else here needs
+ * clients_mutex.
  * ------------------------------------------------------------------------- */
 
-static void broadcast_event(const zmk_ipc_ZmkEvent *event) {
-    uint8_t buf[zmk_ipc_ZmkEvent_size];
-    size_t encoded_len;
+static struct ipc_frame *frame_alloc(void) {
+    struct ipc_frame *frame;
 
-    if (zmk_ipc_encode_event(event, buf, sizeof(buf), &encoded_len) != 0) {
-        return; /* encode error already logged inside helper */
+    if (k_mem_slab_alloc(&frame_slab, (void **)&frame, K_NO_WAIT) < 0) {
+        return NULL;
     }
+    frame->refs = 0;
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS)
+    frame->packed_len = 0;
+#endif
+    return frame;
+}
 
-    k_mutex_lock(&clients_mutex, K_FOREVER);
+static void frame_release(struct ipc_frame *frame) {
+    if (frame->refs == 0 || --frame->refs == 0) {
+        k_mem_slab_free(&frame_slab, frame);
+    }
+}
+
+static uint16_t client_slot(const struct ipc_client *client, uint16_t offset) {
+    return (client->head + offset) % QUEUE_DEPTH;
+}
+
+static void update_wanted_mask(void) {
+    /* The shared-memory consumer always takes every event type. */
+    uint32_t mask = IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_SHM) ? EVENT_MASK_ALL : 0;
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_TRACE_FILE)
+    /* So does the trace file. */
+    if (trace_file) {
+        mask = EVENT_MASK_ALL;
+    }
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS)
+    bool packed = false;
+#endif
+
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (clients[i].fd >= 0) {
+            mask |= clients[i].event_mask;
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS)
+            packed |= clients[i].packed_requested;
+#endif
+        }
+    }
+    atomic_set(&wanted_mask, (atomic_val_t)mask);
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS)
+    atomic_set(&packed_wanted, packed);
+#endif
+}
+
+static void client_close(struct ipc_client *client) {
+    for (uint16_t i = 0; i < client->count; i++) {
+        frame_release(client->frames[client_slot(client, i)]);
+    }
+    close(client->fd);
+    client->fd        = -1;
+    client->head      = 0;
+    client->count     = 0;
+    client->head_sent = 0;
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS)
+    client->packed_requested = false;
+    client->packed           = false;
+#endif
+    update_wanted_mask();
+}
+
+static void client_count_drops(struct ipc_client *client, uint32_t count) {
+    client->dropped += count;
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYBOARD_DELTA)
+    /* The frame may have been a delta, so resync the client. */
+    if (client->event_mask & EVENT_BIT(zmk_ipc_ZmkEvent_keyboard_delta_tag)) {
+        atomic_set(&keyframe_due, 1);
+    }
+#endif
+}
+
+/* Remove the frame at queue offset `offset`, closing the gap it leaves. */
+static void client_drop_at(struct ipc_client *client, uint16_t offset) {
+    frame_release(client->frames[client_slot(client, offset)]);
+
+    if (offset == 0) {
+        client->head = client_slot(client, 1);
+        client->head_sent = 0;
+    } else {
+        for (uint16_t i = offset; i + 1 < client->count; i++) {
+            client->frames[client_slot(client, i)] = client->frames[client_slot(client, i + 1)];
+        }
+    }
+    client->count--;
+    client_count_drops(client, 1);
+}
+
+/* Queue a shared frame. Returns false if the client had to be disconnected. */
+static bool client_enqueue(struct ipc_client *client, struct ipc_frame *frame) {
+    if (client->count == QUEUE_DEPTH) {
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_OVERFLOW_DISCONNECT)
+        LOG_WRN("IPC observer: client fd=%d queue full, disconnecting", client->fd);
+        client_close(client);
+        return false;
+#elif IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_OVERFLOW_DROP_NEWEST)
+        client_count_drops(client, 1);
+        return true;
+#else
+        /* Never evict a frame whose first bytes are already on the wire. */
+        client_drop_at(client, client->head_sent > 0 ? 1 : 0);
+#endif
+    }
+
+    frame->refs++;
+    client->frames[client_slot(client, client->count)] = frame;
+    client->count++;
+    client->high_water = MAX(client->high_water, client->count);
+    return true;
+}
+
+/* Apply the overflow policy to every client subscribed to one of the events
+ * in `lost_mask`, which never reached the per-client queues: each of them
+ * misses the `lost` events.  clients_mutex must be held. */
+static void clients_count_lost(uint32_t lost_mask, uint32_t lost) {
     for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (client_fds[i] < 0) {
+        struct ipc_client *client = &clients[i];
+
+        if (client->fd < 0 || !(client->event_mask & lost_mask)) {
             continue;
         }
-        int ret = zmk_ipc_frame_send(client_fds[i], buf, encoded_len);
-        if (ret != 0) {
-            LOG_DBG("IPC observer: client fd[%d] dropped (err %d)", i, ret);
-            close(client_fds[i]);
-            client_fds[i] = -1;
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_OVERFLOW_DISCONNECT)
+        LOG_WRN("IPC observer: client fd=%d missed events, disconnecting", client->fd);
+        client_close(client);
+#else
+        client_count_drops(client, lost);
+#endif
+    }
+}
+
+/*
+ * Write as much of the client's queue as the socket accepts without blocking,
+ * gathering up to WRITER_IOV_MAX queued frames per sendmsg() call.
+ * Returns -EAGAIN if frames remain queued, 0 if the queue was drained, or
+ * another negative errno if the connection failed.
+ */
+static int client_flush(struct ipc_client *client) {
+    while (client->count > 0) {
+        struct iovec iov[WRITER_IOV_MAX];
+        size_t iov_count = MIN(client->count, WRITER_IOV_MAX);
+        size_t total = 0;
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS)
+        if (client->head_sent == 0) {
+            client->packed = client->packed_requested;
+        }
+#endif
+
+        for (size_t i = 0; i < iov_count; i++) {
+            struct ipc_frame *frame = client->frames[client_slot(client, i)];
+            size_t skip = (i == 0) ? client->head_sent : 0;
+            uint8_t *bytes = frame->data;
+            size_t len = frame->len;
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS)
+            if (client->packed && frame->packed_len > 0) {
+                bytes = frame->packed;
+                len   = frame->packed_len;
+            }
+#endif
+
+            iov[i].iov_base = bytes + skip;
+            iov[i].iov_len  = len - skip;
+            total += iov[i].iov_len;
+        }
+
+        struct msghdr msg = {.msg_iov = iov, .msg_iovlen = iov_count};
+        ssize_t sent = sendmsg(client->fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return (errno == EWOULDBLOCK) ? -EAGAIN : -errno;
+        }
+
+        /* Retire fully written frames; remember progress into the next one. */
+        size_t done = (size_t)sent;
+        client->bytes_sent += done;
+        for (size_t i = 0; i < iov_count && done >= iov[i].iov_len; i++) {
+            done -= iov[i].iov_len;
+            client->frames_sent++;
+            frame_release(client->frames[client->head]);
+            client->head = client_slot(client, 1);
+            client->head_sent = 0;
+            client->count--;
+        }
+        client->head_sent += (uint16_t)done;
+
+        if ((size_t)sent < total) {
+            return -EAGAIN;
         }
     }
-    k_mutex_unlock(&clients_mutex);
+
+    return 0;
 }
 
 /* -------------------------------------------------------------------------
- * Build Endpoint sub-message from a transport string produced by
- * zmk_endpoint_instance_to_str()  (e.g. "USB", "BLE:0", "None")
+ * Fan-out
+ * The raising thread encodes an event once, directly into a shared
+ * length-prefixed frame, and puts it on the fan-out queue.  The writer
+ * thread takes it from there, under clients_mutex, and queues it for every
+ * subscribed client; it also performs the actual socket writes.
  * ------------------------------------------------------------------------- */
 
-static zmk_ipc_Endpoint endpoint_from_str(const char *transport_str) {
-    zmk_ipc_Endpoint ep = zmk_ipc_Endpoint_init_zero;
+static inline bool event_wanted(pb_size_t tag) {
+    return (atomic_get(&wanted_mask) & EVENT_BIT(tag)) != 0;
+}
 
-    if (strncmp(transport_str, "USB", 3) == 0) {
-        ep.transport = zmk_ipc_TransportType_TRANSPORT_USB;
-    } else if (strncmp(transport_str, "BLE:", 4) == 0) {
-        ep.transport        = zmk_ipc_TransportType_TRANSPORT_BLE;
-        ep.ble_profile_idx  = (uint32_t)atoi(transport_str + 4);
-    } else {
-        ep.transport = zmk_ipc_TransportType_TRANSPORT_NONE;
+/* Queue a frame for every subscribed client; clients_mutex must be held.
+ * Returns true if any client queued it. */
+static bool fanout_frame(struct ipc_frame *frame) {
+    const uint32_t bit = frame->event_bit;
+    bool queued = false;
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_SHM)
+    if (!(bit & EVENT_MASK_ALL)) {
+        /* Opt-in event types stay off the ring. */
+    } else if (zmk_ipc_shm_ring_write(&event_ring, frame->data, frame->len) == 0) {
+        shm_dropped = 0;
+    } else if (shm_dropped++ == 0) {
+        LOG_WRN("IPC observer: shm ring full, dropping events");
     }
+#endif
 
-    return ep;
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_TRACE_FILE)
+    if (trace_file && (bit & EVENT_MASK_ALL) &&
+        fwrite(frame->data, 1, frame->len, trace_file) != frame->len) {
+        LOG_ERR("IPC observer: cannot write the trace file, closing it");
+        fclose(trace_file);
+        trace_file = NULL;
+        update_wanted_mask();
+    }
+#endif
+
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (clients[i].fd < 0 || !(clients[i].event_mask & bit)) {
+            continue;
+        }
+        queued |= client_enqueue(&clients[i], frame);
+    }
+
+    if (frame->refs == 0) {
+        frame_release(frame);
+    }
+    return queued;
+}
+
+/* Encode an event whose timestamp is set into a new frame, or return NULL. */
+static struct ipc_frame *encode_event(const zmk_ipc_ZmkEvent *event) {
+    struct ipc_frame *frame = frame_alloc();
+    if (!frame) {
+        LOG_ERR("IPC observer: frame pool exhausted");
+        return NULL;
+    }
+
+    size_t frame_len;
+    if (zmk_ipc_encode_event_frame(event, frame->data, sizeof(frame->data), &frame_len) != 0) {
+        frame_release(frame); /* encode error already logged inside helper */
+        return NULL;
+    }
+    frame->len       = (uint16_t)frame_len;
+    frame->event_bit = EVENT_BIT(event->which_payload);
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS)
+    /* Events without a packed form keep packed_len 0 and go out as protobuf. */
+    if (atomic_get(&packed_wanted) &&
+        zmk_ipc_encode_packed_frame(event, frame->packed, sizeof(frame->packed), &frame_len) == 0) {
+        frame->packed_len = (uint16_t)frame_len;
+    }
+#endif
+    return frame;
+}
+
+/* Hand an entry to the writer thread; safe on any thread. */
+static void fanout_put(const struct fanout_entry *entry) {
+    if (k_msgq_put(&fanout_queue, entry, K_NO_WAIT) < 0) {
+        if (entry->frame) {
+            atomic_or(&fanout_lost_mask, entry->frame->event_bit);
+            frame_release(entry->frame);
+            atomic_inc(&fanout_lost);
+        }
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KSCAN_BATCH)
+        else {
+            atomic_inc(&kscan_records_lost);
+        }
+#endif
+    }
+    k_sem_give(&writer_sem);
 }
 
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KSCAN_BATCH)
 /* -------------------------------------------------------------------------
- * Public notification functions (called from endpoints.c)
+ * Deferred KscanEvents
+ *
+ * The position listener only records the event on the fan-out queue; the
+ * records are encoded here, in their place in the stream.  Batches are
+ * sent when full, or CONFIG_ZMK_IPC_OBSERVER_KSCAN_BATCH_FLUSH_MS after
+ * their first event.  clients_mutex must be held throughout.
  * ------------------------------------------------------------------------- */
 
-void zmk_ipc_observer_notify_keyboard_report(const char *transport_str) {
-    struct zmk_hid_keyboard_report *report = zmk_hid_get_keyboard_report();
-    const size_t keys_size = sizeof(report->body.keys);
+/* Static, like the keymap event: the writer thread's stack is small. */
+static zmk_ipc_ZmkEvent kscan_ev;
 
-    zmk_ipc_HidKeyboardReport kb = zmk_ipc_HidKeyboardReport_init_zero;
-    kb.has_endpoint  = true;
-    kb.endpoint      = endpoint_from_str(transport_str);
-    kb.modifiers     = report->body.modifiers;
-    kb.keys.size     = (pb_size_t)MIN(keys_size, sizeof(kb.keys.bytes));
-    memcpy(kb.keys.bytes, report->body.keys, kb.keys.size);
+static bool kscan_event_send(void) {
+    struct ipc_frame *frame = encode_event(&kscan_ev);
 
-    zmk_ipc_ZmkEvent ev     = zmk_ipc_ZmkEvent_init_zero;
-    ev.which_payload        = zmk_ipc_ZmkEvent_keyboard_tag;
-    ev.payload.keyboard     = kb;
+    return frame && fanout_frame(frame);
+}
 
-    broadcast_event(&ev);
+static bool kscan_batch_send(void) {
+    kscan_ev = (zmk_ipc_ZmkEvent)zmk_ipc_ZmkEvent_init_zero;
+    kscan_ev.which_payload       = zmk_ipc_ZmkEvent_kscan_batch_tag;
+    kscan_ev.payload.kscan_batch = kscan_batch;
+    kscan_ev.timestamp           = k_uptime_get();
+
+    kscan_batch.events_count = 0;
+    kscan_batch.dropped      = 0;
+    return kscan_event_send();
 }
 
-void zmk_ipc_observer_notify_consumer_report(const char *transport_str) {
-    struct zmk_hid_consumer_report *report = zmk_hid_get_consumer_report();
-    const size_t keys_size = sizeof(report->body.keys);
+/* Encode one record.  Returns true if any client queued a frame. */
+static bool kscan_record_send(const struct kscan_record *rec) {
+    bool queued = false;
 
-    zmk_ipc_HidConsumerReport cr = zmk_ipc_HidConsumerReport_init_zero;
-    cr.has_endpoint  = true;
-    cr.endpoint      = endpoint_from_str(transport_str);
-    cr.keys.size     = (pb_size_t)MIN(keys_size, sizeof(cr.keys.bytes));
-    memcpy(cr.keys.bytes, report->body.keys, cr.keys.size);
+    uint32_t lost = (uint32_t)atomic_clear(&kscan_records_lost);
+    if (lost > 0) {
+        LOG_WRN("IPC observer: %u position events lost", lost);
+        if (event_wanted(zmk_ipc_ZmkEvent_kscan_batch_tag)) {
+            kscan_batch.dropped += lost;
+        }
+        clients_count_lost(EVENT_BIT(zmk_ipc_ZmkEvent_kscan_event_tag) |
+                               EVENT_BIT(zmk_ipc_ZmkEvent_kscan_batch_tag),
+                           lost);
+    }
 
-    zmk_ipc_ZmkEvent ev     = zmk_ipc_ZmkEvent_init_zero;
-    ev.which_payload        = zmk_ipc_ZmkEvent_consumer_tag;
-    ev.payload.consumer     = cr;
+    const zmk_ipc_KscanEvent kscan = {
+        .source    = rec->source,
+        .position  = rec->position,
+        .pressed   = rec->pressed,
+        .timestamp = rec->timestamp,
+        .context   = rec->context,
+    };
 
-    broadcast_event(&ev);
+    if (event_wanted(zmk_ipc_ZmkEvent_kscan_event_tag)) {
+        kscan_ev = (zmk_ipc_ZmkEvent)zmk_ipc_ZmkEvent_init_zero;
+        kscan_ev.which_payload       = zmk_ipc_ZmkEvent_kscan_event_tag;
+        kscan_ev.payload.kscan_event = kscan;
+        kscan_ev.timestamp           = rec->timestamp;
+        kscan_ev.context             = rec->context;
+        queued |= kscan_event_send();
+    }
+
+    if (event_wanted(zmk_ipc_ZmkEvent_kscan_batch_tag)) {
+        if (kscan_batch.events_count == 0) {
+            kscan_batch_due = k_uptime_get() + CONFIG_ZMK_IPC_OBSERVER_KSCAN_BATCH_FLUSH_MS;
+        }
+        kscan_batch.events[kscan_batch.events_count++] = kscan;
+        if (kscan_batch.events_count == KSCAN_BATCH_MAX) {
+            queued |= kscan_batch_send();
+        }
+    }
+    return queued;
 }
 
-#if IS_ENABLED(CONFIG_ZMK_POINTING)
-void zmk_ipc_observer_notify_mouse_report(const char *transport_str) {
-    struct zmk_hid_mouse_report *report = zmk_hid_get_mouse_report();
+/* Send the batch if it is due.  Returns the milliseconds until it is, or -1
+ * if no batch is pending. */
+static int64_t kscan_batch_flush_due(void) {
+    if (kscan_batch.events_count == 0) {
+        return -1;
+    }
 
-    zmk_ipc_HidMouseReport mr = zmk_ipc_HidMouseReport_init_zero;
-    mr.has_endpoint  = true;
-    mr.endpoint      = endpoint_from_str(transport_str);
-    mr.buttons       = report->body.buttons;
-    mr.dx            = report->body.d_x;
-    mr.dy            = report->body.d_y;
-    mr.scroll_x      = report->body.d_scroll_x;
-    mr.scroll_y      = report->body.d_scroll_y;
+    int64_t left = kscan_batch_due - k_uptime_get();
+    if (left > 0) {
+        return left;
+    }
+    kscan_batch_send();
+    return -1;
+}
+#endif /* IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KSCAN_BATCH) */
 
-    zmk_ipc_ZmkEvent ev  = zmk_ipc_ZmkEvent_init_zero;
-    ev.which_payload     = zmk_ipc_ZmkEvent_mouse_tag;
-    ev.payload.mouse     = mr;
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_INPUT_CREDITS)
+/* Send InputCredits if the queue has taken events since the last ones.
+ * Returns the milliseconds until the next check, or -1 if no client is
+ * subscribed.  clients_mutex must be held. */
+static int64_t input_credits_send(void) {
+    /* Static, like the kscan event: the writer thread's stack is small. */
+    static zmk_ipc_ZmkEvent credits_ev;
 
-    broadcast_event(&ev);
-}
-#endif /* IS_ENABLED(CONFIG_ZMK_POINTING) */
+    if (!event_wanted(zmk_ipc_ZmkEvent_input_credits_tag)) {
+        return -1;
+    }
 
-/* -------------------------------------------------------------------------
- * keyscan (position_state_changed) event listener
- * ------------------------------------------------------------------------- */
+    uint32_t consumed = zmk_physical_layouts_kscan_taken_events();
+    if (consumed != credits_consumed || credits_due) {
+        credits_ev = (zmk_ipc_ZmkEvent)zmk_ipc_ZmkEvent_init_zero;
+        credits_ev.which_payload = zmk_ipc_ZmkEvent_input_credits_tag;
+        credits_ev.payload.input_credits.capacity = CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE;
+        credits_ev.payload.input_credits.consumed = consumed;
+        credits_ev.timestamp = k_uptime_get();
 
-static int ipc_position_listener(const zmk_event_t *eh) {
-    const struct zmk_position_state_changed *pos = as_zmk_position_state_changed(eh);
-    if (!pos) {
-        return 0;
+        struct ipc_frame *frame = encode_event(&credits_ev);
+        if (frame) {
+            fanout_frame(frame);
+            credits_consumed = consumed;
+            credits_due = false;
+        }
     }
+    return CONFIG_ZMK_IPC_OBSERVER_INPUT_CREDITS_INTERVAL_MS;
+}
+#endif
 
-    zmk_ipc_KscanEvent kscan = zmk_ipc_KscanEvent_init_zero;
-    kscan.source    = pos->source;
-    kscan.position  = pos->position;
-    kscan.pressed   = pos->state;
-    kscan.timestamp = pos->timestamp;
+/* Fan out everything on the fan-out queue, in order; clients_mutex must be
+ * held.  Returns true if any client queued a frame. */
+static bool fanout_drain(void) {
+    struct fanout_entry entry;
+    bool queued = false;
 
-    zmk_ipc_ZmkEvent ev         = zmk_ipc_ZmkEvent_init_zero;
-    ev.which_payload            = zmk_ipc_ZmkEvent_kscan_event_tag;
-    ev.payload.kscan_event      = kscan;
+    uint32_t lost = (uint32_t)atomic_clear(&fanout_lost);
+    if (lost > 0) {
+        LOG_WRN("IPC observer: %u events lost, fan-out queue full", lost);
+        /* Counting the drops also resyncs keyboard delta subscribers. */
+        clients_count_lost((uint32_t)atomic_clear(&fanout_lost_mask), lost);
+    }
 
-    broadcast_event(&ev);
-    return 0;
+    while (k_msgq_get(&fanout_queue, &entry, K_NO_WAIT) == 0) {
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KSCAN_BATCH)
+        if (!entry.frame) {
+            queued |= kscan_record_send(&entry.kscan);
+            continue;
+        }
+#endif
+        queued |= fanout_frame(entry.frame);
+    }
+    return queued;
 }
 
-ZMK_LISTENER(zmk_ipc_position_listener, ipc_position_listener);
-ZMK_SUBSCRIPTION(zmk_ipc_position_listener, zmk_position_state_changed);
+static void broadcast_event(zmk_ipc_ZmkEvent *event) {
+    event->timestamp = k_uptime_get();
+    event->context   = zmk_context_index();
+
+    struct ipc_frame *frame = encode_event(event);
+    if (frame) {
+        fanout_put(&(struct fanout_entry){.frame = frame});
+    }
+}
 
 /* -------------------------------------------------------------------------
- * Accept thread: blocks on accept(), adds new clients to the list
+ * Writer thread: fans events out to the per-client queues and drains them,
+ * off the event-raising path
  * ------------------------------------------------------------------------- */
 
-static void ipc_accept_thread_func(void *a, void *b, void *c) {
-    LOG_INF("ZMK IPC observer: waiting for clients on %s",
-            CONFIG_ZMK_IPC_OBSERVER_SOCKET_PATH);
+static void ipc_writer_thread_func(void *a, void *b, void *c) {
+    int64_t wait_ms = -1;
 
     for (;;) {
-        int client = accept(server_fd, NULL, NULL);
-        if (client < 0) {
-            if (errno == EINTR) {
-                continue;
-            }
-            LOG_ERR("IPC observer: accept() failed (errno=%d)", errno);
-            k_sleep(K_MSEC(100));
-            continue;
-        }
+        k_sem_take(&writer_sem, wait_ms < 0 ? K_FOREVER : K_MSEC(wait_ms));
 
-        LOG_INF("IPC observer: client connected (fd=%d)", client);
-
-        bool accepted = false;
+        bool backlog = false;
         k_mutex_lock(&clients_mutex, K_FOREVER);
+        fanout_drain();
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KSCAN_BATCH)
+        wait_ms = kscan_batch_flush_due();
+#else
+        wait_ms = -1;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_INPUT_CREDITS)
+        int64_t credits_wait_ms = input_credits_send();
+        if (credits_wait_ms >= 0) {
+            wait_ms = wait_ms < 0 ? credits_wait_ms : MIN(wait_ms, credits_wait_ms);
+        }
+#endif
         for (int i = 0; i < MAX_CLIENTS; i++) {
-            if (client_fds[i] < 0) {
-                client_fds[i] = client;
-                accepted = true;
-                break;
+            struct ipc_client *client = &clients[i];
+
+            if (client->fd < 0 || client->count == 0) {
+                continue;
+            }
+
+            int ret = client_flush(client);
+            if (ret == -EAGAIN) {
+                backlog = true;
+            } else if (ret < 0) {
+                LOG_DBG("IPC observer: client fd[%d] dropped (err %d, %u frames lost)", i,
+                        ret, client->dropped);
+                client_close(client);
             }
         }
         k_mutex_unlock(&clients_mutex);
 
-        if (!accepted) {
-            LOG_WRN("IPC observer: max clients (%d) reached, rejecting", MAX_CLIENTS);
-            close(client);
+        if (backlog) {
+            wait_ms = wait_ms < 0 ? CONFIG_ZMK_IPC_OBSERVER_WRITER_RETRY_MS
+                                  : MIN(wait_ms, CONFIG_ZMK_IPC_OBSERVER_WRITER_RETRY_MS);
         }
     }
 }
 
-K_THREAD_DEFINE(zmk_ipc_accept_thread,
-                CONFIG_ZMK_IPC_OBSERVER_THREAD_STACK_SIZE,
-                ipc_accept_thread_func,
+K_THREAD_DEFINE(zmk_ipc_writer_thread,
+                CONFIG_ZMK_IPC_OBSERVER_WRITER_THREAD_STACK_SIZE,
+                ipc_writer_thread_func,
                 NULL, NULL, NULL,
                 K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
 
 /* -------------------------------------------------------------------------
- * Initialisation
+ * Build Endpoint sub-message from an endpoint instance
  * ------------------------------------------------------------------------- */
 
-static int ipc_observer_init(void) {
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        client_fds[i] = -1;
+static zmk_ipc_Endpoint endpoint_from_instance(const struct zmk_endpoint_instance *endpoint) {
+    zmk_ipc_Endpoint ep = zmk_ipc_Endpoint_init_zero;
+
+    switch (endpoint->transport) {
+    case ZMK_TRANSPORT_USB:
+        ep.transport = zmk_ipc_TransportType_TRANSPORT_USB;
+        break;
+    case ZMK_TRANSPORT_BLE:
+        ep.transport        = zmk_ipc_TransportType_TRANSPORT_BLE;
+        ep.ble_profile_idx  = endpoint->ble.profile_index;
+        break;
+    default:
+        ep.transport = zmk_ipc_TransportType_TRANSPORT_NONE;
+        break;
+    }
+
+    return ep;
+}
+
+static struct zmk_endpoint_instance instance_from_endpoint(const zmk_ipc_Endpoint *ep) {
+    struct zmk_endpoint_instance endpoint = {.transport = ZMK_TRANSPORT_NONE};
+
+    switch (ep->transport) {
+    case zmk_ipc_TransportType_TRANSPORT_USB:
+        endpoint.transport = ZMK_TRANSPORT_USB;
+        break;
+    case zmk_ipc_TransportType_TRANSPORT_BLE:
+        endpoint.transport         = ZMK_TRANSPORT_BLE;
+        endpoint.ble.profile_index = ep->ble_profile_idx;
+        break;
+    default:
+        break;
+    }
+
+    return endpoint;
+}
+
+/* -------------------------------------------------------------------------
+ * Latency tracing
+ *
+ * Traces are recorded per key position at kscan callback time (kscan IPC
+ * thread) and promoted to the single pending trace when that position's
+ * event is raised (system work queue).  The next keyboard report consumes
+ * the pending trace.
+ * ------------------------------------------------------------------------- */
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_LATENCY_TRACE)
+
+static struct k_spinlock trace_lock;
+static zmk_ipc_LatencyTrace position_traces[ZMK_KEYMAP_LEN];
+static zmk_ipc_LatencyTrace pending_trace;
+static bool has_pending_trace;
+
+static inline int64_t trace_now_us(void) { return k_ticks_to_us_floor64(k_uptime_ticks()); }
+
+void zmk_ipc_observer_trace_kscan(uint32_t row, uint32_t col, uint32_t seq, uint64_t client_ts) {
+    if (seq == 0) {
+        return;
     }
 
-    server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
-    if (server_fd < 0) {
-        LOG_ERR("IPC observer: socket() failed (errno=%d)", errno);
-        return -errno;
+    struct zmk_physical_layout const *const *layouts;
+    size_t layouts_len = zmk_physical_layouts_get_list(&layouts);
+    int selected = zmk_physical_layouts_get_selected();
+    if (selected < 0 || (size_t)selected >= layouts_len) {
+        return;
     }
 
-    struct sockaddr_un addr;
-    memset(&addr, 0, sizeof(addr));
-    addr.sun_family = AF_UNIX;
-    strncpy(addr.sun_path, CONFIG_ZMK_IPC_OBSERVER_SOCKET_PATH,
-            sizeof(addr.sun_path) - 1);
+    int32_t position =
+        zmk_matrix_transform_row_column_to_position(layouts[selected]->matrix_transform, row, col);
+    if (position < 0) {
+        return;
+    }
+
+    zmk_ipc_observer_trace_position(position, seq, client_ts);
+}
+
+void zmk_ipc_observer_trace_position(uint32_t position, uint32_t seq, uint64_t client_ts) {
+    if (seq == 0 || position >= ZMK_KEYMAP_LEN) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&trace_lock);
+    position_traces[position] = (zmk_ipc_LatencyTrace){
+        .seq = seq,
+        .client_ts = client_ts,
+        .kscan_us = trace_now_us(),
+    };
+    k_spin_unlock(&trace_lock, key);
+}
+
+void zmk_ipc_observer_trace_raise(uint32_t position) {
+    if (position >= ZMK_KEYMAP_LEN) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&trace_lock);
+    zmk_ipc_LatencyTrace *trace = &position_traces[position];
+    if (trace->seq != 0) {
+        pending_trace = *trace;
+        pending_trace.raise_us = trace_now_us();
+        has_pending_trace = true;
+        trace->seq = 0;
+    }
+    k_spin_unlock(&trace_lock, key);
+}
+
+static bool take_pending_trace(zmk_ipc_LatencyTrace *out) {
+    k_spinlock_key_t key = k_spin_lock(&trace_lock);
+    bool found = has_pending_trace;
+    if (found) {
+        *out = pending_trace;
+        out->report_us = trace_now_us();
+        has_pending_trace = false;
+    }
+    k_spin_unlock(&trace_lock, key);
+
+    return found;
+}
 
-    unlink(CONFIG_ZMK_IPC_OBSERVER_SOCKET_PATH);
+#endif /* IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_LATENCY_TRACE) */
+
+/* -------------------------------------------------------------------------
+ * Public notification functions (called from endpoints.c)
+ * ------------------------------------------------------------------------- */
+
+/* The HID reports as last built, shared by the notifications and the state
+ * snapshot; they leave the latency trace alone. */
+static void fill_keyboard_report(zmk_ipc_HidKeyboardReport *kb,
+                                 const struct zmk_endpoint_instance *endpoint) {
+    kb->has_endpoint  = true;
+    kb->endpoint      = endpoint_from_instance(endpoint);
+
+#if IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT)
+    if (zmk_endpoint_get_keyboard_report_format(*endpoint) ==
+        ZMK_HID_KEYBOARD_REPORT_FORMAT_BOOT) {
+        zmk_hid_boot_report_t *boot_report = zmk_hid_get_boot_report();
+
+        kb->format    = zmk_ipc_KeyboardReportFormat_KEYBOARD_REPORT_FORMAT_BOOT;
+        kb->modifiers = boot_report->modifiers;
+        kb->keys.size = (pb_size_t)sizeof(boot_report->keys);
+        memcpy(kb->keys.bytes, boot_report->keys, kb->keys.size);
+    } else
+#endif /* IS_ENABLED(CONFIG_ZMK_HID_BOOT_REPORT) */
+    {
+        struct zmk_hid_keyboard_report *report = zmk_hid_get_keyboard_report();
+        const size_t keys_size = sizeof(report->body.keys);
+
+        kb->modifiers = report->body.modifiers;
+        kb->keys.size = (pb_size_t)MIN(keys_size, sizeof(kb->keys.bytes));
+        memcpy(kb->keys.bytes, report->body.keys, kb->keys.size);
+    }
+}
+
+static void fill_consumer_report(zmk_ipc_HidConsumerReport *cr,
+                                 const struct zmk_endpoint_instance *endpoint) {
+    struct zmk_hid_consumer_report *report = zmk_hid_get_consumer_report();
+    const size_t keys_size = sizeof(report->body.keys);
+
+    cr->has_endpoint  = true;
+    cr->endpoint      = endpoint_from_instance(endpoint);
+    cr->keys.size     = (pb_size_t)MIN(keys_size, sizeof(cr->keys.bytes));
+    memcpy(cr->keys.bytes, report->body.keys, cr->keys.size);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+static void fill_mouse_report(zmk_ipc_HidMouseReport *mr,
+                              const struct zmk_endpoint_instance *endpoint) {
+    struct zmk_hid_mouse_report *report = zmk_hid_get_mouse_report();
+
+    mr->has_endpoint  = true;
+    mr->endpoint      = endpoint_from_instance(endpoint);
+    mr->buttons       = report->body.buttons;
+    mr->dx            = report->body.d_x;
+    mr->dy            = report->body.d_y;
+    mr->scroll_x      = report->body.d_scroll_x;
+    mr->scroll_y      = report->body.d_scroll_y;
+}
+#endif /* IS_ENABLED(CONFIG_ZMK_POINTING) */
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYBOARD_DELTA)
+
+#define DELTA_KEYS_BYTES 32
+
+/* Usages held in the last report sent as a delta, one bit per usage ID, and
+ * the delta count; only touched by the thread sending keyboard reports. */
+static uint8_t delta_keys[DELTA_KEYS_BYTES];
+static uint32_t delta_seq;
+static uint32_t deltas_since_keyframe;
+
+/* The usages held in a report, as a bitmap whatever the report layout. */
+static void report_keys_bitmap(const zmk_ipc_HidKeyboardReport *kb,
+                               uint8_t bitmap[DELTA_KEYS_BYTES]) {
+    memset(bitmap, 0, DELTA_KEYS_BYTES);
+
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_NKRO)
+    if (kb->format == zmk_ipc_KeyboardReportFormat_KEYBOARD_REPORT_FORMAT_NATIVE) {
+        memcpy(bitmap, kb->keys.bytes, MIN(kb->keys.size, DELTA_KEYS_BYTES));
+        return;
+    }
+#endif
+
+    for (pb_size_t i = 0; i < kb->keys.size; i++) {
+        if (kb->keys.bytes[i]) {
+            WRITE_BIT(bitmap[kb->keys.bytes[i] / 8], kb->keys.bytes[i] % 8, true);
+        }
+    }
+}
+
+static void append_usages(pb_byte_t *list, pb_size_t *size, size_t capacity, int byte,
+                          uint8_t bits) {
+    for (; bits; bits &= bits - 1) {
+        if (*size == capacity) {
+            LOG_WRN("IPC observer: too many usage changes for one keyboard delta");
+            return;
+        }
+        list[(*size)++] = (pb_byte_t)(byte * 8 + __builtin_ctz(bits));
+    }
+}
+
+static void broadcast_keyboard_delta(const zmk_ipc_HidKeyboardReport *kb) {
+    uint8_t keys[DELTA_KEYS_BYTES];
+    report_keys_bitmap(kb, keys);
+
+    zmk_ipc_ZmkEvent ev = zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload = zmk_ipc_ZmkEvent_keyboard_delta_tag;
+
+    zmk_ipc_HidKeyboardDelta *delta = &ev.payload.keyboard_delta;
+    delta->seq       = ++delta_seq;
+    delta->modifiers = kb->modifiers;
+    delta->keyframe  = atomic_clear(&keyframe_due) ||
+                      (CONFIG_ZMK_IPC_OBSERVER_KEYFRAME_INTERVAL > 0 &&
+                       ++deltas_since_keyframe >= CONFIG_ZMK_IPC_OBSERVER_KEYFRAME_INTERVAL);
+    if (delta->keyframe) {
+        deltas_since_keyframe = 0;
+    }
+
+    for (int byte = 0; byte < DELTA_KEYS_BYTES; byte++) {
+        const uint8_t held = delta->keyframe ? 0 : delta_keys[byte];
+
+        append_usages(delta->pressed.bytes, &delta->pressed.size, sizeof(delta->pressed.bytes),
+                      byte, keys[byte] & ~held);
+        append_usages(delta->released.bytes, &delta->released.size,
+                      sizeof(delta->released.bytes), byte, held & ~keys[byte]);
+    }
+    memcpy(delta_keys, keys, sizeof(delta_keys));
+
+    broadcast_event(&ev);
+}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYBOARD_DELTA) */
+
+void zmk_ipc_observer_notify_keyboard_report(const struct zmk_endpoint_instance *endpoint) {
+    zmk_ipc_HidKeyboardReport kb = zmk_ipc_HidKeyboardReport_init_zero;
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_LATENCY_TRACE)
+    /* Consume the trace even if nobody is listening, so it is never attached
+     * to an unrelated later report. */
+    kb.has_trace = take_pending_trace(&kb.trace);
+#endif
+
+    const bool full = event_wanted(zmk_ipc_ZmkEvent_keyboard_tag);
+    const bool delta = IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYBOARD_DELTA) &&
+                       event_wanted(zmk_ipc_ZmkEvent_keyboard_delta_tag);
+    if (!full && !delta) {
+        return;
+    }
+
+    fill_keyboard_report(&kb, endpoint);
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYBOARD_DELTA)
+    if (delta) {
+        broadcast_keyboard_delta(&kb);
+    }
+#endif
+
+    if (!full) {
+        return;
+    }
+
+    zmk_ipc_ZmkEvent ev     = zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload        = zmk_ipc_ZmkEvent_keyboard_tag;
+    ev.payload.keyboard     = kb;
+
+    broadcast_event(&ev);
+}
+
+void zmk_ipc_observer_notify_consumer_report(const struct zmk_endpoint_instance *endpoint) {
+    if (!event_wanted(zmk_ipc_ZmkEvent_consumer_tag)) {
+        return;
+    }
+
+    zmk_ipc_ZmkEvent ev     = zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload        = zmk_ipc_ZmkEvent_consumer_tag;
+    fill_consumer_report(&ev.payload.consumer, endpoint);
+
+    broadcast_event(&ev);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+void zmk_ipc_observer_notify_mouse_report(const struct zmk_endpoint_instance *endpoint) {
+    if (!event_wanted(zmk_ipc_ZmkEvent_mouse_tag)) {
+        return;
+    }
+
+    zmk_ipc_ZmkEvent ev  = zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload     = zmk_ipc_ZmkEvent_mouse_tag;
+    fill_mouse_report(&ev.payload.mouse, endpoint);
+
+    broadcast_event(&ev);
+}
+#endif /* IS_ENABLED(CONFIG_ZMK_POINTING) */
+
+/* -------------------------------------------------------------------------
+ * keyscan (position_state_changed) event listener
+ * ------------------------------------------------------------------------- */
+
+static int ipc_position_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *pos = as_zmk_position_state_changed(eh);
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KSCAN_BATCH)
+    /* Only record the event here; the writer thread encodes it. */
+    if (!pos || !(event_wanted(zmk_ipc_ZmkEvent_kscan_event_tag) ||
+                  event_wanted(zmk_ipc_ZmkEvent_kscan_batch_tag))) {
+        return 0;
+    }
+
+    fanout_put(&(struct fanout_entry){
+        .kscan =
+            {
+                .timestamp = pos->timestamp,
+                .position  = pos->position,
+                .source    = pos->source,
+                .context   = pos->context,
+                .pressed   = pos->state,
+            },
+    });
+    return 0;
+#else
+    if (!pos || !event_wanted(zmk_ipc_ZmkEvent_kscan_event_tag)) {
+        return 0;
+    }
+
+    zmk_ipc_KscanEvent kscan = zmk_ipc_KscanEvent_init_zero;
+    kscan.source    = pos->source;
+    kscan.position  = pos->position;
+    kscan.pressed   = pos->state;
+    kscan.timestamp = pos->timestamp;
+    kscan.context   = pos->context;
+
+    zmk_ipc_ZmkEvent ev         = zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload            = zmk_ipc_ZmkEvent_kscan_event_tag;
+    ev.payload.kscan_event      = kscan;
+
+    broadcast_event(&ev);
+    return 0;
+#endif
+}
+
+ZMK_LISTENER(zmk_ipc_position_listener, ipc_position_listener);
+ZMK_SUBSCRIPTION(zmk_ipc_position_listener, zmk_position_state_changed);
+
+/* -------------------------------------------------------------------------
+ * Layer state event listener
+ * ------------------------------------------------------------------------- */
+
+static int ipc_layer_listener(const zmk_event_t *eh) {
+    const struct zmk_layer_state_changed *ls = as_zmk_layer_state_changed(eh);
+    if (!ls || !event_wanted(zmk_ipc_ZmkEvent_layer_state_tag)) {
+        return 0;
+    }
+
+    /* A change of only the lock of a layer isn't reported. */
+    if (ls->old_layers_state == ls->layers_state) {
+        return 0;
+    }
+
+    zmk_ipc_ZmkEvent ev            = zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload               = zmk_ipc_ZmkEvent_layer_state_tag;
+    ev.payload.layer_state.layer   = ls->layer;
+    ev.payload.layer_state.active  = ls->state;
+
+    broadcast_event(&ev);
+    return 0;
+}
+
+ZMK_LISTENER(zmk_ipc_layer_listener, ipc_layer_listener);
+ZMK_SUBSCRIPTION(zmk_ipc_layer_listener, zmk_layer_state_changed);
+
+/* -------------------------------------------------------------------------
+ * Modifier and endpoint state event listeners
+ * ------------------------------------------------------------------------- */
+
+static int ipc_modifiers_listener(const zmk_event_t *eh) {
+    const struct zmk_modifiers_state_changed *ms = as_zmk_modifiers_state_changed(eh);
+    if (!ms || !event_wanted(zmk_ipc_ZmkEvent_modifiers_state_tag)) {
+        return 0;
+    }
+
+    zmk_ipc_ZmkEvent ev                           = zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload                              = zmk_ipc_ZmkEvent_modifiers_state_tag;
+    ev.payload.modifiers_state.modifiers          = ms->modifiers;
+    ev.payload.modifiers_state.pressed            = ms->state;
+    ev.payload.modifiers_state.explicit_modifiers = zmk_hid_get_explicit_mods();
+
+    broadcast_event(&ev);
+    return 0;
+}
+
+ZMK_LISTENER(zmk_ipc_modifiers_listener, ipc_modifiers_listener);
+ZMK_SUBSCRIPTION(zmk_ipc_modifiers_listener, zmk_modifiers_state_changed);
+
+static int ipc_endpoint_listener(const zmk_event_t *eh) {
+    const struct zmk_endpoint_changed *ec = as_zmk_endpoint_changed(eh);
+    if (!ec || !event_wanted(zmk_ipc_ZmkEvent_endpoint_changed_tag)) {
+        return 0;
+    }
+
+    zmk_ipc_ZmkEvent ev                       = zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload                          = zmk_ipc_ZmkEvent_endpoint_changed_tag;
+    ev.payload.endpoint_changed.has_endpoint  = true;
+    ev.payload.endpoint_changed.endpoint      = endpoint_from_instance(&ec->endpoint);
+
+    broadcast_event(&ev);
+    return 0;
+}
+
+ZMK_LISTENER(zmk_ipc_endpoint_listener, ipc_endpoint_listener);
+ZMK_SUBSCRIPTION(zmk_ipc_endpoint_listener, zmk_endpoint_changed);
+
+/* -------------------------------------------------------------------------
+ * Event loop handlers: accept new clients and read their control frames.
+ *
+ * The listening socket and every client are served by the shared IPC event
+ * loop (see zmk_ipc_loop.h); all sockets are non-blocking.
+ * ------------------------------------------------------------------------- */
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_STATE_SNAPSHOT)
+/*
+ * Queue the state snapshot for a new client; clients_mutex must be held and
+ * the fan-out queue drained.  Every change after the state is read is then
+ * fanned out to the client behind the snapshot.
+ */
+static bool queue_state_snapshot(struct ipc_client *client) {
+    const struct zmk_endpoint_instance endpoint = zmk_endpoint_get_selected();
+
+    zmk_ipc_ZmkEvent ev = zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload = zmk_ipc_ZmkEvent_state_snapshot_tag;
+
+    zmk_ipc_StateSnapshot *snap = &ev.payload.state_snapshot;
+    snap->layer_state        = zmk_keymap_layer_state();
+    snap->default_layer      = zmk_keymap_layer_default();
+    snap->explicit_modifiers = zmk_hid_get_explicit_mods();
+    snap->has_endpoint       = true;
+    snap->endpoint           = endpoint_from_instance(&endpoint);
+    snap->has_keyboard       = true;
+    fill_keyboard_report(&snap->keyboard, &endpoint);
+    snap->has_consumer       = true;
+    fill_consumer_report(&snap->consumer, &endpoint);
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+    snap->has_mouse          = true;
+    fill_mouse_report(&snap->mouse, &endpoint);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+    snap->battery_level      = zmk_battery_state_of_charge();
+#else
+    snap->battery_level      = -1;
+#endif
+    ev.timestamp = k_uptime_get();
+
+    struct ipc_frame *frame = frame_alloc();
+    if (!frame) {
+        LOG_ERR("IPC observer: frame pool exhausted");
+        return false;
+    }
+
+    size_t frame_len;
+    if (zmk_ipc_encode_event_frame(&ev, frame->data, sizeof(frame->data), &frame_len) != 0) {
+        frame_release(frame);
+        return false;
+    }
+    frame->len = (uint16_t)frame_len;
+
+    bool queued = client_enqueue(client, frame);
+    if (frame->refs == 0) {
+        frame_release(frame);
+    }
+    return queued;
+}
+#endif /* IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_STATE_SNAPSHOT) */
+
+static void client_readable(struct zmk_ipc_loop_source *source);
+
+static void accept_client(struct zmk_ipc_loop_source *source) {
+    int client = zmk_ipc_listener_accept(server_fd);
+    if (client < 0) {
+        if (client != -EAGAIN) {
+            LOG_ERR("IPC observer: accept() failed (err %d)", client);
+        }
+        return;
+    }
+
+#if CONFIG_ZMK_IPC_OBSERVER_SNDBUF_SIZE > 0
+    int sndbuf = CONFIG_ZMK_IPC_OBSERVER_SNDBUF_SIZE;
+
+    if (setsockopt(client, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf)) < 0) {
+        LOG_WRN("IPC observer: can't set SO_SNDBUF to %d (errno=%d)", sndbuf, errno);
+    }
+#endif
+
+    LOG_INF("IPC observer: client connected (fd=%d)", client);
+
+    bool accepted = false;
+    bool full = true;
+    bool queued = false;
+    k_mutex_lock(&clients_mutex, K_FOREVER);
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_STATE_SNAPSHOT)
+    /* Events already raised must not reach the new client ahead of its snapshot. */
+    queued = fanout_drain();
+#endif
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (clients[i].fd < 0) {
+            full = false;
+            if (zmk_ipc_loop_add(&clients[i].source, client, client_readable) < 0) {
+                break; /* already logged inside helper */
+            }
+
+            clients[i].fd          = client;
+            clients[i].event_mask  = EVENT_MASK_ALL;
+            clients[i].head        = 0;
+            clients[i].count       = 0;
+            clients[i].head_sent   = 0;
+            clients[i].high_water  = 0;
+            clients[i].dropped     = 0;
+            clients[i].frames_sent = 0;
+            clients[i].bytes_sent  = 0;
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS)
+            clients[i].packed_requested = false;
+            clients[i].packed           = false;
+#endif
+            zmk_ipc_frame_reader_init(&clients[i].reader, client);
+            update_wanted_mask();
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_STATE_SNAPSHOT)
+            queued |= queue_state_snapshot(&clients[i]);
+#endif
+            accepted = true;
+            break;
+        }
+    }
+    k_mutex_unlock(&clients_mutex);
+
+    if (queued) {
+        k_sem_give(&writer_sem);
+    }
+
+    if (!accepted) {
+        if (full) {
+            LOG_WRN("IPC observer: max clients (%d) reached, rejecting", MAX_CLIENTS);
+        }
+        close(client);
+    }
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_DRIVER)
+static const struct device *const kscan_ipc_dev =
+    DEVICE_DT_GET(DT_COMPAT_GET_ANY_STATUS_OKAY(zmk_kscan_ipc));
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS) || IS_ENABLED(CONFIG_ZMK_WORK_STATS) ||           \
+    IS_ENABLED(CONFIG_ZMK_THREAD_STACK_STATS)
+/* Progress of a reply of several frames to one client. */
+struct stats_reply {
+    struct ipc_client *client;
+    uint32_t index;
+    uint32_t count;
+};
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+
+static void queue_event_stats(const struct zmk_event_type *type,
+                              const struct zmk_event_stats *stats, void *user_data) {
+    struct stats_reply *reply = user_data;
+
+    /* Once a disconnect-on-overflow policy has closed the client, stop. */
+    if (reply->client->fd < 0) {
+        return;
+    }
+
+    zmk_ipc_ZmkEvent ev = zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload = zmk_ipc_ZmkEvent_event_stats_tag;
+
+    zmk_ipc_EventTypeStats *es = &ev.payload.event_stats;
+    strncpy(es->name, type->name, sizeof(es->name) - 1);
+    es->index             = reply->index++;
+    es->count             = reply->count;
+    es->raised            = stats->raised;
+    es->listeners_invoked = stats->listeners_invoked;
+    es->captured          = stats->captured;
+    es->cycles            = stats->cycles;
+    es->cycles_per_sec    = (uint32_t)sys_clock_hw_cycles_per_sec();
+
+    struct ipc_frame *frame = frame_alloc();
+    if (!frame) {
+        LOG_ERR("IPC observer: frame pool exhausted");
+        return;
+    }
+
+    size_t frame_len;
+    if (zmk_ipc_encode_event_frame(&ev, frame->data, sizeof(frame->data), &frame_len) != 0) {
+        frame_release(frame);
+        return;
+    }
+    frame->len = (uint16_t)frame_len;
+
+    client_enqueue(reply->client, frame);
+    if (frame->refs == 0) {
+        frame_release(frame);
+    }
+}
+
+/* Queue the event manager's counters for one client, bypassing its mask. */
+static void send_event_stats(struct ipc_client *client) {
+    struct stats_reply reply = {
+        .client = client,
+        .count = (uint32_t)zmk_event_manager_stats_foreach(NULL, NULL),
+    };
+
+    zmk_event_manager_stats_foreach(queue_event_stats, &reply);
+    k_sem_give(&writer_sem);
+}
+#endif /* IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS) */
+
+#if IS_ENABLED(CONFIG_ZMK_STAGE_TIMING)
+/* Queue the stage histograms for one client, bypassing its mask. */
+static void send_stage_timings(struct ipc_client *client) {
+    for (int stage = 0; stage < ZMK_STAGE_COUNT && client->fd >= 0; stage++) {
+        struct zmk_stage_timing timing;
+        zmk_stage_timing_get(stage, &timing);
+
+        zmk_ipc_ZmkEvent ev = zmk_ipc_ZmkEvent_init_zero;
+        ev.which_payload = zmk_ipc_ZmkEvent_stage_timing_tag;
+
+        zmk_ipc_StageTiming *st = &ev.payload.stage_timing;
+        strncpy(st->name, zmk_stage_timing_name(stage), sizeof(st->name) - 1);
+        st->index          = stage;
+        st->count          = ZMK_STAGE_COUNT;
+        st->samples        = timing.samples;
+        st->total_cycles   = timing.total_cycles;
+        st->max_cycles     = timing.max_cycles;
+        st->buckets_count  = ZMK_STAGE_TIMING_BUCKETS;
+        memcpy(st->buckets, timing.buckets, sizeof(st->buckets));
+        st->cycles_per_sec = (uint32_t)sys_clock_hw_cycles_per_sec();
+
+        struct ipc_frame *frame = frame_alloc();
+        if (!frame) {
+            LOG_ERR("IPC observer: frame pool exhausted");
+            break;
+        }
+
+        size_t frame_len;
+        if (zmk_ipc_encode_event_frame(&ev, frame->data, sizeof(frame->data), &frame_len) != 0) {
+            frame_release(frame);
+            break;
+        }
+        frame->len = (uint16_t)frame_len;
+
+        client_enqueue(client, frame);
+        if (frame->refs == 0) {
+            frame_release(frame);
+        }
+    }
+
+    k_sem_give(&writer_sem);
+}
+#endif /* IS_ENABLED(CONFIG_ZMK_STAGE_TIMING) */
+
+#if IS_ENABLED(CONFIG_ZMK_WORK_STATS)
+static void queue_work_stats(const struct zmk_work_stats *stats, void *user_data) {
+    struct stats_reply *reply = user_data;
+
+    if (reply->client->fd < 0) {
+        return;
+    }
+
+    zmk_ipc_ZmkEvent ev = zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload = zmk_ipc_ZmkEvent_work_stats_tag;
+
+    zmk_ipc_WorkStats *ws = &ev.payload.work_stats;
+    strncpy(ws->name, stats->name, sizeof(ws->name) - 1);
+    ws->index                = reply->index++;
+    ws->count                = reply->count;
+    ws->submitted            = stats->submitted;
+    ws->runs                 = stats->runs;
+    ws->total_latency_cycles = stats->total_latency_cycles;
+    ws->max_latency_cycles   = stats->max_latency_cycles;
+    ws->total_run_cycles     = stats->total_run_cycles;
+    ws->max_run_cycles       = stats->max_run_cycles;
+    ws->queue_capacity       = stats->queue_capacity;
+    ws->queue_high_water     = stats->queue_high_water;
+    ws->cycles_per_sec       = (uint32_t)sys_clock_hw_cycles_per_sec();
+
+    struct ipc_frame *frame = frame_alloc();
+    if (!frame) {
+        LOG_ERR("IPC observer: frame pool exhausted");
+        return;
+    }
+
+    size_t frame_len;
+    if (zmk_ipc_encode_event_frame(&ev, frame->data, sizeof(frame->data), &frame_len) != 0) {
+        frame_release(frame);
+        return;
+    }
+    frame->len = (uint16_t)frame_len;
+
+    client_enqueue(reply->client, frame);
+    if (frame->refs == 0) {
+        frame_release(frame);
+    }
+}
+
+/* Queue the work item counters for one client, bypassing its mask. */
+static void send_work_stats(struct ipc_client *client) {
+    struct stats_reply reply = {
+        .client = client,
+        .count = (uint32_t)zmk_work_stats_foreach(NULL, NULL),
+    };
+
+    zmk_work_stats_foreach(queue_work_stats, &reply);
+    k_sem_give(&writer_sem);
+}
+#endif /* IS_ENABLED(CONFIG_ZMK_WORK_STATS) */
+
+#if IS_ENABLED(CONFIG_ZMK_THREAD_STACK_STATS)
+static void count_thread(const struct k_thread *thread, void *user_data) {
+    (*(uint32_t *)user_data)++;
+}
+
+static void queue_thread_stack(const struct k_thread *thread, void *user_data) {
+    struct stats_reply *reply = user_data;
+
+    if (reply->client->fd < 0) {
+        return;
+    }
+
+    zmk_ipc_ZmkEvent ev = zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload = zmk_ipc_ZmkEvent_thread_stack_tag;
+
+    zmk_ipc_ThreadStack *ts = &ev.payload.thread_stack;
+    const char *name = k_thread_name_get((k_tid_t)thread);
+    if (name && name[0]) {
+        strncpy(ts->name, name, sizeof(ts->name) - 1);
+    } else {
+        snprintf(ts->name, sizeof(ts->name), "%p", (void *)thread);
+    }
+    ts->index      = reply->index++;
+    ts->count      = reply->count;
+    ts->stack_size = thread->stack_info.size;
+
+    /* Walks the stack up to the deepest byte the thread has overwritten. */
+    size_t unused;
+    if (k_thread_stack_space_get(thread, &unused) == 0) {
+        ts->stack_used = thread->stack_info.size - unused;
+    }
+
+    struct ipc_frame *frame = frame_alloc();
+    if (!frame) {
+        LOG_ERR("IPC observer: frame pool exhausted");
+        return;
+    }
+
+    size_t frame_len;
+    if (zmk_ipc_encode_event_frame(&ev, frame->data, sizeof(frame->data), &frame_len) != 0) {
+        frame_release(frame);
+        return;
+    }
+    frame->len = (uint16_t)frame_len;
+
+    client_enqueue(reply->client, frame);
+    if (frame->refs == 0) {
+        frame_release(frame);
+    }
+}
+
+/* Queue the stack use of every thread for one client, bypassing its mask. */
+static void send_thread_stacks(struct ipc_client *client) {
+    struct stats_reply reply = {
+        .client = client,
+    };
+
+    k_thread_foreach_unlocked(count_thread, &reply.count);
+    k_thread_foreach_unlocked(queue_thread_stack, &reply);
+    k_sem_give(&writer_sem);
+}
+#endif /* IS_ENABLED(CONFIG_ZMK_THREAD_STACK_STATS) */
+
+static void fill_client_stats(zmk_ipc_ClientStats *cs, const struct ipc_client *client) {
+    cs->frames_sent      = client->frames_sent;
+    cs->bytes_sent       = client->bytes_sent;
+    cs->frames_dropped   = client->dropped;
+    cs->queue_depth      = client->count;
+    cs->queue_high_water = client->high_water;
+    cs->queue_capacity   = QUEUE_DEPTH;
+
+    int sndbuf;
+    socklen_t len = sizeof(sndbuf);
+    if (getsockopt(client->fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, &len) == 0) {
+        cs->sndbuf_size = sndbuf;
+    }
+
+    int queued;
+    if (ioctl(client->fd, SIOCOUTQ, &queued) == 0) {
+        cs->sndbuf_used = queued;
+    }
+}
+
+/* Queue the counters of every connection for one client, bypassing its mask;
+ * clients_mutex must be held. */
+static void send_client_stats(struct ipc_client *client) {
+    uint32_t count = 0;
+    uint32_t index = 0;
+
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        count += clients[i].fd >= 0;
+    }
+
+    /* Once a disconnect-on-overflow policy has closed the client, stop. */
+    for (int i = 0; i < MAX_CLIENTS && client->fd >= 0; i++) {
+        if (clients[i].fd < 0) {
+            continue;
+        }
+
+        zmk_ipc_ZmkEvent ev = zmk_ipc_ZmkEvent_init_zero;
+        ev.which_payload = zmk_ipc_ZmkEvent_client_stats_tag;
+
+        zmk_ipc_ClientStats *cs = &ev.payload.client_stats;
+        cs->index     = index++;
+        cs->count     = count;
+        cs->requester = &clients[i] == client;
+        fill_client_stats(cs, &clients[i]);
+
+        struct ipc_frame *frame = frame_alloc();
+        if (!frame) {
+            LOG_ERR("IPC observer: frame pool exhausted");
+            break;
+        }
+
+        size_t frame_len;
+        if (zmk_ipc_encode_event_frame(&ev, frame->data, sizeof(frame->data), &frame_len) != 0) {
+            frame_release(frame);
+            break;
+        }
+        frame->len = (uint16_t)frame_len;
+
+        client_enqueue(client, frame);
+        if (frame->refs == 0) {
+            frame_release(frame);
+        }
+    }
+
+    k_sem_give(&writer_sem);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYMAP) ||                                                  \
+    IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_CHECKPOINT) || IS_ENABLED(CONFIG_ZMK_KEY_STATS)
+/*
+ * Queue a reply frame for a client; clients_mutex must be held.  Replies
+ * were asked for, so they bypass the overflow policy: while the client's
+ * queue is full the writer is kicked and the mutex released until it has
+ * made room.  Returns false if the client disconnected in the meantime.
+ */
+static bool client_enqueue_reply(struct ipc_client *client, const zmk_ipc_ZmkEvent *ev) {
+    const int fd = client->fd;
+
+    while (client->count == QUEUE_DEPTH) {
+        k_sem_give(&writer_sem);
+        k_mutex_unlock(&clients_mutex);
+        k_sleep(K_MSEC(CONFIG_ZMK_IPC_OBSERVER_WRITER_RETRY_MS));
+        k_mutex_lock(&clients_mutex, K_FOREVER);
+
+        if (client->fd != fd) {
+            return false;
+        }
+    }
+
+    struct ipc_frame *frame = frame_alloc();
+    if (!frame) {
+        LOG_ERR("IPC observer: frame pool exhausted");
+        return false;
+    }
+
+    size_t frame_len;
+    if (zmk_ipc_encode_event_frame(ev, frame->data, sizeof(frame->data), &frame_len) != 0) {
+        frame_release(frame);
+        return false;
+    }
+    frame->len = (uint16_t)frame_len;
+
+    return client_enqueue(client, frame);
+}
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_KEY_STATS)
+/* Queue one KeyStats frame for a client; position -1 is the intervals. */
+static bool queue_key_stats(struct ipc_client *client, int32_t position,
+                            const struct zmk_key_stats *stats, uint32_t index, uint32_t count) {
+    static zmk_ipc_ZmkEvent ev;
+
+    ev = (zmk_ipc_ZmkEvent)zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload = zmk_ipc_ZmkEvent_key_stats_tag;
+
+    zmk_ipc_KeyStats *ks = &ev.payload.key_stats;
+    ks->index         = index;
+    ks->count         = count;
+    ks->position      = position;
+    ks->samples       = stats->samples;
+    ks->max_ms        = stats->max_ms;
+    ks->buckets_count = ZMK_KEY_STATS_BUCKETS;
+    memcpy(ks->buckets, stats->buckets, sizeof(ks->buckets));
+    ks->holds         = stats->holds;
+    ks->taps          = stats->taps;
+    ks->retro_taps    = stats->retro_taps;
+
+    return client_enqueue_reply(client, &ev);
+}
+
+static bool key_stats_used(uint32_t position, struct zmk_key_stats *stats) {
+    zmk_key_stats_get(position, stats);
+    return stats->samples > 0 || stats->holds > 0 || stats->taps > 0;
+}
+
+/*
+ * Stream the key timing histograms to one client, bypassing its mask: the
+ * intervals first, then the positions that have any samples.
+ */
+static void send_key_stats(struct ipc_client *client) {
+    struct zmk_key_stats stats;
+    uint32_t count = 1;
+
+    for (uint32_t position = 0; position < ZMK_KEYMAP_LEN; position++) {
+        count += key_stats_used(position, &stats);
+    }
+
+    zmk_key_stats_get_intervals(&stats);
+    bool sent = queue_key_stats(client, -1, &stats, 0, count);
+
+    for (uint32_t position = 0, index = 1; position < ZMK_KEYMAP_LEN && sent && index < count;
+         position++) {
+        if (key_stats_used(position, &stats)) {
+            sent = queue_key_stats(client, position, &stats, index++, count);
+        }
+    }
+
+    k_sem_give(&writer_sem);
+}
+#endif /* IS_ENABLED(CONFIG_ZMK_KEY_STATS) */
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYMAP)
+/* End of the range [first, first + count) clipped to limit; count 0 means
+ * "up to limit". */
+static uint32_t keymap_range_end(uint32_t first, uint32_t count, uint32_t limit) {
+    if (first >= limit) {
+        return first;
+    }
+    return (count == 0 || count > limit - first) ? limit : first + count;
+}
+
+static void get_keymap_binding(zmk_ipc_KeymapBinding *out, zmk_keymap_layer_id_t layer_id,
+                               uint16_t position) {
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_PACKED_BINDINGS)
+    struct zmk_keymap_local_binding binding;
+
+    if (zmk_keymap_get_layer_local_binding_at_idx(layer_id, position, &binding) == 0) {
+        out->behavior_id = binding.behavior_local_id;
+        out->param1      = binding.param1;
+        out->param2      = binding.param2;
+    }
+#else
+    const struct zmk_behavior_binding *binding =
+        zmk_keymap_get_layer_binding_at_idx(layer_id, position);
+
+    if (binding && binding->behavior_dev) {
+        out->behavior_id = zmk_behavior_get_local_id(binding->behavior_dev);
+        out->param1      = binding->param1;
+        out->param2      = binding->param2;
+    }
+#endif
+}
+
+#define KEYMAP_RUN_MAX ARRAY_SIZE(((zmk_ipc_KeymapBindings *)NULL)->bindings)
+
+/* Queue one KeymapBindings frame covering [first_position, end) of a layer. */
+static bool queue_keymap_run(struct ipc_client *client, uint32_t layer_id,
+                             uint32_t first_position, uint32_t end, uint32_t index,
+                             uint32_t count) {
+    static zmk_ipc_ZmkEvent ev;
+
+    ev = (zmk_ipc_ZmkEvent)zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload = zmk_ipc_ZmkEvent_keymap_bindings_tag;
+
+    zmk_ipc_KeymapBindings *run = &ev.payload.keymap_bindings;
+    run->layer_id       = layer_id;
+    run->first_position = first_position;
+    run->index          = index;
+    run->count          = count;
+
+    for (uint32_t position = first_position; position < end; position++) {
+        get_keymap_binding(&run->bindings[run->bindings_count++], layer_id, position);
+    }
+
+    return client_enqueue_reply(client, &ev);
+}
+
+/* Stream the requested block of the keymap to one client, bypassing its mask. */
+static void send_keymap_bindings(struct ipc_client *client,
+                                 const zmk_ipc_GetKeymapBindings *req) {
+    const uint32_t layers_end =
+        keymap_range_end(req->first_layer, req->layer_count, ZMK_KEYMAP_LAYERS_LEN);
+    const uint32_t positions_end =
+        keymap_range_end(req->first_position, req->position_count, ZMK_KEYMAP_LEN);
+    const uint32_t runs_per_layer =
+        DIV_ROUND_UP(positions_end - req->first_position, KEYMAP_RUN_MAX);
+    const uint32_t count = (layers_end - req->first_layer) * runs_per_layer;
+    uint32_t index = 0;
+
+    if (count == 0) {
+        /* Still answer, so the client can tell the reply is complete. */
+        if (queue_keymap_run(client, req->first_layer, req->first_position,
+                             req->first_position, 0, 1)) {
+            k_sem_give(&writer_sem);
+        }
+        return;
+    }
+
+    for (uint32_t layer = req->first_layer; layer < layers_end; layer++) {
+        for (uint32_t position = req->first_position; position < positions_end;
+             position += KEYMAP_RUN_MAX) {
+            uint32_t end = MIN(position + KEYMAP_RUN_MAX, positions_end);
+
+            if (!queue_keymap_run(client, layer, position, end, index++, count)) {
+                return;
+            }
+        }
+    }
+
+    k_sem_give(&writer_sem);
+}
+
+static int set_keymap_binding(uint32_t layer_id, uint32_t position,
+                              const zmk_ipc_KeymapBinding *in) {
+    if (layer_id >= ZMK_KEYMAP_LAYERS_LEN || position >= ZMK_KEYMAP_LEN) {
+        return -EINVAL;
+    }
+
+    const char *behavior_name = zmk_behavior_find_behavior_name_from_local_id(in->behavior_id);
+    if (!behavior_name) {
+        return -ENODEV;
+    }
+
+    struct zmk_behavior_binding binding = {
+        .behavior_dev = behavior_name,
+        .param1 = in->param1,
+        .param2 = in->param2,
+    };
+
+    int ret = zmk_behavior_validate_binding(&binding);
+    if (ret < 0) {
+        return ret;
+    }
+
+    return zmk_keymap_set_layer_binding_at_idx(layer_id, position, binding);
+}
+
+/*
+ * Return the keymap to the state it boots in, so a newly loaded keymap isn't
+ * entered on a layer or with keys of the old one.
+ */
+static void reset_keymap_state(void) {
+    zmk_keymap_layer_to(zmk_keymap_layer_default(), true);
+    zmk_endpoint_clear_reports();
+}
+
+/* Apply a block of bindings and report the outcome to the requester. */
+static void apply_keymap_bindings(struct ipc_client *client,
+                                  const zmk_ipc_SetKeymapBindings *req) {
+    static zmk_ipc_ZmkEvent ev;
+
+    ev = (zmk_ipc_ZmkEvent)zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload = zmk_ipc_ZmkEvent_keymap_set_result_tag;
+    zmk_ipc_KeymapSetResult *result = &ev.payload.keymap_set_result;
+
+    if (req->bindings_count > 0 && req->position_count == 0) {
+        result->error = -EINVAL;
+    }
+
+    if (result->error == 0 && req->reset) {
+        reset_keymap_state();
+    }
+
+    for (pb_size_t i = 0; i < req->bindings_count && result->error == 0; i++) {
+        int ret = set_keymap_binding(req->first_layer + i / req->position_count,
+                                     req->first_position + i % req->position_count,
+                                     &req->bindings[i]);
+        if (ret < 0) {
+            LOG_DBG("IPC observer: SetKeymapBindings failed at binding %u (%d)", i, ret);
+            result->error = ret;
+        } else {
+            result->applied++;
+        }
+    }
+
+    if (result->error == 0 && req->save) {
+        result->error = zmk_keymap_save_changes();
+    }
+
+    if (client_enqueue_reply(client, &ev)) {
+        k_sem_give(&writer_sem);
+    }
+}
+#endif /* IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYMAP) */
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_CHECKPOINT)
+/* Write a checkpoint and report the outcome to the requester. */
+static void save_checkpoint(struct ipc_client *client, const zmk_ipc_SaveCheckpoint *req) {
+    static zmk_ipc_ZmkEvent ev;
+
+    ev = (zmk_ipc_ZmkEvent)zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload = zmk_ipc_ZmkEvent_checkpoint_result_tag;
+    ev.payload.checkpoint_result.error =
+        req->path[0] != '\0' ? zmk_checkpoint_save(req->path) : -EINVAL;
+
+    if (client_enqueue_reply(client, &ev)) {
+        k_sem_give(&writer_sem);
+    }
+}
+#endif /* IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_CHECKPOINT) */
+
+static bool is_control_message(const zmk_ipc_ClientMessage *msg) {
+    switch (msg->which_payload) {
+    case zmk_ipc_ClientMessage_subscribe_tag:
+    case zmk_ipc_ClientMessage_get_event_stats_tag:
+    case zmk_ipc_ClientMessage_get_stage_timings_tag:
+    case zmk_ipc_ClientMessage_get_work_stats_tag:
+    case zmk_ipc_ClientMessage_get_thread_stacks_tag:
+    case zmk_ipc_ClientMessage_get_client_stats_tag:
+    case zmk_ipc_ClientMessage_get_keymap_bindings_tag:
+    case zmk_ipc_ClientMessage_set_keymap_bindings_tag:
+    case zmk_ipc_ClientMessage_set_keyboard_report_format_tag:
+    case zmk_ipc_ClientMessage_hello_tag:
+    case zmk_ipc_ClientMessage_save_checkpoint_tag:
+    case zmk_ipc_ClientMessage_get_key_stats_tag:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/* Set a client's event mask; clients_mutex must be held. */
+static void client_subscribe(struct ipc_client *client, uint32_t event_mask) {
+    const uint32_t added = event_mask & ~client->event_mask;
+
+    client->event_mask = event_mask & (EVENT_MASK_ALL | EVENT_MASK_OPT_IN);
+    update_wanted_mask();
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYBOARD_DELTA)
+    /* A new delta subscriber needs a keyframe to apply the deltas to. */
+    if (added & EVENT_BIT(zmk_ipc_ZmkEvent_keyboard_delta_tag)) {
+        atomic_set(&keyframe_due, 1);
+    }
+#endif
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_INPUT_CREDITS)
+    /* A new credits subscriber needs a starting point to count from. */
+    if (added & EVENT_BIT(zmk_ipc_ZmkEvent_input_credits_tag)) {
+        credits_due = true;
+        k_sem_give(&writer_sem);
+    }
+#endif
+    ARG_UNUSED(added);
+}
+
+/* The ZmkEvent payloads this build can send, replies included. */
+static uint32_t capabilities_event_mask(void) {
+    uint32_t mask = EVENT_MASK_ALL | EVENT_MASK_OPT_IN |
+                    EVENT_BIT(zmk_ipc_ZmkEvent_client_stats_tag) |
+                    EVENT_BIT(zmk_ipc_ZmkEvent_capabilities_tag);
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_STATE_SNAPSHOT)
+    mask |= EVENT_BIT(zmk_ipc_ZmkEvent_state_snapshot_tag);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+    mask |= EVENT_BIT(zmk_ipc_ZmkEvent_event_stats_tag);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_STAGE_TIMING)
+    mask |= EVENT_BIT(zmk_ipc_ZmkEvent_stage_timing_tag);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_WORK_STATS)
+    mask |= EVENT_BIT(zmk_ipc_ZmkEvent_work_stats_tag);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_KEY_STATS)
+    mask |= EVENT_BIT(zmk_ipc_ZmkEvent_key_stats_tag);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_THREAD_STACK_STATS)
+    mask |= EVENT_BIT(zmk_ipc_ZmkEvent_thread_stack_tag);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYMAP)
+    mask |= EVENT_BIT(zmk_ipc_ZmkEvent_keymap_bindings_tag) |
+            EVENT_BIT(zmk_ipc_ZmkEvent_keymap_set_result_tag);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_CHECKPOINT)
+    mask |= EVENT_BIT(zmk_ipc_ZmkEvent_checkpoint_result_tag);
+#endif
+    return mask;
+}
+
+/* The ClientMessage payloads the observer socket acts on. */
+static uint32_t capabilities_message_mask(void) {
+    uint32_t mask = BIT(zmk_ipc_ClientMessage_subscribe_tag) |
+                    BIT(zmk_ipc_ClientMessage_get_client_stats_tag) |
+                    BIT(zmk_ipc_ClientMessage_set_keyboard_report_format_tag) |
+                    BIT(zmk_ipc_ClientMessage_hello_tag);
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+    mask |= BIT(zmk_ipc_ClientMessage_get_event_stats_tag);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_STAGE_TIMING)
+    mask |= BIT(zmk_ipc_ClientMessage_get_stage_timings_tag);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_WORK_STATS)
+    mask |= BIT(zmk_ipc_ClientMessage_get_work_stats_tag);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_KEY_STATS)
+    mask |= BIT(zmk_ipc_ClientMessage_get_key_stats_tag);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_THREAD_STACK_STATS)
+    mask |= BIT(zmk_ipc_ClientMessage_get_thread_stacks_tag);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYMAP)
+    mask |= BIT(zmk_ipc_ClientMessage_get_keymap_bindings_tag) |
+            BIT(zmk_ipc_ClientMessage_set_keymap_bindings_tag);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_CHECKPOINT)
+    mask |= BIT(zmk_ipc_ClientMessage_save_checkpoint_tag);
+#endif
+    return mask;
+}
+
+/* Subscribe a client to the payloads it understands, if it said, and queue
+ * the Capabilities reply, bypassing its mask; clients_mutex must be held. */
+static void client_hello(struct ipc_client *client, const zmk_ipc_Hello *hello) {
+    LOG_DBG("IPC observer: Hello from fd=%d, protocol version %u", client->fd,
+            hello->protocol_version);
+
+    if (hello->event_mask != 0) {
+        client_subscribe(client, hello->event_mask);
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS)
+    /* Takes effect at the client's next frame boundary; events encoded
+     * while no client wanted packed frames stay protobuf. */
+    client->packed_requested = hello->packed_events;
+    update_wanted_mask();
+#endif
+
+    zmk_ipc_ZmkEvent ev = zmk_ipc_ZmkEvent_init_zero;
+    ev.which_payload = zmk_ipc_ZmkEvent_capabilities_tag;
+
+    zmk_ipc_Capabilities *caps = &ev.payload.capabilities;
+    caps->protocol_version  = ZMK_IPC_PROTOCOL_VERSION;
+    caps->max_event_frame   = ZMK_IPC_EVENT_FRAME_MAX;
+    caps->max_message_frame = ZMK_IPC_MSG_FRAME_MAX;
+    caps->event_mask        = capabilities_event_mask();
+    caps->message_mask      = capabilities_message_mask();
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS)
+    caps->packed_version    = ZMK_IPC_PACKED_VERSION;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_DRIVER)
+    /* Key input is only dispatched with CONFIG_ZMK_IPC_OBSERVER_CONNECT, but
+     * the matrix size is worth knowing either way. */
+    zmk_ipc_Capabilities kscan_caps = zmk_ipc_Capabilities_init_zero;
+
+    zmk_kscan_ipc_fill_capabilities(kscan_ipc_dev, &kscan_caps);
+    caps->rows    = kscan_caps.rows;
+    caps->columns = kscan_caps.columns;
+    if (IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_CONNECT)) {
+        caps->message_mask |= kscan_caps.message_mask;
+    }
+#endif
+
+    struct ipc_frame *frame = frame_alloc();
+    if (!frame) {
+        LOG_ERR("IPC observer: frame pool exhausted");
+        return;
+    }
+
+    size_t frame_len;
+    if (zmk_ipc_encode_event_frame(&ev, frame->data, sizeof(frame->data), &frame_len) != 0) {
+        frame_release(frame);
+        return;
+    }
+    frame->len = (uint16_t)frame_len;
+
+    client_enqueue(client, frame);
+    if (frame->refs == 0) {
+        frame_release(frame);
+    }
+    k_sem_give(&writer_sem);
+}
+
+/* Apply a control message; clients_mutex must be held. */
+static void handle_control_message(struct ipc_client *client, const zmk_ipc_ClientMessage *msg) {
+    switch (msg->which_payload) {
+    case zmk_ipc_ClientMessage_subscribe_tag:
+        client_subscribe(client, msg->payload.subscribe.event_mask);
+        LOG_DBG("IPC observer: fd=%d subscribed to mask 0x%02x", client->fd, client->event_mask);
+        break;
+    case zmk_ipc_ClientMessage_get_event_stats_tag:
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_STATS)
+        send_event_stats(client);
+#else
+        LOG_DBG("IPC observer: GetEventStats needs CONFIG_ZMK_EVENT_MANAGER_STATS");
+#endif
+        break;
+    case zmk_ipc_ClientMessage_get_stage_timings_tag:
+#if IS_ENABLED(CONFIG_ZMK_STAGE_TIMING)
+        send_stage_timings(client);
+#else
+        LOG_DBG("IPC observer: GetStageTimings needs CONFIG_ZMK_STAGE_TIMING");
+#endif
+        break;
+    case zmk_ipc_ClientMessage_get_work_stats_tag:
+#if IS_ENABLED(CONFIG_ZMK_WORK_STATS)
+        send_work_stats(client);
+#else
+        LOG_DBG("IPC observer: GetWorkStats needs CONFIG_ZMK_WORK_STATS");
+#endif
+        break;
+    case zmk_ipc_ClientMessage_get_key_stats_tag:
+#if IS_ENABLED(CONFIG_ZMK_KEY_STATS)
+        send_key_stats(client);
+#else
+        LOG_DBG("IPC observer: GetKeyStats needs CONFIG_ZMK_KEY_STATS");
+#endif
+        break;
+    case zmk_ipc_ClientMessage_get_thread_stacks_tag:
+#if IS_ENABLED(CONFIG_ZMK_THREAD_STACK_STATS)
+        send_thread_stacks(client);
+#else
+        LOG_DBG("IPC observer: GetThreadStacks needs CONFIG_ZMK_THREAD_STACK_STATS");
+#endif
+        break;
+    case zmk_ipc_ClientMessage_get_client_stats_tag:
+        send_client_stats(client);
+        break;
+    case zmk_ipc_ClientMessage_hello_tag:
+        client_hello(client, &msg->payload.hello);
+        break;
+    case zmk_ipc_ClientMessage_get_keymap_bindings_tag:
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYMAP)
+        send_keymap_bindings(client, &msg->payload.get_keymap_bindings);
+#else
+        LOG_DBG("IPC observer: GetKeymapBindings needs CONFIG_ZMK_IPC_OBSERVER_KEYMAP");
+#endif
+        break;
+    case zmk_ipc_ClientMessage_set_keymap_bindings_tag:
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_KEYMAP)
+        apply_keymap_bindings(client, &msg->payload.set_keymap_bindings);
+#else
+        LOG_DBG("IPC observer: SetKeymapBindings needs CONFIG_ZMK_IPC_OBSERVER_KEYMAP");
+#endif
+        break;
+    case zmk_ipc_ClientMessage_save_checkpoint_tag:
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_CHECKPOINT)
+        save_checkpoint(client, &msg->payload.save_checkpoint);
+#else
+        LOG_DBG("IPC observer: SaveCheckpoint needs CONFIG_ZMK_IPC_OBSERVER_CHECKPOINT");
+#endif
+        break;
+    case zmk_ipc_ClientMessage_set_keyboard_report_format_tag: {
+        const zmk_ipc_SetKeyboardReportFormat *req = &msg->payload.set_keyboard_report_format;
+        enum zmk_hid_keyboard_report_format format =
+            req->format == zmk_ipc_KeyboardReportFormat_KEYBOARD_REPORT_FORMAT_BOOT
+                ? ZMK_HID_KEYBOARD_REPORT_FORMAT_BOOT
+                : ZMK_HID_KEYBOARD_REPORT_FORMAT_NATIVE;
+
+        int err = zmk_endpoint_set_keyboard_report_format(instance_from_endpoint(&req->endpoint),
+                                                          format);
+        if (err < 0) {
+            LOG_WRN("IPC observer: can't select keyboard report format %d (%d)", req->format, err);
+        }
+        break;
+    }
+    }
+}
+
+/* Forward an input message; called without clients_mutex, since injected
+ * events are processed (and broadcast back) before this returns. */
+static void handle_input_message(const zmk_ipc_ClientMessage *msg) {
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_CONNECT)
+    zmk_kscan_ipc_inject(kscan_ipc_dev, msg);
+#else
+    LOG_DBG("IPC observer: ignoring ClientMessage payload %d", msg->which_payload);
+#endif
+}
+
+/* Drain the frames available on one client. */
+static void service_client(struct ipc_client *client, int fd) {
+    static zmk_ipc_ClientMessage msg;
+
+    for (;;) {
+        k_mutex_lock(&clients_mutex, K_FOREVER);
+
+        /* The writer may have dropped (and the fd been reused) since polling. */
+        if (client->fd != fd) {
+            k_mutex_unlock(&clients_mutex);
+            return;
+        }
+
+        int ret = zmk_ipc_frame_reader_next(&client->reader, &msg);
+        bool is_input = false;
+
+        if (ret == 0) {
+            if (is_control_message(&msg)) {
+                handle_control_message(client, &msg);
+            } else {
+                is_input = true;
+            }
+        } else if (ret == -EBADMSG) {
+            LOG_WRN("IPC observer: decode error, skipping frame");
+        } else if (ret != -EAGAIN && ret != -EWOULDBLOCK) {
+            LOG_INF("IPC observer: client fd=%d disconnected (%d)", fd, ret);
+            client_close(client);
+        }
+
+        k_mutex_unlock(&clients_mutex);
+
+        if (is_input) {
+            handle_input_message(&msg);
+        } else if (ret != 0 && ret != -EBADMSG) {
+            return;
+        }
+    }
+}
+
+static void client_readable(struct zmk_ipc_loop_source *source) {
+    service_client(CONTAINER_OF(source, struct ipc_client, source), source->fd);
+}
+
+/* -------------------------------------------------------------------------
+ * Initialisation
+ * ------------------------------------------------------------------------- */
+
+static int ipc_observer_init(void) {
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        clients[i].fd = -1;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_TRACE_FILE)
+    const char *trace_path = getenv("ZMK_IPC_TRACE_FILE");
+    if (trace_path && trace_path[0] != '\0') {
+        trace_file = fopen(trace_path, "wb");
+        if (!trace_file) {
+            LOG_ERR("IPC observer: cannot open trace file %s (errno=%d)", trace_path, errno);
+            return -errno;
+        }
+        update_wanted_mask();
+        LOG_INF("ZMK IPC observer tracing to %s", trace_path);
+    }
+#endif
+
+    int fd = zmk_ipc_listener_open(CONFIG_ZMK_IPC_OBSERVER_SOCKET_PATH, 5);
+    if (fd < 0) {
+        return fd; /* already logged inside helper */
+    }
+    server_fd = fd;
 
-    if (bind(server_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
-        LOG_ERR("IPC observer: bind() failed (errno=%d)", errno);
+    int err = zmk_ipc_loop_add(&server_source, server_fd, accept_client);
+    if (err < 0) {
         close(server_fd);
         server_fd = -1;
-        return -errno;
+        return err;
     }
 
-    if (listen(server_fd, 5) < 0) {
-        LOG_ERR("IPC observer: listen() failed (errno=%d)", errno);
+#if IS_ENABLED(CONFIG_ZMK_IPC_OBSERVER_SHM)
+    err = zmk_ipc_shm_ring_create(&event_ring, CONFIG_ZMK_IPC_OBSERVER_SHM_PATH,
+                                      CONFIG_ZMK_IPC_OBSERVER_SHM_SIZE);
+    if (err < 0) {
+        LOG_ERR("IPC observer: cannot create shm ring %s (err %d)",
+                CONFIG_ZMK_IPC_OBSERVER_SHM_PATH, err);
         close(server_fd);
         server_fd = -1;
-        return -errno;
+        return err;
     }
+    update_wanted_mask();
+    LOG_INF("ZMK IPC observer publishing on shm ring %s", CONFIG_ZMK_IPC_OBSERVER_SHM_PATH);
+#endif
 
     LOG_INF("ZMK IPC observer listening on %s (protobuf/length-prefix framing)",
             CONFIG_ZMK_IPC_OBSERVER_SOCKET_PATH);
@@ -15,21 +15,132 @@ PB_BIND(zmk_ipc_KeyPosition, zmk_ipc_KeyPosition, AUTO)
 PB_BIND(zmk_ipc_KeyEvent, zmk_ipc_KeyEvent, AUTO)
 
 
-PB_BIND(zmk_ipc_ClientMessage, zmk_ipc_ClientMessage, AUTO)
+PB_BIND(zmk_ipc_KeyEventBatch, zmk_ipc_KeyEventBatch, 2)
+
+
+PB_BIND(zmk_ipc_Subscribe, zmk_ipc_Subscribe, AUTO)
+
+
+PB_BIND(zmk_ipc_AdvanceTime, zmk_ipc_AdvanceTime, AUTO)
+
+
+PB_BIND(zmk_ipc_GetEventStats, zmk_ipc_GetEventStats, AUTO)
+
+
+PB_BIND(zmk_ipc_GetStageTimings, zmk_ipc_GetStageTimings, AUTO)
+
+
+PB_BIND(zmk_ipc_GetWorkStats, zmk_ipc_GetWorkStats, AUTO)
+
+
+PB_BIND(zmk_ipc_GetKeyStats, zmk_ipc_GetKeyStats, AUTO)
+
+
+PB_BIND(zmk_ipc_GetThreadStacks, zmk_ipc_GetThreadStacks, AUTO)
+
+
+PB_BIND(zmk_ipc_GetClientStats, zmk_ipc_GetClientStats, AUTO)
+
+
+PB_BIND(zmk_ipc_KeymapBinding, zmk_ipc_KeymapBinding, AUTO)
+
+
+PB_BIND(zmk_ipc_GetKeymapBindings, zmk_ipc_GetKeymapBindings, AUTO)
+
+
+PB_BIND(zmk_ipc_SetKeymapBindings, zmk_ipc_SetKeymapBindings, 2)
+
+
+PB_BIND(zmk_ipc_SetKeyboardReportFormat, zmk_ipc_SetKeyboardReportFormat, AUTO)
+
+
+PB_BIND(zmk_ipc_SensorEvent, zmk_ipc_SensorEvent, AUTO)
+
+
+PB_BIND(zmk_ipc_SensorEventBatch, zmk_ipc_SensorEventBatch, 2)
+
+
+PB_BIND(zmk_ipc_PointerEvent, zmk_ipc_PointerEvent, AUTO)
+
+
+PB_BIND(zmk_ipc_PointerEventBatch, zmk_ipc_PointerEventBatch, 2)
+
+
+PB_BIND(zmk_ipc_Hello, zmk_ipc_Hello, AUTO)
+
+
+PB_BIND(zmk_ipc_SaveCheckpoint, zmk_ipc_SaveCheckpoint, 2)
+
+
+PB_BIND(zmk_ipc_ClientMessage, zmk_ipc_ClientMessage, 4)
 
 
 PB_BIND(zmk_ipc_KscanEvent, zmk_ipc_KscanEvent, AUTO)
 
 
+PB_BIND(zmk_ipc_LatencyTrace, zmk_ipc_LatencyTrace, AUTO)
+
+
 PB_BIND(zmk_ipc_HidKeyboardReport, zmk_ipc_HidKeyboardReport, AUTO)
 
 
+PB_BIND(zmk_ipc_HidKeyboardDelta, zmk_ipc_HidKeyboardDelta, AUTO)
+
+
 PB_BIND(zmk_ipc_HidConsumerReport, zmk_ipc_HidConsumerReport, AUTO)
 
 
 PB_BIND(zmk_ipc_HidMouseReport, zmk_ipc_HidMouseReport, AUTO)
 
 
+PB_BIND(zmk_ipc_EventTypeStats, zmk_ipc_EventTypeStats, AUTO)
+
+
+PB_BIND(zmk_ipc_StageTiming, zmk_ipc_StageTiming, AUTO)
+
+
+PB_BIND(zmk_ipc_WorkStats, zmk_ipc_WorkStats, AUTO)
+
+
+PB_BIND(zmk_ipc_KeyStats, zmk_ipc_KeyStats, AUTO)
+
+
+PB_BIND(zmk_ipc_ThreadStack, zmk_ipc_ThreadStack, AUTO)
+
+
+PB_BIND(zmk_ipc_ClientStats, zmk_ipc_ClientStats, AUTO)
+
+
+PB_BIND(zmk_ipc_KscanEventBatch, zmk_ipc_KscanEventBatch, AUTO)
+
+
+PB_BIND(zmk_ipc_Capabilities, zmk_ipc_Capabilities, AUTO)
+
+
+PB_BIND(zmk_ipc_KeymapBindings, zmk_ipc_KeymapBindings, AUTO)
+
+
+PB_BIND(zmk_ipc_KeymapSetResult, zmk_ipc_KeymapSetResult, AUTO)
+
+
+PB_BIND(zmk_ipc_CheckpointResult, zmk_ipc_CheckpointResult, AUTO)
+
+
+PB_BIND(zmk_ipc_InputCredits, zmk_ipc_InputCredits, AUTO)
+
+
+PB_BIND(zmk_ipc_LayerStateChanged, zmk_ipc_LayerStateChanged, AUTO)
+
+
+PB_BIND(zmk_ipc_ModifiersStateChanged, zmk_ipc_ModifiersStateChanged, AUTO)
+
+
+PB_BIND(zmk_ipc_EndpointChanged, zmk_ipc_EndpointChanged, AUTO)
+
+
+PB_BIND(zmk_ipc_StateSnapshot, zmk_ipc_StateSnapshot, AUTO)
+
+
 PB_BIND(zmk_ipc_ZmkEvent, zmk_ipc_ZmkEvent, AUTO)
 
 
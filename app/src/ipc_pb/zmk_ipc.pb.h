@@ -21,6 +21,14 @@ typedef enum _zmk_ipc_TransportType {
     zmk_ipc_TransportType_TRANSPORT_BLE = 3
 } zmk_ipc_TransportType;
 
+/* Layout of the keys in a HidKeyboardReport. */
+typedef enum _zmk_ipc_KeyboardReportFormat {
+    /* The layout ZMK is built for: HKRO usage slots or the NKRO bitmap. */
+    zmk_ipc_KeyboardReportFormat_KEYBOARD_REPORT_FORMAT_NATIVE = 0,
+    /* The 6-key boot protocol layout, needs CONFIG_ZMK_HID_BOOT_REPORT. */
+    zmk_ipc_KeyboardReportFormat_KEYBOARD_REPORT_FORMAT_BOOT = 1
+} zmk_ipc_KeyboardReportFormat;
+
 /* Whether this is a press or a release. */
 typedef enum _zmk_ipc_KeyEvent_Action {
     zmk_ipc_KeyEvent_Action_ACTION_UNSPECIFIED = 0,
@@ -51,14 +59,230 @@ typedef struct _zmk_ipc_KeyEvent {
         zmk_ipc_KeyPosition key_pos;
         uint32_t position;
     } address;
+    /* Optional latency tracing.  A non-zero seq is carried through ZMK and
+ reported back, with kernel timestamps, in the LatencyTrace of the next
+ HidKeyboardReport.  client_ts is opaque to ZMK and echoed unchanged. */
+    uint32_t seq;
+    uint64_t client_ts;
 } zmk_ipc_KeyEvent;
 
+/* A batch of key events carried in a single frame.
+ The driver injects the events into the kscan pipeline in order, exactly
+ as if each had been sent in its own frame.  Batching amortises the
+ framing and decode cost when replaying recorded sessions at high rates.
+ Maximum batch length: see zmk_ipc.options (KeyEventBatch.events). */
+typedef struct _zmk_ipc_KeyEventBatch {
+    pb_size_t events_count;
+    zmk_ipc_KeyEvent events[256];
+} zmk_ipc_KeyEventBatch;
+
+/* Selects which ZmkEvent payload types the sending connection receives.
+ Sent on the observer socket; replaces any previous subscription.
+ Connections that never send a Subscribe receive every event type.
+
+ event_mask bit N selects the ZmkEvent payload with field number N:
+   bit 1 (0x02) – kscan_event     bit 3 (0x08) – consumer
+   bit 2 (0x04) – keyboard        bit 4 (0x10) – mouse */
+typedef struct _zmk_ipc_Subscribe {
+    uint32_t event_mask;
+} zmk_ipc_Subscribe;
+
+/* Lets `ms` milliseconds of kernel time pass before the next message on the
+ same connection is processed; timers and delayed work due in that window
+ fire in order.  With CONFIG_ZMK_KSCAN_IPC_VIRTUAL_TIME this is the only
+ way simulated time advances, so replays run as fast as the host allows
+ and every timeout is deterministic. */
+typedef struct _zmk_ipc_AdvanceTime {
+    uint32_t ms;
+} zmk_ipc_AdvanceTime;
+
+/* Requests the event manager's per-event-type dispatch counters
+ (CONFIG_ZMK_EVENT_MANAGER_STATS).  Sent on the observer socket; the reply
+ is one ZmkEvent.event_stats frame per event type, delivered to the
+ requesting connection only and regardless of its Subscribe mask. */
+typedef struct _zmk_ipc_GetEventStats {
+    char dummy_field;
+} zmk_ipc_GetEventStats;
+
+/* Requests the hot path's per-stage cycle histograms
+ (CONFIG_ZMK_STAGE_TIMING).  The reply is one ZmkEvent.stage_timing frame
+ per stage, to the requesting connection only. */
+typedef struct _zmk_ipc_GetStageTimings {
+    char dummy_field;
+} zmk_ipc_GetStageTimings;
+
+/* Requests the work item counters (CONFIG_ZMK_WORK_STATS).  The reply is one
+ ZmkEvent.work_stats frame per work item, to the requesting connection only. */
+typedef struct _zmk_ipc_GetWorkStats {
+    char dummy_field;
+} zmk_ipc_GetWorkStats;
+
+/* Requests the key timing histograms (CONFIG_ZMK_KEY_STATS).  The reply is
+ one ZmkEvent.key_stats frame for the intervals between key presses, then
+ one per key position pressed or decided as a hold-tap since boot, to the
+ requesting connection only. */
+typedef struct _zmk_ipc_GetKeyStats {
+    char dummy_field;
+} zmk_ipc_GetKeyStats;
+
+/* Requests the stack use of every thread (CONFIG_ZMK_THREAD_STACK_STATS).
+ The reply is one ZmkEvent.thread_stack frame per thread, to the requesting
+ connection only. */
+typedef struct _zmk_ipc_GetThreadStacks {
+    char dummy_field;
+} zmk_ipc_GetThreadStacks;
+
+/* Requests the counters of every observer connection.  The reply is one
+ ZmkEvent.client_stats frame per connected client, to the requesting
+ connection only. */
+typedef struct _zmk_ipc_GetClientStats {
+    char dummy_field;
+} zmk_ipc_GetClientStats;
+
+/* One keymap binding, identified the same way as in ZMK Studio: a behavior
+ local ID plus the behavior's two parameters. */
+typedef struct _zmk_ipc_KeymapBinding {
+    uint32_t behavior_id;
+    uint32_t param1;
+    uint32_t param2;
+} zmk_ipc_KeymapBinding;
+
+/* Requests the bindings of layer IDs [first_layer, first_layer + layer_count)
+ at binding indexes [first_position, first_position + position_count)
+ (CONFIG_ZMK_IPC_OBSERVER_KEYMAP).  A zero count extends the range to the
+ last layer / position, so an all-zero request dumps the whole keymap.
+ The reply is a stream of KeymapBindings frames, delivered to the
+ requesting connection only and regardless of its Subscribe mask. */
+typedef struct _zmk_ipc_GetKeymapBindings {
+    uint32_t first_layer;
+    uint32_t layer_count;
+    uint32_t first_position;
+    uint32_t position_count;
+} zmk_ipc_GetKeymapBindings;
+
+/* Replaces a block of bindings (CONFIG_ZMK_IPC_OBSERVER_KEYMAP): `bindings`
+ holds position_count entries starting at first_position for layer ID
+ first_layer, then the same positions for first_layer + 1, and so on.
+ With save set, keymap changes are persisted once the block is applied.
+ With reset set, the keymap state is reset before the block is applied, as
+ after loading a new keymap: every layer but the default one is deactivated,
+ locked ones included, and the HID reports are cleared.  Set it on the first
+ block of a whole keymap to hot-reload it.
+ Answered with one KeymapSetResult frame.
+ Maximum block size: see zmk_ipc.options (SetKeymapBindings.bindings). */
+typedef struct _zmk_ipc_SetKeymapBindings {
+    uint32_t first_layer;
+    uint32_t first_position;
+    uint32_t position_count;
+    pb_size_t bindings_count;
+    zmk_ipc_KeymapBinding bindings[256];
+    bool save;
+    bool reset;
+} zmk_ipc_SetKeymapBindings;
+
+/* Selects the keyboard report layout sent to an endpoint, as a host that
+ only understands boot keyboards would (see HidKeyboardReport.format).
+ Sent on the observer socket.  Layouts the build can't produce are ignored. */
+typedef struct _zmk_ipc_SetKeyboardReportFormat {
+    bool has_endpoint;
+    zmk_ipc_Endpoint endpoint;
+    zmk_ipc_KeyboardReportFormat format;
+} zmk_ipc_SetKeyboardReportFormat;
+
+/* A reading for one of the keymap sensors, raised as a zmk_sensor_event on
+ the sensor's rotation channel, as if the sensor device had reported it.
+ val1 / val2 follow Zephyr's struct sensor_value: val2 is in millionths.
+ Readings for an out of range sensor_index are dropped. */
+typedef struct _zmk_ipc_SensorEvent {
+    uint32_t sensor_index;
+    int32_t val1;
+    int32_t val2;
+} zmk_ipc_SensorEvent;
+
+/* A batch of sensor readings carried in a single frame, raised in order.
+ Maximum batch length: see zmk_ipc.options (SensorEventBatch.events). */
+typedef struct _zmk_ipc_SensorEventBatch {
+    pb_size_t events_count;
+    zmk_ipc_SensorEvent events[256];
+} zmk_ipc_SensorEventBatch;
+
+/* Relative pointer input, raised as Zephyr input events from the kscan IPC
+ device, so a zmk,input-listener whose device is that node feeds it through
+ its input processors into mouse reports.
+ buttons is the set of buttons held, bit N being INPUT_BTN_N (0 – 4); only
+ buttons that changed since the last PointerEvent are reported.  The last
+ input event raised carries sync: leave it unset to spread one report over
+ several PointerEvents. */
+typedef struct _zmk_ipc_PointerEvent {
+    int32_t dx;
+    int32_t dy;
+    int32_t wheel;
+    int32_t hwheel;
+    uint32_t buttons;
+    bool sync;
+} zmk_ipc_PointerEvent;
+
+/* A batch of pointer events carried in a single frame, raised in order.
+ Maximum batch length: see zmk_ipc.options (PointerEventBatch.events). */
+typedef struct _zmk_ipc_PointerEventBatch {
+    pb_size_t events_count;
+    zmk_ipc_PointerEvent events[256];
+} zmk_ipc_PointerEventBatch;
+
+/* Opens a versioned session; optional, clients that never send it get the
+ behaviour of protocol version 1.  Answered with one Capabilities frame on
+ the same connection, on the observer and the kscan socket alike.
+ A non-zero event_mask lists the ZmkEvent payloads the client understands
+ (bits as in Subscribe) and on the observer socket also subscribes the
+ connection to those of them the firmware can send, opt-in payloads such as
+ keyboard_delta and kscan_batch included.
+ packed_events asks for the fixed-layout frames of
+ CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS (see zmk_ipc_packed.h) for the event
+ types that have one; it is ignored unless Capabilities.packed_version is
+ non-zero. */
+typedef struct _zmk_ipc_Hello {
+    uint32_t protocol_version;
+    uint32_t event_mask;
+    bool packed_events;
+} zmk_ipc_Hello;
+
+/* Writes a checkpoint of the keyboard to `path` on the host
+ (CONFIG_ZMK_IPC_OBSERVER_CHECKPOINT): the settings image, with the keymap,
+ BLE profiles and everything else saved so far, plus the active and locked
+ layers.  It is refused with -EBUSY while a key is held or reported or a
+ combo, hold-tap, sticky key or tap dance is pending, since that state isn't
+ saved.  An instance started with the
+ ZMK_SETTINGS_TEMPLATE environment variable set to the checkpoint boots in
+ that state.  Answered with one CheckpointResult frame.
+ Maximum path length: see zmk_ipc.options (SaveCheckpoint.path). */
+typedef struct _zmk_ipc_SaveCheckpoint {
+    char path[256];
+} zmk_ipc_SaveCheckpoint;
+
 /* Top-level wrapper for all client → ZMK messages.
  Extend with additional variants (e.g. reset, layer control) as needed. */
 typedef struct _zmk_ipc_ClientMessage {
     pb_size_t which_payload;
     union {
         zmk_ipc_KeyEvent key_event;
+        zmk_ipc_KeyEventBatch key_batch;
+        zmk_ipc_Subscribe subscribe;
+        zmk_ipc_AdvanceTime advance_time;
+        zmk_ipc_GetEventStats get_event_stats;
+        zmk_ipc_GetKeymapBindings get_keymap_bindings;
+        zmk_ipc_SetKeymapBindings set_keymap_bindings;
+        zmk_ipc_SetKeyboardReportFormat set_keyboard_report_format;
+        zmk_ipc_SensorEvent sensor_event;
+        zmk_ipc_SensorEventBatch sensor_batch;
+        zmk_ipc_PointerEvent pointer_event;
+        zmk_ipc_PointerEventBatch pointer_batch;
+        zmk_ipc_GetStageTimings get_stage_timings;
+        zmk_ipc_GetWorkStats get_work_stats;
+        zmk_ipc_GetThreadStacks get_thread_stacks;
+        zmk_ipc_GetClientStats get_client_stats;
+        zmk_ipc_Hello hello;
+        zmk_ipc_SaveCheckpoint save_checkpoint;
+        zmk_ipc_GetKeyStats get_key_stats;
     } payload;
 } zmk_ipc_ClientMessage;
 
@@ -75,8 +299,23 @@ typedef struct _zmk_ipc_KscanEvent {
     bool pressed;
     /* Kernel uptime at event time, milliseconds. */
     int64_t timestamp;
+    /* Keyboard the key belongs to: the `context` of the zmk,kscan-ipc
+ instance it was sent to, 0 for the first or only keyboard. */
+    uint32_t context;
 } zmk_ipc_KscanEvent;
 
+/* Injection-to-report timing of a traced KeyEvent (see KeyEvent.seq).
+ Timestamps are kernel uptime in microseconds, taken when the kscan IPC
+ driver invoked the kscan callback, when the resulting
+ zmk_position_state_changed was raised, and when the report was sent. */
+typedef struct _zmk_ipc_LatencyTrace {
+    uint32_t seq;
+    uint64_t client_ts;
+    int64_t kscan_us;
+    int64_t raise_us;
+    int64_t report_us;
+} zmk_ipc_LatencyTrace;
+
 typedef PB_BYTES_ARRAY_T(32) zmk_ipc_HidKeyboardReport_keys_t;
 /* HID keyboard report sent to a transport endpoint.
  Fired after keymap + modifier processing, immediately before the report
@@ -90,15 +329,42 @@ typedef PB_BYTES_ARRAY_T(32) zmk_ipc_HidKeyboardReport_keys_t;
 
  keys byte layout:
    HKRO mode: 6 bytes, each a HID usage ID (0 = not pressed)
-   NKRO mode: bitmap of all supported HID usage IDs */
+   NKRO mode: bitmap of all supported HID usage IDs
+   BOOT format: 6 bytes as in HKRO mode, all 0x01 on rollover */
 typedef struct _zmk_ipc_HidKeyboardReport {
     bool has_endpoint;
     zmk_ipc_Endpoint endpoint;
     uint32_t modifiers;
     /* Raw key bytes — length depends on HKRO / NKRO build configuration. */
     zmk_ipc_HidKeyboardReport_keys_t keys;
+    /* Present when this is the first report after a traced KeyEvent was
+ raised (CONFIG_ZMK_IPC_OBSERVER_LATENCY_TRACE). */
+    bool has_trace;
+    zmk_ipc_LatencyTrace trace;
+    /* Layout of keys used for this endpoint. */
+    zmk_ipc_KeyboardReportFormat format;
 } zmk_ipc_HidKeyboardReport;
 
+typedef PB_BYTES_ARRAY_T(64) zmk_ipc_HidKeyboardDelta_pressed_t;
+typedef PB_BYTES_ARRAY_T(64) zmk_ipc_HidKeyboardDelta_released_t;
+/* Changes of the keyboard report since the previous one, sent instead of a
+ HidKeyboardReport to clients subscribed to ZmkEvent.keyboard_delta.  The
+ endpoint is left out; it is the one of the last StateSnapshot or
+ EndpointChanged. */
+typedef struct _zmk_ipc_HidKeyboardDelta {
+    /* Counts the deltas since boot.  A gap means frames to this client were
+ dropped, and its state is stale until the next keyframe. */
+    uint32_t seq;
+    /* The whole modifier byte, as it costs no more than a change list. */
+    uint32_t modifiers;
+    /* Usage IDs pressed and released since the previous report, whatever
+ the report layout.  On a keyframe, pressed lists every held usage and
+ released is empty. */
+    zmk_ipc_HidKeyboardDelta_pressed_t pressed;
+    zmk_ipc_HidKeyboardDelta_released_t released;
+    bool keyframe;
+} zmk_ipc_HidKeyboardDelta;
+
 typedef PB_BYTES_ARRAY_T(16) zmk_ipc_HidConsumerReport_keys_t;
 /* HID consumer (media key) report sent to a transport endpoint.
 
@@ -130,6 +396,238 @@ typedef struct _zmk_ipc_HidMouseReport {
     int32_t scroll_y;
 } zmk_ipc_HidMouseReport;
 
+/* Dispatch counters for one event type since boot; reply to GetEventStats. */
+typedef struct _zmk_ipc_EventTypeStats {
+    /* Event type name, e.g. "zmk_position_state_changed". */
+    char name[48];
+    /* Position of this frame in the reply and the number of frames in it. */
+    uint32_t index;
+    uint32_t count;
+    /* Raises (including raise_after / raise_at, excluding releases). */
+    uint32_t raised;
+    uint32_t listeners_invoked;
+    uint32_t captured;
+    /* Cycles spent dispatching, including nested events raised by listeners. */
+    uint64_t cycles;
+    uint32_t cycles_per_sec;
+} zmk_ipc_EventTypeStats;
+
+/* Cycle histogram of one hot path stage since boot; reply to GetStageTimings. */
+typedef struct _zmk_ipc_StageTiming {
+    /* Stage name, e.g. "behavior". */
+    char name[24];
+    /* Position of this frame in the reply and the number of frames in it. */
+    uint32_t index;
+    uint32_t count;
+    uint32_t samples;
+    uint64_t total_cycles;
+    uint32_t max_cycles;
+    /* buckets[0] counts samples of 0 cycles, buckets[i] those of
+ [2^(i-1), 2^i) cycles; the last bucket also counts everything longer. */
+    pb_size_t buckets_count;
+    uint32_t buckets[32];
+    uint32_t cycles_per_sec;
+} zmk_ipc_StageTiming;
+
+/* Counters of one work item since boot; reply to GetWorkStats. */
+typedef struct _zmk_ipc_WorkStats {
+    /* Work item name, e.g. "behavior_queue". */
+    char name[24];
+    /* Position of this frame in the reply and the number of frames in it. */
+    uint32_t index;
+    uint32_t count;
+    uint32_t submitted;
+    uint32_t runs;
+    /* Cycles from the time a run was due until it started. */
+    uint64_t total_latency_cycles;
+    uint32_t max_latency_cycles;
+    uint64_t total_run_cycles;
+    uint32_t max_run_cycles;
+    /* Capacity of the queue the work item drains, 0 if it has none. */
+    uint32_t queue_capacity;
+    uint32_t queue_high_water;
+    uint32_t cycles_per_sec;
+} zmk_ipc_WorkStats;
+
+/* Timing histogram of one key position, or of the intervals between key
+ presses, since boot; reply to GetKeyStats. */
+typedef struct _zmk_ipc_KeyStats {
+    /* Position of this frame in the reply and the number of frames in it. */
+    uint32_t index;
+    uint32_t count;
+    /* Key position whose press durations this frame holds, or -1 for the
+ intervals from one key press to the next. */
+    int32_t position;
+    uint32_t samples;
+    uint32_t max_ms;
+    /* buckets[0] counts samples under 1 ms, buckets[i] those of
+ [2^(i-1), 2^i) ms; the last bucket also counts everything longer. */
+    pb_size_t buckets_count;
+    uint32_t buckets[16];
+    /* How often the hold-tap at this position was decided as a hold or a
+ tap, and how often a hold turned into a tap on release (retro-tap),
+ which is then no longer counted as a hold. Per position counts stop at
+ 65535. */
+    uint32_t holds;
+    uint32_t taps;
+    uint32_t retro_taps;
+} zmk_ipc_KeyStats;
+
+/* Stack of one thread; reply to GetThreadStacks. */
+typedef struct _zmk_ipc_ThreadStack {
+    /* Thread name, or its address in hex if it has none. */
+    char name[32];
+    /* Position of this frame in the reply and the number of frames in it. */
+    uint32_t index;
+    uint32_t count;
+    /* Stack size and the most of it in use at any point since the thread
+ started, in bytes. */
+    uint32_t stack_size;
+    uint32_t stack_used;
+} zmk_ipc_ThreadStack;
+
+/* Counters of one observer connection; reply to GetClientStats. */
+typedef struct _zmk_ipc_ClientStats {
+    /* Position of this frame in the reply and the number of frames in it. */
+    uint32_t index;
+    uint32_t count;
+    /* Set on the frame describing the connection that asked. */
+    bool requester;
+    /* Frames and bytes the socket accepted since the client connected. */
+    uint32_t frames_sent;
+    uint64_t bytes_sent;
+    /* Frames the overflow policy discarded. */
+    uint32_t frames_dropped;
+    /* Frames queued now, the most ever queued at once, and the queue size
+ (CONFIG_ZMK_IPC_OBSERVER_CLIENT_QUEUE_DEPTH). */
+    uint32_t queue_depth;
+    uint32_t queue_high_water;
+    uint32_t queue_capacity;
+    /* Kernel send buffer size (SO_SNDBUF) and the bytes waiting in it. */
+    uint32_t sndbuf_size;
+    uint32_t sndbuf_used;
+} zmk_ipc_ClientStats;
+
+/* Position events collected off the key path and sent together, oldest
+ first (CONFIG_ZMK_IPC_OBSERVER_KSCAN_BATCH).  A batch isn't ordered with
+ the reports its events caused; each event carries its own timestamp. */
+typedef struct _zmk_ipc_KscanEventBatch {
+    pb_size_t events_count;
+    zmk_ipc_KscanEvent events[8];
+    /* Position events lost since the previous batch, because they arrived
+ faster than the observer could collect them. */
+    uint32_t dropped;
+} zmk_ipc_KscanEventBatch;
+
+/* What the firmware build supports; reply to Hello. */
+typedef struct _zmk_ipc_Capabilities {
+    /* Highest protocol version the firmware speaks.  A client asking for a
+ newer one should fall back to this. */
+    uint32_t protocol_version;
+    /* Largest frame, length prefix included, the firmware sends and accepts. */
+    uint32_t max_event_frame;
+    uint32_t max_message_frame;
+    /* ZmkEvent payloads the connection can receive, and ClientMessage
+ payloads the firmware acts on; bit N is the payload with field number
+ N, as in Subscribe.  event_mask is 0 on the kscan socket. */
+    uint32_t event_mask;
+    uint32_t message_mask;
+    /* Logical key matrix of the kscan IPC device (its DTS `rows` and
+ `columns`), 0 if the build has none. */
+    uint32_t rows;
+    uint32_t columns;
+    /* Version of the fixed-layout event frames (ZMK_IPC_PACKED_VERSION),
+ 0 if the build can't send them. */
+    uint32_t packed_version;
+} zmk_ipc_Capabilities;
+
+/* A run of consecutive bindings on one layer; reply to GetKeymapBindings. */
+typedef struct _zmk_ipc_KeymapBindings {
+    uint32_t layer_id;
+    uint32_t first_position;
+    pb_size_t bindings_count;
+    zmk_ipc_KeymapBinding bindings[16];
+    /* Position of this frame in the reply and the number of frames in it. */
+    uint32_t index;
+    uint32_t count;
+} zmk_ipc_KeymapBindings;
+
+/* Reply to SetKeymapBindings. */
+typedef struct _zmk_ipc_KeymapSetResult {
+    /* Bindings applied, in order, before the first failure. */
+    uint32_t applied;
+    /* 0 on success, otherwise a negative errno. */
+    int32_t error;
+} zmk_ipc_KeymapSetResult;
+
+/* Reply to SaveCheckpoint. */
+typedef struct _zmk_ipc_CheckpointResult {
+    /* 0 on success, -EBUSY while keys or behaviors are active, otherwise a
+ negative errno. */
+    int32_t error;
+} zmk_ipc_CheckpointResult;
+
+/* Flow control for key input (CONFIG_ZMK_IPC_OBSERVER_INPUT_CREDITS), sent
+ only to connections subscribed to input_credits, once on subscribing and
+ then whenever `consumed` has changed.  A client that is the only source of
+ key events never fills the kscan event queue while it has sent at most
+ `capacity` events more than `consumed`, counting from the first
+ InputCredits it got.  Events beyond that aren't lost, but stall every IPC
+ socket until the queue has room again. */
+typedef struct _zmk_ipc_InputCredits {
+    /* Size of the kscan event queue (CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE). */
+    uint32_t capacity;
+    /* Kscan events taken off the queue since boot, wrapping around. */
+    uint32_t consumed;
+} zmk_ipc_InputCredits;
+
+/* A layer was activated or deactivated (zmk_layer_state_changed). */
+typedef struct _zmk_ipc_LayerStateChanged {
+    uint32_t layer;
+    bool active;
+} zmk_ipc_LayerStateChanged;
+
+/* Explicit modifiers were pressed or released (zmk_modifiers_state_changed).
+ Implicit modifiers of keycodes like LS(A) are only seen in the keyboard
+ report. */
+typedef struct _zmk_ipc_ModifiersStateChanged {
+    /* The modifiers that changed, in the HID modifier byte layout. */
+    uint32_t modifiers;
+    bool pressed;
+    /* All explicit modifiers held after the change. */
+    uint32_t explicit_modifiers;
+} zmk_ipc_ModifiersStateChanged;
+
+/* The endpoint reports are sent to changed (zmk_endpoint_changed). */
+typedef struct _zmk_ipc_EndpointChanged {
+    bool has_endpoint;
+    zmk_ipc_Endpoint endpoint;
+} zmk_ipc_EndpointChanged;
+
+/* The state a client would otherwise have to rebuild from earlier events.
+ Sent once to each client right after it connects, ahead of any other
+ event; LayerStateChanged, ModifiersStateChanged, EndpointChanged and the
+ HID reports then follow it as deltas. */
+typedef struct _zmk_ipc_StateSnapshot {
+    /* Bit N set for each active layer N, as in LayerStateChanged.layer. */
+    uint32_t layer_state;
+    uint32_t default_layer;
+    uint32_t explicit_modifiers;
+    bool has_endpoint;
+    zmk_ipc_Endpoint endpoint;
+    /* The last reports built for the selected endpoint. */
+    bool has_keyboard;
+    zmk_ipc_HidKeyboardReport keyboard;
+    bool has_consumer;
+    zmk_ipc_HidConsumerReport consumer;
+    /* Present only with CONFIG_ZMK_POINTING. */
+    bool has_mouse;
+    zmk_ipc_HidMouseReport mouse;
+    /* Battery state of charge in percent, -1 without
+ CONFIG_ZMK_BATTERY_REPORTING. */
+    int32_t battery_level;
+} zmk_ipc_StateSnapshot;
+
 /* Top-level wrapper for all ZMK → client notifications. */
 typedef struct _zmk_ipc_ZmkEvent {
     pb_size_t which_payload;
@@ -138,7 +636,31 @@ typedef struct _zmk_ipc_ZmkEvent {
         zmk_ipc_HidKeyboardReport keyboard;
         zmk_ipc_HidConsumerReport consumer;
         zmk_ipc_HidMouseReport mouse;
+        zmk_ipc_EventTypeStats event_stats;
+        zmk_ipc_KeymapBindings keymap_bindings;
+        zmk_ipc_KeymapSetResult keymap_set_result;
+        zmk_ipc_LayerStateChanged layer_state;
+        zmk_ipc_StageTiming stage_timing;
+        zmk_ipc_WorkStats work_stats;
+        zmk_ipc_ThreadStack thread_stack;
+        zmk_ipc_StateSnapshot state_snapshot;
+        zmk_ipc_ModifiersStateChanged modifiers_state;
+        zmk_ipc_EndpointChanged endpoint_changed;
+        zmk_ipc_HidKeyboardDelta keyboard_delta;
+        zmk_ipc_ClientStats client_stats;
+        zmk_ipc_KscanEventBatch kscan_batch;
+        zmk_ipc_Capabilities capabilities;
+        zmk_ipc_CheckpointResult checkpoint_result;
+        zmk_ipc_InputCredits input_credits;
+        zmk_ipc_KeyStats key_stats;
     } payload;
+    /* Kernel uptime when the event was published, milliseconds.  Not set on
+ replies to a single client. */
+    int64_t timestamp;
+    /* Keyboard (CONFIG_ZMK_CONTEXT_COUNT) the event was raised for, 0 for
+ the first or only one.  A kscan_batch can mix keyboards; each of its
+ events carries its own. */
+    uint32_t context;
 } zmk_ipc_ZmkEvent;
 
 /* Used as a placeholder return type where no response data is needed. */
@@ -156,6 +678,10 @@ extern "C" {
 #define _zmk_ipc_TransportType_MAX zmk_ipc_TransportType_TRANSPORT_BLE
 #define _zmk_ipc_TransportType_ARRAYSIZE ((zmk_ipc_TransportType)(zmk_ipc_TransportType_TRANSPORT_BLE+1))
 
+#define _zmk_ipc_KeyboardReportFormat_MIN zmk_ipc_KeyboardReportFormat_KEYBOARD_REPORT_FORMAT_NATIVE
+#define _zmk_ipc_KeyboardReportFormat_MAX zmk_ipc_KeyboardReportFormat_KEYBOARD_REPORT_FORMAT_BOOT
+#define _zmk_ipc_KeyboardReportFormat_ARRAYSIZE ((zmk_ipc_KeyboardReportFormat)(zmk_ipc_KeyboardReportFormat_KEYBOARD_REPORT_FORMAT_BOOT+1))
+
 #define _zmk_ipc_KeyEvent_Action_MIN zmk_ipc_KeyEvent_Action_ACTION_UNSPECIFIED
 #define _zmk_ipc_KeyEvent_Action_MAX zmk_ipc_KeyEvent_Action_RELEASE
 #define _zmk_ipc_KeyEvent_Action_ARRAYSIZE ((zmk_ipc_KeyEvent_Action)(zmk_ipc_KeyEvent_Action_RELEASE+1))
@@ -165,6 +691,10 @@ extern "C" {
 
 #define zmk_ipc_KeyEvent_action_ENUMTYPE zmk_ipc_KeyEvent_Action
 
+#define zmk_ipc_SetKeyboardReportFormat_format_ENUMTYPE zmk_ipc_KeyboardReportFormat
+
+#define zmk_ipc_HidKeyboardReport_format_ENUMTYPE zmk_ipc_KeyboardReportFormat
+
 
 
 
@@ -176,23 +706,97 @@ extern "C" {
 /* Initializer values for message structs */
 #define zmk_ipc_Endpoint_init_default            {_zmk_ipc_TransportType_MIN, 0}
 #define zmk_ipc_KeyPosition_init_default         {0, 0}
-#define zmk_ipc_KeyEvent_init_default            {_zmk_ipc_KeyEvent_Action_MIN, 0, {zmk_ipc_KeyPosition_init_default}}
+#define zmk_ipc_KeyEvent_init_default            {_zmk_ipc_KeyEvent_Action_MIN, 0, {zmk_ipc_KeyPosition_init_default}, 0, 0}
+#define zmk_ipc_KeyEventBatch_init_default       {0, {zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default, zmk_ipc_KeyEvent_init_default}}
+#define zmk_ipc_Subscribe_init_default           {0}
+#define zmk_ipc_AdvanceTime_init_default         {0}
+#define zmk_ipc_GetEventStats_init_default       {0}
+#define zmk_ipc_GetStageTimings_init_default     {0}
+#define zmk_ipc_GetWorkStats_init_default        {0}
+#define zmk_ipc_GetKeyStats_init_default         {0}
+#define zmk_ipc_GetThreadStacks_init_default     {0}
+#define zmk_ipc_GetClientStats_init_default      {0}
+#define zmk_ipc_KeymapBinding_init_default       {0, 0, 0}
+#define zmk_ipc_GetKeymapBindings_init_default   {0, 0, 0, 0}
+#define zmk_ipc_SetKeymapBindings_init_default   {0, 0, 0, 0, {zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default}, 0, 0}
+#define zmk_ipc_SetKeyboardReportFormat_init_default {false, zmk_ipc_Endpoint_init_default, _zmk_ipc_KeyboardReportFormat_MIN}
+#define zmk_ipc_SensorEvent_init_default         {0, 0, 0}
+#define zmk_ipc_SensorEventBatch_init_default    {0, {zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default, zmk_ipc_SensorEvent_init_default}}
+#define zmk_ipc_PointerEvent_init_default        {0, 0, 0, 0, 0, 0}
+#define zmk_ipc_PointerEventBatch_init_default   {0, {zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default, zmk_ipc_PointerEvent_init_default}}
+#define zmk_ipc_Hello_init_default               {0, 0, 0}
+#define zmk_ipc_SaveCheckpoint_init_default      {""}
 #define zmk_ipc_ClientMessage_init_default       {0, {zmk_ipc_KeyEvent_init_default}}
-#define zmk_ipc_KscanEvent_init_default          {0, 0, 0, 0}
-#define zmk_ipc_HidKeyboardReport_init_default   {false, zmk_ipc_Endpoint_init_default, 0, {0, {0}}}
+#define zmk_ipc_KscanEvent_init_default          {0, 0, 0, 0, 0}
+#define zmk_ipc_LatencyTrace_init_default        {0, 0, 0, 0, 0}
+#define zmk_ipc_HidKeyboardReport_init_default   {false, zmk_ipc_Endpoint_init_default, 0, {0, {0}}, false, zmk_ipc_LatencyTrace_init_default, _zmk_ipc_KeyboardReportFormat_MIN}
+#define zmk_ipc_HidKeyboardDelta_init_default    {0, 0, {0, {0}}, {0, {0}}, 0}
 #define zmk_ipc_HidConsumerReport_init_default   {false, zmk_ipc_Endpoint_init_default, {0, {0}}}
 #define zmk_ipc_HidMouseReport_init_default      {false, zmk_ipc_Endpoint_init_default, 0, 0, 0, 0, 0}
-#define zmk_ipc_ZmkEvent_init_default            {0, {zmk_ipc_KscanEvent_init_default}}
+#define zmk_ipc_EventTypeStats_init_default      {"", 0, 0, 0, 0, 0, 0, 0}
+#define zmk_ipc_StageTiming_init_default         {"", 0, 0, 0, 0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0}
+#define zmk_ipc_WorkStats_init_default           {"", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+#define zmk_ipc_KeyStats_init_default            {0, 0, 0, 0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0, 0, 0}
+#define zmk_ipc_ThreadStack_init_default         {"", 0, 0, 0, 0}
+#define zmk_ipc_ClientStats_init_default         {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+#define zmk_ipc_KscanEventBatch_init_default     {0, {zmk_ipc_KscanEvent_init_default, zmk_ipc_KscanEvent_init_default, zmk_ipc_KscanEvent_init_default, zmk_ipc_KscanEvent_init_default, zmk_ipc_KscanEvent_init_default, zmk_ipc_KscanEvent_init_default, zmk_ipc_KscanEvent_init_default, zmk_ipc_KscanEvent_init_default}, 0}
+#define zmk_ipc_Capabilities_init_default        {0, 0, 0, 0, 0, 0, 0, 0}
+#define zmk_ipc_KeymapBindings_init_default      {0, 0, 0, {zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default, zmk_ipc_KeymapBinding_init_default}, 0, 0}
+#define zmk_ipc_KeymapSetResult_init_default     {0, 0}
+#define zmk_ipc_CheckpointResult_init_default    {0}
+#define zmk_ipc_InputCredits_init_default        {0, 0}
+#define zmk_ipc_LayerStateChanged_init_default   {0, 0}
+#define zmk_ipc_ModifiersStateChanged_init_default {0, 0, 0}
+#define zmk_ipc_EndpointChanged_init_default     {false, zmk_ipc_Endpoint_init_default}
+#define zmk_ipc_StateSnapshot_init_default       {0, 0, 0, false, zmk_ipc_Endpoint_init_default, false, zmk_ipc_HidKeyboardReport_init_default, false, zmk_ipc_HidConsumerReport_init_default, false, zmk_ipc_HidMouseReport_init_default, 0}
+#define zmk_ipc_ZmkEvent_init_default            {0, {zmk_ipc_KscanEvent_init_default}, 0, 0}
 #define zmk_ipc_Empty_init_default               {0}
 #define zmk_ipc_Endpoint_init_zero               {_zmk_ipc_TransportType_MIN, 0}
 #define zmk_ipc_KeyPosition_init_zero            {0, 0}
-#define zmk_ipc_KeyEvent_init_zero               {_zmk_ipc_KeyEvent_Action_MIN, 0, {zmk_ipc_KeyPosition_init_zero}}
+#define zmk_ipc_KeyEvent_init_zero               {_zmk_ipc_KeyEvent_Action_MIN, 0, {zmk_ipc_KeyPosition_init_zero}, 0, 0}
+#define zmk_ipc_KeyEventBatch_init_zero          {0, {zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero, zmk_ipc_KeyEvent_init_zero}}
+#define zmk_ipc_Subscribe_init_zero              {0}
+#define zmk_ipc_AdvanceTime_init_zero            {0}
+#define zmk_ipc_GetEventStats_init_zero          {0}
+#define zmk_ipc_GetStageTimings_init_zero        {0}
+#define zmk_ipc_GetWorkStats_init_zero           {0}
+#define zmk_ipc_GetKeyStats_init_zero            {0}
+#define zmk_ipc_GetThreadStacks_init_zero        {0}
+#define zmk_ipc_GetClientStats_init_zero         {0}
+#define zmk_ipc_KeymapBinding_init_zero          {0, 0, 0}
+#define zmk_ipc_GetKeymapBindings_init_zero      {0, 0, 0, 0}
+#define zmk_ipc_SetKeymapBindings_init_zero      {0, 0, 0, 0, {zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero}, 0, 0}
+#define zmk_ipc_SetKeyboardReportFormat_init_zero {false, zmk_ipc_Endpoint_init_zero, _zmk_ipc_KeyboardReportFormat_MIN}
+#define zmk_ipc_SensorEvent_init_zero            {0, 0, 0}
+#define zmk_ipc_SensorEventBatch_init_zero       {0, {zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero, zmk_ipc_SensorEvent_init_zero}}
+#define zmk_ipc_PointerEvent_init_zero           {0, 0, 0, 0, 0, 0}
+#define zmk_ipc_PointerEventBatch_init_zero      {0, {zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero, zmk_ipc_PointerEvent_init_zero}}
+#define zmk_ipc_Hello_init_zero                  {0, 0, 0}
+#define zmk_ipc_SaveCheckpoint_init_zero         {""}
 #define zmk_ipc_ClientMessage_init_zero          {0, {zmk_ipc_KeyEvent_init_zero}}
-#define zmk_ipc_KscanEvent_init_zero             {0, 0, 0, 0}
-#define zmk_ipc_HidKeyboardReport_init_zero      {false, zmk_ipc_Endpoint_init_zero, 0, {0, {0}}}
+#define zmk_ipc_KscanEvent_init_zero             {0, 0, 0, 0, 0}
+#define zmk_ipc_LatencyTrace_init_zero           {0, 0, 0, 0, 0}
+#define zmk_ipc_HidKeyboardReport_init_zero      {false, zmk_ipc_Endpoint_init_zero, 0, {0, {0}}, false, zmk_ipc_LatencyTrace_init_zero, _zmk_ipc_KeyboardReportFormat_MIN}
+#define zmk_ipc_HidKeyboardDelta_init_zero       {0, 0, {0, {0}}, {0, {0}}, 0}
 #define zmk_ipc_HidConsumerReport_init_zero      {false, zmk_ipc_Endpoint_init_zero, {0, {0}}}
 #define zmk_ipc_HidMouseReport_init_zero         {false, zmk_ipc_Endpoint_init_zero, 0, 0, 0, 0, 0}
-#define zmk_ipc_ZmkEvent_init_zero               {0, {zmk_ipc_KscanEvent_init_zero}}
+#define zmk_ipc_EventTypeStats_init_zero         {"", 0, 0, 0, 0, 0, 0, 0}
+#define zmk_ipc_StageTiming_init_zero            {"", 0, 0, 0, 0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0}
+#define zmk_ipc_WorkStats_init_zero              {"", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+#define zmk_ipc_KeyStats_init_zero               {0, 0, 0, 0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0, 0, 0}
+#define zmk_ipc_ThreadStack_init_zero            {"", 0, 0, 0, 0}
+#define zmk_ipc_ClientStats_init_zero            {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+#define zmk_ipc_KscanEventBatch_init_zero        {0, {zmk_ipc_KscanEvent_init_zero, zmk_ipc_KscanEvent_init_zero, zmk_ipc_KscanEvent_init_zero, zmk_ipc_KscanEvent_init_zero, zmk_ipc_KscanEvent_init_zero, zmk_ipc_KscanEvent_init_zero, zmk_ipc_KscanEvent_init_zero, zmk_ipc_KscanEvent_init_zero}, 0}
+#define zmk_ipc_Capabilities_init_zero           {0, 0, 0, 0, 0, 0, 0, 0}
+#define zmk_ipc_KeymapBindings_init_zero         {0, 0, 0, {zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero, zmk_ipc_KeymapBinding_init_zero}, 0, 0}
+#define zmk_ipc_KeymapSetResult_init_zero        {0, 0}
+#define zmk_ipc_CheckpointResult_init_zero       {0}
+#define zmk_ipc_InputCredits_init_zero           {0, 0}
+#define zmk_ipc_LayerStateChanged_init_zero      {0, 0}
+#define zmk_ipc_ModifiersStateChanged_init_zero  {0, 0, 0}
+#define zmk_ipc_EndpointChanged_init_zero        {false, zmk_ipc_Endpoint_init_zero}
+#define zmk_ipc_StateSnapshot_init_zero          {0, 0, 0, false, zmk_ipc_Endpoint_init_zero, false, zmk_ipc_HidKeyboardReport_init_zero, false, zmk_ipc_HidConsumerReport_init_zero, false, zmk_ipc_HidMouseReport_init_zero, 0}
+#define zmk_ipc_ZmkEvent_init_zero               {0, {zmk_ipc_KscanEvent_init_zero}, 0, 0}
 #define zmk_ipc_Empty_init_zero                  {0}
 
 /* Field tags (for use in manual encoding/decoding) */
@@ -203,14 +807,80 @@ extern "C" {
 #define zmk_ipc_KeyEvent_action_tag              1
 #define zmk_ipc_KeyEvent_key_pos_tag             2
 #define zmk_ipc_KeyEvent_position_tag            3
+#define zmk_ipc_KeyEvent_seq_tag                 4
+#define zmk_ipc_KeyEvent_client_ts_tag           5
+#define zmk_ipc_KeyEventBatch_events_tag         1
+#define zmk_ipc_Subscribe_event_mask_tag         1
+#define zmk_ipc_AdvanceTime_ms_tag               1
+#define zmk_ipc_KeymapBinding_behavior_id_tag    1
+#define zmk_ipc_KeymapBinding_param1_tag         2
+#define zmk_ipc_KeymapBinding_param2_tag         3
+#define zmk_ipc_GetKeymapBindings_first_layer_tag 1
+#define zmk_ipc_GetKeymapBindings_layer_count_tag 2
+#define zmk_ipc_GetKeymapBindings_first_position_tag 3
+#define zmk_ipc_GetKeymapBindings_position_count_tag 4
+#define zmk_ipc_SetKeymapBindings_first_layer_tag 1
+#define zmk_ipc_SetKeymapBindings_first_position_tag 2
+#define zmk_ipc_SetKeymapBindings_position_count_tag 3
+#define zmk_ipc_SetKeymapBindings_bindings_tag   4
+#define zmk_ipc_SetKeymapBindings_save_tag       5
+#define zmk_ipc_SetKeymapBindings_reset_tag      6
+#define zmk_ipc_SetKeyboardReportFormat_endpoint_tag 1
+#define zmk_ipc_SetKeyboardReportFormat_format_tag 2
+#define zmk_ipc_SensorEvent_sensor_index_tag     1
+#define zmk_ipc_SensorEvent_val1_tag             2
+#define zmk_ipc_SensorEvent_val2_tag             3
+#define zmk_ipc_SensorEventBatch_events_tag      1
+#define zmk_ipc_PointerEvent_dx_tag              1
+#define zmk_ipc_PointerEvent_dy_tag              2
+#define zmk_ipc_PointerEvent_wheel_tag           3
+#define zmk_ipc_PointerEvent_hwheel_tag          4
+#define zmk_ipc_PointerEvent_buttons_tag         5
+#define zmk_ipc_PointerEvent_sync_tag            6
+#define zmk_ipc_PointerEventBatch_events_tag     1
+#define zmk_ipc_Hello_protocol_version_tag       1
+#define zmk_ipc_Hello_event_mask_tag             2
+#define zmk_ipc_Hello_packed_events_tag          3
+#define zmk_ipc_SaveCheckpoint_path_tag          1
 #define zmk_ipc_ClientMessage_key_event_tag      1
+#define zmk_ipc_ClientMessage_key_batch_tag      2
+#define zmk_ipc_ClientMessage_subscribe_tag      3
+#define zmk_ipc_ClientMessage_advance_time_tag   4
+#define zmk_ipc_ClientMessage_get_event_stats_tag 5
+#define zmk_ipc_ClientMessage_get_keymap_bindings_tag 6
+#define zmk_ipc_ClientMessage_set_keymap_bindings_tag 7
+#define zmk_ipc_ClientMessage_set_keyboard_report_format_tag 8
+#define zmk_ipc_ClientMessage_sensor_event_tag   9
+#define zmk_ipc_ClientMessage_sensor_batch_tag   10
+#define zmk_ipc_ClientMessage_pointer_event_tag  11
+#define zmk_ipc_ClientMessage_pointer_batch_tag  12
+#define zmk_ipc_ClientMessage_get_stage_timings_tag 13
+#define zmk_ipc_ClientMessage_get_work_stats_tag 14
+#define zmk_ipc_ClientMessage_get_thread_stacks_tag 15
+#define zmk_ipc_ClientMessage_get_client_stats_tag 16
+#define zmk_ipc_ClientMessage_hello_tag          17
+#define zmk_ipc_ClientMessage_save_checkpoint_tag 18
+#define zmk_ipc_ClientMessage_get_key_stats_tag  19
 #define zmk_ipc_KscanEvent_source_tag            1
 #define zmk_ipc_KscanEvent_position_tag          2
 #define zmk_ipc_KscanEvent_pressed_tag           3
 #define zmk_ipc_KscanEvent_timestamp_tag         4
+#define zmk_ipc_KscanEvent_context_tag           5
+#define zmk_ipc_LatencyTrace_seq_tag             1
+#define zmk_ipc_LatencyTrace_client_ts_tag       2
+#define zmk_ipc_LatencyTrace_kscan_us_tag        3
+#define zmk_ipc_LatencyTrace_raise_us_tag        4
+#define zmk_ipc_LatencyTrace_report_us_tag       5
 #define zmk_ipc_HidKeyboardReport_endpoint_tag   1
 #define zmk_ipc_HidKeyboardReport_modifiers_tag  2
 #define zmk_ipc_HidKeyboardReport_keys_tag       3
+#define zmk_ipc_HidKeyboardReport_trace_tag      4
+#define zmk_ipc_HidKeyboardReport_format_tag     5
+#define zmk_ipc_HidKeyboardDelta_seq_tag         1
+#define zmk_ipc_HidKeyboardDelta_modifiers_tag   2
+#define zmk_ipc_HidKeyboardDelta_pressed_tag     3
+#define zmk_ipc_HidKeyboardDelta_released_tag    4
+#define zmk_ipc_HidKeyboardDelta_keyframe_tag    5
 #define zmk_ipc_HidConsumerReport_endpoint_tag   1
 #define zmk_ipc_HidConsumerReport_keys_tag       2
 #define zmk_ipc_HidMouseReport_endpoint_tag      1
@@ -219,10 +889,116 @@ extern "C" {
 #define zmk_ipc_HidMouseReport_dy_tag            4
 #define zmk_ipc_HidMouseReport_scroll_x_tag      5
 #define zmk_ipc_HidMouseReport_scroll_y_tag      6
+#define zmk_ipc_EventTypeStats_name_tag          1
+#define zmk_ipc_EventTypeStats_index_tag         2
+#define zmk_ipc_EventTypeStats_count_tag         3
+#define zmk_ipc_EventTypeStats_raised_tag        4
+#define zmk_ipc_EventTypeStats_listeners_invoked_tag 5
+#define zmk_ipc_EventTypeStats_captured_tag      6
+#define zmk_ipc_EventTypeStats_cycles_tag        7
+#define zmk_ipc_EventTypeStats_cycles_per_sec_tag 8
+#define zmk_ipc_StageTiming_name_tag             1
+#define zmk_ipc_StageTiming_index_tag            2
+#define zmk_ipc_StageTiming_count_tag            3
+#define zmk_ipc_StageTiming_samples_tag          4
+#define zmk_ipc_StageTiming_total_cycles_tag     5
+#define zmk_ipc_StageTiming_max_cycles_tag       6
+#define zmk_ipc_StageTiming_buckets_tag          7
+#define zmk_ipc_StageTiming_cycles_per_sec_tag   8
+#define zmk_ipc_WorkStats_name_tag               1
+#define zmk_ipc_WorkStats_index_tag              2
+#define zmk_ipc_WorkStats_count_tag              3
+#define zmk_ipc_WorkStats_submitted_tag          4
+#define zmk_ipc_WorkStats_runs_tag               5
+#define zmk_ipc_WorkStats_total_latency_cycles_tag 6
+#define zmk_ipc_WorkStats_max_latency_cycles_tag 7
+#define zmk_ipc_WorkStats_total_run_cycles_tag   8
+#define zmk_ipc_WorkStats_max_run_cycles_tag     9
+#define zmk_ipc_WorkStats_queue_capacity_tag     10
+#define zmk_ipc_WorkStats_queue_high_water_tag   11
+#define zmk_ipc_WorkStats_cycles_per_sec_tag     12
+#define zmk_ipc_KeyStats_index_tag               1
+#define zmk_ipc_KeyStats_count_tag               2
+#define zmk_ipc_KeyStats_position_tag            3
+#define zmk_ipc_KeyStats_samples_tag             4
+#define zmk_ipc_KeyStats_max_ms_tag              5
+#define zmk_ipc_KeyStats_buckets_tag             6
+#define zmk_ipc_KeyStats_holds_tag               7
+#define zmk_ipc_KeyStats_taps_tag                8
+#define zmk_ipc_KeyStats_retro_taps_tag          9
+#define zmk_ipc_ThreadStack_name_tag             1
+#define zmk_ipc_ThreadStack_index_tag            2
+#define zmk_ipc_ThreadStack_count_tag            3
+#define zmk_ipc_ThreadStack_stack_size_tag       4
+#define zmk_ipc_ThreadStack_stack_used_tag       5
+#define zmk_ipc_ClientStats_index_tag            1
+#define zmk_ipc_ClientStats_count_tag            2
+#define zmk_ipc_ClientStats_requester_tag        3
+#define zmk_ipc_ClientStats_frames_sent_tag      4
+#define zmk_ipc_ClientStats_bytes_sent_tag       5
+#define zmk_ipc_ClientStats_frames_dropped_tag   6
+#define zmk_ipc_ClientStats_queue_depth_tag      7
+#define zmk_ipc_ClientStats_queue_high_water_tag 8
+#define zmk_ipc_ClientStats_queue_capacity_tag   9
+#define zmk_ipc_ClientStats_sndbuf_size_tag      10
+#define zmk_ipc_ClientStats_sndbuf_used_tag      11
+#define zmk_ipc_KscanEventBatch_events_tag       1
+#define zmk_ipc_KscanEventBatch_dropped_tag      2
+#define zmk_ipc_Capabilities_protocol_version_tag 1
+#define zmk_ipc_Capabilities_max_event_frame_tag 2
+#define zmk_ipc_Capabilities_max_message_frame_tag 3
+#define zmk_ipc_Capabilities_event_mask_tag      4
+#define zmk_ipc_Capabilities_message_mask_tag    5
+#define zmk_ipc_Capabilities_rows_tag            6
+#define zmk_ipc_Capabilities_columns_tag         7
+#define zmk_ipc_Capabilities_packed_version_tag  8
+#define zmk_ipc_KeymapBindings_layer_id_tag      1
+#define zmk_ipc_KeymapBindings_first_position_tag 2
+#define zmk_ipc_KeymapBindings_bindings_tag      3
+#define zmk_ipc_KeymapBindings_index_tag         4
+#define zmk_ipc_KeymapBindings_count_tag         5
+#define zmk_ipc_KeymapSetResult_applied_tag      1
+#define zmk_ipc_KeymapSetResult_error_tag        2
+#define zmk_ipc_CheckpointResult_error_tag       1
+#define zmk_ipc_InputCredits_capacity_tag        1
+#define zmk_ipc_InputCredits_consumed_tag        2
+#define zmk_ipc_LayerStateChanged_layer_tag      1
+#define zmk_ipc_LayerStateChanged_active_tag     2
+#define zmk_ipc_ModifiersStateChanged_modifiers_tag 1
+#define zmk_ipc_ModifiersStateChanged_pressed_tag 2
+#define zmk_ipc_ModifiersStateChanged_explicit_modifiers_tag 3
+#define zmk_ipc_EndpointChanged_endpoint_tag     1
+#define zmk_ipc_StateSnapshot_layer_state_tag    1
+#define zmk_ipc_StateSnapshot_default_layer_tag  2
+#define zmk_ipc_StateSnapshot_explicit_modifiers_tag 3
+#define zmk_ipc_StateSnapshot_endpoint_tag       4
+#define zmk_ipc_StateSnapshot_keyboard_tag       5
+#define zmk_ipc_StateSnapshot_consumer_tag       6
+#define zmk_ipc_StateSnapshot_mouse_tag          7
+#define zmk_ipc_StateSnapshot_battery_level_tag  8
 #define zmk_ipc_ZmkEvent_kscan_event_tag         1
 #define zmk_ipc_ZmkEvent_keyboard_tag            2
 #define zmk_ipc_ZmkEvent_consumer_tag            3
 #define zmk_ipc_ZmkEvent_mouse_tag               4
+#define zmk_ipc_ZmkEvent_event_stats_tag         5
+#define zmk_ipc_ZmkEvent_keymap_bindings_tag     6
+#define zmk_ipc_ZmkEvent_keymap_set_result_tag   7
+#define zmk_ipc_ZmkEvent_layer_state_tag         8
+#define zmk_ipc_ZmkEvent_stage_timing_tag        10
+#define zmk_ipc_ZmkEvent_work_stats_tag          11
+#define zmk_ipc_ZmkEvent_thread_stack_tag        12
+#define zmk_ipc_ZmkEvent_state_snapshot_tag      13
+#define zmk_ipc_ZmkEvent_modifiers_state_tag     14
+#define zmk_ipc_ZmkEvent_endpoint_changed_tag    15
+#define zmk_ipc_ZmkEvent_keyboard_delta_tag      16
+#define zmk_ipc_ZmkEvent_client_stats_tag        17
+#define zmk_ipc_ZmkEvent_kscan_batch_tag         18
+#define zmk_ipc_ZmkEvent_capabilities_tag        19
+#define zmk_ipc_ZmkEvent_checkpoint_result_tag   20
+#define zmk_ipc_ZmkEvent_input_credits_tag       21
+#define zmk_ipc_ZmkEvent_key_stats_tag           22
+#define zmk_ipc_ZmkEvent_timestamp_tag           9
+#define zmk_ipc_ZmkEvent_context_tag             23
 
 /* Struct field encoding specification for nanopb */
 #define zmk_ipc_Endpoint_FIELDLIST(X, a) \
@@ -240,32 +1016,212 @@ X(a, STATIC,   SINGULAR, UINT32,   col,               2)
 #define zmk_ipc_KeyEvent_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, UENUM,    action,            1) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (address,key_pos,address.key_pos),   2) \
-X(a, STATIC,   ONEOF,    UINT32,   (address,position,address.position),   3)
+X(a, STATIC,   ONEOF,    UINT32,   (address,position,address.position),   3) \
+X(a, STATIC,   SINGULAR, UINT32,   seq,               4) \
+X(a, STATIC,   SINGULAR, UINT64,   client_ts,         5)
 #define zmk_ipc_KeyEvent_CALLBACK NULL
 #define zmk_ipc_KeyEvent_DEFAULT NULL
 #define zmk_ipc_KeyEvent_address_key_pos_MSGTYPE zmk_ipc_KeyPosition
 
+#define zmk_ipc_KeyEventBatch_FIELDLIST(X, a) \
+X(a, STATIC,   REPEATED, MESSAGE,  events,            1)
+#define zmk_ipc_KeyEventBatch_CALLBACK NULL
+#define zmk_ipc_KeyEventBatch_DEFAULT NULL
+#define zmk_ipc_KeyEventBatch_events_MSGTYPE zmk_ipc_KeyEvent
+
+#define zmk_ipc_Subscribe_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   event_mask,        1)
+#define zmk_ipc_Subscribe_CALLBACK NULL
+#define zmk_ipc_Subscribe_DEFAULT NULL
+
+#define zmk_ipc_AdvanceTime_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   ms,                1)
+#define zmk_ipc_AdvanceTime_CALLBACK NULL
+#define zmk_ipc_AdvanceTime_DEFAULT NULL
+
+#define zmk_ipc_GetEventStats_FIELDLIST(X, a) \
+
+#define zmk_ipc_GetEventStats_CALLBACK NULL
+#define zmk_ipc_GetEventStats_DEFAULT NULL
+
+#define zmk_ipc_GetStageTimings_FIELDLIST(X, a) \
+
+#define zmk_ipc_GetStageTimings_CALLBACK NULL
+#define zmk_ipc_GetStageTimings_DEFAULT NULL
+
+#define zmk_ipc_GetWorkStats_FIELDLIST(X, a) \
+
+#define zmk_ipc_GetWorkStats_CALLBACK NULL
+#define zmk_ipc_GetWorkStats_DEFAULT NULL
+
+#define zmk_ipc_GetKeyStats_FIELDLIST(X, a) \
+
+#define zmk_ipc_GetKeyStats_CALLBACK NULL
+#define zmk_ipc_GetKeyStats_DEFAULT NULL
+
+#define zmk_ipc_GetThreadStacks_FIELDLIST(X, a) \
+
+#define zmk_ipc_GetThreadStacks_CALLBACK NULL
+#define zmk_ipc_GetThreadStacks_DEFAULT NULL
+
+#define zmk_ipc_GetClientStats_FIELDLIST(X, a) \
+
+#define zmk_ipc_GetClientStats_CALLBACK NULL
+#define zmk_ipc_GetClientStats_DEFAULT NULL
+
+#define zmk_ipc_KeymapBinding_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   behavior_id,       1) \
+X(a, STATIC,   SINGULAR, UINT32,   param1,            2) \
+X(a, STATIC,   SINGULAR, UINT32,   param2,            3)
+#define zmk_ipc_KeymapBinding_CALLBACK NULL
+#define zmk_ipc_KeymapBinding_DEFAULT NULL
+
+#define zmk_ipc_GetKeymapBindings_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   first_layer,       1) \
+X(a, STATIC,   SINGULAR, UINT32,   layer_count,       2) \
+X(a, STATIC,   SINGULAR, UINT32,   first_position,    3) \
+X(a, STATIC,   SINGULAR, UINT32,   position_count,    4)
+#define zmk_ipc_GetKeymapBindings_CALLBACK NULL
+#define zmk_ipc_GetKeymapBindings_DEFAULT NULL
+
+#define zmk_ipc_SetKeymapBindings_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   first_layer,       1) \
+X(a, STATIC,   SINGULAR, UINT32,   first_position,    2) \
+X(a, STATIC,   SINGULAR, UINT32,   position_count,    3) \
+X(a, STATIC,   REPEATED, MESSAGE,  bindings,          4) \
+X(a, STATIC,   SINGULAR, BOOL,     save,              5) \
+X(a, STATIC,   SINGULAR, BOOL,     reset,             6)
+#define zmk_ipc_SetKeymapBindings_CALLBACK NULL
+#define zmk_ipc_SetKeymapBindings_DEFAULT NULL
+#define zmk_ipc_SetKeymapBindings_bindings_MSGTYPE zmk_ipc_KeymapBinding
+
+#define zmk_ipc_SetKeyboardReportFormat_FIELDLIST(X, a) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  endpoint,          1) \
+X(a, STATIC,   SINGULAR, UENUM,    format,            2)
+#define zmk_ipc_SetKeyboardReportFormat_CALLBACK NULL
+#define zmk_ipc_SetKeyboardReportFormat_DEFAULT NULL
+#define zmk_ipc_SetKeyboardReportFormat_endpoint_MSGTYPE zmk_ipc_Endpoint
+
+#define zmk_ipc_SensorEvent_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   sensor_index,      1) \
+X(a, STATIC,   SINGULAR, INT32,    val1,              2) \
+X(a, STATIC,   SINGULAR, INT32,    val2,              3)
+#define zmk_ipc_SensorEvent_CALLBACK NULL
+#define zmk_ipc_SensorEvent_DEFAULT NULL
+
+#define zmk_ipc_SensorEventBatch_FIELDLIST(X, a) \
+X(a, STATIC,   REPEATED, MESSAGE,  events,            1)
+#define zmk_ipc_SensorEventBatch_CALLBACK NULL
+#define zmk_ipc_SensorEventBatch_DEFAULT NULL
+#define zmk_ipc_SensorEventBatch_events_MSGTYPE zmk_ipc_SensorEvent
+
+#define zmk_ipc_PointerEvent_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, SINT32,   dx,                1) \
+X(a, STATIC,   SINGULAR, SINT32,   dy,                2) \
+X(a, STATIC,   SINGULAR, SINT32,   wheel,             3) \
+X(a, STATIC,   SINGULAR, SINT32,   hwheel,            4) \
+X(a, STATIC,   SINGULAR, UINT32,   buttons,           5) \
+X(a, STATIC,   SINGULAR, BOOL,     sync,              6)
+#define zmk_ipc_PointerEvent_CALLBACK NULL
+#define zmk_ipc_PointerEvent_DEFAULT NULL
+
+#define zmk_ipc_PointerEventBatch_FIELDLIST(X, a) \
+X(a, STATIC,   REPEATED, MESSAGE,  events,            1)
+#define zmk_ipc_PointerEventBatch_CALLBACK NULL
+#define zmk_ipc_PointerEventBatch_DEFAULT NULL
+#define zmk_ipc_PointerEventBatch_events_MSGTYPE zmk_ipc_PointerEvent
+
+#define zmk_ipc_Hello_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   protocol_version,   1) \
+X(a, STATIC,   SINGULAR, UINT32,   event_mask,        2) \
+X(a, STATIC,   SINGULAR, BOOL,     packed_events,     3)
+#define zmk_ipc_Hello_CALLBACK NULL
+#define zmk_ipc_Hello_DEFAULT NULL
+
+#define zmk_ipc_SaveCheckpoint_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   path,              1)
+#define zmk_ipc_SaveCheckpoint_CALLBACK NULL
+#define zmk_ipc_SaveCheckpoint_DEFAULT NULL
+
 #define zmk_ipc_ClientMessage_FIELDLIST(X, a) \
-X(a, STATIC,   ONEOF,    MESSAGE,  (payload,key_event,payload.key_event),   1)
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,key_event,payload.key_event),   1) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,key_batch,payload.key_batch),   2) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,subscribe,payload.subscribe),   3) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,advance_time,payload.advance_time),   4) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,get_event_stats,payload.get_event_stats),   5) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,get_keymap_bindings,payload.get_keymap_bindings),   6) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,set_keymap_bindings,payload.set_keymap_bindings),   7) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,set_keyboard_report_format,payload.set_keyboard_report_format),   8) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,sensor_event,payload.sensor_event),   9) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,sensor_batch,payload.sensor_batch),  10) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,pointer_event,payload.pointer_event),  11) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,pointer_batch,payload.pointer_batch),  12) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,get_stage_timings,payload.get_stage_timings),  13) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,get_work_stats,payload.get_work_stats),  14) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,get_thread_stacks,payload.get_thread_stacks),  15) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,get_client_stats,payload.get_client_stats),  16) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,hello,payload.hello),  17) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,save_checkpoint,payload.save_checkpoint),  18) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,get_key_stats,payload.get_key_stats),  19)
 #define zmk_ipc_ClientMessage_CALLBACK NULL
 #define zmk_ipc_ClientMessage_DEFAULT NULL
 #define zmk_ipc_ClientMessage_payload_key_event_MSGTYPE zmk_ipc_KeyEvent
+#define zmk_ipc_ClientMessage_payload_key_batch_MSGTYPE zmk_ipc_KeyEventBatch
+#define zmk_ipc_ClientMessage_payload_subscribe_MSGTYPE zmk_ipc_Subscribe
+#define zmk_ipc_ClientMessage_payload_advance_time_MSGTYPE zmk_ipc_AdvanceTime
+#define zmk_ipc_ClientMessage_payload_get_event_stats_MSGTYPE zmk_ipc_GetEventStats
+#define zmk_ipc_ClientMessage_payload_get_keymap_bindings_MSGTYPE zmk_ipc_GetKeymapBindings
+#define zmk_ipc_ClientMessage_payload_set_keymap_bindings_MSGTYPE zmk_ipc_SetKeymapBindings
+#define zmk_ipc_ClientMessage_payload_set_keyboard_report_format_MSGTYPE zmk_ipc_SetKeyboardReportFormat
+#define zmk_ipc_ClientMessage_payload_sensor_event_MSGTYPE zmk_ipc_SensorEvent
+#define zmk_ipc_ClientMessage_payload_sensor_batch_MSGTYPE zmk_ipc_SensorEventBatch
+#define zmk_ipc_ClientMessage_payload_pointer_event_MSGTYPE zmk_ipc_PointerEvent
+#define zmk_ipc_ClientMessage_payload_pointer_batch_MSGTYPE zmk_ipc_PointerEventBatch
+#define zmk_ipc_ClientMessage_payload_get_stage_timings_MSGTYPE zmk_ipc_GetStageTimings
+#define zmk_ipc_ClientMessage_payload_get_work_stats_MSGTYPE zmk_ipc_GetWorkStats
+#define zmk_ipc_ClientMessage_payload_get_thread_stacks_MSGTYPE zmk_ipc_GetThreadStacks
+#define zmk_ipc_ClientMessage_payload_get_client_stats_MSGTYPE zmk_ipc_GetClientStats
+#define zmk_ipc_ClientMessage_payload_hello_MSGTYPE zmk_ipc_Hello
+#define zmk_ipc_ClientMessage_payload_save_checkpoint_MSGTYPE zmk_ipc_SaveCheckpoint
+#define zmk_ipc_ClientMessage_payload_get_key_stats_MSGTYPE zmk_ipc_GetKeyStats
 
 #define zmk_ipc_KscanEvent_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, UINT32,   source,            1) \
 X(a, STATIC,   SINGULAR, UINT32,   position,          2) \
 X(a, STATIC,   SINGULAR, BOOL,     pressed,           3) \
-X(a, STATIC,   SINGULAR, INT64,    timestamp,         4)
+X(a, STATIC,   SINGULAR, INT64,    timestamp,         4) \
+X(a, STATIC,   SINGULAR, UINT32,   context,           5)
 #define zmk_ipc_KscanEvent_CALLBACK NULL
 #define zmk_ipc_KscanEvent_DEFAULT NULL
 
+#define zmk_ipc_LatencyTrace_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   seq,               1) \
+X(a, STATIC,   SINGULAR, UINT64,   client_ts,         2) \
+X(a, STATIC,   SINGULAR, INT64,    kscan_us,          3) \
+X(a, STATIC,   SINGULAR, INT64,    raise_us,          4) \
+X(a, STATIC,   SINGULAR, INT64,    report_us,         5)
+#define zmk_ipc_LatencyTrace_CALLBACK NULL
+#define zmk_ipc_LatencyTrace_DEFAULT NULL
+
 #define zmk_ipc_HidKeyboardReport_FIELDLIST(X, a) \
 X(a, STATIC,   OPTIONAL, MESSAGE,  endpoint,          1) \
 X(a, STATIC,   SINGULAR, UINT32,   modifiers,         2) \
-X(a, STATIC,   SINGULAR, BYTES,    keys,              3)
+X(a, STATIC,   SINGULAR, BYTES,    keys,              3) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  trace,             4) \
+X(a, STATIC,   SINGULAR, UENUM,    format,            5)
 #define zmk_ipc_HidKeyboardReport_CALLBACK NULL
 #define zmk_ipc_HidKeyboardReport_DEFAULT NULL
 #define zmk_ipc_HidKeyboardReport_endpoint_MSGTYPE zmk_ipc_Endpoint
+#define zmk_ipc_HidKeyboardReport_trace_MSGTYPE zmk_ipc_LatencyTrace
+
+#define zmk_ipc_HidKeyboardDelta_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   seq,               1) \
+X(a, STATIC,   SINGULAR, UINT32,   modifiers,         2) \
+X(a, STATIC,   SINGULAR, BYTES,    pressed,           3) \
+X(a, STATIC,   SINGULAR, BYTES,    released,          4) \
+X(a, STATIC,   SINGULAR, BOOL,     keyframe,          5)
+#define zmk_ipc_HidKeyboardDelta_CALLBACK NULL
+#define zmk_ipc_HidKeyboardDelta_DEFAULT NULL
 
 #define zmk_ipc_HidConsumerReport_FIELDLIST(X, a) \
 X(a, STATIC,   OPTIONAL, MESSAGE,  endpoint,          1) \
@@ -285,17 +1241,211 @@ X(a, STATIC,   SINGULAR, SINT32,   scroll_y,          6)
 #define zmk_ipc_HidMouseReport_DEFAULT NULL
 #define zmk_ipc_HidMouseReport_endpoint_MSGTYPE zmk_ipc_Endpoint
 
+#define zmk_ipc_EventTypeStats_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   name,              1) \
+X(a, STATIC,   SINGULAR, UINT32,   index,             2) \
+X(a, STATIC,   SINGULAR, UINT32,   count,             3) \
+X(a, STATIC,   SINGULAR, UINT32,   raised,            4) \
+X(a, STATIC,   SINGULAR, UINT32,   listeners_invoked,   5) \
+X(a, STATIC,   SINGULAR, UINT32,   captured,          6) \
+X(a, STATIC,   SINGULAR, UINT64,   cycles,            7) \
+X(a, STATIC,   SINGULAR, UINT32,   cycles_per_sec,    8)
+#define zmk_ipc_EventTypeStats_CALLBACK NULL
+#define zmk_ipc_EventTypeStats_DEFAULT NULL
+
+#define zmk_ipc_StageTiming_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   name,              1) \
+X(a, STATIC,   SINGULAR, UINT32,   index,             2) \
+X(a, STATIC,   SINGULAR, UINT32,   count,             3) \
+X(a, STATIC,   SINGULAR, UINT32,   samples,           4) \
+X(a, STATIC,   SINGULAR, UINT64,   total_cycles,      5) \
+X(a, STATIC,   SINGULAR, UINT32,   max_cycles,        6) \
+X(a, STATIC,   REPEATED, UINT32,   buckets,           7) \
+X(a, STATIC,   SINGULAR, UINT32,   cycles_per_sec,    8)
+#define zmk_ipc_StageTiming_CALLBACK NULL
+#define zmk_ipc_StageTiming_DEFAULT NULL
+
+#define zmk_ipc_WorkStats_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   name,              1) \
+X(a, STATIC,   SINGULAR, UINT32,   index,             2) \
+X(a, STATIC,   SINGULAR, UINT32,   count,             3) \
+X(a, STATIC,   SINGULAR, UINT32,   submitted,         4) \
+X(a, STATIC,   SINGULAR, UINT32,   runs,              5) \
+X(a, STATIC,   SINGULAR, UINT64,   total_latency_cycles,   6) \
+X(a, STATIC,   SINGULAR, UINT32,   max_latency_cycles,   7) \
+X(a, STATIC,   SINGULAR, UINT64,   total_run_cycles,   8) \
+X(a, STATIC,   SINGULAR, UINT32,   max_run_cycles,    9) \
+X(a, STATIC,   SINGULAR, UINT32,   queue_capacity,   10) \
+X(a, STATIC,   SINGULAR, UINT32,   queue_high_water,  11) \
+X(a, STATIC,   SINGULAR, UINT32,   cycles_per_sec,   12)
+#define zmk_ipc_WorkStats_CALLBACK NULL
+#define zmk_ipc_WorkStats_DEFAULT NULL
+
+#define zmk_ipc_KeyStats_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   index,             1) \
+X(a, STATIC,   SINGULAR, UINT32,   count,             2) \
+X(a, STATIC,   SINGULAR, SINT32,   position,          3) \
+X(a, STATIC,   SINGULAR, UINT32,   samples,           4) \
+X(a, STATIC,   SINGULAR, UINT32,   max_ms,            5) \
+X(a, STATIC,   REPEATED, UINT32,   buckets,           6) \
+X(a, STATIC,   SINGULAR, UINT32,   holds,             7) \
+X(a, STATIC,   SINGULAR, UINT32,   taps,              8) \
+X(a, STATIC,   SINGULAR, UINT32,   retro_taps,        9)
+#define zmk_ipc_KeyStats_CALLBACK NULL
+#define zmk_ipc_KeyStats_DEFAULT NULL
+
+#define zmk_ipc_ThreadStack_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   name,              1) \
+X(a, STATIC,   SINGULAR, UINT32,   index,             2) \
+X(a, STATIC,   SINGULAR, UINT32,   count,             3) \
+X(a, STATIC,   SINGULAR, UINT32,   stack_size,        4) \
+X(a, STATIC,   SINGULAR, UINT32,   stack_used,        5)
+#define zmk_ipc_ThreadStack_CALLBACK NULL
+#define zmk_ipc_ThreadStack_DEFAULT NULL
+
+#define zmk_ipc_ClientStats_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   index,             1) \
+X(a, STATIC,   SINGULAR, UINT32,   count,             2) \
+X(a, STATIC,   SINGULAR, BOOL,     requester,         3) \
+X(a, STATIC,   SINGULAR, UINT32,   frames_sent,       4) \
+X(a, STATIC,   SINGULAR, UINT64,   bytes_sent,        5) \
+X(a, STATIC,   SINGULAR, UINT32,   frames_dropped,    6) \
+X(a, STATIC,   SINGULAR, UINT32,   queue_depth,       7) \
+X(a, STATIC,   SINGULAR, UINT32,   queue_high_water,   8) \
+X(a, STATIC,   SINGULAR, UINT32,   queue_capacity,    9) \
+X(a, STATIC,   SINGULAR, UINT32,   sndbuf_size,      10) \
+X(a, STATIC,   SINGULAR, UINT32,   sndbuf_used,      11)
+#define zmk_ipc_ClientStats_CALLBACK NULL
+#define zmk_ipc_ClientStats_DEFAULT NULL
+
+#define zmk_ipc_KscanEventBatch_FIELDLIST(X, a) \
+X(a, STATIC,   REPEATED, MESSAGE,  events,            1) \
+X(a, STATIC,   SINGULAR, UINT32,   dropped,           2)
+#define zmk_ipc_KscanEventBatch_CALLBACK NULL
+#define zmk_ipc_KscanEventBatch_DEFAULT NULL
+#define zmk_ipc_KscanEventBatch_events_MSGTYPE zmk_ipc_KscanEvent
+
+#define zmk_ipc_Capabilities_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   protocol_version,   1) \
+X(a, STATIC,   SINGULAR, UINT32,   max_event_frame,   2) \
+X(a, STATIC,   SINGULAR, UINT32,   max_message_frame,   3) \
+X(a, STATIC,   SINGULAR, UINT32,   event_mask,        4) \
+X(a, STATIC,   SINGULAR, UINT32,   message_mask,      5) \
+X(a, STATIC,   SINGULAR, UINT32,   rows,              6) \
+X(a, STATIC,   SINGULAR, UINT32,   columns,           7) \
+X(a, STATIC,   SINGULAR, UINT32,   packed_version,    8)
+#define zmk_ipc_Capabilities_CALLBACK NULL
+#define zmk_ipc_Capabilities_DEFAULT NULL
+
+#define zmk_ipc_KeymapBindings_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   layer_id,          1) \
+X(a, STATIC,   SINGULAR, UINT32,   first_position,    2) \
+X(a, STATIC,   REPEATED, MESSAGE,  bindings,          3) \
+X(a, STATIC,   SINGULAR, UINT32,   index,             4) \
+X(a, STATIC,   SINGULAR, UINT32,   count,             5)
+#define zmk_ipc_KeymapBindings_CALLBACK NULL
+#define zmk_ipc_KeymapBindings_DEFAULT NULL
+#define zmk_ipc_KeymapBindings_bindings_MSGTYPE zmk_ipc_KeymapBinding
+
+#define zmk_ipc_KeymapSetResult_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   applied,           1) \
+X(a, STATIC,   SINGULAR, SINT32,   error,             2)
+#define zmk_ipc_KeymapSetResult_CALLBACK NULL
+#define zmk_ipc_KeymapSetResult_DEFAULT NULL
+
+#define zmk_ipc_CheckpointResult_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, SINT32,   error,             1)
+#define zmk_ipc_CheckpointResult_CALLBACK NULL
+#define zmk_ipc_CheckpointResult_DEFAULT NULL
+
+#define zmk_ipc_InputCredits_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   capacity,          1) \
+X(a, STATIC,   SINGULAR, UINT32,   consumed,          2)
+#define zmk_ipc_InputCredits_CALLBACK NULL
+#define zmk_ipc_InputCredits_DEFAULT NULL
+
+#define zmk_ipc_LayerStateChanged_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   layer,             1) \
+X(a, STATIC,   SINGULAR, BOOL,     active,            2)
+#define zmk_ipc_LayerStateChanged_CALLBACK NULL
+#define zmk_ipc_LayerStateChanged_DEFAULT NULL
+
+#define zmk_ipc_ModifiersStateChanged_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   modifiers,         1) \
+X(a, STATIC,   SINGULAR, BOOL,     pressed,           2) \
+X(a, STATIC,   SINGULAR, UINT32,   explicit_modifiers,   3)
+#define zmk_ipc_ModifiersStateChanged_CALLBACK NULL
+#define zmk_ipc_ModifiersStateChanged_DEFAULT NULL
+
+#define zmk_ipc_EndpointChanged_FIELDLIST(X, a) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  endpoint,          1)
+#define zmk_ipc_EndpointChanged_CALLBACK NULL
+#define zmk_ipc_EndpointChanged_DEFAULT NULL
+#define zmk_ipc_EndpointChanged_endpoint_MSGTYPE zmk_ipc_Endpoint
+
+#define zmk_ipc_StateSnapshot_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   layer_state,       1) \
+X(a, STATIC,   SINGULAR, UINT32,   default_layer,     2) \
+X(a, STATIC,   SINGULAR, UINT32,   explicit_modifiers,   3) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  endpoint,          4) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  keyboard,          5) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  consumer,          6) \
+X(a, STATIC,   OPTIONAL, MESSAGE,  mouse,             7) \
+X(a, STATIC,   SINGULAR, SINT32,   battery_level,     8)
+#define zmk_ipc_StateSnapshot_CALLBACK NULL
+#define zmk_ipc_StateSnapshot_DEFAULT NULL
+#define zmk_ipc_StateSnapshot_endpoint_MSGTYPE zmk_ipc_Endpoint
+#define zmk_ipc_StateSnapshot_keyboard_MSGTYPE zmk_ipc_HidKeyboardReport
+#define zmk_ipc_StateSnapshot_consumer_MSGTYPE zmk_ipc_HidConsumerReport
+#define zmk_ipc_StateSnapshot_mouse_MSGTYPE zmk_ipc_HidMouseReport
+
 #define zmk_ipc_ZmkEvent_FIELDLIST(X, a) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (payload,kscan_event,payload.kscan_event),   1) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (payload,keyboard,payload.keyboard),   2) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (payload,consumer,payload.consumer),   3) \
-X(a, STATIC,   ONEOF,    MESSAGE,  (payload,mouse,payload.mouse),   4)
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,mouse,payload.mouse),   4) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,event_stats,payload.event_stats),   5) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,keymap_bindings,payload.keymap_bindings),   6) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,keymap_set_result,payload.keymap_set_result),   7) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,layer_state,payload.layer_state),   8) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,stage_timing,payload.stage_timing),  10) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,work_stats,payload.work_stats),  11) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,thread_stack,payload.thread_stack),  12) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,state_snapshot,payload.state_snapshot),  13) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,modifiers_state,payload.modifiers_state),  14) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,endpoint_changed,payload.endpoint_changed),  15) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,keyboard_delta,payload.keyboard_delta),  16) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,client_stats,payload.client_stats),  17) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,kscan_batch,payload.kscan_batch),  18) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,capabilities,payload.capabilities),  19) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,checkpoint_result,payload.checkpoint_result),  20) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,input_credits,payload.input_credits),  21) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,key_stats,payload.key_stats),  22) \
+X(a, STATIC,   SINGULAR, INT64,    timestamp,         9) \
+X(a, STATIC,   SINGULAR, UINT32,   context,          23)
 #define zmk_ipc_ZmkEvent_CALLBACK NULL
 #define zmk_ipc_ZmkEvent_DEFAULT NULL
 #define zmk_ipc_ZmkEvent_payload_kscan_event_MSGTYPE zmk_ipc_KscanEvent
 #define zmk_ipc_ZmkEvent_payload_keyboard_MSGTYPE zmk_ipc_HidKeyboardReport
 #define zmk_ipc_ZmkEvent_payload_consumer_MSGTYPE zmk_ipc_HidConsumerReport
 #define zmk_ipc_ZmkEvent_payload_mouse_MSGTYPE zmk_ipc_HidMouseReport
+#define zmk_ipc_ZmkEvent_payload_event_stats_MSGTYPE zmk_ipc_EventTypeStats
+#define zmk_ipc_ZmkEvent_payload_keymap_bindings_MSGTYPE zmk_ipc_KeymapBindings
+#define zmk_ipc_ZmkEvent_payload_keymap_set_result_MSGTYPE zmk_ipc_KeymapSetResult
+#define zmk_ipc_ZmkEvent_payload_layer_state_MSGTYPE zmk_ipc_LayerStateChanged
+#define zmk_ipc_ZmkEvent_payload_stage_timing_MSGTYPE zmk_ipc_StageTiming
+#define zmk_ipc_ZmkEvent_payload_work_stats_MSGTYPE zmk_ipc_WorkStats
+#define zmk_ipc_ZmkEvent_payload_thread_stack_MSGTYPE zmk_ipc_ThreadStack
+#define zmk_ipc_ZmkEvent_payload_state_snapshot_MSGTYPE zmk_ipc_StateSnapshot
+#define zmk_ipc_ZmkEvent_payload_modifiers_state_MSGTYPE zmk_ipc_ModifiersStateChanged
+#define zmk_ipc_ZmkEvent_payload_endpoint_changed_MSGTYPE zmk_ipc_EndpointChanged
+#define zmk_ipc_ZmkEvent_payload_keyboard_delta_MSGTYPE zmk_ipc_HidKeyboardDelta
+#define zmk_ipc_ZmkEvent_payload_client_stats_MSGTYPE zmk_ipc_ClientStats
+#define zmk_ipc_ZmkEvent_payload_kscan_batch_MSGTYPE zmk_ipc_KscanEventBatch
+#define zmk_ipc_ZmkEvent_payload_capabilities_MSGTYPE zmk_ipc_Capabilities
+#define zmk_ipc_ZmkEvent_payload_checkpoint_result_MSGTYPE zmk_ipc_CheckpointResult
+#define zmk_ipc_ZmkEvent_payload_input_credits_MSGTYPE zmk_ipc_InputCredits
+#define zmk_ipc_ZmkEvent_payload_key_stats_MSGTYPE zmk_ipc_KeyStats
 
 #define zmk_ipc_Empty_FIELDLIST(X, a) \
 
@@ -305,11 +1455,48 @@ X(a, STATIC,   ONEOF,    MESSAGE,  (payload,mouse,payload.mouse),   4)
 extern const pb_msgdesc_t zmk_ipc_Endpoint_msg;
 extern const pb_msgdesc_t zmk_ipc_KeyPosition_msg;
 extern const pb_msgdesc_t zmk_ipc_KeyEvent_msg;
+extern const pb_msgdesc_t zmk_ipc_KeyEventBatch_msg;
+extern const pb_msgdesc_t zmk_ipc_Subscribe_msg;
+extern const pb_msgdesc_t zmk_ipc_AdvanceTime_msg;
+extern const pb_msgdesc_t zmk_ipc_GetEventStats_msg;
+extern const pb_msgdesc_t zmk_ipc_GetStageTimings_msg;
+extern const pb_msgdesc_t zmk_ipc_GetWorkStats_msg;
+extern const pb_msgdesc_t zmk_ipc_GetKeyStats_msg;
+extern const pb_msgdesc_t zmk_ipc_GetThreadStacks_msg;
+extern const pb_msgdesc_t zmk_ipc_GetClientStats_msg;
+extern const pb_msgdesc_t zmk_ipc_KeymapBinding_msg;
+extern const pb_msgdesc_t zmk_ipc_GetKeymapBindings_msg;
+extern const pb_msgdesc_t zmk_ipc_SetKeymapBindings_msg;
+extern const pb_msgdesc_t zmk_ipc_SetKeyboardReportFormat_msg;
+extern const pb_msgdesc_t zmk_ipc_SensorEvent_msg;
+extern const pb_msgdesc_t zmk_ipc_SensorEventBatch_msg;
+extern const pb_msgdesc_t zmk_ipc_PointerEvent_msg;
+extern const pb_msgdesc_t zmk_ipc_PointerEventBatch_msg;
+extern const pb_msgdesc_t zmk_ipc_Hello_msg;
+extern const pb_msgdesc_t zmk_ipc_SaveCheckpoint_msg;
 extern const pb_msgdesc_t zmk_ipc_ClientMessage_msg;
 extern const pb_msgdesc_t zmk_ipc_KscanEvent_msg;
+extern const pb_msgdesc_t zmk_ipc_LatencyTrace_msg;
 extern const pb_msgdesc_t zmk_ipc_HidKeyboardReport_msg;
+extern const pb_msgdesc_t zmk_ipc_HidKeyboardDelta_msg;
 extern const pb_msgdesc_t zmk_ipc_HidConsumerReport_msg;
 extern const pb_msgdesc_t zmk_ipc_HidMouseReport_msg;
+extern const pb_msgdesc_t zmk_ipc_EventTypeStats_msg;
+extern const pb_msgdesc_t zmk_ipc_StageTiming_msg;
+extern const pb_msgdesc_t zmk_ipc_WorkStats_msg;
+extern const pb_msgdesc_t zmk_ipc_KeyStats_msg;
+extern const pb_msgdesc_t zmk_ipc_ThreadStack_msg;
+extern const pb_msgdesc_t zmk_ipc_ClientStats_msg;
+extern const pb_msgdesc_t zmk_ipc_KscanEventBatch_msg;
+extern const pb_msgdesc_t zmk_ipc_Capabilities_msg;
+extern const pb_msgdesc_t zmk_ipc_KeymapBindings_msg;
+extern const pb_msgdesc_t zmk_ipc_KeymapSetResult_msg;
+extern const pb_msgdesc_t zmk_ipc_CheckpointResult_msg;
+extern const pb_msgdesc_t zmk_ipc_InputCredits_msg;
+extern const pb_msgdesc_t zmk_ipc_LayerStateChanged_msg;
+extern const pb_msgdesc_t zmk_ipc_ModifiersStateChanged_msg;
+extern const pb_msgdesc_t zmk_ipc_EndpointChanged_msg;
+extern const pb_msgdesc_t zmk_ipc_StateSnapshot_msg;
 extern const pb_msgdesc_t zmk_ipc_ZmkEvent_msg;
 extern const pb_msgdesc_t zmk_ipc_Empty_msg;
 
@@ -317,26 +1504,100 @@ extern const pb_msgdesc_t zmk_ipc_Empty_msg;
 #define zmk_ipc_Endpoint_fields &zmk_ipc_Endpoint_msg
 #define zmk_ipc_KeyPosition_fields &zmk_ipc_KeyPosition_msg
 #define zmk_ipc_KeyEvent_fields &zmk_ipc_KeyEvent_msg
+#define zmk_ipc_KeyEventBatch_fields &zmk_ipc_KeyEventBatch_msg
+#define zmk_ipc_Subscribe_fields &zmk_ipc_Subscribe_msg
+#define zmk_ipc_AdvanceTime_fields &zmk_ipc_AdvanceTime_msg
+#define zmk_ipc_GetEventStats_fields &zmk_ipc_GetEventStats_msg
+#define zmk_ipc_GetStageTimings_fields &zmk_ipc_GetStageTimings_msg
+#define zmk_ipc_GetWorkStats_fields &zmk_ipc_GetWorkStats_msg
+#define zmk_ipc_GetKeyStats_fields &zmk_ipc_GetKeyStats_msg
+#define zmk_ipc_GetThreadStacks_fields &zmk_ipc_GetThreadStacks_msg
+#define zmk_ipc_GetClientStats_fields &zmk_ipc_GetClientStats_msg
+#define zmk_ipc_KeymapBinding_fields &zmk_ipc_KeymapBinding_msg
+#define zmk_ipc_GetKeymapBindings_fields &zmk_ipc_GetKeymapBindings_msg
+#define zmk_ipc_SetKeymapBindings_fields &zmk_ipc_SetKeymapBindings_msg
+#define zmk_ipc_SetKeyboardReportFormat_fields &zmk_ipc_SetKeyboardReportFormat_msg
+#define zmk_ipc_SensorEvent_fields &zmk_ipc_SensorEvent_msg
+#define zmk_ipc_SensorEventBatch_fields &zmk_ipc_SensorEventBatch_msg
+#define zmk_ipc_PointerEvent_fields &zmk_ipc_PointerEvent_msg
+#define zmk_ipc_PointerEventBatch_fields &zmk_ipc_PointerEventBatch_msg
+#define zmk_ipc_Hello_fields &zmk_ipc_Hello_msg
+#define zmk_ipc_SaveCheckpoint_fields &zmk_ipc_SaveCheckpoint_msg
 #define zmk_ipc_ClientMessage_fields &zmk_ipc_ClientMessage_msg
 #define zmk_ipc_KscanEvent_fields &zmk_ipc_KscanEvent_msg
+#define zmk_ipc_LatencyTrace_fields &zmk_ipc_LatencyTrace_msg
 #define zmk_ipc_HidKeyboardReport_fields &zmk_ipc_HidKeyboardReport_msg
+#define zmk_ipc_HidKeyboardDelta_fields &zmk_ipc_HidKeyboardDelta_msg
 #define zmk_ipc_HidConsumerReport_fields &zmk_ipc_HidConsumerReport_msg
 #define zmk_ipc_HidMouseReport_fields &zmk_ipc_HidMouseReport_msg
+#define zmk_ipc_EventTypeStats_fields &zmk_ipc_EventTypeStats_msg
+#define zmk_ipc_StageTiming_fields &zmk_ipc_StageTiming_msg
+#define zmk_ipc_WorkStats_fields &zmk_ipc_WorkStats_msg
+#define zmk_ipc_KeyStats_fields &zmk_ipc_KeyStats_msg
+#define zmk_ipc_ThreadStack_fields &zmk_ipc_ThreadStack_msg
+#define zmk_ipc_ClientStats_fields &zmk_ipc_ClientStats_msg
+#define zmk_ipc_KscanEventBatch_fields &zmk_ipc_KscanEventBatch_msg
+#define zmk_ipc_Capabilities_fields &zmk_ipc_Capabilities_msg
+#define zmk_ipc_KeymapBindings_fields &zmk_ipc_KeymapBindings_msg
+#define zmk_ipc_KeymapSetResult_fields &zmk_ipc_KeymapSetResult_msg
+#define zmk_ipc_CheckpointResult_fields &zmk_ipc_CheckpointResult_msg
+#define zmk_ipc_InputCredits_fields &zmk_ipc_InputCredits_msg
+#define zmk_ipc_LayerStateChanged_fields &zmk_ipc_LayerStateChanged_msg
+#define zmk_ipc_ModifiersStateChanged_fields &zmk_ipc_ModifiersStateChanged_msg
+#define zmk_ipc_EndpointChanged_fields &zmk_ipc_EndpointChanged_msg
+#define zmk_ipc_StateSnapshot_fields &zmk_ipc_StateSnapshot_msg
 #define zmk_ipc_ZmkEvent_fields &zmk_ipc_ZmkEvent_msg
 #define zmk_ipc_Empty_fields &zmk_ipc_Empty_msg
 
 /* Maximum encoded size of messages (where known) */
-#define ZMK_IPC_ZMK_IPC_PB_H_MAX_SIZE            zmk_ipc_ZmkEvent_size
-#define zmk_ipc_ClientMessage_size               18
+#define ZMK_IPC_ZMK_IPC_PB_H_MAX_SIZE            zmk_ipc_ClientMessage_size
+#define zmk_ipc_AdvanceTime_size                 6
+#define zmk_ipc_Capabilities_size                48
+#define zmk_ipc_CheckpointResult_size            6
+#define zmk_ipc_ClientMessage_size               8963
+#define zmk_ipc_ClientStats_size                 67
 #define zmk_ipc_Empty_size                       0
+#define zmk_ipc_EndpointChanged_size             10
 #define zmk_ipc_Endpoint_size                    8
+#define zmk_ipc_EventTypeStats_size              96
+#define zmk_ipc_GetClientStats_size              0
+#define zmk_ipc_GetEventStats_size               0
+#define zmk_ipc_GetKeyStats_size                 0
+#define zmk_ipc_GetKeymapBindings_size           24
+#define zmk_ipc_GetStageTimings_size             0
+#define zmk_ipc_GetThreadStacks_size             0
+#define zmk_ipc_GetWorkStats_size                0
+#define zmk_ipc_Hello_size                       14
 #define zmk_ipc_HidConsumerReport_size           28
-#define zmk_ipc_HidKeyboardReport_size           50
+#define zmk_ipc_HidKeyboardDelta_size            146
+#define zmk_ipc_HidKeyboardReport_size           104
 #define zmk_ipc_HidMouseReport_size              40
-#define zmk_ipc_KeyEvent_size                    16
+#define zmk_ipc_InputCredits_size                12
+#define zmk_ipc_KeyEventBatch_size               8960
+#define zmk_ipc_KeyEvent_size                    33
 #define zmk_ipc_KeyPosition_size                 12
-#define zmk_ipc_KscanEvent_size                  25
-#define zmk_ipc_ZmkEvent_size                    52
+#define zmk_ipc_KeyStats_size                    130
+#define zmk_ipc_KeymapBinding_size               18
+#define zmk_ipc_KeymapBindings_size              344
+#define zmk_ipc_KeymapSetResult_size             12
+#define zmk_ipc_KscanEventBatch_size             270
+#define zmk_ipc_KscanEvent_size                  31
+#define zmk_ipc_LatencyTrace_size                50
+#define zmk_ipc_LayerStateChanged_size           8
+#define zmk_ipc_ModifiersStateChanged_size       14
+#define zmk_ipc_PointerEventBatch_size           8704
+#define zmk_ipc_PointerEvent_size                32
+#define zmk_ipc_SaveCheckpoint_size              258
+#define zmk_ipc_SensorEventBatch_size            7680
+#define zmk_ipc_SensorEvent_size                 28
+#define zmk_ipc_SetKeyboardReportFormat_size     12
+#define zmk_ipc_SetKeymapBindings_size           5142
+#define zmk_ipc_StageTiming_size                 229
+#define zmk_ipc_StateSnapshot_size               212
+#define zmk_ipc_Subscribe_size                   6
+#define zmk_ipc_ThreadStack_size                 57
+#define zmk_ipc_WorkStats_size                   101
+#define zmk_ipc_ZmkEvent_size                    365
 
 #ifdef __cplusplus
 } /* extern "C" */
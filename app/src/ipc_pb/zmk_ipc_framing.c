@@ -9,110 +9,151 @@
 #include <pb_encode.h>
 #include <pb_decode.h>
 
-#include <zephyr/sys/byteorder.h>
-#include <zephyr/logging/log.h>
-
 #include <sys/socket.h>
 #include <unistd.h>
 #include <errno.h>
 #include <string.h>
 
+#if defined(__ZEPHYR__)
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/logging/log.h>
+
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+#else
+/* Host builds (sample_app/client/) have no logging; errors are returned as codes. */
+#define LOG_WRN(...) ((void)0)
+#define LOG_ERR(...) ((void)0)
+
+static inline void sys_put_be32(uint32_t val, uint8_t dst[4]) {
+    dst[0] = val >> 24;
+    dst[1] = val >> 16;
+    dst[2] = val >> 8;
+    dst[3] = val;
+}
+
+static inline uint32_t sys_get_be32(const uint8_t src[4]) {
+    return (uint32_t)src[0] << 24 | (uint32_t)src[1] << 16 | (uint32_t)src[2] << 8 | src[3];
+}
+#endif
 
 /* -------------------------------------------------------------------------
- * Internal helper: read exactly `len` bytes from fd (blocking)
+ * Internal helpers
  * ------------------------------------------------------------------------- */
 
-static int recv_exact(int fd, uint8_t *buf, size_t len) {
-    size_t received = 0;
+static int decode_client_message(const uint8_t *body, size_t len,
+                                 zmk_ipc_ClientMessage *msg) {
+    pb_istream_t stream = pb_istream_from_buffer(body, len);
+    *msg = (zmk_ipc_ClientMessage)zmk_ipc_ClientMessage_init_zero;
+
+    if (!pb_decode(&stream, &zmk_ipc_ClientMessage_msg, msg)) {
+        LOG_WRN("zmk_ipc: pb_decode ClientMessage failed: %s", PB_GET_ERROR(&stream));
+        return -EBADMSG;
+    }
+
+    return 0;
+}
+
+/* Pull whatever the socket has available into the free tail of the buffer. */
+static int reader_fill(struct zmk_ipc_frame_reader *reader) {
+    size_t pending = reader->len - reader->pos;
+
+    if (reader->pos > 0) {
+        memmove(reader->buf, reader->buf + reader->pos, pending);
+        reader->pos = 0;
+        reader->len = pending;
+    }
 
-    while (received < len) {
-        ssize_t n = recv(fd, buf + received, len - received, 0);
+    for (;;) {
+        ssize_t n = recv(reader->fd, reader->buf + reader->len,
+                         sizeof(reader->buf) - reader->len, 0);
         if (n == 0) {
             return -ECONNRESET; /* peer closed connection */
         }
         if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
             return -errno;
         }
-        received += (size_t)n;
+        reader->len += (size_t)n;
+        return 0;
     }
-    return 0;
 }
 
 /* -------------------------------------------------------------------------
  * Public API
  * ------------------------------------------------------------------------- */
 
-int zmk_ipc_encode_event(const zmk_ipc_ZmkEvent *event,
-                         uint8_t *buf, size_t buf_size, size_t *out_len) {
-    pb_ostream_t stream = pb_ostream_from_buffer(buf, buf_size);
+int zmk_ipc_encode_frame(const pb_msgdesc_t *fields, const void *msg,
+                         uint8_t *frame, size_t frame_size, size_t *out_len) {
+    if (frame_size < 4) {
+        return -EMSGSIZE;
+    }
 
-    if (!pb_encode(&stream, &zmk_ipc_ZmkEvent_msg, event)) {
-        LOG_ERR("zmk_ipc: pb_encode ZmkEvent failed: %s", PB_GET_ERROR(&stream));
+    pb_ostream_t stream = pb_ostream_from_buffer(frame + 4, frame_size - 4);
+
+    if (!pb_encode(&stream, fields, msg)) {
+        LOG_ERR("zmk_ipc: pb_encode failed: %s", PB_GET_ERROR(&stream));
         return -EIO;
     }
 
-    *out_len = stream.bytes_written;
+    sys_put_be32((uint32_t)stream.bytes_written, frame);
+    *out_len = 4 + stream.bytes_written;
     return 0;
 }
 
-int zmk_ipc_frame_send(int fd, const uint8_t *data, size_t len) {
-    /*
-     * Build a single contiguous buffer: [4-byte BE length][payload]
-     * This avoids the race where a partial write of the length prefix
-     * could be interleaved with another sender's data.
-     */
-    uint8_t frame[ZMK_IPC_EVENT_FRAME_MAX];
+int zmk_ipc_encode_event_frame(const zmk_ipc_ZmkEvent *event,
+                               uint8_t *frame, size_t frame_size, size_t *out_len) {
+    return zmk_ipc_encode_frame(&zmk_ipc_ZmkEvent_msg, event, frame, frame_size, out_len);
+}
 
-    if (len + 4 > sizeof(frame)) {
-        return -EMSGSIZE;
+int zmk_ipc_frame_peek(const uint8_t *buf, size_t len, size_t max_payload, size_t *payload_len) {
+    if (len < 4) {
+        return -EAGAIN;
     }
 
-    uint32_t be_len = sys_cpu_to_be32((uint32_t)len);
-    memcpy(frame, &be_len, 4);
-    memcpy(frame + 4, data, len);
-
-    ssize_t sent = send(fd, frame, len + 4, MSG_NOSIGNAL | MSG_DONTWAIT);
-    if (sent < 0) {
-        return -errno;
+    uint32_t msg_len = sys_get_be32(buf);
+    if (msg_len > max_payload) {
+        LOG_WRN("zmk_ipc: incoming frame too large: %" PRIu32 " > %u",
+                msg_len, (unsigned)max_payload);
+        return -EMSGSIZE;
     }
-    if ((size_t)sent != len + 4) {
-        /* Partial send — treat as error to avoid corrupted stream */
-        return -EIO;
+    if (len < 4 + (size_t)msg_len) {
+        return -EAGAIN;
     }
+
+    *payload_len = msg_len;
     return 0;
 }
 
-int zmk_ipc_frame_recv(int fd, zmk_ipc_ClientMessage *msg) {
-    /* Step 1: read 4-byte big-endian length */
-    uint8_t len_buf[4];
-    int ret = recv_exact(fd, len_buf, sizeof(len_buf));
-    if (ret != 0) {
-        return ret;
-    }
+void zmk_ipc_frame_reader_init(struct zmk_ipc_frame_reader *reader, int fd) {
+    reader->fd  = fd;
+    reader->pos = 0;
+    reader->len = 0;
+}
 
-    uint32_t msg_len = sys_be32_to_cpu(*(uint32_t *)len_buf);
-    if (msg_len > zmk_ipc_ClientMessage_size) {
-        LOG_WRN("zmk_ipc: incoming frame too large: %" PRIu32 " > %u",
-                msg_len, (unsigned)zmk_ipc_ClientMessage_size);
-        return -EMSGSIZE;
-    }
+int zmk_ipc_frame_reader_next(struct zmk_ipc_frame_reader *reader,
+                              zmk_ipc_ClientMessage *msg) {
+    for (;;) {
+        size_t msg_len;
+        int ret = zmk_ipc_frame_peek(reader->buf + reader->pos, reader->len - reader->pos,
+                                     zmk_ipc_ClientMessage_size, &msg_len);
 
-    /* Step 2: read exactly msg_len bytes */
-    uint8_t body[zmk_ipc_ClientMessage_size];
-    ret = recv_exact(fd, body, (size_t)msg_len);
-    if (ret != 0) {
-        return ret;
-    }
+        if (ret == 0) {
+            const uint8_t *body = reader->buf + reader->pos + 4;
 
-    /* Step 3: nanopb decode */
-    pb_istream_t stream = pb_istream_from_buffer(body, (size_t)msg_len);
-    *msg = (zmk_ipc_ClientMessage)zmk_ipc_ClientMessage_init_zero;
+            /* Consume before decoding so a bad frame is skipped. The body
+             * stays in place until the next refill. */
+            reader->pos += 4 + msg_len;
+            return decode_client_message(body, msg_len, msg);
+        }
+        if (ret != -EAGAIN) {
+            return ret;
+        }
 
-    if (!pb_decode(&stream, &zmk_ipc_ClientMessage_msg, msg)) {
-        LOG_WRN("zmk_ipc: pb_decode ClientMessage failed: %s", PB_GET_ERROR(&stream));
-        return -EBADMSG;
+        ret = reader_fill(reader);
+        if (ret != 0) {
+            return ret;
+        }
     }
-
-    return 0;
 }
@@ -16,6 +16,8 @@
  *
  * The framing layer is intentionally transport-agnostic; the caller
  * supplies a connected file descriptor (Unix socket, TCP socket, etc.).
+ * It has no Zephyr dependencies outside of __ZEPHYR__ builds, so host
+ * clients (sample_app/client/) compile the same file.
  */
 
 #pragma once
@@ -25,46 +27,95 @@
 
 #include "zmk_ipc.pb.h"
 
+/* Protocol version announced in Capabilities (see Hello in zmk_ipc.proto).
+ * Bump it when a change would break a client written for the previous one. */
+#define ZMK_IPC_PROTOCOL_VERSION  1
+
 /* Maximum encoded sizes (from generated pb.h) */
 #define ZMK_IPC_EVENT_FRAME_MAX   (4U + zmk_ipc_ZmkEvent_size)    /* ZMK → client */
 #define ZMK_IPC_MSG_FRAME_MAX     (4U + zmk_ipc_ClientMessage_size) /* client → ZMK */
 
+/* Receive buffer size: room for one maximum-size frame plus a second one
+ * arriving behind it, so bursts of small frames are drained per recv(). */
+#define ZMK_IPC_READER_BUF_SIZE   (2U * ZMK_IPC_MSG_FRAME_MAX)
+
+/**
+ * Buffered per-connection reader for client → ZMK frames.
+ *
+ * Each refill pulls as many bytes as the socket has available (up to the
+ * free space in @ref buf); subsequent calls decode complete frames straight
+ * out of the buffer without touching the socket again.  Bytes of a trailing
+ * partial frame are moved to the front of the buffer before the next refill.
+ */
+struct zmk_ipc_frame_reader {
+    int fd;
+    size_t pos; /* offset of the first unconsumed byte */
+    size_t len; /* number of valid bytes in buf */
+    uint8_t buf[ZMK_IPC_READER_BUF_SIZE];
+};
+
 /**
- * @brief Encode @p event into @p buf (no length prefix).
+ * @brief Encode @p msg, described by @p fields, as a length-prefixed frame.
  *
- * @param event     Message to encode.
- * @param buf       Output buffer (at least zmk_ipc_ZmkEvent_size bytes).
- * @param buf_size  Size of @p buf.
- * @param out_len   Set to the number of bytes written on success.
- * @retval 0 on success, -EIO on nanopb encode failure.
+ * Same as zmk_ipc_encode_event_frame() for any message type, e.g. a
+ * ClientMessage encoded by a host client.
  */
-int zmk_ipc_encode_event(const zmk_ipc_ZmkEvent *event,
-                         uint8_t *buf, size_t buf_size, size_t *out_len);
+int zmk_ipc_encode_frame(const pb_msgdesc_t *fields, const void *msg,
+                         uint8_t *frame, size_t frame_size, size_t *out_len);
 
 /**
- * @brief Send a length-prefixed protobuf frame to @p fd (non-blocking).
+ * @brief Encode @p event as a complete length-prefixed frame in @p frame.
  *
- * @p data must be the already-encoded protobuf bytes (no length prefix).
- * The function prepends the 4-byte big-endian length and sends both in
- * a single write to avoid partial-frame interleaving.
+ * The 4-byte length prefix is reserved at the start of @p frame, the nanopb
+ * payload is encoded directly after it, and the prefix is back-patched with
+ * the encoded length.  The result can be handed unchanged to any number of
+ * connections (send(), sendmsg()/writev()) without further copies.
  *
- * Uses MSG_NOSIGNAL | MSG_DONTWAIT — returns -EAGAIN if the socket
- * send buffer is full (caller should close the connection).
+ * @param event       Message to encode.
+ * @param frame       Output buffer (at least ZMK_IPC_EVENT_FRAME_MAX bytes).
+ * @param frame_size  Size of @p frame.
+ * @param out_len     Set to the total frame length (prefix + payload).
+ * @retval 0 on success, -EMSGSIZE if @p frame cannot hold the prefix,
+ *         -EIO on nanopb encode failure.
+ */
+int zmk_ipc_encode_event_frame(const zmk_ipc_ZmkEvent *event,
+                               uint8_t *frame, size_t frame_size, size_t *out_len);
+
+/**
+ * @brief Check whether @p buf starts with a complete frame.
  *
- * @retval 0 on success, negative errno on failure.
+ * @param buf          Received bytes, starting at a frame boundary.
+ * @param len          Number of valid bytes in @p buf.
+ * @param max_payload  Largest payload accepted, normally the _size of the
+ *                     expected message type.
+ * @param payload_len  Set to the payload length on success; the payload
+ *                     starts 4 bytes into @p buf.
+ * @retval 0 if a complete frame is buffered.
+ * @retval -EAGAIN   if more bytes are needed.
+ * @retval -EMSGSIZE if the length prefix exceeds @p max_payload.
+ */
+int zmk_ipc_frame_peek(const uint8_t *buf, size_t len, size_t max_payload, size_t *payload_len);
+
+/**
+ * @brief Bind @p reader to a connected @p fd and discard any buffered bytes.
  */
-int zmk_ipc_frame_send(int fd, const uint8_t *data, size_t len);
+void zmk_ipc_frame_reader_init(struct zmk_ipc_frame_reader *reader, int fd);
 
 /**
- * @brief Blocking receive and decode of a ClientMessage frame from @p fd.
+ * @brief Return the next ClientMessage from @p reader, blocking if needed.
  *
- * Reads exactly 4 bytes (length), then exactly @p length bytes (body),
- * then decodes the body as a zmk_ipc_ClientMessage.
+ * If a complete frame is already buffered it is decoded without a syscall;
+ * otherwise a single recv() refills the buffer with whatever the socket has
+ * available and decoding is retried.
  *
  * @retval 0 on success.
  * @retval -ECONNRESET if the peer closed the connection.
  * @retval -EMSGSIZE   if the reported length exceeds the max message size.
- * @retval -EBADMSG    if nanopb decoding failed.
+ * @retval -EBADMSG    if nanopb decoding failed.  The offending frame has
+ *                     been consumed, so the stream remains usable.
+ * @retval -EAGAIN     if the socket is non-blocking and no complete frame
+ *                     is buffered yet.
  * @retval negative errno for other recv errors.
  */
-int zmk_ipc_frame_recv(int fd, zmk_ipc_ClientMessage *msg);
+int zmk_ipc_frame_reader_next(struct zmk_ipc_frame_reader *reader,
+                              zmk_ipc_ClientMessage *msg);
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "zmk_ipc_listener.h"
+
+#include <zephyr/logging/log.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define TCP_PREFIX "tcp:"
+#define INSTANCE_ENV "ZMK_IPC_INSTANCE"
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ------------------------------------------------------------------------- */
+
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+
+    return (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) ? -errno : 0;
+}
+
+/* Parse "HOST:PORT" with a numeric IPv4 host or a bracketed IPv6 one. */
+static int parse_tcp_address(const char *spec, struct sockaddr_storage *addr,
+                             socklen_t *addr_len) {
+    char host[INET6_ADDRSTRLEN];
+    const char *port_sep;
+    const char *host_start = spec;
+    size_t host_len;
+
+    if (spec[0] == '[') {
+        const char *end = strchr(spec, ']');
+        if (!end || end[1] != ':') {
+            return -EINVAL;
+        }
+        host_start = spec + 1;
+        host_len = end - host_start;
+        port_sep = end + 1;
+    } else {
+        port_sep = strrchr(spec, ':');
+        if (!port_sep) {
+            return -EINVAL;
+        }
+        host_len = port_sep - spec;
+    }
+
+    if (host_len == 0 || host_len >= sizeof(host)) {
+        return -EINVAL;
+    }
+    memcpy(host, host_start, host_len);
+    host[host_len] = '\0';
+
+    char *port_end;
+    long port = strtol(port_sep + 1, &port_end, 10);
+    if (port_sep[1] == '\0' || *port_end != '\0' || port < 0 || port > 65535) {
+        return -EINVAL;
+    }
+
+    memset(addr, 0, sizeof(*addr));
+
+    struct sockaddr_in *in4 = (struct sockaddr_in *)addr;
+    if (inet_pton(AF_INET, host, &in4->sin_addr) == 1) {
+        in4->sin_family = AF_INET;
+        in4->sin_port = htons((uint16_t)port);
+        *addr_len = sizeof(*in4);
+        return 0;
+    }
+
+    struct sockaddr_in6 *in6 = (struct sockaddr_in6 *)addr;
+    if (inet_pton(AF_INET6, host, &in6->sin6_addr) == 1) {
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons((uint16_t)port);
+        *addr_len = sizeof(*in6);
+        return 0;
+    }
+
+    return -EINVAL;
+}
+
+/* Fill a Unix address for a filesystem path, or an abstract name after '@'. */
+static int parse_unix_address(const char *address, struct sockaddr_storage *addr,
+                              socklen_t *addr_len) {
+    struct sockaddr_un *un = (struct sockaddr_un *)addr;
+    size_t len = strlen(address);
+
+    memset(addr, 0, sizeof(*addr));
+    un->sun_family = AF_UNIX;
+
+    if (address[0] == '@') {
+        /* The name is the bytes after a leading NUL, without a terminator. */
+        if (len < 2 || len > sizeof(un->sun_path)) {
+            return -EINVAL;
+        }
+        memcpy(un->sun_path + 1, address + 1, len - 1);
+        *addr_len = offsetof(struct sockaddr_un, sun_path) + len;
+        return 0;
+    }
+
+    if (len == 0 || len >= sizeof(un->sun_path)) {
+        return -EINVAL;
+    }
+    memcpy(un->sun_path, address, len);
+    *addr_len = sizeof(*un);
+    return 0;
+}
+
+/*
+ * Append ".<instance>" to a Unix address while ZMK_IPC_INSTANCE is set.
+ * Returns NULL if the result doesn't fit in @p buf.
+ */
+static const char *instance_address(const char *address, char *buf, size_t buf_len) {
+    const char *instance = getenv(INSTANCE_ENV);
+
+    if (!instance || instance[0] == '\0' ||
+        strncmp(address, TCP_PREFIX, strlen(TCP_PREFIX)) == 0) {
+        return address;
+    }
+
+    int len = snprintf(buf, buf_len, "%s.%s", address, instance);
+    return (len < 0 || (size_t)len >= buf_len) ? NULL : buf;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ------------------------------------------------------------------------- */
+
+int zmk_ipc_listener_open(const char *address, int backlog) {
+    char instance_buf[sizeof(((struct sockaddr_un *)0)->sun_path) + 1];
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+
+    const char *resolved = instance_address(address, instance_buf, sizeof(instance_buf));
+    if (!resolved) {
+        LOG_ERR("zmk_ipc: listen address \"%s\" is too long for instance %s", address,
+                getenv(INSTANCE_ENV));
+        return -EINVAL;
+    }
+    address = resolved;
+
+    bool tcp = strncmp(address, TCP_PREFIX, strlen(TCP_PREFIX)) == 0;
+
+    int err = tcp ? parse_tcp_address(address + strlen(TCP_PREFIX), &addr, &addr_len)
+                  : parse_unix_address(address, &addr, &addr_len);
+    if (err < 0) {
+        LOG_ERR("zmk_ipc: invalid listen address \"%s\"", address);
+        return err;
+    }
+
+    int fd = socket(addr.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOG_ERR("zmk_ipc: socket() failed (errno=%d)", errno);
+        return -errno;
+    }
+
+    if (tcp) {
+        /* Restarted instances rebind their port while old connections linger. */
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    } else if (address[0] != '@') {
+        unlink(address);
+    }
+
+    if (bind(fd, (struct sockaddr *)&addr, addr_len) < 0) {
+        err = -errno;
+        LOG_ERR("zmk_ipc: bind() to %s failed (errno=%d)", address, -err);
+        goto fail;
+    }
+
+    if (listen(fd, backlog) < 0) {
+        err = -errno;
+        LOG_ERR("zmk_ipc: listen() on %s failed (errno=%d)", address, -err);
+        goto fail;
+    }
+
+    err = set_nonblocking(fd);
+    if (err < 0) {
+        goto fail;
+    }
+    return fd;
+
+fail:
+    close(fd);
+    return err;
+}
+
+int zmk_ipc_listener_accept(int server_fd) {
+    struct sockaddr_storage peer;
+    socklen_t peer_len = sizeof(peer);
+
+    int fd = accept(server_fd, (struct sockaddr *)&peer, &peer_len);
+    if (fd < 0) {
+        return (errno == EWOULDBLOCK || errno == EINTR) ? -EAGAIN : -errno;
+    }
+
+    int err = set_nonblocking(fd);
+    if (err < 0) {
+        close(fd);
+        return err;
+    }
+
+    if (peer.ss_family == AF_INET || peer.ss_family == AF_INET6) {
+        int one = 1;
+        if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) < 0) {
+            LOG_WRN("zmk_ipc: can't set TCP_NODELAY (errno=%d)", errno);
+        }
+    }
+    return fd;
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Listening sockets for the IPC servers (kscan IPC driver, IPC observer).
+ *
+ * A server address is one string, in one of three forms:
+ *
+ *   /tmp/zmk_ipc.sock   Unix socket at a filesystem path; a stale socket
+ *                       file at the path is removed first.
+ *   @zmk_ipc            Linux abstract-namespace Unix socket.  Nothing is
+ *                       created on the filesystem and the name disappears
+ *                       with the process, so instances in separate network
+ *                       namespaces (containers) never collide.
+ *   tcp:HOST:PORT       TCP on a numeric IPv4 address, or an IPv6 one in
+ *                       brackets: tcp:127.0.0.1:7000, tcp:0.0.0.0:7000,
+ *                       tcp:[::]:7000.  Accepted connections have
+ *                       TCP_NODELAY set, so small frames aren't delayed.
+ *
+ * With the environment variable ZMK_IPC_INSTANCE set, ".<instance>" is
+ * appended to Unix socket addresses, so several instances of one build can
+ * run side by side: /tmp/zmk_ipc.sock.3, @zmk_ipc.3.  TCP addresses are
+ * used as given.
+ *
+ * Frames are the same on every transport.  Listening and accepted sockets
+ * are non-blocking.
+ */
+
+#pragma once
+
+/**
+ * @brief Open a non-blocking listening socket for @p address.
+ *
+ * @param backlog Passed to listen().
+ * @retval the listening socket on success.
+ * @retval -EINVAL if @p address is malformed, or too long once the instance
+ *         is appended, negative errno otherwise.
+ */
+int zmk_ipc_listener_open(const char *address, int backlog);
+
+/**
+ * @brief Accept one pending connection on @p server_fd.
+ *
+ * @retval the non-blocking connected socket on success.
+ * @retval -EAGAIN if no connection is pending, negative errno otherwise.
+ */
+int zmk_ipc_listener_accept(int server_fd);
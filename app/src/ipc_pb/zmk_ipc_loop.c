@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "zmk_ipc_loop.h"
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <sys/epoll.h>
+#include <errno.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+/* Events taken per epoll_wait(); more ready sockets are picked up next time. */
+#define LOOP_EVENTS_MAX 16
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_VIRTUAL_TIME)
+#define LOOP_WAIT_TIMEOUT -1
+#else
+#define LOOP_WAIT_TIMEOUT 0
+#endif
+
+static int epoll_fd = -1;
+static sys_slist_t poll_sources = SYS_SLIST_STATIC_INIT(&poll_sources);
+
+int zmk_ipc_loop_add(struct zmk_ipc_loop_source *source, int fd, zmk_ipc_loop_handler_t handler) {
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = source};
+
+    source->fd = fd;
+    source->handler = handler;
+
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        LOG_ERR("zmk_ipc: epoll_ctl() failed (errno=%d)", errno);
+        return -errno;
+    }
+    return 0;
+}
+
+void zmk_ipc_loop_add_poll(struct zmk_ipc_loop_source *source, zmk_ipc_loop_handler_t handler) {
+    source->fd = -1;
+    source->handler = handler;
+    sys_slist_append(&poll_sources, &source->node);
+}
+
+static void ipc_loop_thread_func(void *a, void *b, void *c) {
+    for (;;) {
+        struct zmk_ipc_loop_source *source;
+
+        SYS_SLIST_FOR_EACH_CONTAINER(&poll_sources, source, node) {
+            source->handler(source);
+        }
+
+        struct epoll_event events[LOOP_EVENTS_MAX];
+        int n = epoll_wait(epoll_fd, events, ARRAY_SIZE(events), LOOP_WAIT_TIMEOUT);
+
+        if (n <= 0) {
+            if (n < 0 && errno != EINTR) {
+                LOG_ERR("zmk_ipc: epoll_wait() failed (errno=%d)", errno);
+            }
+            if (!IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_VIRTUAL_TIME)) {
+                k_sleep(K_MSEC(CONFIG_ZMK_IPC_LOOP_POLL_INTERVAL_MS));
+            }
+            continue;
+        }
+
+        for (int i = 0; i < n; i++) {
+            source = events[i].data.ptr;
+            source->handler(source);
+        }
+
+        if (IS_ENABLED(CONFIG_ZMK_KSCAN_IPC_VIRTUAL_TIME)) {
+            /* Let the work queue and the observer writer finish handling
+             * these events before the next wait freezes the kernel. */
+            k_yield();
+        }
+    }
+}
+
+K_THREAD_DEFINE(zmk_ipc_loop_thread,
+                CONFIG_ZMK_IPC_LOOP_THREAD_STACK_SIZE,
+                ipc_loop_thread_func,
+                NULL, NULL, NULL,
+                K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+
+/* Before any server registers a socket from its own init function. */
+static int ipc_loop_init(void) {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        LOG_ERR("zmk_ipc: epoll_create1() failed (errno=%d)", errno);
+        return -errno;
+    }
+    return 0;
+}
+
+SYS_INIT(ipc_loop_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * The IPC event loop: one thread and one epoll set for the sockets of every
+ * IPC server in the process (the kscan IPC instances and the IPC observer),
+ * so adding instances or clients adds no threads or stacks.
+ *
+ * A server embeds a struct zmk_ipc_loop_source per socket, registers it with
+ * zmk_ipc_loop_add() and recovers its own state in the handler with
+ * CONTAINER_OF().  Handlers run on the loop thread whenever the socket is
+ * readable or has hung up, and have to drain it without blocking, since
+ * every other socket waits meanwhile.  Closing the socket removes it from
+ * the loop.  A stale event may still reach the handler after the socket
+ * was closed from another thread, so handlers check their state first.
+ *
+ * Sources without a socket, such as shared-memory rings, are registered
+ * with zmk_ipc_loop_add_poll() and called once per loop iteration.
+ *
+ * While no socket is ready the loop sleeps on the Zephyr clock for
+ * CONFIG_ZMK_IPC_LOOP_POLL_INTERVAL_MS, so the simulated kernel keeps
+ * running.  With CONFIG_ZMK_KSCAN_IPC_VIRTUAL_TIME it blocks in the host
+ * instead, which freezes simulated time until a client sends something.
+ */
+
+#pragma once
+
+#include <zephyr/sys/slist.h>
+
+struct zmk_ipc_loop_source;
+
+typedef void (*zmk_ipc_loop_handler_t)(struct zmk_ipc_loop_source *source);
+
+struct zmk_ipc_loop_source {
+    int fd; /* registered socket, -1 for poll sources */
+    zmk_ipc_loop_handler_t handler;
+    sys_snode_t node; /* poll sources only */
+};
+
+/**
+ * @brief Watch @p fd for input and call @p handler on the loop thread.
+ *
+ * May be called from init functions and from handlers.
+ *
+ * @retval 0 on success, negative errno from epoll_ctl() otherwise.
+ */
+int zmk_ipc_loop_add(struct zmk_ipc_loop_source *source, int fd, zmk_ipc_loop_handler_t handler);
+
+/**
+ * @brief Call @p handler once per loop iteration, before waiting.
+ *
+ * Only to be called from init functions.
+ */
+void zmk_ipc_loop_add_poll(struct zmk_ipc_loop_source *source, zmk_ipc_loop_handler_t handler);
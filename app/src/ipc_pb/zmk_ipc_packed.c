@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "zmk_ipc_packed.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+
+/* The layouts are part of the protocol: no padding, naturally aligned. */
+BUILD_ASSERT(sizeof(struct zmk_ipc_packed_header) == 16);
+BUILD_ASSERT(sizeof(struct zmk_ipc_packed_kscan_event) == 24);
+BUILD_ASSERT(sizeof(struct zmk_ipc_packed_keyboard) == 40);
+BUILD_ASSERT(sizeof(struct zmk_ipc_packed_consumer) == 24);
+BUILD_ASSERT(sizeof(struct zmk_ipc_packed_mouse) == 24);
+BUILD_ASSERT(sizeof(struct zmk_ipc_packed_layer_state) == 8);
+BUILD_ASSERT(sizeof(struct zmk_ipc_packed_modifiers_state) == 4);
+BUILD_ASSERT(sizeof(struct zmk_ipc_packed_endpoint_changed) == 4);
+
+union packed_payload {
+    struct zmk_ipc_packed_kscan_event kscan_event;
+    struct zmk_ipc_packed_keyboard keyboard;
+    struct zmk_ipc_packed_consumer consumer;
+    struct zmk_ipc_packed_mouse mouse;
+    struct zmk_ipc_packed_layer_state layer_state;
+    struct zmk_ipc_packed_modifiers_state modifiers_state;
+    struct zmk_ipc_packed_endpoint_changed endpoint_changed;
+};
+
+static struct zmk_ipc_packed_endpoint pack_endpoint(bool has_endpoint,
+                                                    const zmk_ipc_Endpoint *endpoint) {
+    if (!has_endpoint) {
+        return (struct zmk_ipc_packed_endpoint){0};
+    }
+
+    return (struct zmk_ipc_packed_endpoint){
+        .valid = 1,
+        .transport = (uint8_t)endpoint->transport,
+        .ble_profile_idx = (uint8_t)endpoint->ble_profile_idx,
+    };
+}
+
+/* Fill @p out for @p event and return its size, or 0 if it has no layout. */
+static size_t pack_payload(const zmk_ipc_ZmkEvent *event, union packed_payload *out) {
+    switch (event->which_payload) {
+    case zmk_ipc_ZmkEvent_kscan_event_tag: {
+        const zmk_ipc_KscanEvent *ev = &event->payload.kscan_event;
+
+        out->kscan_event = (struct zmk_ipc_packed_kscan_event){
+            .timestamp = (int64_t)sys_cpu_to_le64(ev->timestamp),
+            .source = sys_cpu_to_le32(ev->source),
+            .position = sys_cpu_to_le32(ev->position),
+            .pressed = ev->pressed,
+        };
+        return sizeof(out->kscan_event);
+    }
+    case zmk_ipc_ZmkEvent_keyboard_tag: {
+        const zmk_ipc_HidKeyboardReport *ev = &event->payload.keyboard;
+
+        /* The trace has no fixed layout; such reports go out as protobuf. */
+        if (ev->has_trace) {
+            return 0;
+        }
+        out->keyboard = (struct zmk_ipc_packed_keyboard){
+            .endpoint = pack_endpoint(ev->has_endpoint, &ev->endpoint),
+            .modifiers = (uint8_t)ev->modifiers,
+            .format = (uint8_t)ev->format,
+            .keys_len = (uint8_t)ev->keys.size,
+        };
+        memcpy(out->keyboard.keys, ev->keys.bytes, ev->keys.size);
+        return sizeof(out->keyboard);
+    }
+    case zmk_ipc_ZmkEvent_consumer_tag: {
+        const zmk_ipc_HidConsumerReport *ev = &event->payload.consumer;
+
+        out->consumer = (struct zmk_ipc_packed_consumer){
+            .endpoint = pack_endpoint(ev->has_endpoint, &ev->endpoint),
+            .keys_len = (uint8_t)ev->keys.size,
+        };
+        memcpy(out->consumer.keys, ev->keys.bytes, ev->keys.size);
+        return sizeof(out->consumer);
+    }
+    case zmk_ipc_ZmkEvent_mouse_tag: {
+        const zmk_ipc_HidMouseReport *ev = &event->payload.mouse;
+
+        out->mouse = (struct zmk_ipc_packed_mouse){
+            .endpoint = pack_endpoint(ev->has_endpoint, &ev->endpoint),
+            .buttons = sys_cpu_to_le32(ev->buttons),
+            .dx = (int32_t)sys_cpu_to_le32(ev->dx),
+            .dy = (int32_t)sys_cpu_to_le32(ev->dy),
+            .scroll_x = (int32_t)sys_cpu_to_le32(ev->scroll_x),
+            .scroll_y = (int32_t)sys_cpu_to_le32(ev->scroll_y),
+        };
+        return sizeof(out->mouse);
+    }
+    case zmk_ipc_ZmkEvent_layer_state_tag:
+        out->layer_state = (struct zmk_ipc_packed_layer_state){
+            .layer = sys_cpu_to_le32(event->payload.layer_state.layer),
+            .active = event->payload.layer_state.active,
+        };
+        return sizeof(out->layer_state);
+    case zmk_ipc_ZmkEvent_modifiers_state_tag: {
+        const zmk_ipc_ModifiersStateChanged *ev = &event->payload.modifiers_state;
+
+        out->modifiers_state = (struct zmk_ipc_packed_modifiers_state){
+            .modifiers = (uint8_t)ev->modifiers,
+            .pressed = ev->pressed,
+            .explicit_modifiers = (uint8_t)ev->explicit_modifiers,
+        };
+        return sizeof(out->modifiers_state);
+    }
+    case zmk_ipc_ZmkEvent_endpoint_changed_tag: {
+        const zmk_ipc_EndpointChanged *ev = &event->payload.endpoint_changed;
+
+        out->endpoint_changed = (struct zmk_ipc_packed_endpoint_changed){
+            .endpoint = pack_endpoint(ev->has_endpoint, &ev->endpoint),
+        };
+        return sizeof(out->endpoint_changed);
+    }
+    default:
+        return 0;
+    }
+}
+
+int zmk_ipc_encode_packed_frame(const zmk_ipc_ZmkEvent *event, uint8_t *frame, size_t frame_size,
+                                size_t *out_len) {
+    union packed_payload payload;
+    const size_t size = pack_payload(event, &payload);
+
+    if (size == 0) {
+        return -ENOTSUP;
+    }
+
+    const struct zmk_ipc_packed_header header = {
+        .magic = ZMK_IPC_PACKED_MAGIC,
+        .version = ZMK_IPC_PACKED_VERSION,
+        .type = (uint8_t)event->which_payload,
+        .context = (uint8_t)event->context,
+        .size = sys_cpu_to_le32(size),
+        .timestamp = (int64_t)sys_cpu_to_le64(event->timestamp),
+    };
+    const size_t len = 4 + sizeof(header) + size;
+
+    if (frame_size < len) {
+        return -EMSGSIZE;
+    }
+
+    sys_put_be32(len - 4, frame);
+    memcpy(frame + 4, &header, sizeof(header));
+    memcpy(frame + 4 + sizeof(header), &payload, size);
+    *out_len = len;
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Fixed-layout event frames (CONFIG_ZMK_IPC_OBSERVER_PACKED_EVENTS).
+ *
+ * A client that sets packed_events in its Hello receives the high-rate
+ * event types below as packed structs instead of protobuf, so it can read
+ * them in place without a decoder.  The length prefix is unchanged; the
+ * payload is a header followed by the struct of its type:
+ *
+ *   ┌──────────────────────┬──────────────────────┬──────────────────┐
+ *   │ 4 bytes, big-endian  │ 16 bytes             │ header.size bytes│
+ *   │ payload size         │ zmk_ipc_packed_header│ payload struct   │
+ *   └──────────────────────┴──────────────────────┴──────────────────┘
+ *
+ * All integers are little-endian and every field is naturally aligned, so
+ * on a little-endian host a payload copied to an 8-byte aligned buffer can
+ * be cast to the structs directly.  Fields are only ever appended; a client
+ * must accept a header.size larger than the struct it knows.
+ *
+ * Every other event type, and keyboard reports carrying a latency trace,
+ * still arrive as protobuf on the same connection.  The two are told apart
+ * by the first payload byte: ZMK_IPC_PACKED_MAGIC is 0, which never starts
+ * a protobuf message (field number 0 is invalid).
+ *
+ * Like the framing header, this file has no Zephyr dependencies.  It does
+ * include zmk_ipc.pb.h for the payload tags and enums the structs use, so
+ * host clients need that header and nanopb's pb.h on their include path,
+ * though not the nanopb library itself.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "zmk_ipc.pb.h"
+
+#define ZMK_IPC_PACKED_MAGIC   0x00U
+/* Announced as Capabilities.packed_version; bumped when a layout changes
+ * incompatibly. */
+#define ZMK_IPC_PACKED_VERSION 1U
+
+struct zmk_ipc_packed_header {
+    uint8_t magic;   /* ZMK_IPC_PACKED_MAGIC */
+    uint8_t version; /* ZMK_IPC_PACKED_VERSION */
+    uint8_t type;    /* ZmkEvent payload field number, e.g. zmk_ipc_ZmkEvent_keyboard_tag */
+    uint8_t context; /* ZmkEvent.context */
+    uint32_t size;     /* bytes following the header */
+    int64_t timestamp; /* ZmkEvent.timestamp */
+};
+
+/* Endpoint of a report; valid is 0 if the event carried none. */
+struct zmk_ipc_packed_endpoint {
+    uint8_t valid;
+    uint8_t transport; /* zmk_ipc_TransportType */
+    uint8_t ble_profile_idx;
+    uint8_t reserved;
+};
+
+/* zmk_ipc_ZmkEvent_kscan_event_tag */
+struct zmk_ipc_packed_kscan_event {
+    int64_t timestamp;
+    uint32_t source;
+    uint32_t position;
+    uint8_t pressed;
+    uint8_t reserved[7];
+};
+
+/* zmk_ipc_ZmkEvent_keyboard_tag */
+struct zmk_ipc_packed_keyboard {
+    struct zmk_ipc_packed_endpoint endpoint;
+    uint8_t modifiers;
+    uint8_t format; /* zmk_ipc_KeyboardReportFormat */
+    uint8_t keys_len;
+    uint8_t reserved;
+    uint8_t keys[32];
+};
+
+/* zmk_ipc_ZmkEvent_consumer_tag */
+struct zmk_ipc_packed_consumer {
+    struct zmk_ipc_packed_endpoint endpoint;
+    uint8_t keys_len;
+    uint8_t reserved[3];
+    uint8_t keys[16];
+};
+
+/* zmk_ipc_ZmkEvent_mouse_tag */
+struct zmk_ipc_packed_mouse {
+    struct zmk_ipc_packed_endpoint endpoint;
+    uint32_t buttons;
+    int32_t dx;
+    int32_t dy;
+    int32_t scroll_x;
+    int32_t scroll_y;
+};
+
+/* zmk_ipc_ZmkEvent_layer_state_tag */
+struct zmk_ipc_packed_layer_state {
+    uint32_t layer;
+    uint8_t active;
+    uint8_t reserved[3];
+};
+
+/* zmk_ipc_ZmkEvent_modifiers_state_tag */
+struct zmk_ipc_packed_modifiers_state {
+    uint8_t modifiers;
+    uint8_t pressed;
+    uint8_t explicit_modifiers;
+    uint8_t reserved;
+};
+
+/* zmk_ipc_ZmkEvent_endpoint_changed_tag */
+struct zmk_ipc_packed_endpoint_changed {
+    struct zmk_ipc_packed_endpoint endpoint;
+};
+
+/* Largest packed frame, length prefix included. */
+#define ZMK_IPC_PACKED_FRAME_MAX                                                                   \
+    (4U + sizeof(struct zmk_ipc_packed_header) + sizeof(struct zmk_ipc_packed_keyboard))
+
+/**
+ * @brief Encode @p event as a length-prefixed packed frame in @p frame.
+ *
+ * @param event       Message to encode.
+ * @param frame       Output buffer (at least ZMK_IPC_PACKED_FRAME_MAX bytes).
+ * @param frame_size  Size of @p frame.
+ * @param out_len     Set to the total frame length (prefix + payload).
+ * @retval 0 on success.
+ * @retval -ENOTSUP  if the event has no packed layout; send it as protobuf.
+ * @retval -EMSGSIZE if @p frame is too small.
+ */
+int zmk_ipc_encode_packed_frame(const zmk_ipc_ZmkEvent *event, uint8_t *frame, size_t frame_size,
+                                size_t *out_len);
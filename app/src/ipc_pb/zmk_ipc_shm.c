@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "zmk_ipc_shm.h"
+
+#include <pb_decode.h>
+
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/logging/log.h>
+
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <errno.h>
+#include <string.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+BUILD_ASSERT(sizeof(struct zmk_ipc_shm_header) == ZMK_IPC_SHM_DATA_OFFSET,
+             "shared-memory ring header layout changed");
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ------------------------------------------------------------------------- */
+
+static inline uint32_t load_acquire(const uint32_t *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void store_release(uint32_t *p, uint32_t v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+/* Copy @p len bytes starting at stream counter @p pos out of the ring. */
+static void ring_copy_out(const struct zmk_ipc_shm_ring *ring, uint32_t pos, uint8_t *dst,
+                          size_t len) {
+    uint32_t off = pos & ring->mask;
+    size_t first = MIN(len, (size_t)ring->mask + 1 - off);
+
+    memcpy(dst, ring->data + off, first);
+    memcpy(dst + first, ring->data, len - first);
+}
+
+struct ring_istream_state {
+    const struct zmk_ipc_shm_ring *ring;
+    uint32_t pos;
+};
+
+/* nanopb input callback reading straight out of the ring. */
+static bool ring_istream_read(pb_istream_t *stream, pb_byte_t *buf, size_t count) {
+    struct ring_istream_state *state = stream->state;
+
+    ring_copy_out(state->ring, state->pos, buf, count);
+    state->pos += (uint32_t)count;
+    return true;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ------------------------------------------------------------------------- */
+
+int zmk_ipc_shm_ring_create(struct zmk_ipc_shm_ring *ring, const char *path, uint32_t size) {
+    if (!IS_POWER_OF_TWO(size)) {
+        return -EINVAL;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return -errno;
+    }
+
+    size_t map_size = ZMK_IPC_SHM_DATA_OFFSET + size;
+    if (ftruncate(fd, (off_t)map_size) < 0) {
+        int err = errno;
+        close(fd);
+        return -err;
+    }
+
+    void *map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); /* the mapping keeps the file alive */
+    if (map == MAP_FAILED) {
+        return -errno;
+    }
+
+    ring->hdr  = map;
+    ring->data = (uint8_t *)map + ZMK_IPC_SHM_DATA_OFFSET;
+    ring->mask = size - 1;
+
+    ring->hdr->version = ZMK_IPC_SHM_VERSION;
+    ring->hdr->size    = size;
+    /* ftruncate() zeroed head, tail and waiters; publish the magic last so
+     * a client never sees a half-initialised header. */
+    store_release(&ring->hdr->magic, ZMK_IPC_SHM_MAGIC);
+
+    return 0;
+}
+
+int zmk_ipc_shm_ring_write(struct zmk_ipc_shm_ring *ring, const uint8_t *frame, size_t len) {
+    const size_t size = (size_t)ring->mask + 1;
+    if (len > size) {
+        return -EMSGSIZE;
+    }
+
+    uint32_t head = ring->hdr->head; /* only this side writes head */
+    uint32_t tail = load_acquire(&ring->hdr->tail);
+    if (size - (uint32_t)(head - tail) < len) {
+        return -EAGAIN;
+    }
+
+    uint32_t off = head & ring->mask;
+    size_t first = MIN(len, size - off);
+    memcpy(ring->data + off, frame, first);
+    memcpy(ring->data, frame + first, len - first);
+
+    store_release(&ring->hdr->head, head + (uint32_t)len);
+
+    if (load_acquire(&ring->hdr->waiters)) {
+        syscall(SYS_futex, &ring->hdr->head, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+
+    return 0;
+}
+
+int zmk_ipc_shm_ring_next(struct zmk_ipc_shm_ring *ring, zmk_ipc_ClientMessage *msg) {
+    uint32_t tail = ring->hdr->tail; /* only this side writes tail */
+    uint32_t head = load_acquire(&ring->hdr->head);
+    uint32_t pending = head - tail;
+
+    if (pending < 4) {
+        return -EAGAIN;
+    }
+
+    uint8_t prefix[4];
+    ring_copy_out(ring, tail, prefix, sizeof(prefix));
+    uint32_t msg_len = sys_get_be32(prefix);
+
+    if (msg_len > zmk_ipc_ClientMessage_size) {
+        LOG_WRN("zmk_ipc: shm frame too large: %" PRIu32 " > %u", msg_len,
+                (unsigned)zmk_ipc_ClientMessage_size);
+        /* Without a trustworthy length there is no next frame boundary. */
+        store_release(&ring->hdr->tail, head);
+        return -EMSGSIZE;
+    }
+
+    if (pending < 4 + msg_len) {
+        return -EAGAIN;
+    }
+
+    struct ring_istream_state state = {.ring = ring, .pos = tail + 4};
+    pb_istream_t stream = {.callback = ring_istream_read, .state = &state,
+                           .bytes_left = msg_len};
+    *msg = (zmk_ipc_ClientMessage)zmk_ipc_ClientMessage_init_zero;
+    bool ok = pb_decode(&stream, &zmk_ipc_ClientMessage_msg, msg);
+
+    /* Release the frame only after decoding, which still reads from it. */
+    store_release(&ring->hdr->tail, tail + 4 + msg_len);
+
+    if (!ok) {
+        LOG_WRN("zmk_ipc: pb_decode ClientMessage failed: %s", PB_GET_ERROR(&stream));
+        return -EBADMSG;
+    }
+
+    return 0;
+}
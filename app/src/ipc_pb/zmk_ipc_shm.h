@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Shared-memory ring transport for IPC frames.
+ *
+ * A ring is a single-producer / single-consumer byte stream in a file that
+ * both processes map (normally under /dev/shm).  It carries exactly the
+ * same length-prefixed nanopb frames as the Unix sockets, so a client only
+ * changes how it obtains the bytes, not how it parses them.
+ *
+ * File layout (all integers native-endian, offsets in bytes):
+ *
+ *     0  uint32 magic      ZMK_IPC_SHM_MAGIC
+ *     4  uint32 version    ZMK_IPC_SHM_VERSION
+ *     8  uint32 size       data area size, a power of two
+ *    64  uint32 head       total bytes published by the producer
+ *   128  uint32 tail       total bytes consumed by the consumer
+ *   192  uint32 waiters   non-zero while the consumer sleeps on head
+ *   256  data[size]
+ *
+ * head and tail are free-running counters; the byte at counter value c
+ * lives at data[c & (size - 1)] and frames wrap at the end of the area.
+ * The producer writes a whole frame before publishing it with a release
+ * store of head; the consumer advances tail past a frame once it is done
+ * with it.  Counters sit on their own cache lines so the two sides never
+ * share one.
+ *
+ * Wakeups: a consumer that wants to sleep sets waiters and then waits on
+ * the head word with FUTEX_WAIT; producers issue FUTEX_WAKE only while
+ * waiters is set, so a busy ring costs no syscalls at all.  ZMK never
+ * sleeps in the kernel on a ring (that would stall native_sim); it polls
+ * the input ring from its read thread instead.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "zmk_ipc.pb.h"
+
+#define ZMK_IPC_SHM_MAGIC     0x4350495AU /* "ZIPC" */
+#define ZMK_IPC_SHM_VERSION   1U
+
+/* Offset of the data area from the start of the mapping. */
+#define ZMK_IPC_SHM_DATA_OFFSET 256U
+
+struct zmk_ipc_shm_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    uint32_t reserved[13];
+    uint32_t head;
+    uint32_t head_pad[15];
+    uint32_t tail;
+    uint32_t tail_pad[15];
+    uint32_t waiters;
+    uint32_t waiters_pad[15];
+};
+
+struct zmk_ipc_shm_ring {
+    struct zmk_ipc_shm_header *hdr;
+    uint8_t *data;
+    uint32_t mask; /* size - 1 */
+};
+
+/**
+ * @brief Create (or re-create) the ring file at @p path and map it.
+ *
+ * Any existing file is truncated, so a stale ring from a previous run is
+ * never picked up.
+ *
+ * @param size Data area size; must be a power of two and large enough for
+ *             the largest frame carried on the ring.
+ * @retval 0 on success, -EINVAL for a bad @p size, negative errno otherwise.
+ */
+int zmk_ipc_shm_ring_create(struct zmk_ipc_shm_ring *ring, const char *path, uint32_t size);
+
+/**
+ * @brief Publish one complete frame (prefix included) on @p ring.
+ *
+ * Never blocks.  Wakes a sleeping consumer if one is waiting.
+ *
+ * @retval 0 on success.
+ * @retval -EAGAIN   if the ring does not currently have room for the frame.
+ * @retval -EMSGSIZE if the frame can never fit in the ring.
+ */
+int zmk_ipc_shm_ring_write(struct zmk_ipc_shm_ring *ring, const uint8_t *frame, size_t len);
+
+/**
+ * @brief Decode the next ClientMessage published on @p ring.
+ *
+ * Frames are decoded in place, across the wrap point if necessary, and
+ * consumed afterwards.
+ *
+ * @retval 0 on success.
+ * @retval -EAGAIN   if no complete frame has been published.
+ * @retval -EMSGSIZE if the frame length is invalid.  The ring contents can
+ *                   no longer be trusted and are discarded.
+ * @retval -EBADMSG  if nanopb decoding failed.  The frame has been consumed.
+ */
+int zmk_ipc_shm_ring_next(struct zmk_ipc_shm_ring *ring, zmk_ipc_ClientMessage *msg);
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include <zmk/context.h>
+#include <zmk/event_manager.h>
+#include <zmk/key_stats.h>
+#include <zmk/matrix.h>
+#include <zmk/events/position_state_changed.h>
+
+#define WORD_COUNT DIV_ROUND_UP(ZMK_KEYMAP_LEN, 32)
+
+// Kept for every position, so the counts are 16 bits and stop at UINT16_MAX.
+struct position_stats {
+    uint16_t buckets[ZMK_KEY_STATS_BUCKETS];
+    uint16_t max_ms;
+    uint16_t holds;
+    uint16_t taps;
+    uint16_t retro_taps;
+};
+
+static struct position_stats position_stats[ZMK_KEYMAP_LEN];
+static struct zmk_key_stats intervals;
+// Samples come from the system work queue, read from the IPC threads
+static struct k_spinlock stats_lock;
+
+// When each held key was pressed, per context, as the low 32 bits of the event timestamps.
+struct key_stats_state {
+    uint32_t held[WORD_COUNT];
+    uint32_t pressed_at[ZMK_KEYMAP_LEN];
+    uint32_t last_press;
+    bool pressed_before;
+};
+
+ZMK_CONTEXT_STATE_DEFINE(key_stats_states, struct key_stats_state, {});
+
+#define STATE ZMK_CONTEXT_STATE(key_stats_states)
+
+static inline uint8_t bucket_of(uint32_t ms) {
+    if (ms == 0) {
+        return 0;
+    }
+
+    return MIN(32 - __builtin_clz(ms), ZMK_KEY_STATS_BUCKETS - 1);
+}
+
+static inline void count16(uint16_t *count) {
+    if (*count < UINT16_MAX) {
+        (*count)++;
+    }
+}
+
+static void record_press_duration(uint32_t position, uint32_t ms) {
+    struct position_stats *stats = &position_stats[position];
+
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    count16(&stats->buckets[bucket_of(ms)]);
+    stats->max_ms = MAX(stats->max_ms, MIN(ms, UINT16_MAX));
+    k_spin_unlock(&stats_lock, key);
+}
+
+static void record_interval(uint32_t ms) {
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    intervals.samples++;
+    intervals.max_ms = MAX(intervals.max_ms, ms);
+    intervals.buckets[bucket_of(ms)]++;
+    k_spin_unlock(&stats_lock, key);
+}
+
+void zmk_key_stats_hold_tap(uint32_t position, enum zmk_key_stats_hold_tap decision) {
+    if (position >= ZMK_KEYMAP_LEN) {
+        return;
+    }
+
+    struct position_stats *stats = &position_stats[position];
+
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    switch (decision) {
+    case ZMK_KEY_STATS_HOLD_TAP_HOLD:
+        count16(&stats->holds);
+        break;
+    case ZMK_KEY_STATS_HOLD_TAP_TAP:
+        count16(&stats->taps);
+        break;
+    case ZMK_KEY_STATS_HOLD_TAP_RETRO_TAP:
+        // Already counted as a hold when it was decided, unless that count stopped at the top.
+        if (stats->holds > 0 && stats->holds < UINT16_MAX) {
+            stats->holds--;
+        }
+        count16(&stats->retro_taps);
+        break;
+    }
+    k_spin_unlock(&stats_lock, key);
+}
+
+int zmk_key_stats_get(uint32_t position, struct zmk_key_stats *stats) {
+    if (position >= ZMK_KEYMAP_LEN) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    const struct position_stats *ps = &position_stats[position];
+
+    *stats = (struct zmk_key_stats){
+        .max_ms = ps->max_ms,
+        .holds = ps->holds,
+        .taps = ps->taps,
+        .retro_taps = ps->retro_taps,
+    };
+    for (int i = 0; i < ZMK_KEY_STATS_BUCKETS; i++) {
+        stats->buckets[i] = ps->buckets[i];
+        stats->samples += ps->buckets[i];
+    }
+    k_spin_unlock(&stats_lock, key);
+
+    return 0;
+}
+
+void zmk_key_stats_get_intervals(struct zmk_key_stats *stats) {
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    *stats = intervals;
+    k_spin_unlock(&stats_lock, key);
+}
+
+static int key_stats_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    const uint32_t position = ev->position;
+    const uint32_t now = (uint32_t)ev->timestamp;
+
+    if (position >= ZMK_KEYMAP_LEN) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    uint32_t *word = &STATE->held[position / 32];
+
+    if (ev->state) {
+        // Captured presses are raised again with their own, earlier timestamps, after later ones,
+        // which are left out rather than counted as intervals of about 49 days.
+        int32_t interval = (int32_t)(now - STATE->last_press);
+        if (!STATE->pressed_before || interval >= 0) {
+            if (STATE->pressed_before) {
+                record_interval(interval);
+            }
+            STATE->last_press = now;
+            STATE->pressed_before = true;
+        }
+
+        STATE->pressed_at[position] = now;
+        *word |= BIT(position % 32);
+    } else if (*word & BIT(position % 32)) {
+        int32_t duration = (int32_t)(now - STATE->pressed_at[position]);
+        record_press_duration(position, MAX(duration, 0));
+        *word &= ~BIT(position % 32);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(key_stats, key_stats_listener);
+ZMK_SUBSCRIPTION(key_stats, zmk_position_state_changed);
@@ -5,17 +5,21 @@
  */
 
 #include <drivers/behavior.h>
+#include <zephyr/kernel.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/settings/settings.h>
 #include <zephyr/logging/log.h>
-LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+LOG_MODULE_REGISTER(zmk_keymap, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/stdlib.h>
 #include <zmk/behavior.h>
+#include <zmk/context.h>
 #include <zmk/keymap.h>
 #include <zmk/physical_layouts.h>
 #include <zmk/matrix.h>
 #include <zmk/sensors.h>
+#include <zmk/settings.h>
+#include <zmk/stage_timing.h>
 #include <zmk/virtual_key_position.h>
 
 #include <zmk/event_manager.h>
@@ -23,9 +27,24 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/layer_state_changed.h>
 #include <zmk/events/sensor_event.h>
 
-static zmk_keymap_layers_state_t _zmk_keymap_layer_locks = 0;
-static zmk_keymap_layers_state_t _zmk_keymap_layer_state = 0;
-static zmk_keymap_layer_id_t _zmk_keymap_layer_default = 0;
+struct keymap_state {
+    zmk_keymap_layers_state_t layer_locks;
+    zmk_keymap_layers_state_t layer_state;
+    zmk_keymap_layer_id_t layer_default;
+
+    // When a behavior handles a key position "down" event, we record the layer state
+    // here so that even if that layer is deactivated before the "up", event, we
+    // still send the release event to the behavior in that layer also.
+    uint32_t active_behavior_layer[ZMK_KEYMAP_LEN];
+
+    // See the layer resolution cache below.
+    zmk_keymap_layers_state_t layer_resolution[ZMK_KEYMAP_LEN];
+    uint32_t layer_resolution_valid_gen[ZMK_KEYMAP_LEN];
+};
+
+ZMK_CONTEXT_STATE_DEFINE(keymap_states, struct keymap_state, {});
+
+#define STATE ZMK_CONTEXT_STATE(keymap_states)
 
 #define DT_DRV_COMPAT zmk_keymap
 
@@ -35,10 +54,29 @@ static zmk_keymap_layer_id_t _zmk_keymap_layer_default = 0;
 
 #endif
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_STATIC)
+
+// A static keymap gets its behavior devices from the devicetree, so no binding is ever looked up
+// by name.
+#define KEYMAP_BINDING(idx, node)                                                                  \
+    {                                                                                              \
+        .behavior_dev = DEVICE_DT_NAME(DT_PHANDLE_BY_IDX(node, bindings, idx)),                    \
+        .param1 = COND_CODE_0(DT_PHA_HAS_CELL_AT_IDX(node, bindings, idx, param1), (0),            \
+                              (DT_PHA_BY_IDX(node, bindings, idx, param1))),                       \
+        .param2 = COND_CODE_0(DT_PHA_HAS_CELL_AT_IDX(node, bindings, idx, param2), (0),            \
+                              (DT_PHA_BY_IDX(node, bindings, idx, param2))),                       \
+        .device = DEVICE_DT_GET(DT_PHANDLE_BY_IDX(node, bindings, idx)),                           \
+    }
+
+#else
+
+#define KEYMAP_BINDING ZMK_KEYMAP_EXTRACT_BINDING
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_STATIC)
+
 #define TRANSFORMED_LAYER(node)                                                                    \
     {COND_CODE_1(DT_NODE_HAS_PROP(node, bindings),                                                 \
-                 (LISTIFY(DT_PROP_LEN(node, bindings), ZMK_KEYMAP_EXTRACT_BINDING, (, ), node)),   \
-                 ())}
+                 (LISTIFY(DT_PROP_LEN(node, bindings), KEYMAP_BINDING, (, ), node)), ())}
 
 #if ZMK_KEYMAP_HAS_SENSORS
 #define _TRANSFORM_SENSOR_ENTRY(idx, layer)                                                        \
@@ -48,6 +86,9 @@ static zmk_keymap_layer_id_t _zmk_keymap_layer_default = 0;
                               (DT_PHA_BY_IDX(layer, sensor_bindings, idx, param1))),               \
         .param2 = COND_CODE_0(DT_PHA_HAS_CELL_AT_IDX(layer, sensor_bindings, idx, param2), (0),    \
                               (DT_PHA_BY_IDX(layer, sensor_bindings, idx, param2))),               \
+        .device = COND_CODE_1(IS_ENABLED(CONFIG_ZMK_KEYMAP_STATIC),                                \
+                              (DEVICE_DT_GET(DT_PHANDLE_BY_IDX(layer, sensor_bindings, idx))),     \
+                              (NULL)),                                                             \
     }
 
 #define SENSOR_LAYER(node)                                                                         \
@@ -62,11 +103,6 @@ static zmk_keymap_layer_id_t _zmk_keymap_layer_default = 0;
 
 // State
 
-// When a behavior handles a key position "down" event, we record the layer state
-// here so that even if that layer is deactivated before the "up", event, we
-// still send the release event to the behavior in that layer also.
-static uint32_t zmk_keymap_active_behavior_layer[ZMK_KEYMAP_LEN];
-
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
 static uint8_t keymap_layer_orders[ZMK_KEYMAP_LAYERS_LEN];
@@ -104,6 +140,143 @@ static struct zmk_behavior_binding
 
 #endif /* ZMK_KEYMAP_HAS_SENSORS */
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_PACKED_BINDINGS)
+
+#define PACKED_BEHAVIOR_NONE UINT16_MAX
+
+// Position-major copy of zmk_keymap, kept up to date whenever a binding changes. The behavior is
+// stored as an index into the behavior local ID map, so both its device and its local ID (which
+// may only be assigned once settings are loaded) are one lookup away.
+struct packed_binding {
+    uint16_t behavior;
+    uint32_t param1;
+    uint32_t param2;
+};
+
+static struct packed_binding zmk_keymap_packed[ZMK_KEYMAP_LEN][ZMK_KEYMAP_LAYERS_LEN];
+
+static uint16_t packed_behavior_index(const struct device *dev) {
+    if (!dev) {
+        return PACKED_BEHAVIOR_NONE;
+    }
+
+    ptrdiff_t count;
+    STRUCT_SECTION_COUNT(zmk_behavior_local_id_map, &count);
+
+    for (ptrdiff_t i = 0; i < count; i++) {
+        const struct zmk_behavior_local_id_map *item;
+        STRUCT_SECTION_GET(zmk_behavior_local_id_map, i, &item);
+
+        if (item->device == dev) {
+            return i;
+        }
+    }
+
+    return PACKED_BEHAVIOR_NONE;
+}
+
+static const struct zmk_behavior_local_id_map *
+packed_behavior(const struct packed_binding *packed) {
+    if (packed->behavior == PACKED_BEHAVIOR_NONE) {
+        return NULL;
+    }
+
+    const struct zmk_behavior_local_id_map *item;
+    STRUCT_SECTION_GET(zmk_behavior_local_id_map, packed->behavior, &item);
+
+    return item;
+}
+
+#elif !IS_ENABLED(CONFIG_ZMK_KEYMAP_STATIC)
+
+// Behavior devices resolved from zmk_keymap (which may be const), kept up to date whenever a
+// binding changes so that key presses never have to look a behavior up by name.
+static const struct device *zmk_keymap_devices[ZMK_KEYMAP_LAYERS_LEN][ZMK_KEYMAP_LEN];
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_PACKED_BINDINGS)
+
+// Layer resolution cache. For each position, the layer_resolution of a context holds the layer
+// *indexes* whose bindings a key event has to try under its current layer state: active layers
+// from the default layer up, minus those where the position is bound to &trans. Entries are
+// rebuilt lazily, the first time a position is used after layer_resolution_gen moved on; anything
+// that changes the layer state of any context, the layer order, a binding or the selected physical
+// layout bumps it. keymap_trans_layers is indexed by stock position, like the bindings.
+static zmk_keymap_layers_state_t keymap_trans_layers[ZMK_KEYMAP_LEN];
+static uint32_t layer_resolution_gen = 1;
+
+static inline void invalidate_layer_resolution(void) { layer_resolution_gen++; }
+
+#define IS_TRANSPARENT_DEVICE(node) || dev == DEVICE_DT_GET(node)
+
+static bool is_transparent_device(const struct device *dev) {
+    return dev != NULL && (false DT_FOREACH_STATUS_OKAY(zmk_behavior_transparent,
+                                                         IS_TRANSPARENT_DEVICE));
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_STATIC)
+
+// Layers whose binding at each position can be dispatched straight to its behavior driver. The
+// locality and parameter conversion of a behavior live in its driver API, which the devicetree
+// doesn't describe, so these are worked out when the keymap loads.
+static zmk_keymap_layers_state_t keymap_direct_layers[ZMK_KEYMAP_LEN];
+
+static bool is_direct_device(const struct device *dev) {
+    if (!device_is_ready(dev)) {
+        return false;
+    }
+
+    const struct behavior_driver_api *api = (const struct behavior_driver_api *)dev->api;
+    if (api->binding_convert_central_state_dependent_params != NULL) {
+        return false;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT) && IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+    // Other localities may also run the behavior on peripherals.
+    return api->locality == BEHAVIOR_LOCALITY_CENTRAL;
+#else
+    return true;
+#endif
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_STATIC)
+
+static void resolve_binding_device(zmk_keymap_layer_id_t layer_id, uint32_t position) {
+    const struct zmk_behavior_binding *binding = &zmk_keymap[layer_id][position];
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_STATIC)
+    const struct device *dev = binding->device;
+#else
+    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_PACKED_BINDINGS)
+    zmk_keymap_packed[position][layer_id] = (struct packed_binding){
+        .behavior = packed_behavior_index(dev),
+        .param1 = binding->param1,
+        .param2 = binding->param2,
+    };
+#elif IS_ENABLED(CONFIG_ZMK_KEYMAP_STATIC)
+    WRITE_BIT(keymap_direct_layers[position], layer_id, is_direct_device(dev));
+#else
+    zmk_keymap_devices[layer_id][position] = dev;
+#endif
+    WRITE_BIT(keymap_trans_layers[position], layer_id, is_transparent_device(dev));
+    invalidate_layer_resolution();
+}
+
+static void resolve_binding_devices(void) {
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        for (int k = 0; k < ZMK_KEYMAP_LEN; k++) {
+            resolve_binding_device(l, k);
+        }
+#if ZMK_KEYMAP_HAS_SENSORS && !IS_ENABLED(CONFIG_ZMK_KEYMAP_STATIC)
+        for (int s = 0; s < ZMK_KEYMAP_SENSORS_LEN; s++) {
+            struct zmk_behavior_binding *binding = &zmk_sensor_keymap[l][s];
+            binding->device = zmk_behavior_get_binding(binding->behavior_dev);
+        }
+#endif /* ZMK_KEYMAP_HAS_SENSORS && !IS_ENABLED(CONFIG_ZMK_KEYMAP_STATIC) */
+    }
+}
+
 #define ASSERT_LAYER_VAL(_layer, _fail_ret)                                                        \
     if ((_layer) >= ZMK_KEYMAP_LAYERS_LEN) {                                                       \
         return (_fail_ret);                                                                        \
@@ -131,71 +304,124 @@ uint8_t map_layer_id_to_index(zmk_keymap_layer_id_t layer_id) {
 
 #endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
-static inline int set_layer_state(zmk_keymap_layer_id_t layer_id, bool state, bool locking) {
-    int ret = 0;
-    if (layer_id >= ZMK_KEYMAP_LAYERS_LEN) {
-        return -EINVAL;
-    }
-
+// Returns whether the layer changed
+static bool apply_layer_state(zmk_keymap_layer_id_t layer_id, bool state, bool locking) {
     // Default layer should *always* remain active
-    if (layer_id == _zmk_keymap_layer_default && !state) {
-        return 0;
+    if (layer_id == STATE->layer_default && !state) {
+        return false;
     }
 
     // Non-forcing disables should not change a locked active layer
-    if (!locking && !state && (_zmk_keymap_layer_locks & BIT(layer_id))) {
-        return ret;
+    if (!locking && !state && (STATE->layer_locks & BIT(layer_id))) {
+        return false;
     }
 
-    zmk_keymap_layers_state_t old_state = _zmk_keymap_layer_state;
-    zmk_keymap_layers_state_t old_locks = _zmk_keymap_layer_locks;
-    WRITE_BIT(_zmk_keymap_layer_state, layer_id, state);
+    zmk_keymap_layers_state_t old_state = STATE->layer_state;
+    zmk_keymap_layers_state_t old_locks = STATE->layer_locks;
+    WRITE_BIT(STATE->layer_state, layer_id, state);
     if (locking) {
-        WRITE_BIT(_zmk_keymap_layer_locks, layer_id, state);
+        WRITE_BIT(STATE->layer_locks, layer_id, state);
     }
+
     // Don't send state changes unless there was an actual change
-    if (old_state != _zmk_keymap_layer_state || old_locks != _zmk_keymap_layer_locks) {
-        LOG_DBG("layer_changed: layer %d state %d locked %d", layer_id, state, locking);
+    if (old_state == STATE->layer_state && old_locks == STATE->layer_locks) {
+        return false;
+    }
 
-        ret = raise_layer_state_changed(layer_id, state, locking);
-        if (ret < 0) {
-            LOG_WRN("Failed to raise layer state changed (%d)", ret);
+    LOG_DBG("layer_changed: layer %d state %d locked %d", layer_id, state, locking);
+    return true;
+}
+
+// Layers are deactivated before others are activated, each from the highest, as when changed one
+// by one with zmk_keymap_layer_to(). Every layer is applied before the first event is raised, and
+// each event carries the layer states from just before and after its own layer changed.
+static int set_layers_state(zmk_keymap_layers_state_t state, zmk_keymap_layers_state_t mask,
+                            zmk_keymap_layers_state_t locking) {
+    zmk_keymap_layers_state_t old_state = STATE->layer_state;
+    zmk_keymap_layer_id_t changed_layers[ZMK_KEYMAP_LAYERS_LEN];
+    int changed_len = 0;
+
+    for (int pass = 0; pass < 2; pass++) {
+        bool activating = pass == 1;
+
+        for (int layer_id = ZMK_KEYMAP_LAYERS_LEN - 1; layer_id >= 0; layer_id--) {
+            if ((mask & BIT(layer_id)) == 0 || ((state & BIT(layer_id)) != 0) != activating) {
+                continue;
+            }
+
+            if (apply_layer_state(layer_id, activating, (locking & BIT(layer_id)) != 0)) {
+                changed_layers[changed_len++] = layer_id;
+            }
+        }
+    }
+
+    if (changed_len == 0) {
+        return 0;
+    }
+
+    if (old_state != STATE->layer_state) {
+        invalidate_layer_resolution();
+    }
+
+    int ret = 0;
+    zmk_keymap_layers_state_t layers_state = old_state;
+
+    for (int i = 0; i < changed_len; i++) {
+        zmk_keymap_layer_id_t layer_id = changed_layers[i];
+        bool layer_state = (state & BIT(layer_id)) != 0;
+        zmk_keymap_layers_state_t before = layers_state;
+
+        WRITE_BIT(layers_state, layer_id, layer_state);
+
+        int err = raise_layer_state_changed(layer_id, layer_state, (locking & BIT(layer_id)) != 0,
+                                            before, layers_state);
+        if (err < 0) {
+            LOG_WRN("Failed to raise layer state changed (%d)", err);
+            ret = ret < 0 ? ret : err;
         }
     }
 
     return ret;
 }
 
+static inline int set_layer_state(zmk_keymap_layer_id_t layer_id, bool state, bool locking) {
+    if (layer_id >= ZMK_KEYMAP_LAYERS_LEN) {
+        return -EINVAL;
+    }
+
+    return set_layers_state(state ? BIT(layer_id) : 0, BIT(layer_id), locking ? BIT(layer_id) : 0);
+}
+
 zmk_keymap_layer_id_t zmk_keymap_layer_index_to_id(zmk_keymap_layer_index_t layer_index) {
     ASSERT_LAYER_VAL(layer_index, UINT8_MAX);
 
     return LAYER_INDEX_TO_ID(layer_index);
 }
 
-zmk_keymap_layer_id_t zmk_keymap_layer_default(void) { return _zmk_keymap_layer_default; }
+zmk_keymap_layer_id_t zmk_keymap_layer_default(void) { return STATE->layer_default; }
 
-zmk_keymap_layers_state_t zmk_keymap_layer_state(void) { return _zmk_keymap_layer_state; }
+zmk_keymap_layers_state_t zmk_keymap_layer_state(void) { return STATE->layer_state; }
 
-zmk_keymap_layers_state_t zmk_keymap_layer_locks(void) { return _zmk_keymap_layer_locks; }
+zmk_keymap_layers_state_t zmk_keymap_layer_locks(void) { return STATE->layer_locks; }
 
 bool zmk_keymap_layer_active_with_state(zmk_keymap_layer_id_t layer,
                                         zmk_keymap_layers_state_t state_to_test) {
     // The default layer is assumed to be ALWAYS ACTIVE so we include an || here to ensure nobody
     // breaks up that assumption by accident
-    return (state_to_test & (BIT(layer))) == (BIT(layer)) || layer == _zmk_keymap_layer_default;
+    return (state_to_test & (BIT(layer))) == (BIT(layer)) || layer == STATE->layer_default;
 };
 
 bool zmk_keymap_layer_active(zmk_keymap_layer_id_t layer) {
-    return zmk_keymap_layer_active_with_state(layer, _zmk_keymap_layer_state);
+    return zmk_keymap_layer_active_with_state(layer, STATE->layer_state);
 };
 
 bool zmk_keymap_layer_locked(zmk_keymap_layer_id_t layer) {
-    return zmk_keymap_layer_active_with_state(layer, _zmk_keymap_layer_locks);
+    return zmk_keymap_layer_active_with_state(layer, STATE->layer_locks);
 }
 
 zmk_keymap_layer_index_t zmk_keymap_highest_layer_active(void) {
     for (int layer_idx = ZMK_KEYMAP_LAYERS_LEN - 1;
-         layer_idx >= LAYER_ID_TO_INDEX(_zmk_keymap_layer_default); layer_idx--) {
+         layer_idx >= LAYER_ID_TO_INDEX(STATE->layer_default); layer_idx--) {
         zmk_keymap_layer_id_t layer_id = LAYER_INDEX_TO_ID(layer_idx);
 
         if (layer_id == ZMK_KEYMAP_LAYER_ID_INVAL) {
@@ -226,57 +452,114 @@ int zmk_keymap_layer_toggle(zmk_keymap_layer_id_t layer, bool locking) {
 };
 
 int zmk_keymap_layer_to(zmk_keymap_layer_id_t layer, bool locking) {
-    for (int i = ZMK_KEYMAP_LAYERS_LEN - 1; i >= 0; i--) {
-        zmk_keymap_layer_deactivate(i, locking);
+    if (layer >= ZMK_KEYMAP_LAYERS_LEN) {
+        return -EINVAL;
     }
 
-    zmk_keymap_layer_activate(layer, locking);
+    zmk_keymap_layers_state_t all_layers = ~(zmk_keymap_layers_state_t)0;
+    set_layers_state(BIT(layer), all_layers, locking ? all_layers : 0);
 
     return 0;
 }
 
+int zmk_keymap_layers_set(zmk_keymap_layers_state_t state, zmk_keymap_layers_state_t mask,
+                          zmk_keymap_layers_state_t locking) {
+    return set_layers_state(state, mask, locking);
+}
+
 const char *zmk_keymap_layer_name(zmk_keymap_layer_id_t layer_id) {
     ASSERT_LAYER_VAL(layer_id, NULL)
 
     return zmk_keymap_layer_names[layer_id];
 }
 
-const struct zmk_behavior_binding *
-zmk_keymap_get_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint16_t binding_idx) {
-    if (binding_idx >= ZMK_KEYMAP_LEN) {
-        return NULL;
-    }
-
-    ASSERT_LAYER_VAL(layer_id, NULL)
-
+static int get_stock_position_for_binding_idx(uint16_t binding_idx) {
     const uint32_t *pos_map;
     int ret = zmk_physical_layouts_get_selected_to_stock_position_map(&pos_map);
     if (ret < 0) {
         LOG_WRN("Failed to get the position map, can't find the right binding to return (%d)", ret);
-        return NULL;
+        return ret;
     }
 
     if (binding_idx >= ret) {
         LOG_WRN("Can't return binding for unmapped binding index %d", binding_idx);
-        return NULL;
+        return -EINVAL;
     }
 
     uint32_t mapped_idx = pos_map[binding_idx];
 
     if (mapped_idx >= ZMK_KEYMAP_LEN) {
         LOG_WRN("Binding index %d mapped to an invalid key position %d", binding_idx, mapped_idx);
+        return -EINVAL;
+    }
+
+    return mapped_idx;
+}
+
+const struct zmk_behavior_binding *
+zmk_keymap_get_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint16_t binding_idx) {
+    if (binding_idx >= ZMK_KEYMAP_LEN) {
+        return NULL;
+    }
+
+    ASSERT_LAYER_VAL(layer_id, NULL)
+
+    int mapped_idx = get_stock_position_for_binding_idx(binding_idx);
+    if (mapped_idx < 0) {
         return NULL;
     }
 
     return &zmk_keymap[layer_id][mapped_idx];
 }
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_PACKED_BINDINGS)
+
+int zmk_keymap_get_layer_local_binding_at_idx(zmk_keymap_layer_id_t layer_id,
+                                              uint16_t binding_idx,
+                                              struct zmk_keymap_local_binding *binding) {
+    if (binding_idx >= ZMK_KEYMAP_LEN) {
+        return -EINVAL;
+    }
+
+    ASSERT_LAYER_VAL(layer_id, -EINVAL)
+
+    int mapped_idx = get_stock_position_for_binding_idx(binding_idx);
+    if (mapped_idx < 0) {
+        return -EINVAL;
+    }
+
+    const struct packed_binding *packed = &zmk_keymap_packed[mapped_idx][layer_id];
+    const struct zmk_behavior_local_id_map *behavior = packed_behavior(packed);
+    if (!behavior) {
+        return -ENODEV;
+    }
+
+    *binding = (struct zmk_keymap_local_binding){
+        .behavior_local_id = behavior->local_id,
+        .param1 = packed->param1,
+        .param2 = packed->param2,
+    };
+
+    return 0;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_PACKED_BINDINGS)
+
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
 
 #define PENDING_ARRAY_SIZE DIV_ROUND_UP(ZMK_KEYMAP_LEN, 8)
 
 static uint8_t zmk_keymap_layer_pending_changes[ZMK_KEYMAP_LAYERS_LEN][PENDING_ARRAY_SIZE];
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_DELTAS)
+
+// Layers saved by zmk_keymap_save_changes() whose delta hasn't been written to settings yet.
+static atomic_t unwritten_layer_deltas;
+
+static void write_layer_deltas(void);
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_DELTAS)
+
 int zmk_keymap_set_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint16_t binding_idx,
                                         struct zmk_behavior_binding binding) {
     if (binding_idx >= ZMK_KEYMAP_LEN) {
@@ -310,12 +593,20 @@ int zmk_keymap_set_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint16_t
         return 0;
     }
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_DELTAS)
+    // Write out an earlier save of this layer first, so it doesn't pick up this unsaved change.
+    if (atomic_test_bit(&unwritten_layer_deltas, layer_id)) {
+        write_layer_deltas();
+    }
+#endif
+
     uint8_t *pending = zmk_keymap_layer_pending_changes[layer_id];
 
     WRITE_BIT(pending[storage_binding_idx / 8], storage_binding_idx % 8, 1);
 
     // TODO: Need a mutex to protect access to the keymap data?
     memcpy(&zmk_keymap[layer_id][storage_binding_idx], &binding, sizeof(binding));
+    resolve_binding_device(layer_id, storage_binding_idx);
 
     return 0;
 }
@@ -360,6 +651,7 @@ int zmk_keymap_move_layer(zmk_keymap_layer_index_t start_idx, zmk_keymap_layer_i
         keymap_layer_orders[dest_idx] = val;
     }
 
+    invalidate_layer_resolution();
     return 0;
 }
 
@@ -378,6 +670,7 @@ int zmk_keymap_add_layer(void) {
         for (int candidate_id = 0; candidate_id < ZMK_KEYMAP_LAYERS_LEN; candidate_id++) {
             if (!(seen_layer_ids & BIT(candidate_id))) {
                 keymap_layer_orders[index] = candidate_id;
+                invalidate_layer_resolution();
                 return index;
             }
         }
@@ -405,6 +698,7 @@ int zmk_keymap_remove_layer(zmk_keymap_layer_index_t index) {
 
     LOG_HEXDUMP_DBG(keymap_layer_orders, ZMK_KEYMAP_LAYERS_LEN, "Order");
 
+    invalidate_layer_resolution();
     return 0;
 }
 
@@ -418,6 +712,7 @@ int zmk_keymap_restore_layer(zmk_keymap_layer_id_t id, zmk_keymap_layer_index_t
 
     keymap_layer_orders[at_index] = id;
 
+    invalidate_layer_resolution();
     return 0;
 }
 
@@ -495,6 +790,150 @@ int zmk_keymap_check_unsaved_changes(void) {
 #define LAYER_NAME_SETTINGS_KEY "keymap/l_n/%d"
 #define LAYER_BINDING_SETTINGS_KEY "keymap/l/%d/%d"
 
+#define LAYER_DELTA_SETTINGS_KEY "keymap/ld/%d"
+
+static zmk_behavior_local_id_t binding_local_id(zmk_keymap_layer_id_t layer, uint32_t position) {
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_PACKED_BINDINGS)
+    const struct zmk_behavior_local_id_map *behavior =
+        packed_behavior(&zmk_keymap_packed[position][layer]);
+    return behavior ? behavior->local_id : UINT16_MAX;
+#else
+    return zmk_behavior_get_local_id(zmk_keymap[layer][position].behavior_dev);
+#endif
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_DELTAS)
+
+// One entry of a layer delta. A delta holds every binding of its layer that differs from the
+// stock keymap, so loading one only needs the stock layer as a starting point.
+struct zmk_keymap_delta_entry {
+    uint16_t position;
+    struct zmk_behavior_binding_setting binding;
+} __packed;
+
+// Per-binding settings found while loading, removed once their layer is written as a delta.
+static uint8_t legacy_binding_settings[ZMK_KEYMAP_LAYERS_LEN][PENDING_ARRAY_SIZE];
+
+// Layers loaded from a delta, which supersedes any per-binding settings left for them.
+static uint32_t loaded_layer_deltas;
+
+static K_MUTEX_DEFINE(layer_delta_mutex);
+
+static bool binding_is_stock(zmk_keymap_layer_id_t layer, uint32_t position) {
+    const struct zmk_behavior_binding *binding = &zmk_keymap[layer][position];
+    const struct zmk_behavior_binding *stock = &zmk_stock_keymap[layer][position];
+
+    if (binding->param1 != stock->param1 || binding->param2 != stock->param2) {
+        return false;
+    }
+
+    if (binding->behavior_dev == stock->behavior_dev) {
+        return true;
+    }
+
+    return binding->behavior_dev && stock->behavior_dev &&
+           strcmp(binding->behavior_dev, stock->behavior_dev) == 0;
+}
+
+static int write_layer_delta(zmk_keymap_layer_id_t layer) {
+    static struct zmk_keymap_delta_entry delta[ZMK_KEYMAP_LEN];
+    size_t count = 0;
+
+    for (int kp = 0; kp < ZMK_KEYMAP_LEN; kp++) {
+        if (binding_is_stock(layer, kp)) {
+            continue;
+        }
+
+        delta[count++] = (struct zmk_keymap_delta_entry){
+            .position = kp,
+            .binding =
+                {
+                    .behavior_local_id = binding_local_id(layer, kp),
+                    .param1 = zmk_keymap[layer][kp].param1,
+                    .param2 = zmk_keymap[layer][kp].param2,
+                },
+        };
+    }
+
+    char setting_name[14];
+    sprintf(setting_name, LAYER_DELTA_SETTINGS_KEY, layer);
+
+    LOG_DBG("Saving %d changed bindings for layer %d", count, layer);
+
+    int ret = count > 0 ? settings_save_one(setting_name, delta, count * sizeof(delta[0]))
+                        : settings_delete(setting_name);
+    if (ret < 0) {
+        return ret;
+    }
+
+    uint8_t *legacy = legacy_binding_settings[layer];
+    for (int kp = 0; kp < ZMK_KEYMAP_LEN; kp++) {
+        if (legacy[kp / 8] & BIT(kp % 8)) {
+            char binding_setting_name[20];
+            sprintf(binding_setting_name, LAYER_BINDING_SETTINGS_KEY, layer, kp);
+            settings_delete(binding_setting_name);
+
+            WRITE_BIT(legacy[kp / 8], kp % 8, 0);
+        }
+    }
+
+    return 0;
+}
+
+static void write_layer_deltas(void) {
+    k_mutex_lock(&layer_delta_mutex, K_FOREVER);
+
+    uint32_t layers = (uint32_t)atomic_clear(&unwritten_layer_deltas);
+
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        if (!(layers & BIT(l))) {
+            continue;
+        }
+
+        int ret = write_layer_delta(l);
+        if (ret < 0) {
+            LOG_ERR("Failed to save keymap delta for layer %d (%d)", l, ret);
+            // Keep the layer so the next save retries it.
+            atomic_set_bit(&unwritten_layer_deltas, l);
+        }
+    }
+
+    k_mutex_unlock(&layer_delta_mutex);
+}
+
+static void layer_delta_save_work_handler(struct k_work *work) { write_layer_deltas(); }
+
+static K_WORK_DELAYABLE_DEFINE(layer_delta_save_work, layer_delta_save_work_handler);
+
+static int save_bindings(void) {
+    uint32_t layers = 0;
+
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        uint8_t *pending = zmk_keymap_layer_pending_changes[l];
+
+        for (int i = 0; i < PENDING_ARRAY_SIZE; i++) {
+            if (pending[i]) {
+                layers |= BIT(l);
+                break;
+            }
+        }
+
+        memset(pending, 0, PENDING_ARRAY_SIZE);
+    }
+
+    if (!layers) {
+        return 0;
+    }
+
+    atomic_or(&unwritten_layer_deltas, layers);
+
+    int ret = k_work_reschedule(&layer_delta_save_work,
+                                K_MSEC(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_DELTAS_DEBOUNCE));
+    return MIN(ret, 0);
+}
+
+#else
+
 static int save_bindings(void) {
     for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
         uint8_t *pending = zmk_keymap_layer_pending_changes[l];
@@ -507,7 +946,7 @@ static int save_bindings(void) {
                         binding->behavior_dev, binding->param1, binding->param2);
 
                 struct zmk_behavior_binding_setting binding_setting = {
-                    .behavior_local_id = zmk_behavior_get_local_id(binding->behavior_dev),
+                    .behavior_local_id = binding_local_id(l, kp),
                     .param1 = binding->param1,
                     .param2 = binding->param2,
                 };
@@ -526,7 +965,7 @@ static int save_bindings(void) {
                 char setting_name[20];
                 sprintf(setting_name, LAYER_BINDING_SETTINGS_KEY, l, kp);
 
-                int ret = settings_save_one(setting_name, &binding_setting, len);
+                int ret = zmk_settings_save(setting_name, &binding_setting, len);
                 if (ret < 0) {
                     LOG_ERR("Failed to save keymap binding at %d on layer %d (%d)", l, kp, ret);
                     return ret;
@@ -540,9 +979,11 @@ static int save_bindings(void) {
     return 0;
 }
 
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_DELTAS)
+
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 static int save_layer_orders(void) {
-    int ret = settings_save_one(LAYER_ORDER_SETTINGS_KEY, keymap_layer_orders,
+    int ret = zmk_settings_save(LAYER_ORDER_SETTINGS_KEY, keymap_layer_orders,
                                 ARRAY_SIZE(keymap_layer_orders));
     if (ret < 0) {
         return ret;
@@ -558,7 +999,7 @@ static int save_layer_names(void) {
         if (changed_layer_names & BIT(id)) {
             char setting_name[14];
             sprintf(setting_name, LAYER_NAME_SETTINGS_KEY, id);
-            int ret = settings_save_one(setting_name, zmk_keymap_layer_names[id],
+            int ret = zmk_settings_save(setting_name, zmk_keymap_layer_names[id],
                                         strlen(zmk_keymap_layer_names[id]));
             if (ret < 0) {
                 return ret;
@@ -583,7 +1024,20 @@ int zmk_keymap_save_changes(void) {
     }
 #endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
-    return save_layer_names();
+    ret = save_layer_names();
+    if (ret < 0) {
+        return ret;
+    }
+
+    // An explicit save is written now, along with anything else waiting to be saved.
+    return zmk_settings_flush();
+}
+
+void zmk_keymap_flush_saved_changes(void) {
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_DELTAS)
+    k_work_cancel_delayable(&layer_delta_save_work);
+    write_layer_deltas();
+#endif
 }
 
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
@@ -600,6 +1054,8 @@ static void load_stock_keymap_layer_ordering() {
         keymap_layer_orders[i] = ZMK_KEYMAP_LAYER_ID_INVAL;
         i++;
     }
+
+    invalidate_layer_resolution();
 }
 #endif
 
@@ -609,13 +1065,26 @@ static void reload_from_stock_keymap(void) {
             zmk_keymap[l][k] = zmk_stock_keymap[l][k];
         }
     }
+    resolve_binding_devices();
 }
 
 int zmk_keymap_discard_changes(void) {
+    // Saved changes have to reach settings before the keymap is reloaded from there.
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_DELTAS)
+    k_work_cancel_delayable(&layer_delta_save_work);
+    write_layer_deltas();
+    loaded_layer_deltas = 0;
+#endif
+
+    int ret = zmk_settings_flush();
+    if (ret < 0) {
+        return ret;
+    }
+
     load_stock_keymap_layer_ordering();
     reload_from_stock_keymap();
 
-    int ret = settings_load_subtree("keymap");
+    ret = settings_load_subtree("keymap");
     if (ret >= 0) {
         changed_layer_names = 0;
 
@@ -653,7 +1122,13 @@ static int keymap_track_changed_bindings(const char *key, size_t len, settings_r
 }
 
 int zmk_keymap_reset_settings(void) {
-    settings_delete(LAYER_ORDER_SETTINGS_KEY);
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_DELTAS)
+    k_work_cancel_delayable(&layer_delta_save_work);
+    atomic_clear(&unwritten_layer_deltas);
+    loaded_layer_deltas = 0;
+#endif
+
+    zmk_settings_delete(LAYER_ORDER_SETTINGS_KEY);
 
     uint8_t zmk_keymap_layer_changes[ZMK_KEYMAP_LAYERS_LEN][PENDING_ARRAY_SIZE];
 
@@ -663,7 +1138,13 @@ int zmk_keymap_reset_settings(void) {
     for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
         char layer_name_setting_name[14];
         sprintf(layer_name_setting_name, LAYER_NAME_SETTINGS_KEY, l);
-        settings_delete(layer_name_setting_name);
+        zmk_settings_delete(layer_name_setting_name);
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_DELTAS)
+        char layer_delta_setting_name[14];
+        sprintf(layer_delta_setting_name, LAYER_DELTA_SETTINGS_KEY, l);
+        settings_delete(layer_delta_setting_name);
+#endif
 
         uint8_t *changes = zmk_keymap_layer_changes[l];
 
@@ -677,7 +1158,7 @@ int zmk_keymap_reset_settings(void) {
                 LOG_WRN("CLEAR %d on %d layer", k, l);
                 char setting_name[20];
                 sprintf(setting_name, LAYER_BINDING_SETTINGS_KEY, l, k);
-                settings_delete(setting_name);
+                zmk_settings_delete(setting_name);
             }
         }
     }
@@ -693,6 +1174,8 @@ int zmk_keymap_reset_settings(void) {
 
 int zmk_keymap_save_changes(void) { return -ENOTSUP; }
 
+void zmk_keymap_flush_saved_changes(void) {}
+
 int zmk_keymap_discard_changes(void) { return -ENOTSUP; }
 
 int zmk_keymap_reset_settings(void) { return -ENOTSUP; }
@@ -701,8 +1184,6 @@ int zmk_keymap_reset_settings(void) { return -ENOTSUP; }
 
 int zmk_keymap_apply_position_state(uint8_t source, zmk_keymap_layer_id_t layer_id,
                                     uint32_t position, bool pressed, int64_t timestamp) {
-    const struct zmk_behavior_binding *binding =
-        zmk_keymap_get_layer_binding_at_idx(layer_id, position);
     struct zmk_behavior_binding_event event = {
         .layer = layer_id,
         .position = position,
@@ -712,39 +1193,126 @@ int zmk_keymap_apply_position_state(uint8_t source, zmk_keymap_layer_id_t layer_
 #endif
     };
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_PACKED_BINDINGS)
+    ASSERT_LAYER_VAL(layer_id, -EINVAL)
+
+    int mapped_idx = get_stock_position_for_binding_idx(position);
+    if (mapped_idx < 0) {
+        return mapped_idx;
+    }
+
+    const struct packed_binding *packed = &zmk_keymap_packed[mapped_idx][layer_id];
+    const struct zmk_behavior_local_id_map *behavior = packed_behavior(packed);
+
+    struct zmk_behavior_binding resolved = {
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+        .local_id = behavior ? behavior->local_id : 0,
+#endif
+        .behavior_dev = behavior ? behavior->device->name : NULL,
+        .param1 = packed->param1,
+        .param2 = packed->param2,
+        .device = behavior ? behavior->device : NULL,
+    };
+
+    LOG_DBG("layer_id: %d position: %d, binding name: %s", layer_id, position,
+            resolved.behavior_dev ? resolved.behavior_dev : "");
+#else
+    const struct zmk_behavior_binding *binding =
+        zmk_keymap_get_layer_binding_at_idx(layer_id, position);
+
     LOG_DBG("layer_id: %d position: %d, binding name: %s", layer_id, position,
             binding->behavior_dev);
 
-    return zmk_behavior_invoke_binding(binding, event, pressed);
+    uint32_t mapped_idx = binding - zmk_keymap[layer_id];
+    struct zmk_behavior_binding resolved = *binding;
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_STATIC)
+    if (keymap_direct_layers[mapped_idx] & BIT(layer_id)) {
+        const struct behavior_driver_api *api =
+            (const struct behavior_driver_api *)resolved.device->api;
+        behavior_keymap_binding_callback_t handler =
+            pressed ? api->binding_pressed : api->binding_released;
+
+        if (handler == NULL) {
+            return -ENOTSUP;
+        }
+
+        uint32_t start = zmk_stage_timing_start();
+        int ret = handler(&resolved, event);
+
+        zmk_stage_timing_end(ZMK_STAGE_BEHAVIOR, start);
+        return ret;
+    }
+#else
+    resolved.device = zmk_keymap_devices[layer_id][mapped_idx];
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_STATIC)
+#endif
+
+    return zmk_behavior_invoke_binding(&resolved, event, pressed);
 }
 
-int zmk_keymap_position_state_changed(uint8_t source, uint32_t position, bool pressed,
-                                      int64_t timestamp) {
-    if (pressed) {
-        zmk_keymap_active_behavior_layer[position] = _zmk_keymap_layer_state;
+static zmk_keymap_layers_state_t compute_layer_resolution(uint32_t position,
+                                                          zmk_keymap_layers_state_t state) {
+    zmk_keymap_layers_state_t indexes = 0;
+    int stock_position = get_stock_position_for_binding_idx(position);
+
+    if (stock_position < 0) {
+        return 0;
     }
 
     // We use int here to be sure we don't loop layer_idx back to UINT8_MAX
-    for (int layer_idx = ZMK_KEYMAP_LAYERS_LEN - 1;
-         layer_idx >= LAYER_ID_TO_INDEX(_zmk_keymap_layer_default); layer_idx--) {
+    for (int layer_idx = LAYER_ID_TO_INDEX(STATE->layer_default);
+         layer_idx < ZMK_KEYMAP_LAYERS_LEN; layer_idx++) {
         zmk_keymap_layer_id_t layer_id = LAYER_INDEX_TO_ID(layer_idx);
 
         if (layer_id == ZMK_KEYMAP_LAYER_ID_INVAL) {
             continue;
         }
-        if (zmk_keymap_layer_active_with_state(layer_id,
-                                               zmk_keymap_active_behavior_layer[position])) {
-            int ret =
-                zmk_keymap_apply_position_state(source, layer_id, position, pressed, timestamp);
-            if (ret > 0) {
-                LOG_DBG("behavior processing to continue to next layer");
-                continue;
-            } else if (ret < 0) {
-                LOG_DBG("Behavior returned error: %d", ret);
-                return ret;
-            } else {
-                return ret;
-            }
+        if (zmk_keymap_layer_active_with_state(layer_id, state) &&
+            !(keymap_trans_layers[stock_position] & BIT(layer_id))) {
+            WRITE_BIT(indexes, layer_idx, 1);
+        }
+    }
+
+    return indexes;
+}
+
+int zmk_keymap_position_state_changed(uint8_t source, uint32_t position, bool pressed,
+                                      int64_t timestamp) {
+    if (pressed) {
+        STATE->active_behavior_layer[position] = STATE->layer_state;
+    }
+
+    zmk_keymap_layers_state_t state = STATE->active_behavior_layer[position];
+    zmk_keymap_layers_state_t indexes;
+
+    // A release under a layer state that has since changed is resolved without the cache.
+    if (state == STATE->layer_state) {
+        if (STATE->layer_resolution_valid_gen[position] != layer_resolution_gen) {
+            STATE->layer_resolution[position] = compute_layer_resolution(position, state);
+            STATE->layer_resolution_valid_gen[position] = layer_resolution_gen;
+        }
+        indexes = STATE->layer_resolution[position];
+    } else {
+        indexes = compute_layer_resolution(position, state);
+    }
+
+    // Highest layer index first
+    while (indexes) {
+        int layer_idx = find_msb_set(indexes) - 1;
+        zmk_keymap_layer_id_t layer_id = LAYER_INDEX_TO_ID(layer_idx);
+
+        WRITE_BIT(indexes, layer_idx, 0);
+
+        int ret = zmk_keymap_apply_position_state(source, layer_id, position, pressed, timestamp);
+        if (ret > 0) {
+            LOG_DBG("behavior processing to continue to next layer");
+            continue;
+        } else if (ret < 0) {
+            LOG_DBG("Behavior returned error: %d", ret);
+            return ret;
+        } else {
+            return ret;
         }
     }
 
@@ -752,29 +1320,56 @@ int zmk_keymap_position_state_changed(uint8_t source, uint32_t position, bool pr
 }
 
 #if ZMK_KEYMAP_HAS_SENSORS
+
+// Sensor counterpart of the layer resolution cache. For each sensor, it holds the layer indexes
+// with a behavior bound to it. Every one of them gets the sensor data, whether its layer is
+// active or not, so only the layer order and bindings matter, but it is rebuilt along with the
+// position cache.
+static zmk_keymap_layers_state_t sensor_layer_resolution[ZMK_KEYMAP_SENSORS_LEN];
+static uint32_t sensor_layer_resolution_valid_gen[ZMK_KEYMAP_SENSORS_LEN];
+
+static zmk_keymap_layers_state_t compute_sensor_layer_resolution(uint8_t sensor_index) {
+    zmk_keymap_layers_state_t indexes = 0;
+
+    for (int layer_idx = 0; layer_idx < ZMK_KEYMAP_LAYERS_LEN; layer_idx++) {
+        zmk_keymap_layer_id_t layer_id = LAYER_INDEX_TO_ID(layer_idx);
+
+        if (layer_id >= ZMK_KEYMAP_LAYERS_LEN) {
+            continue;
+        }
+
+        if (zmk_behavior_binding_get_device(&zmk_sensor_keymap[layer_id][sensor_index])) {
+            WRITE_BIT(indexes, layer_idx, 1);
+        }
+    }
+
+    return indexes;
+}
+
 int zmk_keymap_sensor_event(uint8_t sensor_index,
                             const struct zmk_sensor_channel_data *channel_data,
                             size_t channel_data_size, int64_t timestamp) {
     bool opaque_response = false;
 
-    for (int layer_idx = ZMK_KEYMAP_LAYERS_LEN - 1; layer_idx >= 0; layer_idx--) {
+    if (sensor_layer_resolution_valid_gen[sensor_index] != layer_resolution_gen) {
+        sensor_layer_resolution[sensor_index] = compute_sensor_layer_resolution(sensor_index);
+        sensor_layer_resolution_valid_gen[sensor_index] = layer_resolution_gen;
+    }
+
+    zmk_keymap_layers_state_t indexes = sensor_layer_resolution[sensor_index];
+
+    // Highest layer index first
+    while (indexes) {
+        int layer_idx = find_msb_set(indexes) - 1;
         uint8_t layer_id = LAYER_INDEX_TO_ID(layer_idx);
 
-        if (layer_id >= ZMK_KEYMAP_LAYERS_LEN) {
-            continue;
-        }
+        WRITE_BIT(indexes, layer_idx, 0);
 
         struct zmk_behavior_binding *binding = &zmk_sensor_keymap[layer_id][sensor_index];
 
         LOG_DBG("layer idx: %d, layer id: %d sensor_index: %d, binding name: %s", layer_idx,
                 layer_id, sensor_index, binding->behavior_dev);
 
-        const struct device *behavior = zmk_behavior_get_binding(binding->behavior_dev);
-        if (!behavior) {
-            LOG_DBG("No behavior assigned to %d on layer %d", sensor_index, layer_id);
-            continue;
-        }
-
         struct zmk_behavior_binding_event event = {
             .layer = layer_id,
             .position = ZMK_VIRTUAL_KEY_POSITION_SENSOR(sensor_index),
@@ -793,7 +1388,7 @@ int zmk_keymap_sensor_event(uint8_t sensor_index,
         }
 
         enum behavior_sensor_binding_process_mode mode =
-            (!opaque_response && layer_idx >= LAYER_ID_TO_INDEX(_zmk_keymap_layer_default) &&
+            (!opaque_response && layer_idx >= LAYER_ID_TO_INDEX(STATE->layer_default) &&
              zmk_keymap_layer_active(layer_id))
                 ? BEHAVIOR_SENSOR_BINDING_PROCESS_MODE_TRIGGER
                 : BEHAVIOR_SENSOR_BINDING_PROCESS_MODE_DISCARD;
@@ -829,11 +1424,18 @@ int keymap_listener(const zmk_event_t *eh) {
     }
 #endif /* ZMK_KEYMAP_HAS_SENSORS */
 
+    if (as_zmk_physical_layout_selection_changed(eh) != NULL) {
+        // Positions now map to other stock positions, and so to other bindings
+        invalidate_layer_resolution();
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
     return -ENOTSUP;
 }
 
 ZMK_LISTENER(keymap, keymap_listener);
 ZMK_SUBSCRIPTION(keymap, zmk_position_state_changed);
+ZMK_SUBSCRIPTION(keymap, zmk_physical_layout_selection_changed);
 
 #if ZMK_KEYMAP_HAS_SENSORS
 ZMK_SUBSCRIPTION(keymap, zmk_sensor_event);
@@ -841,6 +1443,27 @@ ZMK_SUBSCRIPTION(keymap, zmk_sensor_event);
 
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
 
+static void load_binding_setting(zmk_keymap_layer_id_t layer, uint32_t key_position,
+                                 const struct zmk_behavior_binding_setting *binding_setting) {
+    const char *name =
+        zmk_behavior_find_behavior_name_from_local_id(binding_setting->behavior_local_id);
+
+    if (!name) {
+        LOG_WRN("Loaded device %d from settings but no device found by that local ID",
+                binding_setting->behavior_local_id);
+    }
+
+    zmk_keymap[layer][key_position] = (struct zmk_behavior_binding){
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+        .local_id = binding_setting->behavior_local_id,
+#endif
+        .behavior_dev = name,
+        .param1 = binding_setting->param1,
+        .param2 = binding_setting->param2,
+    };
+    resolve_binding_device(layer, key_position);
+}
+
 static int keymap_handle_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg) {
     const char *next;
 
@@ -898,6 +1521,14 @@ static int keymap_handle_set(const char *name, size_t len, settings_read_cb read
             return -EINVAL;
         }
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_DELTAS)
+        WRITE_BIT(legacy_binding_settings[layer][key_position / 8], key_position % 8, 1);
+
+        if (loaded_layer_deltas & BIT(layer)) {
+            return 0;
+        }
+#endif
+
         struct zmk_behavior_binding_setting binding_setting = {0};
         int err = read_cb(cb_arg, &binding_setting, len);
         if (err <= 0) {
@@ -905,23 +1536,54 @@ static int keymap_handle_set(const char *name, size_t len, settings_read_cb read
             return err;
         }
 
-        const char *name =
-            zmk_behavior_find_behavior_name_from_local_id(binding_setting.behavior_local_id);
+        load_binding_setting(layer, key_position, &binding_setting);
+    }
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_DELTAS)
+    else if (settings_name_steq(name, "ld", &next) && next) {
+        static struct zmk_keymap_delta_entry delta[ZMK_KEYMAP_LEN];
 
-        if (!name) {
-            LOG_WRN("Loaded device %d from settings but no device found by that local ID",
-                    binding_setting.behavior_local_id);
+        char *endptr;
+        uint8_t layer = strtoul(next, &endptr, 10);
+        if (*endptr != '\0') {
+            LOG_WRN("Invalid layer number: %s with endptr %s", next, endptr);
+            return -EINVAL;
         }
 
-        zmk_keymap[layer][key_position] = (struct zmk_behavior_binding){
-#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
-            .local_id = binding_setting.behavior_local_id,
-#endif
-            .behavior_dev = name,
-            .param1 = binding_setting.param1,
-            .param2 = binding_setting.param2,
-        };
+        if (layer >= ZMK_KEYMAP_LAYERS_LEN) {
+            LOG_WRN("Layer %d is larger than max of %d", layer, ZMK_KEYMAP_LAYERS_LEN);
+            return -EINVAL;
+        }
+
+        if (len > sizeof(delta) || len % sizeof(delta[0]) != 0) {
+            LOG_ERR("Invalid layer delta size %d", len);
+            return -EINVAL;
+        }
+
+        int err = read_cb(cb_arg, delta, len);
+        if (err < 0) {
+            LOG_ERR("Failed to handle keymap layer delta from settings (err %d)", err);
+            return err;
+        }
+
+        // The delta replaces the whole layer, including anything loaded from per-binding settings.
+        for (int kp = 0; kp < ZMK_KEYMAP_LEN; kp++) {
+            zmk_keymap[layer][kp] = zmk_stock_keymap[layer][kp];
+            resolve_binding_device(layer, kp);
+        }
+
+        for (size_t i = 0; i < err / sizeof(delta[0]); i++) {
+            if (delta[i].position >= ZMK_KEYMAP_LEN) {
+                LOG_WRN("Key position %d is larger than max of %d", delta[i].position,
+                        ZMK_KEYMAP_LEN);
+                continue;
+            }
+
+            load_binding_setting(layer, delta[i].position, &delta[i].binding);
+        }
+
+        loaded_layer_deltas |= BIT(layer);
     }
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_LAYER_DELTAS)
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
     else if (settings_name_steq(name, "layer_order", &next) && !next) {
         int err =
@@ -936,6 +1598,7 @@ static int keymap_handle_set(const char *name, size_t len, settings_read_cb read
 
         memcpy(keymap_layer_orders, settings_layer_orders,
                MIN(len, ARRAY_SIZE(settings_layer_orders)));
+        invalidate_layer_resolution();
     }
 #endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
@@ -956,6 +1619,7 @@ static int keymap_handle_commit(void) {
                     LOG_ERR("Failed to finding device for local ID %d after settings load",
                             binding->local_id);
                 }
+                resolve_binding_device(l, p);
             }
         }
     }
@@ -975,6 +1639,8 @@ int keymap_init(void) {
 #endif
 #if IS_ENABLED(CONFIG_ZMK_STUDIO)
     reload_from_stock_keymap();
+#else
+    resolve_binding_devices();
 #endif
 
     return 0;
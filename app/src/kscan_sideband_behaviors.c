@@ -26,9 +26,15 @@ struct ksbb_entry {
 
 struct ksbb_config {
     const struct device *kscan;
+    // Callback given to the inner kscan, which knows which sideband device it belongs to.
+    kscan_callback_t inner_callback;
     bool auto_enable;
     struct ksbb_entry *entries;
     size_t entries_len;
+    // Index + 1 of the entry for each row and column, 0 if there's none.
+    uint8_t *entry_lookup;
+    uint8_t rows;
+    uint8_t columns;
 };
 
 struct ksbb_data {
@@ -36,60 +42,37 @@ struct ksbb_data {
     bool enabled;
 };
 
-#define GET_KSBB_DEV(n) DEVICE_DT_GET(DT_DRV_INST(n)),
-
-// The kscan callback has no context with it, so we keep a static array of all possible
-// KSBBs to check when a kscan callback from the "wrapped" inner kscan fires.
-static const struct device *ksbbs[] = {DT_INST_FOREACH_STATUS_OKAY(GET_KSBB_DEV)};
-
-const struct device *find_ksbb_for_inner(const struct device *inner_dev) {
-    for (int i = 0; i < ARRAY_SIZE(ksbbs); i++) {
-        const struct device *ksbb = ksbbs[i];
-        const struct ksbb_config *cfg = ksbb->config;
+static struct ksbb_entry *find_sideband_behavior(const struct device *dev, uint32_t row,
+                                                 uint32_t column) {
+    const struct ksbb_config *cfg = dev->config;
 
-        if (cfg->kscan == inner_dev) {
-            return ksbb;
-        }
+    if (row >= cfg->rows || column >= cfg->columns) {
+        return NULL;
     }
 
-    return NULL;
+    uint8_t idx = cfg->entry_lookup[row * cfg->columns + column];
+
+    return idx > 0 ? &cfg->entries[idx - 1] : NULL;
 }
 
-struct ksbb_entry *find_sideband_behavior(const struct device *dev, uint32_t row, uint32_t column) {
-    const struct ksbb_config *cfg = dev->config;
+static void ksbb_inner_kscan_callback(const struct device *ksbb, uint32_t row, uint32_t column,
+                                      bool pressed) {
+    struct ksbb_data *data = ksbb->data;
 
-    for (int e = 0; e < cfg->entries_len; e++) {
-        struct ksbb_entry *candidate = &cfg->entries[e];
+    struct ksbb_entry *entry = find_sideband_behavior(ksbb, row, column);
+    if (entry) {
+        struct zmk_behavior_binding_event event = {.position = INT32_MAX,
+                                                   .timestamp = k_uptime_get()};
 
-        if (candidate->row == row && candidate->column == column) {
-            return candidate;
+        if (pressed) {
+            behavior_keymap_binding_pressed(&entry->binding, event);
+        } else {
+            behavior_keymap_binding_released(&entry->binding, event);
         }
     }
 
-    return NULL;
-}
-
-void ksbb_inner_kscan_callback(const struct device *dev, uint32_t row, uint32_t column,
-                               bool pressed) {
-    const struct device *ksbb = find_ksbb_for_inner(dev);
-    if (ksbb) {
-        struct ksbb_data *data = ksbb->data;
-
-        struct ksbb_entry *entry = find_sideband_behavior(ksbb, row, column);
-        if (entry) {
-            struct zmk_behavior_binding_event event = {.position = INT32_MAX,
-                                                       .timestamp = k_uptime_get()};
-
-            if (pressed) {
-                behavior_keymap_binding_pressed(&entry->binding, event);
-            } else {
-                behavior_keymap_binding_released(&entry->binding, event);
-            }
-        }
-
-        if (data->enabled && data->callback) {
-            data->callback(ksbb, row, column, pressed);
-        }
+    if (data->enabled && data->callback) {
+        data->callback(ksbb, row, column, pressed);
     }
 }
 
@@ -117,7 +100,7 @@ static int ksbb_enable(const struct device *dev) {
     pm_device_action_run(config->kscan, PM_DEVICE_ACTION_RESUME);
 #endif // IS_ENABLED(CONFIG_PM_DEVICE)
 
-    kscan_config(config->kscan, &ksbb_inner_kscan_callback);
+    kscan_config(config->kscan, config->inner_callback);
     kscan_enable_callback(config->kscan);
 
     return 0;
@@ -168,6 +151,12 @@ static int ksbb_init(const struct device *dev) {
         return -ENODEV;
     }
 
+    // The first entry for a row and column wins, as it always has.
+    for (int e = config->entries_len - 1; e >= 0; e--) {
+        const struct ksbb_entry *entry = &config->entries[e];
+        config->entry_lookup[entry->row * config->columns + entry->column] = e + 1;
+    }
+
 #if IS_ENABLED(CONFIG_PM_DEVICE)
     if (!config->auto_enable) {
         pm_device_init_suspended(dev);
@@ -190,24 +179,51 @@ static const struct kscan_driver_api ksbb_api = {
         .binding = ZMK_KEYMAP_EXTRACT_BINDING(0, e),                                               \
     }
 
+// Using sizeof + union trick to find the largest row and column statically.
+#define ENTRY_ROW_ARRAY(e) uint8_t _CONCAT(row_, e)[DT_PROP(e, row) + 1];
+#define ENTRY_COLUMN_ARRAY(e) uint8_t _CONCAT(column_, e)[DT_PROP(e, column) + 1];
+
+#define KSBB_ROWS(n)                                                                               \
+    sizeof(union {                                                                                 \
+        uint8_t none;                                                                              \
+        DT_INST_FOREACH_CHILD_STATUS_OKAY(n, ENTRY_ROW_ARRAY)                                      \
+    })
+#define KSBB_COLUMNS(n)                                                                            \
+    sizeof(union {                                                                                 \
+        uint8_t none;                                                                              \
+        DT_INST_FOREACH_CHILD_STATUS_OKAY(n, ENTRY_COLUMN_ARRAY)                                   \
+    })
+
 #define KSBB_INST(n)                                                                               \
     COND_CODE_1(DT_INST_PROP_OR(n, auto_enable, false), (static int ksbb_auto_enable_##n(void) {   \
                     const struct device *dev = DEVICE_DT_GET(DT_DRV_INST(n));                      \
                     COND_CODE_1(IS_ENABLED(CONFIG_PM_DEVICE),                                      \
                                 (ksbb_pm_action(dev, PM_DEVICE_ACTION_RESUME);),                   \
                                 (const struct ksbb_config *config = dev->config;                   \
-                                 kscan_config(config->kscan, &ksbb_inner_kscan_callback);          \
+                                 kscan_config(config->kscan, config->inner_callback);              \
                                  kscan_enable_callback(config->kscan);))                           \
                     return 0;                                                                      \
                 } SYS_INIT(ksbb_auto_enable_##n, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);), \
                 ())                                                                                \
     static struct ksbb_entry entries_##n[] = {                                                     \
         DT_INST_FOREACH_CHILD_STATUS_OKAY_SEP(n, ENTRY, (, ))};                                    \
+    BUILD_ASSERT(ARRAY_SIZE(entries_##n) < UINT8_MAX, "Too many sideband behaviors");              \
+    BUILD_ASSERT(KSBB_ROWS(n) <= UINT8_MAX && KSBB_COLUMNS(n) <= UINT8_MAX,                        \
+                 "Sideband behavior row or column out of range");                                  \
+    static uint8_t entry_lookup_##n[KSBB_ROWS(n) * KSBB_COLUMNS(n)];                               \
+    static void ksbb_inner_kscan_callback_##n(const struct device *dev, uint32_t row,              \
+                                              uint32_t column, bool pressed) {                     \
+        ksbb_inner_kscan_callback(DEVICE_DT_INST_GET(n), row, column, pressed);                    \
+    }                                                                                              \
     const struct ksbb_config ksbb_config_##n = {                                                   \
         .kscan = DEVICE_DT_GET(DT_INST_PHANDLE(n, kscan)),                                         \
+        .inner_callback = ksbb_inner_kscan_callback_##n,                                           \
         .auto_enable = DT_INST_PROP_OR(n, auto_enable, false),                                     \
         .entries = entries_##n,                                                                    \
         .entries_len = ARRAY_SIZE(entries_##n),                                                    \
+        .entry_lookup = entry_lookup_##n,                                                          \
+        .rows = KSBB_ROWS(n),                                                                      \
+        .columns = KSBB_COLUMNS(n),                                                                \
     };                                                                                             \
     struct ksbb_data ksbb_data_##n = {};                                                           \
     PM_DEVICE_DT_INST_DEFINE(n, ksbb_pm_action);                                                   \
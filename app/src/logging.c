@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
+
+#include <zmk/logging.h>
+
+int zmk_logging_set_level(const char *module, uint32_t level) {
+    uint32_t count = log_src_cnt_get(Z_LOG_LOCAL_DOMAIN_ID);
+    int changed = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        const char *name = log_source_name_get(Z_LOG_LOCAL_DOMAIN_ID, i);
+        if (name == NULL ||
+            (module ? strcmp(name, module) != 0 : strncmp(name, "zmk", strlen("zmk")) != 0)) {
+            continue;
+        }
+
+        log_filter_set(NULL, Z_LOG_LOCAL_DOMAIN_ID, i, level);
+        changed++;
+    }
+
+    return changed > 0 ? changed : -ENOENT;
+}
@@ -12,6 +12,8 @@
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+#include <zmk/settings.h>
+
 #if IS_ENABLED(CONFIG_ZMK_DISPLAY)
 
 #include <zmk/display.h>
@@ -24,7 +26,7 @@ int main(void) {
 
 #if IS_ENABLED(CONFIG_SETTINGS)
     settings_subsys_init();
-    settings_load();
+    zmk_settings_load();
 #endif
 
 #ifdef CONFIG_ZMK_DISPLAY
@@ -10,6 +10,7 @@
 #include <zephyr/pm/device_runtime.h>
 #include <zephyr/drivers/kscan.h>
 #include <zephyr/input/input.h>
+#include <zephyr/sys/atomic.h>
 
 #if IS_ENABLED(CONFIG_SETTINGS)
 #include <zephyr/settings/settings.h>
@@ -19,10 +20,17 @@
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+#include <zmk/context.h>
 #include <zmk/matrix.h>
 #include <zmk/physical_layouts.h>
+#include <zmk/settings.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/position_state_changed.h>
+#include <zmk/ipc_observer.h>
+#include <zmk/profiling.h>
+#include <zmk/stage_timing.h>
+#include <zmk/work_stats.h>
+#include <zmk/workqueue.h>
 
 ZMK_EVENT_IMPL(zmk_physical_layout_selection_changed);
 
@@ -200,19 +208,165 @@ size_t zmk_physical_layouts_get_list(struct zmk_physical_layout const *const **d
 
 #define ZMK_KSCAN_EVENT_STATE_PRESSED 0
 #define ZMK_KSCAN_EVENT_STATE_RELEASED 1
+// events queued with zmk_physical_layouts_kscan_position_changed(), whose row holds the position
+#define ZMK_KSCAN_EVENT_STATE_POSITION_PRESSED 2
+#define ZMK_KSCAN_EVENT_STATE_POSITION_RELEASED 3
 
 struct zmk_kscan_event {
     uint32_t row;
     uint32_t column;
     uint32_t state;
+    uint8_t context;
+    // uptime when the key changed, taken as the event is queued rather than when it's processed
+    int64_t timestamp;
+#if IS_ENABLED(CONFIG_ZMK_STAGE_TIMING)
+    // cycle count when the event was queued
+    uint32_t queued_cycles;
+#endif
 };
 
 static struct zmk_kscan_msg_processor {
     struct k_work work;
 } msg_processor;
 
-K_MSGQ_DEFINE(physical_layouts_kscan_msgq, sizeof(struct zmk_kscan_event),
-              CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE, 4);
+// Ring of kscan events waiting for the work item, which reads them without taking a lock. One
+// slot is always left free to tell a full ring from an empty one. Producers are serialized by a
+// spinlock, since injected events (e.g. from the IPC observer) can come from another thread than
+// the active kscan device.
+#define KSCAN_EVENT_RING_SLOTS (CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE + 1)
+
+static struct zmk_kscan_event kscan_event_ring[KSCAN_EVENT_RING_SLOTS];
+// next slot to write, only advanced by producers
+static atomic_t kscan_event_ring_head;
+// next slot to read, only advanced by the work item
+static atomic_t kscan_event_ring_tail;
+static struct k_spinlock kscan_event_ring_lock;
+static atomic_t kscan_events_dropped;
+static atomic_t kscan_events_taken;
+
+ZMK_WORK_STATS_DEFINE(kscan, KSCAN_EVENT_RING_SLOTS - 1);
+
+// given by the work item when it frees up a slot in a full ring
+static K_SEM_DEFINE(kscan_event_ring_space, 0, 1);
+
+static atomic_val_t kscan_event_ring_next(atomic_val_t slot) {
+    return (slot + 1) % KSCAN_EVENT_RING_SLOTS;
+}
+
+static bool kscan_event_ring_full(void) {
+    return kscan_event_ring_next(atomic_get(&kscan_event_ring_head)) ==
+           atomic_get(&kscan_event_ring_tail);
+}
+
+static int kscan_event_ring_put(const struct zmk_kscan_event *ev) {
+    k_spinlock_key_t key = k_spin_lock(&kscan_event_ring_lock);
+    atomic_val_t head = atomic_get(&kscan_event_ring_head);
+    atomic_val_t next = kscan_event_ring_next(head);
+
+    if (next == atomic_get(&kscan_event_ring_tail)) {
+        k_spin_unlock(&kscan_event_ring_lock, key);
+        LOG_WRN("Kscan event queue full, %ld events dropped so far",
+                atomic_inc(&kscan_events_dropped) + 1);
+        return -ENOSPC;
+    }
+
+    kscan_event_ring[head] = *ev;
+#if IS_ENABLED(CONFIG_ZMK_STAGE_TIMING)
+    kscan_event_ring[head].queued_cycles = zmk_stage_timing_start();
+#endif
+    atomic_set(&kscan_event_ring_head, next);
+
+    // The work item keeps going until it finds the ring empty, so it only needs submitting if it
+    // had already taken every earlier event. Checking after publishing the event means it either
+    // sees the event or is submitted again.
+    atomic_val_t tail = atomic_get(&kscan_event_ring_tail);
+    bool was_empty = tail == head;
+    k_spin_unlock(&kscan_event_ring_lock, key);
+
+    zmk_work_stats_queue_depth(ZMK_WORK_STATS(kscan),
+                               (next - tail + KSCAN_EVENT_RING_SLOTS) % KSCAN_EVENT_RING_SLOTS);
+    if (was_empty) {
+        zmk_work_stats_submit(ZMK_WORK_STATS(kscan), 0);
+        k_work_submit_to_queue(zmk_workqueue_input_work_q(), &msg_processor.work);
+    }
+
+    return 0;
+}
+
+static bool kscan_event_ring_get(struct zmk_kscan_event *ev) {
+    atomic_val_t tail = atomic_get(&kscan_event_ring_tail);
+    atomic_val_t head = atomic_get(&kscan_event_ring_head);
+
+    if (tail == head) {
+        return false;
+    }
+
+    bool was_full = kscan_event_ring_next(head) == tail;
+    *ev = kscan_event_ring[tail];
+    atomic_set(&kscan_event_ring_tail, kscan_event_ring_next(tail));
+    atomic_inc(&kscan_events_taken);
+
+    if (was_full) {
+        k_sem_give(&kscan_event_ring_space);
+    }
+
+    return true;
+}
+
+bool zmk_physical_layouts_kscan_pending(void) {
+    return atomic_get(&kscan_event_ring_tail) != atomic_get(&kscan_event_ring_head);
+}
+
+int zmk_physical_layouts_kscan_wait_for_space(k_timeout_t timeout) {
+    while (kscan_event_ring_full()) {
+        if (k_sem_take(&kscan_event_ring_space, timeout) < 0) {
+            return -EAGAIN;
+        }
+    }
+
+    return 0;
+}
+
+int zmk_physical_layouts_kscan_position_changed(uint32_t position, bool pressed,
+                                               int64_t timestamp) {
+    if (position >= ZMK_KEYMAP_LEN) {
+        return -EINVAL;
+    }
+
+    struct zmk_kscan_event ev = {
+        .row = position,
+        .state = (pressed ? ZMK_KSCAN_EVENT_STATE_POSITION_PRESSED
+                          : ZMK_KSCAN_EVENT_STATE_POSITION_RELEASED),
+        .timestamp = timestamp,
+    };
+
+    return kscan_event_ring_put(&ev);
+}
+
+int zmk_physical_layouts_kscan_context_changed(uint8_t context, uint32_t row, uint32_t column,
+                                              bool pressed) {
+    if (context >= ZMK_CONTEXT_COUNT) {
+        return -EINVAL;
+    }
+
+    struct zmk_kscan_event ev = {
+        .row = row,
+        .column = column,
+        .state = (pressed ? ZMK_KSCAN_EVENT_STATE_PRESSED : ZMK_KSCAN_EVENT_STATE_RELEASED),
+        .context = context,
+        .timestamp = k_uptime_get(),
+    };
+
+    return kscan_event_ring_put(&ev);
+}
+
+uint32_t zmk_physical_layouts_kscan_dropped_events(void) {
+    return (uint32_t)atomic_get(&kscan_events_dropped);
+}
+
+uint32_t zmk_physical_layouts_kscan_taken_events(void) {
+    return (uint32_t)atomic_get(&kscan_events_taken);
+}
 
 #if MATRIX_INPUT_SUPPORT
 
@@ -256,8 +410,8 @@ static void zmk_physical_layout_input_event_cb(struct input_event *evt, void *us
     }
 
     if (evt->sync) {
-        k_msgq_put(&physical_layouts_kscan_msgq, &pending_input_event, K_NO_WAIT);
-        k_work_submit(&msg_processor.work);
+        pending_input_event.timestamp = k_uptime_get();
+        kscan_event_ring_put(&pending_input_event);
     }
 }
 
@@ -272,16 +426,46 @@ static void zmk_physical_layout_kscan_callback(const struct device *dev, uint32_
     struct zmk_kscan_event ev = {
         .row = row,
         .column = column,
-        .state = (pressed ? ZMK_KSCAN_EVENT_STATE_PRESSED : ZMK_KSCAN_EVENT_STATE_RELEASED)};
+        .state = (pressed ? ZMK_KSCAN_EVENT_STATE_PRESSED : ZMK_KSCAN_EVENT_STATE_RELEASED),
+        .timestamp = k_uptime_get()};
 
-    k_msgq_put(&physical_layouts_kscan_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&msg_processor.work);
+    kscan_event_ring_put(&ev);
 }
 
 static void zmk_physical_layouts_kscan_process_msgq(struct k_work *item) {
+    uint32_t run_start = zmk_work_stats_run_start(ZMK_WORK_STATS(kscan));
+    uint8_t context = zmk_context_index();
     struct zmk_kscan_event ev;
 
-    while (k_msgq_get(&physical_layouts_kscan_msgq, &ev, K_NO_WAIT) == 0) {
+    while (kscan_event_ring_get(&ev)) {
+#if IS_ENABLED(CONFIG_ZMK_STAGE_TIMING)
+        zmk_stage_timing_end(ZMK_STAGE_KSCAN_QUEUE, ev.queued_cycles);
+#endif
+        uint32_t dispatch_start;
+
+        // Each event is raised in the context of its keyboard, so the state and reports of
+        // that keyboard are the ones it changes.
+        zmk_context_select(ev.context);
+
+        if (ev.state == ZMK_KSCAN_EVENT_STATE_POSITION_PRESSED ||
+            ev.state == ZMK_KSCAN_EVENT_STATE_POSITION_RELEASED) {
+            bool pressed = (ev.state == ZMK_KSCAN_EVENT_STATE_POSITION_PRESSED);
+
+            LOG_DBG("Position: %d, pressed: %s", ev.row, (pressed ? "true" : "false"));
+            zmk_ipc_observer_trace_raise(ev.row);
+            ZMK_PROFILING_MARK2(keystroke_start, ev.row, pressed);
+            dispatch_start = zmk_stage_timing_start();
+            raise_zmk_position_state_changed((struct zmk_position_state_changed){
+                .source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL,
+                .context = ev.context,
+                .state = pressed,
+                .position = ev.row,
+                .timestamp = ev.timestamp});
+            zmk_stage_timing_end(ZMK_STAGE_POSITION_DISPATCH, dispatch_start);
+            ZMK_PROFILING_MARK2(keystroke_end, ev.row, pressed);
+            continue;
+        }
+
         bool pressed = (ev.state == ZMK_KSCAN_EVENT_STATE_PRESSED);
         int32_t position = zmk_matrix_transform_row_column_to_position(active->matrix_transform,
                                                                        ev.row, ev.column);
@@ -294,12 +478,21 @@ static void zmk_physical_layouts_kscan_process_msgq(struct k_work *item) {
 
         LOG_DBG("Row: %d, col: %d, position: %d, pressed: %s", ev.row, ev.column, position,
                 (pressed ? "true" : "false"));
+        zmk_ipc_observer_trace_raise(position);
+        ZMK_PROFILING_MARK2(keystroke_start, position, pressed);
+        dispatch_start = zmk_stage_timing_start();
         raise_zmk_position_state_changed(
             (struct zmk_position_state_changed){.source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL,
+                                                .context = ev.context,
                                                 .state = pressed,
                                                 .position = position,
-                                                .timestamp = k_uptime_get()});
+                                                .timestamp = ev.timestamp});
+        zmk_stage_timing_end(ZMK_STAGE_POSITION_DISPATCH, dispatch_start);
+        ZMK_PROFILING_MARK2(keystroke_end, position, pressed);
     }
+
+    zmk_context_select(context);
+    zmk_work_stats_run_end(ZMK_WORK_STATS(kscan), run_start);
 }
 
 static const struct zmk_physical_layout *get_default_layout(void) {
@@ -431,7 +624,7 @@ int zmk_physical_layouts_save_selected(void) {
 #if IS_ENABLED(CONFIG_SETTINGS)
     uint8_t val = (uint8_t)zmk_physical_layouts_get_selected();
 
-    return settings_save_one("physical_layouts/selected", &val, sizeof(val));
+    return zmk_settings_save("physical_layouts/selected", &val, sizeof(val));
 #else
     return -ENOTSUP;
 #endif
@@ -439,20 +632,8 @@ int zmk_physical_layouts_save_selected(void) {
 
 int zmk_physical_layouts_revert_selected(void) { return zmk_physical_layouts_select_initial(); }
 
-int zmk_physical_layouts_get_position_map(uint8_t source, uint8_t dest, size_t map_size,
-                                          uint32_t map[map_size]) {
-    if (source >= ARRAY_SIZE(layouts) || dest >= ARRAY_SIZE(layouts)) {
-        return -EINVAL;
-    }
-
-    if (source == dest) {
-        for (int i = 0; i < map_size; i++) {
-            map[i] = i;
-        }
-
-        return 0;
-    }
-
+static int build_position_map(uint8_t source, uint8_t dest, size_t map_size,
+                              uint32_t map[map_size]) {
     const struct zmk_physical_layout *src_layout = layouts[source];
     const struct zmk_physical_layout *dest_layout = layouts[dest];
     int max_kp = dest_layout->keys_len;
@@ -485,42 +666,121 @@ int zmk_physical_layouts_get_position_map(uint8_t source, uint8_t dest, size_t m
         return -EINVAL;
     }
 
-    memset(map, UINT32_MAX, map_size);
-
-    for (int b = 0; b < max_kp; b++) {
-        bool found = false;
+    for (int b = 0; b < map_size; b++) {
+        map[b] = UINT32_MAX;
+    }
 
 #if HAVE_POS_MAP
-        if (src_pos_map && dest_pos_map) {
-            for (int m = 0; m < ZMK_POS_MAP_LEN; m++) {
-                if (dest_pos_map->positions[m] == b) {
-                    map[b] = src_pos_map->positions[m];
-                    found = true;
-                    break;
-                }
+    // One pass over the position map, keeping the first entry for each destination position.
+    if (src_pos_map && dest_pos_map) {
+        for (int m = 0; m < ZMK_POS_MAP_LEN; m++) {
+            uint32_t b = dest_pos_map->positions[m];
+            if (map[b] == UINT32_MAX) {
+                map[b] = src_pos_map->positions[m];
             }
         }
+    }
 #endif
 
 #if !POS_MAP_COMPLETE
-        if (!found) {
-            const struct zmk_key_physical_attrs *key = &dest_layout->keys[b];
-            for (int old_b = 0; old_b < src_layout->keys_len; old_b++) {
-                const struct zmk_key_physical_attrs *candidate_key = &src_layout->keys[old_b];
-
-                if (candidate_key->x == key->x && candidate_key->y == key->y) {
-                    map[b] = old_b;
-                    found = true;
-                    break;
-                }
+    for (int b = 0; b < MIN(max_kp, dest_layout->keys_len); b++) {
+        if (map[b] != UINT32_MAX) {
+            continue;
+        }
+
+        const struct zmk_key_physical_attrs *key = &dest_layout->keys[b];
+        for (int old_b = 0; old_b < src_layout->keys_len; old_b++) {
+            const struct zmk_key_physical_attrs *candidate_key = &src_layout->keys[old_b];
+
+            if (candidate_key->x == key->x && candidate_key->y == key->y) {
+                map[b] = old_b;
+                break;
             }
         }
-#endif
     }
+#endif
 
     return max_kp;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_PHYSICAL_LAYOUT_POSITION_MAP_CACHE)
+
+#define POSITION_MAP_UNMAPPED UINT16_MAX
+
+// Maps between each pair of layouts, built the first time they are needed.
+struct position_map_cache_entry {
+    bool built;
+    uint16_t len;
+    uint16_t positions[ZMK_KEYMAP_LEN];
+};
+
+static struct position_map_cache_entry position_map_cache[ARRAY_SIZE(layouts)][ARRAY_SIZE(layouts)];
+
+static K_MUTEX_DEFINE(position_map_cache_mutex);
+
+static int get_cached_position_map(uint8_t source, uint8_t dest, size_t map_size,
+                                   uint32_t map[map_size]) {
+    struct position_map_cache_entry *entry = &position_map_cache[source][dest];
+
+    k_mutex_lock(&position_map_cache_mutex, K_FOREVER);
+
+    if (!entry->built) {
+        int ret = build_position_map(source, dest, map_size, map);
+        if (ret < 0 || ret > ARRAY_SIZE(entry->positions)) {
+            // Maps that don't fit are built again each time.
+            k_mutex_unlock(&position_map_cache_mutex);
+            return ret;
+        }
+
+        for (int b = 0; b < ret; b++) {
+            entry->positions[b] = map[b] < POSITION_MAP_UNMAPPED ? map[b] : POSITION_MAP_UNMAPPED;
+        }
+
+        entry->len = ret;
+        entry->built = true;
+
+        k_mutex_unlock(&position_map_cache_mutex);
+        return ret;
+    }
+
+    k_mutex_unlock(&position_map_cache_mutex);
+
+    if (map_size < entry->len) {
+        return -EINVAL;
+    }
+
+    for (int b = 0; b < map_size; b++) {
+        map[b] = b < entry->len && entry->positions[b] != POSITION_MAP_UNMAPPED
+                     ? entry->positions[b]
+                     : UINT32_MAX;
+    }
+
+    return entry->len;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_PHYSICAL_LAYOUT_POSITION_MAP_CACHE)
+
+int zmk_physical_layouts_get_position_map(uint8_t source, uint8_t dest, size_t map_size,
+                                          uint32_t map[map_size]) {
+    if (source >= ARRAY_SIZE(layouts) || dest >= ARRAY_SIZE(layouts)) {
+        return -EINVAL;
+    }
+
+    if (source == dest) {
+        for (int i = 0; i < map_size; i++) {
+            map[i] = i;
+        }
+
+        return 0;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_PHYSICAL_LAYOUT_POSITION_MAP_CACHE)
+    return get_cached_position_map(source, dest, map_size, map);
+#else
+    return build_position_map(source, dest, map_size, map);
+#endif
+}
+
 #if IS_ENABLED(CONFIG_SETTINGS)
 
 static int physical_layouts_handle_set(const char *name, size_t len, settings_read_cb read_cb,
@@ -567,7 +827,12 @@ static int zmk_physical_layouts_init(void) {
         selected_to_stock_map[i] = i;
     }
 
-    return zmk_physical_layouts_select_initial();
+    int ret = zmk_physical_layouts_select_initial();
+    if (ret >= 0) {
+        LOG_INF("Key scan enabled %lld ms after boot", k_uptime_get());
+    }
+
+    return ret;
 }
 
 SYS_INIT(zmk_physical_layouts_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -16,6 +16,7 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/endpoints.h>
+#include <zmk/settings.h>
 
 // Reimplement some of the device work from Zephyr PM to work with the new `sys_poweroff` API.
 // TODO: Tweak this to smarter runtime PM of subsystems on sleep.
@@ -27,38 +28,92 @@ TYPE_SECTION_START_EXTERN(const struct device *, pm_device_slots);
 /* Number of devices successfully suspended. */
 static size_t zmk_num_susp;
 
-int zmk_pm_suspend_devices(void) {
+/*
+ * Devices with PM support, in suspend order. They are found on the first suspend, so later ones
+ * don't walk every static device again. Whether each is ready is still checked on every suspend,
+ * since a device that is not yet ready then may be later. If there are more than fit, every
+ * suspend walks all devices instead.
+ */
+static const struct device *pm_candidates[CONFIG_ZMK_PM_DEVICE_CACHE_SIZE];
+static size_t pm_candidate_count;
+static bool pm_candidates_built;
+static bool pm_candidates_valid;
+
+static void pm_candidates_build(void) {
     const struct device *devs;
-    size_t devc;
+    size_t devc = z_device_get_all_static(&devs);
+    enum pm_device_state state;
 
-    devc = z_device_get_all_static(&devs);
-
-    zmk_num_susp = 0;
+    pm_candidates_built = true;
+    pm_candidates_valid = false;
+    pm_candidate_count = 0;
 
     for (const struct device *dev = devs + devc - 1; dev >= devs; dev--) {
-        int ret;
-
-        /*
-         * Ignore uninitialized devices, busy devices, wake up sources, and
-         * devices with runtime PM enabled.
-         */
-        if (!device_is_ready(dev) || pm_device_is_busy(dev) || pm_device_wakeup_is_enabled(dev) ||
-            pm_device_runtime_is_enabled(dev)) {
+        if (pm_device_state_get(dev, &state) == -ENOSYS) {
             continue;
         }
 
-        ret = pm_device_action_run(dev, PM_DEVICE_ACTION_SUSPEND);
-        /* ignore devices not supporting or already at the given state */
-        if ((ret == -ENOSYS) || (ret == -ENOTSUP) || (ret == -EALREADY)) {
-            continue;
-        } else if (ret < 0) {
-            LOG_ERR("Device %s did not enter %s state (%d)", dev->name,
-                    pm_device_state_str(PM_DEVICE_STATE_SUSPENDED), ret);
-            return ret;
+        if (pm_candidate_count == ARRAY_SIZE(pm_candidates)) {
+            LOG_WRN("More than %zu devices support PM, not caching them", pm_candidate_count);
+            return;
+        }
+
+        pm_candidates[pm_candidate_count++] = dev;
+    }
+
+    pm_candidates_valid = true;
+}
+
+static int suspend_device(const struct device *dev) {
+    /*
+     * Ignore uninitialized devices, busy devices, wake up sources, and
+     * devices with runtime PM enabled.
+     */
+    if (!device_is_ready(dev) || pm_device_is_busy(dev) || pm_device_wakeup_is_enabled(dev) ||
+        pm_device_runtime_is_enabled(dev)) {
+        return 0;
+    }
+
+    int ret = pm_device_action_run(dev, PM_DEVICE_ACTION_SUSPEND);
+    /* ignore devices not supporting or already at the given state */
+    if ((ret == -ENOSYS) || (ret == -ENOTSUP) || (ret == -EALREADY)) {
+        return 0;
+    } else if (ret < 0) {
+        LOG_ERR("Device %s did not enter %s state (%d)", dev->name,
+                pm_device_state_str(PM_DEVICE_STATE_SUSPENDED), ret);
+        return ret;
+    }
+
+    TYPE_SECTION_START(pm_device_slots)[zmk_num_susp] = dev;
+    zmk_num_susp++;
+    return 0;
+}
+
+int zmk_pm_suspend_devices(void) {
+    zmk_num_susp = 0;
+
+    if (!pm_candidates_built) {
+        pm_candidates_build();
+    }
+
+    if (pm_candidates_valid) {
+        for (size_t i = 0; i < pm_candidate_count; i++) {
+            int ret = suspend_device(pm_candidates[i]);
+            if (ret < 0) {
+                return ret;
+            }
         }
+        return 0;
+    }
+
+    const struct device *devs;
+    size_t devc = z_device_get_all_static(&devs);
 
-        TYPE_SECTION_START(pm_device_slots)[zmk_num_susp] = dev;
-        zmk_num_susp++;
+    for (const struct device *dev = devs + devc - 1; dev >= devs; dev--) {
+        int ret = suspend_device(dev);
+        if (ret < 0) {
+            return ret;
+        }
     }
 
     return 0;
@@ -88,6 +143,11 @@ const struct device *soft_off_wakeup_sources[] = {
 #endif
 
 int zmk_pm_soft_off(void) {
+#if IS_ENABLED(CONFIG_SETTINGS)
+    // Settings still waiting to be written would be lost when powering off.
+    zmk_settings_flush();
+#endif
+
 #if IS_ENABLED(CONFIG_PM_DEVICE)
     size_t device_count;
     const struct device *devs;
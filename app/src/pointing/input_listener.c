@@ -8,6 +8,7 @@
 
 #include <zephyr/sys/util_macro.h>
 #include <zephyr/device.h>
+#include <zephyr/init.h>
 #include <zephyr/kernel.h>
 #include <zephyr/input/input.h>
 #include <zephyr/logging/log.h>
@@ -16,6 +17,9 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zephyr/dt-bindings/input/input-event-codes.h>
 
+#include <stdlib.h>
+#include <string.h>
+
 #include <zmk/endpoints.h>
 #include <drivers/input_processor.h>
 #include <zmk/pointing.h>
@@ -24,6 +28,8 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/pointing/resolution_multipliers.h>
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 
+#include <zmk/event_manager.h>
+#include <zmk/events/layer_state_changed.h>
 #include <zmk/hid.h>
 #include <zmk/keymap.h>
 
@@ -65,9 +71,61 @@ struct input_processor_remainder_data {
     int16_t x, y, wheel, h_wheel;
 };
 
+#if IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_FUSE_PROCESSORS) ||                                      \
+    IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_BATCH_FRAMES)
+
+// The relative codes the listener turns into mouse reports, which are fused and batched
+static const uint16_t rel_codes[] = {INPUT_REL_X, INPUT_REL_Y, INPUT_REL_WHEEL, INPUT_REL_HWHEEL};
+
+#define REL_CODES_LEN ARRAY_SIZE(rel_codes)
+
+static int rel_code_index(uint16_t code) {
+    for (int i = 0; i < REL_CODES_LEN; i++) {
+        if (rel_codes[i] == code) {
+            return i;
+        }
+    }
+
+    return -ENOENT;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_FUSE_PROCESSORS) ||
+       // IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_BATCH_FRAMES)
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_FUSE_PROCESSORS)
+
+struct input_listener_fused_code {
+    uint16_t code;
+    int16_t mul;
+    int16_t div;
+    int16_t remainder;
+    // Scaled by one of the processors, which works on 16 bit values
+    bool narrow;
+};
+
+// Consecutive processors, applied as one where possible. Events that aren't one of the fused
+// codes still go through each processor in turn.
+struct input_listener_processor_step {
+    uint8_t start;
+    uint8_t len;
+    uint8_t remainder_start;
+    bool fused;
+    bool track_remainders;
+    struct input_listener_fused_code codes[REL_CODES_LEN];
+};
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_FUSE_PROCESSORS)
+
 struct input_listener_processor_data {
+    // Times the processors are applied to each event in the current layer state. Resolved whenever
+    // the layer state changes, rather than for every event.
+    uint8_t runs;
     size_t remainders_len;
     struct input_processor_remainder_data *remainders;
+#if IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_FUSE_PROCESSORS)
+    size_t steps_len;
+    struct input_listener_processor_step *steps;
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_FUSE_PROCESSORS)
 };
 
 struct input_listener_config {
@@ -93,6 +151,16 @@ struct input_listener_data {
     int16_t h_wheel_remainder;
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 
+#if IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_BATCH_FRAMES)
+    // Relative values received in the current frame, before any processor, and which codes of
+    // rel_codes they were received for
+    int32_t frame_values[REL_CODES_LEN];
+    uint8_t frame_codes;
+    // Ends a frame the device never syncs
+    struct k_work_delayable frame_timeout_work;
+    const struct device *frame_dev;
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_BATCH_FRAMES)
+
     struct input_listener_processor_data base_processor_data;
     struct input_listener_processor_data layer_override_data[];
 };
@@ -161,11 +229,10 @@ static inline bool is_y_data(const struct input_event *evt) {
     return evt->type == INPUT_EV_REL && evt->code == INPUT_REL_Y;
 }
 
-static int apply_config(uint8_t listener_index, const struct input_listener_config_entry *cfg,
-                        struct input_listener_processor_data *processor_data,
-                        struct input_listener_data *data, struct input_event *evt) {
-    size_t remainder_index = 0;
-    for (size_t p = 0; p < cfg->processors_len; p++) {
+static int apply_processors(uint8_t listener_index, const struct input_listener_config_entry *cfg,
+                            struct input_listener_processor_data *processor_data, size_t start,
+                            size_t end, size_t remainder_index, struct input_event *evt) {
+    for (size_t p = start; p < end; p++) {
         const struct zmk_input_processor_entry *proc_e = &cfg->processors[p];
         struct input_processor_remainder_data *remainders = NULL;
         if (proc_e->track_remainders) {
@@ -209,33 +276,222 @@ static int apply_config(uint8_t listener_index, const struct input_listener_conf
     return ZMK_INPUT_PROC_CONTINUE;
 }
 
-static int filter_with_input_config(const struct input_listener_config *cfg,
-                                    struct input_listener_data *data, struct input_event *evt) {
-    if (!evt->dev) {
-        return -ENODEV;
+#if IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_FUSE_PROCESSORS)
+
+// Returns false for events the step doesn't cover. The value is scaled with a single division,
+// carrying one remainder per code if any of the processors tracks them. Scaled codes are cut to
+// 16 bits like the scaler cuts them; since only the first scaler that divides is folded into a
+// step, that gives the same value as cutting after each processor.
+static bool apply_fused_step(struct input_listener_processor_step *step, struct input_event *evt) {
+    int idx = evt->type == INPUT_EV_REL ? rel_code_index(evt->code) : -ENOENT;
+    if (idx < 0) {
+        return false;
+    }
+
+    struct input_listener_fused_code *fused = &step->codes[idx];
+    int32_t value = evt->value * fused->mul;
+    if (step->track_remainders) {
+        value += fused->remainder;
+    }
+    if (fused->narrow) {
+        value = (int16_t)value;
+    }
+
+    int32_t scaled = value / fused->div;
+    if (step->track_remainders) {
+        fused->remainder = value - scaled * fused->div;
+    }
+
+    evt->code = fused->code;
+    evt->value = scaled;
+    return true;
+}
+
+// Keeps the multipliers within what the processors themselves take. They aren't reduced, so a
+// product that wraps in 16 bits wraps the same way it does through each processor.
+static bool reduce_linear_map(struct zmk_input_processor_linear_map *map) {
+    if (map->div == 0) {
+        return false;
+    }
+
+    if (map->div < 0) {
+        map->mul = -map->mul;
+        map->div = -map->div;
+    }
+
+    return abs(map->mul) <= INT16_MAX && map->div <= INT16_MAX;
+}
+
+static bool divides(const struct zmk_input_processor_linear_map *maps) {
+    for (int i = 0; i < REL_CODES_LEN; i++) {
+        if (maps[i].div > 1) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool scales(const struct zmk_input_processor_linear_map *maps,
+                   const struct zmk_input_processor_linear_map *next) {
+    for (int i = 0; i < REL_CODES_LEN; i++) {
+        if (abs(next[i].mul) != abs(maps[i].mul) || next[i].div != maps[i].div) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Folds as many linear processors from start as possible into the step, returning how many
+static size_t fuse_processors(const struct input_listener_config_entry *cfg, size_t start,
+                              struct input_listener_processor_step *step) {
+    struct zmk_input_processor_linear_map maps[REL_CODES_LEN];
+    bool narrow[REL_CODES_LEN] = {false};
+    for (int i = 0; i < REL_CODES_LEN; i++) {
+        maps[i] = (struct zmk_input_processor_linear_map){
+            .type = INPUT_EV_REL, .code = rel_codes[i], .mul = 1, .div = 1};
+    }
+
+    size_t p = start;
+    for (; p < cfg->processors_len; p++) {
+        const struct zmk_input_processor_entry *proc_e = &cfg->processors[p];
+        struct zmk_input_processor_linear_map next[REL_CODES_LEN];
+        bool linear = true;
+
+        for (int i = 0; linear && i < REL_CODES_LEN; i++) {
+            next[i] = maps[i];
+            linear = zmk_input_processor_map_linear(proc_e->dev, proc_e->param1, proc_e->param2,
+                                                    &next[i]) == 0 &&
+                     reduce_linear_map(&next[i]);
+        }
+
+        // Scaling a value that was already divided would round it once rather than twice, so
+        // once a step divides, only processors that rename or negate codes are folded into it.
+        // The remainders are then only those of the processor that divides.
+        if (!linear || (divides(maps) && scales(maps, next))) {
+            break;
+        }
+
+        if (!divides(maps) && divides(next)) {
+            step->track_remainders = proc_e->track_remainders;
+        }
+
+        for (int i = 0; i < REL_CODES_LEN; i++) {
+            narrow[i] |= abs(next[i].mul) != abs(maps[i].mul) || next[i].div != maps[i].div;
+        }
+
+        memcpy(maps, next, sizeof(maps));
+    }
+
+    for (int i = 0; i < REL_CODES_LEN; i++) {
+        step->codes[i] = (struct input_listener_fused_code){
+            .code = maps[i].code, .mul = maps[i].mul, .div = maps[i].div, .narrow = narrow[i]};
+    }
+
+    return p - start;
+}
+
+static void build_processor_steps(const struct input_listener_config_entry *cfg,
+                                  struct input_listener_processor_data *processor_data) {
+    size_t remainder_index = 0;
+    size_t steps_len = 0;
+
+    for (size_t p = 0; p < cfg->processors_len;) {
+        struct input_listener_processor_step *step = &processor_data->steps[steps_len++];
+        *step = (struct input_listener_processor_step){.start = p,
+                                                       .remainder_start = remainder_index};
+
+        size_t len = fuse_processors(cfg, p, step);
+        step->fused = len > 0;
+        step->len = MAX(len, 1);
+
+        for (size_t i = p; i < p + step->len; i++) {
+            remainder_index += cfg->processors[i].track_remainders ? 1 : 0;
+        }
+
+        p += step->len;
     }
 
+    processor_data->steps_len = steps_len;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_FUSE_PROCESSORS)
+
+static int apply_config(uint8_t listener_index, const struct input_listener_config_entry *cfg,
+                        struct input_listener_processor_data *processor_data,
+                        struct input_listener_data *data, struct input_event *evt) {
+#if IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_FUSE_PROCESSORS)
+    // Steps are built at boot, so anything earlier goes through each processor
+    if (processor_data->steps_len > 0) {
+        for (size_t s = 0; s < processor_data->steps_len; s++) {
+            struct input_listener_processor_step *step = &processor_data->steps[s];
+            if (step->fused && apply_fused_step(step, evt)) {
+                continue;
+            }
+
+            int ret = apply_processors(listener_index, cfg, processor_data, step->start,
+                                       step->start + step->len, step->remainder_start, evt);
+            if (ret != ZMK_INPUT_PROC_CONTINUE) {
+                return ret;
+            }
+        }
+
+        return ZMK_INPUT_PROC_CONTINUE;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_FUSE_PROCESSORS)
+
+    return apply_processors(listener_index, cfg, processor_data, 0, cfg->processors_len, 0, evt);
+}
+
+// An override is applied once for each of its layers that's active, until one that doesn't
+// process the next is, which also skips the base processors.
+static void resolve_layer_overrides(const struct input_listener_config *cfg,
+                                    struct input_listener_data *data) {
+    bool process_next = true;
+
     for (size_t oi = 0; oi < cfg->layer_overrides_len; oi++) {
         const struct input_listener_layer_override *override = &cfg->layer_overrides[oi];
-        struct input_listener_processor_data *override_data = &data->layer_override_data[oi];
         uint32_t mask = override->layer_mask;
         uint8_t layer = 0;
-        while (mask != 0) {
-            if (mask & BIT(0) && zmk_keymap_layer_active(layer)) {
-                int ret =
-                    apply_config(cfg->listener_index, &override->config, override_data, data, evt);
+        uint8_t runs = 0;
 
-                if (ret < 0) {
-                    return ret;
-                }
-                if (!override->process_next) {
-                    return 0;
-                }
+        while (process_next && mask != 0) {
+            if (mask & BIT(0) && zmk_keymap_layer_active(layer)) {
+                runs++;
+                process_next = override->process_next;
             }
 
             layer++;
             mask = mask >> 1;
         }
+
+        data->layer_override_data[oi].runs = runs;
+    }
+
+    data->base_processor_data.runs = process_next ? 1 : 0;
+}
+
+static int filter_with_input_config(const struct input_listener_config *cfg,
+                                    struct input_listener_data *data, struct input_event *evt) {
+    if (!evt->dev) {
+        return -ENODEV;
+    }
+
+    for (size_t oi = 0; oi < cfg->layer_overrides_len; oi++) {
+        struct input_listener_processor_data *override_data = &data->layer_override_data[oi];
+
+        for (uint8_t r = 0; r < override_data->runs; r++) {
+            int ret = apply_config(cfg->listener_index, &cfg->layer_overrides[oi].config,
+                                   override_data, data, evt);
+            if (ret < 0) {
+                return ret;
+            }
+        }
+    }
+
+    if (data->base_processor_data.runs == 0) {
+        return 0;
     }
 
     return apply_config(cfg->listener_index, &cfg->base, &data->base_processor_data, data, evt);
@@ -271,7 +527,7 @@ static void apply_resolution_scaling(struct input_listener_data *data, struct in
 }
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 
-static void input_handler(const struct input_listener_config *config,
+static void process_event(const struct input_listener_config *config,
                           struct input_listener_data *data, struct input_event *evt) {
     // First, process to update the event data as needed.
     int ret = filter_with_input_config(config, data, evt);
@@ -300,6 +556,8 @@ static void input_handler(const struct input_listener_config *config,
     }
 
     if (evt->sync) {
+        zmk_endpoint_mouse_report_lock();
+
         if (data->mouse.wheel_data.mode == INPUT_LISTENER_XY_DATA_MODE_REL) {
             zmk_hid_mouse_scroll_set(data->mouse.wheel_data.x.value,
                                      data->mouse.wheel_data.y.value);
@@ -329,6 +587,8 @@ static void input_handler(const struct input_listener_config *config,
         zmk_hid_mouse_scroll_set(0, 0);
         zmk_hid_mouse_movement_set(0, 0);
 
+        zmk_endpoint_mouse_report_unlock();
+
         clear_xy_data(&data->mouse.data);
         clear_xy_data(&data->mouse.wheel_data);
 
@@ -336,17 +596,122 @@ static void input_handler(const struct input_listener_config *config,
     }
 }
 
+#if IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_BATCH_FRAMES)
+
+// Returns false for events that aren't summed into the frame
+static bool batch_frame_event(struct input_listener_data *data, const struct input_event *evt) {
+    int idx = evt->type == INPUT_EV_REL ? rel_code_index(evt->code) : -ENOENT;
+    if (idx < 0) {
+        return false;
+    }
+
+    if (data->frame_codes == 0) {
+        data->frame_dev = evt->dev;
+        k_work_schedule(&data->frame_timeout_work,
+                        K_MSEC(CONFIG_ZMK_INPUT_LISTENER_BATCH_FRAMES_TIMEOUT_MS));
+    }
+
+    data->frame_values[idx] += evt->value;
+    data->frame_codes |= BIT(idx);
+    return true;
+}
+
+// Syncs the frame through the input subsystem rather than flushing it here, so it's still only
+// ever handled from the input thread. Other listeners of the device see an empty synced event.
+static void frame_timeout_work_cb(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct input_listener_data *data =
+        CONTAINER_OF(dwork, struct input_listener_data, frame_timeout_work);
+    uint8_t codes = data->frame_codes;
+
+    if (codes == 0) {
+        return;
+    }
+
+    LOG_DBG("Syncing a frame the device left open");
+    int ret = input_report(data->frame_dev, INPUT_EV_REL, rel_codes[__builtin_ctz(codes)], 0, true,
+                           K_NO_WAIT);
+    if (ret < 0) {
+        LOG_WRN("Failed to sync the open frame (%d)", ret);
+    }
+}
+
+// Runs the processors once for each code of the frame, with the sync on the last of them
+static void flush_frame(const struct input_listener_config *config,
+                        struct input_listener_data *data, const struct device *dev, bool sync) {
+    if (data->frame_codes == 0) {
+        return;
+    }
+
+    k_work_cancel_delayable(&data->frame_timeout_work);
+
+    for (int i = 0; i < REL_CODES_LEN; i++) {
+        if (!(data->frame_codes & BIT(i))) {
+            continue;
+        }
+
+        data->frame_codes &= ~BIT(i);
+
+        struct input_event evt = {
+            .dev = dev,
+            .sync = sync && data->frame_codes == 0,
+            .type = INPUT_EV_REL,
+            .code = rel_codes[i],
+            .value = data->frame_values[i],
+        };
+        data->frame_values[i] = 0;
+
+        process_event(config, data, &evt);
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_BATCH_FRAMES)
+
+static void input_handler(const struct input_listener_config *config,
+                          struct input_listener_data *data, struct input_event *evt) {
+#if IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_BATCH_FRAMES)
+    if (batch_frame_event(data, evt)) {
+        if (evt->sync) {
+            flush_frame(config, data, evt->dev, true);
+        }
+
+        return;
+    }
+
+    // Any other event comes after the motion received before it
+    flush_frame(config, data, evt->dev, false);
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_BATCH_FRAMES)
+
+    process_event(config, data, evt);
+}
+
 #endif // VALID_LISTENER_COUNT > 0
 
 #define ONE_FOR_TRACKED(n, elem, idx)                                                              \
     +DT_PROP(DT_PHANDLE_BY_IDX(n, input_processors, idx), track_remainders)
 #define PROCESSOR_REM_TRACKERS(n) (0 DT_FOREACH_PROP_ELEM(n, input_processors, ONE_FOR_TRACKED))
 
+#if IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_FUSE_PROCESSORS)
+
+#define SCOPED_PROCESSOR_STEPS(scope, n, id)                                                       \
+    static struct input_listener_processor_step _CONCAT(                                           \
+        input_processor_steps_##id, scope)[DT_PROP_LEN_OR(n, input_processors, 0)];
+
+#define IL_EXTRACT_STEPS(n, id, scope) .steps = _CONCAT(input_processor_steps_##id, scope),
+
+#else
+
+#define SCOPED_PROCESSOR_STEPS(scope, n, id)
+#define IL_EXTRACT_STEPS(n, id, scope)
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_FUSE_PROCESSORS)
+
 #define SCOPED_PROCESSOR(scope, n, id)                                                             \
     COND_CODE_1(DT_NODE_HAS_PROP(n, input_processors),                                             \
                 (static struct input_processor_remainder_data _CONCAT(                             \
                      input_processor_remainders_##id, scope)[PROCESSOR_REM_TRACKERS(n)] = {};),    \
                 ())                                                                                \
+    SCOPED_PROCESSOR_STEPS(scope, n, id)                                                           \
     static const struct zmk_input_processor_entry _CONCAT(                                         \
         processor_##id, scope)[DT_PROP_LEN_OR(n, input_processors, 0)] =                           \
         COND_CODE_1(DT_NODE_HAS_PROP(n, input_processors),                                         \
@@ -364,7 +729,7 @@ static void input_handler(const struct input_listener_config *config,
     {COND_CODE_1(DT_NODE_HAS_PROP(n, input_processors),                                            \
                  (.remainders_len = PROCESSOR_REM_TRACKERS(n),                                     \
                   .remainders = _CONCAT(input_processor_remainders_##id, scope), ),                \
-                 ())}
+                 ()) IL_EXTRACT_STEPS(n, id, scope)}
 
 #define IL_ONE(...) +1
 
@@ -406,3 +771,61 @@ static void input_handler(const struct input_listener_config *config,
         ())
 
 DT_INST_FOREACH_STATUS_OKAY(IL_INST)
+
+#if VALID_LISTENER_COUNT > 0
+
+struct input_listener_ref {
+    const struct input_listener_config *config;
+    struct input_listener_data *data;
+};
+
+#define IL_REF(n)                                                                                  \
+    COND_CODE_1(DT_NODE_HAS_STATUS(DT_INST_PHANDLE(n, device), okay),                              \
+                ({.config = &config_##n, .data = &data_##n}, ), ())
+
+static const struct input_listener_ref listeners[] = {DT_INST_FOREACH_STATUS_OKAY(IL_REF)};
+
+// Events handled while the layer state changes may see some overrides resolved for the old state
+// and some for the new one, as they would have by checking the layers as they went.
+static void resolve_all_layer_overrides(void) {
+    for (size_t i = 0; i < ARRAY_SIZE(listeners); i++) {
+        resolve_layer_overrides(listeners[i].config, listeners[i].data);
+    }
+}
+
+static int input_listener_layer_state_changed_listener(const zmk_event_t *eh) {
+    resolve_all_layer_overrides();
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(input_listener, input_listener_layer_state_changed_listener);
+ZMK_SUBSCRIPTION(input_listener, zmk_layer_state_changed);
+
+static int input_listener_init(void) {
+#if IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_BATCH_FRAMES)
+    for (size_t i = 0; i < ARRAY_SIZE(listeners); i++) {
+        k_work_init_delayable(&listeners[i].data->frame_timeout_work, frame_timeout_work_cb);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_BATCH_FRAMES)
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_FUSE_PROCESSORS)
+    for (size_t i = 0; i < ARRAY_SIZE(listeners); i++) {
+        const struct input_listener_config *config = listeners[i].config;
+        struct input_listener_data *data = listeners[i].data;
+
+        for (size_t oi = 0; oi < config->layer_overrides_len; oi++) {
+            build_processor_steps(&config->layer_overrides[oi].config,
+                                  &data->layer_override_data[oi]);
+        }
+
+        build_processor_steps(&config->base, &data->base_processor_data);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_FUSE_PROCESSORS)
+
+    resolve_all_layer_overrides();
+    return 0;
+}
+
+SYS_INIT(input_listener_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#endif // VALID_LISTENER_COUNT > 0
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_input_processor_acceleration
+
+#include <stdlib.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <drivers/input_processor.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define LUT_SIZE CONFIG_ZMK_INPUT_PROCESSOR_ACCELERATION_LUT_SIZE
+#define IDLE_RESET_MS CONFIG_ZMK_INPUT_PROCESSOR_ACCELERATION_IDLE_RESET_MS
+
+// Gains are in thousandths
+#define GAIN_UNIT 1000
+
+#define MAX_CODES 2
+
+struct accel_config {
+    uint8_t type;
+    size_t codes_len;
+    const uint16_t *codes;
+    size_t curve_len;
+    const uint32_t *curve;
+};
+
+struct accel_data {
+    // Gain at each multiple of velocity_step, computed from the curve at boot
+    uint16_t lut[LUT_SIZE];
+    uint32_t velocity_step;
+    // Gain for the current frame, looked up from the speed of the previous one
+    uint16_t gain;
+    int64_t frame_motion[MAX_CODES];
+    int64_t last_sync_ticks;
+};
+
+static int code_idx(const struct accel_config *cfg, uint16_t code) {
+    for (int i = 0; i < cfg->codes_len; i++) {
+        if (cfg->codes[i] == code) {
+            return i;
+        }
+    }
+
+    return -ENODEV;
+}
+
+static uint32_t curve_gain(const struct accel_config *cfg, uint32_t velocity) {
+    const uint32_t *curve = cfg->curve;
+
+    if (velocity <= curve[0]) {
+        return curve[1];
+    }
+
+    for (size_t i = 2; i < cfg->curve_len; i += 2) {
+        if (velocity <= curve[i]) {
+            uint32_t v0 = curve[i - 2], g0 = curve[i - 1], v1 = curve[i], g1 = curve[i + 1];
+            return (int32_t)g0 + ((int64_t)g1 - g0) * (velocity - v0) / (v1 - v0);
+        }
+    }
+
+    return curve[cfg->curve_len - 1];
+}
+
+// The speed of a frame is only known once it's synced, so each frame is accelerated with the gain
+// of the one before it, which is one lookup per frame.
+static void end_frame(const struct accel_config *cfg, struct accel_data *data) {
+    int64_t now = k_uptime_ticks();
+    uint64_t elapsed_us = MAX(k_ticks_to_us_floor64(now - data->last_sync_ticks), 1);
+
+    int64_t a = data->frame_motion[0], b = data->frame_motion[1];
+    // Octagonal approximation of the distance, within 12% of it without a square root
+    uint64_t distance = MAX(a, b) + MIN(a, b) / 2;
+    uint64_t velocity = distance * USEC_PER_SEC / elapsed_us;
+
+    data->gain = data->lut[MIN(velocity / data->velocity_step, LUT_SIZE - 1)];
+    data->frame_motion[0] = data->frame_motion[1] = 0;
+    data->last_sync_ticks = now;
+}
+
+// The first frame after a pause would otherwise get the gain of the last one before it, which
+// could be the fastest of a flick.
+static void reset_idle_gain(struct accel_data *data) {
+    if (IDLE_RESET_MS > 0 && data->frame_motion[0] == 0 && data->frame_motion[1] == 0 &&
+        k_uptime_ticks() - data->last_sync_ticks > k_ms_to_ticks_ceil64(IDLE_RESET_MS)) {
+        data->gain = data->lut[0];
+    }
+}
+
+static int accel_handle_event(const struct device *dev, struct input_event *event,
+                              uint32_t param1, uint32_t param2,
+                              struct zmk_input_processor_state *state) {
+    const struct accel_config *cfg = dev->config;
+    struct accel_data *data = dev->data;
+
+    int idx = event->type == cfg->type ? code_idx(cfg, event->code) : -ENODEV;
+    if (idx >= 0) {
+        reset_idle_gain(data);
+        data->frame_motion[idx] += llabs(event->value);
+
+        int64_t value = (int64_t)event->value * data->gain;
+        if (state && state->remainder) {
+            value += *state->remainder;
+        }
+
+        int64_t scaled = value / GAIN_UNIT;
+        if (state && state->remainder) {
+            *state->remainder = value - scaled * GAIN_UNIT;
+        }
+
+        int32_t accelerated = CLAMP(scaled, INT32_MIN, INT32_MAX);
+        LOG_DBG("accelerated %d with gain %d to %d", event->value, data->gain, accelerated);
+        event->value = accelerated;
+    }
+
+    if (event->sync) {
+        end_frame(cfg, data);
+    }
+
+    return ZMK_INPUT_PROC_CONTINUE;
+}
+
+static struct zmk_input_processor_driver_api accel_driver_api = {
+    .handle_event = accel_handle_event,
+};
+
+static int accel_init(const struct device *dev) {
+    const struct accel_config *cfg = dev->config;
+    struct accel_data *data = dev->data;
+
+    if (cfg->curve_len < 2 || cfg->curve_len % 2 != 0) {
+        LOG_ERR("The acceleration curve needs pairs of a speed and a gain");
+        return -EINVAL;
+    }
+
+    for (size_t i = 0; i < cfg->curve_len; i += 2) {
+        if ((i > 0 && cfg->curve[i] <= cfg->curve[i - 2]) || cfg->curve[i + 1] > UINT16_MAX) {
+            LOG_ERR("Invalid acceleration curve point %d", (int)(i / 2));
+            return -EINVAL;
+        }
+    }
+
+    data->velocity_step = MAX(DIV_ROUND_UP(cfg->curve[cfg->curve_len - 2], LUT_SIZE - 1), 1);
+
+    for (int i = 0; i < LUT_SIZE; i++) {
+        data->lut[i] = curve_gain(cfg, i * data->velocity_step);
+    }
+
+    data->gain = data->lut[0];
+    data->last_sync_ticks = k_uptime_ticks();
+
+    return 0;
+}
+
+#define ACCEL_INST(n)                                                                              \
+    BUILD_ASSERT(DT_INST_PROP_LEN(n, codes) <= MAX_CODES,                                          \
+                 "An acceleration processor takes at most two codes");                             \
+    static const uint16_t accel_codes_##n[] = DT_INST_PROP(n, codes);                              \
+    static const uint32_t accel_curve_##n[] = DT_INST_PROP(n, curve);                              \
+    static const struct accel_config accel_config_##n = {                                          \
+        .type = DT_INST_PROP_OR(n, type, INPUT_EV_REL),                                            \
+        .codes_len = DT_INST_PROP_LEN(n, codes),                                                   \
+        .codes = accel_codes_##n,                                                                  \
+        .curve_len = DT_INST_PROP_LEN(n, curve),                                                   \
+        .curve = accel_curve_##n,                                                                  \
+    };                                                                                             \
+    static struct accel_data accel_data_##n = {};                                                  \
+    DEVICE_DT_INST_DEFINE(n, &accel_init, NULL, &accel_data_##n, &accel_config_##n, POST_KERNEL,   \
+                          CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &accel_driver_api);
+
+DT_INST_FOREACH_STATUS_OKAY(ACCEL_INST)
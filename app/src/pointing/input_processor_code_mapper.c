@@ -6,6 +6,8 @@
 
 #define DT_DRV_COMPAT zmk_input_processor_code_mapper
 
+#include <string.h>
+
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <drivers/input_processor.h>
@@ -14,12 +16,40 @@
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+struct cm_entry {
+    uint16_t from;
+    uint16_t to;
+};
+
+struct cm_data {
+    // The pairs of the map sorted by source code, keeping only the first pair of each source
+    struct cm_entry *entries;
+    size_t entries_len;
+};
+
 struct cm_config {
     uint8_t type;
     size_t mapping_size;
     uint16_t mapping[];
 };
 
+static const struct cm_entry *cm_find(const struct device *dev, uint16_t code) {
+    const struct cm_data *data = dev->data;
+    size_t lo = 0, hi = data->entries_len;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (data->entries[mid].from < code) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo < data->entries_len && data->entries[lo].from == code ? &data->entries[lo] : NULL;
+}
+
 static int cm_handle_event(const struct device *dev, struct input_event *event, uint32_t param1,
                            uint32_t param2, struct zmk_input_processor_state *state) {
     const struct cm_config *cfg = dev->config;
@@ -28,23 +58,66 @@ static int cm_handle_event(const struct device *dev, struct input_event *event,
         return ZMK_INPUT_PROC_CONTINUE;
     }
 
-    for (int i = 0; i < cfg->mapping_size / 2; i++) {
-        if (cfg->mapping[i * 2] == event->code) {
-            uint16_t orig = event->code;
-            event->code = cfg->mapping[(i * 2) + 1];
-            LOG_DBG("Remapped %d to %d", orig, event->code);
-            break;
-        }
+    const struct cm_entry *entry = cm_find(dev, event->code);
+    if (entry) {
+        LOG_DBG("Remapped %d to %d", entry->from, entry->to);
+        event->code = entry->to;
     }
 
     return ZMK_INPUT_PROC_CONTINUE;
 }
 
+static int cm_map_linear(const struct device *dev, uint32_t param1, uint32_t param2,
+                         struct zmk_input_processor_linear_map *map) {
+    const struct cm_config *cfg = dev->config;
+
+    if (map->type != cfg->type) {
+        return 0;
+    }
+
+    const struct cm_entry *entry = cm_find(dev, map->code);
+    if (entry) {
+        map->code = entry->to;
+    }
+
+    return 0;
+}
+
+static int cm_init(const struct device *dev) {
+    const struct cm_config *cfg = dev->config;
+    struct cm_data *data = dev->data;
+    size_t len = 0;
+
+    // Insertion sort, so of pairs with the same source code the first one stays first and wins
+    for (size_t i = 0; i < cfg->mapping_size / 2; i++) {
+        struct cm_entry entry = {.from = cfg->mapping[i * 2], .to = cfg->mapping[(i * 2) + 1]};
+        size_t j = len;
+
+        while (j > 0 && data->entries[j - 1].from > entry.from) {
+            j--;
+        }
+
+        if (j > 0 && data->entries[j - 1].from == entry.from) {
+            continue;
+        }
+
+        memmove(&data->entries[j + 1], &data->entries[j], (len - j) * sizeof(entry));
+        data->entries[j] = entry;
+        len++;
+    }
+
+    data->entries_len = len;
+    return 0;
+}
+
 static struct zmk_input_processor_driver_api cm_driver_api = {
     .handle_event = cm_handle_event,
+    .map_linear = cm_map_linear,
 };
 
 #define TL_INST(n)                                                                                 \
+    static struct cm_entry cm_entries_##n[DT_INST_PROP_LEN(n, map) / 2];                           \
+    static struct cm_data cm_data_##n = {.entries = cm_entries_##n};                               \
     static const struct cm_config cm_config_##n = {                                                \
         .type = DT_INST_PROP_OR(n, type, INPUT_EV_REL),                                            \
         .mapping_size = DT_INST_PROP_LEN(n, map),                                                  \
@@ -52,7 +125,7 @@ static struct zmk_input_processor_driver_api cm_driver_api = {
     };                                                                                             \
     BUILD_ASSERT(DT_INST_PROP_LEN(n, map) % 2 == 0,                                                \
                  "Must have an even number of mapping entries");                                   \
-    DEVICE_DT_INST_DEFINE(n, NULL, NULL, NULL, &cm_config_##n, POST_KERNEL,                        \
+    DEVICE_DT_INST_DEFINE(n, cm_init, NULL, &cm_data_##n, &cm_config_##n, POST_KERNEL,             \
                           CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &cm_driver_api);
 
 DT_INST_FOREACH_STATUS_OKAY(TL_INST)
\ No newline at end of file
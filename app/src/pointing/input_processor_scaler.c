@@ -59,8 +59,28 @@ static int scaler_handle_event(const struct device *dev, struct input_event *eve
     return ZMK_INPUT_PROC_CONTINUE;
 }
 
+static int scaler_map_linear(const struct device *dev, uint32_t param1, uint32_t param2,
+                             struct zmk_input_processor_linear_map *map) {
+    const struct scaler_config *cfg = dev->config;
+
+    if (map->type != cfg->type) {
+        return 0;
+    }
+
+    for (int i = 0; i < cfg->codes_len; i++) {
+        if (cfg->codes[i] == map->code) {
+            map->mul *= (int32_t)param1;
+            map->div *= (int32_t)param2;
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
 static struct zmk_input_processor_driver_api scaler_driver_api = {
     .handle_event = scaler_handle_event,
+    .map_linear = scaler_map_linear,
 };
 
 #define SCALER_INST(n)                                                                             \
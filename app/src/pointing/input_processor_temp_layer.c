@@ -10,7 +10,9 @@
 #include <zephyr/device.h>
 #include <drivers/input_processor.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
 #include <zmk/keymap.h>
+#include <zmk/matrix.h>
 #include <zmk/behavior.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/keycode_state_changed.h>
@@ -37,25 +39,51 @@ struct temp_layer_data {
     const struct device *dev;
     struct k_mutex lock;
     struct temp_layer_state state;
+    // excluded_positions as bits indexed by position, built at init
+    uint32_t excluded_positions[DIV_ROUND_UP(ZMK_KEYMAP_LEN, 32)];
 };
 
-/* Static Work Queue Items */
-static struct k_work_delayable layer_disable_works[MAX_LAYERS];
+/*
+ * Layer Disable Timing
+ *
+ * Every input event stores the time its layer should be disabled at, and moves a single delayable
+ * work to the earliest deadline of any layer. When it runs, it disables the layers whose deadline
+ * passed and rearms itself for the ones that were pushed back in the meantime.
+ */
+static atomic_t layer_disable_deadlines[MAX_LAYERS];
+static ATOMIC_DEFINE(layer_disable_armed, MAX_LAYERS);
 
-/* Position Search */
-static bool position_is_excluded(const struct temp_layer_config *config, uint32_t position) {
-    if (!config->excluded_positions || !config->num_positions) {
-        return false;
-    }
+static void layer_disable_callback(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(layer_disable_work, layer_disable_callback);
+
+// Milliseconds until the deadline of @p layer, negative or zero once it passed.
+static int32_t layer_disable_remaining(uint8_t layer, uint32_t now) {
+    return (int32_t)((uint32_t)atomic_get(&layer_disable_deadlines[layer]) - now);
+}
+
+static void layer_disable_after(uint8_t layer, uint32_t timeout_ms) {
+    uint32_t now = k_uptime_get_32();
+    int32_t next = timeout_ms;
 
-    const uint16_t *end = config->excluded_positions + config->num_positions;
-    for (const uint16_t *pos = config->excluded_positions; pos < end; pos++) {
-        if (*pos == position) {
-            return true;
+    atomic_set(&layer_disable_deadlines[layer], (atomic_val_t)(now + timeout_ms));
+    // The deadline is stored first, so the callback either sees it or the bit is clear here.
+    atomic_set_bit(layer_disable_armed, layer);
+
+    // Another layer, or this one with a shorter timeout before, may be due earlier
+    for (int other = 0; other < MAX_LAYERS; other++) {
+        if (other != layer && atomic_test_bit(layer_disable_armed, other)) {
+            next = MIN(next, MAX(layer_disable_remaining(other, now), 0));
         }
     }
 
-    return false;
+    k_work_reschedule(&layer_disable_work, K_MSEC(next));
+}
+
+/* Position Search */
+static bool position_is_excluded(const struct temp_layer_data *data, uint32_t position) {
+    return position < ZMK_KEYMAP_LEN &&
+           (data->excluded_positions[position / 32] & BIT(position % 32));
 }
 
 /* Timing Check */
@@ -118,13 +146,40 @@ static K_WORK_DEFINE(layer_action_work, layer_action_work_cb);
 
 /* Work Queue Callback */
 static void layer_disable_callback(struct k_work *work) {
-    struct k_work_delayable *d_work = k_work_delayable_from_work(work);
-    int layer_index = ARRAY_INDEX(layer_disable_works, d_work);
+    uint32_t now = k_uptime_get_32();
+    int32_t next = INT32_MAX;
 
-    struct layer_state_action action = {.layer = layer_index, .activate = false};
+    for (int layer = 0; layer < MAX_LAYERS; layer++) {
+        if (!atomic_test_bit(layer_disable_armed, layer)) {
+            continue;
+        }
+
+        int32_t remaining = layer_disable_remaining(layer, now);
+        if (remaining > 0) {
+            next = MIN(next, remaining);
+            continue;
+        }
+
+        atomic_clear_bit(layer_disable_armed, layer);
+        // An event may have pushed the deadline back before the bit was cleared.
+        remaining = layer_disable_remaining(layer, now);
+        if (remaining > 0 && !atomic_test_and_set_bit(layer_disable_armed, layer)) {
+            next = MIN(next, remaining);
+            continue;
+        }
 
-    int ret = k_msgq_put(&temp_layer_action_msgq, &action, K_MSEC(10));
-    k_work_submit(&layer_action_work);
+        struct layer_state_action action = {.layer = layer, .activate = false};
+
+        int ret = k_msgq_put(&temp_layer_action_msgq, &action, K_MSEC(10));
+        if (ret < 0) {
+            LOG_ERR("Failed to enqueue action to disable layer %d (%d)", layer, ret);
+        }
+        k_work_submit(&layer_action_work);
+    }
+
+    if (next != INT32_MAX) {
+        k_work_schedule(&layer_disable_work, K_MSEC(next));
+    }
 }
 
 /* Event Handlers */
@@ -137,7 +192,8 @@ static int handle_layer_state_changed(const struct device *dev, const zmk_event_
     if (!zmk_keymap_layer_active(zmk_keymap_layer_index_to_id(data->state.toggle_layer))) {
         LOG_DBG("Deactivating layer that was activated by this processor");
         data->state.is_active = false;
-        k_work_cancel_delayable(&layer_disable_works[data->state.toggle_layer]);
+        // the work disarms itself once it finds no layer armed
+        atomic_clear_bit(layer_disable_armed, data->state.toggle_layer);
     }
     ret = k_mutex_unlock(&data->lock);
     if (ret < 0) {
@@ -161,8 +217,8 @@ static int handle_position_state_changed(const struct device *dev, const zmk_eve
 
     const struct temp_layer_config *cfg = dev->config;
 
-    if (data->state.is_active && cfg->excluded_positions && cfg->num_positions > 0) {
-        if (!position_is_excluded(cfg, ev->position)) {
+    if (data->state.is_active && cfg->num_positions > 0) {
+        if (!position_is_excluded(data, ev->position)) {
             LOG_DBG("Position not excluded, deactivating layer");
             update_layer_state(&data->state, false);
         }
@@ -238,6 +294,15 @@ static int temp_layer_handle_event(const struct device *dev, struct input_event
 
     struct temp_layer_data *data = (struct temp_layer_data *)dev->data;
 
+    if (param2 > 0) {
+        layer_disable_after(param1, param2);
+    }
+
+    // Once the layer is active, the deadline above is all a motion event changes.
+    if (data->state.is_active && data->state.toggle_layer == param1) {
+        return ZMK_INPUT_PROC_CONTINUE;
+    }
+
     int ret = k_mutex_lock(&data->lock, K_FOREVER);
     if (ret < 0) {
         return ret;
@@ -259,10 +324,6 @@ static int temp_layer_handle_event(const struct device *dev, struct input_event
         }
     }
 
-    if (param2 > 0) {
-        k_work_reschedule(&layer_disable_works[param1], K_MSEC(param2));
-    }
-
     k_mutex_unlock(&data->lock);
 
     return ZMK_INPUT_PROC_CONTINUE;
@@ -270,10 +331,16 @@ static int temp_layer_handle_event(const struct device *dev, struct input_event
 
 static int temp_layer_init(const struct device *dev) {
     struct temp_layer_data *data = (struct temp_layer_data *)dev->data;
+    const struct temp_layer_config *cfg = dev->config;
     k_mutex_init(&data->lock);
 
-    for (int i = 0; i < MAX_LAYERS; i++) {
-        k_work_init_delayable(&layer_disable_works[i], layer_disable_callback);
+    for (size_t i = 0; i < cfg->num_positions; i++) {
+        uint16_t position = cfg->excluded_positions[i];
+        if (position >= ZMK_KEYMAP_LEN) {
+            LOG_WRN("Ignoring excluded position %d outside of the keymap", position);
+            continue;
+        }
+        data->excluded_positions[position / 32] |= BIT(position % 32);
     }
 
     return 0;
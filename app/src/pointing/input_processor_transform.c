@@ -68,8 +68,24 @@ static int ipt_handle_event(const struct device *dev, struct input_event *event,
     return ZMK_INPUT_PROC_CONTINUE;
 }
 
+// Runs the transform on a unit event, which gives the map the same code change and sign
+static int ipt_map_linear(const struct device *dev, uint32_t param1, uint32_t param2,
+                          struct zmk_input_processor_linear_map *map) {
+    struct input_event event = {.type = map->type, .code = map->code, .value = 1};
+
+    int ret = ipt_handle_event(dev, &event, param1, param2, NULL);
+    if (ret < 0) {
+        return ret;
+    }
+
+    map->code = event.code;
+    map->mul *= event.value;
+    return 0;
+}
+
 static struct zmk_input_processor_driver_api ipt_driver_api = {
     .handle_event = ipt_handle_event,
+    .map_linear = ipt_map_linear,
 };
 
 static int ipt_init(const struct device *dev) { return 0; }
@@ -6,6 +6,8 @@
 
 #define DT_DRV_COMPAT zmk_input_split
 
+#include <string.h>
+
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/input/input.h>
@@ -108,6 +110,101 @@ int zmk_input_split_peripheral_disconnected(uint8_t reg) {
 
 #include <zmk/split/peripheral.h>
 
+// Relative motion codes that can be summed up between reports, below INPUT_REL_MISC
+#define ZIS_REL_CODES (INPUT_REL_MISC + 1)
+
+struct zis_peripheral_config {
+    uint8_t reg;
+    const struct zmk_input_processor_entry *processors;
+    size_t processors_len;
+    uint32_t report_interval_ms;
+};
+
+struct zis_peripheral_data {
+    const struct zis_peripheral_config *config;
+    struct k_spinlock lock;
+    struct k_work_delayable report_work;
+    // bits indexed by the codes with motion in values
+    uint16_t pending;
+    int32_t values[ZIS_REL_CODES];
+};
+
+BUILD_ASSERT(ZIS_REL_CODES <= 16);
+
+static void zis_report(uint8_t reg, uint8_t type, uint16_t code, int32_t value, bool sync) {
+    struct zmk_split_transport_peripheral_event ev = {
+        .type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_INPUT_EVENT,
+        .data = {.input_event = {
+                     .reg = reg,
+                     .type = type,
+                     .code = code,
+                     .value = value,
+                     .sync = sync,
+                 }}};
+    zmk_split_peripheral_report_event(&ev);
+}
+
+// Sends the motion summed up so far, the last code sent carrying the sync
+static void zis_flush_pending(struct zis_peripheral_data *data, bool sync) {
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    uint16_t pending = data->pending;
+    int32_t values[ZIS_REL_CODES];
+    memcpy(values, data->values, sizeof(values));
+    data->pending = 0;
+    memset(data->values, 0, sizeof(data->values));
+    k_spin_unlock(&data->lock, key);
+
+    while (pending) {
+        uint16_t code = __builtin_ctz(pending);
+        pending &= pending - 1;
+        zis_report(data->config->reg, INPUT_EV_REL, code, values[code], sync && !pending);
+    }
+}
+
+static void zis_report_work_cb(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct zis_peripheral_data *data = CONTAINER_OF(dwork, struct zis_peripheral_data, report_work);
+
+    zis_flush_pending(data, true);
+}
+
+static void zis_handle_event(const struct zis_peripheral_config *config,
+                             struct zis_peripheral_data *data, struct input_event *evt) {
+    for (size_t i = 0; i < config->processors_len; i++) {
+        int ret = zmk_input_processor_handle_event(config->processors[i].dev, evt,
+                                                   config->processors[i].param1,
+                                                   config->processors[i].param2, NULL);
+        if (ret != ZMK_INPUT_PROC_CONTINUE) {
+            return;
+        }
+    }
+
+    if (config->report_interval_ms > 0 && evt->type == INPUT_EV_REL && evt->code < ZIS_REL_CODES) {
+        if (evt->value == 0) {
+            return;
+        }
+
+        k_spinlock_key_t key = k_spin_lock(&data->lock);
+        data->values[evt->code] += evt->value;
+        data->pending |= BIT(evt->code);
+        k_spin_unlock(&data->lock, key);
+
+        // Only schedules when idle, so motion is sent at most once per interval
+        k_work_schedule(&data->report_work, K_MSEC(config->report_interval_ms));
+        return;
+    }
+
+    // Anything else is sent right away, after the motion before it. That includes motion the
+    // report work has already taken, so a running work is waited for rather than raced.
+    if (config->report_interval_ms > 0) {
+        struct k_work_sync sync;
+        k_work_cancel_delayable_sync(&data->report_work, &sync);
+        zis_flush_pending(data, false);
+    }
+
+    zis_report(config->reg, evt->type, evt->code, evt->value, evt->sync);
+}
+
 #define ZIS_INST(n)                                                                                \
     static const struct zmk_input_processor_entry processors_##n[] =                               \
         COND_CODE_1(DT_INST_NODE_HAS_PROP(n, input_processors),                                    \
@@ -116,25 +213,18 @@ int zmk_input_split_peripheral_disconnected(uint8_t reg) {
                     ({}));                                                                         \
     BUILD_ASSERT(DT_INST_NODE_HAS_PROP(n, device),                                                 \
                  "Peripheral input splits need an `input` property set");                          \
+    static const struct zis_peripheral_config config_##n = {                                       \
+        .reg = DT_INST_REG_ADDR(n),                                                                \
+        .processors = processors_##n,                                                              \
+        .processors_len = ARRAY_SIZE(processors_##n),                                              \
+        .report_interval_ms = DT_INST_PROP(n, report_interval_ms),                                 \
+    };                                                                                             \
+    static struct zis_peripheral_data data_##n = {                                                 \
+        .config = &config_##n,                                                                     \
+        .report_work = Z_WORK_DELAYABLE_INITIALIZER(zis_report_work_cb),                           \
+    };                                                                                             \
     void split_input_handler_##n(struct input_event *evt, void *user_data) {                       \
-        for (size_t i = 0; i < ARRAY_SIZE(processors_##n); i++) {                                  \
-            int ret = zmk_input_processor_handle_event(processors_##n[i].dev, evt,                 \
-                                                       processors_##n[i].param1,                   \
-                                                       processors_##n[i].param2, NULL);            \
-            if (ret != ZMK_INPUT_PROC_CONTINUE) {                                                  \
-                return;                                                                            \
-            }                                                                                      \
-        }                                                                                          \
-        struct zmk_split_transport_peripheral_event ev = {                                         \
-            .type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_INPUT_EVENT,                         \
-            .data = {.input_event = {                                                              \
-                         .reg = DT_INST_REG_ADDR(n),                                               \
-                         .type = evt->type,                                                        \
-                         .code = evt->code,                                                        \
-                         .value = evt->value,                                                      \
-                         .sync = evt->sync,                                                        \
-                     }}};                                                                          \
-        zmk_split_peripheral_report_event(&ev);                                                    \
+        zis_handle_event(&config_##n, &data_##n, evt);                                             \
     }                                                                                              \
     INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(DT_INST_PHANDLE(n, device)), split_input_handler_##n, NULL);
 
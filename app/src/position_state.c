@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include <zmk/context.h>
+#include <zmk/event_manager.h>
+#include <zmk/matrix.h>
+#include <zmk/position_state.h>
+#include <zmk/events/position_state_changed.h>
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT) && IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+#include <zmk/split/central.h>
+#define PERIPHERAL_COUNT ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT
+#else
+#define PERIPHERAL_COUNT 0
+#endif
+
+// The local keys first, then one bitmap per peripheral.
+#define SOURCE_COUNT (PERIPHERAL_COUNT + 1)
+#define WORD_COUNT DIV_ROUND_UP(ZMK_KEYMAP_LEN, 32)
+
+struct position_state {
+    uint32_t source_held[SOURCE_COUNT][WORD_COUNT];
+    // Union of the sources, which is what most modules ask about.
+    uint32_t held[WORD_COUNT];
+    uint32_t held_count;
+    // Latest timestamp of the position events raised so far.
+    int64_t last_timestamp;
+};
+
+ZMK_CONTEXT_STATE_DEFINE(position_states, struct position_state, {});
+
+#define STATE ZMK_CONTEXT_STATE(position_states)
+
+static int source_index(uint8_t source) {
+    if (source == ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL) {
+        return 0;
+    }
+
+    return source < PERIPHERAL_COUNT ? source + 1 : -1;
+}
+
+static bool test_bit(const uint32_t *bitmap, uint32_t position) {
+    return (bitmap[position / 32] & BIT(position % 32)) != 0;
+}
+
+bool zmk_position_state_is_pressed(uint32_t position) {
+    return position < ZMK_KEYMAP_LEN && test_bit(STATE->held, position);
+}
+
+bool zmk_position_state_source_is_pressed(uint8_t source, uint32_t position) {
+    int index = source_index(source);
+
+    return index >= 0 && position < ZMK_KEYMAP_LEN && test_bit(STATE->source_held[index], position);
+}
+
+uint32_t zmk_position_state_pressed_count(void) { return STATE->held_count; }
+
+int64_t zmk_position_state_last_timestamp(void) { return STATE->last_timestamp; }
+
+void zmk_position_state_foreach_pressed(zmk_position_state_cb_t cb, void *user_data) {
+    for (uint32_t word = 0; word < WORD_COUNT; word++) {
+        for (uint32_t bits = STATE->held[word]; bits; bits &= bits - 1) {
+            cb(word * 32 + find_lsb_set(bits) - 1, user_data);
+        }
+    }
+}
+
+static void update_held(uint32_t position) {
+    bool pressed = false;
+
+    for (int i = 0; i < SOURCE_COUNT && !pressed; i++) {
+        pressed = test_bit(STATE->source_held[i], position);
+    }
+
+    if (pressed != test_bit(STATE->held, position)) {
+        WRITE_BIT(STATE->held[position / 32], position % 32, pressed);
+        STATE->held_count += pressed ? 1 : -1;
+    }
+}
+
+static int position_state_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    int index = source_index(ev->source);
+
+    STATE->last_timestamp = MAX(STATE->last_timestamp, ev->timestamp);
+
+    if (index < 0 || ev->position >= ZMK_KEYMAP_LEN) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    WRITE_BIT(STATE->source_held[index][ev->position / 32], ev->position % 32, ev->state);
+    update_held(ev->position);
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(position_state, position_state_listener);
+ZMK_SUBSCRIPTION(position_state, zmk_position_state_changed);
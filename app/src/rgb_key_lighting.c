@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+
+#include <stdlib.h>
+
+#include <zephyr/logging/log.h>
+
+#include <zephyr/drivers/led_strip.h>
+
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/matrix.h>
+#include <zmk/physical_layouts.h>
+#include <zmk/workqueue.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define DT_DRV_COMPAT zmk_rgb_key_map
+
+BUILD_ASSERT(DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT) <= 1,
+             "Only one zmk,rgb-key-map node can be enabled");
+
+#define KEY_MAP DT_DRV_INST(0)
+#define KEY_MAP_LAYOUT DT_PHANDLE(KEY_MAP, physical_layout)
+#define KEY_MAP_STRIP DT_PHANDLE(KEY_MAP, led_strip)
+
+#define STRIP_NUM_PIXELS DT_PROP(KEY_MAP_STRIP, chain_length)
+#define LED_COUNT DT_PROP_LEN(KEY_MAP, key_positions)
+#define KEY_COUNT DT_PROP_LEN(KEY_MAP_LAYOUT, keys)
+
+BUILD_ASSERT(LED_COUNT <= STRIP_NUM_PIXELS, "The RGB key map has more LEDs than its strip");
+
+BUILD_ASSERT(!DT_HAS_CHOSEN(zmk_underglow) ||
+                 !DT_SAME_NODE(DT_CHOSEN(zmk_underglow), KEY_MAP_STRIP),
+             "The RGB key map strip can't also be the underglow strip");
+
+#define FRAME_PERIOD_MS (1000 / CONFIG_ZMK_RGB_KEY_LIGHTING_FPS)
+
+#define INTENSITY_MAX UINT8_MAX
+
+// Fades a fully lit key out over CONFIG_ZMK_RGB_KEY_LIGHTING_FADE_MS
+#define INTENSITY_DECAY                                                                            \
+    MAX(1, INTENSITY_MAX * FRAME_PERIOD_MS / CONFIG_ZMK_RGB_KEY_LIGHTING_FADE_MS)
+
+struct key_center {
+    int16_t x;
+    int16_t y;
+};
+
+#define KEY_CENTER_INIT(i, node)                                                                   \
+    {                                                                                              \
+        .x = (int16_t)(int32_t)DT_PHA_BY_IDX(node, keys, i, x) +                                   \
+             (int16_t)(int32_t)DT_PHA_BY_IDX(node, keys, i, width) / 2,                            \
+        .y = (int16_t)(int32_t)DT_PHA_BY_IDX(node, keys, i, y) +                                   \
+             (int16_t)(int32_t)DT_PHA_BY_IDX(node, keys, i, height) / 2,                           \
+    }
+
+static const struct key_center key_centers[KEY_COUNT] = {
+    LISTIFY(KEY_COUNT, KEY_CENTER_INIT, (, ), KEY_MAP_LAYOUT)};
+
+static const uint16_t led_key_positions[LED_COUNT] = DT_PROP(KEY_MAP, key_positions);
+
+static const struct device *led_strip = DEVICE_DT_GET(KEY_MAP_STRIP);
+
+static bool strip_ready;
+
+static struct led_rgb pixels[STRIP_NUM_PIXELS];
+
+// Only accessed from frames, so a press updates the LEDs in the next frame however many keys were
+// pressed since the last one.
+static uint8_t intensities[LED_COUNT];
+
+// Positions of the selected layout pressed since the last frame
+static ATOMIC_DEFINE(pressed_positions, ZMK_KEYMAP_LEN);
+
+// Set while frames are running, which is only until every LED has faded out
+static atomic_t animating;
+
+static void light_pressed_key(uint32_t position) {
+    struct zmk_physical_layout const *const *layouts;
+    size_t layouts_len = zmk_physical_layouts_get_list(&layouts);
+    int selected = zmk_physical_layouts_get_selected();
+
+    if (selected < 0 || selected >= layouts_len || position >= layouts[selected]->keys_len) {
+        return;
+    }
+
+    const struct zmk_key_physical_attrs *key = &layouts[selected]->keys[position];
+    int32_t x = key->x + key->width / 2;
+    int32_t y = key->y + key->height / 2;
+
+    for (int i = 0; i < LED_COUNT; i++) {
+        if (led_key_positions[i] >= KEY_COUNT) {
+            continue;
+        }
+
+        int32_t dx = abs(key_centers[led_key_positions[i]].x - x);
+        int32_t dy = abs(key_centers[led_key_positions[i]].y - y);
+
+        // Octagonal approximation of the distance, within 12% of it without a square root
+        int32_t distance = MAX(dx, dy) + MIN(dx, dy) / 2;
+
+        uint8_t intensity = 0;
+        if (distance == 0) {
+            intensity = INTENSITY_MAX;
+        } else if (distance < CONFIG_ZMK_RGB_KEY_LIGHTING_SPREAD) {
+            intensity = INTENSITY_MAX * (CONFIG_ZMK_RGB_KEY_LIGHTING_SPREAD - distance) /
+                        CONFIG_ZMK_RGB_KEY_LIGHTING_SPREAD;
+        }
+
+        intensities[i] = MAX(intensities[i], intensity);
+    }
+}
+
+static void light_pressed_keys(void) {
+    for (uint32_t position = 0; position < ZMK_KEYMAP_LEN; position++) {
+        if (atomic_test_and_clear_bit(pressed_positions, position)) {
+            light_pressed_key(position);
+        }
+    }
+}
+
+static bool any_pressed_keys(void) {
+    for (uint32_t position = 0; position < ZMK_KEYMAP_LEN; position++) {
+        if (atomic_test_bit(pressed_positions, position)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static uint8_t scale_channel(uint8_t channel, uint8_t intensity) {
+    return channel * intensity * CONFIG_ZMK_RGB_KEY_LIGHTING_BRT_MAX / (INTENSITY_MAX * 100);
+}
+
+// Returns whether the frame lit any LED, so frames only stop once one leaves the whole strip off
+static bool render_frame(void) {
+    const uint32_t color = CONFIG_ZMK_RGB_KEY_LIGHTING_COLOR;
+    bool lit = false;
+
+    for (int i = 0; i < LED_COUNT; i++) {
+        pixels[i] = (struct led_rgb){
+            r : scale_channel((color >> 16) & 0xFF, intensities[i]),
+            g : scale_channel((color >> 8) & 0xFF, intensities[i]),
+            b : scale_channel(color & 0xFF, intensities[i]),
+        };
+
+        lit |= intensities[i] > 0;
+        intensities[i] = intensities[i] > INTENSITY_DECAY ? intensities[i] - INTENSITY_DECAY : 0;
+    }
+
+    return lit;
+}
+
+static void frame_timer_handler(struct k_timer *timer);
+
+K_TIMER_DEFINE(frame_timer, frame_timer_handler, NULL);
+
+static void frame_work_cb(struct k_work *work) {
+    light_pressed_keys();
+
+    bool lit = render_frame();
+
+    // The whole strip is sent once per frame, whatever the number of keys that changed
+    int err = led_strip_update_rgb(led_strip, pixels, STRIP_NUM_PIXELS);
+    if (err < 0) {
+        LOG_ERR("Failed to update the RGB key strip (%d)", err);
+    }
+
+    if (lit) {
+        return;
+    }
+
+    // The frame just sent left every LED off. A key pressed meanwhile either sees the frames
+    // stopped and starts them again, or is caught here.
+    k_timer_stop(&frame_timer);
+    atomic_clear(&animating);
+
+    if (any_pressed_keys() && atomic_cas(&animating, 0, 1)) {
+        k_timer_start(&frame_timer, K_NO_WAIT, K_MSEC(FRAME_PERIOD_MS));
+    }
+}
+
+K_WORK_DEFINE(frame_work, frame_work_cb);
+
+static void frame_timer_handler(struct k_timer *timer) {
+    k_work_submit_to_queue(zmk_workqueue_lowprio_work_q(), &frame_work);
+}
+
+static int rgb_key_lighting_event_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    if (ev == NULL || !ev->state || !strip_ready || ev->position >= ZMK_KEYMAP_LEN) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    atomic_set_bit(pressed_positions, ev->position);
+
+    if (atomic_cas(&animating, 0, 1)) {
+        k_timer_start(&frame_timer, K_NO_WAIT, K_MSEC(FRAME_PERIOD_MS));
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(rgb_key_lighting, rgb_key_lighting_event_listener);
+ZMK_SUBSCRIPTION(rgb_key_lighting, zmk_position_state_changed);
+
+static int rgb_key_lighting_init(void) {
+    if (!device_is_ready(led_strip)) {
+        LOG_ERR("LED strip device %s is not ready", led_strip->name);
+        return -ENODEV;
+    }
+
+    for (int i = 0; i < LED_COUNT; i++) {
+        if (led_key_positions[i] >= KEY_COUNT) {
+            LOG_WRN("LED %d is mapped to key position %d, outside of its layout", i,
+                    led_key_positions[i]);
+        }
+    }
+
+    strip_ready = true;
+    return 0;
+}
+
+SYS_INIT(rgb_key_lighting_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -7,9 +7,9 @@
 #include <zephyr/device.h>
 #include <zephyr/init.h>
 #include <zephyr/kernel.h>
+#include <zephyr/pm/device_runtime.h>
 #include <zephyr/settings/settings.h>
 
-#include <math.h>
 #include <stdlib.h>
 
 #include <zephyr/logging/log.h>
@@ -18,6 +18,7 @@
 #include <drivers/ext_power.h>
 
 #include <zmk/rgb_underglow.h>
+#include <zmk/settings.h>
 
 #include <zmk/activity.h>
 #include <zmk/usb.h>
@@ -25,6 +26,7 @@
 #include <zmk/events/activity_state_changed.h>
 #include <zmk/events/usb_conn_state_changed.h>
 #include <zmk/workqueue.h>
+#include <zmk/work_stats.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -41,6 +43,8 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #define SAT_MAX 100
 #define BRT_MAX 100
 
+#define HUE_SECTOR (HUE_MAX / 6)
+
 BUILD_ASSERT(CONFIG_ZMK_RGB_UNDERGLOW_BRT_MIN <= CONFIG_ZMK_RGB_UNDERGLOW_BRT_MAX,
              "ERROR: RGB underglow maximum brightness is less than minimum brightness");
 
@@ -64,10 +68,15 @@ static const struct device *led_strip;
 
 static struct led_rgb pixels[STRIP_NUM_PIXELS];
 
+// Set whenever the strip may not be showing the pixels, so unchanged frames aren't sent again
+static bool pixels_dirty = true;
+
 static struct rgb_underglow_state state;
 
 #if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_EXT_POWER)
 static const struct device *const ext_power = DEVICE_DT_GET(DT_INST(0, zmk_ext_power_generic));
+// whether the underglow holds a runtime PM usage count on ext_power
+static bool ext_power_held;
 #endif
 
 static struct zmk_led_hsb hsb_scale_min_max(struct zmk_led_hsb hsb) {
@@ -81,68 +90,83 @@ static struct zmk_led_hsb hsb_scale_zero_max(struct zmk_led_hsb hsb) {
     return hsb;
 }
 
-static struct led_rgb hsb_to_rgb(struct zmk_led_hsb hsb) {
-    float r = 0, g = 0, b = 0;
+// Scales the level of a channel at full saturation and brightness, out of HUE_SECTOR, to the
+// saturation and brightness of the color. The divisor is constant, so no division is done.
+static uint8_t hsb_channel(struct zmk_led_hsb hsb, uint32_t level) {
+    return hsb.b * (SAT_MAX * HUE_SECTOR - hsb.s * (HUE_SECTOR - level)) * 255 /
+           (BRT_MAX * SAT_MAX * HUE_SECTOR);
+}
 
-    uint8_t i = hsb.h / 60;
-    float v = hsb.b / ((float)BRT_MAX);
-    float s = hsb.s / ((float)SAT_MAX);
-    float f = hsb.h / ((float)HUE_MAX) * 6 - i;
-    float p = v * (1 - s);
-    float q = v * (1 - f * s);
-    float t = v * (1 - (1 - f) * s);
+static struct led_rgb hsb_to_rgb(struct zmk_led_hsb hsb) {
+    uint32_t rise = hsb.h % HUE_SECTOR;
+    uint32_t fall = HUE_SECTOR - rise;
+    uint32_t r, g, b;
 
-    switch (i % 6) {
+    switch ((hsb.h / HUE_SECTOR) % 6) {
     case 0:
-        r = v;
-        g = t;
-        b = p;
+        r = HUE_SECTOR;
+        g = rise;
+        b = 0;
         break;
     case 1:
-        r = q;
-        g = v;
-        b = p;
+        r = fall;
+        g = HUE_SECTOR;
+        b = 0;
         break;
     case 2:
-        r = p;
-        g = v;
-        b = t;
+        r = 0;
+        g = HUE_SECTOR;
+        b = rise;
         break;
     case 3:
-        r = p;
-        g = q;
-        b = v;
+        r = 0;
+        g = fall;
+        b = HUE_SECTOR;
         break;
     case 4:
-        r = t;
-        g = p;
-        b = v;
+        r = rise;
+        g = 0;
+        b = HUE_SECTOR;
         break;
-    case 5:
-        r = v;
-        g = p;
-        b = q;
+    default:
+        r = HUE_SECTOR;
+        g = 0;
+        b = fall;
         break;
     }
 
-    struct led_rgb rgb = {r : r * 255, g : g * 255, b : b * 255};
+    struct led_rgb rgb = {
+        r : hsb_channel(hsb, r),
+        g : hsb_channel(hsb, g),
+        b : hsb_channel(hsb, b),
+    };
 
     return rgb;
 }
 
-static void zmk_rgb_underglow_effect_solid(void) {
+static void set_pixel(int i, struct led_rgb rgb) {
+    if (pixels[i].r != rgb.r || pixels[i].g != rgb.g || pixels[i].b != rgb.b) {
+        pixels[i] = rgb;
+        pixels_dirty = true;
+    }
+}
+
+// Converts the color once for the effects showing a single color on the whole strip
+static void fill_pixels(struct zmk_led_hsb hsb) {
+    struct led_rgb rgb = hsb_to_rgb(hsb);
+
     for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
-        pixels[i] = hsb_to_rgb(hsb_scale_min_max(state.color));
+        set_pixel(i, rgb);
     }
 }
 
+static void zmk_rgb_underglow_effect_solid(void) { fill_pixels(hsb_scale_min_max(state.color)); }
+
 static void zmk_rgb_underglow_effect_breathe(void) {
-    for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
-        struct zmk_led_hsb hsb = state.color;
-        hsb.b = abs(state.animation_step - 1200) / 12;
+    struct zmk_led_hsb hsb = state.color;
+    hsb.b = abs(state.animation_step - 1200) / 12;
 
-        pixels[i] = hsb_to_rgb(hsb_scale_zero_max(hsb));
-    }
+    fill_pixels(hsb_scale_zero_max(hsb));
 
     state.animation_step += state.animation_speed * 10;
 
@@ -152,23 +176,26 @@ static void zmk_rgb_underglow_effect_breathe(void) {
 }
 
 static void zmk_rgb_underglow_effect_spectrum(void) {
-    for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
-        struct zmk_led_hsb hsb = state.color;
-        hsb.h = state.animation_step;
+    struct zmk_led_hsb hsb = state.color;
+    hsb.h = state.animation_step;
 
-        pixels[i] = hsb_to_rgb(hsb_scale_min_max(hsb));
-    }
+    fill_pixels(hsb_scale_min_max(hsb));
 
     state.animation_step += state.animation_speed;
     state.animation_step = state.animation_step % HUE_MAX;
 }
 
 static void zmk_rgb_underglow_effect_swirl(void) {
+    struct zmk_led_hsb hsb = hsb_scale_min_max(state.color);
+    hsb.h = state.animation_step;
+
     for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
-        struct zmk_led_hsb hsb = state.color;
-        hsb.h = (HUE_MAX / STRIP_NUM_PIXELS * i + state.animation_step) % HUE_MAX;
+        set_pixel(i, hsb_to_rgb(hsb));
 
-        pixels[i] = hsb_to_rgb(hsb_scale_min_max(hsb));
+        hsb.h += HUE_MAX / STRIP_NUM_PIXELS;
+        if (hsb.h >= HUE_MAX) {
+            hsb.h -= HUE_MAX;
+        }
     }
 
     state.animation_step += state.animation_speed * 2;
@@ -191,19 +218,34 @@ static void zmk_rgb_underglow_tick(struct k_work *work) {
         break;
     }
 
+    if (!pixels_dirty) {
+        return;
+    }
+
     int err = led_strip_update_rgb(led_strip, pixels, STRIP_NUM_PIXELS);
     if (err < 0) {
         LOG_ERR("Failed to update the RGB strip (%d)", err);
     }
+
+    pixels_dirty = err < 0;
 }
 
-K_WORK_DEFINE(underglow_tick_work, zmk_rgb_underglow_tick);
+ZMK_WORK_STATS_DEFINE(underglow_tick, 0);
+
+static void underglow_tick_work_cb(struct k_work *work) {
+    uint32_t start = zmk_work_stats_run_start(ZMK_WORK_STATS(underglow_tick));
+    zmk_rgb_underglow_tick(work);
+    zmk_work_stats_run_end(ZMK_WORK_STATS(underglow_tick), start);
+}
+
+K_WORK_DEFINE(underglow_tick_work, underglow_tick_work_cb);
 
 static void zmk_rgb_underglow_tick_handler(struct k_timer *timer) {
     if (!state.on) {
         return;
     }
 
+    zmk_work_stats_submit(ZMK_WORK_STATS(underglow_tick), 0);
     k_work_submit_to_queue(zmk_workqueue_lowprio_work_q(), &underglow_tick_work);
 }
 
@@ -235,12 +277,6 @@ static int rgb_settings_set(const char *name, size_t len, settings_read_cb read_
 }
 
 SETTINGS_STATIC_HANDLER_DEFINE(rgb_underglow, "rgb/underglow", NULL, rgb_settings_set, NULL, NULL);
-
-static void zmk_rgb_underglow_save_state_work(struct k_work *_work) {
-    settings_save_one("rgb/underglow/state", &state, sizeof(state));
-}
-
-static struct k_work_delayable underglow_save_work;
 #endif
 
 static int zmk_rgb_underglow_init(void) {
@@ -265,16 +301,16 @@ static int zmk_rgb_underglow_init(void) {
         on : IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_ON_START)
     };
 
-#if IS_ENABLED(CONFIG_SETTINGS)
-    k_work_init_delayable(&underglow_save_work, zmk_rgb_underglow_save_state_work);
-#endif
-
 #if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_AUTO_OFF_USB)
     state.on = zmk_usb_is_powered();
 #endif
 
     if (state.on) {
+#if IS_ENABLED(CONFIG_ZMK_BOOT_INPUT_FIRST)
+        k_timer_start(&underglow_tick, K_MSEC(CONFIG_ZMK_BOOT_DEFERRED_START_MS), K_MSEC(50));
+#else
         k_timer_start(&underglow_tick, K_NO_WAIT, K_MSEC(50));
+#endif
     }
 
     return 0;
@@ -282,8 +318,7 @@ static int zmk_rgb_underglow_init(void) {
 
 int zmk_rgb_underglow_save_state(void) {
 #if IS_ENABLED(CONFIG_SETTINGS)
-    int ret = k_work_reschedule(&underglow_save_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
-    return MIN(ret, 0);
+    return zmk_settings_save("rgb/underglow/state", &state, sizeof(state));
 #else
     return 0;
 #endif
@@ -303,6 +338,10 @@ int zmk_rgb_underglow_on(void) {
 
 #if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_EXT_POWER)
     if (ext_power != NULL) {
+        // Holds the output on if runtime PM manages it.
+        if (!ext_power_held && pm_device_runtime_get(ext_power) == 0) {
+            ext_power_held = true;
+        }
         int rc = ext_power_enable(ext_power);
         if (rc != 0) {
             LOG_ERR("Unable to enable EXT_POWER: %d", rc);
@@ -323,6 +362,9 @@ static void zmk_rgb_underglow_off_handler(struct k_work *work) {
     }
 
     led_strip_update_rgb(led_strip, pixels, STRIP_NUM_PIXELS);
+
+    // The strip may lose what it showed while powered off, so the first frame is always sent
+    pixels_dirty = true;
 }
 
 K_WORK_DEFINE(underglow_off_work, zmk_rgb_underglow_off_handler);
@@ -337,6 +379,10 @@ int zmk_rgb_underglow_off(void) {
         if (rc != 0) {
             LOG_ERR("Unable to disable EXT_POWER: %d", rc);
         }
+        if (ext_power_held) {
+            pm_device_runtime_put(ext_power);
+            ext_power_held = false;
+        }
     }
 #endif
 
@@ -4,9 +4,12 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <stdlib.h>
+
 #include <zephyr/drivers/sensor.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/init.h>
+#include <zephyr/kernel.h>
 
 #include <zephyr/logging/log.h>
 
@@ -15,6 +18,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/sensors.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/sensor_event.h>
+#include <zmk/workqueue.h>
 
 #if ZMK_KEYMAP_HAS_SENSORS
 
@@ -55,6 +59,22 @@ static struct sensors_item_cfg sensors[] = {LISTIFY(ZMK_KEYMAP_SENSORS_LEN, SENS
 
 static ATOMIC_DEFINE(pending_sensors, ZMK_KEYMAP_SENSORS_LEN);
 
+#if CONFIG_ZMK_KEYMAP_SENSORS_MAX_EVENT_RATE > 0
+
+#define SENSOR_EVENT_INTERVAL_MS (1000 / CONFIG_ZMK_KEYMAP_SENSORS_MAX_EVENT_RATE)
+
+// Readings summed since the last event raised for each sensor.
+struct sensor_accumulator {
+    struct k_work_delayable work;
+    struct sensor_value sum;
+    int64_t last_event;
+};
+
+static struct sensor_accumulator accumulators[ZMK_KEYMAP_SENSORS_LEN];
+static struct k_spinlock accumulators_lock;
+
+#endif // CONFIG_ZMK_KEYMAP_SENSORS_MAX_EVENT_RATE > 0
+
 const struct zmk_sensor_config *zmk_sensors_get_config_at_index(uint8_t sensor_index) {
     if (sensor_index > ARRAY_SIZE(configs)) {
         return NULL;
@@ -63,6 +83,108 @@ const struct zmk_sensor_config *zmk_sensors_get_config_at_index(uint8_t sensor_i
     return &configs[sensor_index];
 }
 
+static void raise_sensor_value(uint32_t sensor_index, struct sensor_value value) {
+    const struct sensors_item_cfg *item = &sensors[sensor_index];
+
+    ZMK_EVENT_INIT(zmk_sensor_event, ev);
+    ev.data.sensor_index = item->sensor_index;
+    ev.data.channel_data_size = 1;
+    ev.data.channel_data[0] =
+        (struct zmk_sensor_channel_data){.value = value, .channel = item->trigger.chan};
+    ev.data.timestamp = k_uptime_get();
+
+    ZMK_EVENT_RAISE(ev);
+}
+
+#if CONFIG_ZMK_KEYMAP_SENSORS_MAX_EVENT_RATE > 0
+
+static void raise_accumulated_sensor_value(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct sensor_accumulator *acc = CONTAINER_OF(dwork, struct sensor_accumulator, work);
+
+    k_spinlock_key_t key = k_spin_lock(&accumulators_lock);
+    struct sensor_value value = acc->sum;
+    acc->sum = (struct sensor_value){0};
+    if (value.val1 != 0 || value.val2 != 0) {
+        acc->last_event = k_uptime_get();
+    }
+    k_spin_unlock(&accumulators_lock, key);
+
+    // Readings in opposite directions can cancel out
+    if (value.val1 != 0 || value.val2 != 0) {
+        raise_sensor_value(acc - accumulators, value);
+    }
+}
+
+static void accumulate_sensor_value(uint32_t sensor_index, const struct sensor_value *value) {
+    struct sensor_accumulator *acc = &accumulators[sensor_index];
+
+    k_spinlock_key_t key = k_spin_lock(&accumulators_lock);
+    acc->sum.val1 += value->val1;
+    acc->sum.val2 += value->val2;
+    if (abs(acc->sum.val2) >= 1000000) {
+        acc->sum.val1 += acc->sum.val2 / 1000000;
+        acc->sum.val2 %= 1000000;
+    }
+    int64_t next_event = acc->last_event + SENSOR_EVENT_INTERVAL_MS;
+    k_spin_unlock(&accumulators_lock, key);
+
+    // Already scheduled if an earlier reading is still waiting, so this just joins it
+    k_work_schedule_for_queue(zmk_workqueue_input_work_q(), &acc->work,
+                              K_TIMEOUT_ABS_MS(next_event));
+}
+
+#endif // CONFIG_ZMK_KEYMAP_SENSORS_MAX_EVENT_RATE > 0
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SENSORS_INJECT)
+
+#if CONFIG_ZMK_KEYMAP_SENSORS_MAX_EVENT_RATE == 0
+
+// Injected readings come from other threads, and are raised from the input work queue like
+// readings of sensors that trigger from an interrupt.
+struct injected_sensor_value {
+    uint8_t sensor_index;
+    struct sensor_value value;
+};
+
+K_MSGQ_DEFINE(injected_sensor_values, sizeof(struct injected_sensor_value), 16, 4);
+
+static void raise_injected_sensor_values(struct k_work *work) {
+    struct injected_sensor_value injected;
+
+    while (k_msgq_get(&injected_sensor_values, &injected, K_NO_WAIT) == 0) {
+        raise_sensor_value(injected.sensor_index, injected.value);
+    }
+}
+
+K_WORK_DEFINE(injected_sensor_work, raise_injected_sensor_values);
+
+#endif // CONFIG_ZMK_KEYMAP_SENSORS_MAX_EVENT_RATE == 0
+
+int zmk_sensors_inject(uint8_t sensor_index, const struct sensor_value *value) {
+    if (sensor_index >= ARRAY_SIZE(sensors)) {
+        return -EINVAL;
+    }
+
+#if CONFIG_ZMK_KEYMAP_SENSORS_MAX_EVENT_RATE > 0
+    accumulate_sensor_value(sensor_index, value);
+#else
+    struct injected_sensor_value injected = {.sensor_index = sensor_index, .value = *value};
+
+    // Waiting for room makes a fast producer back up instead of losing readings
+    int err = k_msgq_put(&injected_sensor_values, &injected, K_FOREVER);
+    if (err) {
+        return err;
+    }
+
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &injected_sensor_work);
+#endif
+
+    return 0;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SENSORS_INJECT)
+
 static void trigger_sensor_data_for_position(uint32_t sensor_index) {
     int err;
     const struct sensors_item_cfg *item = &sensors[sensor_index];
@@ -81,12 +203,11 @@ static void trigger_sensor_data_for_position(uint32_t sensor_index) {
         return;
     }
 
-    raise_zmk_sensor_event(
-        (struct zmk_sensor_event){.sensor_index = item->sensor_index,
-                                  .channel_data_size = 1,
-                                  .channel_data = {(struct zmk_sensor_channel_data){
-                                      .value = value, .channel = item->trigger.chan}},
-                                  .timestamp = k_uptime_get()});
+#if CONFIG_ZMK_KEYMAP_SENSORS_MAX_EVENT_RATE > 0
+    accumulate_sensor_value(sensor_index, &value);
+#else
+    raise_sensor_value(sensor_index, value);
+#endif
 }
 
 static void run_sensors_data_trigger(struct k_work *work) {
@@ -112,7 +233,7 @@ static void zmk_sensors_trigger_handler(const struct device *dev,
 
     if (k_is_in_isr()) {
         atomic_set_bit(pending_sensors, sensor_index);
-        k_work_submit(&sensor_data_work);
+        k_work_submit_to_queue(zmk_workqueue_input_work_q(), &sensor_data_work);
     } else {
         trigger_sensor_data_for_position(sensor_index);
     }
@@ -121,6 +242,10 @@ static void zmk_sensors_trigger_handler(const struct device *dev,
 static void zmk_sensors_init_item(uint8_t i) {
     LOG_DBG("Init sensor at index %d", i);
 
+#if CONFIG_ZMK_KEYMAP_SENSORS_MAX_EVENT_RATE > 0
+    k_work_init_delayable(&accumulators[i].work, raise_accumulated_sensor_value);
+#endif
+
     if (!sensors[i].dev) {
         LOG_DBG("No local device for %d", i);
         return;
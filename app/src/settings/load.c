@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/settings.h>
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_DEFERRED_LOAD)
+
+#include <zmk/workqueue.h>
+
+// Settings that only change how the keyboard looks. They are loaded from the low priority work
+// queue once everything else, like the keymap and BLE bonds, is loaded and committed.
+static const char *const deferred_subtrees[] = {
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW)
+    "rgb/underglow",
+#endif
+#if IS_ENABLED(CONFIG_ZMK_BACKLIGHT)
+    "backlight",
+#endif
+};
+
+static bool is_deferred(const char *key) {
+    for (int i = 0; i < ARRAY_SIZE(deferred_subtrees); i++) {
+        if (settings_name_steq(key, deferred_subtrees[i], NULL)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static int load_eager_cb(const char *key, size_t len, settings_read_cb read_cb, void *cb_arg,
+                         void *param) {
+    if (is_deferred(key)) {
+        return 0;
+    }
+
+    return settings_call_set_handler(key, len, read_cb, cb_arg, NULL);
+}
+
+static void deferred_load_work_handler(struct k_work *work) {
+    int64_t start = k_uptime_get();
+
+    for (int i = 0; i < ARRAY_SIZE(deferred_subtrees); i++) {
+        int err = settings_load_subtree(deferred_subtrees[i]);
+        if (err < 0) {
+            LOG_ERR("Failed to load %s settings (%d)", deferred_subtrees[i], err);
+        }
+    }
+
+    LOG_INF("Loaded deferred settings in %lld ms", k_uptime_get() - start);
+}
+
+static K_WORK_DEFINE(deferred_load_work, deferred_load_work_handler);
+
+int zmk_settings_load(void) {
+    int64_t start = k_uptime_get();
+
+    int err = settings_load_subtree_direct(NULL, load_eager_cb, NULL);
+    if (err < 0) {
+        return err;
+    }
+
+    err = settings_commit();
+
+    LOG_INF("Loaded settings in %lld ms", k_uptime_get() - start);
+
+    k_work_submit_to_queue(zmk_workqueue_lowprio_work_q(), &deferred_load_work);
+    return err;
+}
+
+#else
+
+int zmk_settings_load(void) {
+    int64_t start = k_uptime_get();
+
+    int err = settings_load();
+
+    LOG_INF("Loaded settings in %lld ms", k_uptime_get() - start);
+    return err;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SETTINGS_DEFERRED_LOAD)
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Settings backend for native builds that keeps all settings in one memory-mapped image file.
+ *
+ * The image is a header followed by an append-only log of records. Saving a key appends a record
+ * and marks the one it replaces, deleting one appends a record with no value, and a load is a
+ * single walk of the log in memory. Once the image is full, the live records are compacted in
+ * place.
+ *
+ * The image is ZMK_SETTINGS_IMAGE, or CONFIG_ZMK_SETTINGS_MMAP_FILE if that is unset. If
+ * ZMK_SETTINGS_TEMPLATE names an image instead, it is mapped copy-on-write: every instance started
+ * from the same template shares its pages, and changes stay private to the instance. Templates
+ * are written by zmk_settings_export().
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/settings.h>
+
+#define IMAGE_MAGIC 0x5a4d4b53 // "ZMKS"
+
+struct image_header {
+    uint32_t magic;
+    // Offset just past the last complete record. It is only advanced once a record is written.
+    uint32_t used;
+};
+
+struct record_header {
+    uint8_t name_len;
+    // Set once a later record of the same key is written.
+    uint8_t replaced;
+    // A record without a value deletes the key.
+    uint16_t val_len;
+};
+
+#define RECORD_SIZE(name_len, val_len)                                                             \
+    ROUND_UP(sizeof(struct record_header) + (name_len) + (val_len), 4)
+
+static uint8_t *image;
+static size_t image_size;
+
+static struct image_header *header(void) { return (struct image_header *)image; }
+
+static struct record_header *record_at(uint32_t off) {
+    return (struct record_header *)(image + off);
+}
+
+static const char *record_name(const struct record_header *rec) {
+    return (const char *)(rec + 1);
+}
+
+static const uint8_t *record_value(const struct record_header *rec) {
+    return (const uint8_t *)(rec + 1) + rec->name_len;
+}
+
+static uint32_t record_next(uint32_t off) {
+    const struct record_header *rec = record_at(off);
+    return off + RECORD_SIZE(rec->name_len, rec->val_len);
+}
+
+static bool record_is(const struct record_header *rec, const char *name, size_t name_len) {
+    return rec->name_len == name_len && memcmp(record_name(rec), name, name_len) == 0;
+}
+
+static struct record_header *find_latest(const char *name, size_t name_len) {
+    for (uint32_t o = sizeof(struct image_header); o < header()->used; o = record_next(o)) {
+        struct record_header *rec = record_at(o);
+        if (!rec->replaced && record_is(rec, name, name_len)) {
+            return rec;
+        }
+    }
+
+    return NULL;
+}
+
+// Moves the live records to the front of the log, dropping replaced ones and deletions.
+static void compact(void) {
+    uint32_t used = header()->used;
+    uint32_t dst = sizeof(struct image_header);
+
+    for (uint32_t o = sizeof(struct image_header); o < used;) {
+        uint32_t next = record_next(o);
+
+        if (record_at(o)->val_len > 0 && !record_at(o)->replaced) {
+            memmove(image + dst, image + o, next - o);
+            dst += next - o;
+        }
+
+        o = next;
+    }
+
+    memset(image + dst, 0, used - dst);
+    header()->used = dst;
+
+    LOG_DBG("Compacted settings image from %u to %u bytes", used, dst);
+}
+
+// Writes a record at the end of the log of img, which must have room for it.
+static void append_record(uint8_t *img, const char *name, size_t name_len, const void *value,
+                          size_t val_len) {
+    struct image_header *hdr = (struct image_header *)img;
+    struct record_header *rec = (struct record_header *)(img + hdr->used);
+
+    memcpy((char *)(rec + 1), name, name_len);
+    memcpy((char *)(rec + 1) + name_len, value, val_len);
+    *rec = (struct record_header){.name_len = name_len, .val_len = val_len};
+
+    hdr->used += RECORD_SIZE(name_len, val_len);
+}
+
+struct value_read_arg {
+    const uint8_t *value;
+    size_t len;
+};
+
+static ssize_t value_read(void *cb_arg, void *data, size_t len) {
+    struct value_read_arg *arg = cb_arg;
+
+    len = MIN(len, arg->len);
+    memcpy(data, arg->value, len);
+    return len;
+}
+
+static int mmap_load(struct settings_store *cs, const struct settings_load_arg *arg) {
+    char name[SETTINGS_MAX_NAME_LEN + 1];
+
+    for (uint32_t o = sizeof(struct image_header); o < header()->used; o = record_next(o)) {
+        const struct record_header *rec = record_at(o);
+        if (rec->val_len == 0 || rec->replaced || rec->name_len > SETTINGS_MAX_NAME_LEN) {
+            continue;
+        }
+
+        memcpy(name, record_name(rec), rec->name_len);
+        name[rec->name_len] = '\0';
+
+        if (arg && arg->subtree && !settings_name_steq(name, arg->subtree, NULL)) {
+            continue;
+        }
+
+        struct value_read_arg read_arg = {.value = record_value(rec), .len = rec->val_len};
+        settings_call_set_handler(name, rec->val_len, value_read, &read_arg, arg);
+    }
+
+    return 0;
+}
+
+static int mmap_save(struct settings_store *cs, const char *name, const char *value,
+                     size_t val_len) {
+    size_t name_len = strlen(name);
+    if (!value) {
+        val_len = 0;
+    }
+
+    if (name_len > UINT8_MAX || val_len > UINT16_MAX) {
+        return -EINVAL;
+    }
+
+    struct record_header *latest = find_latest(name, name_len);
+    if (latest ? latest->val_len == val_len &&
+                     (val_len == 0 || memcmp(record_value(latest), value, val_len) == 0)
+               : val_len == 0) {
+        return 0;
+    }
+
+    size_t size = RECORD_SIZE(name_len, val_len);
+    if (header()->used + size > image_size) {
+        compact();
+        latest = find_latest(name, name_len);
+    }
+
+    if (header()->used + size > image_size) {
+        LOG_ERR("Settings image is full, can't save %s", name);
+        return -ENOSPC;
+    }
+
+    append_record(image, name, name_len, value, val_len);
+
+    // Only mark the old record once the new one is complete, so a key is never left without one.
+    if (latest) {
+        latest->replaced = true;
+    }
+
+    return 0;
+}
+
+static const struct settings_store_itf mmap_itf = {
+    .csi_load = mmap_load,
+    .csi_save = mmap_save,
+};
+
+static struct settings_store mmap_store = {.cs_itf = &mmap_itf};
+
+static int map_image(const char *path, bool private) {
+    int fd = open(path, private ? O_RDONLY : O_RDWR | O_CREAT, 0600);
+    if (fd < 0) {
+        LOG_ERR("Failed to open settings image %s (errno=%d)", path, errno);
+        return -errno;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        int err = -errno;
+        close(fd);
+        return err;
+    }
+
+    image_size = CONFIG_ZMK_SETTINGS_MMAP_SIZE;
+    if (private && st.st_size < image_size) {
+        LOG_ERR("Settings template %s is smaller than %d bytes", path,
+                CONFIG_ZMK_SETTINGS_MMAP_SIZE);
+        close(fd);
+        return -EINVAL;
+    }
+
+    if (!private && st.st_size != image_size && ftruncate(fd, image_size) < 0) {
+        int err = -errno;
+        LOG_ERR("Failed to size settings image %s (errno=%d)", path, errno);
+        close(fd);
+        return err;
+    }
+
+    void *map = mmap(NULL, image_size, PROT_READ | PROT_WRITE,
+                     private ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED) {
+        LOG_ERR("Failed to map settings image %s (errno=%d)", path, errno);
+        return -errno;
+    }
+
+    image = map;
+
+    if (header()->magic != IMAGE_MAGIC || header()->used < sizeof(struct image_header) ||
+        header()->used > image_size) {
+        LOG_INF("Initializing settings image %s", path);
+        memset(image, 0, image_size);
+        *header() = (struct image_header){.magic = IMAGE_MAGIC,
+                                          .used = sizeof(struct image_header)};
+    }
+
+    return 0;
+}
+
+int settings_backend_init(void) {
+    const char *template = getenv("ZMK_SETTINGS_TEMPLATE");
+    const char *path = getenv("ZMK_SETTINGS_IMAGE");
+
+    int err = template && template[0] != '\0'
+                  ? map_image(template, true)
+                  : map_image(path && path[0] != '\0' ? path : CONFIG_ZMK_SETTINGS_MMAP_FILE,
+                              false);
+    if (err < 0) {
+        return err;
+    }
+
+    settings_src_register(&mmap_store);
+    settings_dst_register(&mmap_store);
+    return 0;
+}
+
+int zmk_settings_export(const char *path, const char *name, const void *value, size_t val_len) {
+    size_t name_len = strlen(name);
+
+    if (!image) {
+        return -ENODEV;
+    }
+
+    if (name_len > UINT8_MAX || val_len == 0 || val_len > UINT16_MAX) {
+        return -EINVAL;
+    }
+
+    size_t size = RECORD_SIZE(name_len, val_len);
+    if (header()->used + size > image_size) {
+        compact();
+    }
+
+    if (header()->used + size > image_size) {
+        return -ENOSPC;
+    }
+
+    uint8_t *copy = malloc(image_size);
+    if (!copy) {
+        return -ENOMEM;
+    }
+
+    memcpy(copy, image, image_size);
+
+    const struct record_header *latest = find_latest(name, name_len);
+    if (latest) {
+        ((struct record_header *)(copy + ((const uint8_t *)latest - image)))->replaced = true;
+    }
+
+    append_record(copy, name, name_len, value, val_len);
+
+    int ret = 0;
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        ret = -errno;
+        LOG_ERR("Failed to create settings image %s (errno=%d)", path, errno);
+        goto out;
+    }
+
+    for (size_t written = 0; written < image_size;) {
+        ssize_t len = write(fd, copy + written, image_size - written);
+        if (len < 0) {
+            ret = -errno;
+            LOG_ERR("Failed to write settings image %s (errno=%d)", path, errno);
+            break;
+        }
+
+        written += len;
+    }
+
+    close(fd);
+
+out:
+    free(copy);
+    return ret;
+}
+
+int zmk_settings_erase(void) {
+    LOG_INF("Erasing settings image");
+
+    if (!image) {
+        return -ENODEV;
+    }
+
+    memset(image + sizeof(struct image_header), 0, image_size - sizeof(struct image_header));
+    header()->used = sizeof(struct image_header);
+    return 0;
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/settings.h>
+
+// Values saved through zmk_settings_save() wait here until the save debounce passes, so changes
+// from several subsystems reach flash together in one flush, each key with only its last value.
+// Flushed values stay cached, so saving the same value again is skipped, and a value that is
+// already in flash, e.g. one set back to what it was at boot, isn't written again either.
+
+#define WRITE_BEHIND_NAME_LEN 32
+
+struct write_behind_entry {
+    char name[WRITE_BEHIND_NAME_LEN];
+    uint8_t value[CONFIG_ZMK_SETTINGS_WRITE_BEHIND_VALUE_SIZE];
+    uint16_t len;
+    bool used;
+    bool dirty;
+};
+
+static struct write_behind_entry entries[CONFIG_ZMK_SETTINGS_WRITE_BEHIND_ENTRIES];
+
+static K_MUTEX_DEFINE(entries_mutex);
+
+static void write_behind_flush_work(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(flush_work, write_behind_flush_work);
+
+static struct write_behind_entry *find_entry(const char *name) {
+    for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+        if (entries[i].used && strcmp(entries[i].name, name) == 0) {
+            return &entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+struct stored_value_match {
+    const struct write_behind_entry *entry;
+    bool matches;
+};
+
+static int match_stored_value(const char *key, size_t len, settings_read_cb read_cb, void *cb_arg,
+                              void *param) {
+    struct stored_value_match *match = param;
+    uint8_t stored[CONFIG_ZMK_SETTINGS_WRITE_BEHIND_VALUE_SIZE];
+
+    // Only the key itself, not those below it. Backends that keep older records of the key report
+    // them first, so the last call is the current value.
+    if (key != NULL) {
+        return 0;
+    }
+
+    match->matches = len == match->entry->len && read_cb(cb_arg, stored, len) == len &&
+                     memcmp(stored, match->entry->value, len) == 0;
+    return 0;
+}
+
+static bool is_stored(const struct write_behind_entry *entry) {
+    struct stored_value_match match = {.entry = entry};
+
+    return settings_load_subtree_direct(entry->name, match_stored_value, &match) == 0 &&
+           match.matches;
+}
+
+static int flush_locked(void) {
+    int ret = 0;
+
+    for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+        struct write_behind_entry *entry = &entries[i];
+        if (!entry->used || !entry->dirty) {
+            continue;
+        }
+
+        if (is_stored(entry)) {
+            LOG_DBG("Setting %s is unchanged in flash, not writing it", entry->name);
+            entry->dirty = false;
+            continue;
+        }
+
+        int err = settings_save_one(entry->name, entry->value, entry->len);
+        if (err < 0) {
+            LOG_ERR("Failed to save setting %s (%d)", entry->name, err);
+            ret = err;
+            continue;
+        }
+
+        entry->dirty = false;
+    }
+
+    return ret;
+}
+
+// Finds a slot for a new key, evicting a flushed value if needed. Only if every slot is still
+// waiting to be written does this flush them early.
+static struct write_behind_entry *alloc_entry_locked(void) {
+    struct write_behind_entry *clean = NULL;
+
+    for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+        if (!entries[i].used) {
+            return &entries[i];
+        }
+
+        if (!entries[i].dirty && !clean) {
+            clean = &entries[i];
+        }
+    }
+
+    if (clean) {
+        return clean;
+    }
+
+    LOG_DBG("Settings write-behind cache is full, flushing early");
+    flush_locked();
+
+    for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+        if (!entries[i].dirty) {
+            return &entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void write_behind_flush_work(struct k_work *work) {
+    if (zmk_settings_flush() < 0) {
+        // Failed keys stay dirty, so try them again later.
+        k_work_reschedule(&flush_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
+    }
+}
+
+int zmk_settings_save(const char *name, const void *value, size_t len) {
+    k_mutex_lock(&entries_mutex, K_FOREVER);
+
+    struct write_behind_entry *entry = find_entry(name);
+    if (entry && entry->len == len && memcmp(entry->value, value, len) == 0) {
+        k_mutex_unlock(&entries_mutex);
+        return 0;
+    }
+
+    if (strlen(name) >= WRITE_BEHIND_NAME_LEN || len > sizeof(entry->value)) {
+        // Too large to cache, so write it now. Any cached value for the key is stale.
+        if (entry) {
+            entry->used = false;
+        }
+
+        k_mutex_unlock(&entries_mutex);
+        return settings_save_one(name, value, len);
+    }
+
+    if (!entry) {
+        entry = alloc_entry_locked();
+        if (!entry) {
+            k_mutex_unlock(&entries_mutex);
+            return settings_save_one(name, value, len);
+        }
+
+        strcpy(entry->name, name);
+        entry->used = true;
+    }
+
+    memcpy(entry->value, value, len);
+    entry->len = len;
+    entry->dirty = true;
+
+    k_mutex_unlock(&entries_mutex);
+
+    int ret = k_work_reschedule(&flush_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
+    return MIN(ret, 0);
+}
+
+int zmk_settings_delete(const char *name) {
+    k_mutex_lock(&entries_mutex, K_FOREVER);
+
+    struct write_behind_entry *entry = find_entry(name);
+    if (entry) {
+        entry->used = false;
+    }
+
+    k_mutex_unlock(&entries_mutex);
+
+    return settings_delete(name);
+}
+
+int zmk_settings_flush(void) {
+    k_work_cancel_delayable(&flush_work);
+
+    k_mutex_lock(&entries_mutex, K_FOREVER);
+    int ret = flush_locked();
+    k_mutex_unlock(&entries_mutex);
+
+    return ret;
+}
@@ -19,6 +19,8 @@
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+#include <drivers/behavior.h>
+
 #include <zmk/stdlib.h>
 #include <zmk/ble.h>
 #include <zmk/behavior.h>
@@ -26,13 +28,18 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/split/transport/central.h>
 #include <zmk/split/bluetooth/uuid.h>
 #include <zmk/split/bluetooth/service.h>
+#include <zmk/split/bluetooth/central.h>
+#include <zmk/activity.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/sensor_event.h>
 #include <zmk/events/battery_state_changed.h>
+#include <zmk/events/activity_state_changed.h>
 #include <zmk/pointing/input_split.h>
 #include <zmk/hid_indicators_types.h>
 #include <zmk/physical_layouts.h>
+#include <zmk/work_stats.h>
+#include <zmk/workqueue.h>
 
 static int start_scanning(void);
 
@@ -50,18 +57,39 @@ struct peripheral_slot {
     struct bt_gatt_discover_params discover_params;
     struct bt_gatt_subscribe_params subscribe_params;
     struct bt_gatt_subscribe_params sensor_subscribe_params;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+    struct bt_gatt_subscribe_params edges_subscribe_params;
+    uint8_t next_edge_seq;
+    bool edge_seq_valid;
+    // timestamp of the last edge queued, which later edges are never raised before
+    int64_t last_edge_timestamp;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
     struct bt_gatt_discover_params sub_discover_params;
     uint16_t run_behavior_handle;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
+    uint16_t run_behavior_compact_handle;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
     struct bt_gatt_subscribe_params batt_lvl_subscribe_params;
     struct bt_gatt_read_params batt_lvl_read_params;
 #endif /* IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING) */
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
     uint16_t update_hid_indicators;
+    // last indicators written, valid if hid_indicators_written is set
+    zmk_hid_indicators_t written_hid_indicators;
+    bool hid_indicators_written;
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
     uint16_t selected_physical_layout_handle;
+    // last layout index written, valid if layout_written is set
+    uint8_t written_layout_idx;
+    bool layout_written;
+    // uptime before which no other state setting command is sent
+    int64_t next_state_write_at;
     uint8_t position_state[POSITION_STATE_DATA_LEN];
     uint8_t changed_positions[POSITION_STATE_DATA_LEN];
+    struct zmk_split_bt_link_stats link_stats;
+    // average delay of the link stats, in 1/16 ms
+    uint32_t avg_delay_q4;
 };
 
 #if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
@@ -73,6 +101,8 @@ struct peripheral_input_slot {
     struct bt_conn *conn;
     struct bt_gatt_subscribe_params sub;
     uint8_t reg;
+    // index of the peripheral slot of conn, the source of the input events
+    uint8_t source;
 };
 
 #define COUNT_INPUT_SPLIT(n) +1
@@ -80,6 +110,12 @@ struct peripheral_input_slot {
 static struct peripheral_input_slot
     peripheral_input_slots[(0 DT_FOREACH_STATUS_OKAY(zmk_input_split, COUNT_INPUT_SPLIT))];
 
+BUILD_ASSERT(ARRAY_SIZE(peripheral_input_slots) <= 32, "Too many input split devices");
+
+// Bitmaps of the input slots reserved in total and for each connection, by bt_conn_index()
+static uint32_t reserved_input_slots;
+static uint32_t conn_input_slots[CONFIG_BT_MAX_CONN];
+
 static bool input_slot_is_open(size_t i) {
     return i < ARRAY_SIZE(peripheral_input_slots) && peripheral_input_slots[i].conn == NULL;
 }
@@ -90,26 +126,30 @@ static bool input_slot_is_pending(size_t i) {
             !peripheral_input_slots[i].sub.ccc_handle || !peripheral_input_slots[i].reg);
 }
 
-static int reserve_next_open_input_slot(struct peripheral_input_slot **slot, struct bt_conn *conn) {
-    for (size_t i = 0; i < ARRAY_SIZE(peripheral_input_slots); i++) {
-        if (input_slot_is_open(i)) {
-            peripheral_input_slots[i].conn = conn;
-
-            // Clear out any previously set values
-            peripheral_input_slots[i].sub.value_handle = 0;
-            peripheral_input_slots[i].sub.ccc_handle = 0;
-            peripheral_input_slots[i].reg = 0;
-            *slot = &peripheral_input_slots[i];
-            return i;
-        }
+static int reserve_next_open_input_slot(struct peripheral_input_slot **slot, struct bt_conn *conn,
+                                        uint8_t source) {
+    size_t i = find_lsb_set(~reserved_input_slots) - 1;
+    if (i >= ARRAY_SIZE(peripheral_input_slots)) {
+        return -ENOMEM;
     }
 
-    return -ENOMEM;
+    reserved_input_slots |= BIT(i);
+    conn_input_slots[bt_conn_index(conn)] |= BIT(i);
+    peripheral_input_slots[i].conn = conn;
+    peripheral_input_slots[i].source = source;
+
+    // Clear out any previously set values
+    peripheral_input_slots[i].sub.value_handle = 0;
+    peripheral_input_slots[i].sub.ccc_handle = 0;
+    peripheral_input_slots[i].reg = 0;
+    *slot = &peripheral_input_slots[i];
+    return i;
 }
 
 static int find_pending_input_slot(struct peripheral_input_slot **slot, struct bt_conn *conn) {
-    for (size_t i = 0; i < ARRAY_SIZE(peripheral_input_slots); i++) {
-        if (peripheral_input_slots[i].conn == conn && input_slot_is_pending(i)) {
+    for (uint32_t slots = conn_input_slots[bt_conn_index(conn)]; slots; slots &= slots - 1) {
+        size_t i = __builtin_ctz(slots);
+        if (input_slot_is_pending(i)) {
             *slot = &peripheral_input_slots[i];
             return i;
         }
@@ -119,11 +159,13 @@ static int find_pending_input_slot(struct peripheral_input_slot **slot, struct b
 }
 
 void release_peripheral_input_subs(struct bt_conn *conn) {
-    for (size_t i = 0; i < ARRAY_SIZE(peripheral_input_slots); i++) {
-        if (peripheral_input_slots[i].conn == conn) {
-            peripheral_input_slots[i].conn = NULL;
-            zmk_input_split_peripheral_disconnected(peripheral_input_slots[i].reg);
-        }
+    uint32_t *slots = &conn_input_slots[bt_conn_index(conn)];
+
+    reserved_input_slots &= ~*slots;
+    for (; *slots; *slots &= *slots - 1) {
+        size_t i = __builtin_ctz(*slots);
+        peripheral_input_slots[i].conn = NULL;
+        zmk_input_split_peripheral_disconnected(peripheral_input_slots[i].reg);
     }
 }
 
@@ -140,6 +182,8 @@ static const struct bt_uuid_128 split_service_uuid = BT_UUID_INIT_128(ZMK_SPLIT_
 
 struct peripheral_event_wrapper {
     uint8_t source;
+    // uptime at which the event happened
+    int64_t timestamp;
     struct zmk_split_transport_peripheral_event event;
 };
 
@@ -150,6 +194,35 @@ void peripheral_event_work_callback(struct k_work *work);
 
 K_WORK_DEFINE(peripheral_event_work, peripheral_event_work_callback);
 
+ZMK_WORK_STATS_DEFINE(split_peripheral_events, CONFIG_ZMK_SPLIT_BLE_CENTRAL_POSITION_QUEUE_SIZE);
+
+static atomic_t dropped_peripheral_events;
+
+// Queues an event for peripheral_event_work, which callers submit once after queueing all the
+// events of a notification. Callers run on the Bluetooth RX thread, which must never wait, so
+// when the queue is full the event is dropped and the work submitted early to drain it. Key
+// positions are only recorded in position_state once their event is queued, so the next
+// notification of the peripheral resends a dropped change.
+static int queue_peripheral_event(const struct peripheral_event_wrapper *ev) {
+    // Counted as submitted once queued, since callers submit the work after queueing
+    zmk_work_stats_submit(ZMK_WORK_STATS(split_peripheral_events), 0);
+
+    int err = k_msgq_put(&peripheral_event_msgq, ev, K_NO_WAIT);
+    if (err == -ENOMSG) {
+        k_work_submit_to_queue(zmk_workqueue_input_work_q(), &peripheral_event_work);
+    }
+
+    if (err < 0) {
+        LOG_WRN("Dropped event of type %d from peripheral %d, %ld dropped in total",
+                ev->event.type, ev->source, atomic_inc(&dropped_peripheral_events) + 1);
+    } else {
+        zmk_work_stats_queue_depth(ZMK_WORK_STATS(split_peripheral_events),
+                                   k_msgq_num_used_get(&peripheral_event_msgq));
+    }
+
+    return err;
+}
+
 int peripheral_slot_index_for_conn(struct bt_conn *conn) {
     for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
         if (peripherals[i].conn == conn) {
@@ -195,29 +268,44 @@ int release_peripheral_slot(int index) {
                 uint32_t position = (i * 8) + j;
                 struct peripheral_event_wrapper ev = {
                     .source = index,
+                    .timestamp = k_uptime_get(),
                     .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT,
                               .data = {.key_position_event = {
                                            .position = position,
                                            .pressed = false,
                                        }}}};
 
-                k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-                k_work_submit(&peripheral_event_work);
+                // Kept as pressed if dropped, so reconnecting releases the position instead
+                if (queue_peripheral_event(&ev) == 0) {
+                    WRITE_BIT(slot->position_state[i], j, 0);
+                }
             }
         }
     }
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &peripheral_event_work);
 
     for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
-        slot->position_state[i] = 0U;
         slot->changed_positions[i] = 0U;
     }
 
+    slot->link_stats = (struct zmk_split_bt_link_stats){0};
+
     // Clean up previously discovered handles;
     slot->subscribe_params.value_handle = 0;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+    slot->edges_subscribe_params.value_handle = 0;
+    slot->edge_seq_valid = false;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
     slot->run_behavior_handle = 0;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
+    slot->run_behavior_compact_handle = 0;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
     slot->selected_physical_layout_handle = 0;
+    slot->layout_written = false;
+    slot->next_state_write_at = 0;
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
     slot->update_hid_indicators = 0;
+    slot->hid_indicators_written = false;
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
     return 0;
@@ -288,14 +376,15 @@ static uint8_t split_central_sensor_notify_func(struct bt_conn *conn,
 
     struct peripheral_event_wrapper event_wrapper = {
         .source = peripheral_slot_index_for_conn(conn),
+        .timestamp = k_uptime_get(),
         .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_SENSOR_EVENT,
                   .data = {.sensor_event = {
                                .channel_data = sensor_event.channel_data[0],
                                .sensor_index = sensor_event.sensor_index,
                            }}}};
 
-    k_msgq_put(&peripheral_event_msgq, &event_wrapper, K_NO_WAIT);
-    k_work_submit(&peripheral_event_work);
+    queue_peripheral_event(&event_wrapper);
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &peripheral_event_work);
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -322,24 +411,24 @@ static uint8_t peripheral_input_event_notify_cb(struct bt_conn *conn,
     struct zmk_split_input_event_payload payload;
     memcpy(&payload, data, MIN(length, sizeof(struct zmk_split_input_event_payload)));
 
-    for (size_t i = 0; i < ARRAY_SIZE(peripheral_input_slots); i++) {
-        if (&peripheral_input_slots[i].sub == params) {
-            struct peripheral_event_wrapper event_wrapper = {
-                .source = peripheral_slot_index_for_conn(conn),
-                .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_INPUT_EVENT,
-                          .data = {.input_event = {
-                                       .reg = peripheral_input_slots[i].reg,
-                                       .sync = payload.sync,
-                                       .code = payload.code,
-                                       .type = payload.type,
-                                       .value = payload.value,
-                                   }}}};
-
-            k_msgq_put(&peripheral_event_msgq, &event_wrapper, K_NO_WAIT);
-            k_work_submit(&peripheral_event_work);
-            break;
-        }
-    }
+    // Each input slot subscribes with its own params
+    const struct peripheral_input_slot *input_slot =
+        CONTAINER_OF(params, struct peripheral_input_slot, sub);
+
+    struct peripheral_event_wrapper event_wrapper = {
+        .source = input_slot->source,
+        .timestamp = k_uptime_get(),
+        .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_INPUT_EVENT,
+                  .data = {.input_event = {
+                               .reg = input_slot->reg,
+                               .sync = payload.sync,
+                               .code = payload.code,
+                               .type = payload.type,
+                               .value = payload.value,
+                           }}}};
+
+    queue_peripheral_event(&event_wrapper);
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &peripheral_event_work);
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -366,31 +455,137 @@ static uint8_t split_central_notify_func(struct bt_conn *conn,
 
     for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
         slot->changed_positions[i] = ((uint8_t *)data)[i] ^ slot->position_state[i];
-        slot->position_state[i] = ((uint8_t *)data)[i];
     }
-    LOG_HEXDUMP_DBG(slot->position_state, POSITION_STATE_DATA_LEN, "data");
+    LOG_HEXDUMP_DBG(data, POSITION_STATE_DATA_LEN, "data");
+
+    int source = peripheral_slot_index_for_conn(conn);
+    int64_t now = k_uptime_get();
 
     for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
         for (int j = 0; j < 8; j++) {
             if (slot->changed_positions[i] & BIT(j)) {
                 uint32_t position = (i * 8) + j;
-                bool pressed = slot->position_state[i] & BIT(j);
+                bool pressed = ((uint8_t *)data)[i] & BIT(j);
                 struct peripheral_event_wrapper ev = {
-                    .source = peripheral_slot_index_for_conn(conn),
+                    .source = source,
+                    .timestamp = now,
                     .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT,
                               .data = {.key_position_event = {
                                            .position = position,
                                            .pressed = pressed,
                                        }}}};
-                k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-                k_work_submit(&peripheral_event_work);
+                if (queue_peripheral_event(&ev) == 0) {
+                    WRITE_BIT(slot->position_state[i], j, pressed);
+                }
             }
         }
     }
 
+    // One submission covers every change in the notification
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &peripheral_event_work);
+
     return BT_GATT_ITER_CONTINUE;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+
+static void update_link_delay(struct peripheral_slot *slot, uint16_t delay_ms) {
+    struct zmk_split_bt_link_stats *stats = &slot->link_stats;
+    uint32_t delay_q4 = (uint32_t)delay_ms << 4;
+
+    // An average over roughly the last 8 edges, starting from the first one
+    slot->avg_delay_q4 =
+        stats->edges ? slot->avg_delay_q4 - slot->avg_delay_q4 / 8 + delay_q4 / 8 : delay_q4;
+    stats->avg_delay_ms = (slot->avg_delay_q4 + 8) >> 4;
+    stats->last_delay_ms = delay_ms;
+    stats->max_delay_ms = MAX(stats->max_delay_ms, delay_ms);
+    stats->edges++;
+}
+
+static uint8_t split_central_edges_notify_func(struct bt_conn *conn,
+                                               struct bt_gatt_subscribe_params *params,
+                                               const void *data, uint16_t length) {
+    struct peripheral_slot *slot = peripheral_slot_for_conn(conn);
+
+    if (slot == NULL) {
+        LOG_ERR("No peripheral state found for connection");
+        return BT_GATT_ITER_CONTINUE;
+    }
+
+    if (!data) {
+        LOG_DBG("[UNSUBSCRIBED]");
+        params->value_handle = 0U;
+        return BT_GATT_ITER_STOP;
+    }
+
+    LOG_DBG("[EDGES NOTIFICATION] data %p length %u", data, length);
+
+    const size_t edges_offset = offsetof(struct zmk_split_position_edges_payload, edges);
+    if (length < edges_offset ||
+        (length - edges_offset) % sizeof(struct zmk_split_position_edge) != 0) {
+        LOG_WRN("Ignoring position edges notify with incorrect data length (%d)", length);
+        return BT_GATT_ITER_CONTINUE;
+    }
+
+    // Peripherals with a larger MTU may send more edges than the payload struct holds
+    uint8_t seq = ((const struct zmk_split_position_edges_payload *)data)->seq;
+    const struct zmk_split_position_edge *edges =
+        (const struct zmk_split_position_edge *)((const uint8_t *)data + edges_offset);
+    size_t count = (length - edges_offset) / sizeof(struct zmk_split_position_edge);
+
+    if (slot->edge_seq_valid && seq != slot->next_edge_seq) {
+        uint8_t dropped = seq - slot->next_edge_seq;
+        LOG_WRN("Peripheral dropped %d key position changes", dropped);
+        slot->link_stats.dropped_edges += dropped;
+    }
+    slot->next_edge_seq = seq + count;
+    slot->edge_seq_valid = true;
+
+    int source = peripheral_slot_index_for_conn(conn);
+    int64_t now = k_uptime_get();
+
+    for (size_t i = 0; i < count; i++) {
+        uint8_t position = edges[i].position;
+        uint16_t age_and_state = sys_le16_to_cpu(edges[i].age_and_state);
+        uint16_t age = age_and_state & ZMK_SPLIT_POSITION_EDGE_AGE_MAX;
+        bool pressed = age_and_state & ZMK_SPLIT_POSITION_EDGE_PRESSED;
+
+        update_link_delay(slot, age);
+
+        if (position >= POSITION_STATE_DATA_LEN * 8) {
+            LOG_WRN("Ignoring edge for out of range position %d", position);
+            continue;
+        }
+
+        // After dropped edges, skip the ones that don't change the state we know of
+        if (pressed == !!(slot->position_state[position / 8] & BIT(position % 8))) {
+            continue;
+        }
+
+        // Ages are rounded and capped on the peripheral, so an edge could seem to come before
+        // the one queued ahead of it
+        int64_t timestamp = MAX(now - age, slot->last_edge_timestamp);
+        struct peripheral_event_wrapper ev = {
+            .source = source,
+            .timestamp = timestamp,
+            .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT,
+                      .data = {.key_position_event = {
+                                   .position = position,
+                                   .pressed = pressed,
+                               }}}};
+        if (queue_peripheral_event(&ev) == 0) {
+            WRITE_BIT(slot->position_state[position / 8], position % 8, pressed);
+            slot->last_edge_timestamp = timestamp;
+        }
+    }
+
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &peripheral_event_work);
+
+    return BT_GATT_ITER_CONTINUE;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
 
 static uint8_t split_central_battery_level_notify_func(struct bt_conn *conn,
@@ -420,13 +615,14 @@ static uint8_t split_central_battery_level_notify_func(struct bt_conn *conn,
 
     struct peripheral_event_wrapper ev = {
         .source = peripheral_slot_index_for_conn(conn),
+        .timestamp = k_uptime_get(),
         .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_BATTERY_EVENT,
                   .data = {.battery_event = {
                                .level = battery_level,
                            }}}};
 
-    k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_event_work);
+    queue_peripheral_event(&ev);
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &peripheral_event_work);
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -464,13 +660,14 @@ static uint8_t split_central_battery_level_read_func(struct bt_conn *conn, uint8
 
     struct peripheral_event_wrapper ev = {
         .source = peripheral_slot_index_for_conn(conn),
+        .timestamp = k_uptime_get(),
         .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_BATTERY_EVENT,
                   .data = {.battery_event = {
                                .level = battery_level,
                            }}}};
 
-    k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_event_work);
+    queue_peripheral_event(&ev);
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &peripheral_event_work);
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -511,14 +708,21 @@ static int update_peripheral_selected_layout(struct peripheral_slot *slot, uint8
         return -EAGAIN;
     }
 
+    if (slot->layout_written && slot->written_layout_idx == layout_idx) {
+        return -EALREADY;
+    }
+
     int err = bt_gatt_write_without_response(slot->conn, slot->selected_physical_layout_handle,
                                              &layout_idx, sizeof(layout_idx), true);
 
     if (err < 0) {
         LOG_ERR("Failed to write physical layout index to peripheral (err %d)", err);
+        return err;
     }
 
-    return err;
+    slot->written_layout_idx = layout_idx;
+    slot->layout_written = true;
+    return 0;
 }
 
 static void update_peripherals_selected_physical_layout(struct k_work *_work) {
@@ -540,6 +744,14 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
                                                  struct bt_gatt_discover_params *params) {
     if (!attr) {
         LOG_DBG("Discover complete");
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+        // Peripherals without position edges only get the position state subscription here
+        struct peripheral_slot *slot = peripheral_slot_for_conn(conn);
+        if (slot != NULL && !slot->edges_subscribe_params.value_handle &&
+            slot->subscribe_params.value_handle) {
+            split_central_subscribe(conn, &slot->subscribe_params);
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
         return BT_GATT_ITER_STOP;
     }
 
@@ -567,7 +779,21 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
             slot->subscribe_params.value_handle = bt_gatt_attr_value_handle(attr);
             slot->subscribe_params.notify = split_central_notify_func;
             slot->subscribe_params.value = BT_GATT_CCC_NOTIFY;
-            split_central_subscribe(conn, &slot->subscribe_params);
+            // With position edges, this waits for discovery to show whether the peripheral has them
+            if (!IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)) {
+                split_central_subscribe(conn, &slot->subscribe_params);
+            }
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+        } else if (bt_uuid_cmp(chrc_uuid,
+                               BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_POSITION_EDGES_UUID)) == 0) {
+            LOG_DBG("Found position edges characteristic");
+            slot->edges_subscribe_params.disc_params = &slot->sub_discover_params;
+            slot->edges_subscribe_params.end_handle = slot->discover_params.end_handle;
+            slot->edges_subscribe_params.value_handle = bt_gatt_attr_value_handle(attr);
+            slot->edges_subscribe_params.notify = split_central_edges_notify_func;
+            slot->edges_subscribe_params.value = BT_GATT_CCC_NOTIFY;
+            split_central_subscribe(conn, &slot->edges_subscribe_params);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
 #if ZMK_KEYMAP_HAS_SENSORS
         } else if (bt_uuid_cmp(chrc_uuid,
                                BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_SENSOR_STATE_UUID)) == 0) {
@@ -587,7 +813,8 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
                    0) {
             LOG_DBG("Found an input characteristic");
             struct peripheral_input_slot *input_slot;
-            int ret = reserve_next_open_input_slot(&input_slot, conn);
+            int ret = reserve_next_open_input_slot(&input_slot, conn,
+                                                   peripheral_slot_index_for_conn(conn));
             if (ret < 0) {
                 LOG_WRN("No available slot for peripheral input subscriptions (%d)", ret);
 
@@ -609,6 +836,12 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
             slot->discover_params.uuid = NULL;
             slot->discover_params.start_handle = attr->handle + 2;
             slot->run_behavior_handle = bt_gatt_attr_value_handle(attr);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
+        } else if (bt_uuid_cmp(chrc_uuid, BT_UUID_DECLARE_128(
+                                              ZMK_SPLIT_BT_CHAR_RUN_BEHAVIOR_COMPACT_UUID)) == 0) {
+            LOG_DBG("Found compact run behavior handle");
+            slot->run_behavior_compact_handle = bt_gatt_attr_value_handle(attr);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
         } else if (!bt_uuid_cmp(((struct bt_gatt_chrc *)attr->user_data)->uuid,
                                 BT_UUID_DECLARE_128(ZMK_SPLIT_BT_SELECT_PHYS_LAYOUT_UUID))) {
             LOG_DBG("Found select physical layout handle");
@@ -688,6 +921,14 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
     bool subscribed = slot->run_behavior_handle && slot->subscribe_params.value_handle &&
                       slot->selected_physical_layout_handle;
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+    subscribed = subscribed && slot->edges_subscribe_params.value_handle;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
+    subscribed = subscribed && slot->run_behavior_compact_handle;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
+
 #if ZMK_KEYMAP_HAS_SENSORS
     subscribed = subscribed && slot->sensor_subscribe_params.value_handle;
 #endif /* ZMK_KEYMAP_HAS_SENSORS */
@@ -745,6 +986,39 @@ static uint8_t split_central_service_discovery_func(struct bt_conn *conn,
     return BT_GATT_ITER_STOP;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_IDLE_PARAMS)
+
+// The supervision timeout has to outlast twice the events the peripheral may skip while idle
+BUILD_ASSERT(CONFIG_ZMK_SPLIT_BLE_PREF_TIMEOUT * 4 >
+                 (1 + CONFIG_ZMK_SPLIT_BLE_IDLE_PREF_LATENCY) * CONFIG_ZMK_SPLIT_BLE_IDLE_PREF_INT,
+             "CONFIG_ZMK_SPLIT_BLE_PREF_TIMEOUT is too short for the idle connection parameters");
+
+static void update_peripherals_conn_params(struct k_work *_work) {
+    struct bt_le_conn_param *param =
+        zmk_activity_get_state() == ZMK_ACTIVITY_ACTIVE
+            ? BT_LE_CONN_PARAM(CONFIG_ZMK_SPLIT_BLE_PREF_INT, CONFIG_ZMK_SPLIT_BLE_PREF_INT,
+                               CONFIG_ZMK_SPLIT_BLE_PREF_LATENCY, CONFIG_ZMK_SPLIT_BLE_PREF_TIMEOUT)
+            : BT_LE_CONN_PARAM(CONFIG_ZMK_SPLIT_BLE_IDLE_PREF_INT,
+                               CONFIG_ZMK_SPLIT_BLE_IDLE_PREF_INT,
+                               CONFIG_ZMK_SPLIT_BLE_IDLE_PREF_LATENCY,
+                               CONFIG_ZMK_SPLIT_BLE_PREF_TIMEOUT);
+
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        if (peripherals[i].state != PERIPHERAL_SLOT_STATE_CONNECTED) {
+            continue;
+        }
+
+        int err = bt_conn_le_param_update(peripherals[i].conn, param);
+        if (err < 0 && err != -EALREADY) {
+            LOG_WRN("Failed to update connection params of peripheral %d (err %d)", i, err);
+        }
+    }
+}
+
+K_WORK_DEFINE(update_peripherals_conn_params_work, update_peripherals_conn_params);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_IDLE_PARAMS)
+
 static void split_central_process_connection(struct bt_conn *conn) {
     int err;
 
@@ -777,6 +1051,15 @@ static void split_central_process_connection(struct bt_conn *conn) {
     LOG_DBG("New connection params: Interval: %d, Latency: %d, PHY: %d", info.le.interval,
             info.le.latency, info.le.phy->rx_phy);
 
+    slot->link_stats.interval = info.le.interval;
+    slot->link_stats.latency = info.le.latency;
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_IDLE_PARAMS)
+    if (zmk_activity_get_state() != ZMK_ACTIVITY_ACTIVE) {
+        k_work_submit(&update_peripherals_conn_params_work);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_IDLE_PARAMS)
+
     // Restart scanning if necessary.
     start_scanning();
 }
@@ -959,13 +1242,14 @@ static void split_central_disconnected(struct bt_conn *conn, uint8_t reason) {
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
     struct peripheral_event_wrapper ev = {
         .source = peripheral_slot_index_for_conn(conn),
+        .timestamp = k_uptime_get(),
         .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_BATTERY_EVENT,
                   .data = {.battery_event = {
                                .level = 0,
                            }}}};
 
-    k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_event_work);
+    queue_peripheral_event(&ev);
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &peripheral_event_work);
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
 
 #if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
@@ -1003,10 +1287,25 @@ static void split_central_security_changed(struct bt_conn *conn, bt_security_t l
     k_work_submit(&update_peripherals_selected_layouts_work);
 }
 
+static void split_central_le_param_updated(struct bt_conn *conn, uint16_t interval,
+                                           uint16_t latency, uint16_t timeout) {
+    struct peripheral_slot *slot = peripheral_slot_for_conn(conn);
+    if (slot == NULL) {
+        return;
+    }
+
+    LOG_DBG("Peripheral %d: interval %d latency %d timeout %d",
+            peripheral_slot_index_for_conn(conn), interval, latency, timeout);
+
+    slot->link_stats.interval = interval;
+    slot->link_stats.latency = latency;
+}
+
 static struct bt_conn_cb conn_callbacks = {
     .connected = split_central_connected,
     .disconnected = split_central_disconnected,
     .security_changed = split_central_security_changed,
+    .le_param_updated = split_central_le_param_updated,
 };
 
 K_THREAD_STACK_DEFINE(split_central_split_run_q_stack,
@@ -1014,116 +1313,307 @@ K_THREAD_STACK_DEFINE(split_central_split_run_q_stack,
 
 struct k_work_q split_central_split_run_q;
 
-struct central_cmd_wrapper {
-    uint8_t source;
-    struct zmk_split_transport_central_command cmd;
-};
+void split_central_split_run_callback(struct k_work *work);
 
-K_MSGQ_DEFINE(zmk_split_central_split_run_msgq, sizeof(struct central_cmd_wrapper),
-              CONFIG_ZMK_SPLIT_BLE_CENTRAL_SPLIT_RUN_QUEUE_SIZE, 4);
+K_WORK_DELAYABLE_DEFINE(split_central_split_run_work, split_central_split_run_callback);
 
-void split_central_split_run_callback(struct k_work *work) {
-    struct central_cmd_wrapper payload_wrapper;
+// Commands are queued per peripheral, so a full queue for one doesn't hold up the others, and the
+// work sends one command to each peripheral in turn. State setting commands replace an earlier one
+// with the same effect that hasn't been sent yet, so bursts of global behaviors like RGB changes
+// only send the latest state. Once one is sent, the next waits for the following connection event,
+// which gives later changes, like a host toggling caps lock, that long to replace it.
+#define CMD_QUEUE_SIZE CONFIG_ZMK_SPLIT_BLE_CENTRAL_SPLIT_RUN_QUEUE_SIZE
 
-    LOG_DBG("");
+struct peripheral_cmd_queue {
+    struct zmk_split_transport_central_command cmds[CMD_QUEUE_SIZE];
+    bool idempotent[CMD_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t len;
+};
 
-    while (k_msgq_get(&zmk_split_central_split_run_msgq, &payload_wrapper, K_NO_WAIT) == 0) {
-        if (peripherals[payload_wrapper.source].state != PERIPHERAL_SLOT_STATE_CONNECTED) {
-            LOG_ERR("Source not connected");
-            continue;
-        }
+static struct peripheral_cmd_queue peripheral_cmd_queues[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+static struct k_spinlock peripheral_cmd_queues_lock;
 
-        switch (payload_wrapper.cmd.type) {
-        case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR: {
-            if (!peripherals[payload_wrapper.source].run_behavior_handle) {
-                LOG_ERR("Run behavior handle not found");
-                continue;
-            }
+#define CMD_QUEUE_IDX(queue, i) (((queue)->head + (i)) % CMD_QUEUE_SIZE)
 
-            struct zmk_split_run_behavior_payload payload = {
-                .data = {
-                    .param1 = payload_wrapper.cmd.data.invoke_behavior.param1,
-                    .param2 = payload_wrapper.cmd.data.invoke_behavior.param2,
-                    .position = payload_wrapper.cmd.data.invoke_behavior.position,
-                    .source = payload_wrapper.cmd.data.invoke_behavior.event_source,
-                    .state = payload_wrapper.cmd.data.invoke_behavior.state ? 1 : 0,
-                }};
-            const size_t payload_dev_size = sizeof(payload.behavior_dev);
-            if (strlcpy(payload.behavior_dev, payload_wrapper.cmd.data.invoke_behavior.behavior_dev,
-                        payload_dev_size) >= payload_dev_size) {
-                LOG_ERR("Truncated behavior label %s to %s before invoking peripheral behavior",
-                        payload_wrapper.cmd.data.invoke_behavior.behavior_dev,
-                        payload.behavior_dev);
-            }
+static bool central_cmd_is_idempotent(const struct zmk_split_transport_central_command *cmd) {
+    switch (cmd->type) {
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_PHYSICAL_LAYOUT:
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_HID_INDICATORS:
+        return true;
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR: {
+        struct zmk_behavior_binding binding = {
+            .behavior_dev = cmd->data.invoke_behavior.behavior_dev,
+            .param1 = cmd->data.invoke_behavior.param1,
+            .param2 = cmd->data.invoke_behavior.param2,
+        };
+        struct zmk_behavior_binding_event event = {
+            .position = cmd->data.invoke_behavior.position,
+            .timestamp = k_uptime_get(),
+        };
+
+        return behavior_keymap_binding_is_idempotent(&binding, event) > 0;
+    }
+    default:
+        return false;
+    }
+}
 
-            int err = bt_gatt_write_without_response(
-                peripherals[payload_wrapper.source].conn,
-                peripherals[payload_wrapper.source].run_behavior_handle, &payload,
-                sizeof(struct zmk_split_run_behavior_payload), true);
+// Whether a later command makes an earlier idempotent one redundant
+static bool central_cmd_replaces(const struct zmk_split_transport_central_command *later,
+                                 const struct zmk_split_transport_central_command *earlier) {
+    if (later->type != earlier->type) {
+        return false;
+    }
 
-            if (err) {
-                LOG_ERR("Failed to write the behavior characteristic (err %d)", err);
-            }
-            break;
-        }
-        case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_PHYSICAL_LAYOUT:
-            update_peripheral_selected_layout(
-                &peripherals[payload_wrapper.source],
-                payload_wrapper.cmd.data.set_physical_layout.layout_idx);
-            break;
-#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
-        case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_HID_INDICATORS:
-            LOG_WRN("do the indicators dance");
-            if (peripherals[payload_wrapper.source].update_hid_indicators == 0) {
-                // It appears that sometimes the peripheral is considered connected
-                // before the GATT characteristics have been discovered. If this is
-                // the case, the update_hid_indicators handle will not yet be set.
-                LOG_WRN("NO HANDLE TO SET ON PERIPHERAL");
+    if (later->type != ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR) {
+        return true;
+    }
+
+    return later->data.invoke_behavior.param1 == earlier->data.invoke_behavior.param1 &&
+           later->data.invoke_behavior.state == earlier->data.invoke_behavior.state &&
+           strcmp(later->data.invoke_behavior.behavior_dev,
+                  earlier->data.invoke_behavior.behavior_dev) == 0;
+}
+
+static int queue_peripheral_cmd(uint8_t source, struct zmk_split_transport_central_command cmd) {
+    struct peripheral_cmd_queue *queue = &peripheral_cmd_queues[source];
+    bool idempotent = central_cmd_is_idempotent(&cmd);
+    bool dropped = false;
+
+    k_spinlock_key_t key = k_spin_lock(&peripheral_cmd_queues_lock);
+
+    if (idempotent) {
+        // Drop the earlier command, then queue this one last to keep the order of the others
+        for (int i = 0; i < queue->len; i++) {
+            if (queue->idempotent[CMD_QUEUE_IDX(queue, i)] &&
+                central_cmd_replaces(&cmd, &queue->cmds[CMD_QUEUE_IDX(queue, i)])) {
+                for (int j = i + 1; j < queue->len; j++) {
+                    queue->cmds[CMD_QUEUE_IDX(queue, j - 1)] = queue->cmds[CMD_QUEUE_IDX(queue, j)];
+                    queue->idempotent[CMD_QUEUE_IDX(queue, j - 1)] =
+                        queue->idempotent[CMD_QUEUE_IDX(queue, j)];
+                }
+                queue->len--;
                 break;
             }
+        }
+    }
 
-            int err = bt_gatt_write_without_response(
-                peripherals[payload_wrapper.source].conn,
-                peripherals[payload_wrapper.source].update_hid_indicators,
-                &payload_wrapper.cmd.data.set_hid_indicators.indicators,
-                sizeof(payload_wrapper.cmd.data.set_hid_indicators.indicators), true);
+    if (queue->len == CMD_QUEUE_SIZE) {
+        queue->head = CMD_QUEUE_IDX(queue, 1);
+        queue->len--;
+        dropped = true;
+    }
 
-            if (err) {
-                LOG_ERR("Failed to write HID indicator characteristic (err %d)", err);
-            }
-            break;
-#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
-        default:
-            LOG_WRN("Unsupported wrapped central command type %d", payload_wrapper.cmd.type);
-            return;
+    queue->cmds[CMD_QUEUE_IDX(queue, queue->len)] = cmd;
+    queue->idempotent[CMD_QUEUE_IDX(queue, queue->len)] = idempotent;
+    queue->len++;
+
+    k_spin_unlock(&peripheral_cmd_queues_lock, key);
+
+    if (dropped) {
+        LOG_WRN("Run command queue for peripheral %d full, dropped its oldest command", source);
+    }
+
+    k_work_reschedule_for_queue(&split_central_split_run_q, &split_central_split_run_work,
+                                K_NO_WAIT);
+
+    return 0;
+}
+
+// Returns 1 and the next command, 0 if there's none, or -EAGAIN if the next command sets state and
+// has to wait until the given uptime.
+static int dequeue_peripheral_cmd(uint8_t source, int64_t state_ready_at,
+                                  struct zmk_split_transport_central_command *cmd,
+                                  bool *idempotent) {
+    struct peripheral_cmd_queue *queue = &peripheral_cmd_queues[source];
+    int ret = 0;
+
+    k_spinlock_key_t key = k_spin_lock(&peripheral_cmd_queues_lock);
+
+    if (queue->len > 0) {
+        if (queue->idempotent[queue->head] && k_uptime_get() < state_ready_at) {
+            ret = -EAGAIN;
+        } else {
+            *cmd = queue->cmds[queue->head];
+            *idempotent = queue->idempotent[queue->head];
+            queue->head = CMD_QUEUE_IDX(queue, 1);
+            queue->len--;
+            ret = 1;
         }
     }
+
+    k_spin_unlock(&peripheral_cmd_queues_lock, key);
+
+    return ret;
 }
 
-K_WORK_DEFINE(split_central_split_run_work, split_central_split_run_callback);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
 
-static int split_bt_invoke_behavior_payload(struct central_cmd_wrapper payload_wrapper) {
-    LOG_DBG("");
+// Returns -ENOTSUP if the behavior has to be invoked by name instead, because the peripheral
+// doesn't support local IDs or the behavior has none.
+static int
+invoke_peripheral_behavior_compact(struct peripheral_slot *slot,
+                                   const struct zmk_split_transport_central_command *cmd) {
+    if (!slot->run_behavior_compact_handle) {
+        return -ENOTSUP;
+    }
 
-    int err = k_msgq_put(&zmk_split_central_split_run_msgq, &payload_wrapper, K_MSEC(100));
+    zmk_behavior_local_id_t local_id =
+        zmk_behavior_get_local_id(cmd->data.invoke_behavior.behavior_dev);
+    if (local_id == UINT16_MAX) {
+        return -ENOTSUP;
+    }
+
+    uint8_t buf[ZMK_SPLIT_RUN_BEHAVIOR_COMPACT_MAX_LEN];
+    struct zmk_split_run_behavior_compact_header *header = (void *)buf;
+    *header = (struct zmk_split_run_behavior_compact_header){
+        .local_id = sys_cpu_to_le16(local_id),
+        .position = cmd->data.invoke_behavior.position,
+        .source = cmd->data.invoke_behavior.event_source,
+        .state = cmd->data.invoke_behavior.state ? 1 : 0,
+    };
+
+    size_t len = sizeof(*header);
+    len += zmk_split_varint_put(buf + len, cmd->data.invoke_behavior.param1);
+    len += zmk_split_varint_put(buf + len, cmd->data.invoke_behavior.param2);
+
+    int err = bt_gatt_write_without_response(slot->conn, slot->run_behavior_compact_handle, buf,
+                                             len, true);
     if (err) {
-        switch (err) {
-        case -EAGAIN: {
-            LOG_WRN("Run command message queue full, popping first message and queueing again");
-            struct central_cmd_wrapper discarded_report;
-            k_msgq_get(&zmk_split_central_split_run_msgq, &discarded_report, K_NO_WAIT);
-            return split_bt_invoke_behavior_payload(payload_wrapper);
+        LOG_ERR("Failed to write the compact behavior characteristic (err %d)", err);
+    }
+
+    return err;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
+
+// Returns whether anything was written to the peripheral
+static bool send_peripheral_cmd(uint8_t source,
+                                const struct zmk_split_transport_central_command *cmd) {
+    if (peripherals[source].state != PERIPHERAL_SLOT_STATE_CONNECTED) {
+        LOG_ERR("Source not connected");
+        return false;
+    }
+
+    switch (cmd->type) {
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR: {
+        if (!peripherals[source].run_behavior_handle) {
+            LOG_ERR("Run behavior handle not found");
+            return false;
         }
-        default:
-            LOG_WRN("Failed to queue behavior to send (%d)", err);
-            return err;
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
+        int compact_err = invoke_peripheral_behavior_compact(&peripherals[source], cmd);
+        if (compact_err != -ENOTSUP) {
+            return compact_err == 0;
         }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
+
+        struct zmk_split_run_behavior_payload payload = {
+            .data = {
+                .param1 = cmd->data.invoke_behavior.param1,
+                .param2 = cmd->data.invoke_behavior.param2,
+                .position = cmd->data.invoke_behavior.position,
+                .source = cmd->data.invoke_behavior.event_source,
+                .state = cmd->data.invoke_behavior.state ? 1 : 0,
+            }};
+        const size_t payload_dev_size = sizeof(payload.behavior_dev);
+        if (strlcpy(payload.behavior_dev, cmd->data.invoke_behavior.behavior_dev,
+                    payload_dev_size) >= payload_dev_size) {
+            LOG_ERR("Truncated behavior label %s to %s before invoking peripheral behavior",
+                    cmd->data.invoke_behavior.behavior_dev, payload.behavior_dev);
+        }
+
+        int err = bt_gatt_write_without_response(
+            peripherals[source].conn, peripherals[source].run_behavior_handle, &payload,
+            sizeof(struct zmk_split_run_behavior_payload), true);
+
+        if (err) {
+            LOG_ERR("Failed to write the behavior characteristic (err %d)", err);
+            return false;
+        }
+        return true;
     }
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_PHYSICAL_LAYOUT:
+        return update_peripheral_selected_layout(&peripherals[source],
+                                                 cmd->data.set_physical_layout.layout_idx) == 0;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_HID_INDICATORS: {
+        struct peripheral_slot *slot = &peripherals[source];
+        zmk_hid_indicators_t indicators = cmd->data.set_hid_indicators.indicators;
+
+        if (slot->update_hid_indicators == 0) {
+            // It appears that sometimes the peripheral is considered connected
+            // before the GATT characteristics have been discovered. If this is
+            // the case, the update_hid_indicators handle will not yet be set.
+            LOG_WRN("No HID indicators handle to write on peripheral %d", source);
+            return false;
+        }
 
-    k_work_submit_to_queue(&split_central_split_run_q, &split_central_split_run_work);
+        if (slot->hid_indicators_written && slot->written_hid_indicators == indicators) {
+            return false;
+        }
 
-    return 0;
-};
+        int err = bt_gatt_write_without_response(slot->conn, slot->update_hid_indicators,
+                                                 &indicators, sizeof(indicators), true);
+
+        if (err) {
+            LOG_ERR("Failed to write HID indicator characteristic (err %d)", err);
+            return false;
+        }
+
+        slot->written_hid_indicators = indicators;
+        slot->hid_indicators_written = true;
+        return true;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+    default:
+        LOG_WRN("Unsupported wrapped central command type %d", cmd->type);
+        return false;
+    }
+}
+
+// The connection interval of the peripheral in ms, rounded up
+static int64_t peripheral_conn_interval_ms(uint8_t source) {
+    return DIV_ROUND_UP(peripherals[source].link_stats.interval * 5, 4);
+}
+
+void split_central_split_run_callback(struct k_work *work) {
+    bool sent;
+    int64_t next_ready_at = INT64_MAX;
+
+    LOG_DBG("");
+
+    do {
+        sent = false;
+        for (uint8_t i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+            struct zmk_split_transport_central_command cmd;
+            bool idempotent;
+            int64_t ready_at = peripherals[i].next_state_write_at;
+
+            int ret = dequeue_peripheral_cmd(i, ready_at, &cmd, &idempotent);
+            if (ret == -EAGAIN) {
+                next_ready_at = MIN(next_ready_at, ready_at);
+                continue;
+            }
+
+            if (ret > 0) {
+                if (send_peripheral_cmd(i, &cmd) && idempotent) {
+                    peripherals[i].next_state_write_at =
+                        k_uptime_get() + peripheral_conn_interval_ms(i);
+                }
+                sent = true;
+            }
+        }
+    } while (sent);
+
+    if (next_ready_at != INT64_MAX) {
+        k_work_schedule_for_queue(&split_central_split_run_q, &split_central_split_run_work,
+                                  K_MSEC(MAX(next_ready_at - k_uptime_get(), 0)));
+    }
+}
 
 static int finish_init();
 
@@ -1161,11 +1651,32 @@ static int zmk_split_bt_central_listener_cb(const zmk_event_t *eh) {
     if (as_zmk_physical_layout_selection_changed(eh)) {
         k_work_submit(&update_peripherals_selected_layouts_work);
     }
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_IDLE_PARAMS)
+    if (as_zmk_activity_state_changed(eh)) {
+        k_work_submit(&update_peripherals_conn_params_work);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_IDLE_PARAMS)
     return ZMK_EV_EVENT_BUBBLE;
 }
 
 ZMK_LISTENER(zmk_split_bt_central, zmk_split_bt_central_listener_cb);
 ZMK_SUBSCRIPTION(zmk_split_bt_central, zmk_physical_layout_selection_changed);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_IDLE_PARAMS)
+ZMK_SUBSCRIPTION(zmk_split_bt_central, zmk_activity_state_changed);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_IDLE_PARAMS)
+
+int zmk_split_bt_central_get_link_stats(uint8_t source, struct zmk_split_bt_link_stats *stats) {
+    if (source >= ARRAY_SIZE(peripherals)) {
+        return -EINVAL;
+    }
+
+    if (peripherals[source].state != PERIPHERAL_SLOT_STATE_CONNECTED) {
+        return -ENOTCONN;
+    }
+
+    *stats = peripherals[source].link_stats;
+    return 0;
+}
 
 static int split_central_bt_send_command(uint8_t source,
                                          struct zmk_split_transport_central_command cmd) {
@@ -1177,8 +1688,7 @@ static int split_central_bt_send_command(uint8_t source,
     case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_HID_INDICATORS:
     case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_PHYSICAL_LAYOUT:
     case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR: {
-        struct central_cmd_wrapper wrapper = {.source = source, .cmd = cmd};
-        return split_bt_invoke_behavior_payload(wrapper);
+        return queue_peripheral_cmd(source, cmd);
     }
     case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_POLL_EVENTS:
         return -ENOTSUP;
@@ -1282,9 +1792,14 @@ static int finish_init() {
 }
 
 void peripheral_event_work_callback(struct k_work *work) {
+    uint32_t start = zmk_work_stats_run_start(ZMK_WORK_STATS(split_peripheral_events));
     struct peripheral_event_wrapper ev;
+
     while (k_msgq_get(&peripheral_event_msgq, &ev, K_NO_WAIT) == 0) {
         LOG_DBG("Trigger key position state change of type %d", ev.event.type);
-        zmk_split_transport_central_peripheral_event_handler(&bt_central, ev.source, ev.event);
+        zmk_split_transport_central_peripheral_event_handler_at(&bt_central, ev.source, ev.event,
+                                                                ev.timestamp);
     }
+
+    zmk_work_stats_run_end(ZMK_WORK_STATS(split_peripheral_events), start);
 }
@@ -66,6 +66,12 @@ static ssize_t split_svc_run_behavior(struct bt_conn *conn, const struct bt_gatt
                                       const void *buf, uint16_t len, uint16_t offset,
                                       uint8_t flags);
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
+static ssize_t split_svc_run_behavior_compact(struct bt_conn *conn,
+                                              const struct bt_gatt_attr *attrs, const void *buf,
+                                              uint16_t len, uint16_t offset, uint8_t flags);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
+
 static ssize_t split_svc_num_of_positions(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
                                           void *buf, uint16_t len, uint16_t offset) {
     return bt_gatt_attr_read(conn, attrs, buf, len, offset, attrs->user_data, sizeof(uint8_t));
@@ -75,6 +81,18 @@ static void split_svc_pos_state_ccc(const struct bt_gatt_attr *attr, uint16_t va
     LOG_DBG("value %d", value);
 }
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+
+// Set while the central is subscribed to position edges, which then replace the bitmap.
+static bool position_edges_enabled;
+
+static void split_svc_pos_edges_ccc(const struct bt_gatt_attr *attr, uint16_t value) {
+    LOG_DBG("value %d", value);
+    position_edges_enabled = (value == BT_GATT_CCC_NOTIFY);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
 static zmk_hid_indicators_t hid_indicators = 0;
@@ -205,7 +223,18 @@ BT_GATT_SERVICE_DEFINE(
                            BT_GATT_CHRC_WRITE | BT_GATT_CHRC_READ,
                            BT_GATT_PERM_WRITE_ENCRYPT | BT_GATT_PERM_READ_ENCRYPT,
                            split_svc_get_selected_phys_layout, split_svc_select_phys_layout,
-                           NULL), );
+                           NULL),
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+    BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_POSITION_EDGES_UUID),
+                           BT_GATT_CHRC_NOTIFY, BT_GATT_PERM_READ_ENCRYPT, NULL, NULL, NULL),
+    BT_GATT_CCC(split_svc_pos_edges_ccc, BT_GATT_PERM_READ_ENCRYPT | BT_GATT_PERM_WRITE_ENCRYPT),
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
+    BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_RUN_BEHAVIOR_COMPACT_UUID),
+                           BT_GATT_CHRC_WRITE_WITHOUT_RESP, BT_GATT_PERM_WRITE_ENCRYPT, NULL,
+                           split_svc_run_behavior_compact, NULL),
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
+);
 
 K_THREAD_STACK_DEFINE(service_q_stack, CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_STACK_SIZE);
 
@@ -248,13 +277,104 @@ int send_position_state() {
     return 0;
 }
 
-static int zmk_split_bt_position_pressed(uint8_t position) {
-    WRITE_BIT(position_state[position / 8], position % 8, true);
-    return send_position_state();
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+
+struct position_edge {
+    int64_t timestamp;
+    uint8_t seq;
+    uint8_t position;
+    bool pressed;
+};
+
+K_MSGQ_DEFINE(position_edges_msgq, sizeof(struct position_edge),
+              CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_POSITION_QUEUE_SIZE, 4);
+
+// Every queued edge takes a sequence number, so the central can tell when some were dropped.
+static uint8_t next_position_edge_seq;
+
+static void send_position_edges_callback(struct k_work *work) {
+    struct position_edge edge;
+    int ret = k_msgq_get(&position_edges_msgq, &edge, K_NO_WAIT);
+
+    while (ret == 0) {
+        struct zmk_split_position_edges_payload payload = {.seq = edge.seq};
+        int64_t now = k_uptime_get();
+        size_t count = 0;
+
+        // Pack consecutive edges only, since the payload carries the sequence number of the first
+        do {
+            uint16_t age = MIN(now - edge.timestamp, ZMK_SPLIT_POSITION_EDGE_AGE_MAX);
+            payload.edges[count++] = (struct zmk_split_position_edge){
+                .position = edge.position,
+                .age_and_state =
+                    sys_cpu_to_le16(age | (edge.pressed ? ZMK_SPLIT_POSITION_EDGE_PRESSED : 0)),
+            };
+            ret = k_msgq_get(&position_edges_msgq, &edge, K_NO_WAIT);
+        } while (ret == 0 && count < ZMK_SPLIT_POSITION_EDGES_MAX &&
+                 edge.seq == (uint8_t)(payload.seq + count));
+
+        const struct bt_gatt_attr *attr =
+            bt_gatt_find_by_uuid(split_svc.attrs, split_svc.attr_count,
+                                 BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_POSITION_EDGES_UUID));
+        int err = bt_gatt_notify(NULL, attr, &payload,
+                                 offsetof(struct zmk_split_position_edges_payload, edges) +
+                                     count * sizeof(struct zmk_split_position_edge));
+        if (err) {
+            LOG_DBG("Error notifying %d", err);
+        }
+    }
 }
 
-static int zmk_split_bt_position_released(uint8_t position) {
-    WRITE_BIT(position_state[position / 8], position % 8, false);
+// Runs a coalescing window after the first edge queued since the last notification, so the edges
+// of keys rolled within it go out together.
+K_WORK_DELAYABLE_DEFINE(service_position_edges_notify_work, send_position_edges_callback);
+
+static int send_position_edge(struct position_edge *edge) {
+    int err = k_msgq_put(&position_edges_msgq, edge, K_MSEC(100));
+    if (err) {
+        switch (err) {
+        case -EAGAIN: {
+            LOG_WRN("Position edge message queue full, popping first message and queueing again");
+            struct position_edge discarded_edge;
+            k_msgq_get(&position_edges_msgq, &discarded_edge, K_NO_WAIT);
+            return send_position_edge(edge);
+        }
+        default:
+            LOG_WRN("Failed to queue position edge to send (%d)", err);
+            return err;
+        }
+    }
+
+    if (k_msgq_num_used_get(&position_edges_msgq) >= ZMK_SPLIT_POSITION_EDGES_MAX) {
+        // A full notification is ready, no point in waiting for more.
+        k_work_reschedule_for_queue(&service_work_q, &service_position_edges_notify_work,
+                                    K_NO_WAIT);
+    } else {
+        k_work_schedule_for_queue(&service_work_q, &service_position_edges_notify_work,
+                                  K_MSEC(CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_POSITION_COALESCE_MS));
+    }
+
+    return 0;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+
+static int zmk_split_bt_position_changed(uint8_t position, bool pressed) {
+    WRITE_BIT(position_state[position / 8], position % 8, pressed);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+    if (position_edges_enabled) {
+        struct position_edge edge = {
+            .timestamp = k_uptime_get(),
+            .seq = next_position_edge_seq++,
+            .position = position,
+            .pressed = pressed,
+        };
+
+        return send_position_edge(&edge);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EDGES)
+
     return send_position_state();
 }
 
@@ -349,11 +469,8 @@ int zmk_split_transport_peripheral_bt_report_event(
     const struct zmk_split_transport_peripheral_event *ev) {
     switch (ev->type) {
     case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT:
-        if (ev->data.key_position_event.pressed) {
-            zmk_split_bt_position_pressed(ev->data.key_position_event.position);
-        } else {
-            zmk_split_bt_position_released(ev->data.key_position_event.position);
-        }
+        zmk_split_bt_position_changed(ev->data.key_position_event.position,
+                                      ev->data.key_position_event.pressed);
         break;
 #if ZMK_KEYMAP_HAS_SENSORS
     case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_SENSOR_EVENT:
@@ -434,4 +551,66 @@ static ssize_t split_svc_run_behavior(struct bt_conn *conn, const struct bt_gatt
     }
 
     return len;
-}
\ No newline at end of file
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
+
+static ssize_t split_svc_run_behavior_compact(struct bt_conn *conn,
+                                              const struct bt_gatt_attr *attrs, const void *buf,
+                                              uint16_t len, uint16_t offset, uint8_t flags) {
+    const struct zmk_split_run_behavior_compact_header *header = buf;
+    const size_t header_len = sizeof(struct zmk_split_run_behavior_compact_header);
+
+    LOG_DBG("offset %d len %d", offset, len);
+
+    // Always fits in one write, so there's nothing to reassemble
+    if (offset != 0) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+    }
+
+    if (len < header_len) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+    }
+
+    const uint8_t *params = (const uint8_t *)buf + header_len;
+    size_t params_len = len - header_len;
+    uint32_t param1, param2;
+
+    size_t param1_len = zmk_split_varint_get(params, params_len, &param1);
+    if (param1_len == 0 ||
+        zmk_split_varint_get(params + param1_len, params_len - param1_len, &param2) == 0) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+    }
+
+    zmk_behavior_local_id_t local_id = sys_le16_to_cpu(header->local_id);
+    const char *behavior_dev = zmk_behavior_find_behavior_name_from_local_id(local_id);
+    if (!behavior_dev) {
+        LOG_ERR("No behavior with local ID %d to invoke", local_id);
+        return len;
+    }
+
+    struct zmk_split_transport_central_command cmd = {
+        .type = ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR,
+        .data = {.invoke_behavior = {
+                     .param1 = param1,
+                     .param2 = param2,
+                     .position = header->position,
+                     .event_source = header->source,
+                     .state = header->state,
+                 }}};
+
+    strlcpy(cmd.data.invoke_behavior.behavior_dev, behavior_dev,
+            sizeof(cmd.data.invoke_behavior.behavior_dev));
+
+    LOG_DBG("%s with params %d %d: pressed? %d", behavior_dev, param1, param2, header->state);
+
+    int err =
+        zmk_split_transport_peripheral_command_handler(zmk_split_transport_peripheral_bt(), cmd);
+    if (err) {
+        LOG_ERR("Failed to invoke behavior %s: %d", behavior_dev, err);
+    }
+
+    return len;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_COMPACT_RUN_BEHAVIOR)
\ No newline at end of file
@@ -11,6 +11,7 @@
 #include <zmk/split/central.h>
 #include <zmk/hid_indicators_types.h>
 #include <zmk/pointing/input_split.h>
+#include <zmk/position_state.h>
 
 #include <zephyr/logging/log.h>
 
@@ -32,6 +33,13 @@ static uint8_t peripheral_battery_levels[ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT] = {
 int zmk_split_transport_central_peripheral_event_handler(
     const struct zmk_split_transport_central *transport, uint8_t source,
     struct zmk_split_transport_peripheral_event ev) {
+    return zmk_split_transport_central_peripheral_event_handler_at(transport, source, ev,
+                                                                   k_uptime_get());
+}
+
+int zmk_split_transport_central_peripheral_event_handler_at(
+    const struct zmk_split_transport_central *transport, uint8_t source,
+    struct zmk_split_transport_peripheral_event ev, int64_t timestamp) {
     if (transport != active_transport) {
         // Ignoring events from non-active transport
         LOG_WRN("Ignoring peripheral event from non-active transport");
@@ -39,11 +47,14 @@ int zmk_split_transport_central_peripheral_event_handler(
     }
     switch (ev.type) {
     case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT: {
+        // An edge that happened on the peripheral before a key that was already processed still
+        // arrives after it, and timeouts resolved by timestamp must not see time run backwards.
+        timestamp = MAX(timestamp, zmk_position_state_last_timestamp());
         struct zmk_position_state_changed state_ev = {.source = source,
                                                       .position =
                                                           ev.data.key_position_event.position,
                                                       .state = ev.data.key_position_event.pressed,
-                                                      .timestamp = k_uptime_get()};
+                                                      .timestamp = timestamp};
         return raise_zmk_position_state_changed(state_ev);
     }
 #if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
@@ -55,22 +66,21 @@ int zmk_split_transport_central_peripheral_event_handler(
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
     case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_BATTERY_EVENT: {
-        struct zmk_peripheral_battery_state_changed battery_ev = {
-            .source = source,
-            .state_of_charge = ev.data.battery_event.level,
-        };
+        ZMK_EVENT_INIT(zmk_peripheral_battery_state_changed, battery_ev);
+        battery_ev.data.source = source;
+        battery_ev.data.state_of_charge = ev.data.battery_event.level;
         peripheral_battery_levels[source] = ev.data.battery_event.level;
-        return raise_zmk_peripheral_battery_state_changed(battery_ev);
+        return ZMK_EVENT_RAISE(battery_ev);
     }
 #endif
     case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_SENSOR_EVENT: {
-        struct zmk_sensor_event sensor_ev = {.sensor_index = ev.data.sensor_event.sensor_index,
-                                             .channel_data_size = 1,
-                                             .timestamp = k_uptime_get()};
-
-        sensor_ev.channel_data[0] = ev.data.sensor_event.channel_data;
+        ZMK_EVENT_INIT(zmk_sensor_event, sensor_ev);
+        sensor_ev.data.sensor_index = ev.data.sensor_event.sensor_index;
+        sensor_ev.data.channel_data_size = 1;
+        sensor_ev.data.timestamp = timestamp;
+        sensor_ev.data.channel_data[0] = ev.data.sensor_event.channel_data;
 
-        return raise_zmk_sensor_event(sensor_ev);
+        return ZMK_EVENT_RAISE(sensor_ev);
     }
     default:
         LOG_WRN("GOT AN UNKNOWN EVENT TYPE %d", ev.type);
@@ -120,10 +130,10 @@ int zmk_split_central_update_hid_indicator(zmk_hid_indicators_t indicators) {
 
     uint8_t source_ids[ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT];
 
-    int ret = active_transport->api->get_available_source_ids(source_ids);
+    int count = active_transport->api->get_available_source_ids(source_ids);
 
-    if (ret < 0) {
-        return ret;
+    if (count < 0) {
+        return count;
     }
 
     struct zmk_split_transport_central_command command =
@@ -138,8 +148,8 @@ int zmk_split_central_update_hid_indicator(zmk_hid_indicators_t indicators) {
                 },
         };
 
-    for (size_t i = 0; i < ret; i++) {
-        ret = active_transport->api->send_command(source_ids[i], command);
+    for (size_t i = 0; i < count; i++) {
+        int ret = active_transport->api->send_command(source_ids[i], command);
         if (ret < 0) {
             return ret;
         }
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <zephyr/types.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/matrix.h>
+#include <zmk/split/transport/central.h>
+
+#include "ipc.h"
+
+// The central listens on the socket, and each peripheral that connects gets the first free
+// source, until the connection closes.
+
+#define PERIPHERAL_COUNT CONFIG_ZMK_SPLIT_IPC_CENTRAL_PERIPHERALS
+
+static int peripheral_fds[PERIPHERAL_COUNT] = {[0 ... PERIPHERAL_COUNT - 1] = -1};
+
+static K_MUTEX_DEFINE(peripheral_fds_lock);
+
+static atomic_t connected_count;
+
+// positions pressed by each peripheral, as delivered, to release them if it disconnects
+static ATOMIC_DEFINE(pressed_positions[PERIPHERAL_COUNT], ZMK_KEYMAP_LEN);
+
+static void notify_status_work_cb(struct k_work *work);
+
+static K_WORK_DEFINE(notify_status_work, notify_status_work_cb);
+
+static int split_central_ipc_send_command(uint8_t source,
+                                          struct zmk_split_transport_central_command cmd) {
+    if (source >= PERIPHERAL_COUNT) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&peripheral_fds_lock, K_FOREVER);
+
+    int err = -ENOTCONN;
+    if (peripheral_fds[source] >= 0) {
+        err = zmk_split_ipc_send(peripheral_fds[source], &cmd, sizeof(cmd));
+    }
+
+    k_mutex_unlock(&peripheral_fds_lock);
+
+    if (err < 0) {
+        LOG_WRN("Failed to send command %d to peripheral %d (%d)", cmd.type, source, err);
+    }
+
+    return err;
+}
+
+static int split_central_ipc_get_available_source_ids(uint8_t *sources) {
+    int count = 0;
+
+    k_mutex_lock(&peripheral_fds_lock, K_FOREVER);
+
+    for (uint8_t i = 0; i < PERIPHERAL_COUNT; i++) {
+        if (peripheral_fds[i] >= 0) {
+            sources[count++] = i;
+        }
+    }
+
+    k_mutex_unlock(&peripheral_fds_lock);
+
+    return count;
+}
+
+static zmk_split_transport_central_status_changed_cb_t transport_status_cb;
+
+static int
+split_central_ipc_set_status_callback(zmk_split_transport_central_status_changed_cb_t cb) {
+    transport_status_cb = cb;
+    return 0;
+}
+
+static struct zmk_split_transport_status split_central_ipc_get_status(void) {
+    int connected = atomic_get(&connected_count);
+    enum zmk_split_transport_connections_status connections =
+        ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_SOME_CONNECTED;
+
+    if (connected == 0) {
+        connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_DISCONNECTED;
+    } else if (connected == PERIPHERAL_COUNT) {
+        connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED;
+    }
+
+    return (struct zmk_split_transport_status){
+        .available = true,
+        .enabled = true,
+        .connections = connections,
+    };
+}
+
+static const struct zmk_split_transport_central_api central_api = {
+    .send_command = split_central_ipc_send_command,
+    .get_available_source_ids = split_central_ipc_get_available_source_ids,
+    .set_status_callback = split_central_ipc_set_status_callback,
+    .get_status = split_central_ipc_get_status,
+};
+
+ZMK_SPLIT_TRANSPORT_CENTRAL_REGISTER(ipc_central, &central_api, CONFIG_ZMK_SPLIT_IPC_PRIORITY);
+
+static void notify_status_work_cb(struct k_work *work) {
+    if (transport_status_cb) {
+        transport_status_cb(&ipc_central, split_central_ipc_get_status());
+    }
+}
+
+static void release_pressed_positions(uint8_t source) {
+    for (uint32_t position = 0; position < ZMK_KEYMAP_LEN; position++) {
+        if (!atomic_test_and_clear_bit(pressed_positions[source], position)) {
+            continue;
+        }
+
+        struct zmk_split_transport_peripheral_event ev = {
+            .type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT,
+            .data = {.key_position_event = {.position = position, .pressed = false}},
+        };
+        zmk_split_transport_central_peripheral_event_handler(&ipc_central, source, ev);
+    }
+}
+
+void zmk_split_ipc_deliver_frame(const struct zmk_split_ipc_frame *frame) {
+    if (frame->type == ZMK_SPLIT_IPC_FRAME_DISCONNECTED) {
+        release_pressed_positions(frame->source);
+        return;
+    }
+
+    const struct zmk_split_transport_peripheral_event *ev = &frame->data.event;
+    if (ev->type == ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT &&
+        ev->data.key_position_event.position < ZMK_KEYMAP_LEN) {
+        atomic_set_bit_to(pressed_positions[frame->source], ev->data.key_position_event.position,
+                          ev->data.key_position_event.pressed);
+    }
+
+    zmk_split_transport_central_peripheral_event_handler(&ipc_central, frame->source, *ev);
+}
+
+static void set_peripheral_fd(uint8_t source, int fd) {
+    k_mutex_lock(&peripheral_fds_lock, K_FOREVER);
+    peripheral_fds[source] = fd;
+    k_mutex_unlock(&peripheral_fds_lock);
+
+    atomic_add(&connected_count, fd >= 0 ? 1 : -1);
+    k_work_submit(&notify_status_work);
+}
+
+static void accept_peripherals(int server_fd) {
+    for (;;) {
+        int fd = accept(server_fd, NULL, NULL);
+        if (fd < 0) {
+            return;
+        }
+
+        uint8_t source = PERIPHERAL_COUNT;
+        for (uint8_t i = 0; i < PERIPHERAL_COUNT; i++) {
+            if (peripheral_fds[i] < 0) {
+                source = i;
+                break;
+            }
+        }
+
+        if (source == PERIPHERAL_COUNT) {
+            LOG_WRN("Rejecting peripheral, all %d sources are connected", PERIPHERAL_COUNT);
+            close(fd);
+            continue;
+        }
+
+        zmk_split_ipc_set_nonblocking(fd);
+        set_peripheral_fd(source, fd);
+        LOG_INF("Peripheral connected as source %d", source);
+    }
+}
+
+static void service_peripheral(uint8_t source) {
+    struct zmk_split_ipc_frame frame = {
+        .type = ZMK_SPLIT_IPC_FRAME_EVENT,
+        .source = source,
+    };
+
+    for (;;) {
+        int len = zmk_split_ipc_recv(peripheral_fds[source], &frame.data.event,
+                                     sizeof(frame.data.event));
+        if (len == -EAGAIN) {
+            return;
+        }
+
+        if (len < 0) {
+            LOG_INF("Peripheral at source %d disconnected", source);
+            int fd = peripheral_fds[source];
+            set_peripheral_fd(source, -1);
+            close(fd);
+
+            frame.type = ZMK_SPLIT_IPC_FRAME_DISCONNECTED;
+            zmk_split_ipc_queue_frame(&frame);
+            return;
+        }
+
+        if (len != sizeof(frame.data.event)) {
+            LOG_WRN("Ignoring %d byte message from peripheral %d", len, source);
+            continue;
+        }
+
+        zmk_split_ipc_queue_frame(&frame);
+    }
+}
+
+static int open_server_socket(void) {
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if (fd < 0) {
+        LOG_ERR("Failed to create the split IPC socket (errno=%d)", errno);
+        return -errno;
+    }
+
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    strncpy(addr.sun_path, CONFIG_ZMK_SPLIT_IPC_SOCKET_PATH, sizeof(addr.sun_path) - 1);
+    unlink(CONFIG_ZMK_SPLIT_IPC_SOCKET_PATH);
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, PERIPHERAL_COUNT) < 0) {
+        int err = errno;
+        LOG_ERR("Failed to listen on %s (errno=%d)", CONFIG_ZMK_SPLIT_IPC_SOCKET_PATH, err);
+        close(fd);
+        return -err;
+    }
+
+    zmk_split_ipc_set_nonblocking(fd);
+    return fd;
+}
+
+// Sockets are polled without blocking, since a blocking host call stops the whole simulated
+// kernel.
+static void split_central_ipc_thread_func(void *a, void *b, void *c) {
+    int server_fd = open_server_socket();
+    if (server_fd < 0) {
+        return;
+    }
+
+    LOG_DBG("Waiting for peripherals on %s", CONFIG_ZMK_SPLIT_IPC_SOCKET_PATH);
+
+    for (;;) {
+        accept_peripherals(server_fd);
+
+        for (uint8_t i = 0; i < PERIPHERAL_COUNT; i++) {
+            if (peripheral_fds[i] >= 0) {
+                service_peripheral(i);
+            }
+        }
+
+        k_sleep(K_MSEC(CONFIG_ZMK_SPLIT_IPC_POLL_INTERVAL_MS));
+    }
+}
+
+K_THREAD_DEFINE(split_central_ipc_thread, CONFIG_ZMK_SPLIT_IPC_THREAD_STACK_SIZE,
+                split_central_ipc_thread_func, NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO,
+                0, 0);
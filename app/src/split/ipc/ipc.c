@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+
+#include <sys/socket.h>
+#include <fcntl.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "ipc.h"
+
+K_MSGQ_DEFINE(delayed_frames, sizeof(struct zmk_split_ipc_frame), CONFIG_ZMK_SPLIT_IPC_QUEUE_SIZE,
+              8);
+
+static void deliver_frames_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(deliver_frames_work, deliver_frames_work_cb);
+
+static void deliver_frames_work_cb(struct k_work *work) {
+    struct zmk_split_ipc_frame frame;
+
+    while (k_msgq_peek(&delayed_frames, &frame) == 0) {
+        int64_t now = k_uptime_get();
+        if (frame.deliver_at > now) {
+            k_work_schedule(&deliver_frames_work, K_MSEC(frame.deliver_at - now));
+            return;
+        }
+
+        k_msgq_get(&delayed_frames, &frame, K_NO_WAIT);
+        zmk_split_ipc_deliver_frame(&frame);
+    }
+}
+
+// A fixed seed makes the frames dropped and the jitter applied the same on every run, given the
+// same traffic.
+static uint32_t random_state = CONFIG_ZMK_SPLIT_IPC_RANDOM_SEED;
+
+static uint32_t next_random(void) {
+    // xorshift32
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+// Frames are delivered in the order they were received, as on the real transports, so jitter
+// never moves a frame ahead of the one before it.
+static int64_t last_deliver_at;
+
+void zmk_split_ipc_queue_frame(struct zmk_split_ipc_frame *frame) {
+    if (frame->type != ZMK_SPLIT_IPC_FRAME_DISCONNECTED && CONFIG_ZMK_SPLIT_IPC_LOSS_PERMILLE > 0 &&
+        next_random() % 1000 < CONFIG_ZMK_SPLIT_IPC_LOSS_PERMILLE) {
+        LOG_DBG("Dropping frame from source %d", frame->source);
+        return;
+    }
+
+    int64_t latency = CONFIG_ZMK_SPLIT_IPC_LATENCY_MS;
+    if (CONFIG_ZMK_SPLIT_IPC_LATENCY_JITTER_MS > 0) {
+        latency += next_random() % (CONFIG_ZMK_SPLIT_IPC_LATENCY_JITTER_MS + 1);
+    }
+
+    frame->deliver_at = MAX(k_uptime_get() + latency, last_deliver_at);
+
+    int err = k_msgq_put(&delayed_frames, frame, K_NO_WAIT);
+    if (err < 0) {
+        LOG_WRN("Dropping frame from source %d, the delivery queue is full", frame->source);
+        return;
+    }
+
+    last_deliver_at = frame->deliver_at;
+
+    // Doesn't move an earlier delivery already scheduled, which is at most this one's time
+    k_work_schedule(&deliver_frames_work, K_NO_WAIT);
+}
+
+void zmk_split_ipc_set_nonblocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+int zmk_split_ipc_recv(int fd, void *buf, size_t size) {
+    // With MSG_TRUNC, the full size of a message too long for the buffer is returned
+    ssize_t len = recv(fd, buf, size, MSG_DONTWAIT | MSG_TRUNC);
+    if (len < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return -EAGAIN;
+        }
+
+        return -ECONNRESET;
+    }
+
+    if (len == 0) {
+        return -ECONNRESET;
+    }
+
+    return len;
+}
+
+int zmk_split_ipc_send(int fd, const void *buf, size_t size) {
+    ssize_t len = send(fd, buf, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (len < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? -EAGAIN : -errno;
+    }
+
+    return 0;
+}
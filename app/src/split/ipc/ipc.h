@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <zephyr/types.h>
+
+#include <zmk/split/transport/types.h>
+
+// Each central command and peripheral event is sent as one SOCK_SEQPACKET message holding the
+// transport struct as is. Both halves are built from the same tree for the same host, so the
+// layout always matches, and a message of any other size is rejected.
+
+enum zmk_split_ipc_frame_type {
+    ZMK_SPLIT_IPC_FRAME_COMMAND,
+    ZMK_SPLIT_IPC_FRAME_EVENT,
+    // Queued when a connection closes, behind the frames that were still in flight on it
+    ZMK_SPLIT_IPC_FRAME_DISCONNECTED,
+};
+
+struct zmk_split_ipc_frame {
+    int64_t deliver_at;
+    enum zmk_split_ipc_frame_type type;
+    uint8_t source;
+    union {
+        struct zmk_split_transport_central_command cmd;
+        struct zmk_split_transport_peripheral_event event;
+    } data;
+};
+
+// Implemented by the role specific side, called from the system work queue once the injected
+// latency of the frame has passed.
+void zmk_split_ipc_deliver_frame(const struct zmk_split_ipc_frame *frame);
+
+// Applies the injected loss and latency to a received frame, and queues it for delivery.
+// Disconnection frames are never dropped.
+void zmk_split_ipc_queue_frame(struct zmk_split_ipc_frame *frame);
+
+void zmk_split_ipc_set_nonblocking(int fd);
+
+// Returns the size of the message received, -EAGAIN if there is none, or -ECONNRESET once the
+// other side closed the connection.
+int zmk_split_ipc_recv(int fd, void *buf, size_t size);
+
+int zmk_split_ipc_send(int fd, const void *buf, size_t size);
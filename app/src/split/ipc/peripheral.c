@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <zephyr/types.h>
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/split/transport/peripheral.h>
+
+#include "ipc.h"
+
+// The peripheral connects to the socket of the central, and tries again every
+// CONFIG_ZMK_SPLIT_IPC_RECONNECT_INTERVAL_MS until it's listening.
+
+static int central_fd = -1;
+
+static K_MUTEX_DEFINE(central_fd_lock);
+
+static void notify_status_work_cb(struct k_work *work);
+
+static K_WORK_DEFINE(notify_status_work, notify_status_work_cb);
+
+static int
+split_peripheral_ipc_report_event(const struct zmk_split_transport_peripheral_event *ev) {
+    k_mutex_lock(&central_fd_lock, K_FOREVER);
+
+    int err = -ENOTCONN;
+    if (central_fd >= 0) {
+        err = zmk_split_ipc_send(central_fd, ev, sizeof(*ev));
+    }
+
+    k_mutex_unlock(&central_fd_lock);
+
+    if (err < 0) {
+        LOG_WRN("Failed to send event %d to the central (%d)", ev->type, err);
+    }
+
+    return err;
+}
+
+static zmk_split_transport_peripheral_status_changed_cb_t transport_status_cb;
+
+static int
+split_peripheral_ipc_set_status_callback(zmk_split_transport_peripheral_status_changed_cb_t cb) {
+    transport_status_cb = cb;
+    return 0;
+}
+
+static struct zmk_split_transport_status split_peripheral_ipc_get_status(void) {
+    return (struct zmk_split_transport_status){
+        .available = true,
+        .enabled = true,
+        .connections = central_fd >= 0 ? ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED
+                                       : ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_DISCONNECTED,
+    };
+}
+
+static const struct zmk_split_transport_peripheral_api peripheral_api = {
+    .report_event = split_peripheral_ipc_report_event,
+    .set_status_callback = split_peripheral_ipc_set_status_callback,
+    .get_status = split_peripheral_ipc_get_status,
+};
+
+ZMK_SPLIT_TRANSPORT_PERIPHERAL_REGISTER(ipc_peripheral, &peripheral_api,
+                                        CONFIG_ZMK_SPLIT_IPC_PRIORITY);
+
+static void notify_status_work_cb(struct k_work *work) {
+    if (transport_status_cb) {
+        transport_status_cb(&ipc_peripheral, split_peripheral_ipc_get_status());
+    }
+}
+
+void zmk_split_ipc_deliver_frame(const struct zmk_split_ipc_frame *frame) {
+    if (frame->type == ZMK_SPLIT_IPC_FRAME_COMMAND) {
+        zmk_split_transport_peripheral_command_handler(&ipc_peripheral, frame->data.cmd);
+    }
+}
+
+static void set_central_fd(int fd) {
+    k_mutex_lock(&central_fd_lock, K_FOREVER);
+    central_fd = fd;
+    k_mutex_unlock(&central_fd_lock);
+
+    k_work_submit(&notify_status_work);
+}
+
+static int connect_central(void) {
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if (fd < 0) {
+        LOG_ERR("Failed to create the split IPC socket (errno=%d)", errno);
+        return -errno;
+    }
+
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    strncpy(addr.sun_path, CONFIG_ZMK_SPLIT_IPC_SOCKET_PATH, sizeof(addr.sun_path) - 1);
+
+    // Connecting to a Unix socket doesn't wait on the other side, only on its listen queue
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        int err = errno;
+        close(fd);
+        return -err;
+    }
+
+    zmk_split_ipc_set_nonblocking(fd);
+    return fd;
+}
+
+static void service_central(void) {
+    struct zmk_split_ipc_frame frame = {.type = ZMK_SPLIT_IPC_FRAME_COMMAND};
+
+    for (;;) {
+        int len = zmk_split_ipc_recv(central_fd, &frame.data.cmd, sizeof(frame.data.cmd));
+        if (len == -EAGAIN) {
+            return;
+        }
+
+        if (len < 0) {
+            LOG_INF("Central disconnected");
+            int fd = central_fd;
+            set_central_fd(-1);
+            close(fd);
+            return;
+        }
+
+        if (len != sizeof(frame.data.cmd)) {
+            LOG_WRN("Ignoring %d byte message from the central", len);
+            continue;
+        }
+
+        zmk_split_ipc_queue_frame(&frame);
+    }
+}
+
+// Sockets are polled without blocking, since a blocking host call stops the whole simulated
+// kernel.
+static void split_peripheral_ipc_thread_func(void *a, void *b, void *c) {
+    int64_t next_connect_at = 0;
+
+    for (;;) {
+        if (central_fd < 0 && k_uptime_get() >= next_connect_at) {
+            int fd = connect_central();
+            if (fd >= 0) {
+                LOG_INF("Connected to the central at %s", CONFIG_ZMK_SPLIT_IPC_SOCKET_PATH);
+                set_central_fd(fd);
+            } else {
+                next_connect_at = k_uptime_get() + CONFIG_ZMK_SPLIT_IPC_RECONNECT_INTERVAL_MS;
+            }
+        }
+
+        if (central_fd >= 0) {
+            service_central();
+        }
+
+        k_sleep(K_MSEC(CONFIG_ZMK_SPLIT_IPC_POLL_INTERVAL_MS));
+    }
+}
+
+K_THREAD_DEFINE(split_peripheral_ipc_thread, CONFIG_ZMK_SPLIT_IPC_THREAD_STACK_SIZE,
+                split_peripheral_ipc_thread_func, NULL, NULL, NULL,
+                K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
@@ -461,6 +461,15 @@ static void notify_transport_status(void) {
 
 #endif
 
+static void publish_event_frame(const uint8_t *payload, size_t payload_size) {
+    // Shorter events only fill the start of the payload
+    struct event_payload event_payload = {0};
+    memcpy(&event_payload, payload, payload_size);
+
+    zmk_split_transport_central_peripheral_event_handler(&wired_central, event_payload.source,
+                                                         event_payload.event);
+}
+
 static void publish_events_work(struct k_work *work) {
 
 #if IS_HALF_DUPLEX_MODE
@@ -468,20 +477,5 @@ static void publish_events_work(struct k_work *work) {
                       K_MSEC(CONFIG_ZMK_SPLIT_WIRED_HALF_DUPLEX_RX_COMPLETE_TIMEOUT));
 #endif // IS_HALF_DUPLEX_MODE
 
-    while (ring_buf_size_get(&rx_buf) > MSG_EXTRA_SIZE) {
-        struct event_envelope env;
-        int item_err =
-            zmk_split_wired_get_item(&rx_buf, (uint8_t *)&env, sizeof(struct event_envelope));
-        switch (item_err) {
-        case 0:
-            zmk_split_transport_central_peripheral_event_handler(&wired_central, env.payload.source,
-                                                                 env.payload.event);
-            break;
-        case -EAGAIN:
-            return;
-        default:
-            LOG_WRN("Issue fetching an item from the RX buffer: %d", item_err);
-            return;
-        }
-    }
+    zmk_split_wired_process_frames(&rx_buf, sizeof(struct event_payload), publish_event_frame);
 }
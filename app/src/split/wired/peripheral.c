@@ -420,32 +420,28 @@ static void notify_transport_status(void) {
 
 #endif // HAS_DETECT_GPIO
 
-static void process_tx_cb(void) {
-    while (ring_buf_size_get(&chosen_rx_buf) > MSG_EXTRA_SIZE) {
-        struct command_envelope env;
-        int item_err = zmk_split_wired_get_item(&chosen_rx_buf, (uint8_t *)&env,
-                                                sizeof(struct command_envelope));
-        switch (item_err) {
-        case 0:
-            if (env.payload.cmd.type == ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_POLL_EVENTS) {
-                begin_tx();
-            } else {
-                int ret = k_msgq_put(&cmd_msg_queue, &env.payload.cmd, K_NO_WAIT);
-                if (ret < 0) {
-                    LOG_WRN("Failed to queue command for processing (%d)", ret);
-                    return;
-                }
-
-                k_work_submit(&publish_commands);
-            }
-            break;
-        case -EAGAIN:
-            return;
-        default:
-            LOG_WRN("Issue fetching an item from the RX buffer: %d", item_err);
-            return;
-        }
+static void process_command_frame(const uint8_t *payload, size_t payload_size) {
+    // Shorter commands only fill the start of the payload
+    struct command_payload command_payload = {0};
+    memcpy(&command_payload, payload, payload_size);
+
+    if (command_payload.cmd.type == ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_POLL_EVENTS) {
+        begin_tx();
+        return;
+    }
+
+    int ret = k_msgq_put(&cmd_msg_queue, &command_payload.cmd, K_NO_WAIT);
+    if (ret < 0) {
+        LOG_WRN("Failed to queue command for processing (%d)", ret);
+        return;
     }
+
+    k_work_submit(&publish_commands);
+}
+
+static void process_tx_cb(void) {
+    zmk_split_wired_process_frames(&chosen_rx_buf, sizeof(struct command_payload),
+                                   process_command_frame);
 }
 static void publish_commands_work(struct k_work *work) {
     struct zmk_split_transport_central_command cmd;
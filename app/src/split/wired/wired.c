@@ -18,7 +18,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 void zmk_split_wired_poll_out(struct ring_buf *tx_buf, const struct device *uart) {
     uint8_t *buf;
     uint32_t claim_len;
-    while ((claim_len = ring_buf_get_claim(tx_buf, &buf, MIN(32, tx_buf->size))) > 0) {
+    while ((claim_len = ring_buf_get_claim(tx_buf, &buf, tx_buf->size)) > 0) {
         LOG_HEXDUMP_DBG(buf, claim_len, "TX Bytes");
         for (int i = 0; i < claim_len; i++) {
             uart_poll_out(uart, buf[i]);
@@ -270,58 +270,86 @@ int zmk_split_wired_async_init(struct zmk_split_wired_async_state *state) {
 
 #endif
 
-int zmk_split_wired_get_item(struct ring_buf *rx_buf, uint8_t *env, size_t env_size) {
-    while (ring_buf_size_get(rx_buf) > sizeof(struct msg_prefix) + sizeof(struct msg_postfix)) {
-        struct msg_prefix prefix;
+// Points *view at the first len bytes of the RX buffer, in place unless they wrap around the end
+// of its storage, in which case they're copied to scratch. Nothing is consumed from the buffer,
+// and since only the reader consumes, the view stays valid until it does.
+static int rx_buf_view(struct ring_buf *rx_buf, size_t len, uint8_t **view, uint8_t *scratch) {
+    if (ring_buf_size_get(rx_buf) < len) {
+        return -EAGAIN;
+    }
+
+    uint32_t claimed = ring_buf_get_claim(rx_buf, view, len);
+    ring_buf_get_finish(rx_buf, 0);
+
+    if (claimed < len) {
+        ring_buf_peek(rx_buf, scratch, len);
+        *view = scratch;
+    }
+
+    return 0;
+}
 
-        __ASSERT_EVAL(
-            (void)ring_buf_peek(rx_buf, (uint8_t *)&prefix, sizeof(prefix)),
-            uint32_t peek_read = ring_buf_peek(rx_buf, (uint8_t *)&prefix, sizeof(prefix)),
-            peek_read == sizeof(prefix), "Somehow read less than we expect from the RX buffer");
+int zmk_split_wired_process_frames(struct ring_buf *rx_buf, size_t max_payload_size,
+                                   zmk_split_wired_frame_cb_t cb) {
+    __ASSERT(max_payload_size + MSG_EXTRA_SIZE <= MSG_MAX_SIZE, "Payload too big for the scratch");
 
-        if (memcmp(&prefix.magic_prefix, &ZMK_SPLIT_WIRED_ENVELOPE_MAGIC_PREFIX,
-                   sizeof(prefix.magic_prefix)) != 0) {
-            uint8_t discarded_byte;
-            ring_buf_get(rx_buf, &discarded_byte, 1);
+    uint8_t scratch[MSG_MAX_SIZE];
 
-            LOG_WRN("Prefix mismatch, discarding byte %0x", discarded_byte);
+    while (ring_buf_size_get(rx_buf) > 0) {
+        uint8_t *data;
 
+        // Skip straight to the next byte that could start a prefix
+        uint32_t len = ring_buf_get_claim(rx_buf, &data, ring_buf_size_get(rx_buf));
+        uint8_t *start = memchr(data, ZMK_SPLIT_WIRED_ENVELOPE_MAGIC_PREFIX[0], len);
+        uint32_t skip = start ? start - data : len;
+        ring_buf_get_finish(rx_buf, skip);
+
+        if (skip > 0) {
+            LOG_WRN("Prefix mismatch, discarding %d bytes", skip);
             continue;
         }
 
-        size_t payload_to_read = sizeof(prefix) + prefix.payload_size;
+        uint8_t *frame;
+        int ret = rx_buf_view(rx_buf, sizeof(struct msg_prefix), &frame, scratch);
+        if (ret < 0) {
+            return ret;
+        }
 
-        if (payload_to_read > env_size) {
-            LOG_WRN("Invalid message with payload %d bigger than expected max %d", payload_to_read,
-                    env_size);
-            return -EINVAL;
+        const struct msg_prefix *prefix = (const struct msg_prefix *)frame;
+        if (memcmp(prefix->magic_prefix, ZMK_SPLIT_WIRED_ENVELOPE_MAGIC_PREFIX,
+                   sizeof(prefix->magic_prefix)) != 0) {
+            ring_buf_get(rx_buf, NULL, 1);
+            continue;
         }
 
-        if (ring_buf_size_get(rx_buf) < payload_to_read + sizeof(struct msg_postfix)) {
-            return -EAGAIN;
+        size_t payload_size = prefix->payload_size;
+        if (payload_size > max_payload_size) {
+            LOG_WRN("Invalid message with payload %d bigger than expected max %d", payload_size,
+                    max_payload_size);
+            ring_buf_get(rx_buf, NULL, 1);
+            continue;
         }
 
-        // Now that prefix matches, read it out so we can read the rest of the payload.
-        __ASSERT_EVAL((void)ring_buf_get(rx_buf, env, payload_to_read),
-                      uint32_t read = ring_buf_get(rx_buf, env, payload_to_read),
-                      read == payload_to_read,
-                      "Somehow read less than we expect from the RX buffer");
+        size_t frame_size = MSG_EXTRA_SIZE + payload_size;
+        ret = rx_buf_view(rx_buf, frame_size, &frame, scratch);
+        if (ret < 0) {
+            return ret;
+        }
 
         struct msg_postfix postfix;
-        __ASSERT_EVAL((void)ring_buf_get(rx_buf, (uint8_t *)&postfix, sizeof(postfix)),
-                      uint32_t read = ring_buf_get(rx_buf, (uint8_t *)&postfix, sizeof(postfix)),
-                      read == sizeof(postfix),
-                      "Somehow read less of the postfix than we expect from the RX buffer");
+        memcpy(&postfix, frame + frame_size - sizeof(postfix), sizeof(postfix));
 
-        uint32_t crc = crc32_ieee(env, payload_to_read);
+        uint32_t crc = crc32_ieee(frame, sizeof(struct msg_prefix) + payload_size);
         if (crc != postfix.crc) {
-            LOG_WRN("Data corruption in received peripheral event, ignoring %d vs %d", crc,
-                    postfix.crc);
-            return -EINVAL;
+            LOG_WRN("Data corruption in received message, ignoring %d vs %d", crc, postfix.crc);
+            // The prefix may have been part of another frame, so look for the next one from here
+            ring_buf_get(rx_buf, NULL, 1);
+            continue;
         }
 
-        return 0;
+        cb(frame + sizeof(struct msg_prefix), payload_size);
+        ring_buf_get(rx_buf, NULL, frame_size);
     }
 
     return -EAGAIN;
-}
\ No newline at end of file
+}
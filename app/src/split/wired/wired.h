@@ -43,6 +43,8 @@ struct msg_postfix {
 } __packed;
 
 #define MSG_EXTRA_SIZE (sizeof(struct msg_prefix) + sizeof(struct msg_postfix))
+#define MSG_MAX_SIZE                                                                               \
+    (MSG_EXTRA_SIZE + MAX(sizeof(struct command_payload), sizeof(struct event_payload)))
 
 typedef void (*zmk_split_wired_process_tx_callback_t)(void);
 
@@ -93,4 +95,11 @@ int zmk_split_wired_async_rx_cancel(struct zmk_split_wired_async_state *state);
 
 #endif
 
-int zmk_split_wired_get_item(struct ring_buf *rx_buf, uint8_t *env, size_t env_size);
\ No newline at end of file
+// Called with the payload of each valid frame, which is only valid until the callback returns.
+typedef void (*zmk_split_wired_frame_cb_t)(const uint8_t *payload, size_t payload_size);
+
+// Dispatches every complete frame in the RX buffer to the callback, reading them in place, and
+// discards any bytes that aren't part of a frame with a payload up to max_payload_size bytes and a
+// valid CRC. Returns -EAGAIN once the rest of the buffer is an incomplete frame, if any.
+int zmk_split_wired_process_frames(struct ring_buf *rx_buf, size_t max_payload_size,
+                                   zmk_split_wired_frame_cb_t cb);
\ No newline at end of file
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include <zmk/stage_timing.h>
+
+static const char *const stage_names[ZMK_STAGE_COUNT] = {
+    [ZMK_STAGE_KSCAN_QUEUE] = "kscan_queue",
+    [ZMK_STAGE_POSITION_DISPATCH] = "position_dispatch",
+    [ZMK_STAGE_BEHAVIOR] = "behavior",
+    [ZMK_STAGE_KEYCODE] = "keycode",
+    [ZMK_STAGE_ENDPOINT_SEND] = "endpoint_send",
+};
+
+static struct zmk_stage_timing timings[ZMK_STAGE_COUNT];
+// Samples come from the system work queue, the kscan callbacks and the IPC threads
+static struct k_spinlock timings_lock;
+
+static inline uint8_t bucket_of(uint32_t cycles) {
+    if (cycles == 0) {
+        return 0;
+    }
+
+    return MIN(32 - __builtin_clz(cycles), ZMK_STAGE_TIMING_BUCKETS - 1);
+}
+
+void zmk_stage_timing_end(enum zmk_stage stage, uint32_t start) {
+    uint32_t cycles = k_cycle_get_32() - start;
+    struct zmk_stage_timing *timing = &timings[stage];
+
+    k_spinlock_key_t key = k_spin_lock(&timings_lock);
+    timing->samples++;
+    timing->total_cycles += cycles;
+    timing->max_cycles = MAX(timing->max_cycles, cycles);
+    timing->buckets[bucket_of(cycles)]++;
+    k_spin_unlock(&timings_lock, key);
+}
+
+const char *zmk_stage_timing_name(enum zmk_stage stage) { return stage_names[stage]; }
+
+void zmk_stage_timing_get(enum zmk_stage stage, struct zmk_stage_timing *timing) {
+    k_spinlock_key_t key = k_spin_lock(&timings_lock);
+    *timing = timings[stage];
+    k_spin_unlock(&timings_lock, key);
+}
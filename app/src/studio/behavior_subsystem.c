@@ -161,7 +161,110 @@ static bool encode_behavior_name(pb_ostream_t *stream, const pb_field_t *field,
     return pb_encode_string(stream, zbm->metadata.display_name, strlen(zbm->metadata.display_name));
 }
 
-static struct encode_metadata_sets_state state = {};
+#if CONFIG_ZMK_STUDIO_BEHAVIOR_METADATA_CACHE_SIZE > 0
+
+// The encoded metadata field of each behavior already sent, since it never changes at runtime and
+// is requested for every behavior each time Studio connects. Entries are appended as behaviors are
+// first requested, until the blob is full, after which the rest are encoded on every request.
+struct metadata_cache_entry_header {
+    zmk_behavior_local_id_t local_id;
+    uint16_t len;
+} __packed;
+
+static uint8_t metadata_cache[CONFIG_ZMK_STUDIO_BEHAVIOR_METADATA_CACHE_SIZE];
+static size_t metadata_cache_len;
+
+static const uint8_t *find_cached_metadata(zmk_behavior_local_id_t local_id, size_t *len) {
+    size_t offset = 0;
+
+    while (offset < metadata_cache_len) {
+        struct metadata_cache_entry_header header;
+        memcpy(&header, &metadata_cache[offset], sizeof(header));
+        offset += sizeof(header);
+
+        if (header.local_id == local_id) {
+            *len = header.len;
+            return &metadata_cache[offset];
+        }
+
+        offset += header.len;
+    }
+
+    return NULL;
+}
+
+static const uint8_t *cache_metadata(zmk_behavior_local_id_t local_id, const pb_field_t *field,
+                                     struct encode_metadata_sets_state *state, size_t *len) {
+    struct metadata_cache_entry_header header = {.local_id = local_id};
+    if (metadata_cache_len + sizeof(header) >= sizeof(metadata_cache)) {
+        return NULL;
+    }
+
+    uint8_t *data = &metadata_cache[metadata_cache_len + sizeof(header)];
+    size_t space = MIN(sizeof(metadata_cache) - metadata_cache_len - sizeof(header), UINT16_MAX);
+    pb_ostream_t stream = pb_ostream_from_buffer(data, space);
+
+    void *arg = state;
+    if (!encode_metadata_sets(&stream, field, &arg)) {
+        LOG_DBG("No room to cache the metadata of behavior %d", local_id);
+        return NULL;
+    }
+
+    header.len = stream.bytes_written;
+    memcpy(&metadata_cache[metadata_cache_len], &header, sizeof(header));
+    metadata_cache_len += sizeof(header) + header.len;
+
+    *len = header.len;
+    return data;
+}
+
+#endif // CONFIG_ZMK_STUDIO_BEHAVIOR_METADATA_CACHE_SIZE > 0
+
+struct encode_metadata_state {
+    zmk_behavior_local_id_t local_id;
+    const struct device *device;
+    struct encode_metadata_sets_state sets;
+};
+
+static bool encode_metadata(pb_ostream_t *stream, const pb_field_t *field, void *const *arg) {
+    struct encode_metadata_state *state = (struct encode_metadata_state *)*arg;
+
+#if CONFIG_ZMK_STUDIO_BEHAVIOR_METADATA_CACHE_SIZE > 0
+    size_t len;
+    const uint8_t *cached = find_cached_metadata(state->local_id, &len);
+#else
+    const uint8_t *cached = NULL;
+#endif // CONFIG_ZMK_STUDIO_BEHAVIOR_METADATA_CACHE_SIZE > 0
+
+    // Only fetched once a response is actually encoded without its cached metadata
+    if (!cached && !state->sets.sets) {
+        struct behavior_parameter_metadata desc = {0};
+        int ret = behavior_get_parameter_metadata(state->device, &desc);
+        if (ret < 0) {
+            LOG_DBG("Failed to fetch the metadata for behavior %d! %d", state->local_id, ret);
+        } else {
+            LOG_DBG("Got metadata with %d sets", desc.sets_len);
+        }
+
+        state->sets.sets = desc.sets;
+        state->sets.sets_len = desc.sets_len;
+    }
+
+#if CONFIG_ZMK_STUDIO_BEHAVIOR_METADATA_CACHE_SIZE > 0
+    if (!cached) {
+        cached = cache_metadata(state->local_id, field, &state->sets, &len);
+    }
+
+    if (cached) {
+        return pb_write(stream, cached, len);
+    }
+#endif // CONFIG_ZMK_STUDIO_BEHAVIOR_METADATA_CACHE_SIZE > 0
+
+    void *sets_arg = &state->sets;
+    return encode_metadata_sets(stream, field, &sets_arg);
+}
+
+static struct encode_metadata_state state = {};
 
 zmk_studio_Response get_behavior_details(const zmk_studio_Request *req) {
     uint32_t behavior_id = req->subsystem.behaviors.request_type.get_behavior_details.behavior_id;
@@ -186,24 +289,18 @@ zmk_studio_Response get_behavior_details(const zmk_studio_Request *req) {
 
     __ASSERT(zbm != NULL, "Can't find a device without also having metadata");
 
-    struct behavior_parameter_metadata desc = {0};
-    int ret = behavior_get_parameter_metadata(device, &desc);
-    if (ret < 0) {
-        LOG_DBG("Failed to fetch the metadata for %s! %d", zbm->metadata.display_name, ret);
-    } else {
-        LOG_DBG("Got metadata with %d sets", desc.sets_len);
-    }
-
     zmk_behaviors_GetBehaviorDetailsResponse resp =
         zmk_behaviors_GetBehaviorDetailsResponse_init_zero;
     resp.id = behavior_id;
     resp.display_name.funcs.encode = encode_behavior_name;
     resp.display_name.arg = zbm;
 
-    state.sets = desc.sets;
-    state.sets_len = desc.sets_len;
+    state = (struct encode_metadata_state){
+        .local_id = behavior_id,
+        .device = device,
+    };
 
-    resp.metadata.funcs.encode = encode_metadata_sets;
+    resp.metadata.funcs.encode = encode_metadata;
     resp.metadata.arg = &state;
 
     return BEHAVIOR_RESPONSE(get_behavior_details, resp);
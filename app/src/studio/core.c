@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <string.h>
+
 #include <zmk/studio/core.h>
 
 ZMK_EVENT_IMPL(zmk_studio_core_lock_state_changed);
@@ -12,17 +14,36 @@ static enum zmk_studio_core_lock_state state = IS_ENABLED(CONFIG_ZMK_STUDIO_LOCK
                                                    ? ZMK_STUDIO_CORE_LOCK_STATE_LOCKED
                                                    : ZMK_STUDIO_CORE_LOCK_STATE_UNLOCKED;
 
+#if CONFIG_ZMK_STUDIO_LOCK_RESUME_TIMEOUT_SEC > 0
+
+// The unlocked session of a host that disconnected, kept until it reconnects or the resume
+// timeout passes. While it's suspended, the state reads as locked.
+static struct {
+    bool suspended;
+    uint8_t peer_len;
+    uint8_t peer[16];
+} session;
+
+enum zmk_studio_core_lock_state zmk_studio_core_get_lock_state(void) {
+    return session.suspended ? ZMK_STUDIO_CORE_LOCK_STATE_LOCKED : state;
+}
+
+#else
+
 enum zmk_studio_core_lock_state zmk_studio_core_get_lock_state(void) { return state; }
 
-static void set_state(enum zmk_studio_core_lock_state new_state) {
-    if (state == new_state) {
+#endif
+
+// Raises the lock state change if the state as read by zmk_studio_core_get_lock_state() differs
+// from @p before, which also covers suspending and resuming a session.
+static void raise_if_changed(enum zmk_studio_core_lock_state before) {
+    enum zmk_studio_core_lock_state after = zmk_studio_core_get_lock_state();
+    if (after == before) {
         return;
     }
 
-    state = new_state;
-
     raise_zmk_studio_core_lock_state_changed(
-        (struct zmk_studio_core_lock_state_changed){.state = state});
+        (struct zmk_studio_core_lock_state_changed){.state = after});
 }
 
 #if CONFIG_ZMK_STUDIO_LOCK_IDLE_TIMEOUT_SEC > 0
@@ -41,10 +62,69 @@ void zmk_studio_core_reschedule_lock_timeout() {}
 
 #endif
 
+#if CONFIG_ZMK_STUDIO_LOCK_RESUME_TIMEOUT_SEC > 0
+
+static void core_resume_timeout_cb(struct k_work *work) { zmk_studio_core_lock(); }
+
+K_WORK_DELAYABLE_DEFINE(core_resume_timeout, core_resume_timeout_cb);
+
+static void end_session(void) {
+    session.suspended = false;
+    k_work_cancel_delayable(&core_resume_timeout);
+}
+
+void zmk_studio_core_suspend(const void *peer, size_t len) {
+    if (state != ZMK_STUDIO_CORE_LOCK_STATE_UNLOCKED || len > sizeof(session.peer)) {
+        zmk_studio_core_lock();
+        return;
+    }
+
+    memcpy(session.peer, peer, len);
+    session.peer_len = len;
+    session.suspended = true;
+    raise_if_changed(ZMK_STUDIO_CORE_LOCK_STATE_UNLOCKED);
+    k_work_reschedule(&core_resume_timeout, K_SECONDS(CONFIG_ZMK_STUDIO_LOCK_RESUME_TIMEOUT_SEC));
+}
+
+void zmk_studio_core_resume(const void *peer, size_t len) {
+    if (!session.suspended) {
+        return;
+    }
+
+    if (len != session.peer_len || memcmp(session.peer, peer, len) != 0) {
+        zmk_studio_core_lock();
+        return;
+    }
+
+    end_session();
+    raise_if_changed(ZMK_STUDIO_CORE_LOCK_STATE_LOCKED);
+    zmk_studio_core_reschedule_lock_timeout();
+}
+
+#else
+
+static void end_session(void) {}
+
+void zmk_studio_core_suspend(const void *peer, size_t len) { zmk_studio_core_lock(); }
+
+void zmk_studio_core_resume(const void *peer, size_t len) {}
+
+#endif
+
 void zmk_studio_core_unlock() {
-    set_state(ZMK_STUDIO_CORE_LOCK_STATE_UNLOCKED);
+    enum zmk_studio_core_lock_state before = zmk_studio_core_get_lock_state();
+
+    end_session();
+    state = ZMK_STUDIO_CORE_LOCK_STATE_UNLOCKED;
+    raise_if_changed(before);
 
     zmk_studio_core_reschedule_lock_timeout();
 }
 
-void zmk_studio_core_lock() { set_state(ZMK_STUDIO_CORE_LOCK_STATE_LOCKED); }
\ No newline at end of file
+void zmk_studio_core_lock() {
+    enum zmk_studio_core_lock_state before = zmk_studio_core_get_lock_state();
+
+    end_session();
+    state = ZMK_STUDIO_CORE_LOCK_STATE_LOCKED;
+    raise_if_changed(before);
+}
\ No newline at end of file
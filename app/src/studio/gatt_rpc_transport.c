@@ -143,6 +143,7 @@ static void notif_rpc_tx_cb(struct k_work *work) {
     if (!conn) {
         LOG_WRN("No active connection for queued data, dropping");
         ring_buf_reset(tx_buf);
+        zmk_rpc_tx_space_notify();
         return;
     }
 
@@ -165,6 +166,8 @@ static void notif_rpc_tx_cb(struct k_work *work) {
             ring_buf_get_finish(tx_buf, len);
         }
 
+        zmk_rpc_tx_space_notify();
+
         rpc_indicate_params.len = added;
 
         int err = bt_gatt_indicate(conn, &rpc_indicate_params);
@@ -195,7 +198,8 @@ static void gatt_tx_notify(struct ring_buf *tx_buf, size_t added, bool msg_done,
 
     atomic_t ns = atomic_get(&notify_size);
 
-    if (msg_done || state->pending_notify > ns) {
+    // Also sent when the buffer is full, as the encoder is then waiting on it to be drained
+    if (msg_done || state->pending_notify > ns || ring_buf_space_get(tx_buf) == 0) {
         k_work_submit(&notify_tx_work);
         state->pending_notify = 0;
     }
@@ -209,8 +213,20 @@ static void *gatt_tx_user_data(void) {
     return &tx_state;
 }
 
-ZMK_RPC_TRANSPORT(gatt, ZMK_TRANSPORT_BLE, gatt_start_rx, gatt_stop_rx, gatt_tx_user_data,
-                  gatt_tx_notify);
+static size_t gatt_tx_chunk_size(void) {
+    return MIN(atomic_get(&notify_size), sizeof(indicate_buffer));
+}
+
+ZMK_RPC_TRANSPORT_FRAMED(gatt, ZMK_TRANSPORT_BLE, ZMK_RPC_TRANSPORT_FRAMING_BYTE_STUFFED,
+                         gatt_start_rx, gatt_stop_rx, gatt_tx_user_data, gatt_tx_notify,
+                         gatt_tx_chunk_size);
+
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_LOCK_ON_DISCONNECT)
+// The host last connected on the active profile. Its bonded address is what a session is resumed
+// with, since only that host can re-establish the encrypted link.
+static bt_addr_le_t session_peer;
+static bool session_peer_connected;
+#endif
 
 static int gatt_rpc_listener(const zmk_event_t *eh) {
     refresh_notify_size();
@@ -218,10 +234,23 @@ static int gatt_rpc_listener(const zmk_event_t *eh) {
 #if IS_ENABLED(CONFIG_ZMK_STUDIO_LOCK_ON_DISCONNECT)
     struct bt_conn *conn = zmk_ble_active_profile_conn();
 
-    if (!conn) {
-        zmk_studio_core_lock();
-    } else {
+    if (conn) {
+        const bt_addr_le_t *dst = bt_conn_get_dst(conn);
+
+        if (session_peer_connected && bt_addr_le_cmp(dst, &session_peer) != 0) {
+            // Switched to another connected host
+            zmk_studio_core_lock();
+        } else {
+            zmk_studio_core_resume(dst, sizeof(*dst));
+        }
+        bt_addr_le_copy(&session_peer, dst);
+        session_peer_connected = true;
         bt_conn_unref(conn);
+    } else if (session_peer_connected) {
+        session_peer_connected = false;
+        zmk_studio_core_suspend(&session_peer, sizeof(session_peer));
+    } else {
+        zmk_studio_core_lock();
     }
 #endif
 
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/ring_buffer.h>
+
+#include <zephyr/logging/log.h>
+#include <zmk/studio/core.h>
+#include <zmk/studio/rpc.h>
+
+LOG_MODULE_DECLARE(zmk_studio, CONFIG_ZMK_STUDIO_LOG_LEVEL);
+
+// Serves one Studio client at a time on a Unix socket of the host. Messages are length prefixed,
+// as on the other IPC sockets, rather than byte stuffed, since the socket is a reliable stream.
+//
+// native_sim builds have neither USB nor BLE, so the transport is selected while the endpoint
+// transport is none.
+
+static int client_fd = -1;
+
+static K_MUTEX_DEFINE(client_fd_lock);
+
+static atomic_t rx_enabled;
+
+static void set_nonblocking(int fd) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK); }
+
+static void close_client(void) {
+    k_mutex_lock(&client_fd_lock, K_FOREVER);
+    if (client_fd >= 0) {
+        close(client_fd);
+        client_fd = -1;
+    }
+    k_mutex_unlock(&client_fd_lock);
+
+    LOG_INF("Studio client disconnected");
+
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_LOCK_ON_DISCONNECT)
+    zmk_studio_core_lock();
+#endif
+}
+
+// Sends everything in the TX buffer, waiting on the client if its socket is full. Data for a
+// client that's gone is discarded, so the RPC thread never waits on an empty socket.
+static void flush_tx_buf(struct ring_buf *tx_buf) {
+    uint8_t *buf;
+    uint32_t claim_len;
+
+    while ((claim_len = ring_buf_get_claim(tx_buf, &buf, ring_buf_capacity_get(tx_buf))) > 0) {
+        k_mutex_lock(&client_fd_lock, K_FOREVER);
+        ssize_t len = client_fd >= 0 ? send(client_fd, buf, claim_len, MSG_DONTWAIT | MSG_NOSIGNAL)
+                                     : claim_len;
+        int err = len < 0 ? errno : 0;
+        k_mutex_unlock(&client_fd_lock);
+
+        if (len < 0) {
+            if (err == EAGAIN || err == EWOULDBLOCK) {
+                ring_buf_get_finish(tx_buf, 0);
+                k_sleep(K_MSEC(CONFIG_ZMK_STUDIO_TRANSPORT_IPC_POLL_INTERVAL_MS));
+                continue;
+            }
+
+            LOG_WRN("Failed to send to the Studio client (errno=%d)", err);
+            close_client();
+            len = claim_len;
+        }
+
+        ring_buf_get_finish(tx_buf, len);
+        zmk_rpc_tx_space_notify();
+    }
+}
+
+static void tx_notify(struct ring_buf *tx_buf, size_t added, bool msg_done, void *user_data) {
+    if (msg_done || (ring_buf_size_get(tx_buf) > (ring_buf_capacity_get(tx_buf) / 2))) {
+        flush_tx_buf(tx_buf);
+    }
+}
+
+static int start_rx(void) {
+    atomic_set(&rx_enabled, 1);
+    return 0;
+}
+
+static int stop_rx(void) {
+    atomic_set(&rx_enabled, 0);
+    return 0;
+}
+
+ZMK_RPC_TRANSPORT_FRAMED(ipc, ZMK_TRANSPORT_NONE, ZMK_RPC_TRANSPORT_FRAMING_LENGTH_PREFIXED,
+                         start_rx, stop_rx, NULL, tx_notify, NULL);
+
+static int open_server_socket(void) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        LOG_ERR("Failed to create the Studio socket (errno=%d)", errno);
+        return -errno;
+    }
+
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    strncpy(addr.sun_path, CONFIG_ZMK_STUDIO_TRANSPORT_IPC_SOCKET_PATH, sizeof(addr.sun_path) - 1);
+    unlink(CONFIG_ZMK_STUDIO_TRANSPORT_IPC_SOCKET_PATH);
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 1) < 0) {
+        int err = errno;
+        LOG_ERR("Failed to listen on %s (errno=%d)", CONFIG_ZMK_STUDIO_TRANSPORT_IPC_SOCKET_PATH,
+                err);
+        close(fd);
+        return -err;
+    }
+
+    set_nonblocking(fd);
+    return fd;
+}
+
+static void accept_client(int server_fd) {
+    int fd = accept(server_fd, NULL, NULL);
+    if (fd < 0) {
+        return;
+    }
+
+    set_nonblocking(fd);
+
+    k_mutex_lock(&client_fd_lock, K_FOREVER);
+    client_fd = fd;
+    k_mutex_unlock(&client_fd_lock);
+
+    LOG_INF("Studio client connected");
+}
+
+// Moves whatever the client sent into the RX buffer, as far as it has room
+static void receive_from_client(void) {
+    struct ring_buf *rx_buf = zmk_rpc_get_rx_buf();
+
+    for (;;) {
+        uint8_t *buf;
+        uint32_t claim_len = ring_buf_put_claim(rx_buf, &buf, ring_buf_capacity_get(rx_buf));
+        if (claim_len == 0) {
+            return;
+        }
+
+        // The RPC thread closes the client if a send fails
+        k_mutex_lock(&client_fd_lock, K_FOREVER);
+        ssize_t len = client_fd >= 0 ? recv(client_fd, buf, claim_len, MSG_DONTWAIT) : 0;
+        int err = len < 0 ? errno : 0;
+        k_mutex_unlock(&client_fd_lock);
+
+        if (len < 0 && (err == EAGAIN || err == EWOULDBLOCK || err == EINTR)) {
+            ring_buf_put_finish(rx_buf, 0);
+            return;
+        }
+
+        if (len <= 0) {
+            ring_buf_put_finish(rx_buf, 0);
+            close_client();
+            return;
+        }
+
+        ring_buf_put_finish(rx_buf, len);
+        zmk_rpc_rx_notify();
+    }
+}
+
+// Sockets are polled without blocking, since a blocking host call stops the whole simulated
+// kernel.
+static void ipc_rpc_transport_thread_func(void *a, void *b, void *c) {
+    int server_fd = open_server_socket();
+    if (server_fd < 0) {
+        return;
+    }
+
+    LOG_DBG("Waiting for a Studio client on %s", CONFIG_ZMK_STUDIO_TRANSPORT_IPC_SOCKET_PATH);
+
+    for (;;) {
+        if (client_fd < 0) {
+            accept_client(server_fd);
+        }
+
+        if (client_fd >= 0 && atomic_get(&rx_enabled)) {
+            receive_from_client();
+        }
+
+        k_sleep(K_MSEC(CONFIG_ZMK_STUDIO_TRANSPORT_IPC_POLL_INTERVAL_MS));
+    }
+}
+
+K_THREAD_DEFINE(studio_ipc_rpc_transport_thread, CONFIG_ZMK_STUDIO_TRANSPORT_IPC_THREAD_STACK_SIZE,
+                ipc_rpc_transport_thread_func, NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO,
+                0, 0);
@@ -27,16 +27,26 @@ static bool encode_layer_bindings(pb_ostream_t *stream, const pb_field_t *field,
     const zmk_keymap_layer_id_t layer_id = *(uint8_t *)*arg;
 
     for (int b = 0; b < ZMK_KEYMAP_LEN; b++) {
+        zmk_keymap_BehaviorBinding bb = zmk_keymap_BehaviorBinding_init_zero;
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_PACKED_BINDINGS)
+        struct zmk_keymap_local_binding binding;
+
+        if (zmk_keymap_get_layer_local_binding_at_idx(layer_id, b, &binding) == 0) {
+            bb.behavior_id = binding.behavior_local_id;
+            bb.param1 = binding.param1;
+            bb.param2 = binding.param2;
+        }
+#else
         const struct zmk_behavior_binding *binding =
             zmk_keymap_get_layer_binding_at_idx(layer_id, b);
 
-        zmk_keymap_BehaviorBinding bb = zmk_keymap_BehaviorBinding_init_zero;
-
         if (binding && binding->behavior_dev) {
             bb.behavior_id = zmk_behavior_get_local_id(binding->behavior_dev);
             bb.param1 = binding->param1;
             bb.param2 = binding->param2;
         }
+#endif
 
         if (!pb_encode_tag_for_field(stream, field)) {
             return false;
@@ -293,7 +303,7 @@ static bool encode_layout_keys(pb_ostream_t *stream, const pb_field_t *field, vo
     return true;
 }
 
-static bool encode_layouts(pb_ostream_t *stream, const pb_field_t *field, void *const *arg) {
+static bool encode_layout_list(pb_ostream_t *stream, const pb_field_t *field, void *const *arg) {
     struct zmk_physical_layout const *const *layouts;
     const size_t layout_count = zmk_physical_layouts_get_list(&layouts);
 
@@ -322,6 +332,40 @@ static bool encode_layouts(pb_ostream_t *stream, const pb_field_t *field, void *
     return true;
 }
 
+#if CONFIG_ZMK_STUDIO_PHYSICAL_LAYOUTS_CACHE_SIZE > 0
+
+// The encoded layouts field, since the layouts never change at runtime and are requested each time
+// Studio connects. Encoded on the first request; if they don't fit, they're encoded on every one.
+static uint8_t layouts_cache[CONFIG_ZMK_STUDIO_PHYSICAL_LAYOUTS_CACHE_SIZE];
+static size_t layouts_cache_len;
+static bool layouts_cache_tried;
+
+static bool encode_layouts(pb_ostream_t *stream, const pb_field_t *field, void *const *arg) {
+    if (!layouts_cache_tried) {
+        pb_ostream_t cache_stream = pb_ostream_from_buffer(layouts_cache, sizeof(layouts_cache));
+
+        layouts_cache_tried = true;
+        if (encode_layout_list(&cache_stream, field, arg)) {
+            layouts_cache_len = cache_stream.bytes_written;
+        } else {
+            LOG_DBG("No room to cache the physical layouts");
+            layouts_cache_len = SIZE_MAX;
+        }
+    }
+
+    if (layouts_cache_len != SIZE_MAX) {
+        return pb_write(stream, layouts_cache, layouts_cache_len);
+    }
+
+    return encode_layout_list(stream, field, arg);
+}
+
+#else
+
+#define encode_layouts encode_layout_list
+
+#endif // CONFIG_ZMK_STUDIO_PHYSICAL_LAYOUTS_CACHE_SIZE > 0
+
 zmk_studio_Response get_physical_layouts(const zmk_studio_Request *req) {
     LOG_DBG("");
     zmk_keymap_PhysicalLayouts resp = zmk_keymap_PhysicalLayouts_init_zero;
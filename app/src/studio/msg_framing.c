@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <string.h>
+
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -77,4 +79,67 @@ bool studio_framing_process_byte(enum studio_framing_state *rpc_framing_state, u
         LOG_ERR("Unsupported framing state: %d", *rpc_framing_state);
         return false;
     }
-}
\ No newline at end of file
+}
+
+// Sets the top bit of each byte of the word that's zero, and possibly of the ones above it
+#define WORD_HAS_ZERO_BYTE(w) (((w) - 0x01010101U) & ~(w) & 0x80808080U)
+
+#define WORD_HAS_BYTE(w, b) WORD_HAS_ZERO_BYTE((w) ^ ((uint32_t)(b) * 0x01010101U))
+
+static inline bool is_framing_byte(uint8_t c) {
+    return c == FRAMING_SOF || c == FRAMING_ESC || c == FRAMING_EOF;
+}
+
+size_t studio_framing_find_framing_byte(const uint8_t *data, size_t len) {
+    size_t i = 0;
+
+    // Skip a word at a time until one holds a framing byte, then find which one it is
+    for (; i + sizeof(uint32_t) <= len; i += sizeof(uint32_t)) {
+        uint32_t w;
+        memcpy(&w, &data[i], sizeof(w));
+
+        if (WORD_HAS_BYTE(w, FRAMING_SOF) || WORD_HAS_BYTE(w, FRAMING_ESC) ||
+            WORD_HAS_BYTE(w, FRAMING_EOF)) {
+            break;
+        }
+    }
+
+    for (; i < len; i++) {
+        if (is_framing_byte(data[i])) {
+            return i;
+        }
+    }
+
+    return len;
+}
+
+size_t studio_framing_process_bytes(enum studio_framing_state *rpc_framing_state,
+                                    const uint8_t *data, size_t len, uint8_t *out,
+                                    size_t *out_len) {
+    size_t processed = 0;
+    *out_len = 0;
+
+    while (processed < len) {
+        if (*rpc_framing_state == FRAMING_STATE_AWAITING_DATA) {
+            size_t run = studio_framing_find_framing_byte(&data[processed], len - processed);
+            memcpy(&out[*out_len], &data[processed], run);
+            *out_len += run;
+            processed += run;
+
+            if (processed == len) {
+                break;
+            }
+        }
+
+        uint8_t c = data[processed++];
+        if (studio_framing_process_byte(rpc_framing_state, c)) {
+            out[(*out_len)++] = c;
+        }
+
+        if (*rpc_framing_state == FRAMING_STATE_EOF) {
+            break;
+        }
+    }
+
+    return processed;
+}
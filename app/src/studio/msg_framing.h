@@ -29,3 +29,19 @@ enum studio_framing_state {
  * has been updated.
  */
 bool studio_framing_process_byte(enum studio_framing_state *frame_state, uint8_t data);
+
+/**
+ * @brief Find the first framing byte (SOF, ESC or EOF) in a span of data.
+ * @retval The index of the first framing byte, or @p len if the span has none.
+ */
+size_t studio_framing_find_framing_byte(const uint8_t *data, size_t len);
+
+/**
+ * @brief Process a span of incoming bytes from a frame, stopping after the EOF of the frame if it's
+ * part of the span. Runs of bytes without framing bytes in them are copied as is.
+ * @param out Buffer for the real data, with room for at least @p len bytes.
+ * @param out_len Set to the number of real data bytes written to @p out.
+ * @retval The number of bytes of @p data processed.
+ */
+size_t studio_framing_process_bytes(enum studio_framing_state *frame_state, const uint8_t *data,
+                                    size_t len, uint8_t *out, size_t *out_len);
@@ -9,10 +9,14 @@
 #include <pb_encode.h>
 #include <pb_decode.h>
 
+#include <string.h>
+
 #include <zephyr/init.h>
 #include <zephyr/kernel.h>
 #include <zephyr/debug/thread_analyzer.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
 
 LOG_MODULE_REGISTER(zmk_studio, CONFIG_ZMK_STUDIO_LOG_LEVEL);
 
@@ -75,6 +79,10 @@ static K_SEM_DEFINE(rpc_rx_sem, 0, 1);
 
 static enum studio_framing_state rpc_framing_state;
 
+// Set when the transport stops, so the RX thread drops the partial message it was reading
+// instead of splicing it onto the start of the next transport's stream.
+static atomic_t rpc_rx_reset;
+
 static K_MUTEX_DEFINE(rpc_transport_mutex);
 static struct zmk_rpc_transport *selected_transport;
 
@@ -90,13 +98,16 @@ static bool rpc_read_cb(pb_istream_t *stream, uint8_t *buf, size_t count) {
         uint32_t len = ring_buf_get_claim(&rpc_rx_buf, &buffer, count - write_offset);
 
         if (len > 0) {
-            for (int i = 0; i < len; i++) {
-                if (studio_framing_process_byte(&rpc_framing_state, buffer[i])) {
-                    buf[write_offset++] = buffer[i];
-                }
-            }
+            size_t data_len;
+            // Bytes past the EOF stay in the buffer for the next message
+            len = studio_framing_process_bytes(&rpc_framing_state, buffer, len,
+                                               &buf[write_offset], &data_len);
+            write_offset += data_len;
         } else {
             k_sem_take(&rpc_rx_sem, K_FOREVER);
+            if (atomic_get(&rpc_rx_reset)) {
+                return false;
+            }
         }
 
         ring_buf_get_finish(&rpc_rx_buf, len);
@@ -115,58 +126,190 @@ static pb_istream_t pb_istream_for_rx_ring_buf() {
     return stream;
 }
 
+// Reads exactly count bytes from the RX buffer, waiting for them as needed. Discards them if buf
+// is NULL. Returns false if the transport stopped before they all arrived.
+static bool rpc_rx_buf_read(uint8_t *buf, size_t count) {
+    size_t read = 0;
+
+    while (read < count) {
+        uint32_t len = ring_buf_get(&rpc_rx_buf, buf ? &buf[read] : NULL, count - read);
+        if (len == 0) {
+            k_sem_take(&rpc_rx_sem, K_FOREVER);
+            if (atomic_get(&rpc_rx_reset)) {
+                return false;
+            }
+        }
+
+        read += len;
+    }
+
+    return true;
+}
+
+static bool rpc_read_length_prefixed_cb(pb_istream_t *stream, uint8_t *buf, size_t count) {
+    // The stream never asks for more than bytes_left, so this never reads past the message
+    return rpc_rx_buf_read(buf, count);
+}
+
+// A bounded request never encodes to more than this, so a longer prefix is garbage or a stream
+// that lost its alignment, not something worth waiting out byte by byte.
+#if defined(zmk_studio_Request_size)
+#define RPC_REQUEST_MAX_SIZE zmk_studio_Request_size
+#else
+#define RPC_REQUEST_MAX_SIZE sizeof(zmk_studio_Request)
+#endif
+
+// Only the RX thread consumes, so this is safe against a transport still putting bytes
+static void rpc_rx_discard_buffered(void) {
+    ring_buf_get(&rpc_rx_buf, NULL, ring_buf_size_get(&rpc_rx_buf));
+}
+
+// Drops whatever the stopped transport left behind, and the framing state of its last message
+static void rpc_rx_reset_framing(void) {
+    rpc_framing_state = FRAMING_STATE_IDLE;
+    rpc_rx_discard_buffered();
+}
+
+static enum zmk_rpc_transport_framing selected_transport_framing(void) {
+    k_mutex_lock(&rpc_transport_mutex, K_FOREVER);
+    enum zmk_rpc_transport_framing framing =
+        selected_transport ? selected_transport->framing : ZMK_RPC_TRANSPORT_FRAMING_BYTE_STUFFED;
+    k_mutex_unlock(&rpc_transport_mutex);
+
+    return framing;
+}
+
+static bool decode_request(zmk_studio_Request *req) {
+    if (atomic_clear(&rpc_rx_reset)) {
+        rpc_rx_reset_framing();
+    }
+
+    if (selected_transport_framing() == ZMK_RPC_TRANSPORT_FRAMING_LENGTH_PREFIXED) {
+        uint8_t prefix[4];
+        if (!rpc_rx_buf_read(prefix, sizeof(prefix))) {
+            return false;
+        }
+
+        uint32_t len = sys_get_be32(prefix);
+        if (len > RPC_REQUEST_MAX_SIZE) {
+            // There's no telling where the next message starts, so start over from what arrives
+            // after the bytes already buffered
+            LOG_WRN("Dropping a request with length prefix %u", len);
+            rpc_rx_discard_buffered();
+            return false;
+        }
+
+        pb_istream_t stream = {&rpc_read_length_prefixed_cb, NULL, len};
+        bool status = pb_decode(&stream, &zmk_studio_Request_msg, req);
+
+        // Skip what's left of a message that failed to decode, to keep the next one aligned
+        if (!rpc_rx_buf_read(NULL, stream.bytes_left)) {
+            return false;
+        }
+
+        return status;
+    }
+
+    pb_istream_t stream = pb_istream_for_rx_ring_buf();
+    bool status = pb_decode(&stream, &zmk_studio_Request_msg, req);
+
+    rpc_framing_state = FRAMING_STATE_IDLE;
+
+    return status;
+}
+
 RING_BUF_DECLARE(rpc_tx_buf, CONFIG_ZMK_STUDIO_RPC_TX_BUF_SIZE);
 
 struct ring_buf *zmk_rpc_get_tx_buf(void) { return &rpc_tx_buf; }
 
+static K_SEM_DEFINE(rpc_tx_space_sem, 0, 1);
+
+void zmk_rpc_tx_space_notify(void) { k_sem_give(&rpc_tx_space_sem); }
+
+// Only for a transport that stopped draining without a word, e.g. after a failed send, which is
+// told about the full buffer again each time this passes.
+#define TX_SPACE_WAIT_TIMEOUT K_MSEC(100)
+
+// Bytes of the message being sent that the transport wasn't told about yet, and how many to
+// gather before telling it. Only used with rpc_transport_mutex held.
+static size_t tx_pending_notify;
+static size_t tx_chunk_size;
+
+static void rpc_tx_begin_message(void) {
+    tx_pending_notify = 0;
+    tx_chunk_size = selected_transport->tx_chunk_size ? selected_transport->tx_chunk_size()
+                                                      : ring_buf_capacity_get(&rpc_tx_buf) / 2;
+}
+
+static void rpc_tx_notify(bool msg_done, void *user_data) {
+    selected_transport->tx_notify(&rpc_tx_buf, tx_pending_notify, msg_done, user_data);
+    tx_pending_notify = 0;
+}
+
+static void rpc_tx_added(size_t added, void *user_data) {
+    tx_pending_notify += added;
+
+    if (tx_pending_notify >= tx_chunk_size) {
+        rpc_tx_notify(false, user_data);
+    }
+}
+
+// Sleeps until the transport consumes some of the full TX buffer
+static void rpc_tx_wait_for_space(void *user_data) {
+    if (tx_pending_notify > 0) {
+        rpc_tx_notify(false, user_data);
+    }
+
+    while (ring_buf_space_get(&rpc_tx_buf) == 0) {
+        if (k_sem_take(&rpc_tx_space_sem, TX_SPACE_WAIT_TIMEOUT) < 0) {
+            LOG_DBG("Still waiting for TX buffer space");
+            rpc_tx_notify(false, user_data);
+        }
+    }
+}
+
 static bool rpc_tx_buffer_write(pb_ostream_t *stream, const uint8_t *buf, size_t count) {
     void *user_data = stream->state;
     size_t written = 0;
 
+    // Set when a claim ended right after the escape byte for buf[written]
     bool escape_byte_already_written = false;
-    do {
-        uint32_t write_idx = 0;
-
+    while (written < count) {
         uint8_t *write_buf;
         uint32_t claim_len = ring_buf_put_claim(&rpc_tx_buf, &write_buf, count - written);
 
         if (claim_len == 0) {
+            rpc_tx_wait_for_space(user_data);
             continue;
         }
 
-        int escapes_written = 0;
-        for (int i = 0; i < claim_len && write_idx < claim_len; i++) {
-            uint8_t b = buf[written + i];
-            switch (b) {
-            case FRAMING_EOF:
-            case FRAMING_ESC:
-            case FRAMING_SOF:
-                // Care to be taken. We may need to write the escape byte,
-                // but that's the last available spot for this claim, so we track
-                // if the escape has already been written in the previous iteration
-                // of our loop.
-                if (!escape_byte_already_written) {
-                    escapes_written++;
-                    write_buf[write_idx++] = FRAMING_ESC;
-                    escape_byte_already_written = true;
-                    if (write_idx >= claim_len) {
-                        LOG_WRN("Skipping on, no room to write escape and real byte");
-                        continue;
-                    }
+        uint32_t write_idx = 0;
+        while (write_idx < claim_len && written < count) {
+            if (!escape_byte_already_written) {
+                size_t run = studio_framing_find_framing_byte(
+                    &buf[written], MIN(count - written, claim_len - write_idx));
+                memcpy(&write_buf[write_idx], &buf[written], run);
+                write_idx += run;
+                written += run;
+
+                if (write_idx == claim_len || written == count) {
+                    break;
+                }
+
+                write_buf[write_idx++] = FRAMING_ESC;
+                escape_byte_already_written = true;
+                if (write_idx == claim_len) {
+                    break;
                 }
-            default:
-                write_buf[write_idx++] = b;
-                escape_byte_already_written = false;
-                break;
             }
+
+            write_buf[write_idx++] = buf[written++];
+            escape_byte_already_written = false;
         }
 
         ring_buf_put_finish(&rpc_tx_buf, write_idx);
-
-        written += (write_idx - escapes_written);
-
-        selected_transport->tx_notify(&rpc_tx_buf, write_idx, false, user_data);
-    } while (written < count);
+        rpc_tx_added(write_idx, user_data);
+    }
 
     return true;
 }
@@ -176,21 +319,31 @@ static pb_ostream_t pb_ostream_for_tx_buf(void *user_data) {
     return stream;
 }
 
-static int send_response(const zmk_studio_Response *resp) {
-    k_mutex_lock(&rpc_transport_mutex, K_FOREVER);
+static bool rpc_tx_buffer_write_raw(pb_ostream_t *stream, const uint8_t *buf, size_t count) {
+    void *user_data = stream->state;
+    size_t written = 0;
 
-    if (!selected_transport) {
-        goto exit;
+    while (written < count) {
+        uint32_t len = ring_buf_put(&rpc_tx_buf, &buf[written], count - written);
+
+        if (len == 0) {
+            rpc_tx_wait_for_space(user_data);
+            continue;
+        }
+
+        written += len;
+        rpc_tx_added(len, user_data);
     }
 
-    void *user_data = selected_transport->tx_user_data ? selected_transport->tx_user_data() : NULL;
+    return true;
+}
 
+static bool encode_byte_stuffed(const zmk_studio_Response *resp, void *user_data) {
     pb_ostream_t stream = pb_ostream_for_tx_buf(user_data);
+    pb_ostream_t framing_stream = {&rpc_tx_buffer_write_raw, user_data, SIZE_MAX, 0};
 
     uint8_t framing_byte = FRAMING_SOF;
-    ring_buf_put(&rpc_tx_buf, &framing_byte, 1);
-
-    selected_transport->tx_notify(&rpc_tx_buf, 1, false, user_data);
+    pb_write(&framing_stream, &framing_byte, 1);
 
     /* Now we are ready to encode the message! */
     bool status = pb_encode(&stream, &zmk_studio_Response_msg, resp);
@@ -199,42 +352,107 @@ static int send_response(const zmk_studio_Response *resp) {
 #if !IS_ENABLED(CONFIG_NANOPB_NO_ERRMSG)
         LOG_ERR("Failed to encode the message %s", stream.errmsg);
 #endif // !IS_ENABLED(CONFIG_NANOPB_NO_ERRMSG)
-        return -EINVAL;
+        return false;
     }
 
     framing_byte = FRAMING_EOF;
-    ring_buf_put(&rpc_tx_buf, &framing_byte, 1);
+    pb_write(&framing_stream, &framing_byte, 1);
+
+    rpc_tx_notify(true, user_data);
+
+    return true;
+}
+
+static bool encode_length_prefixed(const zmk_studio_Response *resp, void *user_data) {
+    size_t len;
+    if (!pb_get_encoded_size(&len, &zmk_studio_Response_msg, resp)) {
+        LOG_ERR("Failed to size the message");
+        return false;
+    }
+
+    pb_ostream_t stream = {&rpc_tx_buffer_write_raw, user_data, SIZE_MAX, 0};
+
+    uint8_t prefix[4];
+    sys_put_be32(len, prefix);
+    pb_write(&stream, prefix, sizeof(prefix));
+
+    bool status = pb_encode(&stream, &zmk_studio_Response_msg, resp);
+
+    if (!status) {
+#if !IS_ENABLED(CONFIG_NANOPB_NO_ERRMSG)
+        LOG_ERR("Failed to encode the message %s", stream.errmsg);
+#endif // !IS_ENABLED(CONFIG_NANOPB_NO_ERRMSG)
+        return false;
+    }
+
+    rpc_tx_notify(true, user_data);
 
-    selected_transport->tx_notify(&rpc_tx_buf, 1, true, user_data);
+    return true;
+}
+
+static int send_response(const zmk_studio_Response *resp) {
+    int err = 0;
+
+    k_mutex_lock(&rpc_transport_mutex, K_FOREVER);
+
+    if (!selected_transport) {
+        goto exit;
+    }
+
+    void *user_data = selected_transport->tx_user_data ? selected_transport->tx_user_data() : NULL;
+
+    rpc_tx_begin_message();
+
+    bool status = selected_transport->framing == ZMK_RPC_TRANSPORT_FRAMING_LENGTH_PREFIXED
+                      ? encode_length_prefixed(resp, user_data)
+                      : encode_byte_stuffed(resp, user_data);
+    if (!status) {
+        err = -EINVAL;
+    }
 
 exit:
     k_mutex_unlock(&rpc_transport_mutex);
-    return 0;
+    return err;
 }
 
-static void rpc_main(void) {
+// Requests are decoded ahead into this queue while earlier ones are handled, and their responses
+// sent, so a client can pipeline requests instead of waiting out each round trip. They're still
+// handled one at a time in order, and each response carries the ID of its request.
+K_MSGQ_DEFINE(rpc_request_queue, sizeof(zmk_studio_Request),
+              CONFIG_ZMK_STUDIO_RPC_REQUEST_QUEUE_SIZE, 4);
+
+static void rpc_rx_main(void) {
     for (;;) {
-        pb_istream_t stream = pb_istream_for_rx_ring_buf();
         zmk_studio_Request req = zmk_studio_Request_init_zero;
+        bool status = decode_request(&req);
+
+        if (status) {
+            k_msgq_put(&rpc_request_queue, &req, K_FOREVER);
+        } else {
+            LOG_DBG("Decode failed");
+        }
+    }
+}
+
+K_THREAD_DEFINE(studio_rpc_rx_thread, CONFIG_ZMK_STUDIO_RPC_RX_THREAD_STACK_SIZE, rpc_rx_main, NULL,
+                NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+
+static void rpc_main(void) {
+    for (;;) {
+        zmk_studio_Request req;
 #if IS_ENABLED(CONFIG_THREAD_ANALYZER)
         thread_analyzer_print(0);
 #endif // IS_ENABLED(CONFIG_THREAD_ANALYZER)
-        bool status = pb_decode(&stream, &zmk_studio_Request_msg, &req);
-
-        rpc_framing_state = FRAMING_STATE_IDLE;
+        k_msgq_get(&rpc_request_queue, &req, K_FOREVER);
 
-        if (status) {
-            zmk_studio_Response resp = handle_request(&req);
+        zmk_studio_Response resp = handle_request(&req);
 
-            int err = send_response(&resp);
+        int err = send_response(&resp);
 #if IS_ENABLED(CONFIG_THREAD_ANALYZER)
-            thread_analyzer_print(0);
+        thread_analyzer_print(0);
 #endif // IS_ENABLED(CONFIG_THREAD_ANALYZER)
-            if (err < 0) {
-                LOG_ERR("Failed to send the RPC response %d", err);
-            }
-        } else {
-            LOG_DBG("Decode failed");
+        if (err < 0) {
+            LOG_ERR("Failed to send the RPC response %d", err);
         }
     }
 }
@@ -256,6 +474,9 @@ static void refresh_selected_transport(void) {
             selected_transport->rx_stop();
         }
         selected_transport = NULL;
+
+        atomic_set(&rpc_rx_reset, 1);
+        k_sem_give(&rpc_rx_sem);
 #if IS_ENABLED(CONFIG_ZMK_STUDIO_LOCK_ON_DISCONNECT)
         zmk_studio_core_lock();
 #endif
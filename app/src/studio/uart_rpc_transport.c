@@ -35,6 +35,7 @@ static void tx_notify(struct ring_buf *tx_ring_buf, size_t written, bool msg_don
             }
 
             ring_buf_get_finish(tx_buf, claim_len);
+            zmk_rpc_tx_space_notify();
         }
 #endif
     }
@@ -136,6 +137,7 @@ static void serial_cb(const struct device *dev, void *user_data) {
             int sent = uart_fifo_fill(uart_dev, buf, claim_len);
 
             ring_buf_get_finish(tx_buf, MAX(sent, 0));
+            zmk_rpc_tx_space_notify();
         }
     }
 }
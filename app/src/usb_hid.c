@@ -12,6 +12,7 @@
 
 #include <zmk/usb.h>
 #include <zmk/hid.h>
+#include <zmk/endpoints.h>
 #include <zmk/keymap.h>
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
@@ -28,9 +29,155 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 static const struct device *hid_dev;
 
-static K_SEM_DEFINE(hid_sem, 1, 1);
+// Reports wait in a queue per report ID while the IN endpoint is busy, and the ready callback
+// starts the next write right away, taking the report IDs in turn so that a stream of mouse
+// reports can't hold back key reports or the other way around. Keyboard and consumer reports are
+// sent in order, unless CONFIG_ZMK_USB_HID_LATCH_REPORTS keeps only the latest one waiting. Mouse
+// reports with the same buttons are merged, adding up their movement.
+#define USB_HID_MAX_REPORT_SIZE                                                                    \
+    MAX(sizeof(struct zmk_hid_keyboard_report), sizeof(struct zmk_hid_consumer_report))
+
+struct usb_hid_report_queue {
+    uint8_t reports[CONFIG_ZMK_USB_HID_REPORT_QUEUE_SIZE][USB_HID_MAX_REPORT_SIZE];
+    uint8_t lens[CONFIG_ZMK_USB_HID_REPORT_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t len;
+    // merges @p next into @p queued, returning false if it has to be sent on its own
+    bool (*merge)(uint8_t *queued, const uint8_t *next);
+    // replace the waiting report instead of queueing after it
+    bool latch;
+};
+
+enum {
+    USB_HID_QUEUE_KEYBOARD,
+    USB_HID_QUEUE_CONSUMER,
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+    USB_HID_QUEUE_MOUSE,
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+    USB_HID_QUEUE_COUNT,
+};
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+
+BUILD_ASSERT(sizeof(struct zmk_hid_mouse_report) <= USB_HID_MAX_REPORT_SIZE);
+
+static int16_t add_movement(int16_t a, int16_t b) { return CLAMP(a + b, INT16_MIN, INT16_MAX); }
+
+static bool merge_mouse_reports(uint8_t *queued_data, const uint8_t *next_data) {
+    struct zmk_hid_mouse_report *queued = (struct zmk_hid_mouse_report *)queued_data;
+    const struct zmk_hid_mouse_report *next = (const struct zmk_hid_mouse_report *)next_data;
+
+    if (queued->body.buttons != next->body.buttons) {
+        return false;
+    }
+
+    queued->body.d_x = add_movement(queued->body.d_x, next->body.d_x);
+    queued->body.d_y = add_movement(queued->body.d_y, next->body.d_y);
+    queued->body.d_scroll_y = add_movement(queued->body.d_scroll_y, next->body.d_scroll_y);
+    queued->body.d_scroll_x = add_movement(queued->body.d_scroll_x, next->body.d_scroll_x);
+    return true;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+
+static struct usb_hid_report_queue report_queues[USB_HID_QUEUE_COUNT] = {
+    [USB_HID_QUEUE_KEYBOARD] = {.latch = IS_ENABLED(CONFIG_ZMK_USB_HID_LATCH_REPORTS)},
+    [USB_HID_QUEUE_CONSUMER] = {.latch = IS_ENABLED(CONFIG_ZMK_USB_HID_LATCH_REPORTS)},
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+    [USB_HID_QUEUE_MOUSE] = {.merge = merge_mouse_reports},
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+};
+
+static struct k_spinlock report_queues_lock;
+// the report being written, which has to stay untouched until the endpoint is ready again
+static uint8_t in_flight_report[USB_HID_MAX_REPORT_SIZE];
+static bool in_flight;
+// the queue to look at first for the next write
+static uint8_t next_queue;
+
+static void queue_report(struct usb_hid_report_queue *queue, const uint8_t *report, size_t len) {
+    if (queue->len > 0) {
+        uint8_t tail = (queue->head + queue->len - 1) % CONFIG_ZMK_USB_HID_REPORT_QUEUE_SIZE;
+
+        if (queue->merge && queue->merge(queue->reports[tail], report)) {
+            return;
+        }
+
+        if (queue->latch || queue->len == CONFIG_ZMK_USB_HID_REPORT_QUEUE_SIZE) {
+            if (!queue->latch) {
+                LOG_WRN("USB HID report queue full, replacing the last queued report");
+            }
+
+            memcpy(queue->reports[tail], report, len);
+            queue->lens[tail] = len;
+            return;
+        }
+    }
 
-static void in_ready_cb(const struct device *dev) { k_sem_give(&hid_sem); }
+    uint8_t idx = (queue->head + queue->len) % CONFIG_ZMK_USB_HID_REPORT_QUEUE_SIZE;
+    memcpy(queue->reports[idx], report, len);
+    queue->lens[idx] = len;
+    queue->len++;
+}
+
+// Start writing the next queued report, if the endpoint isn't busy. The write itself happens
+// outside the lock, since some USB drivers take a mutex in it.
+static void write_next_report(void) {
+    for (;;) {
+        k_spinlock_key_t key = k_spin_lock(&report_queues_lock);
+
+        struct usb_hid_report_queue *queue = NULL;
+        for (int i = 0; i < USB_HID_QUEUE_COUNT && !in_flight && !queue; i++) {
+            struct usb_hid_report_queue *candidate =
+                &report_queues[(next_queue + i) % USB_HID_QUEUE_COUNT];
+            if (candidate->len > 0) {
+                queue = candidate;
+                next_queue = (candidate - report_queues + 1) % USB_HID_QUEUE_COUNT;
+            }
+        }
+
+        if (!queue) {
+            k_spin_unlock(&report_queues_lock, key);
+            return;
+        }
+
+        uint8_t len = queue->lens[queue->head];
+        memcpy(in_flight_report, queue->reports[queue->head], len);
+        queue->head = (queue->head + 1) % CONFIG_ZMK_USB_HID_REPORT_QUEUE_SIZE;
+        queue->len--;
+        in_flight = true;
+
+        k_spin_unlock(&report_queues_lock, key);
+
+        int err = hid_int_ep_write(hid_dev, in_flight_report, len, NULL);
+        if (!err) {
+            return;
+        }
+
+        LOG_ERR("Failed to write HID report (%d)", err);
+
+        key = k_spin_lock(&report_queues_lock);
+        in_flight = false;
+        k_spin_unlock(&report_queues_lock, key);
+    }
+}
+
+static void in_ready_cb(const struct device *dev) {
+    k_spinlock_key_t key = k_spin_lock(&report_queues_lock);
+    in_flight = false;
+    k_spin_unlock(&report_queues_lock, key);
+
+    write_next_report();
+}
+
+void zmk_usb_hid_reset(void) {
+    k_spinlock_key_t key = k_spin_lock(&report_queues_lock);
+    for (int i = 0; i < USB_HID_QUEUE_COUNT; i++) {
+        report_queues[i].len = 0;
+    }
+    in_flight = false;
+    k_spin_unlock(&report_queues_lock, key);
+}
 
 #define HID_GET_REPORT_TYPE_MASK 0xff00
 #define HID_GET_REPORT_ID_MASK 0x00ff
@@ -42,9 +189,19 @@ static void in_ready_cb(const struct device *dev) { k_sem_give(&hid_sem); }
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
 static uint8_t hid_protocol = HID_PROTOCOL_REPORT;
 
-static void set_proto_cb(const struct device *dev, uint8_t protocol) { hid_protocol = protocol; }
+void zmk_usb_hid_set_protocol(uint8_t protocol) {
+    hid_protocol = protocol;
+
+    // the USB interface only ever has one layout, so the endpoint just reports the negotiated one
+    struct zmk_endpoint_instance usb = {.transport = ZMK_TRANSPORT_USB};
+    zmk_endpoint_set_keyboard_report_format(usb, protocol == HID_PROTOCOL_BOOT
+                                                     ? ZMK_HID_KEYBOARD_REPORT_FORMAT_BOOT
+                                                     : ZMK_HID_KEYBOARD_REPORT_FORMAT_NATIVE);
+}
 
-void zmk_usb_hid_set_protocol(uint8_t protocol) { hid_protocol = protocol; }
+static void set_proto_cb(const struct device *dev, uint8_t protocol) {
+    zmk_usb_hid_set_protocol(protocol);
+}
 #endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
 
 static uint8_t *get_keyboard_report(size_t *len) {
@@ -184,7 +341,7 @@ static const struct hid_ops ops = {
     .set_report = set_report_cb,
 };
 
-static int zmk_usb_hid_send_report(const uint8_t *report, size_t len) {
+static int zmk_usb_hid_send_report(int queue, const uint8_t *report, size_t len) {
     switch (zmk_usb_get_status()) {
     case USB_DC_SUSPEND:
         return usb_wakeup_request();
@@ -193,22 +350,30 @@ static int zmk_usb_hid_send_report(const uint8_t *report, size_t len) {
     case USB_DC_DISCONNECTED:
     case USB_DC_UNKNOWN:
         return -ENODEV;
-    default:
-        k_sem_take(&hid_sem, K_MSEC(30));
-        int err = hid_int_ep_write(hid_dev, report, len, NULL);
+    default: {
+        k_spinlock_key_t key = k_spin_lock(&report_queues_lock);
+        queue_report(&report_queues[queue], report, len);
+        k_spin_unlock(&report_queues_lock, key);
 
-        if (err) {
-            k_sem_give(&hid_sem);
-        }
+        write_next_report();
 
-        return err;
+        return 0;
+    }
     }
 }
 
 int zmk_usb_hid_send_keyboard_report(void) {
     size_t len;
     uint8_t *report = get_keyboard_report(&len);
-    return zmk_usb_hid_send_report(report, len);
+    return zmk_usb_hid_send_report(USB_HID_QUEUE_KEYBOARD, report, len);
+}
+
+bool zmk_usb_hid_keyboard_report_queue_full(void) {
+    k_spinlock_key_t key = k_spin_lock(&report_queues_lock);
+    bool full = report_queues[USB_HID_QUEUE_KEYBOARD].len == CONFIG_ZMK_USB_HID_REPORT_QUEUE_SIZE;
+    k_spin_unlock(&report_queues_lock, key);
+
+    return full;
 }
 
 int zmk_usb_hid_send_consumer_report(void) {
@@ -219,7 +384,7 @@ int zmk_usb_hid_send_consumer_report(void) {
 #endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
 
     struct zmk_hid_consumer_report *report = zmk_hid_get_consumer_report();
-    return zmk_usb_hid_send_report((uint8_t *)report, sizeof(*report));
+    return zmk_usb_hid_send_report(USB_HID_QUEUE_CONSUMER, (uint8_t *)report, sizeof(*report));
 }
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
@@ -231,7 +396,7 @@ int zmk_usb_hid_send_mouse_report() {
 #endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
 
     struct zmk_hid_mouse_report *report = zmk_hid_get_mouse_report();
-    return zmk_usb_hid_send_report((uint8_t *)report, sizeof(*report));
+    return zmk_usb_hid_send_report(USB_HID_QUEUE_MOUSE, (uint8_t *)report, sizeof(*report));
 }
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
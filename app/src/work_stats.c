@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include <zmk/work_stats.h>
+
+// Work items are submitted from ISRs and other threads than the ones running them
+static struct k_spinlock stats_lock;
+
+void zmk_work_stats_submit(struct zmk_work_stats *stats, uint32_t delay_ms) {
+    uint32_t due = k_cycle_get_32() + k_ms_to_cyc_ceil32(delay_ms);
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    stats->submitted++;
+    if (!stats->pending || (int32_t)(due - stats->due_cycles) < 0) {
+        stats->due_cycles = due;
+        stats->pending = true;
+    }
+
+    k_spin_unlock(&stats_lock, key);
+}
+
+void zmk_work_stats_queue_depth(struct zmk_work_stats *stats, uint32_t used) {
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    stats->queue_high_water = MAX(stats->queue_high_water, used);
+    k_spin_unlock(&stats_lock, key);
+}
+
+uint32_t zmk_work_stats_run_start(struct zmk_work_stats *stats) {
+    uint32_t start = k_cycle_get_32();
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    // Runs nobody recorded a submit for, e.g. after an untracked resubmit, have no latency
+    if (stats->pending) {
+        int32_t late = (int32_t)(start - stats->due_cycles);
+        uint32_t latency = MAX(late, 0);
+
+        stats->total_latency_cycles += latency;
+        stats->max_latency_cycles = MAX(stats->max_latency_cycles, latency);
+        stats->pending = false;
+    }
+
+    k_spin_unlock(&stats_lock, key);
+    return start;
+}
+
+void zmk_work_stats_run_end(struct zmk_work_stats *stats, uint32_t start) {
+    uint32_t cycles = k_cycle_get_32() - start;
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    stats->runs++;
+    stats->total_run_cycles += cycles;
+    stats->max_run_cycles = MAX(stats->max_run_cycles, cycles);
+
+    k_spin_unlock(&stats_lock, key);
+}
+
+size_t zmk_work_stats_foreach(zmk_work_stats_cb_t cb, void *user_data) {
+    size_t count = 0;
+
+    STRUCT_SECTION_FOREACH(zmk_work_stats, stats) {
+        if (cb) {
+            k_spinlock_key_t key = k_spin_lock(&stats_lock);
+            struct zmk_work_stats copy = *stats;
+            k_spin_unlock(&stats_lock, key);
+
+            cb(&copy, user_data);
+        }
+        count++;
+    }
+
+    return count;
+}
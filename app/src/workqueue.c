@@ -9,16 +9,39 @@
 
 #include <zmk/workqueue.h>
 
+#if IS_ENABLED(CONFIG_ZMK_LOW_PRIORITY_WORK_QUEUE)
+
 K_THREAD_STACK_DEFINE(lowprio_q_stack, CONFIG_ZMK_LOW_PRIORITY_THREAD_STACK_SIZE);
 
 static struct k_work_q lowprio_work_q;
 
 struct k_work_q *zmk_workqueue_lowprio_work_q(void) { return &lowprio_work_q; }
 
+#endif // IS_ENABLED(CONFIG_ZMK_LOW_PRIORITY_WORK_QUEUE)
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_WORK_QUEUE)
+
+K_THREAD_STACK_DEFINE(input_q_stack, CONFIG_ZMK_INPUT_THREAD_STACK_SIZE);
+
+static struct k_work_q input_work_q;
+
+struct k_work_q *zmk_workqueue_input_work_q(void) { return &input_work_q; }
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_WORK_QUEUE)
+
 static int workqueue_init(void) {
+#if IS_ENABLED(CONFIG_ZMK_LOW_PRIORITY_WORK_QUEUE)
     static const struct k_work_queue_config queue_config = {.name = "Low Priority Work Queue"};
     k_work_queue_start(&lowprio_work_q, lowprio_q_stack, K_THREAD_STACK_SIZEOF(lowprio_q_stack),
                        CONFIG_ZMK_LOW_PRIORITY_THREAD_PRIORITY, &queue_config);
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_WORK_QUEUE)
+    static const struct k_work_queue_config input_queue_config = {.name = "Input Work Queue"};
+    k_work_queue_start(&input_work_q, input_q_stack, K_THREAD_STACK_SIZEOF(input_q_stack),
+                       CONFIG_ZMK_INPUT_THREAD_PRIORITY, &input_queue_config);
+#endif
+
     return 0;
 }
 
@@ -8,6 +8,8 @@
 #include <zephyr/init.h>
 #include <zephyr/kernel.h>
 
+#include <stdlib.h>
+
 #include <zephyr/logging/log.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
@@ -19,18 +21,32 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/wpm.h>
 
 #define WPM_UPDATE_INTERVAL_SECONDS 1
-#define WPM_RESET_INTERVAL_SECONDS 5
+// Keystrokes are counted over a window that slides by one update interval at a time
+#define WPM_WINDOW_INTERVALS 5
+// Changes smaller than this aren't raised, except to 0
+#define WPM_HYSTERESIS 2
 
 // See https://en.wikipedia.org/wiki/Words_per_minute
 // "Since the length or duration of words is clearly variable, for the purpose of measurement of
 // text entry, the definition of each "word" is often standardized to be five characters or
 // keystrokes long in English"
-#define CHARS_PER_WORD 5.0
+#define CHARS_PER_WORD 5
 
 static uint8_t wpm_state = -1;
-static uint8_t last_wpm_state;
+// Intervals of the window elapsed since typing started
 static uint8_t wpm_update_counter;
+// Keystrokes in the window, and in each of its intervals
 static uint32_t key_pressed_count;
+static uint16_t interval_key_counts[WPM_WINDOW_INTERVALS];
+static uint8_t current_interval;
+// The timer only runs until the window has no keystrokes left
+static bool wpm_timer_running;
+
+static struct k_spinlock wpm_lock;
+
+static void wpm_expiry_function(struct k_timer *_timer);
+
+K_TIMER_DEFINE(wpm_timer, wpm_expiry_function, NULL);
 
 int zmk_wpm_get_state(void) { return wpm_state; }
 
@@ -39,7 +55,20 @@ int wpm_event_listener(const zmk_event_t *eh) {
     if (ev) {
         // count only key up events
         if (!ev->state) {
+            k_spinlock_key_t key = k_spin_lock(&wpm_lock);
+
             key_pressed_count++;
+            interval_key_counts[current_interval] =
+                MIN(interval_key_counts[current_interval] + 1, UINT16_MAX);
+
+            // Typing started again, the window counts from this keystroke
+            if (!wpm_timer_running) {
+                wpm_timer_running = true;
+                k_timer_start(&wpm_timer, K_SECONDS(WPM_UPDATE_INTERVAL_SECONDS),
+                              K_SECONDS(WPM_UPDATE_INTERVAL_SECONDS));
+            }
+
+            k_spin_unlock(&wpm_lock, key);
             LOG_DBG("key_pressed_count %d keycode %d", key_pressed_count, ev->keycode);
         }
     }
@@ -47,35 +76,44 @@ int wpm_event_listener(const zmk_event_t *eh) {
 }
 
 void wpm_work_handler(struct k_work *work) {
-    wpm_update_counter++;
-    wpm_state = (key_pressed_count / CHARS_PER_WORD) /
-                (wpm_update_counter * WPM_UPDATE_INTERVAL_SECONDS / 60.0);
-
-    if (last_wpm_state != wpm_state) {
-        LOG_DBG("Raised WPM state changed %d wpm_update_counter %d", wpm_state, wpm_update_counter);
+    k_spinlock_key_t key = k_spin_lock(&wpm_lock);
+
+    wpm_update_counter = MIN(wpm_update_counter + 1, WPM_WINDOW_INTERVALS);
+    uint8_t counter = wpm_update_counter;
+    uint8_t wpm = MIN(key_pressed_count * 60 /
+                          (CHARS_PER_WORD * wpm_update_counter * WPM_UPDATE_INTERVAL_SECONDS),
+                      UINT8_MAX);
+
+    // The oldest interval leaves the window, and its slot counts the next one
+    current_interval = (current_interval + 1) % WPM_WINDOW_INTERVALS;
+    key_pressed_count -= interval_key_counts[current_interval];
+    interval_key_counts[current_interval] = 0;
+
+    // Once the window is empty, there's nothing left to update until the next keystroke
+    if (key_pressed_count == 0 && wpm == 0) {
+        k_timer_stop(&wpm_timer);
+        wpm_timer_running = false;
+        wpm_update_counter = 0;
+    }
 
-        raise_zmk_wpm_state_changed((struct zmk_wpm_state_changed){.state = wpm_state});
+    k_spin_unlock(&wpm_lock, key);
 
-        last_wpm_state = wpm_state;
-    }
+    int change = (int)wpm - (int)wpm_state;
+    if (change != 0 && (wpm == 0 || abs(change) >= WPM_HYSTERESIS)) {
+        LOG_DBG("Raised WPM state changed %d wpm_update_counter %d", wpm, counter);
 
-    if (wpm_update_counter >= WPM_RESET_INTERVAL_SECONDS) {
-        wpm_update_counter = 0;
-        key_pressed_count = 0;
+        wpm_state = wpm;
+        raise_zmk_wpm_state_changed((struct zmk_wpm_state_changed){.state = wpm_state});
     }
 }
 
 K_WORK_DEFINE(wpm_work, wpm_work_handler);
 
-void wpm_expiry_function(struct k_timer *_timer) { k_work_submit(&wpm_work); }
-
-K_TIMER_DEFINE(wpm_timer, wpm_expiry_function, NULL);
+static void wpm_expiry_function(struct k_timer *_timer) { k_work_submit(&wpm_work); }
 
 static int wpm_init(void) {
     wpm_state = 0;
     wpm_update_counter = 0;
-    k_timer_start(&wpm_timer, K_SECONDS(WPM_UPDATE_INTERVAL_SECONDS),
-                  K_SECONDS(WPM_UPDATE_INTERVAL_SECONDS));
     return 0;
 }
 
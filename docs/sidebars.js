@@ -70,6 +70,7 @@ module.exports = {
             "keymaps/behaviors/hold-tap",
             "keymaps/behaviors/mod-morph",
             "keymaps/behaviors/macros",
+            "keymaps/behaviors/type-string",
             "keymaps/behaviors/key-toggle",
             "keymaps/behaviors/sticky-key",
             "keymaps/behaviors/sticky-layer",
@@ -106,6 +107,7 @@ module.exports = {
             "keymaps/input-processors/transformer",
             "keymaps/input-processors/code-mapper",
             "keymaps/input-processors/temp-layer",
+            "keymaps/input-processors/acceleration",
           ],
         },
       ],
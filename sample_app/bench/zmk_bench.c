@@ -0,0 +1,683 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * zmk_bench — keystroke-to-report latency benchmark for the native_sim/native/zmk_ipc board.
+ *
+ * Sends key events on the kscan IPC socket, so they take the same path as any other kscan
+ * client, and receives the resulting HID reports on the IPC observer socket. It replays scripted
+ * workloads against the keymap in config/.
+ *
+ * Each workload runs twice:
+ *
+ *   latency     every step expected to produce a keyboard report is sent with a seq and a
+ *               host timestamp, and the benchmark waits for the report carrying that seq in
+ *               its LatencyTrace before sending the next step. The sample is the host time
+ *               from sending the event to receiving the report.
+ *   throughput  the steps are sent back to back, and only the last report of the last
+ *               repetition is traced. Events per second are the steps sent over the time
+ *               until that report arrived.
+ *
+ * Only the wire format of the handful of messages used here is implemented, so the benchmark
+ * builds with a plain C compiler and no protobuf library:
+ *
+ *   cc -O2 -o zmk_bench zmk_bench.c
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_SOCKET "/tmp/zmk_ipc.sock"
+#define DEFAULT_KSCAN_SOCKET "/tmp/zmk_kscan_ipc.sock"
+#define DEFAULT_ITERATIONS 200
+#define DEFAULT_TIMEOUT_MS 100
+
+/* ZmkEvent payload field numbers, also the Subscribe.event_mask bits */
+#define EVENT_KEYBOARD 2
+
+/* KeyEvent.Action */
+#define ACTION_PRESS 1
+#define ACTION_RELEASE 2
+
+/* Protobuf wire types */
+#define WT_VARINT 0
+#define WT_I64 1
+#define WT_LEN 2
+#define WT_I32 5
+
+#define FRAME_MAX 4096
+#define READ_BUF_SIZE 65536
+
+/* ------------------------------------------------------------------------------------------ */
+/* Workloads                                                                                  */
+/* ------------------------------------------------------------------------------------------ */
+
+struct step {
+    uint8_t action;
+    uint16_t position;
+    /* set if the step makes ZMK send a keyboard report, so it can be timed */
+    bool report;
+};
+
+#define TAP(p) {ACTION_PRESS, p, true}, {ACTION_RELEASE, p, true}
+#define PRESS(p, r) {ACTION_PRESS, p, r}
+#define RELEASE(p, r) {ACTION_RELEASE, p, r}
+
+/* Positions refer to config/native_sim.keymap */
+
+static const struct step typing_steps[] = {
+    TAP(0), TAP(1), TAP(2), TAP(3), TAP(4), TAP(5), TAP(6), TAP(7), TAP(8), TAP(9),
+};
+
+static const struct step home_row_mod_steps[] = {
+    /* taps resolve on release */
+    PRESS(12, false), RELEASE(12, true), PRESS(13, false), RELEASE(13, true),
+    PRESS(14, false), RELEASE(14, true), PRESS(18, false), RELEASE(18, true),
+    PRESS(19, false), RELEASE(19, true),
+    /* shift held over another key resolves when that key is released */
+    PRESS(15, false), PRESS(0, false), RELEASE(0, true), RELEASE(15, true),
+};
+
+static const struct step combo_steps[] = {
+    /* two key combos that no other combo contains fire on their second press */
+    PRESS(26, false), PRESS(27, true), RELEASE(26, true), RELEASE(27, false),
+    PRESS(29, false), PRESS(30, true), RELEASE(29, true), RELEASE(30, false),
+    PRESS(32, false), PRESS(33, true), RELEASE(32, true), RELEASE(33, false),
+    /* three key combos overlapping three two key ones */
+    PRESS(24, false), PRESS(25, false), PRESS(26, true), RELEASE(24, true),
+    RELEASE(25, false), RELEASE(26, false),
+    PRESS(30, false), PRESS(31, false), PRESS(32, true), RELEASE(30, true),
+    RELEASE(31, false), RELEASE(32, false),
+};
+
+static const struct step macro_steps[] = {
+    PRESS(34, true),
+    RELEASE(34, false),
+    TAP(0),
+};
+
+static const struct step layer_steps[] = {
+    /* momentary layer */
+    PRESS(36, false), TAP(0), RELEASE(36, false),
+    /* toggled on, then back to the base layer */
+    PRESS(37, false), RELEASE(37, false), TAP(1), PRESS(38, false), RELEASE(38, false),
+    TAP(2),
+};
+
+struct workload {
+    const char *name;
+    const struct step *steps;
+    size_t steps_len;
+};
+
+#define WORKLOAD(name, steps) {name, steps, sizeof(steps) / sizeof(steps[0])}
+
+static const struct workload workloads[] = {
+    WORKLOAD("typing", typing_steps),       WORKLOAD("home-row-mods", home_row_mod_steps),
+    WORKLOAD("combos", combo_steps),        WORKLOAD("macros", macro_steps),
+    WORKLOAD("layers", layer_steps),
+};
+
+#define WORKLOADS_LEN (sizeof(workloads) / sizeof(workloads[0]))
+
+/* ------------------------------------------------------------------------------------------ */
+/* Wire format                                                                                */
+/* ------------------------------------------------------------------------------------------ */
+
+static size_t put_varint(uint8_t *p, uint64_t v) {
+    size_t n = 0;
+    do {
+        p[n] = (v & 0x7F) | (v > 0x7F ? 0x80 : 0);
+        v >>= 7;
+        n++;
+    } while (v != 0);
+    return n;
+}
+
+static size_t put_tag(uint8_t *p, uint32_t field, uint8_t wire_type) {
+    return put_varint(p, (uint64_t)field << 3 | wire_type);
+}
+
+static size_t put_uint(uint8_t *p, uint32_t field, uint64_t v) {
+    size_t n = put_tag(p, field, WT_VARINT);
+    return n + put_varint(p + n, v);
+}
+
+/* Wraps @p body as field @p field of a ClientMessage, in a length-prefixed frame */
+static size_t put_client_frame(uint8_t *frame, uint32_t field, const uint8_t *body,
+                               size_t body_len) {
+    size_t n = 4;
+    n += put_tag(frame + n, field, WT_LEN);
+    n += put_varint(frame + n, body_len);
+    memcpy(frame + n, body, body_len);
+    n += body_len;
+
+    uint32_t payload_len = n - 4;
+    frame[0] = payload_len >> 24;
+    frame[1] = payload_len >> 16;
+    frame[2] = payload_len >> 8;
+    frame[3] = payload_len;
+    return n;
+}
+
+static size_t key_event_frame(uint8_t *frame, const struct step *step, uint32_t seq,
+                              uint64_t client_ts) {
+    uint8_t body[64];
+    size_t n = 0;
+
+    n += put_uint(body + n, 1, step->action);
+    n += put_uint(body + n, 3, step->position);
+    if (seq != 0) {
+        n += put_uint(body + n, 4, seq);
+        n += put_uint(body + n, 5, client_ts);
+    }
+
+    return put_client_frame(frame, 1, body, n);
+}
+
+static size_t subscribe_frame(uint8_t *frame, uint32_t event_mask) {
+    uint8_t body[16];
+    size_t n = put_uint(body, 1, event_mask);
+
+    return put_client_frame(frame, 3, body, n);
+}
+
+struct field {
+    uint32_t number;
+    uint8_t wire_type;
+    uint64_t value;
+    const uint8_t *data;
+    size_t len;
+};
+
+static bool get_varint(const uint8_t **p, const uint8_t *end, uint64_t *v) {
+    *v = 0;
+    for (int shift = 0; shift < 64 && *p < end; shift += 7) {
+        uint8_t b = *(*p)++;
+        *v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Reads the next field of a message, returning false at its end or on malformed input */
+static bool next_field(const uint8_t **p, const uint8_t *end, struct field *f) {
+    uint64_t tag;
+    if (*p >= end || !get_varint(p, end, &tag)) {
+        return false;
+    }
+
+    f->number = tag >> 3;
+    f->wire_type = tag & 0x07;
+
+    switch (f->wire_type) {
+    case WT_VARINT:
+        return get_varint(p, end, &f->value);
+    case WT_LEN:
+        if (!get_varint(p, end, &f->value) || f->value > (uint64_t)(end - *p)) {
+            return false;
+        }
+        f->data = *p;
+        f->len = f->value;
+        *p += f->len;
+        return true;
+    case WT_I64:
+    case WT_I32: {
+        size_t len = f->wire_type == WT_I64 ? 8 : 4;
+        if ((size_t)(end - *p) < len) {
+            return false;
+        }
+        *p += len;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+static bool find_field(const uint8_t *data, size_t len, uint32_t number, uint8_t wire_type,
+                       struct field *f) {
+    const uint8_t *p = data, *end = data + len;
+
+    while (next_field(&p, end, f)) {
+        if (f->number == number && f->wire_type == wire_type) {
+            return true;
+        }
+    }
+    return false;
+}
+
+struct trace {
+    uint32_t seq;
+    uint64_t client_ts;
+};
+
+/* Extracts ZmkEvent.keyboard.trace from an event payload */
+static bool keyboard_trace(const uint8_t *payload, size_t len, struct trace *trace) {
+    struct field keyboard, trace_msg, f;
+
+    if (!find_field(payload, len, EVENT_KEYBOARD, WT_LEN, &keyboard) ||
+        !find_field(keyboard.data, keyboard.len, 4, WT_LEN, &trace_msg)) {
+        return false;
+    }
+
+    *trace = (struct trace){0};
+    const uint8_t *p = trace_msg.data, *end = trace_msg.data + trace_msg.len;
+    while (next_field(&p, end, &f)) {
+        if (f.wire_type != WT_VARINT) {
+            continue;
+        }
+        if (f.number == 1) {
+            trace->seq = f.value;
+        } else if (f.number == 2) {
+            trace->client_ts = f.value;
+        }
+    }
+    return trace->seq != 0;
+}
+
+/* ------------------------------------------------------------------------------------------ */
+/* Connection                                                                                 */
+/* ------------------------------------------------------------------------------------------ */
+
+struct conn {
+    int fd;
+    size_t pos;
+    size_t len;
+    uint8_t buf[READ_BUF_SIZE];
+};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int conn_open(struct conn *conn, const char *path) {
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        return -ENAMETOOLONG;
+    }
+    strcpy(addr.sun_path, path);
+
+    conn->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (conn->fd < 0) {
+        return -errno;
+    }
+    if (connect(conn->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        int err = -errno;
+        close(conn->fd);
+        return err;
+    }
+
+    conn->pos = conn->len = 0;
+    return 0;
+}
+
+static int conn_send(struct conn *conn, const uint8_t *frame, size_t len) {
+    while (len > 0) {
+        ssize_t sent = send(conn->fd, frame, len, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -errno;
+        }
+        frame += sent;
+        len -= sent;
+    }
+    return 0;
+}
+
+/*
+ * Returns the next event payload in @p payload, waiting until @p deadline_ns for it.
+ * Returns 0 on success, -ETIMEDOUT at the deadline, or a negative errno.
+ */
+static int conn_next_event(struct conn *conn, uint64_t deadline_ns, const uint8_t **payload,
+                           size_t *len) {
+    for (;;) {
+        size_t avail = conn->len - conn->pos;
+        if (avail >= 4) {
+            const uint8_t *p = conn->buf + conn->pos;
+            uint32_t frame_len = (uint32_t)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3];
+            if (frame_len > FRAME_MAX) {
+                return -EMSGSIZE;
+            }
+            if (avail >= 4 + frame_len) {
+                *payload = p + 4;
+                *len = frame_len;
+                conn->pos += 4 + frame_len;
+                return 0;
+            }
+        }
+
+        // Move the partial frame to the front before refilling
+        memmove(conn->buf, conn->buf + conn->pos, avail);
+        conn->pos = 0;
+        conn->len = avail;
+
+        uint64_t now = now_ns();
+        if (now >= deadline_ns) {
+            return -ETIMEDOUT;
+        }
+
+        struct pollfd pfd = {.fd = conn->fd, .events = POLLIN};
+        int timeout_ms = (deadline_ns - now + 999999) / 1000000;
+        int ret = poll(&pfd, 1, timeout_ms);
+        if (ret < 0 && errno != EINTR) {
+            return -errno;
+        }
+        if (ret <= 0) {
+            continue;
+        }
+
+        ssize_t got = recv(conn->fd, conn->buf + conn->len, sizeof(conn->buf) - conn->len, 0);
+        if (got == 0) {
+            return -ECONNRESET;
+        }
+        if (got < 0 && errno != EINTR && errno != EAGAIN) {
+            return -errno;
+        }
+        if (got > 0) {
+            conn->len += got;
+        }
+    }
+}
+
+/* Waits for the keyboard report traced with @p seq, returning its send-to-receive time */
+static int wait_for_trace(struct conn *conn, uint32_t seq, uint64_t timeout_ns,
+                          uint64_t *latency_ns) {
+    uint64_t deadline = now_ns() + timeout_ns;
+
+    for (;;) {
+        const uint8_t *payload;
+        size_t len;
+        int err = conn_next_event(conn, deadline, &payload, &len);
+        if (err < 0) {
+            return err;
+        }
+
+        struct trace trace;
+        if (keyboard_trace(payload, len, &trace) && trace.seq == seq) {
+            *latency_ns = now_ns() - trace.client_ts;
+            return 0;
+        }
+    }
+}
+
+/* Discards whatever the previous runs left queued */
+static void drain(struct conn *conn, uint64_t quiet_ns) {
+    const uint8_t *payload;
+    size_t len;
+
+    while (conn_next_event(conn, now_ns() + quiet_ns, &payload, &len) == 0) {
+    }
+}
+
+/* ------------------------------------------------------------------------------------------ */
+/* Runs                                                                                       */
+/* ------------------------------------------------------------------------------------------ */
+
+struct options {
+    const char *socket_path;
+    const char *kscan_socket_path;
+    unsigned iterations;
+    uint64_t timeout_ns;
+};
+
+struct result {
+    uint64_t *samples;
+    size_t samples_len;
+    size_t missed;
+    double events_per_sec;
+};
+
+static uint32_t next_seq = 1;
+
+static uint32_t take_seq(void) {
+    uint32_t seq = next_seq++;
+    if (next_seq == 0) {
+        next_seq = 1;
+    }
+    return seq;
+}
+
+static int send_step(struct conn *conn, const struct step *step, uint32_t seq) {
+    uint8_t frame[128];
+    size_t len = key_event_frame(frame, step, seq, seq != 0 ? now_ns() : 0);
+
+    return conn_send(conn, frame, len);
+}
+
+static int run_latency(struct conn *kscan, struct conn *conn, const struct workload *w,
+                       const struct options *opts, struct result *res) {
+    for (unsigned i = 0; i < opts->iterations; i++) {
+        for (size_t s = 0; s < w->steps_len; s++) {
+            const struct step *step = &w->steps[s];
+            uint32_t seq = step->report ? take_seq() : 0;
+
+            int err = send_step(kscan, step, seq);
+            if (err < 0) {
+                return err;
+            }
+            if (seq == 0) {
+                continue;
+            }
+
+            uint64_t latency;
+            err = wait_for_trace(conn, seq, opts->timeout_ns, &latency);
+            if (err == -ETIMEDOUT) {
+                res->missed++;
+                continue;
+            }
+            if (err < 0) {
+                return err;
+            }
+            res->samples[res->samples_len++] = latency;
+        }
+    }
+    return 0;
+}
+
+static int run_throughput(struct conn *kscan, struct conn *conn, const struct workload *w,
+                          const struct options *opts, struct result *res) {
+    size_t last = w->steps_len - 1;
+    uint32_t seq = 0;
+
+    // The last step of the script making a report is the only one traced
+    while (!w->steps[last].report) {
+        last--;
+    }
+
+    uint64_t start = now_ns();
+    for (unsigned i = 0; i < opts->iterations; i++) {
+        for (size_t s = 0; s < w->steps_len; s++) {
+            bool traced = i == opts->iterations - 1 && s == last;
+            if (traced) {
+                seq = take_seq();
+            }
+
+            int err = send_step(kscan, &w->steps[s], traced ? seq : 0);
+            if (err < 0) {
+                return err;
+            }
+        }
+    }
+
+    uint64_t latency;
+    // Every event queued before the traced one has to be processed first
+    int err = wait_for_trace(conn, seq, opts->timeout_ns * opts->iterations * w->steps_len,
+                             &latency);
+    if (err < 0) {
+        return err;
+    }
+
+    double elapsed_s = (now_ns() - start) / 1e9;
+    res->events_per_sec = opts->iterations * w->steps_len / elapsed_s;
+    return 0;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+/* Nearest-rank percentile, in microseconds */
+static double percentile_us(const struct result *res, double pct) {
+    if (res->samples_len == 0) {
+        return 0;
+    }
+
+    size_t rank = (size_t)(pct / 100.0 * res->samples_len + 0.999999);
+    rank = rank == 0 ? 1 : rank > res->samples_len ? res->samples_len : rank;
+    return res->samples[rank - 1] / 1000.0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [-s socket] [-k socket] [-n iterations] [-t timeout-ms] [workload...]\n"
+            "\n"
+            "  -s  IPC observer socket (default " DEFAULT_SOCKET ")\n"
+            "  -k  kscan IPC socket (default " DEFAULT_KSCAN_SOCKET ")\n"
+            "  -n  repetitions of each workload script (default %d)\n"
+            "  -t  time to wait for each traced report (default %d ms)\n"
+            "\n"
+            "workloads:",
+            prog, DEFAULT_ITERATIONS, DEFAULT_TIMEOUT_MS);
+    for (size_t i = 0; i < WORKLOADS_LEN; i++) {
+        fprintf(stderr, " %s", workloads[i].name);
+    }
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char **argv) {
+    struct options opts = {
+        .socket_path = DEFAULT_SOCKET,
+        .kscan_socket_path = DEFAULT_KSCAN_SOCKET,
+        .iterations = DEFAULT_ITERATIONS,
+        .timeout_ns = DEFAULT_TIMEOUT_MS * 1000000ULL,
+    };
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:k:n:t:h")) != -1) {
+        switch (opt) {
+        case 's':
+            opts.socket_path = optarg;
+            break;
+        case 'k':
+            opts.kscan_socket_path = optarg;
+            break;
+        case 'n':
+            opts.iterations = strtoul(optarg, NULL, 10);
+            break;
+        case 't':
+            opts.timeout_ns = strtoull(optarg, NULL, 10) * 1000000ULL;
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if (opts.iterations == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    bool selected[WORKLOADS_LEN] = {false};
+    bool any_selected = optind < argc;
+    for (int a = optind; a < argc; a++) {
+        size_t i;
+        for (i = 0; i < WORKLOADS_LEN; i++) {
+            if (strcmp(argv[a], workloads[i].name) == 0) {
+                selected[i] = true;
+                break;
+            }
+        }
+        if (i == WORKLOADS_LEN) {
+            fprintf(stderr, "unknown workload: %s\n", argv[a]);
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    static struct conn conn, kscan;
+    int err = conn_open(&conn, opts.socket_path);
+    if (err < 0) {
+        fprintf(stderr, "failed to connect to %s: %s\n", opts.socket_path, strerror(-err));
+        return 1;
+    }
+
+    err = conn_open(&kscan, opts.kscan_socket_path);
+    if (err < 0) {
+        fprintf(stderr, "failed to connect to %s: %s\n", opts.kscan_socket_path,
+                strerror(-err));
+        return 1;
+    }
+
+    // Only keyboard reports carry traces
+    uint8_t frame[32];
+    err = conn_send(&conn, frame, subscribe_frame(frame, 1U << EVENT_KEYBOARD));
+    if (err < 0) {
+        fprintf(stderr, "failed to subscribe: %s\n", strerror(-err));
+        return 1;
+    }
+
+    printf("%-14s %8s %7s %10s %10s %10s %12s\n", "workload", "samples", "missed", "p50 us",
+           "p99 us", "p99.9 us", "events/s");
+
+    for (size_t i = 0; i < WORKLOADS_LEN; i++) {
+        const struct workload *w = &workloads[i];
+        if (any_selected && !selected[i]) {
+            continue;
+        }
+
+        struct result res = {
+            .samples = calloc((size_t)opts.iterations * w->steps_len, sizeof(uint64_t)),
+        };
+        if (res.samples == NULL) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+
+        drain(&conn, 20000000ULL);
+        err = run_latency(&kscan, &conn, w, &opts, &res);
+        if (err == 0) {
+            drain(&conn, 20000000ULL);
+            err = run_throughput(&kscan, &conn, w, &opts, &res);
+        }
+        if (err < 0) {
+            fprintf(stderr, "%s: %s\n", w->name, strerror(-err));
+            free(res.samples);
+            return 1;
+        }
+
+        qsort(res.samples, res.samples_len, sizeof(uint64_t), compare_u64);
+        printf("%-14s %8zu %7zu %10.1f %10.1f %10.1f %12.0f\n", w->name, res.samples_len,
+               res.missed, percentile_us(&res, 50), percentile_us(&res, 99),
+               percentile_us(&res, 99.9), res.events_per_sec);
+        fflush(stdout);
+
+        free(res.samples);
+    }
+
+    close(kscan.fd);
+    close(conn.fd);
+    return 0;
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "zmk_ipc_client.h"
+
+#include <pb_decode.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+_Static_assert(ZMK_IPC_CLIENT_RX_BUF_SIZE >= ZMK_IPC_EVENT_FRAME_MAX,
+               "receive buffer can't hold the largest event");
+_Static_assert(ZMK_IPC_CLIENT_TX_BUF_SIZE >= ZMK_IPC_MSG_FRAME_MAX,
+               "send buffer can't hold the largest client message");
+
+int zmk_ipc_client_connect(struct zmk_ipc_client *client, const char *path) {
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+
+    client->fd = -1;
+    client->rx_pos = client->rx_len = 0;
+    client->tx_pos = client->tx_len = 0;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        return -ENAMETOOLONG;
+    }
+    strcpy(addr.sun_path, path);
+
+    client->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (client->fd < 0) {
+        return -errno;
+    }
+
+    if (connect(client->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        int err = -errno;
+
+        if (err == -EINPROGRESS) {
+            return err;
+        }
+        zmk_ipc_client_close(client);
+        return err;
+    }
+    return 0;
+}
+
+int zmk_ipc_client_connect_finish(struct zmk_ipc_client *client) {
+    int err = 0;
+    socklen_t len = sizeof(err);
+
+    if (getsockopt(client->fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0) {
+        return -errno;
+    }
+    if (err == 0) {
+        // SO_ERROR is also 0 while the connection is pending; only a peer makes it complete
+        struct sockaddr_un peer;
+        socklen_t peer_len = sizeof(peer);
+
+        if (getpeername(client->fd, (struct sockaddr *)&peer, &peer_len) < 0) {
+            return errno == ENOTCONN ? -EINPROGRESS : -errno;
+        }
+    }
+    return -err;
+}
+
+void zmk_ipc_client_close(struct zmk_ipc_client *client) {
+    if (client->fd >= 0) {
+        close(client->fd);
+    }
+    client->fd = -1;
+    client->rx_pos = client->rx_len = 0;
+    client->tx_pos = client->tx_len = 0;
+}
+
+int zmk_ipc_client_fd(const struct zmk_ipc_client *client) { return client->fd; }
+
+size_t zmk_ipc_client_pending(const struct zmk_ipc_client *client) {
+    return client->tx_len - client->tx_pos;
+}
+
+int zmk_ipc_client_flush(struct zmk_ipc_client *client) {
+    while (client->tx_pos < client->tx_len) {
+        ssize_t sent = send(client->fd, client->tx + client->tx_pos,
+                            client->tx_len - client->tx_pos, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EWOULDBLOCK ? -EAGAIN : -errno;
+        }
+        client->tx_pos += (size_t)sent;
+    }
+
+    client->tx_pos = client->tx_len = 0;
+    return 0;
+}
+
+int zmk_ipc_client_queue(struct zmk_ipc_client *client, const zmk_ipc_ClientMessage *msg) {
+    // Worst case size, so a message is never encoded twice because it didn't fit
+    if (sizeof(client->tx) - client->tx_len < ZMK_IPC_MSG_FRAME_MAX) {
+        int err = zmk_ipc_client_flush(client);
+        if (err < 0 && err != -EAGAIN) {
+            return err;
+        }
+
+        // Move a partially sent tail to the front to make room behind it
+        size_t pending = client->tx_len - client->tx_pos;
+        memmove(client->tx, client->tx + client->tx_pos, pending);
+        client->tx_pos = 0;
+        client->tx_len = pending;
+
+        if (sizeof(client->tx) - client->tx_len < ZMK_IPC_MSG_FRAME_MAX) {
+            return -ENOBUFS;
+        }
+    }
+
+    size_t frame_len;
+    int err = zmk_ipc_encode_frame(&zmk_ipc_ClientMessage_msg, msg, client->tx + client->tx_len,
+                                   sizeof(client->tx) - client->tx_len, &frame_len);
+    if (err < 0) {
+        return err;
+    }
+
+    client->tx_len += frame_len;
+    return 0;
+}
+
+/* Pull whatever the socket has available into the free tail of the receive buffer */
+static int client_fill(struct zmk_ipc_client *client) {
+    size_t pending = client->rx_len - client->rx_pos;
+
+    if (client->rx_pos > 0) {
+        memmove(client->rx, client->rx + client->rx_pos, pending);
+        client->rx_pos = 0;
+        client->rx_len = pending;
+    }
+
+    for (;;) {
+        ssize_t n = recv(client->fd, client->rx + client->rx_len,
+                         sizeof(client->rx) - client->rx_len, 0);
+        if (n == 0) {
+            return -ECONNRESET;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EWOULDBLOCK ? -EAGAIN : -errno;
+        }
+        client->rx_len += (size_t)n;
+        return 0;
+    }
+}
+
+int zmk_ipc_client_next_frame(struct zmk_ipc_client *client, const uint8_t **payload,
+                              size_t *len) {
+    // At most one refill: the socket is non-blocking, so a second recv() only returns -EAGAIN
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int err = zmk_ipc_frame_peek(client->rx + client->rx_pos,
+                                     client->rx_len - client->rx_pos, zmk_ipc_ZmkEvent_size, len);
+        if (err == 0) {
+            *payload = client->rx + client->rx_pos + 4;
+            client->rx_pos += 4 + *len;
+            return 0;
+        }
+        if (err != -EAGAIN || attempt > 0) {
+            return err;
+        }
+
+        err = client_fill(client);
+        if (err < 0) {
+            return err;
+        }
+    }
+    return -EAGAIN;
+}
+
+int zmk_ipc_client_next_event(struct zmk_ipc_client *client, zmk_ipc_ZmkEvent *event) {
+    const uint8_t *payload;
+    size_t len;
+
+    int err = zmk_ipc_client_next_frame(client, &payload, &len);
+    if (err < 0) {
+        return err;
+    }
+
+    pb_istream_t stream = pb_istream_from_buffer(payload, len);
+    *event = (zmk_ipc_ZmkEvent)zmk_ipc_ZmkEvent_init_zero;
+    return pb_decode(&stream, &zmk_ipc_ZmkEvent_msg, event) ? 0 : -EBADMSG;
+}
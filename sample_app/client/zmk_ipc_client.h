@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * zmk_ipc_client — host-side C client for the ZMK IPC sockets.
+ *
+ * Built on the same nanopb-generated code (zmk_ipc.pb.c) and framing
+ * (zmk_ipc_framing.c) as the firmware, so it always matches the protocol
+ * ZMK speaks. The connection is non-blocking from the start and never
+ * allocates: the receive and send buffers live in struct zmk_ipc_client,
+ * and events are decoded into a zmk_ipc_ZmkEvent the caller owns. All
+ * messages are nanopb STATIC types, so decoding needs no callbacks.
+ *
+ * Sending is batched: zmk_ipc_client_queue() only encodes a ClientMessage
+ * into the send buffer, and zmk_ipc_client_flush() hands everything queued
+ * to the kernel in as few send() calls as the socket accepts.
+ *
+ * Typical loop, with the fd from zmk_ipc_client_fd() in poll():
+ *
+ *     zmk_ipc_client_queue(&client, &msg);    // any number of times
+ *     zmk_ipc_client_flush(&client);          // -EAGAIN: wait for POLLOUT
+ *
+ *     while ((err = zmk_ipc_client_next_event(&client, &event)) == 0) {
+ *         ...                                 // -EAGAIN: wait for POLLIN
+ *     }
+ *
+ * Build with the nanopb runtime of the west workspace, e.g. as a static
+ * library or, for FFI bindings, as a shared one:
+ *
+ *   NANOPB=modules/lib/nanopb
+ *   cc -O2 -shared -fPIC -o libzmk_ipc_client.so \
+ *       -I zmk/app/src/ipc_pb -I $NANOPB \
+ *       zmk/sample_app/client/zmk_ipc_client.c \
+ *       zmk/app/src/ipc_pb/zmk_ipc.pb.c zmk/app/src/ipc_pb/zmk_ipc_framing.c \
+ *       $NANOPB/pb_common.c $NANOPB/pb_encode.c $NANOPB/pb_decode.c
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "zmk_ipc.pb.h"
+#include "zmk_ipc_framing.h"
+
+#define ZMK_IPC_CLIENT_OBSERVER_SOCKET "/tmp/zmk_ipc.sock"
+#define ZMK_IPC_CLIENT_KSCAN_SOCKET    "/tmp/zmk_kscan_ipc.sock"
+
+/* Receive buffer: a few hundred typical events per recv() */
+#ifndef ZMK_IPC_CLIENT_RX_BUF_SIZE
+#define ZMK_IPC_CLIENT_RX_BUF_SIZE (64U * 1024U)
+#endif
+
+/* Send buffer: must hold at least one maximum-size ClientMessage frame */
+#ifndef ZMK_IPC_CLIENT_TX_BUF_SIZE
+#define ZMK_IPC_CLIENT_TX_BUF_SIZE (8U * ZMK_IPC_MSG_FRAME_MAX)
+#endif
+
+struct zmk_ipc_client {
+    int fd;
+    size_t rx_pos; /* offset of the first unconsumed received byte */
+    size_t rx_len; /* number of valid bytes in rx */
+    size_t tx_pos; /* offset of the first byte not yet sent */
+    size_t tx_len; /* number of queued bytes in tx */
+    uint8_t rx[ZMK_IPC_CLIENT_RX_BUF_SIZE];
+    uint8_t tx[ZMK_IPC_CLIENT_TX_BUF_SIZE];
+};
+
+/**
+ * @brief Start connecting @p client to the Unix socket at @p path.
+ *
+ * The socket is non-blocking. A Unix socket normally connects at once; if
+ * ZMK's listen backlog is full, -EAGAIN is returned and the caller retries
+ * later. -EINPROGRESS means the connection completes in the background:
+ * wait for POLLOUT and call zmk_ipc_client_connect_finish().
+ *
+ * @retval 0 if connected.
+ * @retval -EINPROGRESS if the connection is still being set up.
+ * @retval -EAGAIN if the server can't take the connection yet.
+ * @retval negative errno for other failures; the client is closed.
+ */
+int zmk_ipc_client_connect(struct zmk_ipc_client *client, const char *path);
+
+/**
+ * @brief Complete a connection zmk_ipc_client_connect() left in progress.
+ *
+ * @retval 0 if connected, -EINPROGRESS if still pending, or the negative
+ *         errno the connection failed with.
+ */
+int zmk_ipc_client_connect_finish(struct zmk_ipc_client *client);
+
+/**
+ * @brief Close the connection and discard buffered data.
+ */
+void zmk_ipc_client_close(struct zmk_ipc_client *client);
+
+/**
+ * @brief Return the socket of @p client, for poll(), epoll or an event loop.
+ */
+int zmk_ipc_client_fd(const struct zmk_ipc_client *client);
+
+/**
+ * @brief Encode @p msg into the send buffer, without sending it.
+ *
+ * If the buffer is full, already queued bytes are flushed first.
+ *
+ * @retval 0 on success.
+ * @retval -ENOBUFS if the socket doesn't take enough queued bytes to make
+ *         room; flush once it is writable and queue @p msg again.
+ * @retval -EIO if nanopb can't encode @p msg.
+ * @retval negative errno for send errors.
+ */
+int zmk_ipc_client_queue(struct zmk_ipc_client *client, const zmk_ipc_ClientMessage *msg);
+
+/**
+ * @brief Send what zmk_ipc_client_queue() buffered.
+ *
+ * @retval 0 when the send buffer is empty.
+ * @retval -EAGAIN if the socket is full; wait for POLLOUT and call again.
+ * @retval negative errno for other send errors.
+ */
+int zmk_ipc_client_flush(struct zmk_ipc_client *client);
+
+/**
+ * @brief Return the number of queued bytes not sent yet.
+ */
+size_t zmk_ipc_client_pending(const struct zmk_ipc_client *client);
+
+/**
+ * @brief Return the payload of the next received frame without decoding it.
+ *
+ * For bindings with their own protobuf decoder. @p payload points into the
+ * receive buffer and stays valid until the next call on @p client.
+ *
+ * @retval 0 on success.
+ * @retval -EAGAIN if no complete frame has arrived; wait for POLLIN.
+ * @retval -ECONNRESET if ZMK closed the connection.
+ * @retval -EMSGSIZE if the length prefix exceeds the largest ZmkEvent; the
+ *         stream can't be resynchronised and has to be reconnected.
+ * @retval negative errno for other recv errors.
+ */
+int zmk_ipc_client_next_frame(struct zmk_ipc_client *client, const uint8_t **payload,
+                              size_t *len);
+
+/**
+ * @brief Decode the next received event into @p event.
+ *
+ * Returns the same codes as zmk_ipc_client_next_frame(), plus -EBADMSG if
+ * the frame doesn't decode. That frame has been consumed, so the stream
+ * remains usable.
+ */
+int zmk_ipc_client_next_event(struct zmk_ipc_client *client, zmk_ipc_ZmkEvent *event);
@@ -19,11 +19,13 @@ from zmk_client import ZmkIpcClient
 from watch_events import format_event
 
 
-COLUMNS = 12   # must match the DTS `columns` property
+# The DTS `columns` of native_sim/native/zmk_ipc, for firmware that doesn't
+# answer Hello.
+DEFAULT_COLUMNS = 12
 
 
-def pos_to_rc(pos: int) -> tuple[int, int]:
-    return pos // COLUMNS, pos % COLUMNS
+def pos_to_rc(pos: int, columns: int) -> tuple[int, int]:
+    return pos // columns, pos % columns
 
 
 def print_help() -> None:
@@ -61,6 +63,12 @@ def main() -> None:
 
     print("Connected to both sockets.")
 
+    caps = client.hello()
+    columns = caps.columns if caps and caps.columns else DEFAULT_COLUMNS
+    if caps:
+        print(f"Protocol version {caps.protocol_version}, "
+              f"{caps.rows}x{caps.columns} key matrix.")
+
     # ----------------------------------------------------------------
     # Background event watcher
     # ----------------------------------------------------------------
@@ -122,7 +130,7 @@ def main() -> None:
                 print(f"Unknown command: {line!r}  (type 'h' for help)")
                 continue
 
-            row, col = pos_to_rc(pos)
+            row, col = pos_to_rc(pos, columns)
             print(f"  PRESS   position={pos} (row={row}, col={col})")
             client.send_key_press(pos)
             time.sleep(0.05)
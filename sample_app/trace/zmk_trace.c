@@ -0,0 +1,788 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * zmk_trace — records key position traces from the IPC observer and replays them into the
+ * kscan IPC driver of the native_sim/native/zmk_ipc board.
+ *
+ *   record  subscribes to the KscanEvent stream of the observer socket and appends every
+ *           position change to a trace file until interrupted.
+ *   play    streams a trace into the kscan IPC socket, either with its original timing, sped
+ *           up by a factor, or in virtual time: each gap becomes an AdvanceTime message, so a
+ *           board built with CONFIG_ZMK_KSCAN_IPC_VIRTUAL_TIME replays it as fast as the host
+ *           allows with the timing the keymap saw.
+ *   dump    prints a trace as text.
+ *
+ * Trace format, with integers as unsigned LEB128 varints like in protobuf:
+ *
+ *   header  "ZMKT", a version byte (1) and three reserved zero bytes
+ *   record  varint ms since the previous record, or since the first one for the first
+ *           varint position << 1 | pressed
+ *
+ * A typical record is two bytes. The source of a position (local or a split peripheral) is
+ * not kept: positions are global, and a replay injects all of them locally. Traces are read
+ * through mmap(), so sessions of any length replay without being loaded whole.
+ *
+ * As with zmk_bench, only the wire format of the messages used here is implemented, so the
+ * tool builds with a plain C compiler and no protobuf library:
+ *
+ *   cc -O2 -o zmk_trace zmk_trace.c
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_OBSERVER_SOCKET "/tmp/zmk_ipc.sock"
+#define DEFAULT_KSCAN_SOCKET "/tmp/zmk_kscan_ipc.sock"
+
+#define TRACE_MAGIC "ZMKT"
+#define TRACE_VERSION 1
+#define TRACE_HEADER_SIZE 8
+
+/* ZmkEvent payload field numbers, also the Subscribe.event_mask bits */
+#define EVENT_KSCAN 1
+
+/* ClientMessage payload field numbers */
+#define CLIENT_KEY_BATCH 2
+#define CLIENT_SUBSCRIBE 3
+#define CLIENT_ADVANCE_TIME 4
+
+/* KeyEvent.Action */
+#define ACTION_PRESS 1
+#define ACTION_RELEASE 2
+
+/* Protobuf wire types */
+#define WT_VARINT 0
+#define WT_I64 1
+#define WT_LEN 2
+#define WT_I32 5
+
+#define FRAME_MAX 4096
+#define READ_BUF_SIZE 65536
+
+/* Matches the max_count of KeyEventBatch.events in zmk_ipc.options */
+#define BATCH_MAX 256
+/* A KeyEvent of a batch is at most 2 + 2 + 6 bytes, plus its own tag and length */
+#define BATCH_EVENT_MAX 12
+/* Frames are collected and written in chunks of about this size */
+#define SEND_BUF_SIZE 65536
+
+/* ------------------------------------------------------------------------------------------ */
+/* Wire format                                                                                */
+/* ------------------------------------------------------------------------------------------ */
+
+static size_t put_varint(uint8_t *p, uint64_t v) {
+    size_t n = 0;
+    do {
+        p[n] = (v & 0x7F) | (v > 0x7F ? 0x80 : 0);
+        v >>= 7;
+        n++;
+    } while (v != 0);
+    return n;
+}
+
+static size_t put_tag(uint8_t *p, uint32_t field, uint8_t wire_type) {
+    return put_varint(p, (uint64_t)field << 3 | wire_type);
+}
+
+static size_t put_uint(uint8_t *p, uint32_t field, uint64_t v) {
+    size_t n = put_tag(p, field, WT_VARINT);
+    return n + put_varint(p + n, v);
+}
+
+/* Wraps @p body as field @p field of a ClientMessage, in a length-prefixed frame */
+static size_t put_client_frame(uint8_t *frame, uint32_t field, const uint8_t *body,
+                               size_t body_len) {
+    size_t n = 4;
+    n += put_tag(frame + n, field, WT_LEN);
+    n += put_varint(frame + n, body_len);
+    memcpy(frame + n, body, body_len);
+    n += body_len;
+
+    uint32_t payload_len = n - 4;
+    frame[0] = payload_len >> 24;
+    frame[1] = payload_len >> 16;
+    frame[2] = payload_len >> 8;
+    frame[3] = payload_len;
+    return n;
+}
+
+static size_t subscribe_frame(uint8_t *frame, uint32_t event_mask) {
+    uint8_t body[16];
+    size_t n = put_uint(body, 1, event_mask);
+
+    return put_client_frame(frame, CLIENT_SUBSCRIBE, body, n);
+}
+
+static size_t advance_time_frame(uint8_t *frame, uint32_t ms) {
+    uint8_t body[16];
+    size_t n = put_uint(body, 1, ms);
+
+    return put_client_frame(frame, CLIENT_ADVANCE_TIME, body, n);
+}
+
+struct field {
+    uint32_t number;
+    uint8_t wire_type;
+    uint64_t value;
+    const uint8_t *data;
+    size_t len;
+};
+
+static bool get_varint(const uint8_t **p, const uint8_t *end, uint64_t *v) {
+    *v = 0;
+    for (int shift = 0; shift < 64 && *p < end; shift += 7) {
+        uint8_t b = *(*p)++;
+        *v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Reads the next field of a message, returning false at its end or on malformed input */
+static bool next_field(const uint8_t **p, const uint8_t *end, struct field *f) {
+    uint64_t tag;
+    if (*p >= end || !get_varint(p, end, &tag)) {
+        return false;
+    }
+
+    f->number = tag >> 3;
+    f->wire_type = tag & 0x07;
+
+    switch (f->wire_type) {
+    case WT_VARINT:
+        return get_varint(p, end, &f->value);
+    case WT_LEN:
+        if (!get_varint(p, end, &f->value) || f->value > (uint64_t)(end - *p)) {
+            return false;
+        }
+        f->data = *p;
+        f->len = f->value;
+        *p += f->len;
+        return true;
+    case WT_I64:
+    case WT_I32: {
+        size_t len = f->wire_type == WT_I64 ? 8 : 4;
+        if ((size_t)(end - *p) < len) {
+            return false;
+        }
+        *p += len;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+static bool find_field(const uint8_t *data, size_t len, uint32_t number, uint8_t wire_type,
+                       struct field *f) {
+    const uint8_t *p = data, *end = data + len;
+
+    while (next_field(&p, end, f)) {
+        if (f->number == number && f->wire_type == wire_type) {
+            return true;
+        }
+    }
+    return false;
+}
+
+struct key_change {
+    uint32_t position;
+    bool pressed;
+    int64_t timestamp;
+};
+
+/* Extracts ZmkEvent.kscan_event from an event payload; unset fields are proto3 defaults */
+static bool kscan_event(const uint8_t *payload, size_t len, struct key_change *change) {
+    struct field kscan, f;
+
+    if (!find_field(payload, len, EVENT_KSCAN, WT_LEN, &kscan)) {
+        return false;
+    }
+
+    *change = (struct key_change){0};
+    const uint8_t *p = kscan.data, *end = kscan.data + kscan.len;
+    while (next_field(&p, end, &f)) {
+        if (f.wire_type != WT_VARINT) {
+            continue;
+        }
+        if (f.number == 2) {
+            change->position = f.value;
+        } else if (f.number == 3) {
+            change->pressed = f.value != 0;
+        } else if (f.number == 4) {
+            change->timestamp = (int64_t)f.value;
+        }
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------------------------ */
+/* Connection                                                                                 */
+/* ------------------------------------------------------------------------------------------ */
+
+struct conn {
+    int fd;
+    size_t pos;
+    size_t len;
+    uint8_t buf[READ_BUF_SIZE];
+};
+
+static volatile sig_atomic_t interrupted;
+
+static void on_signal(int sig) { interrupted = 1; }
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int conn_open(struct conn *conn, const char *path) {
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        return -ENAMETOOLONG;
+    }
+    strcpy(addr.sun_path, path);
+
+    conn->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (conn->fd < 0) {
+        return -errno;
+    }
+    if (connect(conn->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        int err = -errno;
+        close(conn->fd);
+        return err;
+    }
+
+    conn->pos = conn->len = 0;
+    return 0;
+}
+
+static int conn_send(struct conn *conn, const uint8_t *frame, size_t len) {
+    while (len > 0) {
+        ssize_t sent = send(conn->fd, frame, len, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR && !interrupted) {
+                continue;
+            }
+            return -errno;
+        }
+        frame += sent;
+        len -= sent;
+    }
+    return 0;
+}
+
+/*
+ * Returns the next event payload in @p payload, blocking until one arrives.
+ * Returns 0 on success, -EINTR once interrupted, or a negative errno.
+ */
+static int conn_next_event(struct conn *conn, const uint8_t **payload, size_t *len) {
+    for (;;) {
+        size_t avail = conn->len - conn->pos;
+        if (avail >= 4) {
+            const uint8_t *p = conn->buf + conn->pos;
+            uint32_t frame_len = (uint32_t)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3];
+            if (frame_len > FRAME_MAX) {
+                return -EMSGSIZE;
+            }
+            if (avail >= 4 + frame_len) {
+                *payload = p + 4;
+                *len = frame_len;
+                conn->pos += 4 + frame_len;
+                return 0;
+            }
+        }
+
+        // Move the partial frame to the front before refilling
+        memmove(conn->buf, conn->buf + conn->pos, avail);
+        conn->pos = 0;
+        conn->len = avail;
+
+        ssize_t got = recv(conn->fd, conn->buf + conn->len, sizeof(conn->buf) - conn->len, 0);
+        if (got == 0) {
+            return -ECONNRESET;
+        }
+        if (got < 0) {
+            if (errno == EINTR && !interrupted) {
+                continue;
+            }
+            return -errno;
+        }
+        conn->len += got;
+    }
+}
+
+/* ------------------------------------------------------------------------------------------ */
+/* Trace files                                                                                */
+/* ------------------------------------------------------------------------------------------ */
+
+struct trace_reader {
+    const uint8_t *data;
+    size_t size;
+    const uint8_t *p;
+    const uint8_t *end;
+};
+
+static int trace_open(struct trace_reader *reader, const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -errno;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        int err = -errno;
+        close(fd);
+        return err;
+    }
+    if ((size_t)st.st_size < TRACE_HEADER_SIZE) {
+        close(fd);
+        return -EINVAL;
+    }
+
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    int err = data == MAP_FAILED ? -errno : 0;
+    close(fd);
+    if (err < 0) {
+        return err;
+    }
+
+    // Pages are only touched once, front to back
+    madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+    reader->data = data;
+    reader->size = st.st_size;
+    if (memcmp(reader->data, TRACE_MAGIC, 4) != 0 || reader->data[4] != TRACE_VERSION) {
+        munmap(data, st.st_size);
+        return -EINVAL;
+    }
+
+    reader->p = reader->data + TRACE_HEADER_SIZE;
+    reader->end = reader->data + reader->size;
+    return 0;
+}
+
+static void trace_close(struct trace_reader *reader) {
+    munmap((void *)reader->data, reader->size);
+}
+
+struct trace_record {
+    uint64_t delta_ms;
+    uint32_t position;
+    bool pressed;
+};
+
+/* Returns 1 with the next record, 0 at the end of the trace, or -EILSEQ if it's truncated */
+static int trace_next(struct trace_reader *reader, struct trace_record *record) {
+    uint64_t key;
+
+    if (reader->p == reader->end) {
+        return 0;
+    }
+    if (!get_varint(&reader->p, reader->end, &record->delta_ms) ||
+        !get_varint(&reader->p, reader->end, &key) || key >> 1 > UINT32_MAX) {
+        return -EILSEQ;
+    }
+
+    record->position = key >> 1;
+    record->pressed = key & 1;
+    return 1;
+}
+
+static size_t trace_offset(const struct trace_reader *reader) {
+    return reader->p - reader->data;
+}
+
+/* ------------------------------------------------------------------------------------------ */
+/* record                                                                                     */
+/* ------------------------------------------------------------------------------------------ */
+
+static int cmd_record(const char *socket_path, const char *path) {
+    static struct conn conn;
+    int err = conn_open(&conn, socket_path);
+    if (err < 0) {
+        fprintf(stderr, "failed to connect to %s: %s\n", socket_path, strerror(-err));
+        return 1;
+    }
+
+    uint8_t frame[32];
+    err = conn_send(&conn, frame, subscribe_frame(frame, 1U << EVENT_KSCAN));
+    if (err < 0) {
+        fprintf(stderr, "failed to subscribe: %s\n", strerror(-err));
+        return 1;
+    }
+
+    FILE *out = strcmp(path, "-") == 0 ? stdout : fopen(path, "wb");
+    if (out == NULL) {
+        fprintf(stderr, "failed to create %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    setvbuf(out, NULL, _IOFBF, 1 << 20);
+
+    static const uint8_t header[TRACE_HEADER_SIZE] = {'Z', 'M', 'K', 'T', TRACE_VERSION};
+    fwrite(header, 1, sizeof(header), out);
+
+    uint64_t records = 0;
+    int64_t last_ts = 0;
+
+    while (!interrupted) {
+        const uint8_t *payload = NULL;
+        size_t len = 0;
+        struct key_change change;
+
+        err = conn_next_event(&conn, &payload, &len);
+        if (err < 0) {
+            break;
+        }
+        if (!kscan_event(payload, len, &change)) {
+            continue;
+        }
+
+        // Events of split peripherals may be stamped before a later local one
+        uint64_t delta = records == 0 || change.timestamp < last_ts ? 0
+                                                                    : change.timestamp - last_ts;
+        if (records == 0 || change.timestamp > last_ts) {
+            last_ts = change.timestamp;
+        }
+
+        uint8_t record[20];
+        size_t n = put_varint(record, delta);
+        n += put_varint(record + n, (uint64_t)change.position << 1 | change.pressed);
+        fwrite(record, 1, n, out);
+        records++;
+    }
+
+    close(conn.fd);
+    bool failed = ferror(out) || (out != stdout ? fclose(out) : fflush(out)) != 0;
+    if (failed) {
+        fprintf(stderr, "failed to write %s\n", path);
+        return 1;
+    }
+    if (err < 0 && err != -EINTR && err != -ECONNRESET) {
+        fprintf(stderr, "recording stopped: %s\n", strerror(-err));
+        return 1;
+    }
+
+    fprintf(stderr, "recorded %llu events\n", (unsigned long long)records);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------------------------ */
+/* play                                                                                       */
+/* ------------------------------------------------------------------------------------------ */
+
+enum play_mode {
+    PLAY_REAL_TIME,
+    PLAY_VIRTUAL_TIME,
+};
+
+struct play_options {
+    const char *socket_path;
+    enum play_mode mode;
+    /* real time is divided by this */
+    double speed;
+    /* gaps between events are cut down to this, 0 for no limit */
+    uint64_t max_gap_ms;
+};
+
+/* Frames are collected here and written out in large chunks */
+struct sender {
+    struct conn *conn;
+    size_t len;
+    uint8_t buf[SEND_BUF_SIZE + FRAME_MAX];
+};
+
+static int sender_flush(struct sender *sender) {
+    int err = conn_send(sender->conn, sender->buf, sender->len);
+    sender->len = 0;
+    return err;
+}
+
+static int sender_reserve(struct sender *sender) {
+    return sender->len >= SEND_BUF_SIZE ? sender_flush(sender) : 0;
+}
+
+/* Key events that happened in the same millisecond, sent as one KeyEventBatch */
+struct batch {
+    size_t count;
+    size_t len;
+    uint8_t body[BATCH_MAX * BATCH_EVENT_MAX];
+};
+
+static void batch_add(struct batch *batch, const struct trace_record *record) {
+    uint8_t event[BATCH_EVENT_MAX];
+    size_t n = put_uint(event, 1, record->pressed ? ACTION_PRESS : ACTION_RELEASE);
+    n += put_uint(event + n, 3, record->position);
+
+    batch->len += put_tag(batch->body + batch->len, 1, WT_LEN);
+    batch->len += put_varint(batch->body + batch->len, n);
+    memcpy(batch->body + batch->len, event, n);
+    batch->len += n;
+    batch->count++;
+}
+
+static int batch_send(struct sender *sender, struct batch *batch) {
+    if (batch->count == 0) {
+        return 0;
+    }
+
+    int err = sender_reserve(sender);
+    if (err < 0) {
+        return err;
+    }
+
+    sender->len += put_client_frame(sender->buf + sender->len, CLIENT_KEY_BATCH, batch->body,
+                                    batch->len);
+    batch->count = batch->len = 0;
+    return 0;
+}
+
+static int advance_time(struct sender *sender, uint64_t ms) {
+    while (ms > 0) {
+        uint32_t step = ms > UINT32_MAX ? UINT32_MAX : ms;
+
+        int err = sender_reserve(sender);
+        if (err < 0) {
+            return err;
+        }
+
+        sender->len += advance_time_frame(sender->buf + sender->len, step);
+        ms -= step;
+    }
+    return 0;
+}
+
+static void sleep_until_ns(uint64_t deadline_ns) {
+    struct timespec ts = {
+        .tv_sec = deadline_ns / 1000000000ULL,
+        .tv_nsec = deadline_ns % 1000000000ULL,
+    };
+
+    while (!interrupted && clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+/*
+ * Sends the key events of a batch once they're due. In real time, the batch is written out
+ * as soon as it's due, so timing only depends on the host; in virtual time, it's queued
+ * after the AdvanceTime that gets ZMK to its timestamp.
+ */
+static int play_due(struct sender *sender, struct batch *batch, const struct play_options *opts,
+                    uint64_t start_ns, uint64_t at_ms, uint64_t *clock_ms) {
+    int err;
+
+    if (opts->mode == PLAY_VIRTUAL_TIME) {
+        err = advance_time(sender, at_ms - *clock_ms);
+        *clock_ms = at_ms;
+        return err < 0 ? err : batch_send(sender, batch);
+    }
+
+    err = batch_send(sender, batch);
+    if (err < 0) {
+        return err;
+    }
+
+    sleep_until_ns(start_ns + (uint64_t)(at_ms * 1e6 / opts->speed));
+    return sender_flush(sender);
+}
+
+static int cmd_play(const struct play_options *opts, const char *path) {
+    struct trace_reader reader;
+    int err = trace_open(&reader, path);
+    if (err < 0) {
+        fprintf(stderr, "failed to open %s: %s\n", path,
+                err == -EINVAL ? "not a trace file" : strerror(-err));
+        return 1;
+    }
+
+    static struct conn conn;
+    err = conn_open(&conn, opts->socket_path);
+    if (err < 0) {
+        fprintf(stderr, "failed to connect to %s: %s\n", opts->socket_path, strerror(-err));
+        trace_close(&reader);
+        return 1;
+    }
+
+    static struct sender sender;
+    static struct batch batch;
+    sender.conn = &conn;
+
+    struct trace_record record;
+    uint64_t records = 0;
+    // Trace time of the pending batch, and with virtual time, how far ZMK was advanced
+    uint64_t at_ms = 0, clock_ms = 0;
+    uint64_t start_ns = now_ns();
+
+    while (!interrupted && (err = trace_next(&reader, &record)) > 0) {
+        uint64_t delta = record.delta_ms;
+        if (opts->max_gap_ms != 0 && delta > opts->max_gap_ms) {
+            delta = opts->max_gap_ms;
+        }
+
+        if (delta != 0 || batch.count == BATCH_MAX) {
+            err = play_due(&sender, &batch, opts, start_ns, at_ms, &clock_ms);
+            if (err < 0) {
+                break;
+            }
+            at_ms += delta;
+        }
+
+        batch_add(&batch, &record);
+        records++;
+    }
+
+    if (err == 0) {
+        err = play_due(&sender, &batch, opts, start_ns, at_ms, &clock_ms);
+    }
+    if (err == 0) {
+        err = sender_flush(&sender);
+    }
+
+    double elapsed_s = (now_ns() - start_ns) / 1e9;
+    size_t offset = trace_offset(&reader);
+    close(conn.fd);
+    trace_close(&reader);
+
+    if (err == -EILSEQ) {
+        fprintf(stderr, "%s: truncated record at offset %zu\n", path, offset);
+        return 1;
+    }
+    if (err < 0 && !interrupted) {
+        fprintf(stderr, "replay stopped: %s\n", strerror(-err));
+        return 1;
+    }
+
+    fprintf(stderr, "replayed %llu events over %llu ms of trace time in %.3f s\n",
+            (unsigned long long)records, (unsigned long long)at_ms, elapsed_s);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------------------------ */
+/* dump                                                                                       */
+/* ------------------------------------------------------------------------------------------ */
+
+static int cmd_dump(const char *path) {
+    struct trace_reader reader;
+    int err = trace_open(&reader, path);
+    if (err < 0) {
+        fprintf(stderr, "failed to open %s: %s\n", path,
+                err == -EINVAL ? "not a trace file" : strerror(-err));
+        return 1;
+    }
+
+    struct trace_record record;
+    uint64_t at_ms = 0;
+
+    while ((err = trace_next(&reader, &record)) > 0) {
+        at_ms += record.delta_ms;
+        printf("%12llu ms  %-7s  pos=%u\n", (unsigned long long)at_ms,
+               record.pressed ? "PRESS" : "RELEASE", record.position);
+    }
+
+    size_t offset = trace_offset(&reader);
+    trace_close(&reader);
+
+    if (err < 0) {
+        fprintf(stderr, "%s: truncated record at offset %zu\n", path, offset);
+        return 1;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------------------------ */
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s record [-s socket] <trace|->\n"
+            "       %s play [-s socket] [-V | -x speed] [-g max-gap-ms] <trace>\n"
+            "       %s dump <trace>\n"
+            "\n"
+            "  record -s  IPC observer socket (default " DEFAULT_OBSERVER_SOCKET ")\n"
+            "  play   -s  kscan IPC socket (default " DEFAULT_KSCAN_SOCKET ")\n"
+            "         -V  replay in virtual time, for CONFIG_ZMK_KSCAN_IPC_VIRTUAL_TIME\n"
+            "         -x  replay in real time this many times faster (default 1)\n"
+            "         -g  cut longer gaps between events down to this\n",
+            prog, prog, prog);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    const char *cmd = argv[1];
+    struct play_options opts = {
+        .mode = PLAY_REAL_TIME,
+        .speed = 1,
+    };
+    const char *socket_path = NULL;
+    int opt;
+
+    // Stop recording or playing on Ctrl-C, but let blocking calls return instead of restarting
+    struct sigaction sa = {.sa_handler = on_signal};
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    optind = 2;
+    while ((opt = getopt(argc, argv, "s:Vx:g:h")) != -1) {
+        switch (opt) {
+        case 's':
+            socket_path = optarg;
+            break;
+        case 'V':
+            opts.mode = PLAY_VIRTUAL_TIME;
+            break;
+        case 'x':
+            opts.speed = strtod(optarg, NULL);
+            break;
+        case 'g':
+            opts.max_gap_ms = strtoull(optarg, NULL, 10);
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if (optind != argc - 1 || !(opts.speed > 0)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    const char *path = argv[optind];
+    if (strcmp(cmd, "record") == 0) {
+        return cmd_record(socket_path ? socket_path : DEFAULT_OBSERVER_SOCKET, path);
+    }
+    if (strcmp(cmd, "play") == 0) {
+        opts.socket_path = socket_path ? socket_path : DEFAULT_KSCAN_SOCKET;
+        return cmd_play(&opts, path);
+    }
+    if (strcmp(cmd, "dump") == 0) {
+        return cmd_dump(path);
+    }
+
+    usage(argv[0]);
+    return 2;
+}
@@ -34,6 +34,12 @@ def format_event(ev: ZmkEvent) -> str:
             f"source={k.source}  ts={k.timestamp} ms"
         )
 
+    if which == "kscan_batch":
+        b = ev.kscan_batch
+        keys = " ".join(f"{'+' if k.pressed else '-'}{k.position}" for k in b.events)
+        dropped = f"  dropped={b.dropped}" if b.dropped else ""
+        return f"[kscan x{len(b.events)}] {keys}{dropped}"
+
     if which == "keyboard":
         kb = ev.keyboard
         transport = transport_name(kb.endpoint.transport)
@@ -63,6 +69,41 @@ def format_event(ev: ZmkEvent) -> str:
             f"scroll_x={mr.scroll_x}  scroll_y={mr.scroll_y}"
         )
 
+    if which == "layer_state":
+        ls = ev.layer_state
+        state = "active  " if ls.active else "inactive"
+        return f"[layer   ] {state}  layer={ls.layer}"
+
+    if which == "modifiers_state":
+        ms = ev.modifiers_state
+        state = "PRESS  " if ms.pressed else "RELEASE"
+        return (
+            f"[mods    ] {state}  modifiers=0x{ms.modifiers:02x}  "
+            f"held=0x{ms.explicit_modifiers:02x}"
+        )
+
+    if which == "endpoint_changed":
+        ep = ev.endpoint_changed.endpoint
+        return f"[endpoint] transport={transport_name(ep.transport)}  profile={ep.ble_profile_idx}"
+
+    if which == "state_snapshot":
+        snap = ev.state_snapshot
+        layers = [n for n in range(32) if snap.layer_state & (1 << n)]
+        battery = f"{snap.battery_level}%" if snap.battery_level >= 0 else "-"
+        return (
+            f"[snapshot] layers={layers}  default={snap.default_layer}  "
+            f"mods=0x{snap.explicit_modifiers:02x}  "
+            f"transport={transport_name(snap.endpoint.transport)}  battery={battery}"
+        )
+
+    if which == "capabilities":
+        caps = ev.capabilities
+        return (
+            f"[caps    ] version={caps.protocol_version}  "
+            f"matrix={caps.rows}x{caps.columns}  "
+            f"events=0x{caps.event_mask:x}  messages=0x{caps.message_mask:x}"
+        )
+
     return f"[unknown ] {ev}"
 
 
@@ -0,0 +1,239 @@
+"""
+ZMK IPC Client — asyncio transport for high event rates.
+
+Same wire format and sockets as :mod:`zmk_client`, but reads are done in
+large chunks with every complete frame in a chunk parsed from one buffer,
+and key input goes out as KeyEventBatch frames written back to back with a
+single drain per chunk, optionally paced to a target rate.
+
+Key batches can be traced: the last event of each chunk carries a seq and
+the send time, ZMK echoes them in the LatencyTrace of the next keyboard
+report, and :attr:`AsyncZmkIpcClient.latency` collects the round trips.
+
+Typical usage::
+
+    async def main():
+        client = AsyncZmkIpcClient()
+        await client.connect()
+        client.subscribe("keyboard")
+
+        async def consume():
+            async for ev in client.events():
+                ...
+
+        task = asyncio.create_task(consume())
+        await client.send_key_batch(events, rate=50000, trace=True)
+        print(client.latency.summary())
+        await client.close()
+
+    asyncio.run(main())
+"""
+
+import asyncio
+import socket
+import struct
+import time
+from typing import AsyncIterator, Iterable, List, Optional, Tuple
+
+from zmk_client import EVENTS_SOCK, KEY_BATCH_MAX, KSCAN_SOCK, open_socket
+from zmk_ipc_pb2 import ClientMessage, KeyEvent, KeyEventBatch, Subscribe, ZmkEvent
+
+# Bytes requested per read. Each read parses every complete frame it holds.
+READ_CHUNK = 1 << 18
+
+
+class LatencyStats:
+    """Round trips of traced key events, from send to keyboard report.
+
+    ``host_us`` is what the client sees; ``zmk_us`` is the part spent in
+    ZMK, from the kscan event to the report, taken from the LatencyTrace.
+    """
+
+    def __init__(self) -> None:
+        self.host_us: List[int] = []
+        self.zmk_us: List[int] = []
+
+    def record(self, trace, now_us: int) -> None:
+        self.host_us.append(now_us - trace.client_ts)
+        if trace.report_us and trace.kscan_us:
+            self.zmk_us.append(trace.report_us - trace.kscan_us)
+
+    def reset(self) -> None:
+        self.host_us.clear()
+        self.zmk_us.clear()
+
+    @staticmethod
+    def percentile(samples: List[int], pct: float) -> Optional[int]:
+        """Nearest-rank percentile of *samples*, or None if there are none."""
+        if not samples:
+            return None
+        ordered = sorted(samples)
+        rank = max(0, min(len(ordered) - 1, int(len(ordered) * pct / 100.0 + 0.5) - 1))
+        return ordered[rank]
+
+    def summary(self) -> str:
+        def line(name: str, samples: List[int]) -> str:
+            if not samples:
+                return f"{name}: no samples"
+            p50, p99 = self.percentile(samples, 50), self.percentile(samples, 99)
+            return f"{name}: n={len(samples)} p50={p50} us p99={p99} us max={max(samples)} us"
+
+        return line("host", self.host_us) + "\n" + line("zmk", self.zmk_us)
+
+
+class AsyncZmkIpcClient:
+    """asyncio client for the ZMK native_sim IPC interface.
+
+    By default key input and events share the observer connection (the
+    Connect RPC), which keeps a key batch and the reports it causes on one
+    ordered stream.  Pass ``single=False`` to :meth:`connect` to send input
+    to the kscan socket instead.
+    """
+
+    def __init__(self, kscan_path: str = KSCAN_SOCK, events_path: str = EVENTS_SOCK) -> None:
+        self._kscan_path = kscan_path
+        self._events_path = events_path
+        self._events_reader: Optional[asyncio.StreamReader] = None
+        self._events_writer: Optional[asyncio.StreamWriter] = None
+        self._kscan_writer: Optional[asyncio.StreamWriter] = None
+        self._next_seq = 1
+        self.latency = LatencyStats()
+
+    # ------------------------------------------------------------------
+    # Connection management
+    # ------------------------------------------------------------------
+
+    @staticmethod
+    async def _open(address: str, **kwargs):
+        # The connect itself is local and immediate; the stream runs on the loop.
+        sock = open_socket(address)
+        sock.setblocking(False)
+        if sock.family == socket.AF_UNIX:
+            return await asyncio.open_unix_connection(sock=sock, **kwargs)
+        return await asyncio.open_connection(sock=sock, **kwargs)
+
+    async def connect(self, single: bool = True) -> None:
+        self._events_reader, self._events_writer = await self._open(
+            self._events_path, limit=READ_CHUNK
+        )
+        if single:
+            self._kscan_writer = self._events_writer
+        else:
+            _, self._kscan_writer = await self._open(self._kscan_path)
+
+    async def close(self) -> None:
+        writers = {id(w): w for w in (self._kscan_writer, self._events_writer) if w}
+        for writer in writers.values():
+            writer.close()
+            try:
+                await writer.wait_closed()
+            except OSError:
+                pass
+        self._events_reader = self._events_writer = self._kscan_writer = None
+
+    async def __aenter__(self) -> "AsyncZmkIpcClient":
+        await self.connect()
+        return self
+
+    async def __aexit__(self, *_) -> None:
+        await self.close()
+
+    # ------------------------------------------------------------------
+    # Sending  (client → ZMK)
+    # ------------------------------------------------------------------
+
+    @staticmethod
+    def _frame(msg: ClientMessage) -> bytes:
+        data = msg.SerializeToString()
+        return struct.pack(">I", len(data)) + data
+
+    def _take_seq(self) -> int:
+        seq = self._next_seq
+        self._next_seq = self._next_seq % 0xFFFFFFFF + 1
+        return seq
+
+    def subscribe(self, *payloads: str) -> None:
+        """Restrict the event stream to the given ZmkEvent payload names."""
+        fields = ZmkEvent.DESCRIPTOR.fields_by_name
+        mask = 0
+        for name in payloads:
+            mask |= 1 << fields[name].number
+        self._events_writer.write(self._frame(ClientMessage(subscribe=Subscribe(event_mask=mask))))
+
+    async def send_key_batch(
+        self,
+        events: Iterable[Tuple[int, bool]],
+        *,
+        rate: Optional[float] = None,
+        chunk: int = KEY_BATCH_MAX,
+        trace: bool = False,
+    ) -> int:
+        """Inject ``(position, pressed)`` events in order; returns how many were sent.
+
+        Events go out in KeyEventBatch frames of up to *chunk* events, and
+        the writer is drained once per chunk.  With *rate* (events/s) the
+        chunks are paced so the average rate stays at or below it.  With
+        *trace* the last event of each chunk is traced.
+        """
+        writer = self._kscan_writer
+        chunk = max(1, min(chunk, KEY_BATCH_MAX))
+        sent = 0
+        start = time.monotonic()
+
+        batch = KeyEventBatch()
+        for position, pressed in events:
+            batch.events.add(action=KeyEvent.PRESS if pressed else KeyEvent.RELEASE,
+                             position=position)
+            if len(batch.events) == chunk:
+                sent += await self._send_chunk(writer, batch, trace)
+                batch = KeyEventBatch()
+                if rate:
+                    delay = start + sent / rate - time.monotonic()
+                    if delay > 0:
+                        await asyncio.sleep(delay)
+        if batch.events:
+            sent += await self._send_chunk(writer, batch, trace)
+        return sent
+
+    async def _send_chunk(self, writer: asyncio.StreamWriter, batch: KeyEventBatch,
+                          trace: bool) -> int:
+        if trace:
+            last = batch.events[-1]
+            last.seq = self._take_seq()
+            last.client_ts = time.monotonic_ns() // 1000
+        writer.write(self._frame(ClientMessage(key_batch=batch)))
+        await writer.drain()
+        return len(batch.events)
+
+    # ------------------------------------------------------------------
+    # Receiving  (ZMK → client)
+    # ------------------------------------------------------------------
+
+    async def frames(self) -> AsyncIterator[bytes]:
+        """Yield the payload of each received frame, without decoding it."""
+        reader = self._events_reader
+        buf = b""
+        while True:
+            data = await reader.read(READ_CHUNK)
+            if not data:
+                return
+            buf = buf + data if buf else data
+
+            pos = 0
+            end = len(buf)
+            while end - pos >= 4:
+                (length,) = struct.unpack_from(">I", buf, pos)
+                if end - pos - 4 < length:
+                    break
+                yield buf[pos + 4:pos + 4 + length]
+                pos += 4 + length
+            buf = buf[pos:]
+
+    async def events(self) -> AsyncIterator[ZmkEvent]:
+        """Yield each received ZmkEvent, recording latency traces on the way."""
+        async for payload in self.frames():
+            ev = ZmkEvent()
+            ev.ParseFromString(payload)
+            if ev.WhichOneof("payload") == "keyboard" and ev.keyboard.trace.seq:
+                self.latency.record(ev.keyboard.trace, time.monotonic_ns() // 1000)
+            yield ev
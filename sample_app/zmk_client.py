@@ -8,6 +8,13 @@ Two sockets:
     KSCAN_SOCK  (/tmp/zmk_kscan_ipc.sock)  client → ZMK  (ClientMessage)
     EVENTS_SOCK (/tmp/zmk_ipc.sock)        ZMK → client  (ZmkEvent)
 
+EVENTS_SOCK also accepts ClientMessage frames, so :meth:`ZmkIpcClient.connect_single`
+can inject keys and watch events over one connection (the Connect RPC).
+
+With CONFIG_ZMK_KSCAN_IPC_SHM / CONFIG_ZMK_IPC_OBSERVER_SHM the same frames
+are also carried over shared-memory rings (KSCAN_SHM / EVENTS_SHM); use
+:meth:`ZmkIpcClient.connect_input_shm` / :meth:`ZmkIpcClient.connect_output_shm`.
+
 Typical usage::
 
     client = ZmkIpcClient()
@@ -24,15 +31,76 @@ Typical usage::
     client.close()
 """
 
+import mmap
+import os
 import socket
 import struct
 import threading
-from typing import Callable, Optional
-
-from zmk_ipc_pb2 import ClientMessage, KeyEvent, ZmkEvent
+import time
+from typing import Callable, Iterable, Optional, Tuple
+
+from zmk_ipc_pb2 import (
+    AdvanceTime,
+    ClientMessage,
+    Endpoint,
+    GetClientStats,
+    GetEventStats,
+    GetKeyStats,
+    GetKeymapBindings,
+    GetStageTimings,
+    GetThreadStacks,
+    GetWorkStats,
+    Hello,
+    KeyEvent,
+    KeyEventBatch,
+    KeymapBinding,
+    PointerEvent,
+    PointerEventBatch,
+    SaveCheckpoint,
+    SensorEvent,
+    SensorEventBatch,
+    SetKeyboardReportFormat,
+    SetKeymapBindings,
+    Subscribe,
+    ZmkEvent,
+)
 
 KSCAN_SOCK = "/tmp/zmk_kscan_ipc.sock"
 EVENTS_SOCK = "/tmp/zmk_ipc.sock"
+KSCAN_SHM = "/dev/shm/zmk_kscan_ipc"
+EVENTS_SHM = "/dev/shm/zmk_ipc_events"
+
+# Must match ZMK_IPC_PROTOCOL_VERSION in app/src/ipc_pb/zmk_ipc_framing.h.
+PROTOCOL_VERSION = 1
+
+# Must match KeyEventBatch.events max_count in app/proto/zmk_ipc.options.
+KEY_BATCH_MAX = 256
+
+# Must match SensorEventBatch.events max_count in app/proto/zmk_ipc.options.
+SENSOR_BATCH_MAX = 256
+
+# Must match PointerEventBatch.events max_count in app/proto/zmk_ipc.options.
+POINTER_BATCH_MAX = 256
+
+# Must match SetKeymapBindings.bindings max_count in app/proto/zmk_ipc.options.
+KEYMAP_SET_MAX = 256
+
+# Fixed-layout event frames, see app/src/ipc_pb/zmk_ipc_packed.h.  A payload
+# starting with PACKED_MAGIC is a PACKED_HEADER followed by the struct of its
+# type; any other payload is a protobuf ZmkEvent.
+PACKED_MAGIC = 0
+PACKED_VERSION = 1
+PACKED_HEADER = struct.Struct("<BBBBIq")
+_PACKED_ENDPOINT = "BBBx"
+PACKED_LAYOUTS = {
+    "kscan_event": struct.Struct("<qII?7x"),
+    "keyboard": struct.Struct("<" + _PACKED_ENDPOINT + "BBBx32s"),
+    "consumer": struct.Struct("<" + _PACKED_ENDPOINT + "B3x16s"),
+    "mouse": struct.Struct("<" + _PACKED_ENDPOINT + "Iiiii"),
+    "layer_state": struct.Struct("<I?3x"),
+    "modifiers_state": struct.Struct("<B?Bx"),
+    "endpoint_changed": struct.Struct("<" + _PACKED_ENDPOINT),
+}
 
 
 # ---------------------------------------------------------------------------
@@ -50,6 +118,27 @@ def _recv_exact(sock: socket.socket, n: int) -> bytes:
     return bytes(buf)
 
 
+def open_socket(address: str) -> socket.socket:
+    """Connect to a ZMK IPC server address and return the blocking socket.
+
+    *address* takes the same forms as the server's listen address: a
+    filesystem path, ``@name`` for an abstract Unix socket, or
+    ``tcp:HOST:PORT`` (IPv6 hosts in brackets).
+    """
+    if address.startswith("tcp:"):
+        host, _, port = address[4:].rpartition(":")
+        s = socket.create_connection((host.strip("[]"), int(port)))
+        s.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        return s
+    s = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    try:
+        s.connect("\0" + address[1:] if address.startswith("@") else address)
+    except OSError:
+        s.close()
+        raise
+    return s
+
+
 def _send_frame(sock: socket.socket, data: bytes) -> None:
     """Send *data* with a 4-byte big-endian length prefix."""
     sock.sendall(struct.pack(">I", len(data)) + data)
@@ -62,6 +151,142 @@ def _recv_frame(sock: socket.socket) -> bytes:
     return _recv_exact(sock, length)
 
 
+def _unpack_endpoint(msg, valid: int, transport: int, ble_profile_idx: int) -> None:
+    if valid:
+        msg.endpoint.transport = transport
+        msg.endpoint.ble_profile_idx = ble_profile_idx
+
+
+def unpack_event(data: bytes) -> ZmkEvent:
+    """Build a ZmkEvent from the payload of a packed frame.
+
+    Tools that need the speed read :data:`PACKED_LAYOUTS` themselves; this
+    keeps :meth:`ZmkIpcClient.recv_event` returning the same type either way.
+    """
+    _magic, version, tag, context, _size, timestamp = PACKED_HEADER.unpack_from(data)
+    if version != PACKED_VERSION:
+        raise ValueError(f"unsupported packed frame version {version}")
+    name = ZmkEvent.DESCRIPTOR.fields_by_number[tag].name
+    fields = PACKED_LAYOUTS[name].unpack_from(data, PACKED_HEADER.size)
+    ev = ZmkEvent(timestamp=timestamp, context=context)
+    msg = getattr(ev, name)
+    msg.SetInParent()
+    if name == "kscan_event":
+        msg.timestamp, msg.source, msg.position, msg.pressed = fields
+        msg.context = context
+    elif name == "keyboard":
+        _unpack_endpoint(msg, *fields[:3])
+        msg.modifiers, msg.format = fields[3], fields[4]
+        msg.keys = fields[6][: fields[5]]
+    elif name == "consumer":
+        _unpack_endpoint(msg, *fields[:3])
+        msg.keys = fields[4][: fields[3]]
+    elif name == "mouse":
+        _unpack_endpoint(msg, *fields[:3])
+        msg.buttons, msg.dx, msg.dy, msg.scroll_x, msg.scroll_y = fields[3:]
+    elif name == "layer_state":
+        msg.layer, msg.active = fields
+    elif name == "modifiers_state":
+        msg.modifiers, msg.pressed, msg.explicit_modifiers = fields
+    else:
+        _unpack_endpoint(msg, *fields)
+    return ev
+
+
+# ---------------------------------------------------------------------------
+# Shared-memory ring transport
+# ---------------------------------------------------------------------------
+
+class ShmRing:
+    """Socket-like view of a ZMK shared-memory ring.
+
+    Implements just ``sendall``/``recv``/``close`` so the framing helpers
+    above work unchanged.  The layout is documented in
+    ``app/src/ipc_pb/zmk_ipc_shm.h``; this side polls instead of using
+    futex waits.
+    """
+
+    MAGIC = 0x4350495A
+    _DATA = 256
+    _HEAD = 64
+    _TAIL = 128
+
+    def __init__(self, path: str, poll_interval: float = 0.0005) -> None:
+        fd = os.open(path, os.O_RDWR)
+        try:
+            self._map = mmap.mmap(fd, os.fstat(fd).st_size)
+        finally:
+            os.close(fd)
+        magic, _version, size = struct.unpack_from("=III", self._map, 0)
+        if magic != self.MAGIC:
+            self._map.close()
+            raise ConnectionError(f"{path} is not a ZMK IPC ring")
+        self._size = size
+        self._poll = poll_interval
+
+    def _load(self, off: int) -> int:
+        return struct.unpack_from("=I", self._map, off)[0]
+
+    def _store(self, off: int, value: int) -> None:
+        struct.pack_into("=I", self._map, off, value & 0xFFFFFFFF)
+
+    def sendall(self, data: bytes) -> None:
+        if len(data) > self._size:
+            raise ValueError("frame larger than ring")
+        head = self._load(self._HEAD)
+        while self._size - ((head - self._load(self._TAIL)) & 0xFFFFFFFF) < len(data):
+            time.sleep(self._poll)
+        off = head % self._size
+        first = min(len(data), self._size - off)
+        self._map[self._DATA + off:self._DATA + off + first] = data[:first]
+        self._map[self._DATA:self._DATA + len(data) - first] = data[first:]
+        self._store(self._HEAD, head + len(data))
+
+    def recv(self, n: int) -> bytes:
+        tail = self._load(self._TAIL)
+        while (pending := (self._load(self._HEAD) - tail) & 0xFFFFFFFF) == 0:
+            time.sleep(self._poll)
+        n = min(n, pending)
+        off = tail % self._size
+        first = min(n, self._size - off)
+        out = self._map[self._DATA + off:self._DATA + off + first]
+        out += self._map[self._DATA:self._DATA + n - first]
+        self._store(self._TAIL, tail + n)
+        return out
+
+    def close(self) -> None:
+        self._map.close()
+
+
+class KeyboardDeltaState:
+    """Rebuilds the keyboard state from ``HidKeyboardDelta`` events.
+
+    Subscribe to ``keyboard_delta`` and pass each delta to :meth:`apply`.
+    ``keys`` holds the pressed usage IDs and ``modifiers`` the modifier byte;
+    both are only trustworthy while ``synced`` is true, i.e. from the first
+    keyframe until a gap in the delta sequence.
+    """
+
+    def __init__(self) -> None:
+        self.keys = set()
+        self.modifiers = 0
+        self.synced = False
+        self._seq = None
+
+    def apply(self, delta) -> bool:
+        if delta.keyframe:
+            self.keys = set(delta.pressed)
+            self.synced = True
+        else:
+            if self._seq is not None and delta.seq != self._seq + 1:
+                self.synced = False
+            self.keys |= set(delta.pressed)
+            self.keys -= set(delta.released)
+        self._seq = delta.seq
+        self.modifiers = delta.modifiers
+        return self.synced
+
+
 # ---------------------------------------------------------------------------
 # High-level client
 # ---------------------------------------------------------------------------
@@ -72,9 +297,10 @@ class ZmkIpcClient:
     Parameters
     ----------
     kscan_path:
-        Unix socket path for the kscan IPC driver (input to ZMK).
+        Address of the kscan IPC driver (input to ZMK).
     events_path:
-        Unix socket path for the IPC observer (output from ZMK).
+        Address of the IPC observer (output from ZMK): a socket path,
+        ``@name`` or ``tcp:HOST:PORT``, as for :func:`open_socket`.
     """
 
     def __init__(
@@ -93,24 +319,37 @@ class ZmkIpcClient:
 
     def connect_input(self) -> None:
         """Connect to the kscan IPC socket (client → ZMK key events)."""
-        s = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
-        s.connect(self._kscan_path)
-        self._kscan_sock = s
+        self._kscan_sock = open_socket(self._kscan_path)
 
     def connect_output(self) -> None:
         """Connect to the IPC observer socket (ZMK → client events)."""
-        s = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
-        s.connect(self._events_path)
-        self._events_sock = s
+        self._events_sock = open_socket(self._events_path)
+
+    def connect_input_shm(self, path: str = KSCAN_SHM) -> None:
+        """Send key input over the kscan shared-memory ring instead."""
+        self._kscan_sock = ShmRing(path)  # type: ignore[assignment]
+
+    def connect_output_shm(self, path: str = EVENTS_SHM) -> None:
+        """Receive events from the observer shared-memory ring instead.
+
+        The ring is one-way and unfiltered; :meth:`subscribe` is not available.
+        """
+        self._events_sock = ShmRing(path)  # type: ignore[assignment]
 
     def connect(self) -> None:
         """Connect to both sockets."""
         self.connect_input()
         self.connect_output()
 
+    def connect_single(self) -> None:
+        """Use one observer connection for both key input and events."""
+        self.connect_output()
+        self._kscan_sock = self._events_sock
+
     def close(self) -> None:
         """Close all open sockets."""
-        for sock in (self._kscan_sock, self._events_sock):
+        socks = {id(s): s for s in (self._kscan_sock, self._events_sock) if s}
+        for sock in socks.values():
             if sock:
                 try:
                     sock.close()
@@ -130,13 +369,18 @@ class ZmkIpcClient:
     # Sending key events  (client → ZMK)
     # ------------------------------------------------------------------
 
-    def send_key_press(self, position: int) -> None:
-        """Inject a key-press event at the given linear matrix position."""
-        self._send_key_event(position, KeyEvent.PRESS)
+    def send_key_press(self, position: int, seq: int = 0) -> None:
+        """Inject a key-press event at the given linear matrix position.
+
+        A non-zero *seq* traces the event: the next HidKeyboardReport carries
+        a LatencyTrace with this seq, the client send time (``client_ts``,
+        ``time.monotonic_ns() // 1000``) and ZMK's kernel timestamps.
+        """
+        self._send_key_event(position, KeyEvent.PRESS, seq)
 
-    def send_key_release(self, position: int) -> None:
+    def send_key_release(self, position: int, seq: int = 0) -> None:
         """Inject a key-release event at the given linear matrix position."""
-        self._send_key_event(position, KeyEvent.RELEASE)
+        self._send_key_event(position, KeyEvent.RELEASE, seq)
 
     def send_key_press_rc(self, row: int, col: int) -> None:
         """Inject a key-press event using explicit row/col addressing."""
@@ -146,10 +390,149 @@ class ZmkIpcClient:
         """Inject a key-release event using explicit row/col addressing."""
         self._send_key_event_rc(row, col, KeyEvent.RELEASE)
 
-    def _send_key_event(self, position: int, action: int) -> None:
+    def send_key_batch(self, events: Iterable[Tuple[int, bool]]) -> None:
+        """Inject a sequence of ``(position, pressed)`` events in order.
+
+        Events are packed into KeyEventBatch frames of at most
+        :data:`KEY_BATCH_MAX` entries, so one frame (and one decode on the
+        ZMK side) carries many events.
+        """
+        if self._kscan_sock is None:
+            raise RuntimeError("input socket not connected; call connect_input() first")
+        batch = KeyEventBatch()
+        for position, pressed in events:
+            action = KeyEvent.PRESS if pressed else KeyEvent.RELEASE
+            batch.events.add(action=action, position=position)
+            if len(batch.events) == KEY_BATCH_MAX:
+                _send_frame(self._kscan_sock, ClientMessage(key_batch=batch).SerializeToString())
+                batch = KeyEventBatch()
+        if batch.events:
+            _send_frame(self._kscan_sock, ClientMessage(key_batch=batch).SerializeToString())
+
+    def send_key_batch_paced(
+        self,
+        events: Iterable[Tuple[int, bool]],
+        on_event: Optional[Callable[[ZmkEvent], None]] = None,
+    ) -> None:
+        """Inject ``(position, pressed)`` events as fast as ZMK's kscan event queue takes them.
+
+        Events are only sent while the latest ``InputCredits`` leave room for
+        them in the queue, so the firmware never stops reading the IPC
+        sockets to wait for it.  Requires
+        ``CONFIG_ZMK_IPC_OBSERVER_INPUT_CREDITS``, an output connection
+        subscribed to ``input_credits`` and no other source of key events.
+        Other events that arrive while waiting for credits are passed to
+        *on_event*, or discarded.
+        """
+        if self._kscan_sock is None:
+            raise RuntimeError("input socket not connected; call connect_input() first")
+        pending = list(events)
+        first = None
+        capacity = consumed = sent = 0
+        while pending:
+            room = capacity - (sent - consumed) if first is not None else 0
+            if room <= 0:
+                ev = self.recv_event()
+                if ev.WhichOneof("payload") != "input_credits":
+                    if on_event:
+                        on_event(ev)
+                    continue
+                if first is None:
+                    first = ev.input_credits.consumed
+                capacity = ev.input_credits.capacity
+                consumed = (ev.input_credits.consumed - first) & 0xFFFFFFFF
+                continue
+            self.send_key_batch(pending[:room])
+            sent += len(pending[:room])
+            pending = pending[room:]
+
+    def send_sensor_event(self, sensor_index: int, val1: int, val2: int = 0) -> None:
+        """Raise a reading for keymap sensor *sensor_index*, as its device would.
+
+        *val1* and *val2* follow Zephyr's ``struct sensor_value``: an encoder
+        reports degrees turned, with *val2* in millionths of a degree.
+        """
+        if self._kscan_sock is None:
+            raise RuntimeError("input socket not connected; call connect_input() first")
+        ev = SensorEvent(sensor_index=sensor_index, val1=val1, val2=val2)
+        _send_frame(self._kscan_sock, ClientMessage(sensor_event=ev).SerializeToString())
+
+    def send_sensor_batch(self, events: Iterable[Tuple[int, int, int]]) -> None:
+        """Raise a sequence of ``(sensor_index, val1, val2)`` readings in order.
+
+        Readings are packed into SensorEventBatch frames of at most
+        :data:`SENSOR_BATCH_MAX` entries.
+        """
+        if self._kscan_sock is None:
+            raise RuntimeError("input socket not connected; call connect_input() first")
+        batch = SensorEventBatch()
+        for sensor_index, val1, val2 in events:
+            batch.events.add(sensor_index=sensor_index, val1=val1, val2=val2)
+            if len(batch.events) == SENSOR_BATCH_MAX:
+                msg = ClientMessage(sensor_batch=batch)
+                _send_frame(self._kscan_sock, msg.SerializeToString())
+                batch = SensorEventBatch()
+        if batch.events:
+            msg = ClientMessage(sensor_batch=batch)
+            _send_frame(self._kscan_sock, msg.SerializeToString())
+
+    def send_pointer_event(
+        self,
+        dx: int = 0,
+        dy: int = 0,
+        wheel: int = 0,
+        hwheel: int = 0,
+        buttons: int = 0,
+        sync: bool = True,
+    ) -> None:
+        """Raise relative pointer input from the kscan IPC input device.
+
+        *buttons* is the set of buttons held (bit N is ``INPUT_BTN_N``). With
+        *sync* unset the input is only reported along with a later event.
+        """
+        if self._kscan_sock is None:
+            raise RuntimeError("input socket not connected; call connect_input() first")
+        ev = PointerEvent(dx=dx, dy=dy, wheel=wheel, hwheel=hwheel, buttons=buttons, sync=sync)
+        _send_frame(self._kscan_sock, ClientMessage(pointer_event=ev).SerializeToString())
+
+    def send_pointer_batch(self, motions: Iterable[Tuple[int, int]], buttons: int = 0) -> None:
+        """Raise a sequence of ``(dx, dy)`` motions, each synced on its own.
+
+        Motions are packed into PointerEventBatch frames of at most
+        :data:`POINTER_BATCH_MAX` entries, with *buttons* held throughout.
+        """
         if self._kscan_sock is None:
             raise RuntimeError("input socket not connected; call connect_input() first")
-        msg = ClientMessage(key_event=KeyEvent(action=action, position=position))
+        batch = PointerEventBatch()
+        for dx, dy in motions:
+            batch.events.add(dx=dx, dy=dy, buttons=buttons, sync=True)
+            if len(batch.events) == POINTER_BATCH_MAX:
+                msg = ClientMessage(pointer_batch=batch)
+                _send_frame(self._kscan_sock, msg.SerializeToString())
+                batch = PointerEventBatch()
+        if batch.events:
+            msg = ClientMessage(pointer_batch=batch)
+            _send_frame(self._kscan_sock, msg.SerializeToString())
+
+    def advance_time(self, ms: int) -> None:
+        """Let *ms* milliseconds of ZMK kernel time pass before later input.
+
+        With ``CONFIG_ZMK_KSCAN_IPC_VIRTUAL_TIME`` this is the only way time
+        moves forward, so hold-tap and combo timeouts fire deterministically.
+        """
+        if self._kscan_sock is None:
+            raise RuntimeError("input socket not connected; call connect_input() first")
+        msg = ClientMessage(advance_time=AdvanceTime(ms=ms))
+        _send_frame(self._kscan_sock, msg.SerializeToString())
+
+    def _send_key_event(self, position: int, action: int, seq: int = 0) -> None:
+        if self._kscan_sock is None:
+            raise RuntimeError("input socket not connected; call connect_input() first")
+        ev = KeyEvent(action=action, position=position)
+        if seq:
+            ev.seq = seq
+            ev.client_ts = time.monotonic_ns() // 1000
+        msg = ClientMessage(key_event=ev)
         _send_frame(self._kscan_sock, msg.SerializeToString())
 
     def _send_key_event_rc(self, row: int, col: int, action: int) -> None:
@@ -165,11 +548,329 @@ class ZmkIpcClient:
     # Receiving ZMK events  (ZMK → client)
     # ------------------------------------------------------------------
 
+    def subscribe(self, *payloads: str) -> None:
+        """Restrict the output stream to the given ZmkEvent payload names.
+
+        Example: ``client.subscribe("keyboard", "consumer")``.  Calling it
+        with no arguments unsubscribes from everything.
+        """
+        if self._events_sock is None:
+            raise RuntimeError("output socket not connected; call connect_output() first")
+        fields = ZmkEvent.DESCRIPTOR.fields_by_name
+        mask = 0
+        for name in payloads:
+            mask |= 1 << fields[name].number
+        msg = ClientMessage(subscribe=Subscribe(event_mask=mask))
+        _send_frame(self._events_sock, msg.SerializeToString())
+
+    def hello(self, *payloads: str, timeout: Optional[float] = 1.0, packed: bool = False):
+        """Announce the protocol version and return the firmware's ``Capabilities``.
+
+        *payloads* names the ZmkEvent payloads this client understands; if
+        given, the connection is also subscribed to those the firmware can
+        send, as with :meth:`subscribe`.  ``capabilities.columns`` replaces a
+        hard-coded matrix width for linear positions.  With *packed*, the
+        firmware sends fixed-layout frames where it can
+        (``capabilities.packed_version`` is non-zero); :meth:`recv_event`
+        reads both kinds.  Firmware that predates the handshake does not
+        answer; ``None`` is returned after *timeout* seconds.  Other events that arrive while waiting are discarded.
+        """
+        if self._events_sock is None:
+            raise RuntimeError("output socket not connected; call connect_output() first")
+        fields = ZmkEvent.DESCRIPTOR.fields_by_name
+        mask = 0
+        for name in payloads:
+            mask |= 1 << fields[name].number
+        msg = ClientMessage(
+            hello=Hello(protocol_version=PROTOCOL_VERSION, event_mask=mask, packed_events=packed)
+        )
+        _send_frame(self._events_sock, msg.SerializeToString())
+        deadline = None if timeout is None else time.monotonic() + timeout
+        try:
+            while True:
+                if deadline is not None:
+                    self._events_sock.settimeout(max(deadline - time.monotonic(), 0.001))
+                ev = self.recv_event()
+                if ev.WhichOneof("payload") == "capabilities":
+                    return ev.capabilities
+        except socket.timeout:
+            return None
+        finally:
+            self._events_sock.settimeout(None)
+
+    def get_event_stats(self) -> list:
+        """Fetch the firmware's per-event-type dispatch counters.
+
+        Requires ``CONFIG_ZMK_EVENT_MANAGER_STATS``.  Returns the
+        ``EventTypeStats`` messages in event-type order; other events that
+        arrive while waiting for the reply are discarded.
+        """
+        if self._events_sock is None:
+            raise RuntimeError("output socket not connected; call connect_output() first")
+        msg = ClientMessage(get_event_stats=GetEventStats())
+        _send_frame(self._events_sock, msg.SerializeToString())
+        stats = []
+        while True:
+            ev = self.recv_event()
+            if ev.WhichOneof("payload") != "event_stats":
+                continue
+            stats.append(ev.event_stats)
+            if len(stats) == ev.event_stats.count:
+                return stats
+
+    def get_stage_timings(self) -> list:
+        """Fetch the firmware's per-stage cycle histograms of the key press path.
+
+        Requires ``CONFIG_ZMK_STAGE_TIMING``.  Returns the ``StageTiming``
+        messages in stage order; other events that arrive while waiting for
+        the reply are discarded.
+        """
+        if self._events_sock is None:
+            raise RuntimeError("output socket not connected; call connect_output() first")
+        msg = ClientMessage(get_stage_timings=GetStageTimings())
+        _send_frame(self._events_sock, msg.SerializeToString())
+        timings = []
+        while True:
+            ev = self.recv_event()
+            if ev.WhichOneof("payload") != "stage_timing":
+                continue
+            timings.append(ev.stage_timing)
+            if len(timings) == ev.stage_timing.count:
+                return timings
+
+    def get_work_stats(self) -> list:
+        """Fetch the firmware's latency counters of the work items on the key path.
+
+        Requires ``CONFIG_ZMK_WORK_STATS``.  Returns one ``WorkStats`` message
+        per instrumented work item; other events that arrive while waiting for
+        the reply are discarded.
+        """
+        if self._events_sock is None:
+            raise RuntimeError("output socket not connected; call connect_output() first")
+        msg = ClientMessage(get_work_stats=GetWorkStats())
+        _send_frame(self._events_sock, msg.SerializeToString())
+        stats = []
+        while True:
+            ev = self.recv_event()
+            if ev.WhichOneof("payload") != "work_stats":
+                continue
+            stats.append(ev.work_stats)
+            if len(stats) == ev.work_stats.count:
+                return stats
+
+    def get_key_stats(self) -> list:
+        """Fetch the firmware's key press timing histograms.
+
+        Requires ``CONFIG_ZMK_KEY_STATS``.  Returns the ``KeyStats`` messages,
+        the intervals between key presses (``position`` -1) first, then one
+        per key position with press durations or hold-tap decisions; other
+        events that arrive while waiting for the reply are discarded.
+        """
+        if self._events_sock is None:
+            raise RuntimeError("output socket not connected; call connect_output() first")
+        msg = ClientMessage(get_key_stats=GetKeyStats())
+        _send_frame(self._events_sock, msg.SerializeToString())
+        stats = []
+        while True:
+            ev = self.recv_event()
+            if ev.WhichOneof("payload") != "key_stats":
+                continue
+            stats.append(ev.key_stats)
+            if len(stats) == ev.key_stats.count:
+                return stats
+
+    def get_thread_stacks(self) -> list:
+        """Fetch the stack size and peak stack use of every firmware thread.
+
+        Requires ``CONFIG_ZMK_THREAD_STACK_STATS``.  Returns one ``ThreadStack``
+        message per thread; other events that arrive while waiting for the
+        reply are discarded.
+        """
+        if self._events_sock is None:
+            raise RuntimeError("output socket not connected; call connect_output() first")
+        msg = ClientMessage(get_thread_stacks=GetThreadStacks())
+        _send_frame(self._events_sock, msg.SerializeToString())
+        stacks = []
+        while True:
+            ev = self.recv_event()
+            if ev.WhichOneof("payload") != "thread_stack":
+                continue
+            stacks.append(ev.thread_stack)
+            if len(stacks) == ev.thread_stack.count:
+                return stacks
+
+    def get_client_stats(self) -> list:
+        """Fetch the send counters of every observer connection.
+
+        Returns one ``ClientStats`` message per connected client, the one of
+        this connection with ``requester`` set; other events that arrive
+        while waiting for the reply are discarded.
+        """
+        if self._events_sock is None:
+            raise RuntimeError("output socket not connected; call connect_output() first")
+        msg = ClientMessage(get_client_stats=GetClientStats())
+        _send_frame(self._events_sock, msg.SerializeToString())
+        stats = []
+        while True:
+            ev = self.recv_event()
+            if ev.WhichOneof("payload") != "client_stats":
+                continue
+            stats.append(ev.client_stats)
+            if len(stats) == ev.client_stats.count:
+                return stats
+
+    def get_keymap_bindings(
+        self,
+        first_layer: int = 0,
+        layer_count: int = 0,
+        first_position: int = 0,
+        position_count: int = 0,
+    ) -> dict:
+        """Read a block of keymap bindings; the defaults dump the whole keymap.
+
+        Requires ``CONFIG_ZMK_IPC_OBSERVER_KEYMAP``.  Returns a dict mapping
+        ``(layer_id, position)`` to ``KeymapBinding``; other events that
+        arrive while waiting for the reply are discarded.
+        """
+        if self._events_sock is None:
+            raise RuntimeError("output socket not connected; call connect_output() first")
+        msg = ClientMessage(
+            get_keymap_bindings=GetKeymapBindings(
+                first_layer=first_layer,
+                layer_count=layer_count,
+                first_position=first_position,
+                position_count=position_count,
+            )
+        )
+        _send_frame(self._events_sock, msg.SerializeToString())
+        bindings = {}
+        received = 0
+        while True:
+            ev = self.recv_event()
+            if ev.WhichOneof("payload") != "keymap_bindings":
+                continue
+            run = ev.keymap_bindings
+            for i, binding in enumerate(run.bindings):
+                bindings[(run.layer_id, run.first_position + i)] = binding
+            received += 1
+            if received == run.count:
+                return bindings
+
+    def set_keymap_bindings(
+        self,
+        first_layer: int,
+        first_position: int,
+        layers: Iterable[Iterable[Tuple[int, int, int]]],
+        save: bool = False,
+        reset: bool = False,
+    ) -> int:
+        """Write consecutive layers of bindings starting at ``first_layer``.
+
+        Each entry of ``layers`` is one layer's ``(behavior_id, param1,
+        param2)`` tuples for positions ``first_position`` onwards; all layers
+        must be the same length.  Layers are packed into as few
+        SetKeymapBindings frames as KEYMAP_SET_MAX allows.  With ``save``
+        the keymap is persisted after the last frame.  With ``reset`` the
+        layers and HID reports are reset before the first frame.  Requires
+        ``CONFIG_ZMK_IPC_OBSERVER_KEYMAP``.  Returns the number of bindings
+        applied and raises ``OSError`` if the firmware rejects one.
+        """
+        if self._events_sock is None:
+            raise RuntimeError("output socket not connected; call connect_output() first")
+        rows = [[KeymapBinding(behavior_id=b, param1=p1, param2=p2) for b, p1, p2 in layer]
+                for layer in layers]
+        if not rows:
+            return 0
+        width = len(rows[0])
+        if width == 0 or width > KEYMAP_SET_MAX or any(len(r) != width for r in rows):
+            raise ValueError("layers must be equally long, with 1..%d bindings" % KEYMAP_SET_MAX)
+        per_frame = KEYMAP_SET_MAX // width
+        applied = 0
+        for start in range(0, len(rows), per_frame):
+            chunk = rows[start:start + per_frame]
+            req = SetKeymapBindings(
+                first_layer=first_layer + start,
+                first_position=first_position,
+                position_count=width,
+                bindings=[b for row in chunk for b in row],
+                save=save and start + per_frame >= len(rows),
+                reset=reset and start == 0,
+            )
+            _send_frame(self._events_sock,
+                        ClientMessage(set_keymap_bindings=req).SerializeToString())
+            while True:
+                ev = self.recv_event()
+                if ev.WhichOneof("payload") == "keymap_set_result":
+                    break
+            applied += ev.keymap_set_result.applied
+            if ev.keymap_set_result.error != 0:
+                err = -ev.keymap_set_result.error
+                raise OSError(err, "SetKeymapBindings failed after %d bindings: %s"
+                              % (applied, os.strerror(err)))
+        return applied
+
+    def load_keymap(
+        self,
+        layers: Iterable[Iterable[Tuple[int, int, int]]],
+        save: bool = False,
+    ) -> int:
+        """Replace the whole keymap without restarting the firmware.
+
+        ``layers`` holds every position of layer IDs 0 onwards, as for
+        set_keymap_bindings().  The keymap state is reset first, so the new
+        keymap starts on its default layer with no keys reported.  Release
+        all keys before loading, since behaviors still holding one aren't
+        reset.
+        """
+        return self.set_keymap_bindings(0, 0, layers, save=save, reset=True)
+
+    def save_checkpoint(self, path: str) -> None:
+        """Write a checkpoint of the keyboard's state to ``path``.
+
+        The checkpoint holds the saved settings and the active and locked
+        layers; start another instance with ``ZMK_SETTINGS_TEMPLATE`` set to
+        ``path`` to boot in that state.  Requires
+        ``CONFIG_ZMK_IPC_OBSERVER_CHECKPOINT``.  Raises ``OSError`` if the
+        firmware can't take it, e.g. ``EBUSY`` while a key is held.
+        """
+        if self._events_sock is None:
+            raise RuntimeError("output socket not connected; call connect_output() first")
+        msg = ClientMessage(save_checkpoint=SaveCheckpoint(path=os.path.abspath(path)))
+        _send_frame(self._events_sock, msg.SerializeToString())
+        while True:
+            ev = self.recv_event()
+            if ev.WhichOneof("payload") == "checkpoint_result":
+                break
+        if ev.checkpoint_result.error != 0:
+            err = -ev.checkpoint_result.error
+            raise OSError(err, "SaveCheckpoint failed: %s" % os.strerror(err))
+
+    def set_keyboard_report_format(
+        self, transport: int, fmt: int, ble_profile_idx: int = 0
+    ) -> None:
+        """Select the keyboard report layout ZMK sends to an endpoint.
+
+        ``transport`` is a TransportType and ``fmt`` a KeyboardReportFormat
+        value, e.g. ``KEYBOARD_REPORT_FORMAT_BOOT`` to see the 6-key report a
+        boot protocol host would get.  Layouts the firmware isn't built for
+        are ignored.
+        """
+        if self._events_sock is None:
+            raise RuntimeError("output socket not connected; call connect_output() first")
+        req = SetKeyboardReportFormat(
+            endpoint=Endpoint(transport=transport, ble_profile_idx=ble_profile_idx),
+            format=fmt,
+        )
+        msg = ClientMessage(set_keyboard_report_format=req)
+        _send_frame(self._events_sock, msg.SerializeToString())
+
     def recv_event(self) -> ZmkEvent:
         """Block until one ZmkEvent is received and return it."""
         if self._events_sock is None:
             raise RuntimeError("output socket not connected; call connect_output() first")
         data = _recv_frame(self._events_sock)
+        if data[:1] == bytes([PACKED_MAGIC]):
+            return unpack_event(data)
         ev = ZmkEvent()
         ev.ParseFromString(data)
         return ev
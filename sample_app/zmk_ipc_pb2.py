@@ -13,7 +13,7 @@ _sym_db = _symbol_database.Default()
 
 
 
-DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\rzmk_ipc.proto\x12\x07zmk.ipc\"N\n\x08\x45ndpoint\x12)\n\ttransport\x18\x01 \x01(\x0e\x32\x16.zmk.ipc.TransportType\x12\x17\n\x0f\x62le_profile_idx\x18\x02 \x01(\r\"\'\n\x0bKeyPosition\x12\x0b\n\x03row\x18\x01 \x01(\r\x12\x0b\n\x03\x63ol\x18\x02 \x01(\r\"\xb6\x01\n\x08KeyEvent\x12(\n\x06\x61\x63tion\x18\x01 \x01(\x0e\x32\x18.zmk.ipc.KeyEvent.Action\x12\'\n\x07key_pos\x18\x02 \x01(\x0b\x32\x14.zmk.ipc.KeyPositionH\x00\x12\x12\n\x08position\x18\x03 \x01(\rH\x00\"8\n\x06\x41\x63tion\x12\x16\n\x12\x41\x43TION_UNSPECIFIED\x10\x00\x12\t\n\x05PRESS\x10\x01\x12\x0b\n\x07RELEASE\x10\x02\x42\t\n\x07\x61\x64\x64ress\"B\n\rClientMessage\x12&\n\tkey_event\x18\x01 \x01(\x0b\x32\x11.zmk.ipc.KeyEventH\x00\x42\t\n\x07payload\"R\n\nKscanEvent\x12\x0e\n\x06source\x18\x01 \x01(\r\x12\x10\n\x08position\x18\x02 \x01(\r\x12\x0f\n\x07pressed\x18\x03 \x01(\x08\x12\x11\n\ttimestamp\x18\x04 \x01(\x03\"Y\n\x11HidKeyboardReport\x12#\n\x08\x65ndpoint\x18\x01 \x01(\x0b\x32\x11.zmk.ipc.Endpoint\x12\x11\n\tmodifiers\x18\x02 \x01(\r\x12\x0c\n\x04keys\x18\x03 \x01(\x0c\"F\n\x11HidConsumerReport\x12#\n\x08\x65ndpoint\x18\x01 \x01(\x0b\x32\x11.zmk.ipc.Endpoint\x12\x0c\n\x04keys\x18\x02 \x01(\x0c\"\x82\x01\n\x0eHidMouseReport\x12#\n\x08\x65ndpoint\x18\x01 \x01(\x0b\x32\x11.zmk.ipc.Endpoint\x12\x0f\n\x07\x62uttons\x18\x02 \x01(\r\x12\n\n\x02\x64x\x18\x03 \x01(\x11\x12\n\n\x02\x64y\x18\x04 \x01(\x11\x12\x10\n\x08scroll_x\x18\x05 \x01(\x11\x12\x10\n\x08scroll_y\x18\x06 \x01(\x11\"\xcb\x01\n\x08ZmkEvent\x12*\n\x0bkscan_event\x18\x01 \x01(\x0b\x32\x13.zmk.ipc.KscanEventH\x00\x12.\n\x08keyboard\x18\x02 \x01(\x0b\x32\x1a.zmk.ipc.HidKeyboardReportH\x00\x12.\n\x08\x63onsumer\x18\x03 \x01(\x0b\x32\x1a.zmk.ipc.HidConsumerReportH\x00\x12(\n\x05mouse\x18\x04 \x01(\x0b\x32\x17.zmk.ipc.HidMouseReportH\x00\x42\t\n\x07payload\"\x07\n\x05\x45mpty*d\n\rTransportType\x12\x19\n\x15TRANSPORT_UNSPECIFIED\x10\x00\x12\x12\n\x0eTRANSPORT_NONE\x10\x01\x12\x11\n\rTRANSPORT_USB\x10\x02\x12\x11\n\rTRANSPORT_BLE\x10\x03\x32\xac\x01\n\x06ZmkIpc\x12\x34\n\x08SendKeys\x12\x16.zmk.ipc.ClientMessage\x1a\x0e.zmk.ipc.Empty(\x01\x12\x32\n\x0bWatchEvents\x12\x0e.zmk.ipc.Empty\x1a\x11.zmk.ipc.ZmkEvent0\x01\x12\x38\n\x07\x43onnect\x12\x16.zmk.ipc.ClientMessage\x1a\x11.zmk.ipc.ZmkEvent(\x01\x30\x01\x42:\n\x0b\x64\x65v.zmk.ipcB\x0bZmkIpcProtoZ\x1egithub.com/zmkfirmware/zmk/ipcb\x06proto3')
+DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\rzmk_ipc.proto\x12\x07zmk.ipc\"N\n\x08\x45ndpoint\x12)\n\ttransport\x18\x01 \x01(\x0e\x32\x16.zmk.ipc.TransportType\x12\x17\n\x0f\x62le_profile_idx\x18\x02 \x01(\r\"\'\n\x0bKeyPosition\x12\x0b\n\x03row\x18\x01 \x01(\r\x12\x0b\n\x03\x63ol\x18\x02 \x01(\r\"\xd6\x01\n\x08KeyEvent\x12(\n\x06\x61\x63tion\x18\x01 \x01(\x0e\x32\x18.zmk.ipc.KeyEvent.Action\x12\'\n\x07key_pos\x18\x02 \x01(\x0b\x32\x14.zmk.ipc.KeyPositionH\x00\x12\x12\n\x08position\x18\x03 \x01(\rH\x00\x12\x0b\n\x03seq\x18\x04 \x01(\r\x12\x11\n\tclient_ts\x18\x05 \x01(\x04\"8\n\x06\x41\x63tion\x12\x16\n\x12\x41\x43TION_UNSPECIFIED\x10\x00\x12\t\n\x05PRESS\x10\x01\x12\x0b\n\x07RELEASE\x10\x02\x42\t\n\x07\x61\x64\x64ress\"2\n\rKeyEventBatch\x12!\n\x06\x65vents\x18\x01 \x03(\x0b\x32\x11.zmk.ipc.KeyEvent\"\x1f\n\tSubscribe\x12\x12\n\nevent_mask\x18\x01 \x01(\r\"\x19\n\x0b\x41\x64vanceTime\x12\n\n\x02ms\x18\x01 \x01(\r\"\x0f\n\rGetEventStats\"\x11\n\x0fGetStageTimings\"\x0e\n\x0cGetWorkStats\"\r\n\x0bGetKeyStats\"\x11\n\x0fGetThreadStacks\"\x10\n\x0eGetClientStats\"D\n\rKeymapBinding\x12\x13\n\x0b\x62\x65havior_id\x18\x01 \x01(\r\x12\x0e\n\x06param1\x18\x02 \x01(\r\x12\x0e\n\x06param2\x18\x03 \x01(\r\"m\n\x11GetKeymapBindings\x12\x13\n\x0b\x66irst_layer\x18\x01 \x01(\r\x12\x13\n\x0blayer_count\x18\x02 \x01(\r\x12\x16\n\x0e\x66irst_position\x18\x03 \x01(\r\x12\x16\n\x0eposition_count\x18\x04 \x01(\r\"\x9f\x01\n\x11SetKeymapBindings\x12\x13\n\x0b\x66irst_layer\x18\x01 \x01(\r\x12\x16\n\x0e\x66irst_position\x18\x02 \x01(\r\x12\x16\n\x0eposition_count\x18\x03 \x01(\r\x12(\n\x08\x62indings\x18\x04 \x03(\x0b\x32\x16.zmk.ipc.KeymapBinding\x12\x0c\n\x04save\x18\x05 \x01(\x08\x12\r\n\x05reset\x18\x06 \x01(\x08\"m\n\x17SetKeyboardReportFormat\x12#\n\x08\x65ndpoint\x18\x01 \x01(\x0b\x32\x11.zmk.ipc.Endpoint\x12-\n\x06\x66ormat\x18\x02 \x01(\x0e\x32\x1d.zmk.ipc.KeyboardReportFormat\"?\n\x0bSensorEvent\x12\x14\n\x0csensor_index\x18\x01 \x01(\r\x12\x0c\n\x04val1\x18\x02 \x01(\x05\x12\x0c\n\x04val2\x18\x03 \x01(\x05\"8\n\x10SensorEventBatch\x12$\n\x06\x65vents\x18\x01 \x03(\x0b\x32\x14.zmk.ipc.SensorEvent\"d\n\x0cPointerEvent\x12\n\n\x02\x64x\x18\x01 \x01(\x11\x12\n\n\x02\x64y\x18\x02 \x01(\x11\x12\r\n\x05wheel\x18\x03 \x01(\x11\x12\x0e\n\x06hwheel\x18\x04 \x01(\x11\x12\x0f\n\x07\x62uttons\x18\x05 \x01(\r\x12\x0c\n\x04sync\x18\x06 \x01(\x08\":\n\x11PointerEventBatch\x12%\n\x06\x65vents\x18\x01 \x03(\x0b\x32\x15.zmk.ipc.PointerEvent\"L\n\x05Hello\x12\x18\n\x10protocol_version\x18\x01 \x01(\r\x12\x12\n\nevent_mask\x18\x02 \x01(\r\x12\x15\n\rpacked_events\x18\x03 \x01(\x08\"\x1e\n\x0eSaveCheckpoint\x12\x0c\n\x04path\x18\x01 \x01(\t\"\xd5\x07\n\rClientMessage\x12&\n\tkey_event\x18\x01 \x01(\x0b\x32\x11.zmk.ipc.KeyEventH\x00\x12+\n\tkey_batch\x18\x02 \x01(\x0b\x32\x16.zmk.ipc.KeyEventBatchH\x00\x12\'\n\tsubscribe\x18\x03 \x01(\x0b\x32\x12.zmk.ipc.SubscribeH\x00\x12,\n\x0c\x61\x64vance_time\x18\x04 \x01(\x0b\x32\x14.zmk.ipc.AdvanceTimeH\x00\x12\x31\n\x0fget_event_stats\x18\x05 \x01(\x0b\x32\x16.zmk.ipc.GetEventStatsH\x00\x12\x39\n\x13get_keymap_bindings\x18\x06 \x01(\x0b\x32\x1a.zmk.ipc.GetKeymapBindingsH\x00\x12\x39\n\x13set_keymap_bindings\x18\x07 \x01(\x0b\x32\x1a.zmk.ipc.SetKeymapBindingsH\x00\x12\x46\n\x1aset_keyboard_report_format\x18\x08 \x01(\x0b\x32 .zmk.ipc.SetKeyboardReportFormatH\x00\x12,\n\x0csensor_event\x18\t \x01(\x0b\x32\x14.zmk.ipc.SensorEventH\x00\x12\x31\n\x0csensor_batch\x18\n \x01(\x0b\x32\x19.zmk.ipc.SensorEventBatchH\x00\x12.\n\rpointer_event\x18\x0b \x01(\x0b\x32\x15.zmk.ipc.PointerEventH\x00\x12\x33\n\rpointer_batch\x18\x0c \x01(\x0b\x32\x1a.zmk.ipc.PointerEventBatchH\x00\x12\x35\n\x11get_stage_timings\x18\r \x01(\x0b\x32\x18.zmk.ipc.GetStageTimingsH\x00\x12/\n\x0eget_work_stats\x18\x0e \x01(\x0b\x32\x15.zmk.ipc.GetWorkStatsH\x00\x12\x35\n\x11get_thread_stacks\x18\x0f \x01(\x0b\x32\x18.zmk.ipc.GetThreadStacksH\x00\x12\x33\n\x10get_client_stats\x18\x10 \x01(\x0b\x32\x17.zmk.ipc.GetClientStatsH\x00\x12\x1f\n\x05hello\x18\x11 \x01(\x0b\x32\x0e.zmk.ipc.HelloH\x00\x12\x32\n\x0fsave_checkpoint\x18\x12 \x01(\x0b\x32\x17.zmk.ipc.SaveCheckpointH\x00\x12-\n\rget_key_stats\x18\x13 \x01(\x0b\x32\x14.zmk.ipc.GetKeyStatsH\x00\x42\t\n\x07payload\"c\n\nKscanEvent\x12\x0e\n\x06source\x18\x01 \x01(\r\x12\x10\n\x08position\x18\x02 \x01(\r\x12\x0f\n\x07pressed\x18\x03 \x01(\x08\x12\x11\n\ttimestamp\x18\x04 \x01(\x03\x12\x0f\n\x07\x63ontext\x18\x05 \x01(\r\"e\n\x0cLatencyTrace\x12\x0b\n\x03seq\x18\x01 \x01(\r\x12\x11\n\tclient_ts\x18\x02 \x01(\x04\x12\x10\n\x08kscan_us\x18\x03 \x01(\x03\x12\x10\n\x08raise_us\x18\x04 \x01(\x03\x12\x11\n\treport_us\x18\x05 \x01(\x03\"\xae\x01\n\x11HidKeyboardReport\x12#\n\x08\x65ndpoint\x18\x01 \x01(\x0b\x32\x11.zmk.ipc.Endpoint\x12\x11\n\tmodifiers\x18\x02 \x01(\r\x12\x0c\n\x04keys\x18\x03 \x01(\x0c\x12$\n\x05trace\x18\x04 \x01(\x0b\x32\x15.zmk.ipc.LatencyTrace\x12-\n\x06\x66ormat\x18\x05 \x01(\x0e\x32\x1d.zmk.ipc.KeyboardReportFormat\"g\n\x10HidKeyboardDelta\x12\x0b\n\x03seq\x18\x01 \x01(\r\x12\x11\n\tmodifiers\x18\x02 \x01(\r\x12\x0f\n\x07pressed\x18\x03 \x01(\x0c\x12\x10\n\x08released\x18\x04 \x01(\x0c\x12\x10\n\x08keyframe\x18\x05 \x01(\x08\"F\n\x11HidConsumerReport\x12#\n\x08\x65ndpoint\x18\x01 \x01(\x0b\x32\x11.zmk.ipc.Endpoint\x12\x0c\n\x04keys\x18\x02 \x01(\x0c\"\x82\x01\n\x0eHidMouseReport\x12#\n\x08\x65ndpoint\x18\x01 \x01(\x0b\x32\x11.zmk.ipc.Endpoint\x12\x0f\n\x07\x62uttons\x18\x02 \x01(\r\x12\n\n\x02\x64x\x18\x03 \x01(\x11\x12\n\n\x02\x64y\x18\x04 \x01(\x11\x12\x10\n\x08scroll_x\x18\x05 \x01(\x11\x12\x10\n\x08scroll_y\x18\x06 \x01(\x11\"\xa1\x01\n\x0e\x45ventTypeStats\x12\x0c\n\x04name\x18\x01 \x01(\t\x12\r\n\x05index\x18\x02 \x01(\r\x12\r\n\x05\x63ount\x18\x03 \x01(\r\x12\x0e\n\x06raised\x18\x04 \x01(\r\x12\x19\n\x11listeners_invoked\x18\x05 \x01(\r\x12\x10\n\x08\x63\x61ptured\x18\x06 \x01(\r\x12\x0e\n\x06\x63ycles\x18\x07 \x01(\x04\x12\x16\n\x0e\x63ycles_per_sec\x18\x08 \x01(\r\"\x9d\x01\n\x0bStageTiming\x12\x0c\n\x04name\x18\x01 \x01(\t\x12\r\n\x05index\x18\x02 \x01(\r\x12\r\n\x05\x63ount\x18\x03 \x01(\r\x12\x0f\n\x07samples\x18\x04 \x01(\r\x12\x14\n\x0ctotal_cycles\x18\x05 \x01(\x04\x12\x12\n\nmax_cycles\x18\x06 \x01(\r\x12\x0f\n\x07\x62uckets\x18\x07 \x03(\r\x12\x16\n\x0e\x63ycles_per_sec\x18\x08 \x01(\r\"\x8e\x02\n\tWorkStats\x12\x0c\n\x04name\x18\x01 \x01(\t\x12\r\n\x05index\x18\x02 \x01(\r\x12\r\n\x05\x63ount\x18\x03 \x01(\r\x12\x11\n\tsubmitted\x18\x04 \x01(\r\x12\x0c\n\x04runs\x18\x05 \x01(\r\x12\x1c\n\x14total_latency_cycles\x18\x06 \x01(\x04\x12\x1a\n\x12max_latency_cycles\x18\x07 \x01(\r\x12\x18\n\x10total_run_cycles\x18\x08 \x01(\x04\x12\x16\n\x0emax_run_cycles\x18\t \x01(\r\x12\x16\n\x0equeue_capacity\x18\n \x01(\r\x12\x18\n\x10queue_high_water\x18\x0b \x01(\r\x12\x16\n\x0e\x63ycles_per_sec\x18\x0c \x01(\r\"\x9d\x01\n\x08KeyStats\x12\r\n\x05index\x18\x01 \x01(\r\x12\r\n\x05\x63ount\x18\x02 \x01(\r\x12\x10\n\x08position\x18\x03 \x01(\x11\x12\x0f\n\x07samples\x18\x04 \x01(\r\x12\x0e\n\x06max_ms\x18\x05 \x01(\r\x12\x0f\n\x07\x62uckets\x18\x06 \x03(\r\x12\r\n\x05holds\x18\x07 \x01(\r\x12\x0c\n\x04taps\x18\x08 \x01(\r\x12\x12\n\nretro_taps\x18\t \x01(\r\"a\n\x0bThreadStack\x12\x0c\n\x04name\x18\x01 \x01(\t\x12\r\n\x05index\x18\x02 \x01(\r\x12\r\n\x05\x63ount\x18\x03 \x01(\r\x12\x12\n\nstack_size\x18\x04 \x01(\r\x12\x12\n\nstack_used\x18\x05 \x01(\r\"\xf0\x01\n\x0b\x43lientStats\x12\r\n\x05index\x18\x01 \x01(\r\x12\r\n\x05\x63ount\x18\x02 \x01(\r\x12\x11\n\trequester\x18\x03 \x01(\x08\x12\x13\n\x0b\x66rames_sent\x18\x04 \x01(\r\x12\x12\n\nbytes_sent\x18\x05 \x01(\x04\x12\x16\n\x0e\x66rames_dropped\x18\x06 \x01(\r\x12\x13\n\x0bqueue_depth\x18\x07 \x01(\r\x12\x18\n\x10queue_high_water\x18\x08 \x01(\r\x12\x16\n\x0equeue_capacity\x18\t \x01(\r\x12\x13\n\x0bsndbuf_size\x18\n \x01(\r\x12\x13\n\x0bsndbuf_used\x18\x0b \x01(\r\"G\n\x0fKscanEventBatch\x12#\n\x06\x65vents\x18\x01 \x03(\x0b\x32\x13.zmk.ipc.KscanEvent\x12\x0f\n\x07\x64ropped\x18\x02 \x01(\r\"\xbd\x01\n\x0c\x43\x61pabilities\x12\x18\n\x10protocol_version\x18\x01 \x01(\r\x12\x17\n\x0fmax_event_frame\x18\x02 \x01(\r\x12\x19\n\x11max_message_frame\x18\x03 \x01(\r\x12\x12\n\nevent_mask\x18\x04 \x01(\r\x12\x14\n\x0cmessage_mask\x18\x05 \x01(\r\x12\x0c\n\x04rows\x18\x06 \x01(\r\x12\x0f\n\x07\x63olumns\x18\x07 \x01(\r\x12\x16\n\x0epacked_version\x18\x08 \x01(\r\"\x82\x01\n\x0eKeymapBindings\x12\x10\n\x08layer_id\x18\x01 \x01(\r\x12\x16\n\x0e\x66irst_position\x18\x02 \x01(\r\x12(\n\x08\x62indings\x18\x03 \x03(\x0b\x32\x16.zmk.ipc.KeymapBinding\x12\r\n\x05index\x18\x04 \x01(\r\x12\r\n\x05\x63ount\x18\x05 \x01(\r\"1\n\x0fKeymapSetResult\x12\x0f\n\x07\x61pplied\x18\x01 \x01(\r\x12\r\n\x05\x65rror\x18\x02 \x01(\x11\"!\n\x10\x43heckpointResult\x12\r\n\x05\x65rror\x18\x01 \x01(\x11\"2\n\x0cInputCredits\x12\x10\n\x08\x63\x61pacity\x18\x01 \x01(\r\x12\x10\n\x08\x63onsumed\x18\x02 \x01(\r\"2\n\x11LayerStateChanged\x12\r\n\x05layer\x18\x01 \x01(\r\x12\x0e\n\x06\x61\x63tive\x18\x02 \x01(\x08\"W\n\x15ModifiersStateChanged\x12\x11\n\tmodifiers\x18\x01 \x01(\r\x12\x0f\n\x07pressed\x18\x02 \x01(\x08\x12\x1a\n\x12\x65xplicit_modifiers\x18\x03 \x01(\r\"6\n\x0f\x45ndpointChanged\x12#\n\x08\x65ndpoint\x18\x01 \x01(\x0b\x32\x11.zmk.ipc.Endpoint\"\x97\x02\n\rStateSnapshot\x12\x13\n\x0blayer_state\x18\x01 \x01(\r\x12\x15\n\rdefault_layer\x18\x02 \x01(\r\x12\x1a\n\x12\x65xplicit_modifiers\x18\x03 \x01(\r\x12#\n\x08\x65ndpoint\x18\x04 \x01(\x0b\x32\x11.zmk.ipc.Endpoint\x12,\n\x08keyboard\x18\x05 \x01(\x0b\x32\x1a.zmk.ipc.HidKeyboardReport\x12,\n\x08\x63onsumer\x18\x06 \x01(\x0b\x32\x1a.zmk.ipc.HidConsumerReport\x12&\n\x05mouse\x18\x07 \x01(\x0b\x32\x17.zmk.ipc.HidMouseReport\x12\x15\n\rbattery_level\x18\x08 \x01(\x11\"\xb9\x08\n\x08ZmkEvent\x12*\n\x0bkscan_event\x18\x01 \x01(\x0b\x32\x13.zmk.ipc.KscanEventH\x00\x12.\n\x08keyboard\x18\x02 \x01(\x0b\x32\x1a.zmk.ipc.HidKeyboardReportH\x00\x12.\n\x08\x63onsumer\x18\x03 \x01(\x0b\x32\x1a.zmk.ipc.HidConsumerReportH\x00\x12(\n\x05mouse\x18\x04 \x01(\x0b\x32\x17.zmk.ipc.HidMouseReportH\x00\x12.\n\x0b\x65vent_stats\x18\x05 \x01(\x0b\x32\x17.zmk.ipc.EventTypeStatsH\x00\x12\x32\n\x0fkeymap_bindings\x18\x06 \x01(\x0b\x32\x17.zmk.ipc.KeymapBindingsH\x00\x12\x35\n\x11keymap_set_result\x18\x07 \x01(\x0b\x32\x18.zmk.ipc.KeymapSetResultH\x00\x12\x31\n\x0blayer_state\x18\x08 \x01(\x0b\x32\x1a.zmk.ipc.LayerStateChangedH\x00\x12,\n\x0cstage_timing\x18\n \x01(\x0b\x32\x14.zmk.ipc.StageTimingH\x00\x12(\n\nwork_stats\x18\x0b \x01(\x0b\x32\x12.zmk.ipc.WorkStatsH\x00\x12,\n\x0cthread_stack\x18\x0c \x01(\x0b\x32\x14.zmk.ipc.ThreadStackH\x00\x12\x30\n\x0estate_snapshot\x18\r \x01(\x0b\x32\x16.zmk.ipc.StateSnapshotH\x00\x12\x39\n\x0fmodifiers_state\x18\x0e \x01(\x0b\x32\x1e.zmk.ipc.ModifiersStateChangedH\x00\x12\x34\n\x10\x65ndpoint_changed\x18\x0f \x01(\x0b\x32\x18.zmk.ipc.EndpointChangedH\x00\x12\x33\n\x0ekeyboard_delta\x18\x10 \x01(\x0b\x32\x19.zmk.ipc.HidKeyboardDeltaH\x00\x12,\n\x0c\x63lient_stats\x18\x11 \x01(\x0b\x32\x14.zmk.ipc.ClientStatsH\x00\x12/\n\x0bkscan_batch\x18\x12 \x01(\x0b\x32\x18.zmk.ipc.KscanEventBatchH\x00\x12-\n\x0c\x63\x61pabilities\x18\x13 \x01(\x0b\x32\x15.zmk.ipc.CapabilitiesH\x00\x12\x36\n\x11\x63heckpoint_result\x18\x14 \x01(\x0b\x32\x19.zmk.ipc.CheckpointResultH\x00\x12.\n\rinput_credits\x18\x15 \x01(\x0b\x32\x15.zmk.ipc.InputCreditsH\x00\x12&\n\tkey_stats\x18\x16 \x01(\x0b\x32\x11.zmk.ipc.KeyStatsH\x00\x12\x11\n\ttimestamp\x18\t \x01(\x03\x12\x0f\n\x07\x63ontext\x18\x17 \x01(\rB\t\n\x07payload\"\x07\n\x05\x45mpty*d\n\rTransportType\x12\x19\n\x15TRANSPORT_UNSPECIFIED\x10\x00\x12\x12\n\x0eTRANSPORT_NONE\x10\x01\x12\x11\n\rTRANSPORT_USB\x10\x02\x12\x11\n\rTRANSPORT_BLE\x10\x03*Z\n\x14KeyboardReportFormat\x12!\n\x1dKEYBOARD_REPORT_FORMAT_NATIVE\x10\x00\x12\x1f\n\x1bKEYBOARD_REPORT_FORMAT_BOOT\x10\x01\x32\xac\x01\n\x06ZmkIpc\x12\x34\n\x08SendKeys\x12\x16.zmk.ipc.ClientMessage\x1a\x0e.zmk.ipc.Empty(\x01\x12\x32\n\x0bWatchEvents\x12\x0e.zmk.ipc.Empty\x1a\x11.zmk.ipc.ZmkEvent0\x01\x12\x38\n\x07\x43onnect\x12\x16.zmk.ipc.ClientMessage\x1a\x11.zmk.ipc.ZmkEvent(\x01\x30\x01\x42:\n\x0b\x64\x65v.zmk.ipcB\x0bZmkIpcProtoZ\x1egithub.com/zmkfirmware/zmk/ipcb\x06proto3')
 
 _builder.BuildMessageAndEnumDescriptors(DESCRIPTOR, globals())
 _builder.BuildTopDescriptorsAndMessages(DESCRIPTOR, 'zmk_ipc_pb2', globals())
@@ -21,30 +21,106 @@ if _descriptor._USE_C_DESCRIPTORS == False:
 
   DESCRIPTOR._options = None
   DESCRIPTOR._serialized_options = b'\n\013dev.zmk.ipcB\013ZmkIpcProtoZ\036github.com/zmkfirmware/zmk/ipc'
-  _TRANSPORTTYPE._serialized_start=995
-  _TRANSPORTTYPE._serialized_end=1095
+  _TRANSPORTTYPE._serialized_start=6311
+  _TRANSPORTTYPE._serialized_end=6411
+  _KEYBOARDREPORTFORMAT._serialized_start=6413
+  _KEYBOARDREPORTFORMAT._serialized_end=6503
   _ENDPOINT._serialized_start=26
   _ENDPOINT._serialized_end=104
   _KEYPOSITION._serialized_start=106
   _KEYPOSITION._serialized_end=145
   _KEYEVENT._serialized_start=148
-  _KEYEVENT._serialized_end=330
-  _KEYEVENT_ACTION._serialized_start=263
-  _KEYEVENT_ACTION._serialized_end=319
-  _CLIENTMESSAGE._serialized_start=332
-  _CLIENTMESSAGE._serialized_end=398
-  _KSCANEVENT._serialized_start=400
-  _KSCANEVENT._serialized_end=482
-  _HIDKEYBOARDREPORT._serialized_start=484
-  _HIDKEYBOARDREPORT._serialized_end=573
-  _HIDCONSUMERREPORT._serialized_start=575
-  _HIDCONSUMERREPORT._serialized_end=645
-  _HIDMOUSEREPORT._serialized_start=648
-  _HIDMOUSEREPORT._serialized_end=778
-  _ZMKEVENT._serialized_start=781
-  _ZMKEVENT._serialized_end=984
-  _EMPTY._serialized_start=986
-  _EMPTY._serialized_end=993
-  _ZMKIPC._serialized_start=1098
-  _ZMKIPC._serialized_end=1270
+  _KEYEVENT._serialized_end=362
+  _KEYEVENT_ACTION._serialized_start=295
+  _KEYEVENT_ACTION._serialized_end=351
+  _KEYEVENTBATCH._serialized_start=364
+  _KEYEVENTBATCH._serialized_end=414
+  _SUBSCRIBE._serialized_start=416
+  _SUBSCRIBE._serialized_end=447
+  _ADVANCETIME._serialized_start=449
+  _ADVANCETIME._serialized_end=474
+  _GETEVENTSTATS._serialized_start=476
+  _GETEVENTSTATS._serialized_end=491
+  _GETSTAGETIMINGS._serialized_start=493
+  _GETSTAGETIMINGS._serialized_end=510
+  _GETWORKSTATS._serialized_start=512
+  _GETWORKSTATS._serialized_end=526
+  _GETKEYSTATS._serialized_start=528
+  _GETKEYSTATS._serialized_end=541
+  _GETTHREADSTACKS._serialized_start=543
+  _GETTHREADSTACKS._serialized_end=560
+  _GETCLIENTSTATS._serialized_start=562
+  _GETCLIENTSTATS._serialized_end=578
+  _KEYMAPBINDING._serialized_start=580
+  _KEYMAPBINDING._serialized_end=648
+  _GETKEYMAPBINDINGS._serialized_start=650
+  _GETKEYMAPBINDINGS._serialized_end=759
+  _SETKEYMAPBINDINGS._serialized_start=762
+  _SETKEYMAPBINDINGS._serialized_end=921
+  _SETKEYBOARDREPORTFORMAT._serialized_start=923
+  _SETKEYBOARDREPORTFORMAT._serialized_end=1032
+  _SENSOREVENT._serialized_start=1034
+  _SENSOREVENT._serialized_end=1097
+  _SENSOREVENTBATCH._serialized_start=1099
+  _SENSOREVENTBATCH._serialized_end=1155
+  _POINTEREVENT._serialized_start=1157
+  _POINTEREVENT._serialized_end=1257
+  _POINTEREVENTBATCH._serialized_start=1259
+  _POINTEREVENTBATCH._serialized_end=1317
+  _HELLO._serialized_start=1319
+  _HELLO._serialized_end=1395
+  _SAVECHECKPOINT._serialized_start=1397
+  _SAVECHECKPOINT._serialized_end=1427
+  _CLIENTMESSAGE._serialized_start=1430
+  _CLIENTMESSAGE._serialized_end=2411
+  _KSCANEVENT._serialized_start=2413
+  _KSCANEVENT._serialized_end=2512
+  _LATENCYTRACE._serialized_start=2514
+  _LATENCYTRACE._serialized_end=2615
+  _HIDKEYBOARDREPORT._serialized_start=2618
+  _HIDKEYBOARDREPORT._serialized_end=2792
+  _HIDKEYBOARDDELTA._serialized_start=2794
+  _HIDKEYBOARDDELTA._serialized_end=2897
+  _HIDCONSUMERREPORT._serialized_start=2899
+  _HIDCONSUMERREPORT._serialized_end=2969
+  _HIDMOUSEREPORT._serialized_start=2972
+  _HIDMOUSEREPORT._serialized_end=3102
+  _EVENTTYPESTATS._serialized_start=3105
+  _EVENTTYPESTATS._serialized_end=3266
+  _STAGETIMING._serialized_start=3269
+  _STAGETIMING._serialized_end=3426
+  _WORKSTATS._serialized_start=3429
+  _WORKSTATS._serialized_end=3699
+  _KEYSTATS._serialized_start=3702
+  _KEYSTATS._serialized_end=3859
+  _THREADSTACK._serialized_start=3861
+  _THREADSTACK._serialized_end=3958
+  _CLIENTSTATS._serialized_start=3961
+  _CLIENTSTATS._serialized_end=4201
+  _KSCANEVENTBATCH._serialized_start=4203
+  _KSCANEVENTBATCH._serialized_end=4274
+  _CAPABILITIES._serialized_start=4277
+  _CAPABILITIES._serialized_end=4466
+  _KEYMAPBINDINGS._serialized_start=4469
+  _KEYMAPBINDINGS._serialized_end=4599
+  _KEYMAPSETRESULT._serialized_start=4601
+  _KEYMAPSETRESULT._serialized_end=4650
+  _CHECKPOINTRESULT._serialized_start=4652
+  _CHECKPOINTRESULT._serialized_end=4685
+  _INPUTCREDITS._serialized_start=4687
+  _INPUTCREDITS._serialized_end=4737
+  _LAYERSTATECHANGED._serialized_start=4739
+  _LAYERSTATECHANGED._serialized_end=4789
+  _MODIFIERSSTATECHANGED._serialized_start=4791
+  _MODIFIERSSTATECHANGED._serialized_end=4878
+  _ENDPOINTCHANGED._serialized_start=4880
+  _ENDPOINTCHANGED._serialized_end=4934
+  _STATESNAPSHOT._serialized_start=4937
+  _STATESNAPSHOT._serialized_end=5216
+  _ZMKEVENT._serialized_start=5219
+  _ZMKEVENT._serialized_end=6300
+  _EMPTY._serialized_start=6302
+  _EMPTY._serialized_end=6309
+  _ZMKIPC._serialized_start=6506
+  _ZMKIPC._serialized_end=6678
 # @@protoc_insertion_point(module_scope)